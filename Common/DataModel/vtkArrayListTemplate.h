@@ -237,6 +237,17 @@ struct ArrayList
                              vtkStdString &outArrayName, double nullValue,
                              vtkTypeBool promote);
 
+  // Return true if AddArrays() can pair all the arrays of the given output
+  // attributes, that is if all of them are named, non-bit data arrays with
+  // the standard (array of structures) memory layout.
+  static bool CanCopyAll(vtkDataSetAttributes *outPD);
+
+  // Copy the input tuple sources[id] to the output tuple id, for all the
+  // numTuples output tuples. Output attributes must have been allocated
+  // (e.g., vtkDataSetAttributes::CopyAllocate()).
+  static void GatherTuples(vtkDataSetAttributes *inPD, vtkDataSetAttributes *outPD,
+                           const vtkIdType *sources, vtkIdType numTuples);
+
   // Any array excluded here is not added by AddArrays() or AddArrayPair, hence not
   // processed. Also check whether an array is excluded.
   void ExcludeArray(vtkDataArray *da);
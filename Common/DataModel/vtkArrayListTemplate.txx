@@ -14,6 +14,9 @@
 =========================================================================*/
 #include "vtkArrayListTemplate.h"
 #include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
+#include "vtkSMPTools.h"
 
 #include <cassert>
 
@@ -214,4 +217,76 @@ AddSelfInterpolatingArrays(vtkIdType numOutPts, vtkDataSetAttributes *attr, doub
   }//for each candidate array
 }
 
+//----------------------------------------------------------------------------
+inline bool ArrayList::
+CanCopyAll(vtkDataSetAttributes *outPD)
+{
+  for (int i=0; i < outPD->GetNumberOfArrays(); ++i)
+  {
+    // Pairs write through GetVoidPointer(), which returns a temporary copy
+    // for arrays with a non standard layout, and vtkTemplateMacro has no
+    // case for bit arrays.
+    vtkDataArray *array = outPD->GetArray(i);
+    if ( ! array || ! array->GetName() ||
+         ! array->HasStandardMemoryLayout() ||
+         array->GetDataType() == VTK_BIT )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Gather the tuples of a range of output ids from their source ids.
+struct ArrayListGatherTuples
+{
+  ArrayList *Arrays;
+  const vtkIdType *Sources;
+
+  void operator()(vtkIdType outId, vtkIdType endOutId)
+  {
+    for ( ; outId < endOutId; ++outId)
+    {
+      this->Arrays->Copy(this->Sources[outId], outId);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// vtkDataSetAttributes::CopyData() is not thread safe since it traverses
+// iterators shared by all its callers, so the tuples are gathered in parallel
+// through an ArrayList when it pairs all the output arrays. Otherwise (an
+// output array is not a named data array with a standard memory layout, a
+// bit array, or has no matching input array) all of them are copied serially
+// by vtkDataSetAttributes.
+inline void ArrayList::
+GatherTuples(vtkDataSetAttributes *inPD, vtkDataSetAttributes *outPD,
+             const vtkIdType *sources, vtkIdType numTuples)
+{
+  ArrayList arrays;
+  if ( ArrayList::CanCopyAll(outPD) )
+  {
+    arrays.AddArrays(numTuples, inPD, outPD, 0.0, false);
+  }
+  if ( arrays.Arrays.size() == static_cast<size_t>(outPD->GetNumberOfArrays()) )
+  {
+    ArrayListGatherTuples gather = { &arrays, sources };
+    vtkSMPTools::For(0, numTuples, gather);
+  }
+  else
+  {
+    vtkNew<vtkIdList> srcIds;
+    vtkNew<vtkIdList> dstIds;
+    srcIds->SetNumberOfIds(numTuples);
+    dstIds->SetNumberOfIds(numTuples);
+    for (vtkIdType outId=0; outId < numTuples; ++outId)
+    {
+      srcIds->SetId(outId, sources[outId]);
+      dstIds->SetId(outId, outId);
+    }
+    outPD->CopyData(inPD, srcIds, dstIds);
+  }
+}
+
 #endif
@@ -0,0 +1,190 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    UnitTestSpanSpace
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkSmartPointer.h"
+#include "vtkSpanSpace.h"
+#include "vtkImageData.h"
+#include "vtkDataArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+// Exposes the build time, to check when the span space is rebuilt.
+class vtkTestSpanSpace : public vtkSpanSpace
+{
+public:
+  static vtkTestSpanSpace *New();
+  vtkTypeMacro(vtkTestSpanSpace, vtkSpanSpace);
+  vtkMTimeType GetBuildTime() { return this->BuildTime.GetMTime(); }
+};
+vtkStandardNewMacro(vtkTestSpanSpace);
+
+static vtkSmartPointer<vtkImageData> MakeImage(int);
+static int CheckSweep(vtkSpanSpace *, vtkImageData *, vtkDataArray *,
+                      int numValues);
+
+int UnitTestSpanSpace(int, char*[])
+{
+  int status = 0;
+
+  std::cout << "Testing empty Print...";
+  vtkSmartPointer<vtkTestSpanSpace> tree =
+    vtkSmartPointer<vtkTestSpanSpace>::New();
+  std::ostringstream treePrint;
+  tree->Print(treePrint);
+  std::cout << "Passed" << std::endl;
+
+  std::cout << "Testing batches over a sweep of values...";
+  vtkSmartPointer<vtkImageData> anImage = MakeImage(12);
+  vtkDataArray *scalars = anImage->GetPointData()->GetScalars();
+  tree->SetDataSet(anImage);
+  tree->SetBatchSize(7);
+  tree->BuildTree();
+  vtkMTimeType buildTime = tree->GetBuildTime();
+  int status1 = CheckSweep(tree, anImage, scalars, 100);
+  if (status1 || tree->GetBuildTime() != buildTime)
+  {
+    std::cout << "Failed" << std::endl;
+    status++;
+  }
+  else
+  {
+    std::cout << "Passed" << std::endl;
+  }
+
+  std::cout << "Testing rebuild on modified scalars...";
+  // Scalars that are not part of the dataset
+  vtkSmartPointer<vtkFloatArray> other =
+    vtkSmartPointer<vtkFloatArray>::New();
+  other->DeepCopy(scalars);
+  tree->SetScalars(other);
+  tree->BuildTree();
+  buildTime = tree->GetBuildTime();
+  for (vtkIdType i = 0; i < other->GetNumberOfTuples(); ++i)
+  {
+    other->SetValue(i, 2.0f * other->GetValue(i) + 1.0f);
+  }
+  other->Modified();
+  int status2 = CheckSweep(tree, anImage, other, 20);
+  if (status2 || tree->GetBuildTime() == buildTime)
+  {
+    std::cout << "Failed" << std::endl;
+    status++;
+  }
+  else
+  {
+    std::cout << "Passed" << std::endl;
+  }
+
+  std::cout << "Testing Print...";
+  tree->Print(treePrint);
+  std::cout << "Passed" << std::endl;
+
+  if (status)
+  {
+    return EXIT_FAILURE;
+  }
+  else
+  {
+    return EXIT_SUCCESS;
+  }
+}
+
+// Sweeps values across the scalar range (both ends included) and checks
+// that the batches hold the same cells as the serial traversal, and at
+// least the cells that the value crosses.
+int CheckSweep(vtkSpanSpace *tree, vtkImageData *anImage,
+               vtkDataArray *scalars, int numValues)
+{
+  int status = 0;
+  double range[2];
+  scalars->GetRange(range);
+  vtkIdType numCells = anImage->GetNumberOfCells();
+  vtkSmartPointer<vtkIdList> ptIds = vtkSmartPointer<vtkIdList>::New();
+  vtkSmartPointer<vtkFloatArray> cellScalars =
+    vtkSmartPointer<vtkFloatArray>::New();
+  for (int v = 0; v < numValues; ++v)
+  {
+    double value = range[0] + (range[1] - range[0]) * v / (numValues - 1);
+    std::vector<int> serial(numCells, 0);
+    std::vector<int> batched(numCells, 0);
+    tree->InitTraversal(value);
+    vtkIdType cellId;
+    vtkIdList *cellPts;
+    while (tree->GetNextCell(cellId, cellPts, cellScalars))
+    {
+      serial[cellId]++;
+    }
+    vtkIdType numBatches = tree->GetNumberOfCellBatches();
+    for (vtkIdType b = 0; b < numBatches; ++b)
+    {
+      vtkIdType num;
+      const vtkIdType *ids = tree->GetCellBatch(b, num);
+      for (vtkIdType i = 0; i < num; ++i)
+      {
+        batched[ids[i]]++;
+      }
+    }
+    for (vtkIdType c = 0; c < numCells; ++c)
+    {
+      anImage->GetCellPoints(c, ptIds);
+      double sMin = VTK_DOUBLE_MAX, sMax = VTK_DOUBLE_MIN;
+      for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); ++i)
+      {
+        double s = scalars->GetComponent(ptIds->GetId(i), 0);
+        sMin = (s < sMin ? s : sMin);
+        sMax = (s > sMax ? s : sMax);
+      }
+      bool crossed = (value >= sMin && value <= sMax);
+      if (serial[c] > 1 || batched[c] != serial[c] ||
+          (crossed && !serial[c]))
+      {
+        std::cout << "For " << value << " cell " << c
+                  << " found " << serial[c] << " and " << batched[c]
+                  << " times" << std::endl;
+        ++status;
+        break;
+      }
+    }
+  }
+  return status;
+}
+
+vtkSmartPointer<vtkImageData> MakeImage(int dim)
+{
+  vtkSmartPointer<vtkImageData> anImage =
+    vtkSmartPointer<vtkImageData>::New();
+  anImage->SetDimensions(dim, dim, dim);
+  anImage->AllocateScalars(VTK_FLOAT,1);
+  float* pixel = static_cast<float *>(anImage->GetScalarPointer(0,0,0));
+
+  for(int z = 0; z < dim; z++)
+  {
+    for(int y = 0; y < dim; y++)
+    {
+      for(int x = 0; x < dim; x++)
+      {
+        *pixel++ = static_cast<float>(
+          std::sin(0.5 * x) + std::cos(0.3 * y) + 0.1 * z * z);
+      }
+    }
+  }
+  return anImage;
+}
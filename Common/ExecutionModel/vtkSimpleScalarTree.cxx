@@ -98,7 +98,8 @@ void vtkSimpleScalarTree::BuildTree()
   }
 
   if ( this->Tree != nullptr && this->BuildTime > this->MTime
-    && this->BuildTime > this->DataSet->GetMTime() )
+    && this->BuildTime > this->DataSet->GetMTime()
+    && (!this->Scalars || this->BuildTime > this->Scalars->GetMTime()) )
   {
     return;
   }
@@ -26,6 +26,7 @@
 #include "vtkSMPThreadLocalObject.h"
 
 #include <algorithm> //std::sort
+#include <vector>
 
 //-----------------------------------------------------------------------------
 // The following tuple is an interface between VTK class and internal class
@@ -54,6 +55,7 @@ public:
   vtkIdType NumCells; //total number of cells in span space
   vtkIdType *CandidateCells; //to support parallel computing
   vtkIdType  NumCandidates;
+  std::vector<vtkIdType> RowOffsets; //offset of each span row in candidates
 
   // Constructor
   vtkInternalSpanSpace(vtkIdType dim, double sMin, double sMax, vtkIdType numCells);
@@ -86,6 +88,7 @@ public:
   {
     vtkIdType i = static_cast<vtkIdType>(
       static_cast<double>(this->Dim) * (value - this->SMin) / this->Range);
+    i = ( i < 0 ? 0 : (i >= this->Dim ? this->Dim-1 : i));
 
     rMin[0] = 0; //xmin on rectangle left boundary
     rMin[1] = i; //ymin on rectangle bottom
@@ -166,6 +169,34 @@ public:
     {
     }
   };
+
+  // Copy the cells of the rows of a span rectangle into the candidate
+  // list, at the given offset of each row.
+  class CopyCandidates
+  {
+  public:
+    vtkInternalSpanSpace *SpanSpace;
+    vtkIdType *RMin;
+    vtkIdType *RMax;
+
+    CopyCandidates(vtkInternalSpanSpace *ss, vtkIdType rMin[2],
+                   vtkIdType rMax[2]) :
+      SpanSpace(ss), RMin(rMin), RMax(rMax)
+    {
+    }
+
+    void operator()(vtkIdType row, vtkIdType endRow)
+    {
+      vtkIdType *span, numCells;
+      for ( ; row < endRow; ++row )
+      {
+        span = this->SpanSpace->
+          GetCellsInSpan(this->RMin[1]+row, this->RMin, this->RMax, numCells);
+        std::copy(span, span+numCells, this->SpanSpace->CandidateCells +
+                  this->SpanSpace->RowOffsets[row]);
+      }
+    }
+  };
 };
 
 //-----------------------------------------------------------------------------
@@ -301,8 +332,11 @@ void vtkSpanSpace::BuildTree()
     return;
   }
 
-  if ( this->BuildTime > this->MTime
-       && this->BuildTime > this->DataSet->GetMTime() )
+  // The tree is reused as long as neither it, the dataset nor the scalars
+  // (which may not belong to the dataset) were modified since it was built.
+  if ( this->SpanSpace && this->BuildTime > this->MTime
+       && this->BuildTime > this->DataSet->GetMTime()
+       && (!this->Scalars || this->BuildTime > this->Scalars->GetMTime()) )
   {
     return;
   }
@@ -416,23 +450,32 @@ vtkCell *vtkSpanSpace::GetNextCell(vtkIdType& cellId, vtkIdList* &cellPts,
 // InitTraversal() must have been called, which populates the span rectangle.
 vtkIdType vtkSpanSpace::GetNumberOfCellBatches()
 {
-  // Basicall just perform a serial traversal and populate candidate list
+  // The candidates of each row of the span rectangle are contiguous in the
+  // sorted cell ids, so the rows are offset in the candidate list, then
+  // copied in parallel.
   this->SpanSpace->NumCandidates = 0;
-
-  // loop over all rows in span rectangle
-  vtkIdType row, *span, idx, numCells;
-  for (row=this->RMin[1]; row < this->RMax[1]; ++row)
+  vtkIdType numRows = this->RMax[1] - this->RMin[1];
+  if ( numRows < 1 )
   {
-    span = this->SpanSpace->
-      GetCellsInSpan(row, this->RMin, this->RMax, numCells);
-    for (idx=0; idx < numCells; ++idx)
-    {
-      this->SpanSpace->
-        CandidateCells[this->SpanSpace->NumCandidates++] = span[idx];
-    }
+    return 0;
+  }
+  std::vector<vtkIdType> &rowOffsets = this->SpanSpace->RowOffsets;
+  rowOffsets.resize(numRows+1);
+  rowOffsets[0] = 0;
+  vtkIdType row, numCells;
+  for (row=0; row < numRows; ++row)
+  {
+    this->SpanSpace->
+      GetCellsInSpan(this->RMin[1]+row, this->RMin, this->RMax, numCells);
+    rowOffsets[row+1] = rowOffsets[row] + numCells;
   }//for all rows in span rectangle
+  this->SpanSpace->NumCandidates = rowOffsets[numRows];
+
+  vtkInternalSpanSpace::
+    CopyCandidates copy(this->SpanSpace, this->RMin, this->RMax);
+  vtkSMPTools::For(0,numRows,copy);
 
-  // Watch for boundary conditions. Return 10 cells to a batch.
+  // Watch for boundary conditions. Return BatchSize cells to a batch.
   if ( this->SpanSpace->NumCandidates < 1 )
   {
     return 0;
@@ -475,4 +518,5 @@ void vtkSpanSpace::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "Resolution: " << this->Resolution << "\n" ;
+  os << indent << "Batch Size: " << this->BatchSize << "\n" ;
 }
@@ -77,6 +77,17 @@ public:
   vtkGetMacro(Resolution,vtkIdType);
   //@}
 
+  //@{
+  /**
+   * Set/Get the number of cells returned by GetCellBatch() (the last batch
+   * may be smaller). Threaded contouring dispatches whole batches, so
+   * larger batches mean less scheduling overhead per cell. By default
+   * BatchSize = 10.
+   */
+  vtkSetClampMacro(BatchSize,vtkIdType,1,VTK_INT_MAX);
+  vtkGetMacro(BatchSize,vtkIdType);
+  //@}
+
   //----------------------------------------------------------------------
   // The following methods satisfy the vtkScalarTree abstract API.
 
@@ -908,6 +908,441 @@ double *vtkFunctionParser::GetVectorResult()
   return this->Stack;
 }
 
+//-----------------------------------------------------------------------------
+namespace
+{
+// Applies f to every value of a column of the block stack.
+template <typename F>
+void vtkFunctionParserApply(double* x, vtkIdType n, F f)
+{
+  for (vtkIdType t = 0; t < n; ++t)
+  {
+    x[t] = f(x[t]);
+  }
+}
+
+// Applies f to every value of a column of the block stack for which
+// isValid holds, replacing or flagging the others.
+template <typename V, typename F>
+void vtkFunctionParserApplyChecked(double* x, vtkIdType n, V isValid, F f,
+                                   bool replace, double replacement,
+                                   double* invalid)
+{
+  for (vtkIdType t = 0; t < n; ++t)
+  {
+    if (isValid(x[t]))
+    {
+      x[t] = f(x[t]);
+    }
+    else
+    {
+      x[t] = replacement;
+      if (!replace)
+      {
+        invalid[t] = 1.0;
+      }
+    }
+  }
+}
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkFunctionParser::EvaluateBlock(vtkIdType numberOfTuples,
+                                           const double* const* scalarValues,
+                                           const double* const* vectorValues,
+                                           double* result,
+                                           std::vector<double>& workspace) const
+{
+  if (this->FunctionMTime.GetMTime() > this->ParseMTime.GetMTime() ||
+      this->ByteCodeSize <= 0)
+  {
+    return -1;
+  }
+  const vtkIdType n = numberOfTuples;
+  if (n <= 0)
+  {
+    return 0;
+  }
+
+  // The stack holds one column of n values per stack position, followed by
+  // a column flagging the invalid tuples.
+  workspace.resize(static_cast<size_t>(this->StackSize + 1) * n);
+  double* stack = workspace.data();
+  double* invalid = stack + static_cast<size_t>(this->StackSize) * n;
+  std::fill_n(invalid, n, 0.0);
+
+  const int numScalarVariables =
+    static_cast<int>(this->ScalarVariableNames.size());
+  const bool replace = this->ReplaceInvalidValues != 0;
+  const double replacement = replace ? this->ReplacementValue : 0.0;
+  int numImmediatesProcessed = 0;
+  int stackPosition = -1;
+  double* x;
+  double* y;
+  double* z;
+
+  // pointer to the column at stack position pos
+#define VTK_PARSER_COLUMN(pos) (stack + static_cast<size_t>(pos) * n)
+
+  for (int i = 0; i < this->ByteCodeSize; i++)
+  {
+    switch (this->ByteCode[i])
+    {
+      case VTK_PARSER_IMMEDIATE:
+        std::fill_n(VTK_PARSER_COLUMN(++stackPosition), n,
+                    this->Immediates[numImmediatesProcessed++]);
+        break;
+      case VTK_PARSER_UNARY_MINUS:
+        vtkFunctionParserApply(VTK_PARSER_COLUMN(stackPosition), n,
+                               [](double a) { return -a; });
+        break;
+      case VTK_PARSER_UNARY_PLUS:
+      case VTK_PARSER_VECTOR_UNARY_PLUS:
+        break;
+      case VTK_PARSER_ADD:
+      case VTK_PARSER_SUBTRACT:
+      case VTK_PARSER_MULTIPLY:
+      case VTK_PARSER_POWER:
+      case VTK_PARSER_MIN:
+      case VTK_PARSER_MAX:
+      case VTK_PARSER_LESS_THAN:
+      case VTK_PARSER_GREATER_THAN:
+      case VTK_PARSER_EQUAL_TO:
+      case VTK_PARSER_AND:
+      case VTK_PARSER_OR:
+      {
+        x = VTK_PARSER_COLUMN(stackPosition - 1);
+        y = VTK_PARSER_COLUMN(stackPosition);
+        const unsigned char op = this->ByteCode[i];
+        for (vtkIdType t = 0; t < n; ++t)
+        {
+          switch (op)
+          {
+            case VTK_PARSER_ADD: x[t] += y[t]; break;
+            case VTK_PARSER_SUBTRACT: x[t] -= y[t]; break;
+            case VTK_PARSER_MULTIPLY: x[t] *= y[t]; break;
+            case VTK_PARSER_POWER: x[t] = pow(x[t], y[t]); break;
+            case VTK_PARSER_MIN: x[t] = y[t] < x[t] ? y[t] : x[t]; break;
+            case VTK_PARSER_MAX: x[t] = y[t] > x[t] ? y[t] : x[t]; break;
+            case VTK_PARSER_LESS_THAN: x[t] = (x[t] < y[t]); break;
+            case VTK_PARSER_GREATER_THAN: x[t] = (x[t] > y[t]); break;
+            case VTK_PARSER_EQUAL_TO: x[t] = (x[t] == y[t]); break;
+            case VTK_PARSER_AND: x[t] = (x[t] && y[t]); break;
+            default: x[t] = (x[t] || y[t]); break;
+          }
+        }
+        stackPosition--;
+        break;
+      }
+      case VTK_PARSER_DIVIDE:
+        x = VTK_PARSER_COLUMN(stackPosition - 1);
+        y = VTK_PARSER_COLUMN(stackPosition);
+        for (vtkIdType t = 0; t < n; ++t)
+        {
+          if (y[t] == 0)
+          {
+            x[t] = replacement;
+            if (!replace)
+            {
+              invalid[t] = 1.0;
+            }
+          }
+          else
+          {
+            x[t] /= y[t];
+          }
+        }
+        stackPosition--;
+        break;
+      case VTK_PARSER_ABSOLUTE_VALUE:
+        vtkFunctionParserApply(VTK_PARSER_COLUMN(stackPosition), n,
+                               [](double a) { return fabs(a); });
+        break;
+      case VTK_PARSER_EXPONENT:
+        vtkFunctionParserApply(VTK_PARSER_COLUMN(stackPosition), n,
+                               [](double a) { return exp(a); });
+        break;
+      case VTK_PARSER_CEILING:
+        vtkFunctionParserApply(VTK_PARSER_COLUMN(stackPosition), n,
+                               [](double a) { return ceil(a); });
+        break;
+      case VTK_PARSER_FLOOR:
+        vtkFunctionParserApply(VTK_PARSER_COLUMN(stackPosition), n,
+                               [](double a) { return floor(a); });
+        break;
+      case VTK_PARSER_LOGARITHM:
+      case VTK_PARSER_LOGARITHME:
+        vtkFunctionParserApplyChecked(VTK_PARSER_COLUMN(stackPosition), n,
+          [](double a) { return a > 0; }, [](double a) { return log(a); },
+          replace, replacement, invalid);
+        break;
+      case VTK_PARSER_LOGARITHM10:
+        vtkFunctionParserApplyChecked(VTK_PARSER_COLUMN(stackPosition), n,
+          [](double a) { return a > 0; }, [](double a) { return log10(a); },
+          replace, replacement, invalid);
+        break;
+      case VTK_PARSER_SQUARE_ROOT:
+        vtkFunctionParserApplyChecked(VTK_PARSER_COLUMN(stackPosition), n,
+          [](double a) { return a >= 0; }, [](double a) { return sqrt(a); },
+          replace, replacement, invalid);
+        break;
+      case VTK_PARSER_SINE:
+        vtkFunctionParserApply(VTK_PARSER_COLUMN(stackPosition), n,
+                               [](double a) { return sin(a); });
+        break;
+      case VTK_PARSER_COSINE:
+        vtkFunctionParserApply(VTK_PARSER_COLUMN(stackPosition), n,
+                               [](double a) { return cos(a); });
+        break;
+      case VTK_PARSER_TANGENT:
+        vtkFunctionParserApply(VTK_PARSER_COLUMN(stackPosition), n,
+                               [](double a) { return tan(a); });
+        break;
+      case VTK_PARSER_ARCSINE:
+        vtkFunctionParserApplyChecked(VTK_PARSER_COLUMN(stackPosition), n,
+          [](double a) { return a >= -1 && a <= 1; },
+          [](double a) { return asin(a); }, replace, replacement, invalid);
+        break;
+      case VTK_PARSER_ARCCOSINE:
+        vtkFunctionParserApplyChecked(VTK_PARSER_COLUMN(stackPosition), n,
+          [](double a) { return a >= -1 && a <= 1; },
+          [](double a) { return acos(a); }, replace, replacement, invalid);
+        break;
+      case VTK_PARSER_ARCTANGENT:
+        vtkFunctionParserApply(VTK_PARSER_COLUMN(stackPosition), n,
+                               [](double a) { return atan(a); });
+        break;
+      case VTK_PARSER_HYPERBOLIC_SINE:
+        vtkFunctionParserApply(VTK_PARSER_COLUMN(stackPosition), n,
+                               [](double a) { return sinh(a); });
+        break;
+      case VTK_PARSER_HYPERBOLIC_COSINE:
+        vtkFunctionParserApply(VTK_PARSER_COLUMN(stackPosition), n,
+                               [](double a) { return cosh(a); });
+        break;
+      case VTK_PARSER_HYPERBOLIC_TANGENT:
+        vtkFunctionParserApply(VTK_PARSER_COLUMN(stackPosition), n,
+                               [](double a) { return tanh(a); });
+        break;
+      case VTK_PARSER_SIGN:
+        vtkFunctionParserApply(VTK_PARSER_COLUMN(stackPosition), n,
+          [](double a) { return a < 0 ? -1.0 : (a == 0 ? 0.0 : 1.0); });
+        break;
+      case VTK_PARSER_CROSS:
+      {
+        double* u[3] = { VTK_PARSER_COLUMN(stackPosition - 5),
+                         VTK_PARSER_COLUMN(stackPosition - 4),
+                         VTK_PARSER_COLUMN(stackPosition - 3) };
+        double* v[3] = { VTK_PARSER_COLUMN(stackPosition - 2),
+                         VTK_PARSER_COLUMN(stackPosition - 1),
+                         VTK_PARSER_COLUMN(stackPosition) };
+        for (vtkIdType t = 0; t < n; ++t)
+        {
+          double c0 = u[1][t] * v[2][t] - u[2][t] * v[1][t];
+          double c1 = u[2][t] * v[0][t] - u[0][t] * v[2][t];
+          double c2 = u[0][t] * v[1][t] - u[1][t] * v[0][t];
+          u[0][t] = c0;
+          u[1][t] = c1;
+          u[2][t] = c2;
+        }
+        stackPosition -= 3;
+        break;
+      }
+      case VTK_PARSER_VECTOR_UNARY_MINUS:
+        for (int c = 0; c < 3; ++c)
+        {
+          vtkFunctionParserApply(VTK_PARSER_COLUMN(stackPosition - c), n,
+                                 [](double a) { return -a; });
+        }
+        break;
+      case VTK_PARSER_DOT_PRODUCT:
+      {
+        double* u[3] = { VTK_PARSER_COLUMN(stackPosition - 5),
+                         VTK_PARSER_COLUMN(stackPosition - 4),
+                         VTK_PARSER_COLUMN(stackPosition - 3) };
+        double* v[3] = { VTK_PARSER_COLUMN(stackPosition - 2),
+                         VTK_PARSER_COLUMN(stackPosition - 1),
+                         VTK_PARSER_COLUMN(stackPosition) };
+        for (vtkIdType t = 0; t < n; ++t)
+        {
+          u[0][t] = u[0][t] * v[0][t] + u[1][t] * v[1][t] + u[2][t] * v[2][t];
+        }
+        stackPosition -= 5;
+        break;
+      }
+      case VTK_PARSER_VECTOR_ADD:
+      case VTK_PARSER_VECTOR_SUBTRACT:
+      {
+        const double sign =
+          this->ByteCode[i] == VTK_PARSER_VECTOR_ADD ? 1.0 : -1.0;
+        for (int c = 0; c < 3; ++c)
+        {
+          x = VTK_PARSER_COLUMN(stackPosition - 5 + c);
+          y = VTK_PARSER_COLUMN(stackPosition - 2 + c);
+          for (vtkIdType t = 0; t < n; ++t)
+          {
+            x[t] += sign * y[t];
+          }
+        }
+        stackPosition -= 3;
+        break;
+      }
+      case VTK_PARSER_SCALAR_TIMES_VECTOR:
+      {
+        // the scalar is below the vector, the scaled vector replaces both
+        double* s = VTK_PARSER_COLUMN(stackPosition - 3);
+        x = VTK_PARSER_COLUMN(stackPosition - 2);
+        y = VTK_PARSER_COLUMN(stackPosition - 1);
+        z = VTK_PARSER_COLUMN(stackPosition);
+        for (vtkIdType t = 0; t < n; ++t)
+        {
+          const double scale = s[t];
+          s[t] = x[t] * scale;
+          x[t] = y[t] * scale;
+          y[t] = z[t] * scale;
+        }
+        stackPosition--;
+        break;
+      }
+      case VTK_PARSER_VECTOR_TIMES_SCALAR:
+      case VTK_PARSER_VECTOR_OVER_SCALAR:
+      {
+        const bool divide = this->ByteCode[i] == VTK_PARSER_VECTOR_OVER_SCALAR;
+        y = VTK_PARSER_COLUMN(stackPosition);
+        for (int c = 1; c <= 3; ++c)
+        {
+          x = VTK_PARSER_COLUMN(stackPosition - c);
+          for (vtkIdType t = 0; t < n; ++t)
+          {
+            x[t] = divide ? x[t] / y[t] : x[t] * y[t];
+          }
+        }
+        stackPosition--;
+        break;
+      }
+      case VTK_PARSER_MAGNITUDE:
+      case VTK_PARSER_NORMALIZE:
+      {
+        x = VTK_PARSER_COLUMN(stackPosition - 2);
+        y = VTK_PARSER_COLUMN(stackPosition - 1);
+        z = VTK_PARSER_COLUMN(stackPosition);
+        const bool normalize = this->ByteCode[i] == VTK_PARSER_NORMALIZE;
+        for (vtkIdType t = 0; t < n; ++t)
+        {
+          double magnitude = sqrt(z[t] * z[t] + y[t] * y[t] + x[t] * x[t]);
+          if (!normalize)
+          {
+            x[t] = magnitude;
+          }
+          else if (magnitude != 0)
+          {
+            x[t] /= magnitude;
+            y[t] /= magnitude;
+            z[t] /= magnitude;
+          }
+        }
+        if (!normalize)
+        {
+          stackPosition -= 2;
+        }
+        break;
+      }
+      case VTK_PARSER_IHAT:
+      case VTK_PARSER_JHAT:
+      case VTK_PARSER_KHAT:
+        for (int c = 0; c < 3; ++c)
+        {
+          std::fill_n(VTK_PARSER_COLUMN(++stackPosition), n,
+                      this->ByteCode[i] - VTK_PARSER_IHAT == c ? 1.0 : 0.0);
+        }
+        break;
+      case VTK_PARSER_IF:
+      case VTK_PARSER_VECTOR_IF:
+      {
+        // the bool argument is on top of valtrue, itself on top of valfalse
+        const int size = this->ByteCode[i] == VTK_PARSER_IF ? 1 : 3;
+        const double* boolArg = VTK_PARSER_COLUMN(stackPosition);
+        for (int c = 0; c < size; ++c)
+        {
+          x = VTK_PARSER_COLUMN(stackPosition - 2 * size + c);
+          y = VTK_PARSER_COLUMN(stackPosition - size + c);
+          for (vtkIdType t = 0; t < n; ++t)
+          {
+            if (boolArg[t] != 0.0)
+            {
+              x[t] = y[t];
+            }
+          }
+        }
+        stackPosition -= size + 1;
+        break;
+      }
+      default:
+      {
+        const int variable = this->ByteCode[i] - VTK_PARSER_BEGIN_VARIABLES;
+        if (variable < numScalarVariables)
+        {
+          x = VTK_PARSER_COLUMN(++stackPosition);
+          const double* values = scalarValues ? scalarValues[variable] : nullptr;
+          if (values)
+          {
+            std::copy(values, values + n, x);
+          }
+          else
+          {
+            std::fill_n(x, n, this->ScalarVariableValues[variable]);
+          }
+        }
+        else
+        {
+          const int vectorNum = variable - numScalarVariables;
+          const double* values = vectorValues ? vectorValues[vectorNum] : nullptr;
+          for (int c = 0; c < 3; ++c)
+          {
+            x = VTK_PARSER_COLUMN(++stackPosition);
+            if (values)
+            {
+              for (vtkIdType t = 0; t < n; ++t)
+              {
+                x[t] = values[3 * t + c];
+              }
+            }
+            else
+            {
+              std::fill_n(x, n, this->VectorVariableValues[vectorNum][c]);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  if (stackPosition != 0 && stackPosition != 2)
+  {
+    return -1;
+  }
+
+  // gather the result, interleaving vector components
+  const int numComponents = stackPosition + 1;
+  vtkIdType numberOfInvalidTuples = 0;
+  for (int c = 0; c < numComponents; ++c)
+  {
+    x = VTK_PARSER_COLUMN(c);
+    for (vtkIdType t = 0; t < n; ++t)
+    {
+      result[numComponents * t + c] =
+        invalid[t] != 0.0 ? VTK_PARSER_ERROR_RESULT : x[t];
+    }
+  }
+  for (vtkIdType t = 0; t < n; ++t)
+  {
+    numberOfInvalidTuples += (invalid[t] != 0.0);
+  }
+#undef VTK_PARSER_COLUMN
+
+  return numberOfInvalidTuples;
+}
+
 //-----------------------------------------------------------------------------
 const char* vtkFunctionParser::GetScalarVariableName(int i)
 {
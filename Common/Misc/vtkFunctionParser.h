@@ -177,6 +177,31 @@ public:
     result[0] = r[0]; result[1] = r[1]; result[2] = r[2]; };
   //@}
 
+  /**
+   * Evaluate the function for a block of numberOfTuples tuples at once. The
+   * byte code is interpreted one operation at a time over the whole block
+   * instead of once per tuple. scalarValues[i] holds the numberOfTuples
+   * values of the i-th scalar variable and vectorValues[i] the
+   * 3*numberOfTuples interleaved values of the i-th vector variable; a
+   * nullptr entry (or array) uses the value set with SetScalarVariableValue()
+   * or SetVectorVariableValue() for every tuple. One value per tuple, or
+   * three interleaved values for a vector result, are written to result.
+   * workspace is resized as needed and can be reused between calls.
+   *
+   * The function must have been parsed beforehand, e.g. by IsScalarResult().
+   * The parser itself is not modified, so several threads can evaluate
+   * blocks concurrently, each one with its own workspace. Invalid operations
+   * are not reported: their value is ReplacementValue when
+   * ReplaceInvalidValues is on, otherwise the result of the tuple is
+   * VTK_PARSER_ERROR_RESULT. Returns the number of such invalid tuples, or
+   * -1 if the function has not been parsed.
+   */
+  vtkIdType EvaluateBlock(vtkIdType numberOfTuples,
+                          const double* const* scalarValues,
+                          const double* const* vectorValues,
+                          double* result,
+                          std::vector<double>& workspace) const;
+
   //@{
   /**
    * Set the value of a scalar variable.  If a variable with this name
@@ -658,5 +658,49 @@ int TestAppendFilter( int, char* [])
     return EXIT_FAILURE;
   }
 
+  // Append unstructured grids, whose cells are copied directly.
+  vtkNew<vtkAppendFilter> toGrid1;
+  toGrid1->AddInputData(d7);
+  toGrid1->Update();
+  vtkNew<vtkAppendFilter> toGrid2;
+  toGrid2->AddInputData(d8);
+  toGrid2->Update();
+  vtkNew<vtkAppendFilter> appendGrids;
+  appendGrids->AddInputConnection(toGrid1->GetOutputPort());
+  appendGrids->AddInputConnection(toGrid2->GetOutputPort());
+  appendGrids->Update();
+  vtkUnstructuredGrid* grids[2] = { toGrid1->GetOutput(), toGrid2->GetOutput() };
+  vtkUnstructuredGrid* appended = appendGrids->GetOutput();
+  vtkIdType cellOffset = 0, pointOffset = 0;
+  vtkNew<vtkIdList> inIds, outIds;
+  for (int i = 0; i < 2; ++i)
+  {
+    for (vtkIdType cellId = 0; cellId < grids[i]->GetNumberOfCells(); ++cellId)
+    {
+      grids[i]->GetCellPoints(cellId, inIds);
+      appended->GetCellPoints(cellId + cellOffset, outIds);
+      bool same = grids[i]->GetCellType(cellId) == appended->GetCellType(cellId + cellOffset) &&
+        inIds->GetNumberOfIds() == outIds->GetNumberOfIds();
+      for (vtkIdType j = 0; same && j < inIds->GetNumberOfIds(); ++j)
+      {
+        same = inIds->GetId(j) + pointOffset == outIds->GetId(j);
+      }
+      if (!same)
+      {
+        std::cerr << "vtkAppendFilter failed to append cell " << cellId
+                  << " of unstructured grid " << i << "\n";
+        return EXIT_FAILURE;
+      }
+    }
+    cellOffset += grids[i]->GetNumberOfCells();
+    pointOffset += grids[i]->GetNumberOfPoints();
+  }
+  if (appended->GetNumberOfCells() != cellOffset ||
+      appended->GetNumberOfPoints() != pointOffset)
+  {
+    std::cerr << "vtkAppendFilter failed to append unstructured grids\n";
+    return EXIT_FAILURE;
+  }
+
   return EXIT_SUCCESS;
 }
@@ -263,5 +263,20 @@ int TestAppendPolyData(int, char *[])
     return EXIT_FAILURE;
   }
 
+  // A single non empty input is passed through without copying.
+  vtkSmartPointer<vtkPolyData> emptyPolyData = vtkSmartPointer<vtkPolyData>::New();
+  vtkSmartPointer<vtkAppendPolyData> appendSingle = vtkSmartPointer<vtkAppendPolyData>::New();
+  appendSingle->AddInputData(emptyPolyData);
+  appendSingle->AddInputData(inputPolyData1);
+  appendSingle->Update();
+
+  if(appendSingle->GetOutput()->GetPoints() != inputPolyData1->GetPoints() ||
+     appendSingle->GetOutput()->GetNumberOfVerts() != inputPolyData1->GetNumberOfVerts())
+  {
+    std::cerr << "ERROR: A single non empty input should be shallow copied"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
   return EXIT_SUCCESS;
 }
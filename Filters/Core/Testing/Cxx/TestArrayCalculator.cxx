@@ -16,6 +16,8 @@
 #include <vtkArrayCalculator.h>
 #include <vtkCompositeDataPipeline.h>
 #include <vtkCellArray.h>
+#include <vtkDataArray.h>
+#include <vtkMath.h>
 #include <vtkPointData.h>
 #include <vtkPoints.h>
 #include <vtkPolyData.h>
@@ -23,6 +25,8 @@
 #include <vtkTestUtilities.h>
 #include <vtkXMLPolyDataReader.h>
 
+#include <cmath>
+
 #define VTK_CREATE(type, name) \
   vtkSmartPointer<type> name = vtkSmartPointer<type>::New ();
 
@@ -76,6 +80,39 @@ int TestArrayCalculator(int argc, char *argv[])
   //verify the output is correct
   vtkPolyData *result = vtkPolyData::SafeDownCast( calc3->GetOutput() );
   int retCode = result->GetPointData()->HasArray("Result");
+
+  //verify the values computed in blocks match the serial evaluation
+  VTK_CREATE(vtkArrayCalculator, calc4);
+  calc4->SetInputConnection( calc2->GetOutputPort() );
+  calc4->SetAttributeTypeToPointData();
+  calc4->AddVectorArrayName("PresVector");
+  calc4->AddCoordinateScalarVariable("coordsX", 0);
+  calc4->AddCoordinateVectorVariable("coords", 0, 1, 2);
+  calc4->SetFunction("coordsX*PresVector + cross(coords, PresVector)");
+  calc4->SetResultArrayName("Check");
+  calc4->Update();
+
+  vtkPolyData* checked = vtkPolyData::SafeDownCast(calc4->GetOutput());
+  vtkDataArray* presVector = checked->GetPointData()->GetArray("PresVector");
+  vtkDataArray* check = checked->GetPointData()->GetArray("Check");
+  for (vtkIdType i = 0; retCode && i < checked->GetNumberOfPoints(); ++i)
+  {
+    double p[3], v[3], c[3], expected[3];
+    checked->GetPoint(i, p);
+    presVector->GetTuple(i, v);
+    check->GetTuple(i, c);
+    vtkMath::Cross(p, v, expected);
+    for (int k = 0; k < 3; ++k)
+    {
+      expected[k] += p[0] * v[k];
+      if (std::abs(expected[k] - c[k]) > 1e-6 * (1.0 + std::abs(expected[k])))
+      {
+        std::cerr << "Wrong value at point " << i << ": " << c[k]
+                  << " != " << expected[k] << std::endl;
+        retCode = 0;
+      }
+    }
+  }
   vtkAlgorithm::SetDefaultExecutivePrototype(nullptr);
   return !retCode;
 }
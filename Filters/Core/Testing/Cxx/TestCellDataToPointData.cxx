@@ -13,13 +13,17 @@
 
 =========================================================================*/
 
+#include <vtkCellArray.h>
 #include <vtkCellDataToPointData.h>
 #include <vtkDataArray.h>
 #include <vtkCellData.h>
 #include <vtkDataSet.h>
 #include <vtkDataSetTriangleFilter.h>
+#include <vtkDoubleArray.h>
 #include <vtkPointData.h>
 #include <vtkPointDataToCellData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
 #include <vtkRTAnalyticSource.h>
 #include <vtkSmartPointer.h>
 #include <vtkUnstructuredGrid.h>
@@ -96,5 +100,46 @@ int TestCellDataToPointData (int, char*[])
       return EXIT_FAILURE;
     }
   }
+
+  // mixed dimension cells: a triangle (0,1,2) with value 1 and a line (2,3)
+  // with value 3 sharing point 2.
+  vsp(Points, points);
+    points->InsertNextPoint(0, 0, 0);
+    points->InsertNextPoint(1, 0, 0);
+    points->InsertNextPoint(0, 1, 0);
+    points->InsertNextPoint(0, 2, 0);
+  vsp(CellArray, lines);
+    vtkIdType const line[2] = {2, 3};
+    lines->InsertNextCell(2, line);
+  vsp(CellArray, polys);
+    vtkIdType const tri[3] = {0, 1, 2};
+    polys->InsertNextCell(3, tri);
+  vsp(DoubleArray, values);
+    values->SetName(name);
+    values->InsertNextValue(3);
+    values->InsertNextValue(1);
+  vsp(PolyData, mixed);
+    mixed->SetPoints(points);
+    mixed->SetLines(lines);
+    mixed->SetPolys(polys);
+    mixed->GetCellData()->AddArray(values);
+
+  // expected values at points 2 and 3 for All, Patch and DataSetMax
+  double const expected[3][2] = {{2, 3}, {1, 3}, {1, 0}};
+  vsp(CellDataToPointData, mc2p);
+    mc2p->SetInputData(mixed);
+  for (int opt=0;opt<3;opt++)
+  {
+    mc2p->SetContributingCellOption(opt);
+    mc2p->Update();
+    vtkDataArray* const z = mc2p->GetOutput()->GetPointData()->GetArray(name);
+    if (!z || z->GetTuple1(0) != 1 ||
+        z->GetTuple1(2) != expected[opt][0] ||
+        z->GetTuple1(3) != expected[opt][1])
+    {
+      cerr << "Failure on mixed cells with option " << opt << endl;
+      return EXIT_FAILURE;
+    }
+  }
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,227 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestConnectivityFilterParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Labels a set of disjoint spheres with the serial traversal and with the
+// parallel union-find of both connectivity filters, and checks that they
+// find the same regions, and that the regions can be ordered by size.
+
+#include <vtkAppendFilter.h>
+#include <vtkAppendPolyData.h>
+#include <vtkCellData.h>
+#include <vtkConnectivityFilter.h>
+#include <vtkDoubleArray.h>
+#include <vtkIdList.h>
+#include <vtkIdTypeArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataConnectivityFilter.h>
+#include <vtkSphereSource.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+const int NumberOfSpheres = 12;
+
+// Cells of the largest sphere.
+vtkIdType LargestSphere = 0;
+
+void MakeSpheres(vtkPolyData* output)
+{
+  vtkNew<vtkAppendPolyData> append;
+  for (int i = 0; i < NumberOfSpheres; ++i)
+  {
+    // Resolutions are chosen so that no two spheres have the same size.
+    int resolution = 8 + 5 * ((i * 7) % NumberOfSpheres);
+    vtkNew<vtkSphereSource> sphere;
+    sphere->SetCenter(3.0 * i, 0.0, 0.0);
+    sphere->SetThetaResolution(resolution);
+    sphere->SetPhiResolution(resolution);
+    sphere->Update();
+    LargestSphere = std::max(LargestSphere,
+                             sphere->GetOutput()->GetNumberOfCells());
+    append->AddInputData(sphere->GetOutput());
+  }
+  append->Update();
+  output->ShallowCopy(append->GetOutput());
+}
+
+// Region of every output cell, taken from the RegionId of its first point.
+bool CellRegionIds(vtkDataSet* output, std::vector<double>& regionIds)
+{
+  vtkDataArray* pointRegionIds = output->GetPointData()->GetArray("RegionId");
+  if (!pointRegionIds)
+  {
+    std::cerr << "Missing RegionId array." << std::endl;
+    return false;
+  }
+  vtkNew<vtkIdList> ptIds;
+  regionIds.resize(output->GetNumberOfCells());
+  for (vtkIdType i = 0; i < output->GetNumberOfCells(); ++i)
+  {
+    output->GetCellPoints(i, ptIds);
+    regionIds[i] = pointRegionIds->GetTuple1(ptIds->GetId(0));
+  }
+  return true;
+}
+
+bool CheckDescending(vtkIdTypeArray* sizes)
+{
+  for (vtkIdType i = 1; i < sizes->GetNumberOfTuples(); ++i)
+  {
+    if (sizes->GetValue(i) > sizes->GetValue(i - 1))
+    {
+      std::cerr << "Region sizes are not in descending order." << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename TFilter>
+bool TestFilter(vtkDataSet* input)
+{
+  vtkNew<TFilter> serial;
+  serial->SetInputData(input);
+  serial->SetExtractionModeToAllRegions();
+  serial->ColorRegionsOn();
+  serial->Update();
+
+  vtkNew<TFilter> parallel;
+  parallel->SetInputData(input);
+  parallel->SetExtractionModeToAllRegions();
+  parallel->ColorRegionsOn();
+  parallel->ParallelLabelingOn();
+  parallel->Update();
+
+  if (serial->GetNumberOfExtractedRegions() != NumberOfSpheres ||
+      parallel->GetNumberOfExtractedRegions() != NumberOfSpheres)
+  {
+    std::cerr << "Expected " << NumberOfSpheres << " regions, got "
+              << serial->GetNumberOfExtractedRegions() << " (serial) and "
+              << parallel->GetNumberOfExtractedRegions() << " (parallel)"
+              << std::endl;
+    return false;
+  }
+  for (int i = 0; i < NumberOfSpheres; ++i)
+  {
+    if (serial->GetRegionSizes()->GetValue(i) !=
+        parallel->GetRegionSizes()->GetValue(i))
+    {
+      std::cerr << "Size of region " << i << " differs." << std::endl;
+      return false;
+    }
+  }
+
+  // All regions are extracted, so the output cells are in input order.
+  std::vector<double> serialIds, parallelIds;
+  vtkDataSet* parallelOutput = vtkDataSet::SafeDownCast(parallel->GetOutput());
+  if (!CellRegionIds(vtkDataSet::SafeDownCast(serial->GetOutput()), serialIds) ||
+      !CellRegionIds(parallelOutput, parallelIds))
+  {
+    return false;
+  }
+  if (parallelOutput->GetNumberOfPoints() != input->GetNumberOfPoints() ||
+      serialIds != parallelIds)
+  {
+    std::cerr << "Serial and parallel region ids differ." << std::endl;
+    return false;
+  }
+
+  // Largest region first.
+  parallel->SetRegionIdAssignmentMode(TFilter::CELL_COUNT_DESCENDING);
+  parallel->Update();
+  if (!CheckDescending(parallel->GetRegionSizes()) ||
+      parallel->GetRegionSizes()->GetValue(0) != LargestSphere)
+  {
+    return false;
+  }
+
+  // The largest region must be the same whatever the numbering.
+  parallel->SetExtractionModeToLargestRegion();
+  parallel->Update();
+  serial->SetExtractionModeToLargestRegion();
+  serial->Update();
+  vtkDataSet* largest = vtkDataSet::SafeDownCast(parallel->GetOutput());
+  if (largest->GetNumberOfCells() != LargestSphere ||
+      vtkDataSet::SafeDownCast(serial->GetOutput())->GetNumberOfCells() !=
+        LargestSphere)
+  {
+    std::cerr << "Wrong largest region." << std::endl;
+    return false;
+  }
+
+  // Scalar connectivity: only the cells in the band |z| < 0.25 connect, so
+  // every sphere gives one band region plus one region per other cell.
+  vtkNew<TFilter> scalar;
+  scalar->SetInputData(input);
+  scalar->SetExtractionModeToAllRegions();
+  scalar->ScalarConnectivityOn();
+  scalar->SetScalarRange(-0.25, 0.25);
+  scalar->ParallelLabelingOn();
+  scalar->Update();
+  vtkIdType total = 0;
+  vtkIdType bands = 0;
+  vtkIdTypeArray* sizes = scalar->GetRegionSizes();
+  for (vtkIdType i = 0; i < sizes->GetNumberOfTuples(); ++i)
+  {
+    total += sizes->GetValue(i);
+    bands += (sizes->GetValue(i) > 1 ? 1 : 0);
+  }
+  if (total != input->GetNumberOfCells() || bands != NumberOfSpheres)
+  {
+    std::cerr << "Scalar connectivity found " << bands << " bands for "
+              << total << " cells." << std::endl;
+    return false;
+  }
+
+  return true;
+}
+}
+
+int TestConnectivityFilterParallel(int, char*[])
+{
+  vtkNew<vtkPolyData> spheres;
+  MakeSpheres(spheres);
+
+  // Scalars for the scalar connectivity test.
+  vtkNew<vtkDoubleArray> z;
+  z->SetNumberOfTuples(spheres->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < spheres->GetNumberOfPoints(); ++i)
+  {
+    z->SetValue(i, spheres->GetPoint(i)[2]);
+  }
+  spheres->GetPointData()->SetScalars(z);
+
+  if (!TestFilter<vtkPolyDataConnectivityFilter>(spheres))
+  {
+    std::cerr << "vtkPolyDataConnectivityFilter failed." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkAppendFilter> toGrid;
+  toGrid->AddInputData(spheres);
+  toGrid->Update();
+  if (!TestFilter<vtkConnectivityFilter>(toGrid->GetOutput()))
+  {
+    std::cerr << "vtkConnectivityFilter failed." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,351 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestContourGridParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Contours and cuts an unstructured grid of lines, quads, hexahedra and
+// tetrahedra with several values, serially and in parallel (with and
+// without a scalar tree), and checks that the outputs have the same cells,
+// in the same order, with the same points and attributes. Also checks that
+// the parallel filters report progress and can be aborted.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkCommand.h>
+#include <vtkContourGrid.h>
+#include <vtkCutter.h>
+#include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSpanSpace.h>
+#include <vtkSphere.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+const int Size = 16;
+
+vtkIdType PointId(int i, int j, int k)
+{
+  return i + Size * (j + Size * k);
+}
+
+void MakeGrid(vtkUnstructuredGrid* grid)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("Scalars");
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  for (int k = 0; k < Size; ++k)
+  {
+    for (int j = 0; j < Size; ++j)
+    {
+      for (int i = 0; i < Size; ++i)
+      {
+        double x = 0.1 * i, y = 0.1 * j, z = 0.1 * k;
+        points->InsertNextPoint(x, y, z);
+        scalars->InsertNextValue(std::sin(3 * x) + std::cos(2 * y) + z * z);
+        vectors->InsertNextTuple3(x + y, y * z, z - x);
+      }
+    }
+  }
+  grid->SetPoints(points);
+  grid->Allocate(6 * Size * Size * Size);
+
+  vtkNew<vtkIntArray> cellIds;
+  cellIds->SetName("CellIds");
+  for (int i = 0; i + 1 < Size; ++i)
+  {
+    vtkIdType line[2] = { PointId(i, 0, 0), PointId(i + 1, 0, 0) };
+    cellIds->InsertNextValue(grid->InsertNextCell(VTK_LINE, 2, line));
+  }
+  static const int tetras[5][4] = { { 0, 1, 3, 4 }, { 1, 2, 3, 6 },
+    { 1, 4, 5, 6 }, { 3, 4, 6, 7 }, { 1, 3, 4, 6 } };
+  for (int k = 0; k + 1 < Size; ++k)
+  {
+    for (int j = 0; j + 1 < Size; ++j)
+    {
+      for (int i = 0; i + 1 < Size; ++i)
+      {
+        vtkIdType hex[8] = { PointId(i, j, k), PointId(i + 1, j, k),
+          PointId(i + 1, j + 1, k), PointId(i, j + 1, k),
+          PointId(i, j, k + 1), PointId(i + 1, j, k + 1),
+          PointId(i + 1, j + 1, k + 1), PointId(i, j + 1, k + 1) };
+        if ((i + 2 * j + k) % 4 < 2)
+        {
+          cellIds->InsertNextValue(grid->InsertNextCell(VTK_HEXAHEDRON, 8, hex));
+        }
+        else
+        {
+          for (int t = 0; t < 5; ++t)
+          {
+            vtkIdType tetra[4] = { hex[tetras[t][0]], hex[tetras[t][1]],
+              hex[tetras[t][2]], hex[tetras[t][3]] };
+            cellIds->InsertNextValue(grid->InsertNextCell(VTK_TETRA, 4, tetra));
+          }
+        }
+        if (k == 0)
+        {
+          // 2D cells interleaved with the 3D ones
+          cellIds->InsertNextValue(grid->InsertNextCell(VTK_QUAD, 4, hex));
+        }
+      }
+    }
+  }
+  grid->GetPointData()->SetScalars(scalars);
+  grid->GetPointData()->AddArray(vectors);
+  grid->GetCellData()->AddArray(cellIds);
+}
+
+bool SameTuple(vtkDataArray* a, vtkIdType i, vtkDataArray* b, vtkIdType j)
+{
+  if (!a || !b || a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+  {
+    if (a->GetComponent(i, c) != b->GetComponent(j, c))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Compares the cells of both outputs through the coordinates and point data
+// of their points: the serial locator may leave coincident points unmerged
+// (when they fall on a bucket boundary) where the parallel merge does not.
+bool SameCells(vtkPolyData* serial, vtkCellArray* a, vtkPolyData* parallel,
+               vtkCellArray* b)
+{
+  if (a->GetNumberOfCells() != b->GetNumberOfCells())
+  {
+    return false;
+  }
+  vtkIdType npts, *pts, numPts, *ids;
+  a->InitTraversal();
+  b->InitTraversal();
+  while (a->GetNextCell(npts, pts) && b->GetNextCell(numPts, ids))
+  {
+    if (npts != numPts)
+    {
+      return false;
+    }
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      if (!SameTuple(serial->GetPoints()->GetData(), pts[i],
+                     parallel->GetPoints()->GetData(), ids[i]))
+      {
+        return false;
+      }
+      for (int d = 0; d < serial->GetPointData()->GetNumberOfArrays(); ++d)
+      {
+        if (!SameTuple(serial->GetPointData()->GetArray(d), pts[i],
+                       parallel->GetPointData()->GetArray(d), ids[i]))
+        {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool SameOutput(vtkPolyData* serial, vtkPolyData* parallel, bool cellData)
+{
+  if (serial->GetNumberOfCells() == 0 ||
+      parallel->GetNumberOfPoints() > serial->GetNumberOfPoints())
+  {
+    std::cerr << "Expected at most " << serial->GetNumberOfPoints()
+              << " points, got " << parallel->GetNumberOfPoints()
+              << std::endl;
+    return false;
+  }
+  if (!SameCells(serial, serial->GetVerts(), parallel, parallel->GetVerts()) ||
+      !SameCells(serial, serial->GetLines(), parallel, parallel->GetLines()) ||
+      !SameCells(serial, serial->GetPolys(), parallel, parallel->GetPolys()))
+  {
+    std::cerr << "Cells differ." << std::endl;
+    return false;
+  }
+  if (cellData)
+  {
+    vtkDataArray* a = serial->GetCellData()->GetArray("CellIds");
+    vtkDataArray* b = parallel->GetCellData()->GetArray("CellIds");
+    for (vtkIdType i = 0; i < serial->GetNumberOfCells(); ++i)
+    {
+      if (!SameTuple(a, i, b, i))
+      {
+        std::cerr << "Cell data differs." << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Records the progress of an algorithm, and aborts it once the progress
+// reaches AbortProgress.
+class ProgressObserver : public vtkCommand
+{
+public:
+  static ProgressObserver* New() { return new ProgressObserver; }
+
+  void Execute(vtkObject* caller, unsigned long, void* callData) override
+  {
+    double progress = *static_cast<double*>(callData);
+    this->Progress.push_back(progress);
+    if (progress >= this->AbortProgress)
+    {
+      static_cast<vtkAlgorithm*>(caller)->AbortExecuteOn();
+    }
+  }
+
+  std::vector<double> Progress;
+  double AbortProgress = 2.0;
+};
+
+// The lines, the quads and the 3D cells are contoured in three passes, each
+// reporting its progress. Aborting after the first pass leaves the contours
+// of the lines only (if any).
+bool TestProgressAndAbort(vtkPolyDataAlgorithm* filter)
+{
+  vtkNew<ProgressObserver> observer;
+  filter->AddObserver(vtkCommand::ProgressEvent, observer);
+  filter->Modified();
+  filter->Update();
+  bool inPass = false;
+  for (size_t i = 0; i < observer->Progress.size(); ++i)
+  {
+    inPass = inPass ||
+      (observer->Progress[i] > 0.0 && observer->Progress[i] < 1.0);
+    if (i > 0 && observer->Progress[i] < observer->Progress[i - 1])
+    {
+      std::cerr << "Progress goes backwards." << std::endl;
+      return false;
+    }
+  }
+  if (!inPass || observer->Progress.back() != 1.0)
+  {
+    std::cerr << "Progress is not reported while contouring." << std::endl;
+    return false;
+  }
+
+  vtkPolyData* output = filter->GetOutput();
+  vtkIdType numVerts = output->GetNumberOfVerts();
+  if (output->GetNumberOfLines() == 0 || output->GetNumberOfPolys() == 0)
+  {
+    std::cerr << "Expected lines and polys." << std::endl;
+    return false;
+  }
+
+  observer->Progress.clear();
+  observer->AbortProgress = 0.3;
+  filter->Modified();
+  filter->Update();
+  if (output->GetNumberOfVerts() != numVerts ||
+      output->GetNumberOfLines() != 0 || output->GetNumberOfPolys() != 0)
+  {
+    std::cerr << "Contouring was not aborted after the first pass: "
+              << output->GetNumberOfVerts() << " verts, "
+              << output->GetNumberOfLines() << " lines, "
+              << output->GetNumberOfPolys() << " polys." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestContourGrid(vtkUnstructuredGrid* grid, bool useScalarTree)
+{
+  vtkNew<vtkContourGrid> serial;
+  vtkNew<vtkContourGrid> parallel;
+  vtkContourGrid* contours[2] = { serial, parallel };
+  for (int i = 0; i < 2; ++i)
+  {
+    contours[i]->SetInputData(grid);
+    contours[i]->SetValue(0, 0.55);
+    contours[i]->SetValue(1, 1.25);
+    contours[i]->SetValue(2, 1.9);
+    contours[i]->SetParallelContouring(i == 1);
+    if (useScalarTree)
+    {
+      vtkNew<vtkSpanSpace> tree;
+      contours[i]->SetScalarTree(tree);
+      contours[i]->UseScalarTreeOn();
+    }
+    contours[i]->Update();
+  }
+  // With a scalar tree, the serial algorithm does not keep the cell data
+  // of lower dimensional cells in order.
+  return SameOutput(serial->GetOutput(), parallel->GetOutput(),
+                    !useScalarTree) &&
+    (useScalarTree || TestProgressAndAbort(parallel));
+}
+
+bool TestCutter(vtkUnstructuredGrid* grid)
+{
+  vtkNew<vtkSphere> sphere;
+  sphere->SetCenter(0.52, 0.47, 0.5);
+  sphere->SetRadius(0.33);
+
+  vtkNew<vtkCutter> serial;
+  vtkNew<vtkCutter> parallel;
+  vtkCutter* cutters[2] = { serial, parallel };
+  for (int i = 0; i < 2; ++i)
+  {
+    cutters[i]->SetInputData(grid);
+    cutters[i]->SetCutFunction(sphere);
+    cutters[i]->SetValue(0, 0.0);
+    cutters[i]->SetValue(1, 0.21);
+    cutters[i]->GenerateCutScalarsOn();
+    cutters[i]->SetParallelCutting(i == 1);
+    cutters[i]->Update();
+  }
+  return SameOutput(serial->GetOutput(), parallel->GetOutput(), true) &&
+    TestProgressAndAbort(parallel);
+}
+}
+
+int TestContourGridParallel(int, char*[])
+{
+  vtkNew<vtkUnstructuredGrid> grid;
+  MakeGrid(grid);
+
+  if (!TestContourGrid(grid, false))
+  {
+    std::cerr << "Parallel contouring failed." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (!TestContourGrid(grid, true))
+  {
+    std::cerr << "Parallel contouring with a scalar tree failed."
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (!TestCutter(grid))
+  {
+    std::cerr << "Parallel cutting failed." << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,244 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestFeatureEdgesParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Extracts boundary, non-manifold, feature and manifold edges from a folded
+// mesh of quads, triangles and strips, with a hole, a fin and ghost cells,
+// serially and in parallel, and checks that the outputs are identical.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDoubleArray.h>
+#include <vtkFeatureEdges.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkUnsignedCharArray.h>
+
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+const int Size = 24;
+
+vtkIdType PointId(int i, int j)
+{
+  return i + Size * j;
+}
+
+void MakeMesh(vtkPolyData* mesh, bool ghosts)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> values;
+  values->SetName("Values");
+  for (int j = 0; j < Size; ++j)
+  {
+    for (int i = 0; i < Size; ++i)
+    {
+      // folded along i == Size / 2, with some bumps
+      double z = 0.5 * std::abs(i - Size / 2) + 0.05 * std::sin(1.3 * j);
+      points->InsertNextPoint(i, j, z);
+      values->InsertNextValue(i + 0.01 * j);
+    }
+  }
+  // the tip of a fin on the edge (2, 2) - (3, 2)
+  points->InsertNextPoint(2.5, 2.0, 3.0);
+  values->InsertNextValue(-1.0);
+  mesh->SetPoints(points);
+  mesh->GetPointData()->AddArray(values);
+
+  vtkNew<vtkCellArray> polys;
+  vtkNew<vtkCellArray> strips;
+  for (int j = 0; j + 1 < Size; ++j)
+  {
+    if (j == Size - 3)
+    {
+      // the last rows are a strip
+      vtkIdType strip[2 * Size];
+      for (int i = 0; i < Size; ++i)
+      {
+        strip[2 * i] = PointId(i, j + 1);
+        strip[2 * i + 1] = PointId(i, j);
+      }
+      strips->InsertNextCell(2 * Size, strip);
+      continue;
+    }
+    for (int i = 0; i + 1 < Size; ++i)
+    {
+      if (i > 5 && i < 9 && j > 5 && j < 8)
+      {
+        continue; // a hole
+      }
+      vtkIdType quad[4] = { PointId(i, j), PointId(i + 1, j),
+        PointId(i + 1, j + 1), PointId(i, j + 1) };
+      if ((i + j) % 3 == 0)
+      {
+        vtkIdType tri1[3] = { quad[0], quad[1], quad[2] };
+        vtkIdType tri2[3] = { quad[0], quad[2], quad[3] };
+        polys->InsertNextCell(3, tri1);
+        polys->InsertNextCell(3, tri2);
+      }
+      else
+      {
+        polys->InsertNextCell(4, quad);
+      }
+    }
+  }
+  vtkIdType fin[3] = { PointId(2, 2), PointId(3, 2), Size * Size };
+  polys->InsertNextCell(3, fin);
+  mesh->SetPolys(polys);
+  mesh->SetStrips(strips);
+
+  vtkIdType numCells = polys->GetNumberOfCells() + strips->GetNumberOfCells();
+  vtkNew<vtkIntArray> cellIds;
+  cellIds->SetName("CellIds");
+  for (vtkIdType i = 0; i < numCells; ++i)
+  {
+    cellIds->InsertNextValue(static_cast<int>(i));
+  }
+  mesh->GetCellData()->AddArray(cellIds);
+  if (ghosts)
+  {
+    vtkNew<vtkUnsignedCharArray> ghostArray;
+    ghostArray->SetName(vtkDataSetAttributes::GhostArrayName());
+    for (vtkIdType i = 0; i < numCells; ++i)
+    {
+      ghostArray->InsertNextValue(
+        i % 7 == 0 ? vtkDataSetAttributes::DUPLICATECELL : 0);
+    }
+    mesh->GetCellData()->AddArray(ghostArray);
+  }
+}
+
+bool SameArrays(vtkDataSetAttributes* a, vtkDataSetAttributes* b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray* x = a->GetArray(i);
+    vtkDataArray* y = b->GetArray(x->GetName());
+    if (!y || x->GetNumberOfTuples() != y->GetNumberOfTuples() ||
+        x->GetNumberOfComponents() != y->GetNumberOfComponents())
+    {
+      return false;
+    }
+    for (vtkIdType t = 0; t < x->GetNumberOfTuples(); ++t)
+    {
+      for (int c = 0; c < x->GetNumberOfComponents(); ++c)
+      {
+        if (x->GetComponent(t, c) != y->GetComponent(t, c))
+        {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool SameOutput(vtkPolyData* serial, vtkPolyData* parallel)
+{
+  if (serial->GetNumberOfPoints() != parallel->GetNumberOfPoints() ||
+      serial->GetNumberOfLines() != parallel->GetNumberOfLines())
+  {
+    std::cerr << "Expected " << serial->GetNumberOfPoints() << " points and "
+              << serial->GetNumberOfLines() << " lines, got "
+              << parallel->GetNumberOfPoints() << " and "
+              << parallel->GetNumberOfLines() << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < serial->GetNumberOfPoints(); ++i)
+  {
+    double x[3], y[3];
+    serial->GetPoint(i, x);
+    parallel->GetPoint(i, y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+    {
+      std::cerr << "Point " << i << " differs." << std::endl;
+      return false;
+    }
+  }
+  vtkIdType npts, *pts, numPts, *ids;
+  vtkCellArray* a = serial->GetLines();
+  vtkCellArray* b = parallel->GetLines();
+  a->InitTraversal();
+  b->InitTraversal();
+  while (a->GetNextCell(npts, pts) && b->GetNextCell(numPts, ids))
+  {
+    if (npts != 2 || numPts != 2 || pts[0] != ids[0] || pts[1] != ids[1])
+    {
+      std::cerr << "Lines differ." << std::endl;
+      return false;
+    }
+  }
+  if (!SameArrays(serial->GetPointData(), parallel->GetPointData()) ||
+      !SameArrays(serial->GetCellData(), parallel->GetCellData()))
+  {
+    std::cerr << "Attributes differ." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool TestFeatureEdges(vtkPolyData* mesh, bool boundary, bool nonManifold,
+                      bool feature, bool manifold, bool coloring)
+{
+  vtkNew<vtkFeatureEdges> serial;
+  vtkNew<vtkFeatureEdges> parallel;
+  vtkFeatureEdges* filters[2] = { serial, parallel };
+  for (int i = 0; i < 2; ++i)
+  {
+    filters[i]->SetInputData(mesh);
+    filters[i]->SetBoundaryEdges(boundary);
+    filters[i]->SetNonManifoldEdges(nonManifold);
+    filters[i]->SetFeatureEdges(feature);
+    filters[i]->SetManifoldEdges(manifold);
+    filters[i]->SetColoring(coloring);
+    filters[i]->SetFeatureAngle(20.0);
+    filters[i]->SetParallelExtraction(i == 1);
+    filters[i]->Update();
+  }
+  if (serial->GetOutput()->GetNumberOfLines() == 0)
+  {
+    std::cerr << "No edges extracted." << std::endl;
+    return false;
+  }
+  return SameOutput(serial->GetOutput(), parallel->GetOutput());
+}
+}
+
+int TestFeatureEdgesParallel(int, char*[])
+{
+  for (int ghosts = 0; ghosts < 2; ++ghosts)
+  {
+    vtkNew<vtkPolyData> mesh;
+    MakeMesh(mesh, ghosts == 1);
+    if (!TestFeatureEdges(mesh, true, true, true, false, true) ||
+        !TestFeatureEdges(mesh, true, true, true, true, true) ||
+        !TestFeatureEdges(mesh, false, true, false, true, false) ||
+        !TestFeatureEdges(mesh, true, false, false, false, true) ||
+        !TestFeatureEdges(mesh, false, false, true, false, false))
+    {
+      std::cerr << "Parallel feature edges failed"
+                << (ghosts ? " with ghost cells." : ".") << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
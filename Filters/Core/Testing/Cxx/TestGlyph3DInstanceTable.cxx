@@ -0,0 +1,169 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGlyph3DInstanceTable.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compares the instance table of vtkGlyph3D with the expanded glyphs.
+
+#include "vtkConeSource.h"
+#include "vtkDataArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkGlyph3D.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkMatrix4x4.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkTransform.h"
+
+#include <cmath>
+#include <iostream>
+
+int TestGlyph3DInstanceTable(int, char*[])
+{
+  const vtkIdType numInputPts = 50;
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("Vectors");
+  vectors->SetNumberOfComponents(3);
+  for (vtkIdType i = 0; i < numInputPts; ++i)
+  {
+    double t = 0.3 * i;
+    points->InsertNextPoint(std::cos(t), std::sin(t), 0.1 * i);
+    scalars->InsertNextValue(0.5 + 0.05 * i);
+    // include a vector along -x, which is flipped instead of rotated
+    if (i == 7)
+    {
+      vectors->InsertNextTuple3(-2.0, 0.0, 0.0);
+    }
+    else
+    {
+      vectors->InsertNextTuple3(std::sin(t), 1.0, std::cos(2.0 * t));
+    }
+  }
+  vtkNew<vtkPolyData> input;
+  input->SetPoints(points);
+  input->GetPointData()->SetScalars(scalars);
+  input->GetPointData()->SetVectors(vectors);
+
+  vtkNew<vtkConeSource> cone;
+  cone->SetResolution(8);
+  cone->Update();
+  vtkPolyData* source = cone->GetOutput();
+  const vtkIdType numSourcePts = source->GetNumberOfPoints();
+
+  vtkNew<vtkGlyph3D> glyph;
+  glyph->SetInputData(input);
+  glyph->SetSourceConnection(cone->GetOutputPort());
+  glyph->SetScaleModeToScaleByVector();
+  glyph->SetScaleFactor(0.25);
+  glyph->GeneratePointIdsOn();
+  glyph->Update();
+
+  vtkNew<vtkPolyData> expanded;
+  expanded->DeepCopy(glyph->GetOutput());
+  if (expanded->GetNumberOfPoints() != numInputPts * numSourcePts ||
+      expanded->GetNumberOfCells() != numInputPts * source->GetNumberOfCells())
+  {
+    std::cerr << "Unexpected glyph output size: "
+              << expanded->GetNumberOfPoints() << " points, "
+              << expanded->GetNumberOfCells() << " cells" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  glyph->GenerateInstanceTableOn();
+  glyph->Update();
+  vtkPolyData* table = glyph->GetOutput();
+  if (table->GetNumberOfPoints() != numInputPts ||
+      table->GetNumberOfVerts() != numInputPts)
+  {
+    std::cerr << "Expected " << numInputPts << " instances, got "
+              << table->GetNumberOfPoints() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkDataArray* transforms = table->GetPointData()->GetArray("GlyphTransform");
+  vtkIntArray* sourceIndices = vtkIntArray::SafeDownCast(
+    table->GetPointData()->GetArray("GlyphSourceIndex"));
+  vtkDataArray* pointIds = table->GetPointData()->GetArray("InputPointIds");
+  if (!transforms || transforms->GetNumberOfComponents() != 16 ||
+      !sourceIndices || !pointIds)
+  {
+    std::cerr << "Missing instance arrays" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Every expanded glyph point must be the source point transformed by the
+  // matrix of its instance.
+  for (vtkIdType i = 0; i < numInputPts; ++i)
+  {
+    if (sourceIndices->GetValue(i) != 0 ||
+        static_cast<vtkIdType>(pointIds->GetComponent(i, 0)) != i)
+    {
+      std::cerr << "Bad instance " << i << std::endl;
+      return EXIT_FAILURE;
+    }
+    double m[16];
+    transforms->GetTuple(i, m);
+
+    // the matrix must match the translate/rotate/scale composition
+    double x[3], v[3];
+    input->GetPoint(i, x);
+    vectors->GetTuple(i, v);
+    double vMag = vtkMath::Norm(v);
+    vtkNew<vtkTransform> trans;
+    trans->Translate(x);
+    if (v[1] == 0.0 && v[2] == 0.0)
+    {
+      trans->RotateWXYZ(180.0, 0.0, 1.0, 0.0);
+    }
+    else
+    {
+      trans->RotateWXYZ(180.0, (v[0] + vMag) / 2.0, v[1] / 2.0, v[2] / 2.0);
+    }
+    trans->Scale(0.25 * vMag, 0.25 * vMag, 0.25 * vMag);
+    for (int c = 0; c < 16; ++c)
+    {
+      if (std::abs(trans->GetMatrix()->GetElement(c / 4, c % 4) - m[c]) > 1e-9)
+      {
+        std::cerr << "Instance " << i << " has a bad transform" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    for (vtkIdType j = 0; j < numSourcePts; ++j)
+    {
+      double x[3], y[3], expected[3];
+      source->GetPoint(j, x);
+      expanded->GetPoint(i * numSourcePts + j, expected);
+      for (int c = 0; c < 3; ++c)
+      {
+        y[c] = m[4 * c] * x[0] + m[4 * c + 1] * x[1] + m[4 * c + 2] * x[2] +
+          m[4 * c + 3];
+      }
+      if (std::sqrt(vtkMath::Distance2BetweenPoints(y, expected)) > 1e-5)
+      {
+        std::cerr << "Instance " << i << " point " << j << " is (" << y[0]
+                  << ", " << y[1] << ", " << y[2] << "), expected ("
+                  << expected[0] << ", " << expected[1] << ", "
+                  << expected[2] << ")" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,102 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestQuadricClustering.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Checks that each output triangle of vtkQuadricClustering matches the
+// input triangle its cell data was copied from: every corner must be
+// represented by a point close to the bin holding the input corner.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkIdTypeArray.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+#include <vtkQuadricClustering.h>
+#include <vtkSphereSource.h>
+
+#include <cmath>
+#include <vector>
+
+int TestQuadricClustering(int, char*[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(200);
+  sphere->SetPhiResolution(200);
+  sphere->Update();
+
+  vtkNew<vtkPolyData> input;
+  input->DeepCopy(sphere->GetOutput());
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("CellIds");
+  for (vtkIdType i = 0; i < input->GetNumberOfCells(); ++i)
+  {
+    cellIds->InsertNextValue(i);
+  }
+  input->GetCellData()->AddArray(cellIds);
+  input->BuildCells();
+
+  for (int preventDuplicates = 0; preventDuplicates < 2; ++preventDuplicates)
+  {
+    vtkNew<vtkQuadricClustering> clustering;
+    clustering->SetInputData(input);
+    clustering->SetNumberOfDivisions(40, 35, 30);
+    clustering->SetCopyCellData(1);
+    clustering->SetPreventDuplicateCells(preventDuplicates);
+    clustering->Update();
+
+    vtkPolyData* output = clustering->GetOutput();
+    vtkIdTypeArray* outIds = vtkIdTypeArray::SafeDownCast(
+      output->GetCellData()->GetArray("CellIds"));
+    if (output->GetNumberOfPolys() == 0 || !outIds ||
+        outIds->GetNumberOfTuples() != output->GetNumberOfPolys())
+    {
+      cerr << "Unexpected output: " << output->GetNumberOfPolys()
+           << " triangles" << endl;
+      return EXIT_FAILURE;
+    }
+
+    double* spacing = clustering->GetDivisionSpacing();
+    double diagonal = std::sqrt(vtkMath::Dot(spacing, spacing));
+    std::vector<bool> used(output->GetNumberOfPoints(), false);
+    vtkIdType npts, *pts, inNpts, *inPts, cellId = 0;
+    vtkCellArray* polys = output->GetPolys();
+    for (polys->InitTraversal(); polys->GetNextCell(npts, pts); ++cellId)
+    {
+      input->GetCellPoints(outIds->GetValue(cellId), inNpts, inPts);
+      for (int i = 0; i < 3; ++i)
+      {
+        double x[3], inX[3];
+        output->GetPoint(pts[i], x);
+        input->GetPoint(inPts[i], inX);
+        used[pts[i]] = true;
+        if (std::sqrt(vtkMath::Distance2BetweenPoints(x, inX)) > diagonal)
+        {
+          cerr << "Output triangle " << cellId << " does not match input cell "
+               << outIds->GetValue(cellId) << endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+    for (size_t i = 0; i < used.size(); ++i)
+    {
+      if (!used[i])
+      {
+        cerr << "Output point " << i << " is not used" << endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,104 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestQuadricDecimationPartitions.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Compares the partitioned decimation against the serial one on a sphere:
+// the partitioned reduction must be about as large and the distance of the
+// decimated surface to the sphere at most 1.5 times the serial one.
+
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+#include <vtkQuadricDecimation.h>
+#include <vtkSphereSource.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Largest distance from the vertices and the triangle centers of the
+// decimated mesh to the unit sphere.
+double SphereDistance(vtkPolyData* mesh)
+{
+  double maxDistance = 0.0;
+  vtkIdType npts, *pts;
+  mesh->BuildCells();
+  for (vtkIdType cellId = 0; cellId < mesh->GetNumberOfCells(); ++cellId)
+  {
+    mesh->GetCellPoints(cellId, npts, pts);
+    double center[3] = { 0.0, 0.0, 0.0 };
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      double x[3];
+      mesh->GetPoint(pts[i], x);
+      double r = std::sqrt(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]);
+      maxDistance = std::max(maxDistance, std::abs(r - 1.0));
+      for (int k = 0; k < 3; ++k)
+      {
+        center[k] += x[k] / npts;
+      }
+    }
+    double r = std::sqrt(center[0] * center[0] + center[1] * center[1] +
+                         center[2] * center[2]);
+    maxDistance = std::max(maxDistance, std::abs(r - 1.0));
+  }
+  return maxDistance;
+}
+}
+
+int TestQuadricDecimationPartitions(int, char*[])
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetRadius(1.0);
+  sphere->SetThetaResolution(200);
+  sphere->SetPhiResolution(200);
+  sphere->Update();
+  vtkIdType numInputTris = sphere->GetOutput()->GetNumberOfPolys();
+
+  double error[2], reduction[2];
+  for (int partitions = 1, i = 0; i < 2; partitions = 8, ++i)
+  {
+    vtkNew<vtkQuadricDecimation> decimate;
+    decimate->SetInputConnection(sphere->GetOutputPort());
+    decimate->SetTargetReduction(0.9);
+    decimate->SetNumberOfPartitions(partitions);
+    decimate->Update();
+
+    vtkPolyData* output = decimate->GetOutput();
+    error[i] = SphereDistance(output);
+    reduction[i] =
+      1.0 - static_cast<double>(output->GetNumberOfPolys()) / numInputTris;
+
+    if (std::abs(reduction[i] - decimate->GetActualReduction()) > 1e-6)
+    {
+      cerr << "Actual reduction " << decimate->GetActualReduction()
+           << " does not match the output " << reduction[i] << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (reduction[1] < reduction[0] - 0.01)
+  {
+    cerr << "Partitioned reduction " << reduction[1]
+         << " is below the serial reduction " << reduction[0] << endl;
+    return EXIT_FAILURE;
+  }
+  if (error[1] > 1.5 * error[0])
+  {
+    cerr << "Partitioned error " << error[1]
+         << " is more than 1.5 times the serial error " << error[0] << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,138 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSmoothPolyDataFilterParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Smooths a noisy sphere with the default in-place update and with the
+// parallel (double-buffered) update, and checks that both remove the noise
+// by a similar amount for float and double points.
+
+#include <vtkMath.h>
+#include <vtkMinimalStandardRandomSequence.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSmoothPolyDataFilter.h>
+#include <vtkSphereSource.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+// Standard deviation of the distance of the points to the origin.
+double RadiusDeviation(vtkPoints* points)
+{
+  vtkIdType numPts = points->GetNumberOfPoints();
+  double sum = 0.0, sum2 = 0.0;
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    double x[3];
+    points->GetPoint(i, x);
+    double r = std::sqrt(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]);
+    sum += r;
+    sum2 += r * r;
+  }
+  double mean = sum / numPts;
+  return std::sqrt(std::max(sum2 / numPts - mean * mean, 0.0));
+}
+
+int TestPrecision(int precision)
+{
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetRadius(1.0);
+  sphere->SetThetaResolution(64);
+  sphere->SetPhiResolution(64);
+  sphere->SetOutputPointsPrecision(precision);
+  sphere->Update();
+
+  // Add some noise along the radius.
+  vtkNew<vtkPolyData> noisy;
+  noisy->DeepCopy(sphere->GetOutput());
+  vtkPoints* points = noisy->GetPoints();
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    points->GetPoint(i, x);
+    random->Next();
+    double scale = 1.0 + 0.02 * (random->GetValue() - 0.5);
+    x[0] *= scale;
+    x[1] *= scale;
+    x[2] *= scale;
+    points->SetPoint(i, x);
+  }
+  double noise = RadiusDeviation(points);
+
+  vtkNew<vtkSmoothPolyDataFilter> serial;
+  serial->SetInputData(noisy);
+  serial->SetNumberOfIterations(20);
+  serial->SetRelaxationFactor(0.1);
+  serial->Update();
+
+  vtkNew<vtkSmoothPolyDataFilter> parallel;
+  parallel->SetInputData(noisy);
+  parallel->SetNumberOfIterations(20);
+  parallel->SetRelaxationFactor(0.1);
+  parallel->ParallelSmoothingOn();
+  parallel->Update();
+
+  vtkPoints* serialPoints = serial->GetOutput()->GetPoints();
+  vtkPoints* parallelPoints = parallel->GetOutput()->GetPoints();
+  if (parallelPoints->GetDataType() != points->GetDataType())
+  {
+    std::cerr << "Parallel smoothing changed the point type." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  double serialNoise = RadiusDeviation(serialPoints);
+  double parallelNoise = RadiusDeviation(parallelPoints);
+  std::cout << "Noise " << noise << ", serial " << serialNoise
+            << ", parallel " << parallelNoise << std::endl;
+  if (serialNoise > 0.5 * noise || parallelNoise > 0.5 * noise ||
+      parallelNoise > 2.0 * serialNoise)
+  {
+    std::cerr << "Parallel smoothing did not remove the noise." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  double maxDiff = 0.0;
+  for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+  {
+    double x[3], y[3];
+    serialPoints->GetPoint(i, x);
+    parallelPoints->GetPoint(i, y);
+    maxDiff = std::max(maxDiff,
+                       std::sqrt(vtkMath::Distance2BetweenPoints(x, y)));
+  }
+  if (maxDiff > 0.01)
+  {
+    std::cerr << "Serial and parallel smoothing differ by " << maxDiff
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+}
+
+int TestSmoothPolyDataFilterParallel(int, char*[])
+{
+  if (TestPrecision(vtkAlgorithm::SINGLE_PRECISION) != EXIT_SUCCESS ||
+      TestPrecision(vtkAlgorithm::DOUBLE_PRECISION) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
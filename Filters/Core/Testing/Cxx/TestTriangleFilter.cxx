@@ -0,0 +1,171 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTriangleFilter.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Triangulates convex and nonconvex polygons and triangle strips with and
+// without FastConvexTriangulation, and checks that both triangulations
+// cover every input cell with the same number of triangles and the same
+// area, in the order of the input cells.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkIntArray.h>
+#include <vtkMath.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkTriangle.h>
+#include <vtkTriangleFilter.h>
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+const int NumberOfPolygons = 2000;
+
+void MakePolygons(vtkPolyData* polyData)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkCellArray> polys;
+  for (int p = 0; p < NumberOfPolygons; ++p)
+  {
+    // Triangles to decagons, every fourth one a (nonconvex) star.
+    int n = 3 + p % 8;
+    bool star = (p % 4 == 1 && n > 4);
+    double center[3] = { static_cast<double>(p % 50),
+                         static_cast<double>(p / 50), 0.1 * (p % 3) };
+    std::vector<vtkIdType> ids;
+    for (int i = 0; i < n; ++i)
+    {
+      double r = (star && i % 2) ? 0.2 : 0.4;
+      double a = 2.0 * vtkMath::Pi() * i / n;
+      ids.push_back(points->InsertNextPoint(center[0] + r * std::cos(a),
+                                            center[1] + r * std::sin(a),
+                                            center[2]));
+    }
+    polys->InsertNextCell(n, &ids[0]);
+  }
+
+  vtkNew<vtkCellArray> strips;
+  for (int s = 0; s < 20; ++s)
+  {
+    std::vector<vtkIdType> ids;
+    for (int i = 0; i < 3 + s % 6; ++i)
+    {
+      ids.push_back((7 * s + i) % points->GetNumberOfPoints());
+    }
+    strips->InsertNextCell(static_cast<vtkIdType>(ids.size()), &ids[0]);
+  }
+
+  vtkNew<vtkIntArray> cellIds;
+  cellIds->SetName("CellIds");
+  for (int i = 0; i < NumberOfPolygons + 20; ++i)
+  {
+    cellIds->InsertNextValue(i);
+  }
+
+  polyData->SetPoints(points);
+  polyData->SetPolys(polys);
+  polyData->SetStrips(strips);
+  polyData->GetCellData()->AddArray(cellIds);
+}
+
+// Area of the triangles of every input cell.
+bool CellAreas(vtkPolyData* output, std::vector<double>& areas)
+{
+  vtkIntArray* cellIds =
+    vtkIntArray::SafeDownCast(output->GetCellData()->GetArray("CellIds"));
+  if (!cellIds || cellIds->GetNumberOfTuples() != output->GetNumberOfCells())
+  {
+    std::cerr << "Missing cell data." << std::endl;
+    return false;
+  }
+
+  areas.assign(NumberOfPolygons + 20, 0.0);
+  vtkIdType npts, *pts;
+  vtkIdType cellId = 0;
+  int previous = 0;
+  vtkCellArray* polys = output->GetPolys();
+  for (polys->InitTraversal(); polys->GetNextCell(npts, pts); ++cellId)
+  {
+    int inputId = cellIds->GetValue(cellId);
+    if (npts != 3 || inputId < previous)
+    {
+      std::cerr << "Bad triangle " << cellId << std::endl;
+      return false;
+    }
+    previous = inputId;
+    double x0[3], x1[3], x2[3];
+    output->GetPoint(pts[0], x0);
+    output->GetPoint(pts[1], x1);
+    output->GetPoint(pts[2], x2);
+    areas[inputId] += vtkTriangle::TriangleArea(x0, x1, x2);
+  }
+  return true;
+}
+}
+
+int TestTriangleFilter(int, char*[])
+{
+  vtkNew<vtkPolyData> input;
+  MakePolygons(input);
+
+  vtkNew<vtkTriangleFilter> earCut;
+  earCut->SetInputData(input);
+  earCut->Update();
+
+  vtkNew<vtkTriangleFilter> fast;
+  fast->SetInputData(input);
+  fast->FastConvexTriangulationOn();
+  fast->Update();
+
+  vtkIdType expected = 0;
+  vtkIdType npts, *pts;
+  for (int c = 0; c < 2; ++c)
+  {
+    vtkCellArray* cells = c ? input->GetStrips() : input->GetPolys();
+    for (cells->InitTraversal(); cells->GetNextCell(npts, pts);)
+    {
+      expected += npts - 2;
+    }
+  }
+  if (earCut->GetOutput()->GetNumberOfPolys() != expected ||
+      fast->GetOutput()->GetNumberOfPolys() != expected)
+  {
+    std::cerr << "Expected " << expected << " triangles, got "
+              << earCut->GetOutput()->GetNumberOfPolys() << " and "
+              << fast->GetOutput()->GetNumberOfPolys() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::vector<double> earCutAreas, fastAreas;
+  if (!CellAreas(earCut->GetOutput(), earCutAreas) ||
+      !CellAreas(fast->GetOutput(), fastAreas))
+  {
+    return EXIT_FAILURE;
+  }
+  for (size_t i = 0; i < earCutAreas.size(); ++i)
+  {
+    if (std::fabs(earCutAreas[i] - fastAreas[i]) > 1e-6)
+    {
+      std::cerr << "Area of cell " << i << " differs: " << earCutAreas[i]
+                << " (ear-cut) and " << fastAreas[i] << " (fast)"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
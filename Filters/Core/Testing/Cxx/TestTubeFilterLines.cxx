@@ -0,0 +1,302 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTubeFilterLines.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Tubes a set of polylines sharing vertices (including closed loops and
+// degenerate polylines) at once, and checks that the result is the
+// concatenation of the tubes of every polyline processed on its own. This is
+// done with named arrays only, then with unnamed, bit and structure of arrays
+// attributes which are not copied through the same code path.
+
+#include <vtkBitArray.h>
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDoubleArray.h>
+#include <vtkIntArray.h>
+#include <vtkMinimalStandardRandomSequence.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkSOADataArrayTemplate.h>
+#include <vtkTubeFilter.h>
+
+#include <iostream>
+#include <vector>
+
+namespace
+{
+const int NumberOfLines = 50;
+
+void MakeLines(vtkPolyData* polyData)
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+
+  vtkNew<vtkPoints> points;
+  points->SetDataType(VTK_DOUBLE);
+  for (int i = 0; i < 200; ++i)
+  {
+    double x[3];
+    for (int j = 0; j < 3; ++j)
+    {
+      random->Next();
+      x[j] = random->GetValue() + 0.5 * (i % 10);
+    }
+    points->InsertNextPoint(x);
+  }
+
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("Scalars");
+  for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i)
+  {
+    scalars->InsertNextValue(i);
+  }
+
+  vtkNew<vtkCellArray> lines;
+  vtkNew<vtkIntArray> lineIds;
+  lineIds->SetName("LineIds");
+  for (int l = 0; l < NumberOfLines; ++l)
+  {
+    // Consecutive polylines share their points.
+    std::vector<vtkIdType> ids;
+    for (int i = 0; i < 3 + l % 5; ++i)
+    {
+      ids.push_back((3 * l + i) % 200);
+    }
+    if (l % 7 == 0)
+    {
+      ids.push_back(ids[0]); // closed loop
+    }
+    if (l % 9 == 4)
+    {
+      ids.resize(2);
+      ids[1] = ids[0]; // degenerate, not tubed
+    }
+    lines->InsertNextCell(static_cast<vtkIdType>(ids.size()), &ids[0]);
+    lineIds->InsertNextValue(l);
+  }
+
+  polyData->SetPoints(points);
+  polyData->SetLines(lines);
+  polyData->GetPointData()->SetScalars(scalars);
+  polyData->GetCellData()->AddArray(lineIds);
+}
+
+void AddUnnamedArray(vtkPolyData* polyData)
+{
+  vtkNew<vtkDoubleArray> unnamed;
+  for (vtkIdType i = 0; i < polyData->GetNumberOfPoints(); ++i)
+  {
+    unnamed->InsertNextValue(-i);
+  }
+  polyData->GetPointData()->AddArray(unnamed);
+}
+
+void AddBitArrays(vtkPolyData* polyData)
+{
+  vtkNew<vtkBitArray> pointBits;
+  pointBits->SetName("PointBits");
+  for (vtkIdType i = 0; i < polyData->GetNumberOfPoints(); ++i)
+  {
+    pointBits->InsertNextValue(i % 3 == 0);
+  }
+  polyData->GetPointData()->AddArray(pointBits);
+
+  vtkNew<vtkBitArray> cellBits;
+  cellBits->SetName("CellBits");
+  for (vtkIdType i = 0; i < polyData->GetNumberOfCells(); ++i)
+  {
+    cellBits->InsertNextValue(i % 2);
+  }
+  polyData->GetCellData()->AddArray(cellBits);
+}
+
+void AddSOAArrays(vtkPolyData* polyData)
+{
+  vtkNew<vtkSOADataArrayTemplate<float> > pointSOA;
+  pointSOA->SetName("PointSOA");
+  pointSOA->SetNumberOfComponents(2);
+  pointSOA->SetNumberOfTuples(polyData->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < polyData->GetNumberOfPoints(); ++i)
+  {
+    pointSOA->SetTypedComponent(i, 0, i);
+    pointSOA->SetTypedComponent(i, 1, 0.5 * i);
+  }
+  polyData->GetPointData()->AddArray(pointSOA);
+
+  vtkNew<vtkSOADataArrayTemplate<double> > cellSOA;
+  cellSOA->SetName("CellSOA");
+  cellSOA->SetNumberOfComponents(3);
+  cellSOA->SetNumberOfTuples(polyData->GetNumberOfCells());
+  for (vtkIdType i = 0; i < polyData->GetNumberOfCells(); ++i)
+  {
+    cellSOA->SetTypedComponent(i, 0, i);
+    cellSOA->SetTypedComponent(i, 1, -i);
+    cellSOA->SetTypedComponent(i, 2, 2 * i);
+  }
+  polyData->GetCellData()->AddArray(cellSOA);
+}
+
+bool SameTuples(vtkDataArray* a, vtkIdType aStart, vtkDataArray* b,
+                vtkIdType num)
+{
+  for (vtkIdType i = 0; i < num; ++i)
+  {
+    for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+    {
+      if (a->GetComponent(aStart + i, c) != b->GetComponent(i, c))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+int TestOptions(vtkPolyData* input, bool capping, bool shareVertices)
+{
+  vtkNew<vtkTubeFilter> tube;
+  tube->SetInputData(input);
+  tube->SetNumberOfSides(5);
+  tube->SetRadius(0.05);
+  tube->SetCapping(capping);
+  tube->SetSidesShareVertices(shareVertices);
+  tube->SetGenerateTCoordsToNormalizedLength();
+  tube->Update();
+  vtkPolyData* output = tube->GetOutput();
+
+  vtkIdType ptOffset = 0, cellOffset = 0;
+  vtkNew<vtkPolyData> single;
+  single->SetPoints(input->GetPoints());
+  single->GetPointData()->ShallowCopy(input->GetPointData());
+  vtkNew<vtkTubeFilter> singleTube;
+  singleTube->SetInputData(single);
+  singleTube->SetNumberOfSides(5);
+  singleTube->SetRadius(0.05);
+  singleTube->SetCapping(capping);
+  singleTube->SetSidesShareVertices(shareVertices);
+  singleTube->SetGenerateTCoordsToNormalizedLength();
+
+  vtkPointData* outPd = output->GetPointData();
+  vtkCellData* inCd = input->GetCellData();
+  vtkCellData* outCd = output->GetCellData();
+  if (outPd->GetNumberOfArrays() != input->GetPointData()->GetNumberOfArrays() + 2 ||
+      outCd->GetNumberOfArrays() != inCd->GetNumberOfArrays())
+  {
+    std::cerr << "Missing output attributes." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkIdType npts, *pts;
+  vtkCellArray* lines = input->GetLines();
+  int lineId = 0;
+  for (lines->InitTraversal(); lines->GetNextCell(npts, pts); ++lineId)
+  {
+    vtkNew<vtkCellArray> line;
+    line->InsertNextCell(npts, pts);
+    single->SetLines(line);
+    singleTube->Modified();
+    singleTube->Update();
+    vtkPolyData* expected = singleTube->GetOutput();
+    vtkIdType numPts = expected->GetNumberOfPoints();
+    vtkIdType numCells = expected->GetNumberOfCells();
+
+    if (ptOffset + numPts > output->GetNumberOfPoints() ||
+        cellOffset + numCells > output->GetNumberOfCells() ||
+        !SameTuples(output->GetPoints()->GetData(), ptOffset,
+                    expected->GetPoints()->GetData(), numPts))
+    {
+      std::cerr << "Tube of line " << lineId << " differs." << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (int a = 0; a < outPd->GetNumberOfArrays(); ++a)
+    {
+      if (!SameTuples(outPd->GetArray(a), ptOffset,
+                      expected->GetPointData()->GetArray(a), numPts))
+      {
+        std::cerr << "Wrong point data " << a << " for line " << lineId
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    for (int a = 0; a < outCd->GetNumberOfArrays(); ++a)
+    {
+      vtkDataArray* inArray = inCd->GetArray(a);
+      vtkDataArray* outArray = outCd->GetArray(a);
+      for (vtkIdType i = 0; i < numCells; ++i)
+      {
+        for (int c = 0; c < inArray->GetNumberOfComponents(); ++c)
+        {
+          if (outArray->GetComponent(cellOffset + i, c) !=
+              inArray->GetComponent(lineId, c))
+          {
+            std::cerr << "Wrong cell data " << a << " for line " << lineId
+                      << std::endl;
+            return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+
+    ptOffset += numPts;
+    cellOffset += numCells;
+  }
+
+  if (ptOffset != output->GetNumberOfPoints() ||
+      cellOffset != output->GetNumberOfCells())
+  {
+    std::cerr << "Expected " << ptOffset << " points and " << cellOffset
+              << " cells, got " << output->GetNumberOfPoints() << " and "
+              << output->GetNumberOfCells() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+}
+
+int TestTubeFilterLines(int, char*[])
+{
+  for (int attributes = 0; attributes < 4; ++attributes)
+  {
+    vtkNew<vtkPolyData> input;
+    MakeLines(input);
+    if (attributes == 1)
+    {
+      AddUnnamedArray(input);
+    }
+    else if (attributes == 2)
+    {
+      AddBitArrays(input);
+    }
+    else if (attributes == 3)
+    {
+      AddSOAArrays(input);
+    }
+
+    for (int capping = 0; capping < 2; ++capping)
+    {
+      for (int share = 0; share < 2; ++share)
+      {
+        if (TestOptions(input, capping != 0, share != 0) != EXIT_SUCCESS)
+        {
+          std::cerr << "Failed with attributes " << attributes << ", capping "
+                    << capping << " and shared vertices " << share << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -14,9 +14,13 @@
 =========================================================================*/
 #include "vtkAppendFilter.h"
 
+#include "vtkArrayDispatch.h"
+#include "vtkAssume.h"
 #include "vtkBoundingBox.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkDataSetAttributes.h"
 #include "vtkDataSetCollection.h"
 #include "vtkExecutive.h"
@@ -25,16 +29,222 @@
 #include "vtkInformationVector.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
+#include "vtkIdTypeArray.h"
 #include "vtkPointData.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
 #include <set>
 #include <string>
+#include <vector>
 
 vtkStandardNewMacro(vtkAppendFilter);
 
+namespace
+{
+//----------------------------------------------------------------------------
+// Copies all the tuples of an array into another one, starting at Offset.
+struct AppendDataWorker
+{
+  vtkIdType Offset;
+
+  AppendDataWorker(vtkIdType offset) : Offset(offset) {}
+
+  template <typename Array1T, typename Array2T>
+  void operator()(Array1T *dest, Array2T *src)
+  {
+    vtkDataArrayAccessor<Array1T> d(dest);
+    vtkDataArrayAccessor<Array2T> s(src);
+    VTK_ASSUME(src->GetNumberOfComponents() == dest->GetNumberOfComponents());
+
+    const vtkIdType numTuples = src->GetNumberOfTuples();
+    const int numComps = src->GetNumberOfComponents();
+
+    for (vtkIdType t = 0; t < numTuples; ++t)
+    {
+      for (int c = 0; c < numComps; ++c)
+      {
+        d.Set(t + this->Offset, c, s.Get(t, c));
+      }
+    }
+  }
+};
+
+void AppendData(vtkDataArray* dest, vtkDataArray* src, vtkIdType offset)
+{
+  AppendDataWorker worker(offset);
+  if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(dest, src, worker))
+  {
+    // Use vtkDataArray API when fast-path dispatch fails.
+    worker(dest, src);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Copies the points of a range of inputs into the preallocated output
+// points. Every input writes to its own range of points.
+struct AppendPointsFunctor
+{
+  const std::vector<vtkDataSet*>& Inputs;
+  const std::vector<vtkIdType>& PointOffsets;
+  vtkPoints* Points;
+
+  AppendPointsFunctor(const std::vector<vtkDataSet*>& inputs,
+                      const std::vector<vtkIdType>& pointOffsets,
+                      vtkPoints* points)
+    : Inputs(inputs), PointOffsets(pointOffsets), Points(points)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType idx = begin; idx < end; ++idx)
+    {
+      vtkDataSet* dataSet = this->Inputs[idx];
+      const vtkIdType offset = this->PointOffsets[idx];
+      vtkPointSet* ps = vtkPointSet::SafeDownCast(dataSet);
+      if (ps && ps->GetPoints())
+      {
+        AppendData(this->Points->GetData(), ps->GetPoints()->GetData(), offset);
+      }
+      else
+      {
+        double x[3];
+        const vtkIdType numPts = dataSet->GetNumberOfPoints();
+        for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+        {
+          dataSet->GetPoint(ptId, x);
+          this->Points->SetPoint(ptId + offset, x);
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Copies the cells of a range of unstructured grid inputs (without
+// polyhedra) into the preallocated output cell arrays, renumbering their
+// point ids through the global point indices.
+struct AppendCellsFunctor
+{
+  const std::vector<vtkDataSet*>& Inputs;
+  const std::vector<vtkIdType>& PointOffsets;
+  const std::vector<vtkIdType>& CellOffsets;
+  const std::vector<vtkIdType>& ConnectivityOffsets;
+  const vtkIdType* GlobalIndices;
+  vtkIdType* Connectivity;
+  unsigned char* Types;
+  vtkIdType* Locations;
+
+  AppendCellsFunctor(const std::vector<vtkDataSet*>& inputs,
+                     const std::vector<vtkIdType>& pointOffsets,
+                     const std::vector<vtkIdType>& cellOffsets,
+                     const std::vector<vtkIdType>& connectivityOffsets,
+                     const vtkIdType* globalIndices, vtkIdType* connectivity,
+                     unsigned char* types, vtkIdType* locations)
+    : Inputs(inputs), PointOffsets(pointOffsets), CellOffsets(cellOffsets),
+      ConnectivityOffsets(connectivityOffsets), GlobalIndices(globalIndices),
+      Connectivity(connectivity), Types(types), Locations(locations)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType idx = begin; idx < end; ++idx)
+    {
+      vtkUnstructuredGrid* ug = static_cast<vtkUnstructuredGrid*>(this->Inputs[idx]);
+      const vtkIdType numCells = ug->GetNumberOfCells();
+      if (numCells <= 0)
+      {
+        continue;
+      }
+      const vtkIdType* inConn = ug->GetCells()->GetPointer();
+      const vtkIdType* inLocations = ug->GetCellLocationsArray()->GetPointer(0);
+      const unsigned char* inTypes = ug->GetCellTypesArray()->GetPointer(0);
+      const vtkIdType* globalIds = this->GlobalIndices + this->PointOffsets[idx];
+      const vtkIdType cellOffset = this->CellOffsets[idx];
+      vtkIdType* conn = this->Connectivity + this->ConnectivityOffsets[idx];
+
+      for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+      {
+        const vtkIdType* cellPts = inConn + inLocations[cellId];
+        const vtkIdType npts = *cellPts++;
+        this->Types[cellOffset + cellId] = inTypes[cellId];
+        this->Locations[cellOffset + cellId] = conn - this->Connectivity;
+        *conn++ = npts;
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          *conn++ = globalIds[cellPts[i]];
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// An output array and the matching array of every input.
+struct ArrayToAppend
+{
+  vtkAbstractArray* Destination;
+  std::vector<vtkAbstractArray*> Sources;
+};
+
+//----------------------------------------------------------------------------
+// Copies the arrays of a range of inputs into the preallocated output
+// arrays. Without global ids every input writes to its own range of tuples.
+struct AppendArraysFunctor
+{
+  const std::vector<ArrayToAppend>& Arrays;
+  const std::vector<vtkIdType>& Offsets;
+  const vtkIdType* GlobalIds;
+
+  AppendArraysFunctor(const std::vector<ArrayToAppend>& arrays,
+                      const std::vector<vtkIdType>& offsets,
+                      const vtkIdType* globalIds)
+    : Arrays(arrays), Offsets(offsets), GlobalIds(globalIds)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType idx = begin; idx < end; ++idx)
+    {
+      const vtkIdType offset = this->Offsets[idx];
+      for (const ArrayToAppend& array : this->Arrays)
+      {
+        vtkAbstractArray* srcArray = array.Sources[idx];
+        vtkAbstractArray* dstArray = array.Destination;
+        if (!srcArray)
+        {
+          continue;
+        }
+        vtkDataArray* srcDA = vtkArrayDownCast<vtkDataArray>(srcArray);
+        vtkDataArray* dstDA = vtkArrayDownCast<vtkDataArray>(dstArray);
+        if (!this->GlobalIds && srcDA && dstDA)
+        {
+          AppendData(dstDA, srcDA, offset);
+          continue;
+        }
+        for (vtkIdType id = 0; id < srcArray->GetNumberOfTuples(); ++id)
+        {
+          if (this->GlobalIds)
+          {
+            dstArray->SetTuple(this->GlobalIds[id + offset], id, srcArray);
+          }
+          else
+          {
+            dstArray->SetTuple(id + offset, id, srcArray);
+          }
+        }
+      }
+    }
+  }
+};
+} // end anon namespace
+
 //----------------------------------------------------------------------------
 vtkAppendFilter::vtkAppendFilter()
 {
@@ -253,90 +463,154 @@ int vtkAppendFilter::RequestData(
     ptInserter->InitPointInsertion(newPts, outputBounds);
   }
 
+  // The inputs and where their points and cells go in the output.
+  std::vector<vtkDataSet*> inputList;
+  std::vector<vtkIdType> pointOffsets, cellOffsets, connectivityOffsets;
+  vtkIdType connectivitySize = 0;
+  bool allUnstructured = true;
+  inputs->InitTraversal(iter);
+  while ((dataSet = inputs->GetNextDataSet(iter)))
+  {
+    vtkUnstructuredGrid* ug = vtkUnstructuredGrid::SafeDownCast(dataSet);
+    pointOffsets.push_back(inputList.empty() ? 0 :
+      pointOffsets.back() + inputList.back()->GetNumberOfPoints());
+    cellOffsets.push_back(inputList.empty() ? 0 :
+      cellOffsets.back() + inputList.back()->GetNumberOfCells());
+    connectivityOffsets.push_back(connectivitySize);
+    if (ug && (ug->GetNumberOfCells() == 0 ||
+               (ug->GetCells() && !ug->GetFaces())))
+    {
+      connectivitySize += ug->GetNumberOfCells() > 0 ?
+        ug->GetCells()->GetNumberOfConnectivityEntries() : 0;
+    }
+    else
+    {
+      // polyhedra and other dataset types go through the generic cell API
+      allUnstructured = false;
+    }
+    inputList.push_back(dataSet);
+  }
+  const vtkIdType numInputs = static_cast<vtkIdType>(inputList.size());
+
   // append the blocks / pieces in terms of the geometry and topology
   vtkIdType count = 0;
   vtkIdType ptOffset = 0;
   float decimal = 0.0;
-  inputs->InitTraversal(iter);
   int abort = 0;
-  while (!abort && (dataSet = inputs->GetNextDataSet(iter)))
+  if (reallyMergePoints)
   {
-    vtkIdType dataSetNumPts = dataSet->GetNumberOfPoints();
-    vtkIdType dataSetNumCells = dataSet->GetNumberOfCells();
-
-    // copy points
-    for (vtkIdType ptId = 0; ptId < dataSetNumPts && !abort; ++ptId)
+    for (vtkIdType idx = 0; idx < numInputs && !abort; ++idx)
     {
-      if (reallyMergePoints)
+      dataSet = inputList[idx];
+      vtkIdType dataSetNumPts = dataSet->GetNumberOfPoints();
+      for (vtkIdType ptId = 0; ptId < dataSetNumPts && !abort; ++ptId)
       {
         vtkIdType globalPtId = 0;
         ptInserter->InsertUniquePoint(dataSet->GetPoint(ptId), globalPtId);
         globalIndices[ptId + ptOffset] = globalPtId;
         // The point inserter puts the point into newPts, so we don't have to do that here.
-      }
-      else
-      {
-        globalIndices[ptId + ptOffset] = ptId + ptOffset;
-        newPts->SetPoint(ptId + ptOffset, dataSet->GetPoint(ptId));
-      }
 
-      // Update progress
-      count++;
-      if ( !(count % twentieth) )
-      {
-        decimal += 0.05;
-        this->UpdateProgress(decimal);
-        abort = this->GetAbortExecute();
+        // Update progress
+        count++;
+        if ( !(count % twentieth) )
+        {
+          decimal += 0.05;
+          this->UpdateProgress(decimal);
+          abort = this->GetAbortExecute();
+        }
       }
+      ptOffset += dataSetNumPts;
     }
+  }
+  else
+  {
+    // each input is copied to its own range of points
+    for (vtkIdType ptId = 0; ptId < totalNumPts; ++ptId)
+    {
+      globalIndices[ptId] = ptId;
+    }
+    AppendPointsFunctor appendPoints(inputList, pointOffsets, newPts);
+    vtkSMPTools::For(0, numInputs, appendPoints);
+    count += totalNumPts;
+    decimal = 0.05 * (count / twentieth);
+    this->UpdateProgress(decimal);
+  }
 
-    // copy cell
-    vtkUnstructuredGrid *ug = vtkUnstructuredGrid::SafeDownCast(dataSet);
-    for (vtkIdType cellId = 0; cellId < dataSetNumCells && !abort; ++cellId)
+  if (allUnstructured && !abort)
+  {
+    // copy the cells of all inputs in parallel, directly into the output
+    // cell arrays
+    vtkNew<vtkCellArray> newCells;
+    vtkIdType* connectivity = newCells->WritePointer(totalNumCells, connectivitySize);
+    vtkNew<vtkUnsignedCharArray> types;
+    types->SetNumberOfTuples(totalNumCells);
+    vtkNew<vtkIdTypeArray> locations;
+    locations->SetNumberOfTuples(totalNumCells);
+    AppendCellsFunctor appendCells(inputList, pointOffsets, cellOffsets,
+      connectivityOffsets, globalIndices, connectivity, types->GetPointer(0),
+      locations->GetPointer(0));
+    vtkSMPTools::For(0, numInputs, appendCells);
+    output->SetCells(types, locations, newCells);
+    this->UpdateProgress(0.5);
+  }
+  else
+  {
+    ptOffset = 0;
+    for (vtkIdType idx = 0; idx < numInputs && !abort; ++idx)
     {
-      newPtIds->Reset ();
-      if (ug && dataSet->GetCellType(cellId) == VTK_POLYHEDRON )
+      dataSet = inputList[idx];
+      vtkIdType dataSetNumPts = dataSet->GetNumberOfPoints();
+      vtkIdType dataSetNumCells = dataSet->GetNumberOfCells();
+
+      // copy cell
+      vtkUnstructuredGrid *ug = vtkUnstructuredGrid::SafeDownCast(dataSet);
+      for (vtkIdType cellId = 0; cellId < dataSetNumCells && !abort; ++cellId)
       {
-        vtkIdType nfaces, *facePtIds;
-        ug->GetFaceStream(cellId,nfaces,facePtIds);
-        for(vtkIdType id=0; id < nfaces; ++id)
+        newPtIds->Reset ();
+        if (ug && dataSet->GetCellType(cellId) == VTK_POLYHEDRON )
         {
-          vtkIdType nPoints = facePtIds[0];
-          newPtIds->InsertNextId(nPoints);
-          for (vtkIdType j = 1; j <= nPoints; ++j)
+          vtkIdType nfaces, *facePtIds;
+          ug->GetFaceStream(cellId,nfaces,facePtIds);
+          for(vtkIdType id=0; id < nfaces; ++id)
           {
-            newPtIds->InsertNextId(globalIndices[facePtIds[j] + ptOffset]);
+            vtkIdType nPoints = facePtIds[0];
+            newPtIds->InsertNextId(nPoints);
+            for (vtkIdType j = 1; j <= nPoints; ++j)
+            {
+              newPtIds->InsertNextId(globalIndices[facePtIds[j] + ptOffset]);
+            }
+            facePtIds += nPoints + 1;
           }
-          facePtIds += nPoints + 1;
+          output->InsertNextCell(VTK_POLYHEDRON, nfaces, newPtIds->GetPointer(0));
         }
-        output->InsertNextCell(VTK_POLYHEDRON, nfaces, newPtIds->GetPointer(0));
-      }
-      else
-      {
-        dataSet->GetCellPoints(cellId, ptIds);
-        for (vtkIdType id = 0; id < ptIds->GetNumberOfIds(); ++id)
+        else
         {
-          newPtIds->InsertId(id, globalIndices[ptIds->GetId(id) + ptOffset]);
+          dataSet->GetCellPoints(cellId, ptIds);
+          for (vtkIdType id = 0; id < ptIds->GetNumberOfIds(); ++id)
+          {
+            newPtIds->InsertId(id, globalIndices[ptIds->GetId(id) + ptOffset]);
+          }
+          output->InsertNextCell(dataSet->GetCellType(cellId),newPtIds);
         }
-        output->InsertNextCell(dataSet->GetCellType(cellId),newPtIds);
-      }
 
-      // Update progress
-      count++;
-      if ( !(count % twentieth) )
-      {
-        decimal += 0.05;
-        this->UpdateProgress(decimal);
-        abort = this->GetAbortExecute();
+        // Update progress
+        count++;
+        if ( !(count % twentieth) )
+        {
+          decimal += 0.05;
+          this->UpdateProgress(decimal);
+          abort = this->GetAbortExecute();
+        }
       }
+      ptOffset += dataSetNumPts;
     }
-    ptOffset += dataSetNumPts;
   }
 
-
   // Now copy the array data
-  this->AppendArrays(
-    vtkDataObject::POINT, inputVector, globalIndices, output, newPts->GetNumberOfPoints());
+  // Without merging, the global indices are the identity and the point
+  // arrays can be appended input by input.
+  this->AppendArrays(vtkDataObject::POINT, inputVector,
+    reallyMergePoints ? globalIndices : nullptr, output, newPts->GetNumberOfPoints());
   this->UpdateProgress(0.75);
   this->AppendArrays(vtkDataObject::CELL, inputVector, nullptr, output, output->GetNumberOfCells());
   this->UpdateProgress(1.0);
@@ -580,55 +854,49 @@ void vtkAppendFilter::AppendArrays(int attributesType,
   //////////////////////////////////////////////////////////////
   // Phase 4 - Copy data
   //////////////////////////////////////////////////////////////
+  std::vector<ArrayToAppend> arrays;
+  for (std::set<std::string>::iterator it = dataArrayNames.begin(); it != dataArrayNames.end(); ++it)
+  {
+    ArrayToAppend array;
+    array.Destination = outputData->GetAbstractArray(it->c_str());
+    arrays.push_back(array);
+  }
+  // Copy attributes only if the array name is nullptr. If the array name is
+  // non-nullptr, it is copied with the arrays above.
+  int attributes[vtkDataSetAttributes::NUM_ATTRIBUTES];
+  int numAttributes = 0;
+  for (int attribute = 0; attribute < vtkDataSetAttributes::NUM_ATTRIBUTES; ++attribute)
+  {
+    vtkAbstractArray* dstArray = outputData->GetAbstractAttribute(attribute);
+    if (dstArray && !dstArray->GetName())
+    {
+      ArrayToAppend array;
+      array.Destination = dstArray;
+      arrays.push_back(array);
+      attributes[numAttributes++] = attribute;
+    }
+  }
+
+  std::vector<vtkIdType> offsets;
   vtkIdType offset = 0;
   inputs->InitTraversal(iter);
   while ((dataSet = inputs->GetNextDataSet(iter)))
   {
     vtkDataSetAttributes* inputData = dataSet->GetAttributes(attributesType);
-    for (std::set<std::string>::iterator it = dataArrayNames.begin(); it != dataArrayNames.end(); ++it)
+    size_t arrayIndex = 0;
+    for (std::set<std::string>::iterator it = dataArrayNames.begin();
+         it != dataArrayNames.end(); ++it, ++arrayIndex)
     {
-      const char* arrayName = it->c_str();
-      vtkAbstractArray* srcArray = inputData->GetAbstractArray(arrayName);
-      vtkAbstractArray* dstArray = outputData->GetAbstractArray(arrayName);
-
-      for (vtkIdType id = 0; id < srcArray->GetNumberOfTuples(); ++id)
-      {
-        if (globalIds)
-        {
-          dstArray->SetTuple(globalIds[id + offset], id, srcArray);
-        }
-        else
-        {
-          dstArray->SetTuple(id + offset, id, srcArray);
-        }
-      }
+      arrays[arrayIndex].Sources.push_back(inputData->GetAbstractArray(it->c_str()));
     }
-
-    // Copy attributes
-    for (int attribute = 0; attribute < vtkDataSetAttributes::NUM_ATTRIBUTES; ++attribute)
+    for (int i = 0; i < numAttributes; ++i, ++arrayIndex)
     {
-      vtkAbstractArray* srcArray = inputData->GetAbstractAttribute(attribute);
-      vtkAbstractArray* dstArray = outputData->GetAbstractAttribute(attribute);
-
-      // Copy if only the array name is nullptr. If the array name is non-nullptr, it will
-      // have been copied in the loop above.
-      if (srcArray && !srcArray->GetName() &&
-          dstArray && !dstArray->GetName())
-      {
-        for (vtkIdType id = 0; id < srcArray->GetNumberOfTuples(); ++id)
-        {
-          if (globalIds)
-          {
-            dstArray->SetTuple(globalIds[id + offset], id, srcArray);
-          }
-          else
-          {
-            dstArray->SetTuple(id + offset, id, srcArray);
-          }
-        }
-      }
+      vtkAbstractArray* srcArray = inputData->GetAbstractAttribute(attributes[i]);
+      arrays[arrayIndex].Sources.push_back(
+        srcArray && !srcArray->GetName() ? srcArray : nullptr);
     }
 
+    offsets.push_back(offset);
     if (attributesType == vtkDataObject::POINT)
     {
       offset += dataSet->GetNumberOfPoints();
@@ -638,6 +906,26 @@ void vtkAppendFilter::AppendArrays(int attributesType,
       offset += dataSet->GetNumberOfCells();
     }
   }
+
+  // The inputs can be copied in parallel when they write to disjoint
+  // ranges of numeric arrays.
+  bool parallel = (globalIds == nullptr);
+  for (const ArrayToAppend& array : arrays)
+  {
+    if (!vtkArrayDownCast<vtkDataArray>(array.Destination))
+    {
+      parallel = false;
+    }
+  }
+  AppendArraysFunctor appendArrays(arrays, offsets, globalIds);
+  if (parallel)
+  {
+    vtkSMPTools::For(0, static_cast<vtkIdType>(offsets.size()), appendArrays);
+  }
+  else
+  {
+    appendArrays(0, static_cast<vtkIdType>(offsets.size()));
+  }
 }
 
 //----------------------------------------------------------------------------
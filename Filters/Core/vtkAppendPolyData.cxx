@@ -26,14 +26,211 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTrivialProducer.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <vector>
 
 vtkStandardNewMacro(vtkAppendPolyData);
 
+namespace {
+//----------------------------------------------------------------------------
+// Copies NumberOfTuples tuples of src, starting at SourceStart, to dest
+// starting at DestinationStart.
+struct AppendDataWorker
+{
+  vtkIdType DestinationStart;
+  vtkIdType SourceStart;
+  vtkIdType NumberOfTuples;
+
+  AppendDataWorker(vtkIdType dstStart, vtkIdType srcStart, vtkIdType n)
+    : DestinationStart(dstStart), SourceStart(srcStart), NumberOfTuples(n) {}
+
+  template <typename Array1T, typename Array2T>
+  void operator()(Array1T *dest, Array2T *src)
+  {
+    vtkDataArrayAccessor<Array1T> d(dest);
+    vtkDataArrayAccessor<Array2T> s(src);
+    VTK_ASSUME(src->GetNumberOfComponents() == dest->GetNumberOfComponents());
+
+    const int numComps = src->GetNumberOfComponents();
+
+    for (vtkIdType t = 0; t < this->NumberOfTuples; ++t)
+    {
+      for (int c = 0; c < numComps; ++c)
+      {
+        d.Set(t + this->DestinationStart, c, s.Get(t + this->SourceStart, c));
+      }
+    }
+  }
+};
+
+void AppendDataArray(vtkDataArray *dest, vtkDataArray *src, vtkIdType dstStart,
+                     vtkIdType srcStart, vtkIdType n)
+{
+  AppendDataWorker worker(dstStart, srcStart, n);
+  if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(dest, src, worker))
+  {
+    // Use vtkDataArray API when fast-path dispatch fails.
+    worker(dest, src);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Copies the cells of src to pDest, offsetting the point ids. Returns the
+// next pointer in pDest.
+vtkIdType *AppendCellArray(vtkIdType *pDest, vtkCellArray *src,
+                           vtkIdType offset)
+{
+  if (src == nullptr)
+  {
+    return pDest;
+  }
+
+  const vtkIdType *pSrc = src->GetPointer();
+  const vtkIdType *end = pSrc + src->GetNumberOfConnectivityEntries();
+
+  while (pSrc < end)
+  {
+    // copy the number of points, then offset the point indices
+    vtkIdType npts = *pSrc++;
+    *pDest++ = npts;
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      *pDest++ = offset + *pSrc++;
+    }
+  }
+
+  return pDest;
+}
+
+//----------------------------------------------------------------------------
+// Copies the fields of a FieldList from one input to a range of the
+// (preallocated) output tuples.
+void AppendFields(vtkDataSetAttributes *outputDSA,
+                  vtkDataSetAttributes::FieldList &list,
+                  vtkDataSetAttributes *inputDSA, int idx,
+                  vtkIdType dstStart, vtkIdType n, vtkIdType srcStart)
+{
+  if (n <= 0)
+  {
+    return;
+  }
+  for (int i = 0; i < list.GetNumberOfFields(); ++i)
+  {
+    if (list.GetFieldIndex(i) >= 0 && list.GetDSAIndex(idx, i) >= 0)
+    {
+      vtkAbstractArray *toArray = outputDSA->GetAbstractArray(list.GetFieldIndex(i));
+      vtkAbstractArray *fromArray = inputDSA->GetAbstractArray(list.GetDSAIndex(idx, i));
+      vtkDataArray *toDA = vtkArrayDownCast<vtkDataArray>(toArray);
+      vtkDataArray *fromDA = vtkArrayDownCast<vtkDataArray>(fromArray);
+      if (toDA && fromDA)
+      {
+        AppendDataArray(toDA, fromDA, dstStart, srcStart, n);
+      }
+      else
+      {
+        toArray->InsertTuples(dstStart, n, srcStart, fromArray);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// Where the points and cells of an input go in the output.
+struct AppendInputOffsets
+{
+  int PointListIndex; // index in the point FieldList, -1 without points
+  int CellListIndex; // index in the cell FieldList, -1 without cells
+  vtkIdType Point;
+  vtkIdType Cell[4];
+  vtkIdType Connectivity[4];
+};
+
+//----------------------------------------------------------------------------
+// Appends a range of inputs to the preallocated output. Every input writes
+// to its own range of points, cells and connectivity.
+struct AppendPolyDataFunctor
+{
+  vtkPolyData **Inputs;
+  const std::vector<AppendInputOffsets> &Offsets;
+  vtkDataArray *Points;
+  vtkDataArray *Attributes[vtkDataSetAttributes::NUM_ATTRIBUTES];
+  vtkIdType *Connectivity[4];
+  vtkDataSetAttributes::FieldList &PointList;
+  vtkDataSetAttributes::FieldList &CellList;
+  vtkPointData *OutputPD;
+  vtkCellData *OutputCD;
+
+  AppendPolyDataFunctor(vtkPolyData **inputs,
+                        const std::vector<AppendInputOffsets> &offsets,
+                        vtkDataSetAttributes::FieldList &ptList,
+                        vtkDataSetAttributes::FieldList &cellList)
+    : Inputs(inputs), Offsets(offsets), Points(nullptr), PointList(ptList),
+      CellList(cellList), OutputPD(nullptr), OutputCD(nullptr)
+  {
+    std::fill_n(this->Attributes, vtkDataSetAttributes::NUM_ATTRIBUTES, nullptr);
+    std::fill_n(this->Connectivity, 4, nullptr);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType idx = begin; idx < end; ++idx)
+    {
+      vtkPolyData *ds = this->Inputs[idx];
+      const AppendInputOffsets &offsets = this->Offsets[idx];
+
+      if (offsets.PointListIndex >= 0)
+      {
+        vtkPointData *inPD = ds->GetPointData();
+        const vtkIdType numPts = ds->GetNumberOfPoints();
+        // copy points directly
+        AppendDataArray(this->Points, ds->GetPoints()->GetData(),
+                        offsets.Point, 0, numPts);
+        // copy the attributes directly
+        for (int a = 0; a < vtkDataSetAttributes::NUM_ATTRIBUTES; ++a)
+        {
+          if (this->Attributes[a])
+          {
+            AppendDataArray(this->Attributes[a], inPD->GetAttribute(a),
+                            offsets.Point, 0, numPts);
+          }
+        }
+        // append the remainder of the field data
+        AppendFields(this->OutputPD, this->PointList, inPD,
+                     offsets.PointListIndex, offsets.Point, numPts, 0);
+      }
+
+      if (offsets.CellListIndex >= 0)
+      {
+        vtkCellArray *inCells[4] = { ds->GetVerts(), ds->GetLines(),
+                                     ds->GetPolys(), ds->GetStrips() };
+        // These are the cellIDs at which each of the cell types start.
+        vtkIdType cellIndex = 0;
+        for (int c = 0; c < 4; ++c)
+        {
+          // copy the cells
+          AppendCellArray(this->Connectivity[c] + offsets.Connectivity[c],
+                          inCells[c], offsets.Point);
+
+          // copy cell data
+          const vtkIdType numCells =
+            inCells[c] ? inCells[c]->GetNumberOfCells() : 0;
+          AppendFields(this->OutputCD, this->CellList, ds->GetCellData(),
+                       offsets.CellListIndex, offsets.Cell[c], numCells,
+                       cellIndex);
+          cellIndex += numCells;
+        }
+      }
+    }
+  }
+};
+} // end anon namespace
+
 //----------------------------------------------------------------------------
 vtkAppendPolyData::vtkAppendPolyData()
 {
@@ -131,13 +328,12 @@ int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output,
 {
   int idx;
   vtkPolyData *ds;
-  vtkPoints  *inPts;
   vtkPoints *newPts;
-  vtkCellArray *inVerts, *newVerts;
-  vtkCellArray *inLines, *newLines;
-  vtkCellArray *inPolys, *newPolys;
+  vtkCellArray *newVerts;
+  vtkCellArray *newLines;
+  vtkCellArray *newPolys;
   vtkIdType sizePolys, numPolys;
-  vtkCellArray *inStrips, *newStrips;
+  vtkCellArray *newStrips;
   vtkIdType numPts, numCells;
   vtkPointData *inPD = nullptr;
   vtkCellData *inCD = nullptr;
@@ -165,6 +361,8 @@ int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output,
 
   // These Field lists are very picky.  Count the number of non empty inputs
   // so we can initialize them properly.
+  int numNonEmptyInputs = 0;
+  vtkPolyData *nonEmptyInput = nullptr;
   for (idx = 0; idx < numInputs; ++idx)
   {
     ds = inputs[idx];
@@ -178,9 +376,28 @@ int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output,
       {
         ++countCD;
       } // for a data set that has cells
+      if (ds->GetNumberOfPoints() > 0 || ds->GetNumberOfCells() > 0)
+      {
+        ++numNonEmptyInputs;
+        nonEmptyInput = ds;
+      }
     } // for a non nullptr input
   } // for each input
 
+  // A single non empty input is passed through without copying, unless its
+  // points have to be converted to another precision.
+  if (numNonEmptyInputs == 1 &&
+      (this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION ||
+       !nonEmptyInput->GetPoints() ||
+       nonEmptyInput->GetPoints()->GetDataType() ==
+         (this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION ?
+          VTK_FLOAT : VTK_DOUBLE)))
+  {
+    vtkDebugMacro(<<"Only a single non empty input, shallow copying it");
+    output->ShallowCopy(nonEmptyInput);
+    return 1;
+  }
+
   // These are used to determine which fields are available for appending
   vtkDataSetAttributes::FieldList ptList(countPD);
   vtkDataSetAttributes::FieldList cellList(countCD);
@@ -410,104 +627,87 @@ int vtkAppendPolyData::ExecuteAppend(vtkPolyData* output,
     }
   }
 
-  // Allocate the point and cell data
+  // Allocate the point and cell data. The arrays are sized up front so that
+  // the inputs can be copied in any order.
   outputPD->CopyAllocate(ptList,numPts);
   outputCD->CopyAllocate(cellList,numCells);
+  bool numericArraysOnly = true;
+  for (idx = 0; idx < outputPD->GetNumberOfArrays(); ++idx)
+  {
+    outputPD->GetAbstractArray(idx)->SetNumberOfTuples(numPts);
+    numericArraysOnly &= (outputPD->GetArray(idx) != nullptr);
+  }
+  for (idx = 0; idx < outputCD->GetNumberOfArrays(); ++idx)
+  {
+    outputCD->GetAbstractArray(idx)->SetNumberOfTuples(numCells);
+    numericArraysOnly &= (outputCD->GetArray(idx) != nullptr);
+  }
 
-  // loop over all input sets
+  // Compute where each input goes in the output.
+  std::vector<AppendInputOffsets> offsets(numInputs);
   vtkIdType ptOffset = 0;
-  vtkIdType vertOffset = 0;
-  vtkIdType linesOffset = numVerts;
-  vtkIdType polysOffset = numVerts+numLines;
-  vtkIdType stripsOffset = numVerts+numLines+numPolys;
+  vtkIdType cellOffsets[4] = { 0, numVerts, numVerts + numLines,
+                               numVerts + numLines + numPolys };
+  vtkIdType connectivityOffsets[4] = { 0, 0, 0, 0 };
   countPD = countCD = 0;
   for (idx = 0; idx < numInputs; ++idx)
   {
-    this->UpdateProgress(0.2 + 0.8*idx/numInputs);
+    AppendInputOffsets &inputOffsets = offsets[idx];
+    inputOffsets.PointListIndex = inputOffsets.CellListIndex = -1;
     ds = inputs[idx];
-    // this check is not necessary, but I'll put it in anyway
-    if (ds != nullptr)
+    if (ds == nullptr)
     {
-      numPts = ds->GetNumberOfPoints();
-      numCells = ds->GetNumberOfCells();
-      if ( numPts <= 0 && numCells <= 0 )
-      {
-        continue; //no input, just skip
-      }
-
-      inPD = ds->GetPointData();
-      inCD = ds->GetCellData();
-
-      inPts = ds->GetPoints();
-      inVerts = ds->GetVerts();
-      inLines = ds->GetLines();
-      inPolys = ds->GetPolys();
-      inStrips = ds->GetStrips();
-
-      if (ds->GetNumberOfPoints() > 0)
+      continue;
+    }
+    inputOffsets.Point = ptOffset;
+    if (ds->GetNumberOfPoints() > 0)
+    {
+      inputOffsets.PointListIndex = countPD++;
+    }
+    if (ds->GetNumberOfCells() > 0)
+    {
+      inputOffsets.CellListIndex = countCD++;
+      vtkCellArray *inCells[4] = { ds->GetVerts(), ds->GetLines(),
+                                   ds->GetPolys(), ds->GetStrips() };
+      for (int c = 0; c < 4; ++c)
       {
-        // copy points directly
-        this->AppendData(newPts->GetData(),
-                         inPts->GetData(), ptOffset);
-
-        // copy scalars directly
-        if (newPtScalars)
+        inputOffsets.Cell[c] = cellOffsets[c];
+        inputOffsets.Connectivity[c] = connectivityOffsets[c];
+        if (inCells[c])
         {
-          this->AppendData(newPtScalars, inPD->GetScalars(), ptOffset);
+          cellOffsets[c] += inCells[c]->GetNumberOfCells();
+          connectivityOffsets[c] += inCells[c]->GetNumberOfConnectivityEntries();
         }
-        // copy normals directly
-        if (newPtNormals)
-        {
-          this->AppendData(newPtNormals, inPD->GetNormals(), ptOffset);
-        }
-        // copy vectors directly
-        if (newPtVectors)
-        {
-          this->AppendData(newPtVectors, inPD->GetVectors(), ptOffset);
-        }
-        // copy tcoords directly
-        if (newPtTCoords)
-        {
-          this->AppendData(newPtTCoords, inPD->GetTCoords() , ptOffset);
-        }
-        // copy tensors directly
-        if (newPtTensors)
-        {
-          this->AppendData(newPtTensors, inPD->GetTensors(), ptOffset);
-        }
-        // append the remainder of the field data
-        outputPD->CopyData(ptList, inPD, countPD, ptOffset, numPts, 0);
-        ++countPD;
-      }
-
-      if (ds->GetNumberOfCells() > 0)
-      {
-        // These are the cellIDs at which each of the cell types start.
-        vtkIdType vertsIndex = 0;
-        vtkIdType linesIndex = ds->GetNumberOfVerts();
-        vtkIdType polysIndex = linesIndex + ds->GetNumberOfLines();
-        vtkIdType stripsIndex = polysIndex + ds->GetNumberOfPolys();
-
-        // copy the cells
-        pVerts = this->AppendCells(pVerts, inVerts, ptOffset);
-        pLines = this->AppendCells(pLines, inLines, ptOffset);
-        pPolys = this->AppendCells(pPolys, inPolys, ptOffset);
-        pStrips = this->AppendCells(pStrips, inStrips, ptOffset);
-
-        // copy cell data
-        outputCD->CopyData(cellList, inCD, countCD, vertOffset, ds->GetNumberOfVerts(), vertsIndex);
-        vertOffset += ds->GetNumberOfVerts();
-        outputCD->CopyData(cellList, inCD, countCD, linesOffset, ds->GetNumberOfLines(), linesIndex);
-        linesOffset += ds->GetNumberOfLines();
-        outputCD->CopyData(cellList, inCD, countCD, polysOffset, ds->GetNumberOfPolys(), polysIndex);
-        polysOffset += ds->GetNumberOfPolys();
-        outputCD->CopyData(cellList, inCD, countCD, stripsOffset, ds->GetNumberOfStrips(), stripsIndex);
-        stripsOffset += ds->GetNumberOfStrips();
-        ++countCD;
       }
-      ptOffset += numPts;
     }
+    ptOffset += ds->GetNumberOfPoints();
   }
+  this->UpdateProgress(0.2);
+
+  // Copy the inputs. Inputs write to disjoint parts of the output, so they
+  // are copied in parallel unless some arrays are not numeric.
+  AppendPolyDataFunctor append(inputs, offsets, ptList, cellList);
+  append.Points = newPts->GetData();
+  append.Attributes[vtkDataSetAttributes::SCALARS] = newPtScalars;
+  append.Attributes[vtkDataSetAttributes::VECTORS] = newPtVectors;
+  append.Attributes[vtkDataSetAttributes::NORMALS] = newPtNormals;
+  append.Attributes[vtkDataSetAttributes::TCOORDS] = newPtTCoords;
+  append.Attributes[vtkDataSetAttributes::TENSORS] = newPtTensors;
+  append.Connectivity[0] = pVerts;
+  append.Connectivity[1] = pLines;
+  append.Connectivity[2] = pPolys;
+  append.Connectivity[3] = pStrips;
+  append.OutputPD = outputPD;
+  append.OutputCD = outputCD;
+  if (numericArraysOnly)
+  {
+    vtkSMPTools::For(0, numInputs, append);
+  }
+  else
+  {
+    append(0, numInputs);
+  }
+  this->UpdateProgress(1.0);
 
   // Update ourselves and release memory
   //
@@ -688,35 +888,6 @@ void vtkAppendPolyData::PrintSelf(ostream& os, vtkIndent indent)
      << endl;
 }
 
-//----------------------------------------------------------------------------
-namespace {
-struct AppendDataWorker
-{
-  vtkIdType Offset;
-
-  AppendDataWorker(vtkIdType offset) : Offset(offset) {}
-
-  template <typename Array1T, typename Array2T>
-  void operator()(Array1T *dest, Array2T *src)
-  {
-    vtkDataArrayAccessor<Array1T> d(dest);
-    vtkDataArrayAccessor<Array2T> s(src);
-    VTK_ASSUME(src->GetNumberOfComponents() == dest->GetNumberOfComponents());
-
-    const vtkIdType numTuples = src->GetNumberOfTuples();
-    const int numComps = src->GetNumberOfComponents();
-
-    for (vtkIdType t = 0; t < numTuples; ++t)
-    {
-      for (int c = 0; c < numComps; ++c)
-      {
-        d.Set(t + this->Offset, c, s.Get(t, c));
-      }
-    }
-  }
-};
-} // end anon namespace
-
 //----------------------------------------------------------------------------
 void vtkAppendPolyData::AppendData(vtkDataArray *dest, vtkDataArray *src,
                                    vtkIdType offset)
@@ -726,12 +897,7 @@ void vtkAppendPolyData::AppendData(vtkDataArray *dest, vtkDataArray *src,
   assert("Destination array has enough tuples." &&
          src->GetNumberOfTuples() + offset <= dest->GetNumberOfTuples());
 
-  AppendDataWorker worker(offset);
-  if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(dest, src, worker))
-  {
-    // Use vtkDataArray API when fast-path dispatch fails.
-    worker(dest, src);
-  }
+  AppendDataArray(dest, src, offset, 0, src->GetNumberOfTuples());
 }
 
 //----------------------------------------------------------------------------
@@ -739,34 +905,7 @@ void vtkAppendPolyData::AppendData(vtkDataArray *dest, vtkDataArray *src,
 vtkIdType *vtkAppendPolyData::AppendCells(vtkIdType *pDest, vtkCellArray *src,
                                           vtkIdType offset)
 {
-  vtkIdType *pSrc, *end, *pNum;
-
-  if (src == nullptr)
-  {
-    return pDest;
-  }
-
-  pSrc = src->GetPointer();
-  end = pSrc + src->GetNumberOfConnectivityEntries();
-  pNum = pSrc;
-
-  while (pSrc < end)
-  {
-    if (pSrc == pNum)
-    {
-      // move cell pointer to next cell
-      pNum += 1+*pSrc;
-      // copy the number of cells
-      *pDest++ = *pSrc++;
-    }
-    else
-    {
-      // offset the point index
-      *pDest++ = offset + *pSrc++;
-    }
-  }
-
-  return pDest;
+  return AppendCellArray(pDest, src, offset);
 }
 
 //----------------------------------------------------------------------------
@@ -26,11 +26,162 @@
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkTable.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkArrayCalculator);
 
+namespace
+{
+//----------------------------------------------------------------------------
+// Where the values of a variable of the function parser come from: a
+// component of an array, a component of the point coordinates, or, when
+// neither is set, the constant value already set in the parser.
+struct vtkArrayCalculatorVariable
+{
+  vtkDataArray* Array;
+  bool Coordinates;
+  int Components[3];
+
+  vtkArrayCalculatorVariable() : Array(nullptr), Coordinates(false)
+  {
+    std::fill_n(this->Components, 3, 0);
+  }
+};
+
+//----------------------------------------------------------------------------
+// Evaluates the function over a range of tuples, gathering the variables
+// and evaluating the parser one block of tuples at a time.
+class vtkArrayCalculatorFunctor
+{
+public:
+  vtkFunctionParser* Parser;
+  vtkDataSet* DataSet;
+  vtkGraph* Graph;
+  std::vector<vtkArrayCalculatorVariable> ScalarVariables;
+  std::vector<vtkArrayCalculatorVariable> VectorVariables;
+  vtkDataArray* Result;
+  int NumberOfResultComponents;
+  vtkIdType NumberOfInvalidTuples;
+
+  vtkSMPThreadLocal<std::vector<double> > Values;
+  vtkSMPThreadLocal<std::vector<double> > Results;
+  vtkSMPThreadLocal<std::vector<double> > Workspace;
+  vtkSMPThreadLocal<vtkIdType> InvalidTuples;
+
+  vtkArrayCalculatorFunctor()
+    : Parser(nullptr), DataSet(nullptr), Graph(nullptr), Result(nullptr),
+      NumberOfResultComponents(1), NumberOfInvalidTuples(0)
+  {
+  }
+
+  void Initialize()
+  {
+    this->InvalidTuples.Local() = 0;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    const vtkIdType blockSize = 1024;
+    const size_t numScalars = this->ScalarVariables.size();
+    const size_t numVectors = this->VectorVariables.size();
+    std::vector<double>& values = this->Values.Local();
+    std::vector<double>& results = this->Results.Local();
+    std::vector<double>& workspace = this->Workspace.Local();
+    std::vector<const double*> scalarValues(numScalars, nullptr);
+    std::vector<const double*> vectorValues(numVectors, nullptr);
+    double x[3];
+
+    for (vtkIdType blockBegin = begin; blockBegin < end; blockBegin += blockSize)
+    {
+      const vtkIdType n = std::min(blockSize, end - blockBegin);
+      values.resize((numScalars + 3 * numVectors) * n);
+      results.resize(this->NumberOfResultComponents * n);
+
+      // gather the variables, one column per scalar variable and one
+      // interleaved column per vector variable
+      double* column = values.data();
+      for (size_t v = 0; v < numScalars; ++v, column += n)
+      {
+        const vtkArrayCalculatorVariable& var = this->ScalarVariables[v];
+        scalarValues[v] = (var.Array || var.Coordinates) ? column : nullptr;
+        for (vtkIdType t = 0; var.Array && t < n; ++t)
+        {
+          column[t] = var.Array->GetComponent(blockBegin + t, var.Components[0]);
+        }
+        for (vtkIdType t = 0; var.Coordinates && t < n; ++t)
+        {
+          this->GetPoint(blockBegin + t, x);
+          column[t] = x[var.Components[0]];
+        }
+      }
+      for (size_t v = 0; v < numVectors; ++v, column += 3 * n)
+      {
+        const vtkArrayCalculatorVariable& var = this->VectorVariables[v];
+        vectorValues[v] = (var.Array || var.Coordinates) ? column : nullptr;
+        for (vtkIdType t = 0; (var.Array || var.Coordinates) && t < n; ++t)
+        {
+          for (int c = 0; c < 3; ++c)
+          {
+            if (var.Array)
+            {
+              column[3 * t + c] =
+                var.Array->GetComponent(blockBegin + t, var.Components[c]);
+            }
+            else
+            {
+              if (c == 0)
+              {
+                this->GetPoint(blockBegin + t, x);
+              }
+              column[3 * t + c] = x[var.Components[c]];
+            }
+          }
+        }
+      }
+
+      vtkIdType numInvalid = this->Parser->EvaluateBlock(n,
+        scalarValues.data(), vectorValues.data(), results.data(), workspace);
+      this->InvalidTuples.Local() += numInvalid < 0 ? n : numInvalid;
+
+      for (vtkIdType t = 0; t < n; ++t)
+      {
+        this->Result->SetTuple(
+          blockBegin + t, &results[this->NumberOfResultComponents * t]);
+      }
+    }
+  }
+
+  void Reduce()
+  {
+    this->NumberOfInvalidTuples = 0;
+    for (vtkSMPThreadLocal<vtkIdType>::iterator it = this->InvalidTuples.begin();
+         it != this->InvalidTuples.end(); ++it)
+    {
+      this->NumberOfInvalidTuples += *it;
+    }
+  }
+
+private:
+  void GetPoint(vtkIdType id, double x[3])
+  {
+    if (this->DataSet)
+    {
+      this->DataSet->GetPoint(id, x);
+    }
+    else
+    {
+      this->Graph->GetPoint(id, x);
+    }
+  }
+};
+}
+
 vtkArrayCalculator::vtkArrayCalculator()
 {
   this->FunctionParser = vtkFunctionParser::New();
@@ -424,23 +575,30 @@ int vtkArrayCalculator::RequestData(
     resultArray->SetTuple(0, this->FunctionParser->GetVectorResult());
   }
 
-  // Save array pointers to avoid looking them up for each tuple.
-  std::vector<vtkDataArray*> scalarArrays(this->NumberOfScalarArrays);
-  std::vector<vtkDataArray*> vectorArrays(this->NumberOfVectorArrays);
-  std::vector<int> scalarArrayIndicies(this->NumberOfScalarArrays);
-  std::vector<int> vectorArrayIndicies(this->NumberOfVectorArrays);
+  // Evaluate the remaining tuples in parallel, a block of tuples at a time.
+  // The variables that are not needed by the function keep the value set
+  // above.
+  vtkArrayCalculatorFunctor calculator;
+  calculator.Parser = this->FunctionParser;
+  calculator.DataSet = dsInput;
+  calculator.Graph = graphInput;
+  calculator.Result = resultArray;
+  calculator.NumberOfResultComponents = resultType == SCALAR_RESULT ? 1 : 3;
+  calculator.ScalarVariables.resize(
+    this->FunctionParser->GetNumberOfScalarVariables());
+  calculator.VectorVariables.resize(
+    this->FunctionParser->GetNumberOfVectorVariables());
 
   for (int cc=0; cc < this->NumberOfScalarArrays; cc++)
   {
     int idx = this->FunctionParser->GetScalarVariableIndex(
       this->ScalarVariableNames[cc]);
-    if (idx >= 0)
+    if (idx >= 0 && this->FunctionParser->GetScalarVariableNeeded(idx))
     {
-      if (this->FunctionParser->GetScalarVariableNeeded(idx))
-      {
-        scalarArrays[cc] = inFD->GetArray(this->ScalarArrayNames[cc]);
-        scalarArrayIndicies[cc] = idx;
-      }
+      calculator.ScalarVariables[idx].Array =
+        inFD->GetArray(this->ScalarArrayNames[cc]);
+      calculator.ScalarVariables[idx].Components[0] =
+        this->SelectedScalarComponents[cc];
     }
   }
 
@@ -448,76 +606,46 @@ int vtkArrayCalculator::RequestData(
   {
     int idx = this->FunctionParser->GetVectorVariableIndex(
       this->VectorVariableNames[cc]);
-    if (idx >= 0)
+    if (idx >= 0 && this->FunctionParser->GetVectorVariableNeeded(idx))
     {
-      if (this->FunctionParser->GetVectorVariableNeeded(idx))
-      {
-        vectorArrays[cc] = inFD->GetArray(this->VectorArrayNames[cc]);
-        vectorArrayIndicies[cc] = idx;
-      }
+      calculator.VectorVariables[idx].Array =
+        inFD->GetArray(this->VectorArrayNames[cc]);
+      std::copy(this->SelectedVectorComponents[cc],
+                this->SelectedVectorComponents[cc] + 3,
+                calculator.VectorVariables[idx].Components);
     }
   }
 
-  for (i = 1; i < numTuples; i++)
+  if(attribute == vtkDataObject::POINT || attribute == vtkDataObject::VERTEX)
   {
-    for (j = 0; j < this->NumberOfScalarArrays; j++)
+    for (j = 0; j < this->NumberOfCoordinateScalarArrays; j++)
     {
-      if ((currentArray = scalarArrays[j]))
-      {
-        this->FunctionParser->
-          SetScalarVariableValue(scalarArrayIndicies[j],
-            currentArray->GetComponent(i, this->SelectedScalarComponents[j]));
-      }
+      vtkArrayCalculatorVariable& var =
+        calculator.ScalarVariables[j + this->NumberOfScalarArrays];
+      var.Array = nullptr;
+      var.Coordinates = true;
+      var.Components[0] = this->SelectedCoordinateScalarComponents[j];
     }
-    for (j = 0; j < this->NumberOfVectorArrays; j++)
+    for (j = 0; j < this->NumberOfCoordinateVectorArrays; j++)
     {
-      if ((currentArray = vectorArrays[j]))
-      {
-        this->FunctionParser->SetVectorVariableValue(vectorArrayIndicies[j],
-            currentArray->GetComponent(i, this->SelectedVectorComponents[j][0]),
-            currentArray->GetComponent(
-              i, this->SelectedVectorComponents[j][1]),
-            currentArray->GetComponent(i, this->SelectedVectorComponents[j][2]));
-      }
-    }
-    if(attribute == vtkDataObject::POINT || attribute == vtkDataObject::VERTEX)
-    {
-      double* pt = nullptr;
-      if (dsInput)
-      {
-        pt = dsInput->GetPoint(i);
-      }
-      else
-      {
-        pt = graphInput->GetPoint(i);
-      }
-      for (j = 0; j < this->NumberOfCoordinateScalarArrays; j++)
-      {
-        this->FunctionParser->
-          SetScalarVariableValue(
-            j+this->NumberOfScalarArrays, pt[this->SelectedCoordinateScalarComponents[j]]);
-      }
-      for (j = 0; j < this->NumberOfCoordinateVectorArrays; j++)
-      {
-        this->FunctionParser->
-          SetVectorVariableValue(
-            j+this->NumberOfVectorArrays,
-            pt[this->SelectedCoordinateVectorComponents[j][0]],
-            pt[this->SelectedCoordinateVectorComponents[j][1]],
-            pt[this->SelectedCoordinateVectorComponents[j][2]]);
-      }
-    }
-    if (resultType == SCALAR_RESULT)
-    {
-      scalarResult[0] = this->FunctionParser->GetScalarResult();
-      resultArray->SetTuple(i, scalarResult);
-    }
-    else
-    {
-      resultArray->SetTuple(i, this->FunctionParser->GetVectorResult());
+      vtkArrayCalculatorVariable& var =
+        calculator.VectorVariables[j + this->NumberOfVectorArrays];
+      var.Array = nullptr;
+      var.Coordinates = true;
+      std::copy(this->SelectedCoordinateVectorComponents[j],
+                this->SelectedCoordinateVectorComponents[j] + 3,
+                var.Components);
     }
   }
 
+  vtkSMPTools::For(1, numTuples, calculator);
+  if (calculator.NumberOfInvalidTuples > 0)
+  {
+    vtkErrorMacro("The function could not be evaluated for "
+                  << calculator.NumberOfInvalidTuples << " tuples. Their result is "
+                  << VTK_PARSER_ERROR_RESULT << ".");
+  }
+
   output->ShallowCopy(input);
   if(resultPoints)
   {
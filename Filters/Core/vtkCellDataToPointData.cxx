@@ -14,22 +14,30 @@
   =========================================================================*/
 #include "vtkCellDataToPointData.h"
 
+#include "vtkArrayDispatch.h"
 #include "vtkCellData.h"
-#include "vtkCell.h"
+#include "vtkCellType.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkDataSet.h"
+#include "vtkGenericCell.h"
+#include "vtkImageData.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMath.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticCellLinksTemplate.h"
 #include "vtkStructuredGrid.h"
 #include "vtkUniformGrid.h"
-#include "vtkUnsignedIntArray.h"
 
 #include <algorithm>
-#include <functional>
+#include <vector>
 
 #define VTK_MAX_CELLS_PER_POINT 4096
 
@@ -38,89 +46,229 @@ vtkStandardNewMacro(vtkCellDataToPointData);
 namespace
 {
 //----------------------------------------------------------------------------
-// Helper template function that implement the major part of the algorighm
-// which will be expanded by the vtkTemplateMacro. The template function is
-// provided so that coverage test can cover this function.
-  template <typename T>
-  void __spread (vtkDataSet* const src, vtkUnsignedIntArray* const num,
-                 vtkDataArray* const srcarray, vtkDataArray* const dstarray,
-                 vtkIdType ncells, vtkIdType npoints, vtkIdType ncomps,
-                 int highestCellDimension, int contributingCellOption)
+// Gather the cell data onto each point through static cell links. Every point
+// is computed independently of the others, so the points are split across
+// threads. When the cell dimensions are given, either only cells of at least
+// HighestCellDimension contribute, or (Patch) only the highest dimension
+// cells using each point contribute.
+struct vtkCellDataToPointDataGatherInfo
+{
+  vtkStaticCellLinksTemplate<vtkIdType>* Links;
+  const unsigned char* CellDimensions;
+  int HighestCellDimension;
+  bool Patch;
+};
+
+template <typename SrcArrayT, typename DstArrayT>
+struct vtkCellDataToPointDataGather
+{
+  const vtkCellDataToPointDataGatherInfo& Info;
+  SrcArrayT* Src;
+  DstArrayT* Dst;
+  int NumComps;
+  vtkSMPThreadLocal<std::vector<double> > Sums;
+
+  vtkCellDataToPointDataGather(const vtkCellDataToPointDataGatherInfo& info,
+                               SrcArrayT* src, DstArrayT* dst)
+    : Info(info), Src(src), Dst(dst), NumComps(src->GetNumberOfComponents())
   {
-    T const* const srcptr = static_cast<T const*>(srcarray->GetVoidPointer(0));
-    T      * const dstptr = static_cast<T      *>(dstarray->GetVoidPointer(0));
+  }
 
-    // zero initialization
-    std::fill_n(dstptr, npoints*ncomps, T(0));
+  void Initialize()
+  {
+    this->Sums.Local().resize(4 * this->NumComps);
+  }
 
-    // accumulate
-    if (contributingCellOption != vtkCellDataToPointData::Patch)
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    typedef typename vtkDataArrayAccessor<DstArrayT>::APIType DstValueT;
+    vtkDataArrayAccessor<SrcArrayT> src(this->Src);
+    vtkDataArrayAccessor<DstArrayT> dst(this->Dst);
+    std::vector<double>& sums = this->Sums.Local();
+    const int ncomps = this->NumComps;
+    const unsigned char* cellDims = this->Info.CellDimensions;
+
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
     {
-      T const* srcbeg = srcptr;
-      for (vtkIdType cid = 0; cid < ncells; ++cid, srcbeg += ncomps)
+      const vtkIdType ncells = this->Info.Links->GetNumberOfCells(ptId);
+      const vtkIdType* cells = this->Info.Links->GetCells(ptId);
+      vtkIdType counts[4] = { 0, 0, 0, 0 };
+      std::fill(sums.begin(), sums.end(), 0.0);
+
+      for (vtkIdType i = 0; i < ncells; ++i)
       {
-        vtkCell* cell = src->GetCell(cid);
-        if (cell->GetCellDimension() >= highestCellDimension)
+        const vtkIdType cellId = cells[i];
+        int slot = 0;
+        if (cellDims)
         {
-          vtkIdList* pids = cell->GetPointIds();
-          for (vtkIdType i = 0, I = pids->GetNumberOfIds(); i < I; ++i)
+          if (this->Info.Patch)
+          {
+            slot = cellDims[cellId];
+          }
+          else if (cellDims[cellId] < this->Info.HighestCellDimension)
           {
-            T* const dstbeg = dstptr + pids->GetId(i)*ncomps;
-            // accumulate cell data to point data <==> point_data += cell_data
-            std::transform(srcbeg,srcbeg+ncomps,dstbeg,dstbeg,std::plus<T>());
+            continue;
           }
         }
-      }
-      // average
-      T* dstbeg = dstptr;
-      for (vtkIdType pid = 0; pid < npoints; ++pid, dstbeg += ncomps)
-      {
-        // guard against divide by zero
-        if (unsigned int const denom = num->GetValue(pid))
+        ++counts[slot];
+        double* sum = sums.data() + slot * ncomps;
+        for (int comp = 0; comp < ncomps; ++comp)
         {
-          // divide point data by the number of cells using it <==>
-          // point_data /= denum
-          std::transform(dstbeg, dstbeg+ncomps, dstbeg,
-                         std::bind2nd(std::divides<T>(), denom));
+          sum[comp] += static_cast<double>(src.Get(cellId, comp));
         }
       }
+
+      // with patches, only the highest dimension cells are averaged
+      int slot = this->Info.Patch ? 3 : 0;
+      while (slot > 0 && counts[slot] == 0)
+      {
+        --slot;
+      }
+      const double* sum = sums.data() + slot * ncomps;
+      const double weight = counts[slot] ? 1.0 / counts[slot] : 0.0;
+      for (int comp = 0; comp < ncomps; ++comp)
+      {
+        DstValueT value;
+        vtkMath::RoundDoubleToIntegralIfNecessary(sum[comp] * weight, &value);
+        dst.Set(ptId, comp, value);
+      }
     }
-    else
-    { // compute over cell patches
-      vtkNew<vtkIdList> cellsOnPoint;
-      std::vector<T> data(4*ncomps);
-      for (vtkIdType pid = 0; pid < npoints; ++pid)
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+//----------------------------------------------------------------------------
+// Average the cells adjacent to each point of a structured data set without
+// building any links: the cells using point (i,j,k) are the cells
+// (i-1..i, j-1..j, k-1..k) clamped to the cell extent.
+template <typename SrcArrayT, typename DstArrayT>
+struct vtkCellDataToPointDataStructuredGather
+{
+  const int* Dims;
+  SrcArrayT* Src;
+  DstArrayT* Dst;
+  int NumComps;
+  vtkSMPThreadLocal<std::vector<double> > Sums;
+
+  vtkCellDataToPointDataStructuredGather(const int* dims,
+                                         SrcArrayT* src, DstArrayT* dst)
+    : Dims(dims), Src(src), Dst(dst), NumComps(src->GetNumberOfComponents())
+  {
+  }
+
+  void Initialize()
+  {
+    this->Sums.Local().resize(this->NumComps);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    typedef typename vtkDataArrayAccessor<DstArrayT>::APIType DstValueT;
+    vtkDataArrayAccessor<SrcArrayT> src(this->Src);
+    vtkDataArrayAccessor<DstArrayT> dst(this->Dst);
+    std::vector<double>& sums = this->Sums.Local();
+    const int ncomps = this->NumComps;
+    const vtkIdType dims[3] = { this->Dims[0], this->Dims[1], this->Dims[2] };
+    const vtkIdType cellDims[3] = {
+      std::max<vtkIdType>(dims[0] - 1, 1),
+      std::max<vtkIdType>(dims[1] - 1, 1),
+      std::max<vtkIdType>(dims[2] - 1, 1) };
+
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      const vtkIdType ijk[3] = {
+        ptId % dims[0], (ptId / dims[0]) % dims[1], ptId / (dims[0] * dims[1]) };
+      vtkIdType lo[3], hi[3];
+      for (int axis = 0; axis < 3; ++axis)
       {
-        std::fill(data.begin(), data.end(), 0);
-        T numPointCells[4] = {0, 0, 0, 0};
-        // Get all cells touching this point.
-        src->GetPointCells(pid, cellsOnPoint);
-        vtkIdType numPatchCells = cellsOnPoint->GetNumberOfIds();
-        for (vtkIdType pc = 0; pc  < numPatchCells; pc++)
-        {
-          vtkIdType cellId = cellsOnPoint->GetId(pc);
-          int cellDimension = src->GetCell(cellId)->GetCellDimension();
-          numPointCells[cellDimension] += 1;
-          for (int comp=0;comp<ncomps;comp++)
-          {
-            data[comp+ncomps*cellDimension] += srcptr[comp+cellId*ncomps];
-          }
-        }
-        for (int dimension=3;dimension>=0;dimension--)
+        lo[axis] = std::max<vtkIdType>(ijk[axis] - 1, 0);
+        hi[axis] = std::min<vtkIdType>(ijk[axis], cellDims[axis] - 1);
+      }
+      const double weight =
+        1.0 / ((hi[0] - lo[0] + 1) * (hi[1] - lo[1] + 1) * (hi[2] - lo[2] + 1));
+
+      std::fill(sums.begin(), sums.end(), 0.0);
+      for (vtkIdType k = lo[2]; k <= hi[2]; ++k)
+      {
+        for (vtkIdType j = lo[1]; j <= hi[1]; ++j)
         {
-          if (numPointCells[dimension])
+          vtkIdType cellId = lo[0] + cellDims[0] * (j + cellDims[1] * k);
+          for (vtkIdType i = lo[0]; i <= hi[0]; ++i, ++cellId)
           {
-            for (int comp=0;comp<ncomps;comp++)
+            for (int comp = 0; comp < ncomps; ++comp)
             {
-              dstptr[comp+pid*ncomps] = data[comp+dimension*ncomps] / numPointCells[dimension];
+              sums[comp] += weight * static_cast<double>(src.Get(cellId, comp));
             }
-            break;
           }
         }
       }
+      for (int comp = 0; comp < ncomps; ++comp)
+      {
+        DstValueT value;
+        vtkMath::RoundDoubleToIntegralIfNecessary(sums[comp], &value);
+        dst.Set(ptId, comp, value);
+      }
     }
   }
 
+  void Reduce()
+  {
+  }
+};
+
+//----------------------------------------------------------------------------
+// vtkArrayDispatch workers launching the gathers above.
+struct vtkCellDataToPointDataGatherWorker
+{
+  const vtkCellDataToPointDataGatherInfo* Info;
+
+  template <typename SrcArrayT, typename DstArrayT>
+  void operator()(SrcArrayT* src, DstArrayT* dst)
+  {
+    vtkCellDataToPointDataGather<SrcArrayT, DstArrayT> gather(*this->Info, src, dst);
+    vtkSMPTools::For(0, dst->GetNumberOfTuples(), gather);
+  }
+};
+
+struct vtkCellDataToPointDataStructuredWorker
+{
+  const int* Dims;
+
+  template <typename SrcArrayT, typename DstArrayT>
+  void operator()(SrcArrayT* src, DstArrayT* dst)
+  {
+    vtkCellDataToPointDataStructuredGather<SrcArrayT, DstArrayT> gather(
+      this->Dims, src, dst);
+    vtkSMPTools::For(0, dst->GetNumberOfTuples(), gather);
+  }
+};
+
+//----------------------------------------------------------------------------
+// Returns the point dimensions of the structured data sets handled by the
+// link-free path.
+bool vtkCellDataToPointDataGetDimensions(vtkDataSet* input, int dims[3])
+{
+  if (vtkImageData* image = vtkImageData::SafeDownCast(input))
+  {
+    image->GetDimensions(dims);
+    return true;
+  }
+  if (vtkRectilinearGrid* rgrid = vtkRectilinearGrid::SafeDownCast(input))
+  {
+    rgrid->GetDimensions(dims);
+    return true;
+  }
+  if (vtkStructuredGrid* sgrid = vtkStructuredGrid::SafeDownCast(input))
+  {
+    sgrid->GetDimensions(dims);
+    return true;
+  }
+  return false;
+}
+
   // Special traversal algorithm for vtkUniformGrid and vtkRectilinearGrid to support blanking
   // points will not have more than 8 cells for either of these data sets
   template <typename T>
@@ -177,6 +325,63 @@ namespace
       }
     }
   }
+
+  // Link-free traversal for image data, rectilinear grids and unblanked
+  // structured grids. Returns false when the input cannot be handled this way
+  // (e.g. non numeric cell arrays), in which case the generic path is used.
+  bool InterpolateStructuredPointData(vtkCellDataToPointData* filter,
+                                      vtkDataSet* input, vtkDataSet* output)
+  {
+    int dims[3];
+    if (!vtkCellDataToPointDataGetDimensions(input, dims))
+    {
+      return false;
+    }
+    vtkIdType const numPts = input->GetNumberOfPoints();
+    if (static_cast<vtkIdType>(dims[0]) * dims[1] * dims[2] != numPts)
+    {
+      return false;
+    }
+    vtkCellData* const inCD = input->GetCellData();
+    for (int i = 0; i < inCD->GetNumberOfArrays(); ++i)
+    {
+      if (!vtkDataArray::FastDownCast(inCD->GetAbstractArray(i)))
+      {
+        return false;
+      }
+    }
+
+    vtkPointData* const outPD = output->GetPointData();
+    vtkDataSetAttributes::FieldList cfl(1);
+    cfl.InitializeFieldList(inCD);
+    outPD->InterpolateAllocate(cfl, numPts, numPts);
+
+    vtkCellDataToPointDataStructuredWorker worker;
+    worker.Dims = dims;
+    for (int fid = 0, nfields = cfl.GetNumberOfFields(); fid < nfields; ++fid)
+    {
+      filter->UpdateProgress((fid+1.)/nfields);
+      if (filter->GetAbortExecute())
+      {
+        break;
+      }
+      int const dstid = cfl.GetFieldIndex(fid);
+      int const srcid = cfl.GetDSAIndex(0,fid);
+      if (srcid < 0 || dstid < 0)
+      {
+        continue;
+      }
+      vtkDataArray* const srcarray = inCD->GetArray(srcid);
+      vtkDataArray* const dstarray = outPD->GetArray(dstid);
+      dstarray->SetNumberOfTuples(numPts);
+      if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(
+            srcarray, dstarray, worker))
+      {
+        worker(srcarray, dstarray);
+      }
+    }
+    return true;
+  }
 } // end anonymous namespace
 
 //----------------------------------------------------------------------------
@@ -238,7 +443,7 @@ int vtkCellDataToPointData::RequestData(
   {
     InterpolatePointDataWithMask(this, uniformGrid, output);
   }
-  else
+  else if (!InterpolateStructuredPointData(this, input, output))
   {
     this->InterpolatePointData(input, output);
   }
@@ -281,47 +486,38 @@ int vtkCellDataToPointData::RequestDataForUnstructuredData
     return 1;
   }
 
-  // count the number of cells associated with each point. if we are doing patches
-  // though we will do that later on.
-  vtkSmartPointer<vtkUnsignedIntArray> num;
+  // Cell dimensions are only needed when not all cells contribute. They are
+  // cached per cell type since generic cells are costly to instantiate.
+  std::vector<unsigned char> cellDims;
   int highestCellDimension = 0;
-  if (this->ContributingCellOption != vtkCellDataToPointData::Patch)
+  if (this->ContributingCellOption != vtkCellDataToPointData::All)
   {
-    num = vtkSmartPointer<vtkUnsignedIntArray>::New();
-    num->SetNumberOfComponents(1);
-    num->SetNumberOfTuples(npoints);
-    std::fill_n(num->GetPointer(0), npoints, 0u);
-    if (this->ContributingCellOption == vtkCellDataToPointData::DataSetMax)
-    {
-      int maxDimension = src->IsA("vtkPolyData") == 1 ? 2 : 3;
-      for (vtkIdType i=0;i<src->GetNumberOfCells();i++)
-      {
-        int dim = src->GetCell(i)->GetCellDimension();
-        if (dim > highestCellDimension)
-        {
-          highestCellDimension = dim;
-          if (highestCellDimension == maxDimension)
-          {
-            break;
-          }
-        }
-      }
-    }
-    vtkNew<vtkIdList> pids;
+    signed char typeDims[VTK_NUMBER_OF_CELL_TYPES];
+    std::fill_n(typeDims, VTK_NUMBER_OF_CELL_TYPES, -1);
+    vtkNew<vtkGenericCell> typeCell;
+    cellDims.resize(ncells);
     for (vtkIdType cid = 0; cid < ncells; ++cid)
     {
-      if (src->GetCell(cid)->GetCellDimension() >= highestCellDimension)
+      int const type = src->GetCellType(cid);
+      if (typeDims[type] < 0)
       {
-        src->GetCellPoints(cid, pids);
-        for (vtkIdType i = 0, I = pids->GetNumberOfIds(); i < I; ++i)
-        {
-          vtkIdType const pid = pids->GetId(i);
-          num->SetValue(pid, num->GetValue(pid)+1);
-        }
+        typeCell->SetCellType(type);
+        typeDims[type] = static_cast<signed char>(typeCell->GetCellDimension());
       }
+      cellDims[cid] = static_cast<unsigned char>(typeDims[type]);
+      highestCellDimension = std::max(highestCellDimension, int(typeDims[type]));
     }
   }
 
+  vtkStaticCellLinksTemplate<vtkIdType> links;
+  links.BuildLinks(src);
+
+  vtkCellDataToPointDataGatherInfo info;
+  info.Links = &links;
+  info.CellDimensions = cellDims.empty() ? nullptr : cellDims.data();
+  info.HighestCellDimension = highestCellDimension;
+  info.Patch = this->ContributingCellOption == vtkCellDataToPointData::Patch;
+
   // First, copy the input to the output as a starting point
   dst->CopyStructure(src);
   vtkPointData* const opd = dst->GetPointData();
@@ -381,11 +577,12 @@ int vtkCellDataToPointData::RequestDataForUnstructuredData
     vtkDataArray* const dstarray = dstpointdata->GetArray(dstid);
     dstarray->SetNumberOfTuples(npoints);
 
-    vtkIdType const ncomps = srcarray->GetNumberOfComponents();
-    switch (srcarray->GetDataType())
+    vtkCellDataToPointDataGatherWorker worker;
+    worker.Info = &info;
+    if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(
+          srcarray, dstarray, worker))
     {
-      vtkTemplateMacro
-        (__spread<VTK_TT>(src,num,srcarray,dstarray,ncells,npoints,ncomps, highestCellDimension, this->ContributingCellOption));
+      worker(srcarray, dstarray);
     }
   }
 
@@ -16,6 +16,7 @@
 
 #include "vtkCell.h"
 #include "vtkCellData.h"
+#include "vtkConnectivityFilterInternals.h"
 #include "vtkDataSet.h"
 #include "vtkDemandDrivenPipeline.h"
 #include "vtkFloatArray.h"
@@ -31,6 +32,9 @@
 #include "vtkUnstructuredGrid.h"
 #include "vtkIdTypeArray.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkConnectivityFilter);
 
 // Construct with default extraction mode to extract largest regions.
@@ -59,6 +63,9 @@ vtkConnectivityFilter::vtkConnectivityFilter()
   this->NewCellScalars = nullptr;
 
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+
+  this->ParallelLabeling = 0;
+  this->RegionIdAssignmentMode = UNSPECIFIED;
 }
 
 vtkConnectivityFilter::~vtkConnectivityFilter()
@@ -133,8 +140,8 @@ int vtkConnectivityFilter::RequestData(
   vtkIdType numPts, numCells, cellId, i, j, pt;
   vtkPoints *newPts;
   int id;
-  int maxCellsInRegion;
-  int largestRegionId = 0;
+  vtkIdType maxCellsInRegion;
+  vtkIdType largestRegionId = 0;
   vtkPointData *pd=input->GetPointData(), *outputPD=output->GetPointData();
   vtkCellData *cd=input->GetCellData(), *outputCD=output->GetCellData();
 
@@ -243,29 +250,42 @@ int vtkConnectivityFilter::RequestData(
   this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION )
   { //visit all cells marking with region number
-    for (cellId=0; cellId < numCells; cellId++)
+    if ( this->ParallelLabeling )
     {
-      if ( cellId && !(cellId % 5000) )
-      {
-        this->UpdateProgress (0.1 + 0.8*cellId/numCells);
-      }
-
-      if ( this->Visited[cellId] < 0 )
+      this->ParallelLabelRegions(input);
+    }
+    else
+    {
+      for (cellId=0; cellId < numCells; cellId++)
       {
-        this->NumCellsInRegion = 0;
-        this->Wave->InsertNextId(cellId);
-        this->TraverseAndMark (input);
+        if ( cellId && !(cellId % 5000) )
+        {
+          this->UpdateProgress (0.1 + 0.8*cellId/numCells);
+        }
 
-        if ( this->NumCellsInRegion > maxCellsInRegion )
+        if ( this->Visited[cellId] < 0 )
         {
-          maxCellsInRegion = this->NumCellsInRegion;
-          largestRegionId = this->RegionNumber;
+          this->NumCellsInRegion = 0;
+          this->Wave->InsertNextId(cellId);
+          this->TraverseAndMark (input);
+
+          this->RegionSizes->InsertValue(this->RegionNumber++,
+                                         this->NumCellsInRegion);
+          this->Wave->Reset();
+          this->Wave2->Reset();
         }
+      }
+    }
 
-        this->RegionSizes->InsertValue(this->RegionNumber++,
-                                       this->NumCellsInRegion);
-        this->Wave->Reset();
-        this->Wave2->Reset();
+    this->AssignRegionIds(numCells);
+
+    // the first of the largest regions
+    for (i=0; i < this->RegionNumber; i++)
+    {
+      if ( this->RegionSizes->GetValue(i) > maxCellsInRegion )
+      {
+        maxCellsInRegion = this->RegionSizes->GetValue(i);
+        largestRegionId = i;
       }
     }
   }
@@ -613,6 +633,103 @@ void vtkConnectivityFilter::TraverseAndMark (vtkDataSet *input)
   } //while wave is not empty
 }
 
+// Label all cells and points at once: join the cells sharing a point with a
+// union-find, then number the resulting trees by their smallest cell id (the
+// same numbering as the serial traversal).
+void vtkConnectivityFilter::ParallelLabelRegions(vtkDataSet *input)
+{
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkIdType numPts = input->GetNumberOfPoints();
+
+  // Make sure the cell and point queries below are thread safe, as links
+  // and cells are built on demand by some datasets.
+  input->GetCellPoints(0, this->PointIds);
+  input->GetPointCells(0, this->CellIds);
+
+  std::vector<unsigned char> inRange;
+  if ( this->InScalars )
+  {
+    inRange.resize(numCells);
+    vtkConnectivityFilterInternals::FlagCellsInRange(
+      input, this->InScalars, this->ScalarRange, false, inRange.data());
+  }
+
+  this->RegionNumber = vtkConnectivityFilterInternals::LabelCells(
+    input, inRange.empty() ? nullptr : inRange.data(), this->Visited);
+  this->UpdateProgress (0.5);
+  std::copy(this->Visited, this->Visited + numCells,
+            this->NewCellScalars->GetPointer(0));
+
+  this->RegionSizes->SetNumberOfValues(this->RegionNumber);
+  vtkIdType *sizes = this->RegionSizes->GetPointer(0);
+  std::fill_n(sizes, this->RegionNumber, 0);
+  for (vtkIdType cellId=0; cellId < numCells; cellId++)
+  {
+    sizes[this->Visited[cellId]]++;
+  }
+  this->UpdateProgress (0.7);
+
+  // Output points keep the input order.
+  std::vector<vtkIdType> pointRegions(numPts);
+  vtkConnectivityFilterInternals::LabelPoints(
+    input, this->Visited, pointRegions.data());
+
+  this->PointNumber = 0;
+  vtkIdType *pointScalars = this->NewScalars->GetPointer(0);
+  for (vtkIdType ptId=0; ptId < numPts; ptId++)
+  {
+    if ( pointRegions[ptId] >= 0 )
+    {
+      pointScalars[this->PointNumber] = pointRegions[ptId];
+      this->PointMap[ptId] = this->PointNumber++;
+    }
+  }
+  this->UpdateProgress (0.9);
+}
+
+// Renumber the regions by cell count if requested. Regions of equal size
+// keep their relative order.
+void vtkConnectivityFilter::AssignRegionIds(vtkIdType numCells)
+{
+  if ( this->RegionIdAssignmentMode == UNSPECIFIED || this->RegionNumber < 2 )
+  {
+    return;
+  }
+
+  vtkIdType numRegions = this->RegionNumber;
+  const vtkIdType *sizes = this->RegionSizes->GetPointer(0);
+  std::vector<vtkIdType> order(numRegions);
+  for (vtkIdType i=0; i < numRegions; i++)
+  {
+    order[i] = i;
+  }
+  if ( this->RegionIdAssignmentMode == CELL_COUNT_DESCENDING )
+  {
+    std::stable_sort(order.begin(), order.end(),
+      [sizes](vtkIdType a, vtkIdType b) { return sizes[a] > sizes[b]; });
+  }
+  else
+  {
+    std::stable_sort(order.begin(), order.end(),
+      [sizes](vtkIdType a, vtkIdType b) { return sizes[a] < sizes[b]; });
+  }
+
+  std::vector<vtkIdType> newIds(numRegions), newSizes(numRegions);
+  for (vtkIdType i=0; i < numRegions; i++)
+  {
+    newIds[order[i]] = i;
+    newSizes[i] = sizes[order[i]];
+  }
+  std::copy(newSizes.begin(), newSizes.end(), this->RegionSizes->GetPointer(0));
+
+  vtkConnectivityFilterInternals::MapIds(
+    newIds.data(), this->Visited, numCells);
+  vtkConnectivityFilterInternals::MapIds(
+    newIds.data(), this->NewCellScalars->GetPointer(0), numCells);
+  vtkConnectivityFilterInternals::MapIds(
+    newIds.data(), this->NewScalars->GetPointer(0), this->PointNumber);
+}
+
 // Obtain the number of connected regions.
 int vtkConnectivityFilter::GetNumberOfExtractedRegions()
 {
@@ -704,5 +821,9 @@ void vtkConnectivityFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Scalar Range: (" << range[0] << ", " << range[1] << ")\n";
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision
      << "\n";
+  os << indent << "Parallel Labeling: "
+     << (this->ParallelLabeling ? "On\n" : "Off\n");
+  os << indent << "Region Id Assignment Mode: "
+     << this->RegionIdAssignmentMode << "\n";
 }
 
@@ -45,6 +45,14 @@
  * structure. These voxels can then be contoured or processed by other
  * visualization filters.
  *
+ * When extracting the largest, specified, or all regions, the regions can be
+ * labeled in parallel by turning on ParallelLabeling. The cells are then
+ * merged into regions with a union-find structure instead of the serial
+ * wave propagation. With ScalarConnectivity on, a cell whose scalars fall
+ * outside the scalar range then always forms a region of its own, whereas
+ * the serial traversal may still pull it into a neighboring region when it
+ * is the first cell of that region visited.
+ *
  * @sa
  * vtkPolyDataConnectivityFilter
 */
@@ -166,6 +174,14 @@ public:
    */
   int GetNumberOfExtractedRegions();
 
+  //@{
+  /**
+   * Obtain the array containing the region sizes of the extracted
+   * regions
+   */
+  vtkGetObjectMacro(RegionSizes,vtkIdTypeArray);
+  //@}
+
   //@{
   /**
    * Turn on/off the coloring of connected regions.
@@ -185,6 +201,40 @@ public:
   vtkGetMacro(OutputPointsPrecision,int);
   //@}
 
+  //@{
+  /**
+   * Turn on/off parallel labeling of the regions. It is used when extracting
+   * the largest, specified or all regions; the seeded and closest point
+   * modes always use the serial traversal. The regions found are the same
+   * as with the serial traversal (see the class documentation for the one
+   * difference with ScalarConnectivity), but the output points are ordered
+   * by input point id. Off by default.
+   */
+  vtkSetMacro(ParallelLabeling,vtkTypeBool);
+  vtkGetMacro(ParallelLabeling,vtkTypeBool);
+  vtkBooleanMacro(ParallelLabeling,vtkTypeBool);
+  //@}
+
+  /**
+   * Enumeration of the ways region ids can be assigned.
+   */
+  enum RegionIdAssignment {
+    UNSPECIFIED,           //!< ordered by the smallest cell id of the region
+    CELL_COUNT_DESCENDING, //!< largest region first
+    CELL_COUNT_ASCENDING   //!< smallest region first
+  };
+
+  //@{
+  /**
+   * Set/get how the region ids are assigned when extracting the largest,
+   * specified or all regions. By default (UNSPECIFIED) the regions are
+   * numbered in the order of their smallest cell id. Regions of equal size
+   * keep that order.
+   */
+  vtkSetClampMacro(RegionIdAssignmentMode,int,UNSPECIFIED,CELL_COUNT_ASCENDING);
+  vtkGetMacro(RegionIdAssignmentMode,int);
+  //@}
+
   int ProcessRequest(vtkInformation*, vtkInformationVector**, vtkInformationVector*) override;
 
 protected:
@@ -210,8 +260,22 @@ protected:
   vtkTypeBool ScalarConnectivity;
   double ScalarRange[2];
 
+  vtkTypeBool ParallelLabeling;
+  int RegionIdAssignmentMode;
+
   void TraverseAndMark(vtkDataSet *input);
 
+  /**
+   * Label all the cells and points of the input with a parallel union-find
+   * over the cells. Fills the same structures as TraverseAndMark().
+   */
+  void ParallelLabelRegions(vtkDataSet *input);
+
+  /**
+   * Renumber the regions according to RegionIdAssignmentMode.
+   */
+  void AssignRegionIds(vtkIdType numCells);
+
 private:
   // used to support algorithm execution
   vtkFloatArray *CellScalars;
@@ -0,0 +1,415 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConnectivityFilterInternals.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @namespace vtkConnectivityFilterInternals
+ * @brief   Parallel region labeling shared by the connectivity filters
+ *
+ * The cells sharing a point are joined with a union-find, then the resulting
+ * trees are numbered by their smallest cell id, which is the numbering of
+ * the serial traversal. The mesh type is a template parameter so that
+ * vtkPolyData uses its faster non-virtual topology queries.
+ *
+ * @sa
+ *  vtkConnectivityFilter vtkPolyDataConnectivityFilter
+ * @warning
+ *  Do not include this file in a header file, it will break PIMPL convention
+*/
+
+#ifndef vtkConnectivityFilterInternals_h
+#define vtkConnectivityFilterInternals_h
+
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkIdList.h"
+#include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace vtkConnectivityFilterInternals
+{
+
+//----------------------------------------------------------------------------
+// Topology queries. The id lists are only used by the vtkDataSet versions;
+// the vtkPolyData versions require the cells and links to be built.
+inline void GetCellPoints(vtkDataSet *mesh, vtkIdType cellId,
+                          vtkIdList *ptIds, vtkIdType& npts,
+                          const vtkIdType *&pts)
+{
+  mesh->GetCellPoints(cellId, ptIds);
+  npts = ptIds->GetNumberOfIds();
+  pts = ptIds->GetPointer(0);
+}
+
+inline void GetCellPoints(vtkPolyData *mesh, vtkIdType cellId, vtkIdList *,
+                          vtkIdType& npts, const vtkIdType *&pts)
+{
+  vtkIdType *ids;
+  mesh->GetCellPoints(cellId, npts, ids);
+  pts = ids;
+}
+
+inline void GetPointCells(vtkDataSet *mesh, vtkIdType ptId,
+                          vtkIdList *cellIds, vtkIdType& ncells,
+                          const vtkIdType *&cells)
+{
+  mesh->GetPointCells(ptId, cellIds);
+  ncells = cellIds->GetNumberOfIds();
+  cells = cellIds->GetPointer(0);
+}
+
+inline void GetPointCells(vtkPolyData *mesh, vtkIdType ptId, vtkIdList *,
+                          vtkIdType& ncells, const vtkIdType *&cells)
+{
+  unsigned short numCells;
+  vtkIdType *ids;
+  mesh->GetPointCells(ptId, numCells, ids);
+  ncells = numCells;
+  cells = ids;
+}
+
+//----------------------------------------------------------------------------
+// Union-find over the cells. A parent always has a smaller id than its
+// children, so the root of a tree is the smallest cell id of its region.
+inline vtkIdType Find(vtkIdType *parent, vtkIdType id)
+{
+  while (parent[id] != id)
+  {
+    parent[id] = parent[parent[id]]; // path halving
+    id = parent[id];
+  }
+  return id;
+}
+
+inline void Union(vtkIdType *parent, vtkIdType a, vtkIdType b)
+{
+  a = Find(parent, a);
+  b = Find(parent, b);
+  if (a < b)
+  {
+    parent[b] = a;
+  }
+  else if (b < a)
+  {
+    parent[a] = b;
+  }
+}
+
+//----------------------------------------------------------------------------
+// With scalar connectivity, flag the cells whose point scalars overlap the
+// scalar range (lie within it with full scalar connectivity). Only those
+// cells are connected to their neighbors.
+template <class TMesh>
+class CellsInRangeFunctor
+{
+public:
+  TMesh *Mesh;
+  vtkDataArray *Scalars;
+  const double *ScalarRange;
+  bool FullScalarConnectivity;
+  unsigned char *InRange;
+  vtkSMPThreadLocalObject<vtkIdList> PointIds;
+
+  void Initialize()
+  {
+    this->PointIds.Local()->Allocate(VTK_CELL_SIZE);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *ptIds = this->PointIds.Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      GetCellPoints(this->Mesh, cellId, ptIds, npts, pts);
+      double range[2] = { VTK_DOUBLE_MAX, VTK_DOUBLE_MIN };
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        double s = this->Scalars->GetComponent(pts[i], 0);
+        range[0] = std::min(range[0], s);
+        range[1] = std::max(range[1], s);
+      }
+      if (this->FullScalarConnectivity)
+      {
+        this->InRange[cellId] = (range[0] >= this->ScalarRange[0] &&
+                                 range[1] <= this->ScalarRange[1]) ? 1 : 0;
+      }
+      else
+      {
+        this->InRange[cellId] = (range[1] >= this->ScalarRange[0] &&
+                                 range[0] <= this->ScalarRange[1]) ? 1 : 0;
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+//----------------------------------------------------------------------------
+// The cells are split in contiguous blocks. Each block only joins pairs of
+// its own cells, so a thread never writes the parent of a cell of another
+// block. The pairs that cross into a later block are kept and joined
+// serially afterwards.
+template <class TMesh>
+class UnionCellsFunctor
+{
+public:
+  TMesh *Mesh;
+  const unsigned char *InRange;
+  vtkIdType *Parent;
+  vtkIdType NumberOfCells;
+  vtkIdType BlockSize;
+  vtkSMPThreadLocalObject<vtkIdList> PointIds;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > Links;
+
+  void Initialize()
+  {
+    this->PointIds.Local()->Allocate(VTK_CELL_SIZE);
+    this->CellIds.Local()->Allocate(VTK_CELL_SIZE);
+  }
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    vtkIdList *ptIds = this->PointIds.Local();
+    vtkIdList *cellIds = this->CellIds.Local();
+    std::vector<vtkIdType>& links = this->Links.Local();
+    vtkIdType npts, ncells;
+    const vtkIdType *pts, *cells;
+
+    for (vtkIdType block = beginBlock; block < endBlock; ++block)
+    {
+      vtkIdType begin = block * this->BlockSize;
+      vtkIdType end = std::min(begin + this->BlockSize, this->NumberOfCells);
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        if (this->InRange && !this->InRange[cellId])
+        {
+          continue;
+        }
+        vtkIdType lastLink = -1;
+        GetCellPoints(this->Mesh, cellId, ptIds, npts, pts);
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          GetPointCells(this->Mesh, pts[i], cellIds, ncells, cells);
+          for (vtkIdType j = 0; j < ncells; ++j)
+          {
+            vtkIdType neiId = cells[j];
+            if (neiId <= cellId || (this->InRange && !this->InRange[neiId]))
+            {
+              continue;
+            }
+            if (neiId < end)
+            {
+              Union(this->Parent, cellId, neiId);
+            }
+            else if (neiId != lastLink)
+            {
+              links.push_back(cellId);
+              links.push_back(neiId);
+              lastLink = neiId;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+//----------------------------------------------------------------------------
+// Find the root of every cell once all the pairs have been joined.
+class FindRootsFunctor
+{
+public:
+  const vtkIdType *Parent;
+  vtkIdType *Roots;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      vtkIdType id = cellId;
+      while (this->Parent[id] != id)
+      {
+        id = this->Parent[id];
+      }
+      this->Roots[cellId] = id;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// A point takes the region of the smallest cell using it (-1 if unused).
+template <class TMesh>
+class PointRegionsFunctor
+{
+public:
+  TMesh *Mesh;
+  const vtkIdType *CellRegions;
+  vtkIdType *PointRegions;
+  vtkSMPThreadLocalObject<vtkIdList> CellIds;
+
+  void Initialize()
+  {
+    this->CellIds.Local()->Allocate(VTK_CELL_SIZE);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellIds = this->CellIds.Local();
+    vtkIdType ncells;
+    const vtkIdType *cells;
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      GetPointCells(this->Mesh, ptId, cellIds, ncells, cells);
+      this->PointRegions[ptId] = (ncells > 0 ?
+        this->CellRegions[*std::min_element(cells, cells + ncells)] : -1);
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+//----------------------------------------------------------------------------
+// Map region ids through a lookup table, skipping unset (negative) ids.
+class MapIdsFunctor
+{
+public:
+  const vtkIdType *Map;
+  vtkIdType *Ids;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      if (this->Ids[i] >= 0)
+      {
+        this->Ids[i] = this->Map[this->Ids[i]];
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Flag the cells satisfying the scalar criterion in inRange (one entry per
+// cell).
+template <class TMesh>
+void FlagCellsInRange(TMesh *mesh, vtkDataArray *scalars,
+                      const double scalarRange[2],
+                      bool fullScalarConnectivity, unsigned char *inRange)
+{
+  CellsInRangeFunctor<TMesh> cellsInRange;
+  cellsInRange.Mesh = mesh;
+  cellsInRange.Scalars = scalars;
+  cellsInRange.ScalarRange = scalarRange;
+  cellsInRange.FullScalarConnectivity = fullScalarConnectivity;
+  cellsInRange.InRange = inRange;
+  vtkSMPTools::For(0, mesh->GetNumberOfCells(), cellsInRange);
+}
+
+//----------------------------------------------------------------------------
+// Store the region of every cell in cellRegions and return the number of
+// regions. Cells sharing a point are in the same region; if inRange is
+// given, only the flagged cells are joined. Regions are numbered in the
+// order of their smallest cell id.
+template <class TMesh>
+vtkIdType LabelCells(TMesh *mesh, const unsigned char *inRange,
+                     vtkIdType *cellRegions)
+{
+  vtkIdType numCells = mesh->GetNumberOfCells();
+  std::vector<vtkIdType> parent(numCells);
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    parent[cellId] = cellId;
+  }
+
+  vtkIdType numBlocks = 4 * vtkSMPTools::GetEstimatedNumberOfThreads();
+  numBlocks = std::max<vtkIdType>(1, std::min(numBlocks, numCells / 1024));
+
+  UnionCellsFunctor<TMesh> unionCells;
+  unionCells.Mesh = mesh;
+  unionCells.InRange = inRange;
+  unionCells.Parent = parent.data();
+  unionCells.NumberOfCells = numCells;
+  unionCells.BlockSize = (numCells + numBlocks - 1) / numBlocks;
+  vtkSMPTools::For(0, numBlocks, 1, unionCells);
+
+  typename vtkSMPThreadLocal<std::vector<vtkIdType> >::iterator linksItr;
+  for (linksItr = unionCells.Links.begin();
+       linksItr != unionCells.Links.end(); ++linksItr)
+  {
+    const std::vector<vtkIdType>& links = *linksItr;
+    for (size_t i = 0; i < links.size(); i += 2)
+    {
+      Union(parent.data(), links[i], links[i+1]);
+    }
+  }
+
+  FindRootsFunctor findRoots = { parent.data(), cellRegions };
+  vtkSMPTools::For(0, numCells, findRoots);
+
+  // Number the regions in the order of their root (smallest) cell, reusing
+  // the parent entry of the roots to hold the region id.
+  vtkIdType numRegions = 0;
+  for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+  {
+    if (cellRegions[cellId] == cellId)
+    {
+      parent[cellId] = numRegions++;
+    }
+  }
+  MapIdsFunctor regionIds = { parent.data(), cellRegions };
+  vtkSMPTools::For(0, numCells, regionIds);
+  return numRegions;
+}
+
+//----------------------------------------------------------------------------
+// Store the region of every point in pointRegions, given the regions of the
+// cells.
+template <class TMesh>
+void LabelPoints(TMesh *mesh, const vtkIdType *cellRegions,
+                 vtkIdType *pointRegions)
+{
+  PointRegionsFunctor<TMesh> regionsOfPoints;
+  regionsOfPoints.Mesh = mesh;
+  regionsOfPoints.CellRegions = cellRegions;
+  regionsOfPoints.PointRegions = pointRegions;
+  vtkSMPTools::For(0, mesh->GetNumberOfPoints(), regionsOfPoints);
+}
+
+//----------------------------------------------------------------------------
+// Replace each non negative id of ids[0, numIds) by map[id].
+inline void MapIds(const vtkIdType *map, vtkIdType *ids, vtkIdType numIds)
+{
+  MapIdsFunctor mapIds = { map, ids };
+  vtkSMPTools::For(0, numIds, mapIds);
+}
+
+} // namespace vtkConnectivityFilterInternals
+
+#endif
+// VTK-HeaderTest-Exclude: vtkConnectivityFilterInternals.h
@@ -37,6 +37,7 @@
 #include "vtkPointLocator.h"
 #include "vtkIncrementalPointLocator.h"
 #include "vtkContourHelper.h"
+#include "vtkParallelContourHelper.h"
 #include <cmath>
 
 vtkStandardNewMacro(vtkContourGrid);
@@ -58,6 +59,8 @@ vtkContourGrid::vtkContourGrid()
   this->UseScalarTree = 0;
   this->ScalarTree = nullptr;
 
+  this->ParallelContouring = 0;
+
   this->OutputPointsPrecision = DEFAULT_PRECISION;
 
   // by default process active point scalars
@@ -376,6 +379,63 @@ void vtkContourGridExecute(vtkContourGrid *self, vtkDataSet *input,
   output->Squeeze();
 }
 
+//-----------------------------------------------------------------------------
+// Threaded version of vtkContourGridExecute(): the cells are contoured by
+// vtkParallelContourHelper, which merges the points of all the threads.
+static void vtkContourGridParallelExecute(vtkContourGrid *self,
+                                          vtkDataSet *input,
+                                          vtkPolyData *output,
+                                          vtkDataArray *inScalars,
+                                          int numContours, double *values,
+                                          int computeScalars,
+                                          int useScalarTree,
+                                          vtkScalarTree *scalarTree,
+                                          bool generateTriangles)
+{
+  // See vtkContourGridExecute(): the active scalars of (a shallow copy of)
+  // the point data are the scalars to contour.
+  vtkSmartPointer<vtkPointData> inPd = vtkSmartPointer<vtkPointData>::New();
+  inPd->ShallowCopy(input->GetPointData());
+  vtkAbstractArray* oldScalars = inPd->GetScalars();
+  inPd->SetScalars(inScalars);
+  if (oldScalars)
+  {
+    inPd->AddArray(oldScalars);
+  }
+
+  int pointsType = static_cast<vtkUnstructuredGridBase *>(input)->
+    GetPoints()->GetDataType();
+  if(self->GetOutputPointsPrecision() == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    pointsType = VTK_FLOAT;
+  }
+  else if(self->GetOutputPointsPrecision() == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    pointsType = VTK_DOUBLE;
+  }
+
+  vtkParallelContourHelper helper(input, inScalars, inPd,
+                                  input->GetCellData(), pointsType,
+                                  computeScalars != 0, generateTriangles);
+  helper.SetAlgorithm(self);
+  if ( !useScalarTree )
+  {
+    helper.ContourAllCells(numContours, values);
+  }
+  else
+  {
+    // The batches of candidate cells of every contour value are contoured
+    // in parallel, straight from the tree.
+    for (int i=0; i < numContours && !self->GetAbortExecute(); i++)
+    {
+      helper.ContourCellBatches(scalarTree, values[i]);
+      self->UpdateProgress(static_cast<double>(i + 1) / numContours);
+    }
+  }
+  helper.GetOutput(output);
+  output->Squeeze();
+}
+
 //-----------------------------------------------------------------------------
 // Contouring filter for unstructured grids.
 //
@@ -428,15 +488,25 @@ int vtkContourGrid::RequestData(
     scalarTree->SetScalars(inScalars);
   }
 
-  switch (inScalars->GetDataType())
+  if ( this->ParallelContouring )
+  {
+    vtkContourGridParallelExecute(this, input, output, inScalars,
+                                  numContours, values, computeScalars,
+                                  useScalarTree, scalarTree,
+                                  this->GenerateTriangles != 0);
+  }
+  else
   {
-    vtkTemplateMacro(vtkContourGridExecute<VTK_TT>(
-            this, input, output, inScalars, numContours, values,
-            computeScalars, useScalarTree, scalarTree,
-            this->GenerateTriangles != 0));
-    default:
-      vtkErrorMacro(<< "Execute: Unknown ScalarType");
-      return 1;
+    switch (inScalars->GetDataType())
+    {
+      vtkTemplateMacro(vtkContourGridExecute<VTK_TT>(
+              this, input, output, inScalars, numContours, values,
+              computeScalars, useScalarTree, scalarTree,
+              this->GenerateTriangles != 0));
+      default:
+        vtkErrorMacro(<< "Execute: Unknown ScalarType");
+        return 1;
+    }
   }
 
   if(this->ComputeNormals)
@@ -548,6 +618,8 @@ void vtkContourGrid::PrintSelf(ostream& os, vtkIndent indent)
      << (this->ComputeScalars ? "On\n" : "Off\n");
   os << indent << "Use Scalar Tree: "
      << (this->UseScalarTree ? "On\n" : "Off\n");
+  os << indent << "Parallel Contouring: "
+     << (this->ParallelContouring ? "On\n" : "Off\n");
 
   this->ContourValues->PrintSelf(os,indent.GetNextIndent());
 
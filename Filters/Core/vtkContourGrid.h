@@ -166,6 +166,23 @@ public:
   vtkBooleanMacro(GenerateTriangles,vtkTypeBool);
   //@}
 
+  //@{
+  /**
+   * Enable contouring in parallel (using vtkSMPTools). The cells are
+   * contoured in blocks by several threads and the points of all the blocks
+   * are merged afterwards, so the output is a single polydata with the same
+   * points, cells and attributes as the serial algorithm produces (except
+   * that coincident points are always merged). When a scalar tree is used,
+   * the batches of candidate cells of every contour value are contoured in
+   * parallel straight from the tree, which is only rebuilt when the input
+   * or its scalars change (so sweeping contour values reuses it). The
+   * Locator is not used in this mode. Off by default.
+   */
+  vtkSetMacro(ParallelContouring,vtkTypeBool);
+  vtkGetMacro(ParallelContouring,vtkTypeBool);
+  vtkBooleanMacro(ParallelContouring,vtkTypeBool);
+  //@}
+
   /**
    * Create default locator. Used to create one when none is
    * specified. The locator is used to merge coincident points.
@@ -200,6 +217,8 @@ protected:
   vtkTypeBool UseScalarTree;
   vtkScalarTree *ScalarTree;
 
+  vtkTypeBool ParallelContouring;
+
   int OutputPointsPrecision;
   vtkEdgeTable *EdgeTable;
 
@@ -49,6 +49,7 @@
 #include "vtkTimerLog.h"
 #include "vtkSmartPointer.h"
 #include "vtkContourHelper.h"
+#include "vtkParallelContourHelper.h"
 
 #include <algorithm>
 #include <cmath>
@@ -68,6 +69,7 @@ vtkCutter::vtkCutter(vtkImplicitFunction *cf)
   this->GenerateCutScalars = 0;
   this->Locator = nullptr;
   this->GenerateTriangles = 1;
+  this->ParallelCutting = 0;
   this->OutputPointsPrecision = DEFAULT_PRECISION;
 
   this->SynchronizedTemplates3D = vtkSynchronizedTemplates3D::New();
@@ -785,6 +787,34 @@ void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
   {
     inPD = input->GetPointData();
   }
+
+  // Threaded cutting: the cells are cut by vtkParallelContourHelper, which
+  // merges the points of all the threads and builds the whole output.
+  if ( this->ParallelCutting && this->SortBy == VTK_SORT_BY_VALUE &&
+       inputPointSet )
+  {
+    this->CutFunction->FunctionValue(inputPointSet->GetPoints()->GetData(),
+                                     cutScalars);
+    vtkParallelContourHelper parallelHelper(input, cutScalars, inPD, inCD,
+                                            newPoints->GetDataType(), true,
+                                            this->GenerateTriangles != 0);
+    parallelHelper.SetAlgorithm(this);
+    parallelHelper.ContourAllCells(numContours, contourValues);
+    parallelHelper.GetOutput(output);
+    output->Squeeze();
+
+    cutScalars->Delete();
+    if ( this->GenerateCutScalars )
+    {
+      inPD->Delete();
+    }
+    newPoints->Delete();
+    newVerts->Delete();
+    newLines->Delete();
+    newPolys->Delete();
+    return;
+  }
+
   outPD = output->GetPointData();
   outPD->InterpolateAllocate(inPD,estimatedSize,estimatedSize/2);
   outCD->CopyAllocate(inCD,estimatedSize,estimatedSize/2);
@@ -1055,6 +1085,8 @@ void vtkCutter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Cut Function: " << this->CutFunction << "\n";
   os << indent << "Sort By: " << this->GetSortByAsString() << "\n";
+  os << indent << "Parallel Cutting: "
+     << (this->ParallelCutting ? "On\n" : "Off\n");
 
   if ( this->Locator )
   {
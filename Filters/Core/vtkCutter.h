@@ -200,6 +200,18 @@ public:
   const char *GetSortByAsString();
   //@}
 
+  //@{
+  /**
+   * Enable cutting unstructured grids in parallel (using vtkSMPTools) when
+   * sorting by value. The output is the same single polydata the serial
+   * algorithm produces (except that coincident points are always merged);
+   * the Locator is not used in this mode. Off by default.
+   */
+  vtkSetMacro(ParallelCutting,vtkTypeBool);
+  vtkGetMacro(ParallelCutting,vtkTypeBool);
+  vtkBooleanMacro(ParallelCutting,vtkTypeBool);
+  //@}
+
   /**
    * Create default locator. Used to create one when none is specified. The
    * locator is used to merge coincident points.
@@ -249,6 +261,7 @@ protected:
   int SortBy;
   vtkContourValues *ContourValues;
   vtkTypeBool GenerateCutScalars;
+  vtkTypeBool ParallelCutting;
   int OutputPointsPrecision;
 private:
   vtkCutter(const vtkCutter&) = delete;
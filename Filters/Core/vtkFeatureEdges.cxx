@@ -29,9 +29,363 @@
 #include "vtkCellData.h"
 #include "vtkPointData.h"
 #include "vtkIncrementalPointLocator.h"
+#include "vtkArrayListTemplate.h"
+#include "vtkAtomic.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <vector>
 
 vtkStandardNewMacro(vtkFeatureEdges);
 
+namespace
+{
+// An edge of a polygon, in the bucket of its smallest point: its other
+// point, the polygon, and the position of the edge among the edges of all
+// the polygons (the order in which the serial algorithm visits them).
+struct vtkFeatureEdge
+{
+  vtkIdType Max;
+  vtkIdType Cell;
+  vtkIdType Position;
+
+  // The copies of an edge are ordered by position, hence by polygon.
+  bool operator<(const vtkFeatureEdge &edge) const
+  {
+    if (this->Max != edge.Max)
+    {
+      return this->Max < edge.Max;
+    }
+    return this->Position < edge.Position;
+  }
+};
+
+// Edge types, in the order of their color.
+enum
+{
+  vtkFeatureEdgesNone = 0,
+  vtkFeatureEdgesBoundary,
+  vtkFeatureEdgesNonManifold,
+  vtkFeatureEdgesFeature,
+  vtkFeatureEdgesManifold
+};
+
+// Buckets the edges of every polygon by their smallest point: counts them
+// first, then (once the counts are turned into cursors) scatters them. The
+// order within a bucket depends on the threads, it is sorted afterwards.
+struct vtkFeatureEdgesBucketEdges
+{
+  const vtkIdType *Connectivity;
+  const vtkIdType *Offsets;
+  vtkAtomic<vtkIdType> *Cursors;
+  vtkFeatureEdge *Edges; // nullptr to count
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      const vtkIdType *cell = this->Connectivity + this->Offsets[cellId];
+      vtkIdType npts = cell[0];
+      const vtkIdType *pts = cell + 1;
+      // Each polygon takes npts+1 entries of the connectivity.
+      vtkIdType position = this->Offsets[cellId] - cellId;
+      for (vtkIdType i = 0; i < npts; ++i, ++position)
+      {
+        vtkIdType p1 = pts[i];
+        vtkIdType p2 = pts[(i+1)%npts];
+        vtkIdType min = (p1 < p2 ? p1 : p2);
+        if (!this->Edges)
+        {
+          ++this->Cursors[min];
+          continue;
+        }
+        vtkFeatureEdge &edge = this->Edges[this->Cursors[min]++];
+        edge.Max = (p1 < p2 ? p2 : p1);
+        edge.Cell = cellId;
+        edge.Position = position;
+      }
+    }
+  }
+};
+
+// Computes the normal of every polygon (in float, as the serial algorithm).
+struct vtkFeatureEdgesNormals
+{
+  vtkPoints *Points;
+  const vtkIdType *Connectivity;
+  const vtkIdType *Offsets;
+  float *Normals;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    double n[3];
+    for ( ; cellId < endCellId; ++cellId)
+    {
+      const vtkIdType *cell = this->Connectivity + this->Offsets[cellId];
+      vtkPolygon::ComputeNormal(this->Points, static_cast<int>(cell[0]),
+        const_cast<vtkIdType*>(cell + 1), n);
+      for (int i = 0; i < 3; ++i)
+      {
+        this->Normals[3*cellId+i] = static_cast<float>(n[i]);
+      }
+    }
+  }
+};
+
+// Sorts the edge buckets of a range of points, and classifies the copies
+// of every edge (a run of a sorted bucket) the way the serial algorithm
+// classifies them from the edge neighbors of their polygon.
+struct vtkFeatureEdgesClassify
+{
+  vtkFeatureEdge *Edges;
+  const vtkIdType *Buckets;
+  const float *Normals;
+  double CosAngle;
+  const unsigned char *Ghosts;
+  bool BoundaryEdges;
+  bool NonManifoldEdges;
+  bool FeatureEdges;
+  bool ManifoldEdges;
+  unsigned char *Types;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      vtkFeatureEdge *edges = this->Edges + this->Buckets[ptId];
+      vtkFeatureEdge *edgesEnd = this->Edges + this->Buckets[ptId+1];
+      std::sort(edges, edgesEnd);
+      for (vtkFeatureEdge *first = edges, *last; first < edgesEnd;
+           first = last)
+      {
+        vtkIdType numCells = 1;
+        for (last = first + 1; last < edgesEnd && last->Max == first->Max;
+             ++last)
+        {
+          numCells += (last->Cell != (last-1)->Cell);
+        }
+        this->Classify(first, last, numCells - 1);
+      }
+    }
+  }
+
+  void Classify(const vtkFeatureEdge *first, const vtkFeatureEdge *last,
+                vtkIdType numNei)
+  {
+    vtkIdType minCell = first->Cell;
+    for (const vtkFeatureEdge *edge = first; edge < last; ++edge)
+    {
+      vtkIdType cellId = edge->Cell;
+      unsigned char type = vtkFeatureEdgesNone;
+      if (this->BoundaryEdges && numNei < 1)
+      {
+        type = vtkFeatureEdgesBoundary;
+      }
+      else if (this->NonManifoldEdges && numNei > 1)
+      {
+        // only the first polygon of the edge creates it
+        if (cellId == minCell)
+        {
+          type = vtkFeatureEdgesNonManifold;
+        }
+      }
+      else if (this->FeatureEdges && numNei == 1 && cellId == minCell)
+      {
+        const float *n1 = this->Normals + 3*cellId;
+        const float *n2 = this->Normals + 3*(last-1)->Cell;
+        double dot = static_cast<double>(n1[0]) * n2[0] +
+          static_cast<double>(n1[1]) * n2[1] +
+          static_cast<double>(n1[2]) * n2[2];
+        if (dot <= this->CosAngle)
+        {
+          type = vtkFeatureEdgesFeature;
+        }
+      }
+      else if (this->ManifoldEdges && numNei == 1 && cellId == minCell)
+      {
+        type = vtkFeatureEdgesManifold;
+      }
+      if (this->Ghosts &&
+          this->Ghosts[cellId] & vtkDataSetAttributes::DUPLICATECELL)
+      {
+        type = vtkFeatureEdgesNone;
+      }
+      this->Types[edge->Position] = type;
+    }
+  }
+};
+
+// Copies point coordinates from their source points.
+struct vtkFeatureEdgesCopyPoints
+{
+  vtkPoints *InPoints;
+  vtkPoints *OutPoints;
+  const vtkIdType *Sources;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    double x[3];
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      this->InPoints->GetPoint(this->Sources[ptId], x);
+      this->OutPoints->SetPoint(ptId, x);
+    }
+  }
+};
+
+}
+
+//----------------------------------------------------------------------------
+// Extract the edges from sorted edge lists instead of cell links: the edges
+// of all polygons are bucketed by their smallest point and each bucket is
+// sorted, so the copies of an edge are adjacent and are classified together.
+// Output is in serial order.
+static void vtkFeatureEdgesParallelExecute(vtkFeatureEdges *self,
+                                           vtkPolyData *input,
+                                           vtkPoints *inPts,
+                                           vtkCellArray *polys,
+                                           unsigned char *ghosts,
+                                           int pointsType,
+                                           vtkPolyData *output)
+{
+  vtkIdType numPts = input->GetNumberOfPoints();
+  vtkIdType numPolys = polys->GetNumberOfCells();
+  const vtkIdType *connectivity = polys->GetPointer();
+
+  // Offsets of the polygons in the connectivity
+  std::vector<vtkIdType> offsets(numPolys);
+  vtkIdType offset = 0;
+  for (vtkIdType cellId = 0; cellId < numPolys; ++cellId)
+  {
+    offsets[cellId] = offset;
+    offset += connectivity[offset] + 1;
+  }
+  vtkIdType numEdges = offset - numPolys;
+
+  // Bucket the edges by smallest point.
+  std::vector<vtkAtomic<vtkIdType> > cursors(numPts);
+  vtkFeatureEdgesBucketEdges bucket = { connectivity, offsets.data(),
+                                        cursors.data(), nullptr };
+  vtkSMPTools::For(0, numPolys, bucket);
+  std::vector<vtkIdType> buckets(numPts + 1);
+  buckets[0] = 0;
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+  {
+    buckets[ptId + 1] = buckets[ptId] + cursors[ptId];
+    cursors[ptId] = buckets[ptId];
+  }
+  std::vector<vtkFeatureEdge> edges(numEdges);
+  bucket.Edges = edges.data();
+  vtkSMPTools::For(0, numPolys, bucket);
+  std::vector<vtkAtomic<vtkIdType> >().swap(cursors);
+
+  std::vector<float> normals;
+  double cosAngle = 0.0;
+  if (self->GetFeatureEdges())
+  {
+    normals.resize(3 * numPolys);
+    vtkFeatureEdgesNormals computeNormals = { inPts, connectivity,
+                                              offsets.data(), normals.data() };
+    vtkSMPTools::For(0, numPolys, computeNormals);
+    cosAngle = cos(vtkMath::RadiansFromDegrees(self->GetFeatureAngle()));
+  }
+  self->UpdateProgress(0.4);
+
+  std::vector<unsigned char> types(numEdges);
+  vtkFeatureEdgesClassify classify;
+  classify.Edges = edges.data();
+  classify.Buckets = buckets.data();
+  classify.Normals = normals.data();
+  classify.CosAngle = cosAngle;
+  classify.Ghosts = ghosts;
+  classify.BoundaryEdges = self->GetBoundaryEdges() != 0;
+  classify.NonManifoldEdges = self->GetNonManifoldEdges() != 0;
+  classify.FeatureEdges = self->GetFeatureEdges() != 0;
+  classify.ManifoldEdges = self->GetManifoldEdges() != 0;
+  classify.Types = types.data();
+  vtkSMPTools::For(0, numPts, classify);
+  std::vector<vtkFeatureEdge>().swap(edges);
+  self->UpdateProgress(0.8);
+
+  // Output lines in the order of the polygon edges. Points are numbered in
+  // the order they are first used.
+  static const float scalars[5] = { 0.0f, 0.0f, 0.222222f, 0.444444f,
+                                    0.666667f };
+  std::vector<vtkIdType> newIds(numPts, -1);
+  std::vector<vtkIdType> pointSources;
+  std::vector<vtkIdType> cellSources;
+  std::vector<vtkIdType> lines;
+  std::vector<float> lineScalars;
+  vtkIdType position = 0;
+  for (vtkIdType cellId = 0; cellId < numPolys; ++cellId)
+  {
+    const vtkIdType *cell = connectivity + offsets[cellId];
+    vtkIdType npts = cell[0];
+    for (vtkIdType i = 0; i < npts; ++i, ++position)
+    {
+      if (types[position] == vtkFeatureEdgesNone)
+      {
+        continue;
+      }
+      vtkIdType ends[2] = { cell[1+i], cell[1+(i+1)%npts] };
+      lines.push_back(2);
+      for (int j = 0; j < 2; ++j)
+      {
+        if (newIds[ends[j]] < 0)
+        {
+          newIds[ends[j]] = static_cast<vtkIdType>(pointSources.size());
+          pointSources.push_back(ends[j]);
+        }
+        lines.push_back(newIds[ends[j]]);
+      }
+      cellSources.push_back(cellId);
+      lineScalars.push_back(scalars[types[position]]);
+    }
+  }
+  vtkIdType numNewPts = static_cast<vtkIdType>(pointSources.size());
+  vtkIdType numLines = static_cast<vtkIdType>(cellSources.size());
+
+  vtkNew<vtkPoints> newPts;
+  newPts->SetDataType(pointsType);
+  newPts->SetNumberOfPoints(numNewPts);
+  vtkFeatureEdgesCopyPoints copyPoints = { inPts, newPts,
+                                           pointSources.data() };
+  vtkSMPTools::For(0, numNewPts, copyPoints);
+  output->SetPoints(newPts);
+
+  vtkNew<vtkCellArray> newLines;
+  vtkIdTypeArray *lineArray = vtkIdTypeArray::New();
+  lineArray->SetNumberOfValues(static_cast<vtkIdType>(lines.size()));
+  std::copy(lines.begin(), lines.end(), lineArray->GetPointer(0));
+  newLines->SetCells(numLines, lineArray);
+  lineArray->Delete();
+  output->SetLines(newLines);
+
+  vtkPointData *outPD = output->GetPointData();
+  outPD->CopyAllocate(input->GetPointData(), numNewPts);
+  ArrayList::GatherTuples(input->GetPointData(), outPD,
+    pointSources.data(), static_cast<vtkIdType>(pointSources.size()));
+  vtkCellData *outCD = output->GetCellData();
+  outCD->CopyAllocate(input->GetCellData(), numLines);
+  ArrayList::GatherTuples(input->GetCellData(), outCD,
+    cellSources.data(), static_cast<vtkIdType>(cellSources.size()));
+
+  if (self->GetColoring())
+  {
+    vtkFloatArray *newScalars = vtkFloatArray::New();
+    newScalars->SetName("Edge Types");
+    newScalars->SetNumberOfValues(numLines);
+    std::copy(lineScalars.begin(), lineScalars.end(),
+              newScalars->GetPointer(0));
+    int idx = outCD->AddArray(newScalars);
+    outCD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
+    newScalars->Delete();
+  }
+}
+
 // Construct object with feature angle = 30; all types of edges, except
 // manifold edges, are extracted and colored.
 vtkFeatureEdges::vtkFeatureEdges()
@@ -44,6 +398,7 @@ vtkFeatureEdges::vtkFeatureEdges()
   this->Coloring = 1;
   this->Locator = nullptr;
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->ParallelExtraction = 0;
 }
 
 vtkFeatureEdges::~vtkFeatureEdges()
@@ -156,26 +511,33 @@ int vtkFeatureEdges::RequestData(
     newPolys = inPolys;
     Mesh->SetPolys(newPolys);
   }
-  Mesh->BuildLinks();
-
-  // Allocate storage for lines/points (arbitrary allocation sizes)
-  //
-  newPts = vtkPoints::New();
 
   // Set the desired precision for the points in the output.
-  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+  int pointsType = inPts->GetDataType();
+  if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
   {
-    newPts->SetDataType(inPts->GetDataType());
+    pointsType = VTK_FLOAT;
   }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
   {
-    newPts->SetDataType(VTK_FLOAT);
+    pointsType = VTK_DOUBLE;
   }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+
+  if ( this->ParallelExtraction )
   {
-    newPts->SetDataType(VTK_DOUBLE);
+    vtkFeatureEdgesParallelExecute(this, input, inPts, newPolys, ghosts,
+                                   pointsType, output);
+    Mesh->Delete();
+    return 1;
   }
 
+  Mesh->BuildLinks();
+
+  // Allocate storage for lines/points (arbitrary allocation sizes)
+  //
+  newPts = vtkPoints::New();
+  newPts->SetDataType(pointsType);
+
   newPts->Allocate(numPts/10,numPts);
   newLines = vtkCellArray::New();
   newLines->Allocate(numPts/10);
@@ -468,4 +830,6 @@ void vtkFeatureEdges::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "Parallel Extraction: "
+     << (this->ParallelExtraction ? "On\n" : "Off\n");
 }
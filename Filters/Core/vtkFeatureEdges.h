@@ -137,6 +137,22 @@ public:
   vtkGetMacro(OutputPointsPrecision,int);
   //@}
 
+  //@{
+  /**
+   * Turn on/off extracting the edges in parallel (using vtkSMPTools). The
+   * edges of all polygons are sorted so that the copies of each edge are
+   * adjacent, and every edge is classified from its copies instead of from
+   * the cell links. The output has the same lines, in the same order, with
+   * the same attributes, except that the neighbors of an edge are the
+   * polygons that share the edge (not all polygons using both points),
+   * and that points are merged by id: the Locator is not used and
+   * coincident input points are not merged. Off by default.
+   */
+  vtkSetMacro(ParallelExtraction,vtkTypeBool);
+  vtkGetMacro(ParallelExtraction,vtkTypeBool);
+  vtkBooleanMacro(ParallelExtraction,vtkTypeBool);
+  //@}
+
 protected:
   vtkFeatureEdges();
   ~vtkFeatureEdges() override;
@@ -153,6 +169,7 @@ protected:
   vtkTypeBool Coloring;
   int OutputPointsPrecision;
   vtkIncrementalPointLocator *Locator;
+  vtkTypeBool ParallelExtraction;
 private:
   vtkFeatureEdges(const vtkFeatureEdges&) = delete;
   void operator=(const vtkFeatureEdges&) = delete;
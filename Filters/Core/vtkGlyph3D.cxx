@@ -14,18 +14,24 @@
 =========================================================================*/
 #include "vtkGlyph3D.h"
 
+#include "vtkArrayListTemplate.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
+#include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkIntArray.h"
 #include "vtkMath.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTransform.h"
@@ -33,6 +39,477 @@
 #include "vtkUniformGrid.h"
 #include "vtkUnsignedCharArray.h"
 
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+//----------------------------------------------------------------------------
+// A glyph source prepared for copying: its points (after the optional
+// SourceTransform) and a template of each of its four cell arrays.
+struct vtkGlyph3DSourceInfo
+{
+  vtkPolyData* Source;
+  vtkIdType NumberOfPoints;
+  vtkIdType NumberOfCells;
+  std::vector<double> Points;
+  vtkDataArray* Normals;
+  vtkIdType NumberOfCellsPerArray[4];
+  std::vector<vtkIdType> Connectivity[4];
+
+  vtkGlyph3DSourceInfo()
+    : Source(nullptr), NumberOfPoints(0), NumberOfCells(0), Normals(nullptr)
+  {
+    std::fill_n(this->NumberOfCellsPerArray, 4, 0);
+  }
+
+  void Initialize(vtkPolyData* source, vtkTransform* sourceTransform)
+  {
+    this->Source = source;
+    if (!source)
+    {
+      return;
+    }
+    vtkPoints* sourcePts = source->GetPoints();
+    this->NumberOfPoints = sourcePts ? sourcePts->GetNumberOfPoints() : 0;
+    this->NumberOfCells = source->GetNumberOfCells();
+    this->Normals = source->GetPointData()->GetNormals();
+
+    this->Points.resize(3 * this->NumberOfPoints);
+    if (sourceTransform && this->NumberOfPoints > 0)
+    {
+      vtkNew<vtkPoints> transformed;
+      transformed->SetDataTypeToDouble();
+      transformed->Allocate(this->NumberOfPoints);
+      sourceTransform->TransformPoints(sourcePts, transformed);
+      for (vtkIdType i = 0; i < this->NumberOfPoints; ++i)
+      {
+        transformed->GetPoint(i, &this->Points[3 * i]);
+      }
+    }
+    else
+    {
+      for (vtkIdType i = 0; i < this->NumberOfPoints; ++i)
+      {
+        sourcePts->GetPoint(i, &this->Points[3 * i]);
+      }
+    }
+
+    vtkCellArray* cellArrays[4] = {
+      source->GetVerts(), source->GetLines(), source->GetPolys(), source->GetStrips() };
+    for (int a = 0; a < 4; ++a)
+    {
+      if (cellArrays[a])
+      {
+        this->NumberOfCellsPerArray[a] = cellArrays[a]->GetNumberOfCells();
+        const vtkIdType* conn = cellArrays[a]->GetPointer();
+        this->Connectivity[a].assign(
+          conn, conn + cellArrays[a]->GetNumberOfConnectivityEntries());
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Everything computed for one input point before the glyph is copied: the
+// selected source (-1 if the point is not glyphed), the output offsets, the
+// glyph matrix and the values written to the glyph points.
+struct vtkGlyph3DInstance
+{
+  int Source;
+  vtkIdType PointOffset;
+  vtkIdType CellArrayOffset[4];
+  vtkIdType ConnectivityOffset[4];
+  double Matrix[3][4];
+  double Scale;
+  double VectorMagnitude;
+  double Vector[3];
+};
+
+//----------------------------------------------------------------------------
+// Builds Translate(x) * RotateWXYZ(180, axis) * Scale(scale), the matrix
+// vtkGlyph3D has always applied to the source points.
+void vtkGlyph3DBuildMatrix(const double x[3], const double* axis,
+                           const double scale[3], double m[3][4])
+{
+  double r[3][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+  if (axis)
+  {
+    double n[3] = { axis[0], axis[1], axis[2] };
+    vtkMath::Normalize(n);
+    for (int i = 0; i < 3; ++i)
+    {
+      for (int j = 0; j < 3; ++j)
+      {
+        r[i][j] = 2.0 * n[i] * n[j] - (i == j ? 1.0 : 0.0);
+      }
+    }
+  }
+  for (int i = 0; i < 3; ++i)
+  {
+    for (int j = 0; j < 3; ++j)
+    {
+      m[i][j] = r[i][j] * scale[j];
+    }
+    m[i][3] = x[i];
+  }
+}
+
+//----------------------------------------------------------------------------
+// The preallocated output the glyphs are copied to.
+struct vtkGlyph3DOutput
+{
+  const std::vector<vtkGlyph3DInstance>* Instances;
+  const std::vector<vtkGlyph3DSourceInfo>* Sources;
+  float* Normals;
+  float* Vectors;
+  vtkDataArray* SourceTCoords;
+  float* TCoords;
+  vtkDataArray* Scalars;
+  vtkDataArray* ColorScalars;
+  int ScalarsMode; // 0: none, 1: scale, 2: copy color scalars, 3: vector magnitude
+  vtkIdType* PointIds;
+  vtkIdType* Connectivity[4];
+  vtkIdType CellArrayBase[4]; // id of the first cell of each cell array
+  ArrayList* PointArrays; // input point data to output point data
+  ArrayList* CellArrays; // input point data to output cell data
+};
+
+//----------------------------------------------------------------------------
+// Copies the glyphs of a range of input points into the preallocated output.
+// Every glyph writes to its own precomputed range of points and cells, so
+// the input points can be processed in parallel.
+template <typename TP>
+struct vtkGlyph3DCopyGlyphs
+{
+  const vtkGlyph3DOutput& Output;
+  TP* Points;
+
+  vtkGlyph3DCopyGlyphs(const vtkGlyph3DOutput& output, TP* points)
+    : Output(output), Points(points)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType inPtId = begin; inPtId < end; ++inPtId)
+    {
+      const vtkGlyph3DOutput& out = this->Output;
+      const vtkGlyph3DInstance& glyph = (*out.Instances)[inPtId];
+      if (glyph.Source < 0)
+      {
+        continue;
+      }
+      const vtkGlyph3DSourceInfo& source = (*out.Sources)[glyph.Source];
+      const vtkIdType numPts = source.NumberOfPoints;
+      const vtkIdType ptOffset = glyph.PointOffset;
+      const double (*m)[4] = glyph.Matrix;
+
+      // transform the source points
+      const double* x = source.Points.data();
+      TP* p = this->Points + 3 * ptOffset;
+      for (vtkIdType i = 0; i < numPts; ++i, x += 3, p += 3)
+      {
+        p[0] = static_cast<TP>(m[0][0]*x[0] + m[0][1]*x[1] + m[0][2]*x[2] + m[0][3]);
+        p[1] = static_cast<TP>(m[1][0]*x[0] + m[1][1]*x[1] + m[1][2]*x[2] + m[1][3]);
+        p[2] = static_cast<TP>(m[2][0]*x[0] + m[2][1]*x[1] + m[2][2]*x[2] + m[2][3]);
+      }
+
+      // normals are transformed by the inverse transpose of the matrix
+      if (out.Normals && source.Normals)
+      {
+        double a[3][3], inv[3][3], nm[3][3];
+        for (int i = 0; i < 3; ++i)
+        {
+          a[i][0] = m[i][0];
+          a[i][1] = m[i][1];
+          a[i][2] = m[i][2];
+        }
+        vtkMath::Invert3x3(a, inv);
+        vtkMath::Transpose3x3(inv, nm);
+        float* n = out.Normals + 3 * ptOffset;
+        for (vtkIdType i = 0; i < numPts; ++i, n += 3)
+        {
+          double sn[3], tn[3];
+          source.Normals->GetTuple(i, sn);
+          vtkMath::Multiply3x3(nm, sn, tn);
+          vtkMath::Normalize(tn);
+          n[0] = static_cast<float>(tn[0]);
+          n[1] = static_cast<float>(tn[1]);
+          n[2] = static_cast<float>(tn[2]);
+        }
+      }
+
+      if (out.Vectors)
+      {
+        float* v = out.Vectors + 3 * ptOffset;
+        for (vtkIdType i = 0; i < numPts; ++i, v += 3)
+        {
+          v[0] = static_cast<float>(glyph.Vector[0]);
+          v[1] = static_cast<float>(glyph.Vector[1]);
+          v[2] = static_cast<float>(glyph.Vector[2]);
+        }
+      }
+
+      if (out.TCoords)
+      {
+        const int numComps = out.SourceTCoords->GetNumberOfComponents();
+        double tc[3];
+        float* t = out.TCoords + numComps * ptOffset;
+        for (vtkIdType i = 0; i < numPts; ++i)
+        {
+          out.SourceTCoords->GetTuple(i, tc);
+          for (int c = 0; c < numComps; ++c)
+          {
+            *t++ = static_cast<float>(tc[c]);
+          }
+        }
+      }
+
+      for (vtkIdType i = 0; i < numPts; ++i)
+      {
+        switch (out.ScalarsMode)
+        {
+          case 1:
+            out.Scalars->SetTuple1(ptOffset + i, glyph.Scale);
+            break;
+          case 2:
+            out.Scalars->SetTuple(ptOffset + i, inPtId, out.ColorScalars);
+            break;
+          case 3:
+            out.Scalars->SetTuple1(ptOffset + i, glyph.VectorMagnitude);
+            break;
+        }
+      }
+
+      // copy the point data of the input point
+      if (out.PointArrays)
+      {
+        for (vtkIdType i = 0; i < numPts; ++i)
+        {
+          out.PointArrays->Copy(inPtId, ptOffset + i);
+        }
+      }
+      for (int a = 0; out.CellArrays && a < 4; ++a)
+      {
+        const vtkIdType cellOffset = out.CellArrayBase[a] + glyph.CellArrayOffset[a];
+        for (vtkIdType i = 0; i < source.NumberOfCellsPerArray[a]; ++i)
+        {
+          out.CellArrays->Copy(inPtId, cellOffset + i);
+        }
+      }
+
+      if (out.PointIds)
+      {
+        std::fill_n(out.PointIds + ptOffset, numPts, inPtId);
+      }
+
+      // copy the topology, shifted to the points of this glyph
+      for (int a = 0; a < 4; ++a)
+      {
+        const std::vector<vtkIdType>& conn = source.Connectivity[a];
+        vtkIdType* conns = out.Connectivity[a] + glyph.ConnectivityOffset[a];
+        for (std::vector<vtkIdType>::const_iterator it = conn.begin();
+             it != conn.end(); )
+        {
+          vtkIdType npts = *it++;
+          *conns++ = npts;
+          for (vtkIdType i = 0; i < npts; ++i)
+          {
+            *conns++ = *it++ + ptOffset;
+          }
+        }
+      }
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Copies the glyphs of all the input points, in parallel by batches of input
+// points, reporting progress and checking for abort between batches.
+template <typename TP>
+void vtkGlyph3DCopyAllGlyphs(vtkGlyph3D* self, const vtkGlyph3DOutput& output,
+  TP* points, vtkIdType numPts)
+{
+  vtkGlyph3DCopyGlyphs<TP> copy(output, points);
+  const vtkIdType batchSize = std::max(numPts / 10, static_cast<vtkIdType>(10000));
+  for (vtkIdType begin = 0; begin < numPts && !self->GetAbortExecute(); begin += batchSize)
+  {
+    const vtkIdType end = std::min(begin + batchSize, numPts);
+    vtkSMPTools::For(begin, end, copy);
+    self->UpdateProgress(0.5 + 0.5 * end / numPts);
+  }
+}
+
+//----------------------------------------------------------------------------
+// Serially copies the input point data of the glyphs to their output points
+// (and cells, if outputCD is not null), for arrays an ArrayList cannot copy.
+void vtkGlyph3DCopyData(const vtkGlyph3DOutput& output, vtkPointData* inputPD,
+  vtkPointData* outputPD, vtkCellData* outputCD)
+{
+  const std::vector<vtkGlyph3DInstance>& instances = *output.Instances;
+  for (vtkIdType inPtId = 0; inPtId < static_cast<vtkIdType>(instances.size()); ++inPtId)
+  {
+    const vtkGlyph3DInstance& glyph = instances[inPtId];
+    if (glyph.Source < 0)
+    {
+      continue;
+    }
+    const vtkGlyph3DSourceInfo& source = (*output.Sources)[glyph.Source];
+    for (vtkIdType i = 0; outputPD && i < source.NumberOfPoints; ++i)
+    {
+      outputPD->CopyData(inputPD, inPtId, glyph.PointOffset + i);
+    }
+    for (int a = 0; outputCD && a < 4; ++a)
+    {
+      const vtkIdType cellOffset = output.CellArrayBase[a] + glyph.CellArrayOffset[a];
+      for (vtkIdType i = 0; i < source.NumberOfCellsPerArray[a]; ++i)
+      {
+        outputCD->CopyData(inputPD, inPtId, cellOffset + i);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+// Produce one vertex per glyph carrying the glyph transform instead of the
+// expanded glyph geometry.
+void vtkGlyph3DGenerateInstanceTable(vtkGlyph3D* self,
+  const std::vector<vtkGlyph3DInstance>& instances, vtkIdType numGlyphs,
+  vtkPointData* pd, vtkDataArray* inCScalars, vtkDataArray* inSScalars,
+  bool haveVectors, vtkPolyData* output)
+{
+  vtkPointData* outputPD = output->GetPointData();
+  if (pd)
+  {
+    outputPD->CopyAllocate(pd, numGlyphs);
+  }
+
+  vtkNew<vtkPoints> newPts;
+  if(self->GetOutputPointsPrecision() == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_DOUBLE);
+  }
+  newPts->SetNumberOfPoints(numGlyphs);
+
+  vtkNew<vtkDoubleArray> transforms;
+  transforms->SetName("GlyphTransform");
+  transforms->SetNumberOfComponents(16);
+  transforms->SetNumberOfTuples(numGlyphs);
+
+  vtkNew<vtkIntArray> sourceIndices;
+  sourceIndices->SetName("GlyphSourceIndex");
+  sourceIndices->SetNumberOfTuples(numGlyphs);
+
+  vtkSmartPointer<vtkIdTypeArray> pointIds;
+  if ( self->GetGeneratePointIds() )
+  {
+    pointIds = vtkSmartPointer<vtkIdTypeArray>::New();
+    pointIds->SetName(self->GetPointIdsName());
+    pointIds->SetNumberOfTuples(numGlyphs);
+  }
+
+  vtkSmartPointer<vtkDataArray> newScalars;
+  if ( self->GetColorMode() == VTK_COLOR_BY_SCALAR && inCScalars )
+  {
+    newScalars.TakeReference(inCScalars->NewInstance());
+    newScalars->SetNumberOfComponents(inCScalars->GetNumberOfComponents());
+    newScalars->SetName(inCScalars->GetName());
+  }
+  else if ( (self->GetColorMode() == VTK_COLOR_BY_SCALE) && inSScalars)
+  {
+    newScalars = vtkSmartPointer<vtkFloatArray>::New();
+    newScalars->SetName(self->GetScaleMode() == VTK_SCALE_BY_SCALAR ?
+      inSScalars->GetName() : "GlyphScale");
+  }
+  else if ( (self->GetColorMode() == VTK_COLOR_BY_VECTOR) && haveVectors)
+  {
+    newScalars = vtkSmartPointer<vtkFloatArray>::New();
+    newScalars->SetName("VectorMagnitude");
+  }
+  if (newScalars)
+  {
+    newScalars->SetNumberOfTuples(numGlyphs);
+  }
+  vtkSmartPointer<vtkFloatArray> newVectors;
+  if ( haveVectors )
+  {
+    newVectors = vtkSmartPointer<vtkFloatArray>::New();
+    newVectors->SetNumberOfComponents(3);
+    newVectors->SetNumberOfTuples(numGlyphs);
+    newVectors->SetName("GlyphVector");
+  }
+
+  vtkNew<vtkCellArray> verts;
+  vtkIdType* conn = verts->WritePointer(numGlyphs, 2*numGlyphs);
+
+  vtkIdType glyphId = 0;
+  for (vtkIdType inPtId = 0; inPtId < static_cast<vtkIdType>(instances.size()); ++inPtId)
+  {
+    const vtkGlyph3DInstance& glyph = instances[inPtId];
+    if (glyph.Source < 0)
+    {
+      continue;
+    }
+    double m[16] = {
+      glyph.Matrix[0][0], glyph.Matrix[0][1], glyph.Matrix[0][2], glyph.Matrix[0][3],
+      glyph.Matrix[1][0], glyph.Matrix[1][1], glyph.Matrix[1][2], glyph.Matrix[1][3],
+      glyph.Matrix[2][0], glyph.Matrix[2][1], glyph.Matrix[2][2], glyph.Matrix[2][3],
+      0.0, 0.0, 0.0, 1.0 };
+    transforms->SetTypedTuple(glyphId, m);
+    sourceIndices->SetValue(glyphId, glyph.Source);
+    newPts->SetPoint(glyphId,
+      glyph.Matrix[0][3], glyph.Matrix[1][3], glyph.Matrix[2][3]);
+    if (pd)
+    {
+      outputPD->CopyData(pd, inPtId, glyphId);
+    }
+    if (pointIds)
+    {
+      pointIds->SetValue(glyphId, inPtId);
+    }
+    if (newScalars)
+    {
+      if (self->GetColorMode() == VTK_COLOR_BY_SCALAR)
+      {
+        newScalars->SetTuple(glyphId, inPtId, inCScalars);
+      }
+      else
+      {
+        newScalars->SetTuple1(glyphId, self->GetColorMode() == VTK_COLOR_BY_SCALE ?
+          glyph.Scale : glyph.VectorMagnitude);
+      }
+    }
+    if (newVectors)
+    {
+      newVectors->SetTuple(glyphId, glyph.Vector);
+    }
+    *conn++ = 1;
+    *conn++ = glyphId;
+    glyphId++;
+  }
+
+  output->SetPoints(newPts);
+  output->SetVerts(verts);
+  outputPD->AddArray(transforms);
+  outputPD->AddArray(sourceIndices);
+  if (pointIds)
+  {
+    outputPD->AddArray(pointIds);
+  }
+  if (newScalars)
+  {
+    int idx = outputPD->AddArray(newScalars);
+    outputPD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
+  }
+  if (newVectors)
+  {
+    outputPD->SetVectors(newVectors);
+  }
+}
+
+} // end anonymous namespace
+
 vtkStandardNewMacro(vtkGlyph3D);
 vtkCxxSetObjectMacro(vtkGlyph3D, SourceTransform, vtkTransform);
 
@@ -58,6 +535,7 @@ vtkGlyph3D::vtkGlyph3D()
   this->SetPointIdsName("InputPointIds");
   this->SetNumberOfInputPorts(2);
   this->FillCellData = 0;
+  this->GenerateInstanceTable = 0;
   this->SourceTransform = nullptr;
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
 
@@ -140,23 +618,15 @@ bool vtkGlyph3D::Execute(
   vtkPointData *pd;
   vtkDataArray *inCScalars; // Scalars for Coloring
   unsigned char* inGhostLevels=nullptr;
-  vtkDataArray *inNormals, *sourceNormals = nullptr;
+  vtkDataArray *inNormals;
   vtkDataArray *sourceTCoords = nullptr;
-  vtkIdType numPts, numSourcePts, numSourceCells, inPtId, i;
-  vtkPoints *sourcePts = nullptr;
-  vtkSmartPointer<vtkPoints> transformedSourcePts = vtkSmartPointer<vtkPoints>::New();
+  vtkIdType numPts, inPtId, i;
   vtkPoints *newPts;
   vtkDataArray *newScalars=nullptr;
   vtkDataArray *newVectors=nullptr;
   vtkDataArray *newNormals=nullptr;
   vtkDataArray *newTCoords = nullptr;
-  double x[3], v[3], vNew[3], s = 0.0, vMag = 0.0, value, tc[3];
-  vtkTransform *trans = vtkTransform::New();
-  vtkNew<vtkIdList> pointIdList;
-  vtkIdList *cellPts;
-  int npts;
-  vtkIdList *pts;
-  vtkIdType ptIncr, cellIncr, cellId;
+  double x[3], v[3], vNew[3], s = 0.0, vMag = 0.0, value;
   int haveVectors, haveNormals, haveTCoords = 0;
   double scalex,scaley,scalez, den;
   vtkPointData* outputPD = output->GetPointData();
@@ -164,16 +634,9 @@ bool vtkGlyph3D::Execute(
   int numberOfSources = this->GetNumberOfInputConnections(1);
   vtkIdTypeArray *pointIds=nullptr;
   vtkSmartPointer<vtkPolyData> source = this->GetSource(0, sourceVector);
-  vtkNew<vtkIdList> srcPointIdList;
-  vtkNew<vtkIdList> dstPointIdList;
-  vtkNew<vtkIdList> srcCellIdList;
-  vtkNew<vtkIdList> dstCellIdList;
 
   vtkDebugMacro(<<"Generating glyphs");
 
-  pts = vtkIdList::New();
-  pts->Allocate(VTK_CELL_SIZE);
-
   pd = input->GetPointData();
   inNormals = this->GetInputArrayToProcess(2, input);
   inCScalars = this->GetInputArrayToProcess(3, input);
@@ -202,8 +665,6 @@ bool vtkGlyph3D::Execute(
   if (numPts < 1)
   {
     vtkDebugMacro(<<"No points to glyph!");
-    pts->Delete();
-    trans->Delete();
     return 1;
   }
 
@@ -232,8 +693,6 @@ bool vtkGlyph3D::Execute(
     if ( source == nullptr )
     {
       vtkErrorMacro(<<"Indexing on but don't have data to index with");
-      pts->Delete();
-      trans->Delete();
       return true;
     }
     else
@@ -243,6 +702,17 @@ bool vtkGlyph3D::Execute(
     }
   }
 
+  vtkDataArray *array3D = nullptr;
+  if ( haveVectors )
+  {
+    array3D = this->VectorMode == VTK_USE_NORMAL? inNormals : inVectors;
+    if(array3D->GetNumberOfComponents()>3)
+    {
+      vtkErrorMacro(<<"vtkDataArray "<<array3D->GetName()<<" has more than 3 components.\n");
+      return false;
+    }
+  }
+
   // Allocate storage for output PolyData
   //
   outputPD->CopyVectorsOff();
@@ -265,45 +735,28 @@ bool vtkGlyph3D::Execute(
     source = defaultSource;
   }
 
+  // Prepare the glyph sources: their (transformed) points and topology are
+  // extracted once instead of once per glyph.
+  std::vector<vtkGlyph3DSourceInfo> sources;
   if ( this->IndexMode != VTK_INDEXING_OFF )
   {
     pd = nullptr;
     haveNormals = 1;
-    for (numSourcePts=numSourceCells=i=0; i < numberOfSources; i++)
+    sources.resize(numberOfSources);
+    for (i=0; i < numberOfSources; i++)
     {
-      source = this->GetSource(i, sourceVector);
-      if ( source != nullptr )
+      sources[i].Initialize(this->GetSource(i, sourceVector), this->SourceTransform);
+      if ( sources[i].Source != nullptr && !sources[i].Normals )
       {
-        if (source->GetNumberOfPoints() > numSourcePts)
-        {
-          numSourcePts = source->GetNumberOfPoints();
-        }
-        if (source->GetNumberOfCells() > numSourceCells)
-        {
-          numSourceCells = source->GetNumberOfCells();
-        }
-        if ( !(sourceNormals = source->GetPointData()->GetNormals()) )
-        {
-          haveNormals = 0;
-        }
+        haveNormals = 0;
       }
     }
   }
   else
   {
-    sourcePts = source->GetPoints();
-    numSourcePts = sourcePts->GetNumberOfPoints();
-    numSourceCells = source->GetNumberOfCells();
-
-    sourceNormals = source->GetPointData()->GetNormals();
-    if ( sourceNormals )
-    {
-      haveNormals = 1;
-    }
-    else
-    {
-      haveNormals = 0;
-    }
+    sources.resize(1);
+    sources[0].Initialize(source, this->SourceTransform);
+    haveNormals = sources[0].Normals ? 1 : 0;
 
     sourceTCoords = source->GetPointData()->GetTCoords();
     if (sourceTCoords)
@@ -314,117 +767,26 @@ bool vtkGlyph3D::Execute(
     {
       haveTCoords = 0;
     }
-
-    // Prepare to copy output.
-    pd = input->GetPointData();
-    outputPD->CopyAllocate(pd,numPts*numSourcePts);
-    if (this->FillCellData)
-    {
-      outputCD->CopyAllocate(pd,numPts*numSourceCells);
-    }
-  }
-
-  srcPointIdList->SetNumberOfIds(numSourcePts);
-  dstPointIdList->SetNumberOfIds(numSourcePts);
-  srcCellIdList->SetNumberOfIds(numSourceCells);
-  dstCellIdList->SetNumberOfIds(numSourceCells);
-
-  newPts = vtkPoints::New();
-
-  // Set the desired precision for the points in the output.
-  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
-  {
-    newPts->SetDataType(VTK_FLOAT);
-  }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
-  {
-    newPts->SetDataType(VTK_FLOAT);
-  }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
-  {
-    newPts->SetDataType(VTK_DOUBLE);
   }
 
-  newPts->Allocate(numPts*numSourcePts);
-  if ( this->GeneratePointIds )
-  {
-    pointIds = vtkIdTypeArray::New();
-    pointIds->SetName(this->PointIdsName);
-    pointIds->Allocate(numPts*numSourcePts);
-    outputPD->AddArray(pointIds);
-    pointIds->Delete();
-  }
-  if ( this->ColorMode == VTK_COLOR_BY_SCALAR && inCScalars )
-  {
-    newScalars = inCScalars->NewInstance();
-    newScalars->SetNumberOfComponents(inCScalars->GetNumberOfComponents());
-    newScalars->Allocate(inCScalars->GetNumberOfComponents()*numPts*numSourcePts);
-    newScalars->SetName(inCScalars->GetName());
-  }
-  else if ( (this->ColorMode == VTK_COLOR_BY_SCALE) && inSScalars)
-  {
-    newScalars = vtkFloatArray::New();
-    newScalars->Allocate(numPts*numSourcePts);
-    newScalars->SetName("GlyphScale");
-    if (this->ScaleMode == VTK_SCALE_BY_SCALAR)
-    {
-      newScalars->SetName(inSScalars->GetName());
-    }
-  }
-  else if ( (this->ColorMode == VTK_COLOR_BY_VECTOR) && haveVectors)
-  {
-    newScalars = vtkFloatArray::New();
-    newScalars->Allocate(numPts*numSourcePts);
-    newScalars->SetName("VectorMagnitude");
-  }
-  if ( haveVectors )
-  {
-    newVectors = vtkFloatArray::New();
-    newVectors->SetNumberOfComponents(3);
-    newVectors->Allocate(3*numPts*numSourcePts);
-    newVectors->SetName("GlyphVector");
-  }
-  if ( haveNormals )
-  {
-    newNormals = vtkFloatArray::New();
-    newNormals->SetNumberOfComponents(3);
-    newNormals->Allocate(3*numPts*numSourcePts);
-    newNormals->SetName("Normals");
-  }
-  if (haveTCoords)
-  {
-    newTCoords = vtkFloatArray::New();
-    int numComps = sourceTCoords->GetNumberOfComponents();
-    newTCoords->SetNumberOfComponents(numComps);
-    newTCoords->Allocate(numComps*numPts*numSourcePts);
-    newTCoords->SetName("TCoords");
-  }
-
-  // Setting up for calls to PolyData::InsertNextCell()
-  if (this->IndexMode != VTK_INDEXING_OFF )
-  {
-    output->Allocate(3*numPts*numSourceCells,numPts*numSourceCells);
-  }
-  else
-  {
-    output->Allocate(source,
-                     3*numPts*numSourceCells, numPts*numSourceCells);
-  }
-
-  transformedSourcePts->SetDataTypeToDouble();
-  transformedSourcePts->Allocate(numSourcePts);
-
-  // Traverse all Input points, transforming Source points and copying
-  // point attributes.
+  // Traverse all Input points, selecting the glyph, computing its matrix and
+  // the offsets of its points and cells in the output.
   //
-  ptIncr=0;
-  cellIncr=0;
+  vtkGlyph3DInstance notGlyphed = vtkGlyph3DInstance();
+  notGlyphed.Source = -1;
+  std::vector<vtkGlyph3DInstance> instances(numPts, notGlyphed);
+  vtkIdType numNewPts = 0, numNewCells = 0;
+  vtkIdType numNewCellsPerArray[4] = { 0, 0, 0, 0 };
+  vtkIdType connectivitySize[4] = { 0, 0, 0, 0 };
+  vtkIdType numGlyphs = 0;
   for (inPtId=0; inPtId < numPts; inPtId++)
   {
+    vtkGlyph3DInstance& glyph = instances[inPtId];
+
     scalex = scaley = scalez = 1.0;
     if ( ! (inPtId % 10000) )
     {
-      this->UpdateProgress(static_cast<double>(inPtId)/numPts);
+      this->UpdateProgress(0.5*inPtId/numPts);
       if (this->GetAbortExecute())
       {
         break;
@@ -444,23 +806,6 @@ bool vtkGlyph3D::Execute(
 
     if ( haveVectors )
     {
-      vtkDataArray *array3D = this->VectorMode == VTK_USE_NORMAL? inNormals : inVectors;
-      if(array3D->GetNumberOfComponents()>3)
-      {
-        vtkErrorMacro(<<"vtkDataArray "<<array3D->GetName()<<" has more than 3 components.\n");
-        pts->Delete();
-        trans->Delete();
-        if(newPts)
-        {
-          newPts->Delete();
-        }
-        if(newVectors)
-        {
-          newVectors->Delete();
-        }
-        return false;
-      }
-
       v[0] = 0;
       v[1] = 0;
       v[2] = 0;
@@ -493,6 +838,7 @@ bool vtkGlyph3D::Execute(
     }
 
     // Compute index into table of glyphs
+    int index = 0;
     if ( this->IndexMode != VTK_INDEXING_OFF )
     {
       if ( this->IndexMode == VTK_INDEXING_BY_SCALAR )
@@ -504,22 +850,13 @@ bool vtkGlyph3D::Execute(
         value = vMag;
       }
 
-      int index = static_cast<int>((value - this->Range[0])*numberOfSources / den);
+      index = static_cast<int>((value - this->Range[0])*numberOfSources / den);
       index = (index < 0 ? 0 :
               (index >= numberOfSources ? (numberOfSources-1) : index));
-
-      source = this->GetSource(index, sourceVector);
-      if ( source != nullptr )
-      {
-        sourcePts = source->GetPoints();
-        sourceNormals = source->GetPointData()->GetNormals();
-        numSourcePts = sourcePts->GetNumberOfPoints();
-        numSourceCells = source->GetNumberOfCells();
-      }
     }
 
     // Make sure we're not indexing into empty glyph
-    if ( source == nullptr )
+    if ( sources[index].Source == nullptr )
     {
       continue;
     }
@@ -545,33 +882,32 @@ bool vtkGlyph3D::Execute(
       continue;
     }
 
-    // Now begin copying/transforming glyph
-    trans->Identity();
-
-    // Copy all topology (transformation independent)
-    for (cellId=0; cellId < numSourceCells; cellId++)
+    glyph.Source = index;
+    glyph.PointOffset = numNewPts;
+    for (int a = 0; a < 4; ++a)
     {
-      source->GetCellPoints(cellId, pointIdList);
-      cellPts = pointIdList;
-      npts = cellPts->GetNumberOfIds();
-      for (pts->Reset(), i=0; i < npts; i++)
-      {
-        pts->InsertId(i, cellPts->GetId(i) + ptIncr);
-      }
-      output->InsertNextCell(source->GetCellType(cellId), pts);
+      glyph.CellArrayOffset[a] = numNewCellsPerArray[a];
+      glyph.ConnectivityOffset[a] = connectivitySize[a];
+      numNewCellsPerArray[a] += sources[index].NumberOfCellsPerArray[a];
+      connectivitySize[a] +=
+        static_cast<vtkIdType>(sources[index].Connectivity[a].size());
     }
+    numNewPts += sources[index].NumberOfPoints;
+    numNewCells += sources[index].NumberOfCells;
+    numGlyphs++;
+
+    // the scalar value used to color by scale
+    glyph.Scale = scalex;
+    glyph.VectorMagnitude = vMag;
 
     // translate Source to Input point
     input->GetPoint(inPtId, x);
-    trans->Translate(x[0], x[1], x[2]);
-
+    const double* rotation = nullptr;
     if ( haveVectors )
     {
-      // Copy Input vector
-      for (i=0; i < numSourcePts; i++)
-      {
-        newVectors->InsertTuple(i+ptIncr, v);
-      }
+      glyph.Vector[0] = v[0];
+      glyph.Vector[1] = v[1];
+      glyph.Vector[2] = v[2];
       if (this->Orient && (vMag > 0.0))
       {
         // if there is no y or z component
@@ -579,7 +915,10 @@ bool vtkGlyph3D::Execute(
         {
           if (v[0] < 0) //just flip x if we need to
           {
-            trans->RotateWXYZ(180.0,0,1,0);
+            vNew[0] = 0.0;
+            vNew[1] = 1.0;
+            vNew[2] = 0.0;
+            rotation = vNew;
           }
         }
         else
@@ -587,45 +926,13 @@ bool vtkGlyph3D::Execute(
           vNew[0] = (v[0]+vMag) / 2.0;
           vNew[1] = v[1] / 2.0;
           vNew[2] = v[2] / 2.0;
-          trans->RotateWXYZ(180.0,vNew[0],vNew[1],vNew[2]);
+          rotation = vNew;
         }
       }
     }
 
-    if (haveTCoords)
-    {
-      for (i = 0; i < numSourcePts; i++)
-      {
-        sourceTCoords->GetTuple(i, tc);
-        newTCoords->InsertTuple(i+ptIncr, tc);
-      }
-    }
-
-    // determine scale factor from scalars if appropriate
-    // Copy scalar value
-    if (inSScalars && (this->ColorMode == VTK_COLOR_BY_SCALE))
-    {
-      for (i=0; i < numSourcePts; i++)
-      {
-        newScalars->InsertTuple(i+ptIncr, &scalex); // = scaley = scalez
-      }
-    }
-    else if (inCScalars && (this->ColorMode == VTK_COLOR_BY_SCALAR))
-    {
-      for (i=0; i < numSourcePts; i++)
-      {
-        outputPD->CopyTuple(inCScalars, newScalars, inPtId, ptIncr+i);
-      }
-    }
-    if (haveVectors && this->ColorMode == VTK_COLOR_BY_VECTOR)
-    {
-      for (i=0; i < numSourcePts; i++)
-      {
-        newScalars->InsertTuple(i+ptIncr, &vMag);
-      }
-    }
-
     // scale data if appropriate
+    double scale[3] = { 1.0, 1.0, 1.0 };
     if ( this->Scaling )
     {
       if ( this->ScaleMode == VTK_DATA_SCALING_OFF )
@@ -639,75 +946,200 @@ bool vtkGlyph3D::Execute(
         scalez *= this->ScaleFactor;
       }
 
-      if ( scalex == 0.0 )
-      {
-        scalex = 1.0e-10;
-      }
-      if ( scaley == 0.0 )
-      {
-        scaley = 1.0e-10;
-      }
-      if ( scalez == 0.0 )
-      {
-        scalez = 1.0e-10;
-      }
-      trans->Scale(scalex,scaley,scalez);
+      scale[0] = ( scalex == 0.0 ? 1.0e-10 : scalex );
+      scale[1] = ( scaley == 0.0 ? 1.0e-10 : scaley );
+      scale[2] = ( scalez == 0.0 ? 1.0e-10 : scalez );
     }
 
-    // multiply points and normals by resulting matrix
-    if (this->SourceTransform)
+    vtkGlyph3DBuildMatrix(x, rotation, scale, glyph.Matrix);
+  }
+
+  if ( this->GenerateInstanceTable )
+  {
+    vtkGlyph3DGenerateInstanceTable(this, instances, numGlyphs, pd, inCScalars,
+      inSScalars, haveVectors != 0, output);
+    return true;
+  }
+
+  // Allocate the output with the exact sizes computed above.
+  if ( pd )
+  {
+    outputPD->CopyAllocate(pd, numNewPts);
+    if (this->FillCellData)
     {
-      transformedSourcePts->Reset();
-      this->SourceTransform->TransformPoints(sourcePts, transformedSourcePts);
-      trans->TransformPoints(transformedSourcePts, newPts);
+      outputCD->CopyAllocate(pd, numNewCells);
     }
-    else
+    // Size the arrays so that the glyphs can be copied in any order.
+    for (i = 0; i < outputPD->GetNumberOfArrays(); ++i)
     {
-      trans->TransformPoints(sourcePts,newPts);
+      outputPD->GetAbstractArray(i)->SetNumberOfTuples(numNewPts);
     }
-
-    if ( haveNormals )
+    for (i = 0; this->FillCellData && i < outputCD->GetNumberOfArrays(); ++i)
     {
-      trans->TransformNormals(sourceNormals,newNormals);
+      outputCD->GetAbstractArray(i)->SetNumberOfTuples(numNewCells);
     }
+  }
+
+  // Attributes are copied by the glyph threads through array lists, built
+  // before any other array is added to the output.
+  ArrayList pointArrays;
+  ArrayList cellArrays;
+  const bool copyPointArrays = pd && ArrayList::CanCopyAll(outputPD);
+  const bool copyCellArrays = pd && this->FillCellData &&
+    ArrayList::CanCopyAll(outputCD);
+  if (copyPointArrays)
+  {
+    pointArrays.AddArrays(numNewPts, pd, outputPD, 0.0, false);
+  }
+  if (copyCellArrays)
+  {
+    cellArrays.AddArrays(numNewCells, pd, outputCD, 0.0, false);
+  }
+
+  newPts = vtkPoints::New();
+
+  // Set the desired precision for the points in the output.
+  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+  {
+    newPts->SetDataType(VTK_FLOAT);
+  }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_FLOAT);
+  }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_DOUBLE);
+  }
 
-    // Copy point data from source (if possible)
-    if ( pd )
+  newPts->SetNumberOfPoints(numNewPts);
+  if ( this->GeneratePointIds )
+  {
+    pointIds = vtkIdTypeArray::New();
+    pointIds->SetName(this->PointIdsName);
+    pointIds->SetNumberOfTuples(numNewPts);
+    outputPD->AddArray(pointIds);
+    pointIds->Delete();
+  }
+
+  vtkGlyph3DOutput glyphOutput;
+  glyphOutput.ScalarsMode = 0;
+  glyphOutput.ColorScalars = inCScalars;
+  if ( this->ColorMode == VTK_COLOR_BY_SCALAR && inCScalars )
+  {
+    newScalars = inCScalars->NewInstance();
+    newScalars->SetNumberOfComponents(inCScalars->GetNumberOfComponents());
+    newScalars->SetNumberOfTuples(numNewPts);
+    newScalars->SetName(inCScalars->GetName());
+    glyphOutput.ScalarsMode = 2;
+  }
+  else if ( (this->ColorMode == VTK_COLOR_BY_SCALE) && inSScalars)
+  {
+    newScalars = vtkFloatArray::New();
+    newScalars->SetNumberOfTuples(numNewPts);
+    newScalars->SetName("GlyphScale");
+    if (this->ScaleMode == VTK_SCALE_BY_SCALAR)
     {
-      for (i = 0; i < numSourcePts; ++i)
-      {
-        srcPointIdList->SetId(i, inPtId);
-        dstPointIdList->SetId(i, ptIncr + i);
-      }
-      outputPD->CopyData(pd, srcPointIdList, dstPointIdList);
-      if (this->FillCellData)
-      {
-        for (i = 0; i < numSourceCells; ++i)
-        {
-          srcCellIdList->SetId(i, inPtId);
-          dstCellIdList->SetId(i, cellIncr + i);
-        }
-        outputCD->CopyData(pd, srcCellIdList, dstCellIdList);
-      }
+      newScalars->SetName(inSScalars->GetName());
     }
+    glyphOutput.ScalarsMode = 1;
+  }
+  else if ( (this->ColorMode == VTK_COLOR_BY_VECTOR) && haveVectors)
+  {
+    newScalars = vtkFloatArray::New();
+    newScalars->SetNumberOfTuples(numNewPts);
+    newScalars->SetName("VectorMagnitude");
+    glyphOutput.ScalarsMode = 3;
+  }
+  if ( haveVectors )
+  {
+    newVectors = vtkFloatArray::New();
+    newVectors->SetNumberOfComponents(3);
+    newVectors->SetNumberOfTuples(numNewPts);
+    newVectors->SetName("GlyphVector");
+  }
+  if ( haveNormals )
+  {
+    newNormals = vtkFloatArray::New();
+    newNormals->SetNumberOfComponents(3);
+    newNormals->SetNumberOfTuples(numNewPts);
+    newNormals->SetName("Normals");
+  }
+  if (haveTCoords)
+  {
+    newTCoords = vtkFloatArray::New();
+    int numComps = sourceTCoords->GetNumberOfComponents();
+    newTCoords->SetNumberOfComponents(numComps);
+    newTCoords->SetNumberOfTuples(numNewPts);
+    newTCoords->SetName("TCoords");
+  }
 
-    // If point ids are to be generated, do it here
-    if ( this->GeneratePointIds )
+  // The cells of each glyph go to the same cell arrays as in the source.
+  vtkSmartPointer<vtkCellArray> newCells[4];
+  for (int a = 0; a < 4; ++a)
+  {
+    glyphOutput.CellArrayBase[a] = a == 0 ? 0 :
+      glyphOutput.CellArrayBase[a - 1] + numNewCellsPerArray[a - 1];
+    glyphOutput.Connectivity[a] = nullptr;
+    if (numNewCellsPerArray[a] > 0)
     {
-      for (i=0; i < numSourcePts; i++)
-      {
-        pointIds->InsertNextValue(inPtId);
-      }
+      newCells[a] = vtkSmartPointer<vtkCellArray>::New();
+      glyphOutput.Connectivity[a] =
+        newCells[a]->WritePointer(numNewCellsPerArray[a], connectivitySize[a]);
     }
+  }
 
-    ptIncr += numSourcePts;
-    cellIncr += numSourceCells;
+  // Copy the glyphs in parallel.
+  glyphOutput.Instances = &instances;
+  glyphOutput.Sources = &sources;
+  glyphOutput.Normals = newNormals ?
+    static_cast<vtkFloatArray*>(newNormals)->GetPointer(0) : nullptr;
+  glyphOutput.Vectors = newVectors ?
+    static_cast<vtkFloatArray*>(newVectors)->GetPointer(0) : nullptr;
+  glyphOutput.SourceTCoords = sourceTCoords;
+  glyphOutput.TCoords = newTCoords ?
+    static_cast<vtkFloatArray*>(newTCoords)->GetPointer(0) : nullptr;
+  glyphOutput.Scalars = newScalars;
+  glyphOutput.PointIds = pointIds ? pointIds->GetPointer(0) : nullptr;
+  glyphOutput.PointArrays = copyPointArrays ? &pointArrays : nullptr;
+  glyphOutput.CellArrays = copyCellArrays ? &cellArrays : nullptr;
+  if (newPts->GetDataType() == VTK_DOUBLE)
+  {
+    vtkGlyph3DCopyAllGlyphs(this, glyphOutput,
+      static_cast<double*>(newPts->GetVoidPointer(0)), numPts);
+  }
+  else
+  {
+    vtkGlyph3DCopyAllGlyphs(this, glyphOutput,
+      static_cast<float*>(newPts->GetVoidPointer(0)), numPts);
+  }
+  if (pd && (!copyPointArrays || (this->FillCellData && !copyCellArrays)) &&
+    !this->GetAbortExecute())
+  {
+    vtkGlyph3DCopyData(glyphOutput, pd, copyPointArrays ? nullptr : outputPD,
+      (this->FillCellData && !copyCellArrays) ? outputCD : nullptr);
   }
 
   // Update ourselves and release memory
   //
   output->SetPoints(newPts);
   newPts->Delete();
+  if (newCells[0])
+  {
+    output->SetVerts(newCells[0]);
+  }
+  if (newCells[1])
+  {
+    output->SetLines(newCells[1]);
+  }
+  if (newCells[2])
+  {
+    output->SetPolys(newCells[2]);
+  }
+  if (newCells[3])
+  {
+    output->SetStrips(newCells[3]);
+  }
 
   if (newScalars)
   {
@@ -735,8 +1167,6 @@ bool vtkGlyph3D::Execute(
   }
 
   output->Squeeze();
-  trans->Delete();
-  pts->Delete();
 
   return true;
 }
@@ -891,6 +1321,8 @@ void vtkGlyph3D::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Fill Cell Data: " << (this->FillCellData ? "On\n" : "Off\n");
+  os << indent << "Generate Instance Table: "
+     << (this->GenerateInstanceTable ? "On\n" : "Off\n");
 
   os << indent << "SourceTransform: ";
   if (this->SourceTransform)
@@ -73,6 +73,11 @@
  * vtkAlgorithm. The first array is scalars, the next vectors, the next
  * normals and finally color scalars.
  *
+ * @warning
+ * The glyphs are copied to the output in parallel using vtkSMPTools. The
+ * placement of each glyph is computed in a first serial pass over the input
+ * points, so the output is identical for any number of threads.
+ *
  * @sa
  * vtkTensorGlyph
 */
@@ -287,6 +292,21 @@ public:
   vtkBooleanMacro(FillCellData,vtkTypeBool);
   //@}
 
+  //@{
+  /**
+   * Enable/disable the generation of an instance table instead of the
+   * glyph geometry. When enabled, the output contains one vertex per glyphed
+   * input point, located at the glyph position, with a 16-component point
+   * array named "GlyphTransform" holding the row-major 4x4 matrix that maps
+   * the (SourceTransform'ed) source onto the glyph, and an int array named
+   * "GlyphSourceIndex" selecting the source. This is useful for renderers
+   * that draw the glyphs with instancing. Off by default.
+   */
+  vtkSetMacro(GenerateInstanceTable,vtkTypeBool);
+  vtkGetMacro(GenerateInstanceTable,vtkTypeBool);
+  vtkBooleanMacro(GenerateInstanceTable,vtkTypeBool);
+  //@}
+
   /**
    * This can be overwritten by subclass to return 0 when a point is
    * blanked. Default implementation is to always return 1;
@@ -356,6 +376,7 @@ protected:
   int IndexMode; // what to use to index into glyph table
   vtkTypeBool GeneratePointIds; // produce input points ids for each output point
   vtkTypeBool FillCellData; // whether to fill output cell data
+  vtkTypeBool GenerateInstanceTable; // output glyph transforms, not geometry
   char *PointIdsName;
   vtkTransform* SourceTransform;
   int OutputPointsPrecision;
@@ -0,0 +1,730 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkParallelContourHelper.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkParallelContourHelper.h"
+
+#include "vtkAlgorithm.h"
+#include "vtkArrayListTemplate.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCellTypes.h"
+#include "vtkContourHelper.h"
+#include "vtkCutter.h"
+#include "vtkDataSet.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMergePoints.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkScalarTree.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+// The contour of a block of consecutive cells: its own points (merged by
+// the block's locator), point data, verts, lines and polys, and the input
+// cell of every output cell.
+struct vtkParallelContourBlock
+{
+  vtkSmartPointer<vtkPoints> Points;
+  vtkSmartPointer<vtkPointData> PointData;
+  vtkSmartPointer<vtkCellArray> Cells[3];
+  std::vector<vtkIdType> Connectivity[3]; // with the merged point ids
+  std::vector<vtkIdType> Sources[3];
+};
+}
+
+class vtkParallelContourHelperInternals
+{
+public:
+  vtkDataSet *Input;
+  vtkDataArray *Scalars;
+  vtkPointData *InPd;
+  vtkCellData *InCd;
+  int PointsType;
+  bool CopyScalars;
+  bool OutputTriangles;
+  double Bounds[6];
+  vtkAlgorithm *Algorithm;
+
+  // Blocks of all the passes, in output order.
+  std::vector<vtkParallelContourBlock> Blocks;
+
+  // Contours a list of cells (or all cells of a dimension, or the cell
+  // batches of a scalar tree) in parallel. Progress is reported in the range
+  // [progressStart, progressEnd] if it is not empty.
+  void Contour(const vtkIdType *cellIds, vtkScalarTree *tree,
+               vtkIdType numCells, vtkIdType minBlockSize, int dimension,
+               int numValues, const double *values,
+               double progressStart = 0.0, double progressEnd = 0.0);
+
+  bool IsAborted() const
+  {
+    return this->Algorithm && this->Algorithm->GetAbortExecute();
+  }
+};
+
+namespace
+{
+class vtkParallelContourFunctor
+{
+public:
+  vtkParallelContourHelperInternals *Helper;
+  const vtkIdType *CellIds; // nullptr for all cells
+  vtkScalarTree *ScalarTree; // if set, cells are taken from its batches
+  vtkIdType NumberOfCells; // or number of batches
+  vtkIdType BlockSize;
+  int Dimension; // only contour cells of this dimension (or all if < 0)
+  int NumberOfValues;
+  const double *Values;
+  vtkParallelContourBlock *Blocks;
+  unsigned char CellTypeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+
+  vtkSMPThreadLocalObject<vtkMergePoints> Locator;
+  // One cell per cell type, so that contouring mixed cells does not
+  // reinstantiate the cell of a vtkGenericCell at every change of type.
+  vtkSMPThreadLocal<std::vector<vtkSmartPointer<vtkGenericCell> > > Cells;
+  vtkSMPThreadLocalObject<vtkIdList> CellPtIds;
+  vtkSMPThreadLocalObject<vtkCellData> NoCellData;
+  vtkSMPThreadLocal<vtkSmartPointer<vtkDataArray> > CellScalars;
+
+  void Initialize()
+  {
+    vtkDataArray *scalars = this->Helper->Scalars;
+    vtkSmartPointer<vtkDataArray> &cellScalars = this->CellScalars.Local();
+    cellScalars.TakeReference(scalars->NewInstance());
+    cellScalars->SetNumberOfComponents(scalars->GetNumberOfComponents());
+    cellScalars->Allocate(VTK_CELL_SIZE * scalars->GetNumberOfComponents());
+    this->Cells.Local().resize(VTK_NUMBER_OF_CELL_TYPES);
+  }
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    vtkParallelContourHelperInternals *helper = this->Helper;
+    vtkDataSet *input = helper->Input;
+    vtkMergePoints *locator = this->Locator.Local();
+    // Cell data is copied once all the blocks are done, so the cells are
+    // contoured without any.
+    vtkCellData *noCellData = this->NoCellData.Local();
+
+    for (vtkIdType blockId = beginBlock; blockId < endBlock; ++blockId)
+    {
+      vtkIdType begin = blockId * this->BlockSize;
+      vtkIdType end = std::min(begin + this->BlockSize, this->NumberOfCells);
+      vtkParallelContourBlock &block = this->Blocks[blockId];
+      block.Points = vtkSmartPointer<vtkPoints>::New();
+      block.Points->SetDataType(helper->PointsType);
+      block.PointData = vtkSmartPointer<vtkPointData>::New();
+      if (!helper->CopyScalars)
+      {
+        block.PointData->CopyScalarsOff();
+      }
+      block.PointData->InterpolateAllocate(helper->InPd, 1024, 1024);
+      for (int i = 0; i < 3; ++i)
+      {
+        block.Cells[i] = vtkSmartPointer<vtkCellArray>::New();
+      }
+
+      // Size the locator for this block's share of the pass.
+      vtkIdType estimatedSize = input->GetNumberOfPoints() * (end - begin) /
+        std::max<vtkIdType>(1, this->NumberOfCells);
+      locator->InitPointInsertion(block.Points, helper->Bounds,
+                                  std::max<vtkIdType>(estimatedSize, 1024));
+      vtkContourHelper contour(locator, block.Cells[0], block.Cells[1],
+                               block.Cells[2], helper->InPd, noCellData,
+                               block.PointData, noCellData, 1024,
+                               helper->OutputTriangles);
+
+      if (this->ScalarTree)
+      {
+        // Here the range is a range of batches of the scalar tree.
+        for (vtkIdType batch = begin; batch < end && !helper->IsAborted();
+             ++batch)
+        {
+          vtkIdType numCells;
+          const vtkIdType *cellIds =
+            this->ScalarTree->GetCellBatch(batch, numCells);
+          for (vtkIdType i = 0; i < numCells; ++i)
+          {
+            this->ContourCell(cellIds[i], block, contour);
+          }
+        }
+      }
+      else
+      {
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+          if ((i - begin) % 1024 == 0 && helper->IsAborted())
+          {
+            break;
+          }
+          this->ContourCell(this->CellIds ? this->CellIds[i] : i, block,
+                            contour);
+        }
+      }
+    }
+  }
+
+  void ContourCell(vtkIdType cellId, vtkParallelContourBlock &block,
+                   vtkContourHelper &contour)
+  {
+    vtkDataSet *input = this->Helper->Input;
+    int cellType = input->GetCellType(cellId);
+    if (cellType >= VTK_NUMBER_OF_CELL_TYPES ||
+        (this->Dimension >= 0 &&
+         this->CellTypeDimensions[cellType] != this->Dimension))
+    {
+      return;
+    }
+
+    vtkIdList *cellPtIds = this->CellPtIds.Local();
+    input->GetCellPoints(cellId, cellPtIds);
+    if (cellPtIds->GetNumberOfIds() < 1)
+    {
+      return;
+    }
+    vtkDataArray *cellScalars = this->CellScalars.Local();
+    cellScalars->SetNumberOfTuples(cellPtIds->GetNumberOfIds());
+    this->Helper->Scalars->GetTuples(cellPtIds, cellScalars);
+
+    // find min and max values in scalar data
+    vtkIdType numCellScalars = cellScalars->GetNumberOfTuples() *
+      cellScalars->GetNumberOfComponents();
+    int numComp = cellScalars->GetNumberOfComponents();
+    double range[2];
+    range[0] = range[1] = cellScalars->GetComponent(0, 0);
+    for (vtkIdType j = 1; j < numCellScalars; ++j)
+    {
+      double s = cellScalars->GetComponent(j / numComp, j % numComp);
+      range[0] = std::min(range[0], s);
+      range[1] = std::max(range[1], s);
+    }
+
+    bool needCell = false;
+    for (int v = 0; v < this->NumberOfValues && !needCell; ++v)
+    {
+      needCell = (this->Values[v] >= range[0] &&
+                  this->Values[v] <= range[1]);
+    }
+    if (!needCell)
+    {
+      return;
+    }
+
+    vtkSmartPointer<vtkGenericCell> &cell = this->Cells.Local()[cellType];
+    if (!cell)
+    {
+      cell = vtkSmartPointer<vtkGenericCell>::New();
+    }
+    input->GetCell(cellId, cell);
+    for (int v = 0; v < this->NumberOfValues; ++v)
+    {
+      if (this->Values[v] >= range[0] && this->Values[v] <= range[1])
+      {
+        vtkIdType numCells[3];
+        for (int k = 0; k < 3; ++k)
+        {
+          numCells[k] = block.Cells[k]->GetNumberOfCells();
+        }
+        contour.Contour(cell, this->Values[v], cellScalars, cellId);
+        for (int k = 0; k < 3; ++k)
+        {
+          block.Sources[k].insert(block.Sources[k].end(),
+            block.Cells[k]->GetNumberOfCells() - numCells[k], cellId);
+        }
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+// Orders the points of all blocks by coordinates, then by global index, so
+// the copies of a point follow the first one.
+struct vtkParallelContourPointLess
+{
+  const double *Coordinates;
+
+  bool operator()(vtkIdType a, vtkIdType b) const
+  {
+    const double *x = this->Coordinates + 3 * a;
+    const double *y = this->Coordinates + 3 * b;
+    for (int i = 0; i < 3; ++i)
+    {
+      if (x[i] != y[i])
+      {
+        return x[i] < y[i];
+      }
+    }
+    return a < b;
+  }
+};
+
+// Writes the block points into one coordinate array.
+struct vtkParallelContourGatherPoints
+{
+  std::vector<vtkParallelContourBlock> *Blocks;
+  const vtkIdType *Offsets;
+  double *Coordinates;
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType blockId = beginBlock; blockId < endBlock; ++blockId)
+    {
+      vtkPoints *points = (*this->Blocks)[blockId].Points;
+      double *x = this->Coordinates + 3 * this->Offsets[blockId];
+      for (vtkIdType i = 0; i < points->GetNumberOfPoints(); ++i, x += 3)
+      {
+        points->GetPoint(i, x);
+      }
+    }
+  }
+};
+
+// Copies the first copy of every point, and its point data, to the output.
+struct vtkParallelContourCopyPoints
+{
+  std::vector<vtkParallelContourBlock> *Blocks;
+  const vtkIdType *Offsets;
+  const vtkIdType *Representatives;
+  const vtkIdType *NewIds;
+  const double *Coordinates;
+  vtkPoints *OutPoints;
+  vtkPointData *OutPd;
+  bool DataArraysOnly;
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    int numArrays = this->OutPd->GetNumberOfArrays();
+    for (vtkIdType blockId = beginBlock; blockId < endBlock; ++blockId)
+    {
+      vtkParallelContourBlock &block = (*this->Blocks)[blockId];
+      vtkIdType offset = this->Offsets[blockId];
+      vtkIdType numPts = block.Points->GetNumberOfPoints();
+      for (vtkIdType i = 0; i < numPts; ++i)
+      {
+        vtkIdType id = offset + i;
+        if (this->Representatives[id] != id)
+        {
+          continue;
+        }
+        if (this->DataArraysOnly)
+        {
+          this->OutPoints->SetPoint(this->NewIds[id],
+                                    this->Coordinates + 3 * id);
+        }
+        for (int a = 0; a < numArrays; ++a)
+        {
+          vtkAbstractArray *outArray = this->OutPd->GetAbstractArray(a);
+          if (outArray->IsA("vtkDataArray") == this->DataArraysOnly)
+          {
+            outArray->SetTuple(this->NewIds[id], i,
+                               block.PointData->GetAbstractArray(a));
+          }
+        }
+      }
+    }
+  }
+};
+
+// Renumbers the points of the cells of every block with the merged point
+// ids. Lines and triangles that become degenerate (points of different
+// blocks merged into one) are dropped, as vtkCell::Contour() drops them.
+struct vtkParallelContourRemapCells
+{
+  std::vector<vtkParallelContourBlock> *Blocks;
+  const vtkIdType *PointOffsets;
+  const vtkIdType *NewIds;
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType blockId = beginBlock; blockId < endBlock; ++blockId)
+    {
+      vtkParallelContourBlock &block = (*this->Blocks)[blockId];
+      const vtkIdType *newIds = this->NewIds + this->PointOffsets[blockId];
+      for (int type = 0; type < 3; ++type)
+      {
+        vtkCellArray *cells = block.Cells[type];
+        std::vector<vtkIdType> &connectivity = block.Connectivity[type];
+        std::vector<vtkIdType> &sources = block.Sources[type];
+        connectivity.reserve(cells->GetNumberOfConnectivityEntries());
+        const vtkIdType *in = cells->GetPointer();
+        vtkIdType numCells = 0;
+        for (size_t cellId = 0; cellId < sources.size(); ++cellId)
+        {
+          vtkIdType npts = *in++;
+          vtkIdType pts[3];
+          for (vtkIdType i = 0; i < npts && i < 3; ++i)
+          {
+            pts[i] = newIds[in[i]];
+          }
+          if ((npts == 2 && pts[0] == pts[1]) ||
+              (npts == 3 && (pts[0] == pts[1] || pts[0] == pts[2] ||
+                             pts[1] == pts[2])))
+          {
+            in += npts;
+            continue;
+          }
+          connectivity.push_back(npts);
+          for (vtkIdType i = 0; i < npts; ++i)
+          {
+            connectivity.push_back(newIds[*in++]);
+          }
+          sources[numCells++] = sources[cellId];
+        }
+        sources.resize(numCells);
+        block.Cells[type] = nullptr;
+      }
+    }
+  }
+};
+
+// Writes the cells of one type (verts, lines or polys) of all the blocks
+// into the output connectivity.
+struct vtkParallelContourCopyCells
+{
+  std::vector<vtkParallelContourBlock> *Blocks;
+  int Type;
+  const vtkIdType *ConnectivityOffsets;
+  const vtkIdType *CellOffsets;
+  vtkIdType *Connectivity;
+  vtkIdType *Sources;
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType blockId = beginBlock; blockId < endBlock; ++blockId)
+    {
+      vtkParallelContourBlock &block = (*this->Blocks)[blockId];
+      std::copy(block.Connectivity[this->Type].begin(),
+                block.Connectivity[this->Type].end(),
+                this->Connectivity + this->ConnectivityOffsets[blockId]);
+      std::copy(block.Sources[this->Type].begin(),
+                block.Sources[this->Type].end(),
+                this->Sources + this->CellOffsets[blockId]);
+    }
+  }
+};
+
+}
+
+//-----------------------------------------------------------------------------
+void vtkParallelContourHelperInternals::Contour(const vtkIdType *cellIds,
+                                                vtkScalarTree *tree,
+                                                vtkIdType numCells,
+                                                vtkIdType minBlockSize,
+                                                int dimension, int numValues,
+                                                const double *values,
+                                                double progressStart,
+                                                double progressEnd)
+{
+  if (numCells < 1 || numValues < 1 || this->IsAborted())
+  {
+    return;
+  }
+
+  // A few blocks per thread balance the load; a single thread gets a
+  // single block, which needs no merging.
+  int numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+  vtkIdType numBlocks = (numThreads > 1 ? 8 * numThreads : 1);
+  numBlocks = std::max<vtkIdType>(1,
+    std::min(numBlocks, numCells / minBlockSize));
+  size_t firstBlock = this->Blocks.size();
+  this->Blocks.resize(firstBlock + numBlocks);
+
+  vtkParallelContourFunctor contour;
+  contour.Helper = this;
+  contour.CellIds = cellIds;
+  contour.ScalarTree = tree;
+  contour.NumberOfCells = numCells;
+  contour.BlockSize = (numCells + numBlocks - 1) / numBlocks;
+  contour.Dimension = dimension;
+  contour.NumberOfValues = numValues;
+  contour.Values = values;
+  contour.Blocks = &this->Blocks[firstBlock];
+  vtkCutter::GetCellTypeDimensions(contour.CellTypeDimensions);
+
+  // The blocks are contoured in rounds of two blocks per thread, so that
+  // progress is reported from this thread. Once aborted, the blocks of the
+  // following rounds are not contoured and dropped from the output.
+  vtkIdType roundSize = 2 * numThreads;
+  for (vtkIdType begin = 0; begin < numBlocks; begin += roundSize)
+  {
+    vtkIdType end = std::min(begin + roundSize, numBlocks);
+    vtkSMPTools::For(begin, end, 1, contour);
+    if (this->IsAborted())
+    {
+      this->Blocks.resize(firstBlock + end);
+      return;
+    }
+    if (this->Algorithm && progressEnd > progressStart)
+    {
+      this->Algorithm->UpdateProgress(progressStart +
+        (progressEnd - progressStart) * end / numBlocks);
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+vtkParallelContourHelper::vtkParallelContourHelper(vtkDataSet *input,
+                                                   vtkDataArray *scalars,
+                                                   vtkPointData *inPd,
+                                                   vtkCellData *inCd,
+                                                   int pointsType,
+                                                   bool copyScalars,
+                                                   bool outputTriangles)
+{
+  this->Internals = new vtkParallelContourHelperInternals;
+  this->Internals->Input = input;
+  this->Internals->Scalars = scalars;
+  this->Internals->InPd = inPd;
+  this->Internals->InCd = inCd;
+  this->Internals->PointsType = pointsType;
+  this->Internals->CopyScalars = copyScalars;
+  this->Internals->OutputTriangles = outputTriangles;
+  this->Internals->Algorithm = nullptr;
+  // Computed here, so the threads only read the (cached) bounds.
+  input->GetBounds(this->Internals->Bounds);
+}
+
+//-----------------------------------------------------------------------------
+vtkParallelContourHelper::~vtkParallelContourHelper()
+{
+  delete this->Internals;
+}
+
+//-----------------------------------------------------------------------------
+void vtkParallelContourHelper::SetAlgorithm(vtkAlgorithm *algorithm)
+{
+  this->Internals->Algorithm = algorithm;
+}
+
+//-----------------------------------------------------------------------------
+void vtkParallelContourHelper::ContourAllCells(int numValues,
+                                               const double *values)
+{
+  vtkDataSet *input = this->Internals->Input;
+  vtkIdType numCells = input->GetNumberOfCells();
+  if (numCells < 1)
+  {
+    return;
+  }
+
+  // One pass for each dimension of cells present, in increasing dimension,
+  // so the output verts, lines and polys follow the input cell order.
+  unsigned char cellTypeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+  vtkCutter::GetCellTypeDimensions(cellTypeDimensions);
+  vtkNew<vtkCellTypes> cellTypes;
+  input->GetCellTypes(cellTypes);
+  bool hasDimension[4] = { false, false, false, false };
+  for (vtkIdType i = 0; i < cellTypes->GetNumberOfTypes(); ++i)
+  {
+    unsigned char cellType = cellTypes->GetCellType(i);
+    if (cellType < VTK_NUMBER_OF_CELL_TYPES)
+    {
+      hasDimension[cellTypeDimensions[cellType]] = true;
+    }
+  }
+  int numPasses = hasDimension[1] + hasDimension[2] + hasDimension[3];
+
+  // We skip 0d cells (points), because they cannot be cut (generate no data).
+  for (int dimension = 1, pass = 0; dimension <= 3; ++dimension)
+  {
+    if (hasDimension[dimension])
+    {
+      this->Internals->Contour(nullptr, nullptr, numCells, 1024, dimension,
+                               numValues, values,
+                               static_cast<double>(pass) / numPasses,
+                               static_cast<double>(pass + 1) / numPasses);
+      ++pass;
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+void vtkParallelContourHelper::ContourCells(const vtkIdType *cellIds,
+                                            vtkIdType numCells, double value)
+{
+  this->Internals->Contour(cellIds, nullptr, numCells, 1024, -1, 1, &value);
+}
+
+//-----------------------------------------------------------------------------
+void vtkParallelContourHelper::ContourCellBatches(vtkScalarTree *tree,
+                                                  double value)
+{
+  tree->InitTraversal(value);
+  vtkIdType numBatches = tree->GetNumberOfCellBatches();
+  if (numBatches < 1)
+  {
+    return;
+  }
+  // The blocks are made of whole batches, of about 1024 cells.
+  vtkIdType batchSize;
+  tree->GetCellBatch(0, batchSize);
+  vtkIdType minBlockSize =
+    std::max<vtkIdType>(1, 1024 / std::max<vtkIdType>(1, batchSize));
+  this->Internals->Contour(nullptr, tree, numBatches, minBlockSize, -1, 1,
+                           &value);
+}
+
+//-----------------------------------------------------------------------------
+void vtkParallelContourHelper::GetOutput(vtkPolyData *output)
+{
+  std::vector<vtkParallelContourBlock> &blocks = this->Internals->Blocks;
+  vtkIdType numBlocks = static_cast<vtkIdType>(blocks.size());
+
+  // Global index of the points of every block.
+  std::vector<vtkIdType> pointOffsets(numBlocks + 1, 0);
+  for (vtkIdType blockId = 0; blockId < numBlocks; ++blockId)
+  {
+    pointOffsets[blockId + 1] = pointOffsets[blockId] +
+      blocks[blockId].Points->GetNumberOfPoints();
+  }
+  vtkIdType numPts = pointOffsets[numBlocks];
+  std::vector<double> coordinates(3 * numPts);
+  vtkParallelContourGatherPoints gather = { &blocks, &pointOffsets[0],
+                                            coordinates.data() };
+  vtkSMPTools::For(0, numBlocks, 1, gather);
+
+  // Points of different blocks with the same coordinates are merged into
+  // the first one. Point ids follow the first copy of each point. A single
+  // block was merged by its own locator already.
+  std::vector<vtkIdType> representatives(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    representatives[i] = i;
+  }
+  if (numBlocks > 1)
+  {
+    std::vector<vtkIdType> order(representatives);
+    vtkParallelContourPointLess less = { coordinates.data() };
+    vtkSMPTools::Sort(order.begin(), order.end(), less);
+    for (vtkIdType i = 0, first = 0; i < numPts; ++i)
+    {
+      if (i > 0 &&
+          !std::equal(&coordinates[3 * order[i - 1]],
+                      &coordinates[3 * order[i - 1]] + 3,
+                      &coordinates[3 * order[i]]))
+      {
+        first = i;
+      }
+      representatives[order[i]] = order[first];
+    }
+  }
+  std::vector<vtkIdType> newIds(numPts);
+  vtkIdType numOutPts = 0;
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    newIds[i] = (representatives[i] == i ? numOutPts++ :
+                 newIds[representatives[i]]);
+  }
+
+  // Points and point data
+  vtkNew<vtkPoints> newPts;
+  newPts->SetDataType(this->Internals->PointsType);
+  newPts->SetNumberOfPoints(numOutPts);
+  vtkPointData *outPd = output->GetPointData();
+  if (!this->Internals->CopyScalars)
+  {
+    outPd->CopyScalarsOff();
+  }
+  outPd->InterpolateAllocate(this->Internals->InPd, numOutPts);
+  for (int a = 0; a < outPd->GetNumberOfArrays(); ++a)
+  {
+    outPd->GetAbstractArray(a)->SetNumberOfTuples(numOutPts);
+  }
+  vtkParallelContourCopyPoints copyPoints;
+  copyPoints.Blocks = &blocks;
+  copyPoints.Offsets = &pointOffsets[0];
+  copyPoints.Representatives = representatives.data();
+  copyPoints.NewIds = newIds.data();
+  copyPoints.Coordinates = coordinates.data();
+  copyPoints.OutPoints = newPts;
+  copyPoints.OutPd = outPd;
+  copyPoints.DataArraysOnly = true;
+  vtkSMPTools::For(0, numBlocks, 1, copyPoints);
+  // Other arrays (e.g. strings) are not thread safe.
+  copyPoints.DataArraysOnly = false;
+  copyPoints(0, numBlocks);
+  output->SetPoints(newPts);
+
+  // Verts, lines and polys, and the input cell of every output cell
+  vtkParallelContourRemapCells remap = { &blocks, &pointOffsets[0],
+                                         newIds.data() };
+  vtkSMPTools::For(0, numBlocks, 1, remap);
+  std::vector<vtkIdType> sources;
+  vtkIdType numOutCells = 0;
+  for (int type = 0; type < 3; ++type)
+  {
+    std::vector<vtkIdType> connectivityOffsets(numBlocks + 1, 0);
+    std::vector<vtkIdType> cellOffsets(numBlocks + 1, numOutCells);
+    for (vtkIdType blockId = 0; blockId < numBlocks; ++blockId)
+    {
+      connectivityOffsets[blockId + 1] = connectivityOffsets[blockId] +
+        static_cast<vtkIdType>(blocks[blockId].Connectivity[type].size());
+      cellOffsets[blockId + 1] = cellOffsets[blockId] +
+        static_cast<vtkIdType>(blocks[blockId].Sources[type].size());
+    }
+    vtkIdType numCells = cellOffsets[numBlocks] - numOutCells;
+    if (numCells == 0)
+    {
+      continue;
+    }
+
+    vtkNew<vtkIdTypeArray> connectivity;
+    connectivity->SetNumberOfValues(connectivityOffsets[numBlocks]);
+    sources.resize(numOutCells + numCells);
+    vtkParallelContourCopyCells copyCells;
+    copyCells.Blocks = &blocks;
+    copyCells.Type = type;
+    copyCells.ConnectivityOffsets = &connectivityOffsets[0];
+    copyCells.CellOffsets = &cellOffsets[0];
+    copyCells.Connectivity = connectivity->GetPointer(0);
+    copyCells.Sources = sources.data();
+    vtkSMPTools::For(0, numBlocks, 1, copyCells);
+
+    vtkNew<vtkCellArray> cells;
+    cells->SetCells(numCells, connectivity);
+    switch (type)
+    {
+      case 0:
+        output->SetVerts(cells);
+        break;
+      case 1:
+        output->SetLines(cells);
+        break;
+      default:
+        output->SetPolys(cells);
+        break;
+    }
+    numOutCells += numCells;
+  }
+  blocks.clear();
+
+  // Cell data
+  vtkCellData *outCd = output->GetCellData();
+  vtkCellData *inCd = this->Internals->InCd;
+  outCd->CopyAllocate(inCd, numOutCells);
+  ArrayList::GatherTuples(inCd, outCd, sources.data(), numOutCells);
+}
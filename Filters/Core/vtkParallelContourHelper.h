@@ -0,0 +1,104 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkParallelContourHelper.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkParallelContourHelper
+ * @brief   A utility class used to contour the cells of a dataset in parallel
+ *
+ *  This is a simple utility class used by vtkContourGrid and vtkCutter to
+ *  contour cells in parallel (using vtkSMPTools) into a single polydata.
+ *  The cells are contoured in blocks of consecutive cells, each block with
+ *  its own vtkMergePoints locator; the points of all the blocks are then
+ *  merged by coordinates and numbered in the order a single locator would
+ *  number them, so the output matches the serial contour.  Lines and
+ *  triangles that become degenerate when merging are dropped.
+ * @sa
+ * vtkContourHelper vtkContourGrid vtkCutter
+*/
+
+#ifndef vtkParallelContourHelper_h
+#define vtkParallelContourHelper_h
+
+#include "vtkFiltersCoreModule.h" // For export macro
+#include "vtkType.h" // For vtkIdType
+
+class vtkAlgorithm;
+class vtkCellData;
+class vtkDataArray;
+class vtkDataSet;
+class vtkPointData;
+class vtkPolyData;
+class vtkScalarTree;
+class vtkParallelContourHelperInternals;
+
+class VTKFILTERSCORE_EXPORT vtkParallelContourHelper
+{
+public:
+  /**
+   * The input point data inPd is interpolated on the output points, except
+   * for the active scalars if copyScalars is false. The output points are
+   * of type pointsType.
+   */
+  vtkParallelContourHelper(vtkDataSet *input,
+                           vtkDataArray *scalars,
+                           vtkPointData *inPd,
+                           vtkCellData *inCd,
+                           int pointsType,
+                           bool copyScalars,
+                           bool outputTriangles);
+  ~vtkParallelContourHelper();
+
+  /**
+   * The algorithm ContourAllCells() reports its progress to, and whose
+   * abort flag stops the contouring (the cells contoured so far are still
+   * output). Progress is reported from the calling thread, between rounds
+   * of blocks of cells.
+   */
+  void SetAlgorithm(vtkAlgorithm *algorithm);
+
+  /**
+   * Contour all the cells for all the values. 1D cells are contoured
+   * first, then 2D cells and then 3D cells; 0D cells are skipped.
+   */
+  void ContourAllCells(int numValues, const double *values);
+
+  /**
+   * Contour the listed cells (e.g. the candidate cells of a scalar tree)
+   * for a single value.
+   */
+  void ContourCells(const vtkIdType *cellIds, vtkIdType numCells,
+                    double value);
+
+  /**
+   * Contour the candidate cells of a scalar tree for a single value. The
+   * batches of cells of the tree are contoured in parallel, directly from
+   * the tree, so a tree built once serves a whole sweep of values.
+   */
+  void ContourCellBatches(vtkScalarTree *tree, double value);
+
+  /**
+   * Merge the contours computed so far into output: points, point data,
+   * verts, lines, polys and cell data.
+   */
+  void GetOutput(vtkPolyData *output);
+
+private:
+  vtkParallelContourHelper(const vtkParallelContourHelper&) = delete;
+  vtkParallelContourHelper& operator=(const vtkParallelContourHelper&) = delete;
+
+  vtkParallelContourHelperInternals *Internals;
+};
+
+#endif
+// VTK-HeaderTest-Exclude: vtkParallelContourHelper.h
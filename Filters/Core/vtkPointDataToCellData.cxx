@@ -19,14 +19,22 @@
 #include <limits>
 #include <vector>
 
+#include "vtkArrayDispatch.h"
 #include "vtkCellData.h"
 #include "vtkDataArray.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkDataSet.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 
 #define VTK_EPSILON 1.e-6
 
@@ -148,6 +156,79 @@ vtkIdType Histogram::IndexOfLargestBin()
   return std::max_element(this->Bins.begin(), it2, BinCountCmp)->Index;
 }
 
+//----------------------------------------------------------------------------
+// Average the point data of each cell with equal weights. Cells are processed
+// independently so they are split across threads; the accumulation order and
+// weights match vtkDataSetAttributes::InterpolatePoint().
+template <typename SrcArrayT, typename DstArrayT>
+struct AverageFunctor
+{
+  vtkDataSet* Input;
+  SrcArrayT* Src;
+  DstArrayT* Dst;
+  int NumComps;
+  vtkSMPThreadLocalObject<vtkIdList> CellPoints;
+  vtkSMPThreadLocal<std::vector<double> > Sums;
+
+  AverageFunctor(vtkDataSet* input, SrcArrayT* src, DstArrayT* dst)
+    : Input(input), Src(src), Dst(dst), NumComps(src->GetNumberOfComponents())
+  {
+  }
+
+  void Initialize()
+  {
+    this->Sums.Local().resize(this->NumComps);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    typedef typename vtkDataArrayAccessor<DstArrayT>::APIType DstValueT;
+    vtkDataArrayAccessor<SrcArrayT> src(this->Src);
+    vtkDataArrayAccessor<DstArrayT> dst(this->Dst);
+    vtkIdList* cellPts = this->CellPoints.Local();
+    std::vector<double>& sums = this->Sums.Local();
+    const int ncomps = this->NumComps;
+
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      this->Input->GetCellPoints(cellId, cellPts);
+      const vtkIdType numPts = cellPts->GetNumberOfIds();
+      const double weight = numPts ? 1.0 / numPts : 0.0;
+      std::fill(sums.begin(), sums.end(), 0.0);
+      for (vtkIdType i = 0; i < numPts; ++i)
+      {
+        const vtkIdType ptId = cellPts->GetId(i);
+        for (int comp = 0; comp < ncomps; ++comp)
+        {
+          sums[comp] += weight * static_cast<double>(src.Get(ptId, comp));
+        }
+      }
+      for (int comp = 0; comp < ncomps; ++comp)
+      {
+        DstValueT value;
+        vtkMath::RoundDoubleToIntegralIfNecessary(sums[comp], &value);
+        dst.Set(cellId, comp, value);
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+struct AverageWorker
+{
+  vtkDataSet* Input;
+
+  template <typename SrcArrayT, typename DstArrayT>
+  void operator()(SrcArrayT* src, DstArrayT* dst)
+  {
+    AverageFunctor<SrcArrayT, DstArrayT> average(this->Input, src, dst);
+    vtkSMPTools::For(0, dst->GetNumberOfTuples(), average);
+  }
+};
+
 }
 
 
@@ -232,6 +313,22 @@ int vtkPointDataToCellData::RequestData(
   output->GetCellData()->PassData(input->GetCellData());
   output->GetCellData()->CopyFieldOff(vtkDataSetAttributes::GhostArrayName());
 
+  // Plain averaging of numeric arrays is done in parallel over the cells.
+  if (!this->CategoricalData && this->AverageInParallel(input, output))
+  {
+    if ( !this->PassPointData )
+    {
+      output->GetPointData()->CopyAllOff();
+      output->GetPointData()->CopyFieldOn(vtkDataSetAttributes::GhostArrayName());
+    }
+    output->GetPointData()->PassData(input->GetPointData());
+
+    cellPts->Delete();
+    delete [] weights;
+
+    return 1;
+  }
+
   // notice that inPD and outCD are vtkPointData and vtkCellData; respectively.
   // It's weird, but it works.
   outCD->InterpolateAllocate(inPD,numCells);
@@ -295,6 +392,59 @@ int vtkPointDataToCellData::RequestData(
   return 1;
 }
 
+//----------------------------------------------------------------------------
+bool vtkPointDataToCellData::AverageInParallel(vtkDataSet* input,
+                                               vtkDataSet* output)
+{
+  vtkPointData* inPD = input->GetPointData();
+  for (int i = 0; i < inPD->GetNumberOfArrays(); ++i)
+  {
+    if (!vtkDataArray::FastDownCast(inPD->GetAbstractArray(i)))
+    {
+      return false;
+    }
+  }
+
+  vtkIdType numCells = input->GetNumberOfCells();
+
+  // Make the cell queries of the input thread safe (e.g. build the cells of
+  // vtkPolyData) before traversing it from several threads.
+  vtkNew<vtkGenericCell> cell;
+  input->GetCell(0, cell);
+
+  vtkCellData* outCD = output->GetCellData();
+  vtkDataSetAttributes::FieldList pfl(1);
+  pfl.InitializeFieldList(inPD);
+  outCD->InterpolateAllocate(pfl, numCells, numCells);
+
+  AverageWorker worker;
+  worker.Input = input;
+  for (int fid = 0, nfields = pfl.GetNumberOfFields(); fid < nfields; ++fid)
+  {
+    this->UpdateProgress((fid+1.)/nfields);
+    if (this->GetAbortExecute())
+    {
+      break;
+    }
+    int const dstid = pfl.GetFieldIndex(fid);
+    int const srcid = pfl.GetDSAIndex(0,fid);
+    if (srcid < 0 || dstid < 0)
+    {
+      continue;
+    }
+    vtkDataArray* const srcarray = inPD->GetArray(srcid);
+    vtkDataArray* const dstarray = outCD->GetArray(dstid);
+    dstarray->SetNumberOfTuples(numCells);
+    if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(
+          srcarray, dstarray, worker))
+    {
+      worker(srcarray, dstarray);
+    }
+  }
+
+  return true;
+}
+
 //----------------------------------------------------------------------------
 void vtkPointDataToCellData::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -38,6 +38,8 @@
 #include "vtkFiltersCoreModule.h" // For export macro
 #include "vtkDataSetAlgorithm.h"
 
+class vtkDataSet;
+
 class VTKFILTERSCORE_EXPORT vtkPointDataToCellData : public vtkDataSetAlgorithm
 {
 public:
@@ -75,6 +77,13 @@ protected:
                   vtkInformationVector** inputVector,
                   vtkInformationVector* outputVector) override;
 
+  /**
+   * Average the point data of the cells in parallel. Returns false when some
+   * point arrays are not numeric, in which case the serial interpolation is
+   * used instead.
+   */
+  bool AverageInParallel(vtkDataSet* input, vtkDataSet* output);
+
   vtkTypeBool PassPointData;
   vtkTypeBool CategoricalData;
 private:
@@ -17,6 +17,7 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
+#include "vtkConnectivityFilterInternals.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
@@ -28,6 +29,7 @@
 #include "vtkPolyData.h"
 
 #include <algorithm> // for fill_n
+#include <vector>
 
 vtkStandardNewMacro(vtkPolyDataConnectivityFilter);
 
@@ -58,6 +60,9 @@ vtkPolyDataConnectivityFilter::vtkPolyDataConnectivityFilter()
   this->VisitedPointIds = vtkIdList::New();
 
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+
+  this->ParallelLabeling = 0;
+  this->RegionIdAssignmentMode = UNSPECIFIED;
 }
 
 vtkPolyDataConnectivityFilter::~vtkPolyDataConnectivityFilter()
@@ -190,29 +195,42 @@ int vtkPolyDataConnectivityFilter::RequestData(
   this->ExtractionMode != VTK_EXTRACT_CELL_SEEDED_REGIONS &&
   this->ExtractionMode != VTK_EXTRACT_CLOSEST_POINT_REGION )
   { //visit all cells marking with region number
-    for (cellId=0; cellId < numCells; cellId++)
+    if ( this->ParallelLabeling )
     {
-      if ( cellId && !(cellId % 5000) )
-      {
-        this->UpdateProgress (0.1 + 0.8*cellId/numCells);
-      }
-
-      if ( this->Visited[cellId] < 0 )
+      this->ParallelLabelRegions();
+    }
+    else
+    {
+      for (cellId=0; cellId < numCells; cellId++)
       {
-        this->NumCellsInRegion = 0;
-        this->Wave.push_back(cellId);
-        this->TraverseAndMark ();
+        if ( cellId && !(cellId % 5000) )
+        {
+          this->UpdateProgress (0.1 + 0.8*cellId/numCells);
+        }
 
-        if ( this->NumCellsInRegion > maxCellsInRegion )
+        if ( this->Visited[cellId] < 0 )
         {
-          maxCellsInRegion = this->NumCellsInRegion;
-          largestRegionId = this->RegionNumber;
+          this->NumCellsInRegion = 0;
+          this->Wave.push_back(cellId);
+          this->TraverseAndMark ();
+
+          this->RegionSizes->InsertValue(this->RegionNumber++,
+                                         this->NumCellsInRegion);
+          this->Wave.clear();
+          this->Wave2.clear();
         }
+      }
+    }
 
-        this->RegionSizes->InsertValue(this->RegionNumber++,
-                                       this->NumCellsInRegion);
-        this->Wave.clear();
-        this->Wave2.clear();
+    this->AssignRegionIds(numCells);
+
+    // the first of the largest regions
+    for (i=0; i < this->RegionNumber; i++)
+    {
+      if ( this->RegionSizes->GetValue(i) > maxCellsInRegion )
+      {
+        maxCellsInRegion = this->RegionSizes->GetValue(i);
+        largestRegionId = i;
       }
     }
   }
@@ -507,6 +525,99 @@ void vtkPolyDataConnectivityFilter::TraverseAndMark ()
   } //while wave is not empty
 }
 
+// --------------------------------------------------------------------------
+// Label all cells and points at once: join the cells sharing a point with a
+// union-find, then number the resulting trees by their smallest cell id (the
+// same numbering as the serial traversal).
+void vtkPolyDataConnectivityFilter::ParallelLabelRegions()
+{
+  const vtkIdType numCells = this->Mesh->GetNumberOfCells();
+  const vtkIdType numPts = this->Mesh->GetNumberOfPoints();
+
+  std::vector<unsigned char> inRange;
+  if ( this->InScalars )
+  {
+    inRange.resize(numCells);
+    vtkConnectivityFilterInternals::FlagCellsInRange(
+      this->Mesh, this->InScalars, this->ScalarRange,
+      this->FullScalarConnectivity != 0, inRange.data());
+  }
+
+  this->RegionNumber = vtkConnectivityFilterInternals::LabelCells(
+    this->Mesh, inRange.empty() ? nullptr : inRange.data(), this->Visited);
+  this->UpdateProgress (0.5);
+
+  this->RegionSizes->SetNumberOfValues(this->RegionNumber);
+  vtkIdType *sizes = this->RegionSizes->GetPointer(0);
+  std::fill_n(sizes, this->RegionNumber, 0);
+  for (vtkIdType cellId=0; cellId < numCells; cellId++)
+  {
+    sizes[this->Visited[cellId]]++;
+  }
+  this->UpdateProgress (0.7);
+
+  // Output points keep the input order.
+  std::vector<vtkIdType> pointRegions(numPts);
+  vtkConnectivityFilterInternals::LabelPoints(
+    this->Mesh, this->Visited, pointRegions.data());
+
+  this->PointNumber = 0;
+  vtkIdType *pointScalars =
+    vtkArrayDownCast<vtkIdTypeArray>(this->NewScalars)->GetPointer(0);
+  for (vtkIdType ptId=0; ptId < numPts; ptId++)
+  {
+    if ( pointRegions[ptId] >= 0 )
+    {
+      pointScalars[this->PointNumber] = pointRegions[ptId];
+      this->PointMap[ptId] = this->PointNumber++;
+    }
+  }
+  this->UpdateProgress (0.9);
+}
+
+// --------------------------------------------------------------------------
+// Renumber the regions by cell count if requested. Regions of equal size
+// keep their relative order.
+void vtkPolyDataConnectivityFilter::AssignRegionIds(vtkIdType numCells)
+{
+  if ( this->RegionIdAssignmentMode == UNSPECIFIED || this->RegionNumber < 2 )
+  {
+    return;
+  }
+
+  vtkIdType numRegions = this->RegionNumber;
+  const vtkIdType *sizes = this->RegionSizes->GetPointer(0);
+  std::vector<vtkIdType> order(numRegions);
+  for (vtkIdType i=0; i < numRegions; i++)
+  {
+    order[i] = i;
+  }
+  if ( this->RegionIdAssignmentMode == CELL_COUNT_DESCENDING )
+  {
+    std::stable_sort(order.begin(), order.end(),
+      [sizes](vtkIdType a, vtkIdType b) { return sizes[a] > sizes[b]; });
+  }
+  else
+  {
+    std::stable_sort(order.begin(), order.end(),
+      [sizes](vtkIdType a, vtkIdType b) { return sizes[a] < sizes[b]; });
+  }
+
+  std::vector<vtkIdType> newIds(numRegions), newSizes(numRegions);
+  for (vtkIdType i=0; i < numRegions; i++)
+  {
+    newIds[order[i]] = i;
+    newSizes[i] = sizes[order[i]];
+  }
+  std::copy(newSizes.begin(), newSizes.end(), this->RegionSizes->GetPointer(0));
+
+  vtkConnectivityFilterInternals::MapIds(
+    newIds.data(), this->Visited, numCells);
+  vtkConnectivityFilterInternals::MapIds(newIds.data(),
+    vtkArrayDownCast<vtkIdTypeArray>(this->NewScalars)->GetPointer(0),
+    this->PointNumber);
+}
+
 // --------------------------------------------------------------------------
 int vtkPolyDataConnectivityFilter::IsScalarConnected( vtkIdType cellId )
 {
@@ -659,4 +770,8 @@ void vtkPolyDataConnectivityFilter::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "Parallel Labeling: "
+     << (this->ParallelLabeling ? "On\n" : "Off\n");
+  os << indent << "Region Id Assignment Mode: "
+     << this->RegionIdAssignmentMode << "\n";
 }
@@ -43,6 +43,14 @@
  * This use of ScalarConnectivity is particularly useful for selecting cells
  * for later processing.
  *
+ * When extracting the largest, specified, or all regions, the regions can be
+ * labeled in parallel by turning on ParallelLabeling. The cells are then
+ * merged into regions with a union-find structure instead of the serial
+ * wave propagation. With ScalarConnectivity on, a cell that does not
+ * satisfy the scalar criterion then always forms a region of its own,
+ * whereas the serial traversal may still pull it into a neighboring region
+ * when it is the first cell of that region visited.
+ *
  * @sa
  * vtkConnectivityFilter
 */
@@ -221,6 +229,40 @@ public:
   vtkGetMacro(OutputPointsPrecision,int);
   //@}
 
+  //@{
+  /**
+   * Turn on/off parallel labeling of the regions. It is used when extracting
+   * the largest, specified or all regions; the seeded and closest point
+   * modes always use the serial traversal. The regions found are the same
+   * as with the serial traversal (see the class documentation for the one
+   * difference with ScalarConnectivity), but the output points are ordered
+   * by input point id. Off by default.
+   */
+  vtkSetMacro(ParallelLabeling,vtkTypeBool);
+  vtkGetMacro(ParallelLabeling,vtkTypeBool);
+  vtkBooleanMacro(ParallelLabeling,vtkTypeBool);
+  //@}
+
+  /**
+   * Enumeration of the ways region ids can be assigned.
+   */
+  enum RegionIdAssignment {
+    UNSPECIFIED,           //!< ordered by the smallest cell id of the region
+    CELL_COUNT_DESCENDING, //!< largest region first
+    CELL_COUNT_ASCENDING   //!< smallest region first
+  };
+
+  //@{
+  /**
+   * Set/get how the region ids are assigned when extracting the largest,
+   * specified or all regions. By default (UNSPECIFIED) the regions are
+   * numbered in the order of their smallest cell id. Regions of equal size
+   * keep that order.
+   */
+  vtkSetClampMacro(RegionIdAssignmentMode,int,UNSPECIFIED,CELL_COUNT_ASCENDING);
+  vtkGetMacro(RegionIdAssignmentMode,int);
+  //@}
+
 protected:
   vtkPolyDataConnectivityFilter();
   ~vtkPolyDataConnectivityFilter() override;
@@ -246,6 +288,17 @@ protected:
 
   void TraverseAndMark();
 
+  /**
+   * Label all the cells and points of the mesh with a parallel union-find
+   * over the cells. Fills the same structures as TraverseAndMark().
+   */
+  void ParallelLabelRegions();
+
+  /**
+   * Renumber the regions according to RegionIdAssignmentMode.
+   */
+  void AssignRegionIds(vtkIdType numCells);
+
   // used to support algorithm execution
   vtkDataArray *CellScalars;
   vtkIdList *NeighborCellPointIds;
@@ -265,6 +318,8 @@ protected:
 
   vtkTypeBool MarkVisitedPointIds;
   int OutputPointsPrecision;
+  vtkTypeBool ParallelLabeling;
+  int RegionIdAssignmentMode;
 
 private:
   vtkPolyDataConnectivityFilter(const vtkPolyDataConnectivityFilter&) = delete;
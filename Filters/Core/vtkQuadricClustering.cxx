@@ -24,20 +24,201 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkTimerLog.h"
 #include "vtkTriangle.h"
 
+#include <algorithm>
+#include <unordered_map>
 #include <unordered_set> // keep track of inserted triangles
+#include <vector>
 
 vtkStandardNewMacro(vtkQuadricClustering);
 
 //----------------------------------------------------------------------------
-// PIMPLd STL set for keeping track of inserted cells
 struct vtkQuadricClusteringIdTypeHash {
   size_t operator()(vtkIdType val) const { return static_cast<size_t>(val); }
 };
-class vtkQuadricClusteringCellSet : public std::unordered_set<vtkIdType, vtkQuadricClusteringIdTypeHash> {};
-typedef vtkQuadricClusteringCellSet::iterator vtkQuadricClusteringCellSetIterator;
+
+// PIMPLd STL set for keeping track of inserted cells. A triangle is keyed by
+// its sorted bin ids rather than by a single id combining them, which
+// overflows vtkIdType with fine divisions.
+struct vtkQuadricClusteringTriangleKey {
+  vtkIdType Bins[3];
+  bool operator==(const vtkQuadricClusteringTriangleKey &key) const
+  {
+    return this->Bins[0] == key.Bins[0] && this->Bins[1] == key.Bins[1] &&
+           this->Bins[2] == key.Bins[2];
+  }
+};
+struct vtkQuadricClusteringTriangleKeyHash {
+  size_t operator()(const vtkQuadricClusteringTriangleKey &key) const
+  {
+    size_t hash = static_cast<size_t>(key.Bins[0]);
+    hash = hash * 31 + static_cast<size_t>(key.Bins[1]);
+    return hash * 31 + static_cast<size_t>(key.Bins[2]);
+  }
+};
+class vtkQuadricClusteringCellSet : public std::unordered_set<
+  vtkQuadricClusteringTriangleKey, vtkQuadricClusteringTriangleKeyHash> {};
+
+//----------------------------------------------------------------------------
+// Accumulates the quadrics of the triangles of a range of polygons into a
+// sparse per-thread map of bins. Each bin also remembers the first triangle
+// corner that uses it so that the output points can be numbered in the
+// same order as a serial traversal, and the triangles spanning three bins
+// are kept (in traversal order) to generate the output cells.
+class vtkQuadricClusteringAddPolygons
+{
+public:
+  struct BinQuadric
+  {
+    double Quadric[9];
+    vtkIdType FirstCorner;
+  };
+  struct Triangle
+  {
+    vtkIdType Bins[3];
+    vtkIdType CellId;
+  };
+  typedef std::unordered_map<vtkIdType, BinQuadric,
+    vtkQuadricClusteringIdTypeHash> BinMap;
+
+  vtkQuadricClustering *Self;
+  const vtkIdType *Connectivity;
+  vtkPoints *Points;
+  vtkIdType NumberOfCells;
+  vtkIdType ChunkSize;
+  std::vector<vtkIdType> ChunkLocations;
+  std::vector<vtkIdType> ChunkTriangles;
+
+  vtkSMPThreadLocal<BinMap> Bins;
+  vtkSMPThreadLocal<std::vector<Triangle> > Triangles;
+
+  vtkQuadricClusteringAddPolygons(vtkQuadricClustering *self,
+                                  vtkCellArray *polys, vtkPoints *points)
+    : Self(self), Connectivity(polys->GetPointer()), Points(points),
+      NumberOfCells(polys->GetNumberOfCells()), ChunkSize(4096)
+  {
+    // The polygons are traversed in chunks; find where each chunk starts
+    // in the connectivity and in the sequence of triangles.
+    vtkIdType numChunks = (this->NumberOfCells + this->ChunkSize - 1) /
+      this->ChunkSize;
+    this->ChunkLocations.resize(numChunks);
+    this->ChunkTriangles.resize(numChunks);
+    vtkIdType loc = 0, numTris = 0;
+    for (vtkIdType cellId = 0; cellId < this->NumberOfCells; ++cellId)
+    {
+      if (cellId % this->ChunkSize == 0)
+      {
+        this->ChunkLocations[cellId / this->ChunkSize] = loc;
+        this->ChunkTriangles[cellId / this->ChunkSize] = numTris;
+      }
+      numTris += std::max(this->Connectivity[loc] - 2,
+                          static_cast<vtkIdType>(0));
+      loc += this->Connectivity[loc] + 1;
+    }
+  }
+
+  void Initialize()
+  {
+  }
+
+  void operator()(vtkIdType beginChunk, vtkIdType endChunk)
+  {
+    BinMap &bins = this->Bins.Local();
+    std::vector<Triangle> &triangles = this->Triangles.Local();
+    double pts[3][3], quadric4x4[4][4];
+    Triangle tri;
+
+    for (vtkIdType chunk = beginChunk; chunk < endChunk; ++chunk)
+    {
+      vtkIdType loc = this->ChunkLocations[chunk];
+      vtkIdType triId = this->ChunkTriangles[chunk];
+      vtkIdType endCell = std::min((chunk + 1) * this->ChunkSize,
+                                   this->NumberOfCells);
+      for (tri.CellId = chunk * this->ChunkSize; tri.CellId < endCell;
+           ++tri.CellId)
+      {
+        vtkIdType numPts = this->Connectivity[loc];
+        const vtkIdType *ptIds = this->Connectivity + loc + 1;
+        loc += numPts + 1;
+
+        this->Points->GetPoint(ptIds[0], pts[0]);
+        tri.Bins[0] = this->Self->HashPoint(pts[0]);
+        //creates triangles; assumes poly is convex
+        for (vtkIdType j = 0; j < numPts - 2; j++, triId++)
+        {
+          this->Points->GetPoint(ptIds[j+1], pts[1]);
+          tri.Bins[1] = this->Self->HashPoint(pts[1]);
+          this->Points->GetPoint(ptIds[j+2], pts[2]);
+          tri.Bins[2] = this->Self->HashPoint(pts[2]);
+
+          bool distinct = tri.Bins[0] != tri.Bins[1] &&
+            tri.Bins[0] != tri.Bins[2] && tri.Bins[1] != tri.Bins[2];
+          if (!this->Self->UseInternalTriangles && !distinct)
+          {
+            continue;
+          }
+
+          vtkTriangle::ComputeQuadric(pts[0], pts[1], pts[2], quadric4x4);
+          for (int i = 0; i < 3; ++i)
+          {
+            std::pair<BinMap::iterator, bool> found =
+              bins.insert(std::make_pair(tri.Bins[i], BinQuadric()));
+            BinQuadric &bin = found.first->second;
+            if (found.second)
+            {
+              std::fill_n(bin.Quadric, 9, 0.0);
+              bin.FirstCorner = 3 * triId + i;
+            }
+            bin.Quadric[0] += quadric4x4[0][0];
+            bin.Quadric[1] += quadric4x4[0][1];
+            bin.Quadric[2] += quadric4x4[0][2];
+            bin.Quadric[3] += quadric4x4[0][3];
+            bin.Quadric[4] += quadric4x4[1][1];
+            bin.Quadric[5] += quadric4x4[1][2];
+            bin.Quadric[6] += quadric4x4[1][3];
+            bin.Quadric[7] += quadric4x4[2][2];
+            bin.Quadric[8] += quadric4x4[2][3];
+          }
+          if (distinct)
+          {
+            triangles.push_back(tri);
+          }
+        }
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+//----------------------------------------------------------------------------
+// Computes the representative point of each used bin.
+class vtkQuadricClusteringComputePoints
+{
+public:
+  vtkQuadricClustering *Self;
+  vtkPoints *Points;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    double newPt[3];
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      if (this->Self->QuadricArray[i].VertexId != -1)
+      {
+        this->Self->ComputeRepresentativePoint(
+          this->Self->QuadricArray[i].Quadric, i, newPt);
+        this->Points->SetPoint(this->Self->QuadricArray[i].VertexId, newPt);
+      }
+    }
+  }
+};
 
 
 //----------------------------------------------------------------------------
@@ -76,7 +257,6 @@ vtkQuadricClustering::vtkQuadricClustering()
 
   this->PreventDuplicateCells = 1;
   this->CellSet = nullptr;
-  this->NumberOfBins = 0;
 
   this->OutputTriangleArray = nullptr;
   this->OutputLines = nullptr;
@@ -225,8 +405,6 @@ void vtkQuadricClustering::StartAppend(double *bounds)
   if ( this->PreventDuplicateCells )
   {
     this->CellSet = new vtkQuadricClusteringCellSet;
-    this->NumberOfBins =
-      this->NumberOfDivisions[0]*this->NumberOfDivisions[1]*this->NumberOfDivisions[2];
   }
 
   // Copy over the bounds.
@@ -370,44 +548,106 @@ void vtkQuadricClustering::Append(vtkPolyData *pd)
 }
 
 //----------------------------------------------------------------------------
+// The quadrics of the triangles are accumulated in parallel. The output
+// points and triangles are then numbered and ordered exactly as the serial
+// traversal of AddTriangle would.
 void vtkQuadricClustering::AddPolygons(vtkCellArray *polys, vtkPoints *points,
                                        int geometryFlag,
                                        vtkPolyData *input, vtkPolyData *output)
 {
-  vtkIdType *ptIds = nullptr;
-  vtkIdType numPts = 0;
-  double pts0[3], pts1[3], pts2[3];
-  vtkIdType binIds[3];
+  if (polys->GetNumberOfCells() == 0)
+  {
+    return;
+  }
 
-  double total = polys->GetNumberOfCells();
-  double curr = 0;
-  double step = total / 10;
-  if (step < 1000.0)
+  vtkQuadricClusteringAddPolygons accumulate(this, polys, points);
+  vtkSMPTools::For(0,
+    static_cast<vtkIdType>(accumulate.ChunkLocations.size()), accumulate);
+  this->UpdateProgress(.7);
+
+  // Add the quadrics to the bins. Points and segments supersede triangles.
+  typedef vtkQuadricClusteringAddPolygons::BinMap BinMap;
+  std::vector<std::pair<vtkIdType, vtkIdType> > newBins;
+  for (vtkSMPThreadLocal<BinMap>::iterator it = accumulate.Bins.begin();
+       it != accumulate.Bins.end(); ++it)
+  {
+    for (BinMap::iterator bin = it->begin(); bin != it->end(); ++bin)
+    {
+      PointQuadric &pq = this->QuadricArray[bin->first];
+      if (pq.Dimension > 2)
+      {
+        pq.Dimension = 2;
+        this->InitializeQuadric(pq.Quadric);
+      }
+      if (pq.Dimension == 2)
+      {
+        this->AddQuadric(bin->first, bin->second.Quadric);
+      }
+      if (geometryFlag && pq.VertexId == -1)
+      {
+        newBins.push_back(std::make_pair(bin->second.FirstCorner, bin->first));
+      }
+    }
+    BinMap().swap(*it);
+  }
+
+  if (!geometryFlag)
   {
-    step = 1000.0;
+    this->InCellCount += polys->GetNumberOfCells();
+    return;
   }
-  double cstep = step;
 
-  for ( polys->InitTraversal(); polys->GetNextCell(numPts, ptIds); )
+  // Number the new output points in the order the triangles first use them.
+  std::sort(newBins.begin(), newBins.end());
+  for (size_t i = 0; i < newBins.size(); ++i)
   {
-    points->GetPoint(ptIds[0],pts0);
-    binIds[0] = this->HashPoint(pts0);
-    for (vtkIdType j=0; j < numPts-2; j++)//creates triangles; assumes poly is convex
+    PointQuadric &pq = this->QuadricArray[newBins[i].second];
+    if (pq.VertexId == -1)
     {
-      points->GetPoint(ptIds[j+1],pts1);
-      binIds[1] = this->HashPoint(pts1);
-      points->GetPoint(ptIds[j+2],pts2);
-      binIds[2] = this->HashPoint(pts2);
-      this->AddTriangle(binIds, pts0, pts1, pts2, geometryFlag, input, output);
+      pq.VertexId = this->NumberOfBinsUsed++;
     }
-    ++this->InCellCount;
-    if ( curr > cstep )
+  }
+
+  // Add the triangles spanning three bins to the output, in traversal order.
+  typedef vtkQuadricClusteringAddPolygons::Triangle Triangle;
+  std::vector<Triangle> triangles;
+  for (vtkSMPThreadLocal<std::vector<Triangle> >::iterator it =
+         accumulate.Triangles.begin(); it != accumulate.Triangles.end(); ++it)
+  {
+    triangles.insert(triangles.end(), it->begin(), it->end());
+    std::vector<Triangle>().swap(*it);
+  }
+  std::stable_sort(triangles.begin(), triangles.end(),
+    [](const Triangle &t0, const Triangle &t1) { return t0.CellId < t1.CellId; });
+
+  vtkIdType firstCellId = this->InCellCount;
+  vtkIdType triPtIds[3];
+  for (size_t t = 0; t < triangles.size(); ++t)
+  {
+    const vtkIdType *binIds = triangles[t].Bins;
+    for (int i = 0; i < 3; i++)
+    {
+      triPtIds[i] = this->QuadricArray[binIds[i]].VertexId;
+    }
+    if ( this->PreventDuplicateCells )
     {
-      this->UpdateProgress(.6 + .2 * curr / total);
-      cstep += step;
+      vtkQuadricClusteringTriangleKey key =
+        { { binIds[0], binIds[1], binIds[2] } };
+      std::sort(key.Bins, key.Bins + 3);
+      if ( !this->CellSet->insert(key).second )
+      {
+        continue;
+      }
     }
-    curr += 1;
-  }//for all polygons
+    this->OutputTriangleArray->InsertNextCell(3, triPtIds);
+    if (this->CopyCellData && input)
+    {
+      output->GetCellData()->CopyData(input->GetCellData(),
+        firstCellId + triangles[t].CellId, this->OutCellCount++);
+    }
+  }
+
+  this->InCellCount += polys->GetNumberOfCells();
 }
 
 //----------------------------------------------------------------------------
@@ -573,12 +813,10 @@ void vtkQuadricClustering::AddTriangle(vtkIdType *binIds, double *pt0, double *p
             }
             break;
         }
-        // TODO: this arithmetic overflows with the TestQuadricLODActor test.
-        vtkIdType idx = binIds[minIdx] + this->NumberOfBins*binIds[midIdx] +
-                        this->NumberOfBins*this->NumberOfBins*binIds[maxIdx];
-        if ( this->CellSet->find(idx) == this->CellSet->end() )
+        vtkQuadricClusteringTriangleKey key =
+          { { binIds[minIdx], binIds[midIdx], binIds[maxIdx] } };
+        if ( this->CellSet->insert(key).second )
         {
-          this->CellSet->insert(idx);
           this->OutputTriangleArray->InsertNextCell(3, triPtIds);
           if (this->CopyCellData && input)
           {
@@ -921,17 +1159,9 @@ void vtkQuadricClustering::EndAppend()
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
   vtkIdType numBuckets;
-  int abortExecute=0;
   vtkPoints *outputPoints;
-  double newPt[3];
   numBuckets = this->NumberOfDivisions[0] * this->NumberOfDivisions[1] *
                 this->NumberOfDivisions[2];
-  double step = (double)numBuckets / 10.0;
-  if (step < 1000.0)
-  {
-    step = 1000.0;
-  }
-  double cstep = 0;
 
   // Check for mis use of the Append methods.
   if (this->OutputTriangleArray == nullptr || this->OutputLines == nullptr)
@@ -947,25 +1177,15 @@ void vtkQuadricClustering::EndAppend()
     this->CellSet = nullptr;
   }
 
-  // Compute the representative points for each bin
+  // Compute the representative points for each bin. Every output point id
+  // belongs to exactly one bin, so the bins can be processed in parallel.
   outputPoints = vtkPoints::New();
-  for (vtkIdType i = 0; !abortExecute && i < numBuckets; i++ )
-  {
-    if (cstep > step)
-    {
-      cstep = 0;
-      vtkDebugMacro(<<"Finding point in bin #" << i);
-      this->UpdateProgress (0.8+0.2*i/numBuckets);
-      abortExecute = this->GetAbortExecute();
-    }
-    ++cstep;
-
-    if (this->QuadricArray[i].VertexId != -1)
-    {
-      this->ComputeRepresentativePoint(this->QuadricArray[i].Quadric, i, newPt);
-      outputPoints->InsertPoint(this->QuadricArray[i].VertexId, newPt);
-    }
-  }
+  outputPoints->SetNumberOfPoints(this->NumberOfBinsUsed);
+  vtkQuadricClusteringComputePoints computePoints;
+  computePoints.Self = this;
+  computePoints.Points = outputPoints;
+  vtkSMPTools::For(0, numBuckets, computePoints);
+  this->UpdateProgress(1.0);
 
   // Set up the output data object.
   output->SetPoints(outputPoints);
@@ -42,6 +42,11 @@
  * for that bin.  This determines the spatial location of the vertices of
  * each of the triangles in the output.
  *
+ * The quadrics of the polygons are accumulated in parallel (vtkSMPTools)
+ * into per-thread sparse maps of bins that are then summed, and the
+ * representative points are also computed in parallel. The output points
+ * and cells are numbered in the same order as a serial traversal.
+ *
  * To use this filter, specify the divisions defining the spatial subdivision
  * in the x, y, and z directions. You must also specify an input vtkPolyData.
  * Then choose to either 1) use the original points that minimize the quadric
@@ -91,7 +96,9 @@
 class vtkCellArray;
 class vtkFeatureEdges;
 class vtkPoints;
+class vtkQuadricClusteringAddPolygons;
 class vtkQuadricClusteringCellSet;
+class vtkQuadricClusteringComputePoints;
 
 
 class VTKFILTERSCORE_EXPORT vtkQuadricClustering : public vtkPolyDataAlgorithm
@@ -355,7 +362,6 @@ protected:
   // Set this to eliminate duplicate cells
   vtkTypeBool PreventDuplicateCells;
   vtkQuadricClusteringCellSet *CellSet; //PIMPLd stl set for tracking inserted cells
-  vtkIdType NumberOfBins;
 
   // Used internally.
   // can be smaller than user values when input numb er of points is small.
@@ -408,6 +414,9 @@ protected:
   int OutCellCount;
 
 private:
+  friend class vtkQuadricClusteringAddPolygons;
+  friend class vtkQuadricClusteringComputePoints;
+
   vtkQuadricClustering(const vtkQuadricClustering&) = delete;
   void operator=(const vtkQuadricClustering&) = delete;
 };
@@ -49,14 +49,95 @@
 #include "vtkMath.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
 #include "vtkPointData.h"
 #include "vtkPriorityQueue.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkTriangle.h"
 
+#include <algorithm>
+#include <vector>
+
+// Partitioned decimation never creates pieces smaller than this number of
+// triangles.
+#define VTK_QUADRIC_DECIMATION_MIN_PARTITION_SIZE 5000
+
 vtkStandardNewMacro(vtkQuadricDecimation);
 
+namespace
+{
+//----------------------------------------------------------------------------
+struct vtkQuadricDecimationCentroid
+{
+  double X[3];
+  vtkIdType CellId;
+};
+
+//----------------------------------------------------------------------------
+// Assign the triangles to numParts pieces of similar size by recursively
+// splitting the centroids at the median of their longest axis.
+void vtkQuadricDecimationBisect(vtkQuadricDecimationCentroid* begin,
+                                vtkQuadricDecimationCentroid* end,
+                                int numParts, int firstPart,
+                                std::vector<int>& partition)
+{
+  if (numParts <= 1)
+  {
+    for (vtkQuadricDecimationCentroid* c = begin; c != end; ++c)
+    {
+      partition[c->CellId] = firstPart;
+    }
+    return;
+  }
+
+  double bounds[6] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX,
+                       -VTK_DOUBLE_MAX, VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+  for (vtkQuadricDecimationCentroid* c = begin; c != end; ++c)
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      bounds[2 * i] = std::min(bounds[2 * i], c->X[i]);
+      bounds[2 * i + 1] = std::max(bounds[2 * i + 1], c->X[i]);
+    }
+  }
+  int axis = 0;
+  for (int i = 1; i < 3; ++i)
+  {
+    if (bounds[2 * i + 1] - bounds[2 * i] >
+        bounds[2 * axis + 1] - bounds[2 * axis])
+    {
+      axis = i;
+    }
+  }
+
+  int numLeft = numParts / 2;
+  vtkQuadricDecimationCentroid* middle = begin + (end - begin) * numLeft / numParts;
+  std::nth_element(begin, middle, end,
+    [axis](const vtkQuadricDecimationCentroid& a,
+           const vtkQuadricDecimationCentroid& b) { return a.X[axis] < b.X[axis]; });
+
+  vtkQuadricDecimationBisect(begin, middle, numLeft, firstPart, partition);
+  vtkQuadricDecimationBisect(
+    middle, end, numParts - numLeft, firstPart + numLeft, partition);
+}
+
+//----------------------------------------------------------------------------
+// One piece of a partitioned decimation: a decimator whose working mesh
+// holds the triangles of the piece, the ids of its points in the full mesh
+// and the points it shares with other pieces.
+struct vtkQuadricDecimationPiece
+{
+  vtkSmartPointer<vtkQuadricDecimation> Decimator;
+  vtkSmartPointer<vtkPolyData> Mesh;
+  std::vector<vtkIdType> PointIds;
+  std::vector<unsigned char> Locked;
+  vtkIdType NumberOfTriangles;
+};
+}
+
 
 //----------------------------------------------------------------------------
 vtkQuadricDecimation::vtkQuadricDecimation()
@@ -70,6 +151,9 @@ vtkQuadricDecimation::vtkQuadricDecimation()
   this->TargetPoints = vtkDoubleArray::New();
 
   this->TargetReduction = 0.9;
+  this->NumberOfPartitions = 1;
+  this->LockedPoints = nullptr;
+  this->AbortSource = nullptr;
   this->NumberOfEdgeCollapses = 0;
   this->NumberOfComponents = 0;
 
@@ -187,20 +271,12 @@ int vtkQuadricDecimation::RequestData(
   vtkPolyData *output = vtkPolyData::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkIdType numPts = input->GetNumberOfPoints();
   vtkIdType numTris = input->GetNumberOfPolys();
-  vtkIdType edgeId, i;
-  int j;
-  double cost;
-  double *x;
+  vtkIdType i;
   vtkCellArray *polys;
   vtkDataArray *attrib;
   vtkPoints *points;
-  vtkPointData *pointData;
-  vtkIdType endPtIds[2];
   vtkIdList *outputCellList;
-  vtkIdType npts, *pts;
-  vtkIdType numDeletedTris=0;
 
   // check some assumptions about the data
   if (input->GetPolys() == nullptr || input->GetPoints() == nullptr ||
@@ -218,7 +294,6 @@ int vtkQuadricDecimation::RequestData(
 
   polys = vtkCellArray::New();
   points = vtkPoints::New();
-  pointData = vtkPointData::New();
   outputCellList = vtkIdList::New();
 
   // copy the input (only polys) to our working mesh
@@ -233,8 +308,77 @@ int vtkQuadricDecimation::RequestData(
   {
     this->Mesh->GetPointData()->DeepCopy(input->GetPointData());
   }
-  pointData->Delete();
   this->Mesh->GetFieldData()->PassData(input->GetFieldData());
+
+  this->NumberOfComponents = 0;
+  if (this->AttributeErrorMetric)
+  {
+    this->ComputeNumberOfComponents();
+  }
+
+  vtkIdType numPartitions = std::min(
+    static_cast<vtkIdType>(this->NumberOfPartitions),
+    numTris / VTK_QUADRIC_DECIMATION_MIN_PARTITION_SIZE);
+  if (numPartitions > 1)
+  {
+    this->DecimatePartitions(static_cast<int>(numPartitions), numTris);
+  }
+  else
+  {
+    this->DecimateMesh(numTris);
+  }
+
+  // copy the simplified mesh from the working mesh to the output mesh
+  for (i = 0; i < this->Mesh->GetNumberOfCells(); i++)
+  {
+    if (this->Mesh->GetCellType(i) != VTK_EMPTY_CELL)
+    {
+      outputCellList->InsertNextId(i);
+    }
+  }
+
+  output->Reset();
+  output->Allocate(this->Mesh, outputCellList->GetNumberOfIds());
+  output->GetPointData()->CopyAllocate(this->Mesh->GetPointData(),1);
+  output->CopyCells(this->Mesh, outputCellList);
+
+  this->Mesh->DeleteLinks();
+  this->Mesh->Delete();
+  outputCellList->Delete();
+
+  // renormalize, clamp attributes
+  if (this->AttributeErrorMetric)
+  {
+    if (nullptr != (attrib = output->GetPointData()->GetNormals()))
+    {
+      for (i = 0; i < attrib->GetNumberOfTuples(); i++)
+      {
+        vtkMath::Normalize(attrib->GetTuple3(i));
+      }
+    }
+    // might want to add clamping texture coordinates??
+  }
+
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+void vtkQuadricDecimation::DecimateMesh(vtkIdType numInputTris,
+                                        double progressStart,
+                                        double progressEnd)
+{
+  vtkQuadricDecimation *abortSource =
+    this->AbortSource ? this->AbortSource : this;
+  double progressRange = progressEnd - progressStart;
+  vtkIdType numPts = this->Mesh->GetNumberOfPoints();
+  vtkIdType edgeId, i;
+  int j;
+  double cost;
+  double *x;
+  vtkIdType endPtIds[2];
+  vtkIdType npts, *pts;
+  vtkIdType numDeletedTris = numInputTris - this->Mesh->GetNumberOfPolys();
+
   this->Mesh->BuildCells();
   this->Mesh->BuildLinks();
 
@@ -253,6 +397,9 @@ int vtkQuadricDecimation::RequestData(
 
   vtkDebugMacro(<<"Computing Edges");
   this->Edges->InitEdgeInsertion(numPts, 1); // storing edge id as attribute
+  this->EndPoint1List->Reset();
+  this->EndPoint2List->Reset();
+  this->TargetPoints->Reset();
   this->EdgeCosts->Allocate(this->Mesh->GetPolys()->GetNumberOfCells() * 3);
   for (i = 0; i <  this->Mesh->GetNumberOfCells(); i++)
   {
@@ -273,13 +420,8 @@ int vtkQuadricDecimation::RequestData(
     }
   }
 
-  this->UpdateProgress(0.1);
+  this->UpdateProgress(progressStart + 0.1*progressRange);
 
-  this->NumberOfComponents = 0;
-  if (this->AttributeErrorMetric)
-  {
-    this->ComputeNumberOfComponents();
-  }
   x = new double [3+this->NumberOfComponents+this->VolumePreservation];
   this->CollapseCellIds = vtkIdList::New();
   this->TempX = new double [3+this->NumberOfComponents+this->VolumePreservation];
@@ -297,7 +439,7 @@ int vtkQuadricDecimation::RequestData(
   vtkDebugMacro(<<"Computing Quadrics");
   this->InitializeQuadrics(numPts);
   this->AddBoundaryConstraints();
-  this->UpdateProgress(0.15);
+  this->UpdateProgress(progressStart + 0.15*progressRange);
 
   vtkDebugMacro(<<"Computing Costs");
   // Compute the cost of and target point for collapsing each edge.
@@ -314,10 +456,11 @@ int vtkQuadricDecimation::RequestData(
     this->EdgeCosts->Insert(cost, i);
     this->TargetPoints->InsertTuple(i, x);
   }
-  this->UpdateProgress(0.20);
+  this->UpdateProgress(progressStart + 0.20*progressRange);
 
   // Okay collapse edges until desired reduction is reached
-  this->ActualReduction = 0.0;
+  this->ActualReduction = numInputTris > 0 ?
+    static_cast<double>(numDeletedTris) / numInputTris : 0.0;
   this->NumberOfEdgeCollapses = 0;
   edgeId = this->EdgeCosts->Pop(0,cost);
 
@@ -328,8 +471,9 @@ int vtkQuadricDecimation::RequestData(
     if ( ! (this->NumberOfEdgeCollapses % 10000) )
     {
       vtkDebugMacro(<<"Collapsing edge#" << this->NumberOfEdgeCollapses);
-      this->UpdateProgress (0.20 + 0.80*this->NumberOfEdgeCollapses/numPts);
-      abort = this->GetAbortExecute();
+      this->UpdateProgress(progressStart + progressRange *
+        (0.20 + 0.80*this->NumberOfEdgeCollapses/numPts));
+      abort = abortSource->GetAbortExecute();
     }
 
     endPtIds[0] = this->EndPoint1List->GetId(edgeId);
@@ -362,7 +506,7 @@ int vtkQuadricDecimation::RequestData(
 
     // Update the output triangles.
     numDeletedTris += this->CollapseEdge(endPtIds[0], endPtIds[1]);
-    this->ActualReduction = (double) numDeletedTris / numTris;
+    this->ActualReduction = (double) numDeletedTris / numInputTris;
     edgeId = this->EdgeCosts->Pop(0, cost);
   }
 
@@ -385,39 +529,221 @@ int vtkQuadricDecimation::RequestData(
   delete [] this->TempB;
   delete [] this->TempA;
   delete [] this->TempData;
+}
 
-  // copy the simplified mesh from the working mesh to the output mesh
-  for (i = 0; i < this->Mesh->GetNumberOfCells(); i++)
+//----------------------------------------------------------------------------
+void vtkQuadricDecimation::DecimatePartitions(int numPartitions,
+                                              vtkIdType numInputTris)
+{
+  vtkPolyData *mesh = this->Mesh;
+  vtkPointData *pd = mesh->GetPointData();
+  vtkIdType numPts = mesh->GetNumberOfPoints();
+  vtkIdType numTris = mesh->GetNumberOfPolys();
+  vtkCellArray *polys = mesh->GetPolys();
+  vtkIdType npts, *pts, cellId, ptId;
+  int j, part;
+
+  // split the triangles into pieces
+  vtkDebugMacro(<<"Partitioning " << numTris << " triangles into "
+                << numPartitions << " pieces");
+  std::vector<vtkQuadricDecimationCentroid> centroids(numTris);
+  std::vector<vtkIdType> connectivity(3 * numTris);
+  double x[3];
+  for (cellId = 0, polys->InitTraversal();
+       polys->GetNextCell(npts, pts); cellId++)
   {
-    if (this->Mesh->GetCell(i)->GetCellType() != VTK_EMPTY_CELL)
+    vtkQuadricDecimationCentroid& c = centroids[cellId];
+    c.CellId = cellId;
+    c.X[0] = c.X[1] = c.X[2] = 0.0;
+    for (j = 0; j < 3; j++)
     {
-      outputCellList->InsertNextId(i);
+      connectivity[3 * cellId + j] = pts[j];
+      mesh->GetPoint(pts[j], x);
+      c.X[0] += x[0] / 3.0;
+      c.X[1] += x[1] / 3.0;
+      c.X[2] += x[2] / 3.0;
+    }
+  }
+  std::vector<int> partition(numTris);
+  vtkQuadricDecimationBisect(centroids.data(), centroids.data() + numTris,
+                             numPartitions, 0, partition);
+  std::vector<vtkQuadricDecimationCentroid>().swap(centroids);
+
+  // the points used by more than one piece form the seams
+  std::vector<int> owner(numPts, -1);
+  std::vector<unsigned char> seam(numPts, 0);
+  for (cellId = 0; cellId < numTris; cellId++)
+  {
+    for (j = 0; j < 3; j++)
+    {
+      ptId = connectivity[3 * cellId + j];
+      if (owner[ptId] < 0)
+      {
+        owner[ptId] = partition[cellId];
+      }
+      else if (owner[ptId] != partition[cellId])
+      {
+        seam[ptId] = 1;
+      }
     }
   }
 
-  output->Reset();
-  output->Allocate(this->Mesh, outputCellList->GetNumberOfIds());
-  output->GetPointData()->CopyAllocate(this->Mesh->GetPointData(),1);
-  output->CopyCells(this->Mesh, outputCellList);
-
-  this->Mesh->DeleteLinks();
-  this->Mesh->Delete();
-  outputCellList->Delete();
+  // build the working mesh of each piece
+  std::vector<vtkQuadricDecimationPiece> pieces(numPartitions);
+  std::vector<std::vector<vtkIdType> > pieceCells(numPartitions);
+  for (cellId = 0; cellId < numTris; cellId++)
+  {
+    pieceCells[partition[cellId]].push_back(cellId);
+  }
+  std::vector<vtkIdType> localIds(numPts, -1);
+  for (part = 0; part < numPartitions; part++)
+  {
+    vtkQuadricDecimationPiece& piece = pieces[part];
+    const std::vector<vtkIdType>& cells = pieceCells[part];
+    piece.NumberOfTriangles = static_cast<vtkIdType>(cells.size());
+    piece.Mesh = vtkSmartPointer<vtkPolyData>::New();
+    vtkNew<vtkPoints> piecePoints;
+    piecePoints->SetDataType(mesh->GetPoints()->GetDataType());
+    vtkNew<vtkCellArray> pieceCellArray;
+    pieceCellArray->Allocate(4 * piece.NumberOfTriangles);
+    if (this->AttributeErrorMetric)
+    {
+      piece.Mesh->GetPointData()->CopyAllocate(pd);
+    }
+    vtkIdType tri[3];
+    for (vtkIdType c : cells)
+    {
+      for (j = 0; j < 3; j++)
+      {
+        ptId = connectivity[3 * c + j];
+        if (localIds[ptId] < 0)
+        {
+          localIds[ptId] = piecePoints->InsertNextPoint(mesh->GetPoint(ptId));
+          piece.PointIds.push_back(ptId);
+          piece.Locked.push_back(seam[ptId]);
+          if (this->AttributeErrorMetric)
+          {
+            piece.Mesh->GetPointData()->CopyData(pd, ptId, localIds[ptId]);
+          }
+        }
+        tri[j] = localIds[ptId];
+      }
+      pieceCellArray->InsertNextCell(3, tri);
+    }
+    for (vtkIdType id : piece.PointIds)
+    {
+      localIds[id] = -1;
+    }
+    piece.Mesh->SetPoints(piecePoints);
+    piece.Mesh->SetPolys(pieceCellArray);
+
+    // the pieces use the attribute scaling of the whole mesh
+    piece.Decimator = vtkSmartPointer<vtkQuadricDecimation>::New();
+    vtkQuadricDecimation *decimator = piece.Decimator;
+    decimator->TargetReduction = this->TargetReduction;
+    decimator->AttributeErrorMetric = this->AttributeErrorMetric;
+    decimator->VolumePreservation = this->VolumePreservation;
+    decimator->NumberOfComponents = this->NumberOfComponents;
+    std::copy(this->AttributeComponents, this->AttributeComponents + 6,
+              decimator->AttributeComponents);
+    std::copy(this->AttributeScale, this->AttributeScale + 6,
+              decimator->AttributeScale);
+    decimator->Mesh = piece.Mesh;
+    decimator->LockedPoints = piece.Locked.data();
+    decimator->AbortSource = this;
+  }
+  std::vector<std::vector<vtkIdType> >().swap(pieceCells);
+  std::vector<vtkIdType>().swap(connectivity);
+  std::vector<int>().swap(partition);
+  this->UpdateProgress(0.1);
 
-  // renormalize, clamp attributes
+  // decimate the pieces concurrently; each piece decimator checks the abort
+  // flag of this filter
+  vtkSMPTools::For(0, numPartitions, [&](vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType p = begin; p < end && !this->GetAbortExecute(); ++p)
+    {
+      pieces[p].Decimator->DecimateMesh(pieces[p].NumberOfTriangles);
+    }
+  });
+  this->UpdateProgress(0.6);
+
+  // merge the pieces; the seam points were not moved so each is shared by
+  // the pieces using it
+  vtkPolyData *merged = vtkPolyData::New();
+  vtkNew<vtkPoints> mergedPoints;
+  mergedPoints->SetDataType(mesh->GetPoints()->GetDataType());
+  vtkNew<vtkCellArray> mergedPolys;
   if (this->AttributeErrorMetric)
   {
-    if (nullptr != (attrib = output->GetPointData()->GetNormals()))
+    merged->GetPointData()->CopyAllocate(pd);
+  }
+  merged->GetFieldData()->PassData(mesh->GetFieldData());
+  std::vector<vtkIdType> mergedIds(numPts, -1);
+  std::vector<unsigned char> mergedSeam;
+  for (part = 0; part < numPartitions; part++)
+  {
+    vtkQuadricDecimationPiece& piece = pieces[part];
+    vtkPolyData *pieceMesh = piece.Mesh;
+    std::vector<vtkIdType> pieceIds(pieceMesh->GetNumberOfPoints(), -1);
+    vtkIdType tri[3];
+    for (cellId = 0; cellId < pieceMesh->GetNumberOfCells(); cellId++)
     {
-      for (i = 0; i < attrib->GetNumberOfTuples(); i++)
+      if (pieceMesh->GetCellType(cellId) == VTK_EMPTY_CELL)
       {
-        vtkMath::Normalize(attrib->GetTuple3(i));
+        continue;
+      }
+      pieceMesh->GetCellPoints(cellId, npts, pts);
+      for (j = 0; j < 3; j++)
+      {
+        vtkIdType& id = piece.Locked[pts[j]] ?
+          mergedIds[piece.PointIds[pts[j]]] : pieceIds[pts[j]];
+        if (id < 0)
+        {
+          id = mergedPoints->InsertNextPoint(pieceMesh->GetPoint(pts[j]));
+          mergedSeam.push_back(piece.Locked[pts[j]]);
+          if (this->AttributeErrorMetric)
+          {
+            merged->GetPointData()->CopyData(
+              pieceMesh->GetPointData(), pts[j], id);
+          }
+        }
+        tri[j] = id;
       }
+      mergedPolys->InsertNextCell(3, tri);
     }
-    // might want to add clamping texture coordinates??
+    piece.Decimator->Mesh = nullptr;
+    piece.Decimator->LockedPoints = nullptr;
+    piece.Decimator->AbortSource = nullptr;
+    piece.Mesh->DeleteLinks();
+    piece.Mesh = nullptr;
   }
+  merged->SetPoints(mergedPoints);
+  merged->SetPolys(mergedPolys);
+  pieces.clear();
 
-  return 1;
+  this->Mesh->Delete();
+  this->Mesh = merged;
+
+  if (this->GetAbortExecute())
+  {
+    this->ActualReduction = numInputTris > 0 ? static_cast<double>(
+      numInputTris - mergedPolys->GetNumberOfCells()) / numInputTris : 0.0;
+    return;
+  }
+
+  // decimate the seams: only the seam points and their neighbors may move
+  std::vector<unsigned char> locked(mergedPoints->GetNumberOfPoints(), 1);
+  for (mergedPolys->InitTraversal(); mergedPolys->GetNextCell(npts, pts); )
+  {
+    if (mergedSeam[pts[0]] || mergedSeam[pts[1]] || mergedSeam[pts[2]])
+    {
+      locked[pts[0]] = locked[pts[1]] = locked[pts[2]] = 0;
+    }
+  }
+  this->LockedPoints = locked.data();
+  this->DecimateMesh(numInputTris, 0.6, 1.0);
+  this->LockedPoints = nullptr;
 }
 
 //----------------------------------------------------------------------------
@@ -916,6 +1242,12 @@ double vtkQuadricDecimation::ComputeCost(vtkIdType edgeId, double *x)
     }
   }
 
+  if (this->LockedPoints &&
+      (this->LockedPoints[pointIds[0]] || this->LockedPoints[pointIds[1]]))
+  {
+    cost = VTK_DOUBLE_MAX;
+  }
+
   return cost;
 }
 
@@ -1159,6 +1491,12 @@ double vtkQuadricDecimation::ComputeCost2(vtkIdType edgeId, double *x)
 
   cost += this->TempQuad[9];
 
+  if (this->LockedPoints &&
+      (this->LockedPoints[pointIds[0]] || this->LockedPoints[pointIds[1]]))
+  {
+    cost = VTK_DOUBLE_MAX;
+  }
+
   return cost;
 }
 
@@ -1433,6 +1771,7 @@ void vtkQuadricDecimation::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Target Reduction: " << this->TargetReduction << "\n";
   os << indent << "Actual Reduction: " << this->ActualReduction << "\n";
+  os << indent << "Number Of Partitions: " << this->NumberOfPartitions << "\n";
 
   os << indent << "Attribute Error Metric: "
      << (this->AttributeErrorMetric ? "On\n" : "Off\n");
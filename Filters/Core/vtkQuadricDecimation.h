@@ -48,6 +48,12 @@
  * Attributes" is also a good take on the subject especially as it pertains
  * to the error metric applied to attributes.
  *
+ * A single priority queue makes the algorithm inherently serial. For very
+ * large meshes, NumberOfPartitions can be set to split the mesh spatially
+ * into pieces that are decimated concurrently while the points shared
+ * between pieces stay locked; a final pass then decimates the seams between
+ * the pieces.
+ *
  * @par Thanks:
  * Thanks to Bradley Lowekamp of the National Library of Medicine/NIH for
  * contributing this class.
@@ -148,6 +154,21 @@ public:
   vtkGetMacro(TensorsWeight, double);
   //@}
 
+  //@{
+  /**
+   * Set/Get the number of spatial partitions used to decimate the mesh in
+   * parallel. When greater than one, the triangles are split by recursive
+   * bisection of their centroids into this many pieces of similar size,
+   * each piece is decimated to the target reduction in its own thread with
+   * the points it shares with other pieces locked, and the seams between
+   * the pieces are decimated last. Fewer partitions are used when a piece
+   * would hold less than a few thousand triangles. The default is 1, which
+   * decimates the whole mesh with a single priority queue.
+   */
+  vtkSetClampMacro(NumberOfPartitions, int, 1, VTK_INT_MAX);
+  vtkGetMacro(NumberOfPartitions, int);
+  //@}
+
   //@{
   /**
    * Get the actual reduction. This value is only valid after the
@@ -162,6 +183,23 @@ protected:
 
   int RequestData(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
 
+  /**
+   * Decimate the working mesh in place until the target reduction of
+   * numInputTris triangles is reached. Triangles already missing from the
+   * working mesh count as deleted. Points flagged in LockedPoints are
+   * neither moved nor deleted. Progress is reported in the range
+   * [progressStart, progressEnd].
+   */
+  void DecimateMesh(vtkIdType numInputTris, double progressStart = 0.0,
+                    double progressEnd = 1.0);
+
+  /**
+   * Decimate the working mesh in numPartitions pieces concurrently, then
+   * decimate the seams between the pieces. The working mesh is replaced by
+   * the merged result.
+   */
+  void DecimatePartitions(int numPartitions, vtkIdType numInputTris);
+
   /**
    * Do the dirty work of eliminating the edge; return the number of
    * triangles deleted.
@@ -232,6 +270,7 @@ protected:
 
   double TargetReduction;
   double ActualReduction;
+  int NumberOfPartitions;
   vtkTypeBool   AttributeErrorMetric;
   vtkTypeBool   VolumePreservation;
 
@@ -256,6 +295,14 @@ protected:
   int               NumberOfComponents;
   vtkPolyData      *Mesh;
 
+  // Optional flag per point of the working mesh; edges with a flagged
+  // end point are never collapsed.
+  const unsigned char *LockedPoints;
+
+  // Filter whose abort flag stops the decimation; the decimators of the
+  // pieces of a partitioned decimation check the partitioning filter.
+  vtkQuadricDecimation *AbortSource;
+
   struct ErrorQuadric
   {
     double *Quadric;
@@ -25,10 +25,14 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTriangleFilter.h"
 
+#include <algorithm>
 #include <limits>
+#include <vector>
 
 vtkStandardNewMacro(vtkSmoothPolyDataFilter);
 
@@ -129,6 +133,7 @@ vtkSmoothPolyDataFilter::vtkSmoothPolyDataFilter()
   this->GenerateErrorVectors = 0;
 
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->ParallelSmoothing = 0;
 
   this->SmoothPoints = nullptr;
 
@@ -279,6 +284,187 @@ template<typename T> void vtkSPDF_MovePoints(vtkSPDF_InternalParams<T>& params)
   vtkDebugWithObjectMacro(params.spdf, << "Performed " << iterationNumber << " smoothing passes");
 }
 
+// The connected vertices of every movable point packed into a single array
+// (CSR layout). Fixed points get an empty range.
+struct vtkSPDF_Neighbors
+{
+  std::vector<vtkIdType> Offsets;
+  std::vector<vtkIdType> Ids;
+};
+
+class vtkSPDF_CountNeighbors
+{
+public:
+  vtkMeshVertexPtr Verts;
+  vtkIdType *Offsets;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const vtkMeshVertex &vert = this->Verts[i];
+      this->Offsets[i + 1] =
+        (vert.type != VTK_FIXED_VERTEX && vert.edges != nullptr ?
+         vert.edges->GetNumberOfIds() : 0);
+    }
+  }
+};
+
+class vtkSPDF_CopyNeighbors
+{
+public:
+  vtkMeshVertexPtr Verts;
+  const vtkIdType *Offsets;
+  vtkIdType *Ids;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      vtkIdType npts = this->Offsets[i + 1] - this->Offsets[i];
+      if (npts > 0)
+      {
+        const vtkIdType *edges = this->Verts[i].edges->GetPointer(0);
+        std::copy(edges, edges + npts, this->Ids + this->Offsets[i]);
+      }
+    }
+  }
+};
+
+void vtkSPDF_BuildNeighbors(vtkMeshVertexPtr verts, vtkIdType numPts,
+                            vtkSPDF_Neighbors& neighbors)
+{
+  neighbors.Offsets.resize(numPts + 1);
+  neighbors.Offsets[0] = 0;
+
+  vtkSPDF_CountNeighbors count = { verts, &neighbors.Offsets[0] };
+  vtkSMPTools::For(0, numPts, count);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    neighbors.Offsets[i + 1] += neighbors.Offsets[i];
+  }
+
+  neighbors.Ids.resize(neighbors.Offsets[numPts]);
+  if (neighbors.Offsets[numPts] > 0)
+  {
+    vtkSPDF_CopyNeighbors copy = { verts, &neighbors.Offsets[0], &neighbors.Ids[0] };
+    vtkSMPTools::For(0, numPts, copy);
+  }
+}
+
+// One Jacobi pass: read the positions of the previous pass from X and write
+// the new positions to XNew. Points without neighbors are never written, so
+// both buffers must start out with the same coordinates.
+template<typename T> class vtkSPDF_JacobiStep
+{
+public:
+  const vtkIdType *Offsets;
+  const vtkIdType *Ids;
+  T Factor;
+  const T *X;
+  T *XNew;
+  T MaxDist;
+  vtkSMPThreadLocal<T> LocalMaxDist;
+
+  void Initialize()
+  {
+    this->LocalMaxDist.Local() = 0.0;
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    T& maxDist = this->LocalMaxDist.Local();
+    T dist, deltaX[3];
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      vtkIdType npts = this->Offsets[i + 1] - this->Offsets[i];
+      if (npts == 0)
+      {
+        continue;
+      }
+
+      const vtkIdType *edgeIdPtr = this->Ids + this->Offsets[i];
+      deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+      for (vtkIdType j = 0; j < npts; ++j)
+      {
+        const T *y = this->X + 3 * edgeIdPtr[j];
+        deltaX[0] += y[0];
+        deltaX[1] += y[1];
+        deltaX[2] += y[2];
+      }
+
+      const T *x = this->X + 3 * i;
+      T *xNew = this->XNew + 3 * i;
+      for (int k = 0; k < 3; ++k)
+      {
+        xNew[k] = x[k] + this->Factor * (deltaX[k] / npts - x[k]);
+      }
+
+      if ((dist = vtkMath::Norm(deltaX)) > maxDist)
+      {
+        maxDist = dist;
+      }
+    }
+  }
+
+  void Reduce()
+  {
+    this->MaxDist = 0.0;
+    typename vtkSMPThreadLocal<T>::iterator itr;
+    for (itr = this->LocalMaxDist.begin(); itr != this->LocalMaxDist.end(); ++itr)
+    {
+      this->MaxDist = std::max(this->MaxDist, *itr);
+    }
+  }
+};
+
+// Same as vtkSPDF_MovePoints (without source constraint), but with a
+// double-buffered update that processes the points in parallel.
+template<typename T> void vtkSPDF_MovePointsParallel(vtkSPDF_InternalParams<T>& params)
+{
+  vtkSPDF_Neighbors neighbors;
+  vtkSPDF_BuildNeighbors(params.vertexPtr, params.numPts, neighbors);
+
+  T* coords = static_cast<T*>(params.newPts->GetVoidPointer(0));
+  std::vector<T> buffer(coords, coords + 3 * params.numPts);
+
+  vtkSPDF_JacobiStep<T> step;
+  step.Offsets = &neighbors.Offsets[0];
+  step.Ids = neighbors.Ids.empty() ? nullptr : &neighbors.Ids[0];
+  step.Factor = params.factor;
+  T* x = coords;
+  T* xNew = &buffer[0];
+
+  int iterationNumber = 0;
+  for (T maxDist = std::numeric_limits<T>::max();
+       maxDist > params.conv && iterationNumber < params.numberOfIterations;
+       ++iterationNumber)
+  {
+    if (iterationNumber && !(iterationNumber % 5))
+    {
+      params.spdf->UpdateProgress(0.5 + 0.5*iterationNumber / params.numberOfIterations);
+      if (params.spdf->GetAbortExecute())
+      {
+        break;
+      }
+    }
+
+    step.X = x;
+    step.XNew = xNew;
+    vtkSMPTools::For(0, params.numPts, step);
+    maxDist = step.MaxDist;
+    std::swap(x, xNew);
+  }
+
+  // The latest positions may live in the scratch buffer.
+  if (x != coords)
+  {
+    std::copy(x, x + 3 * params.numPts, coords);
+  }
+
+  vtkDebugWithObjectMacro(params.spdf, << "Performed " << iterationNumber << " smoothing passes");
+}
+
 }// namespace
 
 int vtkSmoothPolyDataFilter::RequestData(
@@ -686,7 +872,14 @@ int vtkSmoothPolyDataFilter::RequestData(
                                               Verts, source, this->SmoothPoints,
                                               w, cellLocator };
 
-    vtkSPDF_MovePoints(params);
+    if (this->ParallelSmoothing && !source)
+    {
+      vtkSPDF_MovePointsParallel(params);
+    }
+    else
+    {
+      vtkSPDF_MovePoints(params);
+    }
   }
   else
   {
@@ -695,7 +888,14 @@ int vtkSmoothPolyDataFilter::RequestData(
                                              static_cast<float>(conv), numPts, Verts,
                                              source, this->SmoothPoints, w, cellLocator };
 
-    vtkSPDF_MovePoints(params);
+    if (this->ParallelSmoothing && !source)
+    {
+      vtkSPDF_MovePointsParallel(params);
+    }
+    else
+    {
+      vtkSPDF_MovePoints(params);
+    }
   }
 
   if ( source )
@@ -805,4 +1005,5 @@ void vtkSmoothPolyDataFilter::PrintSelf(ostream& os, vtkIndent indent)
   }
 
   os << indent << "Output Points Precision: " << this->OutputPointsPrecision << "\n";
+  os << indent << "Parallel Smoothing: " << (this->ParallelSmoothing ? "On\n" : "Off\n");
 }
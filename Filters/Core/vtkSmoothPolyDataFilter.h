@@ -77,6 +77,12 @@
  * second input: the Source. If defined, the input mesh is constrained to
  * lie on the surface defined by the Source ivar.
  *
+ * By default the points are moved in place, so a vertex already sees the
+ * new positions of the neighbors visited before it during the same pass
+ * (a Gauss-Seidel style update). Enabling ParallelSmoothing instead computes
+ * every pass from the positions of the previous pass (a Jacobi style
+ * update), which allows the points to be processed in parallel.
+ *
  *
  * @warning
  * The Laplacian operation reduces high frequency information in the geometry
@@ -215,6 +221,20 @@ public:
   vtkGetMacro(OutputPointsPrecision,int);
   //@}
 
+  //@{
+  /**
+   * Turn on/off parallel smoothing. When on, each iteration computes the new
+   * point positions from the positions of the previous iteration only, and
+   * the points are processed in parallel. The result differs slightly from
+   * the default in-place update, and more iterations may be needed for the
+   * same amount of smoothing. This option is ignored when a Source is set.
+   * Off by default.
+   */
+  vtkSetMacro(ParallelSmoothing,vtkTypeBool);
+  vtkGetMacro(ParallelSmoothing,vtkTypeBool);
+  vtkBooleanMacro(ParallelSmoothing,vtkTypeBool);
+  //@}
+
 protected:
   vtkSmoothPolyDataFilter();
   ~vtkSmoothPolyDataFilter() override {}
@@ -232,6 +252,7 @@ protected:
   vtkTypeBool GenerateErrorScalars;
   vtkTypeBool GenerateErrorVectors;
   int OutputPointsPrecision;
+  vtkTypeBool ParallelSmoothing;
 
   vtkSmoothPoints *SmoothPoints;
 private:
@@ -14,18 +14,281 @@
 =========================================================================*/
 #include "vtkTriangleFilter.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
-#include "vtkTriangleStrip.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <vector>
 
 vtkStandardNewMacro(vtkTriangleFilter);
 
+namespace
+{
+// The polygons (or strips) are triangulated in blocks of consecutive cells.
+// Each block keeps its triangles, and the input cell of each triangle,
+// until the output offsets of all the blocks are known.
+struct vtkTriangleFilterBlock
+{
+  std::vector<vtkIdType> Triangles;
+  std::vector<vtkIdType> Sources;
+};
+
+class vtkTriangleFilterTriangulate
+{
+public:
+  vtkPoints *InPts;
+  const vtkIdType *Connectivity;
+  const vtkIdType *Locations;
+  vtkIdType FirstCellId;
+  vtkIdType NumberOfCells;
+  vtkIdType BlockSize;
+  bool Strips;
+  bool FastConvex;
+  vtkTriangleFilterBlock *Blocks;
+
+  vtkSMPThreadLocalObject<vtkPolygon> Polygon;
+  vtkSMPThreadLocalObject<vtkIdList> PolygonTriangles;
+  vtkSMPThreadLocal<std::vector<double> > Coordinates;
+
+  void Initialize()
+  {
+    this->PolygonTriangles.Local()->Allocate(VTK_CELL_SIZE);
+  }
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType blockId = beginBlock; blockId < endBlock; ++blockId)
+    {
+      vtkTriangleFilterBlock &block = this->Blocks[blockId];
+      vtkIdType begin = blockId * this->BlockSize;
+      vtkIdType end = std::min(begin + this->BlockSize, this->NumberOfCells);
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        const vtkIdType *cell = this->Connectivity + this->Locations[cellId];
+        vtkIdType npts = cell[0];
+        const vtkIdType *pts = cell + 1;
+        size_t numTriangles = block.Triangles.size();
+        if (this->Strips)
+        {
+          this->DecomposeStrip(npts, pts, block.Triangles);
+        }
+        else if (npts == 3)
+        {
+          block.Triangles.insert(block.Triangles.end(), pts, pts + 3);
+        }
+        else if (npts > 0 &&
+                 !(this->FastConvex && this->TriangulateConvex(npts, pts,
+                                                               block.Triangles)))
+        {
+          this->EarCut(npts, pts, block.Triangles);
+        }
+        numTriangles = (block.Triangles.size() - numTriangles) / 3;
+        block.Sources.insert(block.Sources.end(), numTriangles,
+                             this->FirstCellId + cellId);
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+
+  // Same triangles, in the same order, as vtkTriangleStrip::DecomposeStrip().
+  void DecomposeStrip(vtkIdType npts, const vtkIdType *pts,
+                      std::vector<vtkIdType> &triangles)
+  {
+    if (npts < 3)
+    {
+      return;
+    }
+    vtkIdType p1 = pts[0], p2 = pts[1], p3;
+    for (vtkIdType i = 0; i < (npts - 2); i++)
+    {
+      p3 = pts[i + 2];
+      if ((i % 2)) // flip ordering to preserve consistency
+      {
+        triangles.push_back(p2);
+        triangles.push_back(p1);
+      }
+      else
+      {
+        triangles.push_back(p1);
+        triangles.push_back(p2);
+      }
+      triangles.push_back(p3);
+      p1 = p2;
+      p2 = p3;
+    }
+  }
+
+  void EarCut(vtkIdType npts, const vtkIdType *pts,
+              std::vector<vtkIdType> &triangles)
+  {
+    vtkPolygon *poly = this->Polygon.Local();
+    vtkIdList *ptIds = this->PolygonTriangles.Local();
+    double x[3];
+    poly->PointIds->SetNumberOfIds(npts);
+    poly->Points->SetNumberOfPoints(npts);
+    for (vtkIdType i = 0; i < npts; i++)
+    {
+      poly->PointIds->SetId(i, pts[i]);
+      this->InPts->GetPoint(pts[i], x);
+      poly->Points->SetPoint(i, x);
+    }
+    poly->Triangulate(ptIds);
+    vtkIdType numSimplices = ptIds->GetNumberOfIds() / 3;
+    for (vtkIdType i = 0; i < 3 * numSimplices; i++)
+    {
+      triangles.push_back(pts[ptIds->GetId(i)]);
+    }
+  }
+
+  // Triangulates a strictly convex polygon without ear-cutting. Returns
+  // false (and adds nothing) if the polygon is not strictly convex.
+  bool TriangulateConvex(vtkIdType npts, const vtkIdType *pts,
+                         std::vector<vtkIdType> &triangles)
+  {
+    if (npts < 4)
+    {
+      return false;
+    }
+    std::vector<double> &x = this->Coordinates.Local();
+    x.resize(3 * npts);
+    for (vtkIdType i = 0; i < npts; i++)
+    {
+      this->InPts->GetPoint(pts[i], &x[3 * i]);
+    }
+
+    // Newell normal, then every corner must turn the same way around it.
+    double normal[3] = { 0.0, 0.0, 0.0 };
+    for (vtkIdType i = 0; i < npts; i++)
+    {
+      const double *p = &x[3 * i];
+      const double *q = &x[3 * ((i + 1) % npts)];
+      normal[0] += (p[1] - q[1]) * (p[2] + q[2]);
+      normal[1] += (p[2] - q[2]) * (p[0] + q[0]);
+      normal[2] += (p[0] - q[0]) * (p[1] + q[1]);
+    }
+    for (vtkIdType i = 0; i < npts; i++)
+    {
+      const double *p0 = &x[3 * ((i + npts - 1) % npts)];
+      const double *p1 = &x[3 * i];
+      const double *p2 = &x[3 * ((i + 1) % npts)];
+      double e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+      double e2[3] = { p2[0] - p1[0], p2[1] - p1[1], p2[2] - p1[2] };
+      double c[3];
+      vtkMath::Cross(e1, e2, c);
+      if (vtkMath::Dot(c, normal) <= 0.0)
+      {
+        return false;
+      }
+    }
+
+    if (npts == 4)
+    {
+      // Split along the shortest diagonal.
+      vtkIdType i0 = 0;
+      if (vtkMath::Distance2BetweenPoints(&x[3], &x[9]) <
+          vtkMath::Distance2BetweenPoints(&x[0], &x[6]))
+      {
+        i0 = 1;
+      }
+      const vtkIdType tris[6] = { i0, i0 + 1, i0 + 2, i0, i0 + 2,
+                                  (i0 + 3) % 4 };
+      for (int i = 0; i < 6; i++)
+      {
+        triangles.push_back(pts[tris[i]]);
+      }
+      return true;
+    }
+
+    for (vtkIdType i = 1; i < (npts - 1); i++)
+    {
+      triangles.push_back(pts[0]);
+      triangles.push_back(pts[i]);
+      triangles.push_back(pts[i + 1]);
+    }
+    return true;
+  }
+};
+
+// Writes the triangles of the blocks into the output cell array.
+struct vtkTriangleFilterFill
+{
+  std::vector<vtkTriangleFilterBlock> *Blocks;
+  const vtkIdType *Offsets;
+  vtkIdType *Polys;
+  vtkIdType *Sources;
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType blockId = beginBlock; blockId < endBlock; ++blockId)
+    {
+      const vtkTriangleFilterBlock &block = (*this->Blocks)[blockId];
+      vtkIdType *polys = this->Polys + 4 * this->Offsets[blockId];
+      for (size_t i = 0; i < block.Triangles.size(); i += 3)
+      {
+        *polys++ = 3;
+        *polys++ = block.Triangles[i];
+        *polys++ = block.Triangles[i + 1];
+        *polys++ = block.Triangles[i + 2];
+      }
+      std::copy(block.Sources.begin(), block.Sources.end(),
+                this->Sources + this->Offsets[blockId]);
+    }
+  }
+};
+
+// Triangulates the cells of a polygon or strip cell array, in parallel, and
+// appends the triangles and their input cells at the end of the lists.
+void vtkTriangleFilterTriangulateCells(vtkPoints *inPts, vtkCellArray *cells,
+                                       vtkIdType firstCellId, bool strips,
+                                       bool fastConvex,
+                                       std::vector<vtkTriangleFilterBlock> &blocks)
+{
+  vtkIdType numCells = cells->GetNumberOfCells();
+  std::vector<vtkIdType> locations(numCells);
+  const vtkIdType *connectivity = cells->GetPointer();
+  for (vtkIdType cellId = 0, loc = 0; cellId < numCells; ++cellId)
+  {
+    locations[cellId] = loc;
+    loc += connectivity[loc] + 1;
+  }
+
+  vtkIdType numBlocks = 4 * vtkSMPTools::GetEstimatedNumberOfThreads();
+  numBlocks = std::max<vtkIdType>(1, std::min(numBlocks, numCells / 1024));
+  size_t firstBlock = blocks.size();
+  blocks.resize(firstBlock + numBlocks);
+
+  vtkTriangleFilterTriangulate triangulate;
+  triangulate.InPts = inPts;
+  triangulate.Connectivity = connectivity;
+  triangulate.Locations = &locations[0];
+  triangulate.FirstCellId = firstCellId;
+  triangulate.NumberOfCells = numCells;
+  triangulate.BlockSize = (numCells + numBlocks - 1) / numBlocks;
+  triangulate.Strips = strips;
+  triangulate.FastConvex = fastConvex;
+  triangulate.Blocks = &blocks[firstBlock];
+  vtkSMPTools::For(0, numBlocks, 1, triangulate);
+}
+}
+
 int vtkTriangleFilter::RequestData(
   vtkInformation *vtkNotUsed(request),
   vtkInformationVector **inputVector,
@@ -43,10 +306,9 @@ int vtkTriangleFilter::RequestData(
 
   vtkIdType numCells=input->GetNumberOfCells();
   vtkIdType cellNum=0;
-  vtkIdType numPts, newId;
   vtkIdType npts = 0;
   vtkIdType *pts = nullptr;
-  int i, j;
+  int i;
   vtkCellData *inCD=input->GetCellData();
   vtkCellData *outCD=output->GetCellData();
   vtkIdType updateInterval;
@@ -55,7 +317,10 @@ int vtkTriangleFilter::RequestData(
 
   int abort=0;
   updateInterval = numCells/100 + 1;
-  outCD->CopyAllocate(inCD,numCells);
+
+  // The input cell of every output cell, for copying the cell data.
+  std::vector<vtkIdType> sources;
+  sources.reserve(numCells);
 
   // Do each of the verts, lines, polys, and strips separately
   // verts
@@ -64,7 +329,6 @@ int vtkTriangleFilter::RequestData(
     cells = input->GetVerts();
     if ( this->PassVerts )
     {
-      newId = output->GetNumberOfCells();
       newCells = vtkCellArray::New();
       newCells->EstimateSize(cells->GetNumberOfCells(),1);
       for (cells->InitTraversal(); cells->GetNextCell(npts,pts) && !abort; cellNum++)
@@ -79,13 +343,13 @@ int vtkTriangleFilter::RequestData(
           for (i=0; i<npts; i++)
           {
             newCells->InsertNextCell(1,pts+i);
-            outCD->CopyData(inCD, cellNum, newId++);
+            sources.push_back(cellNum);
           }
         }
         else
         {
           newCells->InsertNextCell(1,pts);
-          outCD->CopyData(inCD, cellNum, newId++);
+          sources.push_back(cellNum);
         }
       }
       output->SetVerts(newCells);
@@ -103,7 +367,6 @@ int vtkTriangleFilter::RequestData(
     cells = input->GetLines();
     if ( this->PassLines )
     {
-      newId = output->GetNumberOfCells();
       newCells = vtkCellArray::New();
       newCells->EstimateSize(cells->GetNumberOfCells(),2);
       for (cells->InitTraversal(); cells->GetNextCell(npts,pts) && !abort; cellNum++)
@@ -118,13 +381,13 @@ int vtkTriangleFilter::RequestData(
           for (i=0; i<(npts-1); i++)
           {
             newCells->InsertNextCell(2,pts+i);
-            outCD->CopyData(inCD, cellNum, newId++);
+            sources.push_back(cellNum);
           }
         }
         else
         {
           newCells->InsertNextCell(2,pts);
-          outCD->CopyData(inCD, cellNum, newId++);
+          sources.push_back(cellNum);
         }
       }//for all lines
       output->SetLines(newCells);
@@ -136,95 +399,59 @@ int vtkTriangleFilter::RequestData(
     }
   }
 
-  vtkCellArray *newPolys=nullptr;
+  // polys and strips: triangulate in parallel, then gather the triangles
+  std::vector<vtkTriangleFilterBlock> blocks;
   if ( !abort && input->GetPolys()->GetNumberOfCells() > 0 )
   {
-    cells = input->GetPolys();
-    newId = output->GetNumberOfCells();
-    newPolys = vtkCellArray::New();
-    newPolys->EstimateSize(cells->GetNumberOfCells(),3);
-    output->SetPolys(newPolys);
-    vtkIdList *ptIds = vtkIdList::New();
-    ptIds->Allocate(VTK_CELL_SIZE);
-    int numSimplices;
-    vtkPolygon *poly=vtkPolygon::New();
-    vtkIdType triPts[3];
-
-    for (cells->InitTraversal(); cells->GetNextCell(npts,pts) && !abort; cellNum++)
-    {
-      if ( ! (cellNum % updateInterval) ) //manage progress reports / early abort
-      {
-        this->UpdateProgress ((float)cellNum / numCells);
-        abort = this->GetAbortExecute();
-      }
-      if ( npts ==  0 )
-      {
-        continue;
-      }
-      if ( npts == 3 )
-      {
-        newPolys->InsertNextCell(3,pts);
-        outCD->CopyData(inCD, cellNum, newId++);
-      }
-      else //triangulate polygon
-      {
-        //initialize polygon
-        poly->PointIds->SetNumberOfIds(npts);
-        poly->Points->SetNumberOfPoints(npts);
-        for (i=0; i<npts; i++)
-        {
-          poly->PointIds->SetId(i,pts[i]);
-          poly->Points->SetPoint(i,inPts->GetPoint(pts[i]));
-        }
-        poly->Triangulate(ptIds);
-        numPts = ptIds->GetNumberOfIds();
-        numSimplices = numPts / 3;
-        for ( i=0; i < numSimplices; i++ )
-        {
-          for (j=0; j<3; j++)
-          {
-            triPts[j] = poly->PointIds->GetId(ptIds->GetId(3*i+j));
-          }
-          newPolys->InsertNextCell(3, triPts);
-          outCD->CopyData(inCD, cellNum, newId++);
-        }//for each simplex
-      }//triangulate polygon
-    }
-    ptIds->Delete();
-    poly->Delete();
+    vtkTriangleFilterTriangulateCells(inPts, input->GetPolys(), cellNum,
+                                      false, this->FastConvexTriangulation != 0,
+                                      blocks);
+    this->UpdateProgress(0.5);
+    abort = this->GetAbortExecute();
   }
+  cellNum += input->GetPolys()->GetNumberOfCells();
 
-  //strips
   if ( !abort && input->GetStrips()->GetNumberOfCells() > 0 )
   {
-    cells = input->GetStrips();
-    newId = output->GetNumberOfCells();
-    if ( newPolys == nullptr )
-    {
-      newPolys = vtkCellArray::New();
-      newPolys->EstimateSize(cells->GetNumberOfCells(),3);
-      output->SetPolys(newPolys);
-    }
-    for (cells->InitTraversal(); cells->GetNextCell(npts,pts) && !abort; cellNum++)
-    {
-      if ( ! (cellNum % updateInterval) ) //manage progress reports / early abort
-      {
-        this->UpdateProgress ((float)cellNum / numCells);
-        abort = this->GetAbortExecute();
-      }
-      vtkTriangleStrip::DecomposeStrip(npts,pts,newPolys);
-      for (i=0; i<(npts-2); i++)
-      {
-        outCD->CopyData(inCD, cellNum, newId++);
-      }
-    }//for all strips
+    vtkTriangleFilterTriangulateCells(inPts, input->GetStrips(), cellNum,
+                                      true, false, blocks);
+    this->UpdateProgress(0.75);
+    abort = this->GetAbortExecute();
   }
 
-  if ( newPolys != nullptr )
+  if ( !blocks.empty() )
   {
+    std::vector<vtkIdType> offsets(blocks.size());
+    vtkIdType numTriangles = 0;
+    for (size_t blockId = 0; blockId < blocks.size(); ++blockId)
+    {
+      offsets[blockId] = numTriangles;
+      numTriangles += static_cast<vtkIdType>(blocks[blockId].Sources.size());
+    }
+
+    vtkNew<vtkIdTypeArray> polys;
+    polys->SetNumberOfValues(4 * numTriangles);
+    vtkIdType firstTriangle = static_cast<vtkIdType>(sources.size());
+    sources.resize(firstTriangle + numTriangles);
+
+    vtkTriangleFilterFill fill;
+    fill.Blocks = &blocks;
+    fill.Offsets = &offsets[0];
+    fill.Polys = polys->GetPointer(0);
+    fill.Sources = &sources[0] + firstTriangle;
+    vtkSMPTools::For(0, static_cast<vtkIdType>(blocks.size()), 1, fill);
+
+    vtkCellArray *newPolys = vtkCellArray::New();
+    newPolys->SetCells(numTriangles, polys);
+    output->SetPolys(newPolys);
     newPolys->Delete();
   }
 
+  // Copy the cell data of the output cells
+  vtkIdType numNewCells = static_cast<vtkIdType>(sources.size());
+  outCD->CopyAllocate(inCD,numNewCells);
+  ArrayList::GatherTuples(inCD, outCD, sources.data(), numNewCells);
+
   // Update output
   output->SetPoints(input->GetPoints());
   output->GetPointData()->PassData(input->GetPointData());
@@ -245,5 +472,7 @@ void vtkTriangleFilter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Pass Verts: " << (this->PassVerts ? "On\n" : "Off\n");
   os << indent << "Pass Lines: " << (this->PassLines ? "On\n" : "Off\n");
+  os << indent << "Fast Convex Triangulation: "
+     << (this->FastConvexTriangulation ? "On\n" : "Off\n");
 
 }
@@ -20,6 +20,9 @@
  * strips.  It also generates line segments from polylines unless PassLines
  * is off, and generates individual vertex cells from vtkVertex point lists
  * unless PassVerts is off.
+ *
+ * Polygons and triangle strips are triangulated in parallel (using
+ * vtkSMPTools), in blocks of consecutive cells.
 */
 
 #ifndef vtkTriangleFilter_h
@@ -59,8 +62,22 @@ public:
   vtkGetMacro(PassLines,vtkTypeBool);
   //@}
 
+  //@{
+  /**
+   * Turn on/off the direct triangulation of convex polygons (default: off).
+   * If this is on, convex quads are split along their shortest diagonal and
+   * other convex polygons are triangulated as a fan around their first
+   * point, instead of being ear-cut. This is much faster, but the triangles
+   * may differ from the ear-cut ones. Nonconvex polygons are always ear-cut.
+   */
+  vtkBooleanMacro(FastConvexTriangulation,vtkTypeBool);
+  vtkSetMacro(FastConvexTriangulation,vtkTypeBool);
+  vtkGetMacro(FastConvexTriangulation,vtkTypeBool);
+  //@}
+
 protected:
-  vtkTriangleFilter() : PassVerts(1), PassLines(1) {}
+  vtkTriangleFilter() : PassVerts(1), PassLines(1),
+                        FastConvexTriangulation(0) {}
   ~vtkTriangleFilter() override {}
 
   // Usual data generation method
@@ -68,6 +85,7 @@ protected:
 
   vtkTypeBool PassVerts;
   vtkTypeBool PassLines;
+  vtkTypeBool FastConvexTriangulation;
 private:
   vtkTriangleFilter(const vtkTriangleFilter&) = delete;
   void operator=(const vtkTriangleFilter&) = delete;
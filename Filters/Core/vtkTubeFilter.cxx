@@ -14,18 +14,27 @@
 =========================================================================*/
 #include "vtkTubeFilter.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkMath.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolyLine.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 
 #include <algorithm>
+#include <utility>
+#include <vector>
 
 
 vtkStandardNewMacro(vtkTubeFilter);
@@ -81,9 +90,212 @@ struct IdPointsEqual
 
   vtkPoints *Points;
 };
-
 }
 
+// Polyline data shared by the planning and generation passes. Each polyline
+// owns the slice of Ids and Normals that starts at its location in the
+// input cell array, so the polylines can be processed independently.
+struct vtkTubeFilterLines
+{
+  vtkPoints *InPts;
+  const vtkIdType *Connectivity;
+  std::vector<vtkIdType> Locations;
+  std::vector<vtkIdType> Ids;
+  std::vector<double> Normals;
+  std::vector<vtkIdType> NumberOfPoints;
+  std::vector<int> Status;
+  std::vector<vtkIdType> PointOffsets;
+  std::vector<vtkIdType> StripOffsets;
+  std::vector<vtkIdType> CellOffsets;
+
+  vtkIdType *GetIds(vtkIdType lineId)
+  {
+    return &this->Ids[this->Locations[lineId] + 1];
+  }
+  double *GetNormals(vtkIdType lineId)
+  {
+    return &this->Normals[3 * (this->Locations[lineId] + 1)];
+  }
+};
+
+// First pass: removes the degenerate points of the polylines, computes their
+// normals, and checks whether they can be tubed.
+class vtkTubeFilterPlanLines
+{
+public:
+  vtkTubeFilter *Filter;
+  vtkTubeFilterLines *Lines;
+  vtkDataArray *InNormals; // nullptr if the normals are generated
+  vtkDataArray *InScalars;
+  vtkDataArray *InVectors;
+  double *Range;
+  double MaxSpeed;
+
+  vtkSMPThreadLocalObject<vtkPoints> LinePoints;
+  vtkSMPThreadLocalObject<vtkCellArray> LineCells;
+  vtkSMPThreadLocalObject<vtkFloatArray> LineNormals;
+  vtkSMPThreadLocal<std::vector<std::pair<vtkIdType, vtkIdType> > > Sorted;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > LocalIds;
+
+  void Initialize()
+  {
+    this->LinePoints.Local()->SetDataTypeToDouble();
+    this->LineNormals.Local()->SetNumberOfComponents(3);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkPoints *inPts = this->Lines->InPts;
+    for (vtkIdType lineId = begin; lineId < end; ++lineId)
+    {
+      const vtkIdType *line =
+        this->Lines->Connectivity + this->Lines->Locations[lineId];
+      vtkIdType *pts = this->Lines->GetIds(lineId);
+      std::copy(line + 1, line + 1 + line[0], pts);
+
+      // remove degenerate lines to avoid warnings
+      vtkIdType npts = static_cast<vtkIdType>(
+        std::unique(pts, pts + line[0], IdPointsEqual(inPts)) - pts);
+      this->Lines->NumberOfPoints[lineId] = npts;
+      if (npts < 2)
+      {
+        continue; //skip tubing this polyline
+      }
+
+      double *normals = this->Lines->GetNormals(lineId);
+      if (this->InNormals)
+      {
+        for (vtkIdType j = 0; j < npts; ++j)
+        {
+          this->InNormals->GetTuple(pts[j], normals + 3 * j);
+        }
+      }
+      else
+      {
+        this->GenerateNormals(npts, pts, normals);
+      }
+
+      this->Lines->Status[lineId] = this->Filter->GeneratePoints(
+        0, npts, pts, inPts, nullptr, nullptr, this->InScalars, this->Range,
+        this->InVectors, this->MaxSpeed, normals);
+    }
+  }
+
+  void Reduce()
+  {
+  }
+
+  // Each polyline calculates its normals independently, avoiding conflicts
+  // at shared vertices. The normals are generated per point id, so a point
+  // repeated in the polyline (e.g. a closed loop) gets the same normal at
+  // all its occurrences; repeated points share a local id to preserve this.
+  void GenerateNormals(vtkIdType npts, const vtkIdType *pts, double *normals)
+  {
+    std::vector<std::pair<vtkIdType, vtkIdType> > &sorted =
+      this->Sorted.Local();
+    std::vector<vtkIdType> &localIds = this->LocalIds.Local();
+    sorted.resize(npts);
+    localIds.resize(npts);
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      sorted[j] = std::make_pair(pts[j], j);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      localIds[sorted[j].second] =
+        (j > 0 && sorted[j].first == sorted[j - 1].first) ?
+        localIds[sorted[j - 1].second] : sorted[j].second;
+    }
+
+    vtkPoints *points = this->LinePoints.Local();
+    points->SetNumberOfPoints(npts);
+    double x[3];
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      this->Lines->InPts->GetPoint(pts[j], x);
+      points->SetPoint(j, x);
+    }
+    vtkCellArray *cells = this->LineCells.Local();
+    cells->Reset();
+    cells->InsertNextCell(npts, &localIds[0]);
+    vtkFloatArray *lineNormals = this->LineNormals.Local();
+    lineNormals->SetNumberOfTuples(npts);
+    vtkPolyLine::GenerateSlidingNormals(points, cells, lineNormals);
+
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      lineNormals->GetTuple(localIds[j], normals + 3 * j);
+    }
+  }
+};
+
+// Second pass: generates the tubes of the valid polylines at their offsets
+// in the output, and records the input point and cell each output point and
+// cell comes from.
+class vtkTubeFilterGenerateLines
+{
+public:
+  vtkTubeFilter *Filter;
+  vtkTubeFilterLines *Lines;
+  vtkDataArray *InScalars;
+  vtkDataArray *InVectors;
+  double *Range;
+  double MaxSpeed;
+  vtkIdType FirstCellId;
+  vtkPoints *NewPts;
+  vtkFloatArray *NewNormals;
+  vtkFloatArray *NewTCoords;
+  vtkIdType *Strips;
+  vtkIdType *PointSources;
+  vtkIdType *CellSources;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkTubeFilter *self = this->Filter;
+    int numSides = self->SidesShareVertices ?
+      self->NumberOfSides : 2 * self->NumberOfSides;
+    vtkIdType numCells = self->ComputeNumberOfStrips() +
+      (self->Capping ? 2 : 0);
+
+    for (vtkIdType lineId = begin; lineId < end; ++lineId)
+    {
+      vtkIdType npts = this->Lines->NumberOfPoints[lineId];
+      if (npts < 2 || this->Lines->Status[lineId] != vtkTubeFilter::VALID_LINE)
+      {
+        continue;
+      }
+      vtkIdType *pts = this->Lines->GetIds(lineId);
+      vtkIdType offset = this->Lines->PointOffsets[lineId];
+
+      self->GeneratePoints(offset, npts, pts, this->Lines->InPts, this->NewPts,
+                           this->NewNormals, this->InScalars, this->Range,
+                           this->InVectors, this->MaxSpeed,
+                           this->Lines->GetNormals(lineId));
+      self->GenerateStrips(offset, npts,
+                           this->Strips + this->Lines->StripOffsets[lineId]);
+      if (this->NewTCoords)
+      {
+        self->GenerateTextureCoords(offset, npts, pts, this->Lines->InPts,
+                                    this->InScalars, this->NewTCoords);
+      }
+
+      vtkIdType *sources = this->PointSources + offset;
+      for (vtkIdType j = 0; j < npts; ++j)
+      {
+        sources = std::fill_n(sources, numSides, pts[j]);
+      }
+      if (self->Capping)
+      {
+        sources = std::fill_n(sources, self->NumberOfSides, pts[0]);
+        std::fill_n(sources, self->NumberOfSides, pts[npts - 1]);
+      }
+      std::fill_n(this->CellSources + this->Lines->CellOffsets[lineId],
+                  numCells, this->FirstCellId + lineId);
+    }
+  }
+};
+
 int vtkTubeFilter::RequestData(
   vtkInformation *vtkNotUsed(request),
   vtkInformationVector **inputVector,
@@ -111,18 +323,13 @@ int vtkTubeFilter::RequestData(
   vtkPoints *inPts;
   vtkIdType numPts;
   vtkIdType numLines;
-  vtkIdType numNewPts, numNewCells;
+  vtkIdType numNewPts, numNewCells, stripsSize;
   vtkPoints *newPts;
-  int deleteNormals=0;
   vtkFloatArray *newNormals;
   vtkIdType i;
   double range[2], maxSpeed=0;
   vtkCellArray *newStrips;
-  vtkIdType npts=0, *pts=nullptr;
-  vtkIdType offset=0;
   vtkFloatArray *newTCoords=nullptr;
-  int abort=0;
-  vtkIdType inCellId;
   double oldRadius=1.0;
 
   // Check input and initialize
@@ -137,68 +344,22 @@ int vtkTubeFilter::RequestData(
     return 1;
   }
 
-  // Create the geometry and topology
-  numNewPts = numPts * this->NumberOfSides;
-  newPts = vtkPoints::New();
-
-  // Set the desired precision for the points in the output.
-  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
-  {
-    newPts->SetDataType(inPts->GetDataType());
-  }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
-  {
-    newPts->SetDataType(VTK_FLOAT);
-  }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
-  {
-    newPts->SetDataType(VTK_DOUBLE);
-  }
-
-  newPts->Allocate(numNewPts);
-  newNormals = vtkFloatArray::New();
-  newNormals->SetName("TubeNormals");
-  newNormals->SetNumberOfComponents(3);
-  newNormals->Allocate(3*numNewPts);
-  newStrips = vtkCellArray::New();
-  newStrips->Allocate(newStrips->EstimateSize(1,numNewPts));
-  vtkCellArray *singlePolyline = vtkCellArray::New();
-
-  // Point data: copy scalars, vectors, tcoords. Normals may be computed here.
-  outPD->CopyNormalsOff();
-  if ( (this->GenerateTCoords == VTK_TCOORDS_FROM_SCALARS && inScalars) ||
-       this->GenerateTCoords == VTK_TCOORDS_FROM_LENGTH ||
-       this->GenerateTCoords == VTK_TCOORDS_FROM_NORMALIZED_LENGTH )
-  {
-    newTCoords = vtkFloatArray::New();
-    newTCoords->SetNumberOfComponents(2);
-    newTCoords->Allocate(numNewPts);
-    outPD->CopyTCoordsOff();
-  }
-  outPD->CopyAllocate(pd,numNewPts);
-
-  int generateNormals = 0;
+  // Normals are only used if present and not overridden; otherwise they are
+  // either the default normal or generated for each polyline.
+  vtkNew<vtkFloatArray> defaultNormals;
   if ( !(inNormals=pd->GetNormals()) || this->UseDefaultNormal )
   {
-    deleteNormals = 1;
-    inNormals = vtkFloatArray::New();
-    inNormals->SetNumberOfComponents(3);
-    inNormals->SetNumberOfTuples(numPts);
-
+    inNormals = nullptr;
     if ( this->UseDefaultNormal )
     {
+      inNormals = defaultNormals;
+      defaultNormals->SetNumberOfComponents(3);
+      defaultNormals->SetNumberOfTuples(numPts);
       for ( i=0; i < numPts; i++)
       {
-        inNormals->SetTuple(i,this->DefaultNormal);
+        defaultNormals->SetTuple(i,this->DefaultNormal);
       }
     }
-    else
-    {
-      // Normal generation has been moved to lower in the function.
-      // This allows each different polylines to share vertices, but have
-      // their normals (and hence their tubes) calculated independently
-      generateNormals = 1;
-    }
   }
 
   // If varying width, get appropriate info.
@@ -229,71 +390,165 @@ int vtkTubeFilter::RequestData(
   {
     maxSpeed = inVectors->GetMaxNorm();
   }
+  this->Theta = 2.0*vtkMath::Pi() / this->NumberOfSides;
 
-  // Copy selected parts of cell data; certainly don't want normals
+  // Locate the polylines in the input cell array, then check them (in
+  // parallel) to find out which ones can be tubed.
   //
-  numNewCells = inLines->GetNumberOfCells() * this->NumberOfSides + 2;
-  outCD->CopyNormalsOff();
-  outCD->CopyAllocate(cd,numNewCells);
+  vtkTubeFilterLines lines;
+  lines.InPts = inPts;
+  lines.Connectivity = inLines->GetPointer();
+  lines.Locations.resize(numLines);
+  for (vtkIdType lineId = 0, loc = 0; lineId < numLines; ++lineId)
+  {
+    lines.Locations[lineId] = loc;
+    loc += lines.Connectivity[loc] + 1;
+  }
+  vtkIdType connSize = inLines->GetNumberOfConnectivityEntries();
+  lines.Ids.resize(connSize);
+  lines.Normals.resize(3 * connSize);
+  lines.NumberOfPoints.resize(numLines);
+  lines.Status.resize(numLines);
+
+  vtkTubeFilterPlanLines plan;
+  plan.Filter = this;
+  plan.Lines = &lines;
+  plan.InNormals = inNormals;
+  plan.InScalars = inScalars;
+  plan.InVectors = inVectors;
+  plan.Range = range;
+  plan.MaxSpeed = maxSpeed;
+  vtkSMPTools::For(0, numLines, plan);
+  this->UpdateProgress(0.5);
+  if (this->GetAbortExecute())
+  {
+    if (this->VaryRadius == VTK_VARY_RADIUS_BY_ABSOLUTE_SCALAR)
+    {
+      this->Radius = oldRadius;
+    }
+    return 1;
+  }
 
-  //  Create points along each polyline that are connected into NumberOfSides
-  //  triangle strips. Texture coordinates are optionally generated.
+  // Compute the exact size of the output: each valid polyline is given its
+  // range of points, strips and cells, in polyline order.
   //
-  this->Theta = 2.0*vtkMath::Pi() / this->NumberOfSides;
-  vtkPolyLine *lineNormalGenerator = vtkPolyLine::New();
-  // the line cellIds start after the last vert cellId
-  inCellId = input->GetNumberOfVerts();
-  for (inLines->InitTraversal();
-       inLines->GetNextCell(npts,pts) && !abort; inCellId++)
-  {
-    this->UpdateProgress((double)inCellId/numLines);
-    abort = this->GetAbortExecute();
-
-    // remove degenerate lines to avoid warnings
-    npts = static_cast<vtkIdType>(std::unique(pts, pts + npts, IdPointsEqual(inPts)) -
-           pts);
+  vtkIdType numStrips = this->ComputeNumberOfStrips();
+  lines.PointOffsets.resize(numLines);
+  lines.StripOffsets.resize(numLines);
+  lines.CellOffsets.resize(numLines);
+  numNewPts = numNewCells = stripsSize = 0;
+  for (vtkIdType lineId = 0; lineId < numLines; ++lineId)
+  {
+    vtkIdType npts = lines.NumberOfPoints[lineId];
     if (npts < 2)
     {
       continue; //skip tubing this polyline
     }
-
-    // If necessary calculate normals, each polyline calculates its
-    // normals independently, avoiding conflicts at shared vertices.
-    if (generateNormals)
+    switch (lines.Status[lineId])
     {
-      singlePolyline->Reset(); //avoid instantiation
-      singlePolyline->InsertNextCell(npts,pts);
-      lineNormalGenerator->GenerateSlidingNormals(inPts,singlePolyline, inNormals);
+      case VALID_LINE:
+        break;
+      case COINCIDENT_POINTS:
+        vtkWarningMacro(<<"Coincident points!");
+        break;
+      case BAD_NORMAL:
+        vtkWarningMacro(<<"Bad normal!");
+        break;
+      case NEGATIVE_SCALAR:
+        vtkWarningMacro(<<"Scalar value less than zero, skipping line");
+        break;
     }
-
-    // Generate the points around the polyline. The tube is not stripped
-    // if the polyline is bad.
-    //
-    if ( !this->GeneratePoints(offset,npts,pts,inPts,newPts,pd,outPD,
-                               newNormals,inScalars,range,inVectors,
-                               maxSpeed,inNormals) )
+    if (lines.Status[lineId] != VALID_LINE)
     {
       vtkWarningMacro(<< "Could not generate points!");
       continue; //skip tubing this polyline
     }
-
-    // Generate the strips for this polyline (including caps)
-    //
-    this->GenerateStrips(offset,npts,pts,inCellId,cd,outCD,newStrips);
-
-    // Generate the texture coordinates for this polyline
-    //
-    if ( newTCoords )
+    lines.PointOffsets[lineId] = numNewPts;
+    lines.StripOffsets[lineId] = stripsSize;
+    lines.CellOffsets[lineId] = numNewCells;
+    numNewPts = this->ComputeOffset(numNewPts,npts);
+    stripsSize += numStrips * (1 + 2*npts);
+    numNewCells += numStrips;
+    if (this->Capping)
     {
-      this->GenerateTextureCoords(offset,npts,pts,inPts,inScalars,newTCoords);
+      stripsSize += 2 * (1 + this->NumberOfSides);
+      numNewCells += 2;
     }
+  }
+
+  // Create the geometry and topology
+  newPts = vtkPoints::New();
+
+  // Set the desired precision for the points in the output.
+  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
+  {
+    newPts->SetDataType(inPts->GetDataType());
+  }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_FLOAT);
+  }
+  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
+  {
+    newPts->SetDataType(VTK_DOUBLE);
+  }
 
-    // Compute the new offset for the next polyline
-    offset = this->ComputeOffset(offset,npts);
+  newPts->SetNumberOfPoints(numNewPts);
+  newNormals = vtkFloatArray::New();
+  newNormals->SetName("TubeNormals");
+  newNormals->SetNumberOfComponents(3);
+  newNormals->SetNumberOfTuples(numNewPts);
+  vtkNew<vtkIdTypeArray> strips;
+  strips->SetNumberOfValues(stripsSize);
+  newStrips = vtkCellArray::New();
+  newStrips->SetCells(numNewCells, strips);
 
-  }//for all polylines
+  // Point data: copy scalars, vectors, tcoords. Normals may be computed here.
+  outPD->CopyNormalsOff();
+  if ( (this->GenerateTCoords == VTK_TCOORDS_FROM_SCALARS && inScalars) ||
+       this->GenerateTCoords == VTK_TCOORDS_FROM_LENGTH ||
+       this->GenerateTCoords == VTK_TCOORDS_FROM_NORMALIZED_LENGTH )
+  {
+    newTCoords = vtkFloatArray::New();
+    newTCoords->SetNumberOfComponents(2);
+    newTCoords->SetNumberOfTuples(numNewPts);
+    outPD->CopyTCoordsOff();
+  }
+  outPD->CopyAllocate(pd,numNewPts);
 
-  singlePolyline->Delete();
+  // Copy selected parts of cell data; certainly don't want normals
+  //
+  outCD->CopyNormalsOff();
+  outCD->CopyAllocate(cd,numNewCells);
+
+  //  Create points along each polyline that are connected into NumberOfSides
+  //  triangle strips. Texture coordinates are optionally generated.
+  //
+  vtkNew<vtkIdList> pointSources;
+  pointSources->SetNumberOfIds(numNewPts);
+  vtkNew<vtkIdList> cellSources;
+  cellSources->SetNumberOfIds(numNewCells);
+  {
+    vtkTubeFilterGenerateLines generate;
+    generate.Filter = this;
+    generate.Lines = &lines;
+    generate.InScalars = inScalars;
+    generate.InVectors = inVectors;
+    generate.Range = range;
+    generate.MaxSpeed = maxSpeed;
+    // the line cellIds start after the last vert cellId
+    generate.FirstCellId = input->GetNumberOfVerts();
+    generate.NewPts = newPts;
+    generate.NewNormals = newNormals;
+    generate.NewTCoords = newTCoords;
+    generate.Strips = strips->GetPointer(0);
+    generate.PointSources = pointSources->GetPointer(0);
+    generate.CellSources = cellSources->GetPointer(0);
+    vtkSMPTools::For(0, numLines, generate);
+
+    ArrayList::GatherTuples(pd, outPD, pointSources->GetPointer(0), numNewPts);
+    ArrayList::GatherTuples(cd, outCD, cellSources->GetPointer(0), numNewCells);
+  }
 
   // reset the radius to ite original value if necessary
   if (this->VaryRadius == VTK_VARY_RADIUS_BY_ABSOLUTE_SCALAR)
@@ -303,11 +558,6 @@ int vtkTubeFilter::RequestData(
 
   // Update ourselves
   //
-  if ( deleteNormals )
-  {
-    inNormals->Delete();
-  }
-
   if ( newTCoords )
   {
     outPD->SetTCoords(newTCoords);
@@ -322,7 +572,6 @@ int vtkTubeFilter::RequestData(
 
   outPD->SetNormals(newNormals);
   newNormals->Delete();
-  lineNormalGenerator->Delete();
 
   output->Squeeze();
 
@@ -330,13 +579,12 @@ int vtkTubeFilter::RequestData(
 }
 
 int vtkTubeFilter::GeneratePoints(vtkIdType offset,
-                                  vtkIdType npts, vtkIdType *pts,
+                                  vtkIdType npts, const vtkIdType *pts,
                                   vtkPoints *inPts, vtkPoints *newPts,
-                                  vtkPointData *pd, vtkPointData *outPD,
                                   vtkFloatArray *newNormals,
                                   vtkDataArray *inScalars, double range[2],
                                   vtkDataArray *inVectors, double maxSpeed,
-                                  vtkDataArray *inNormals)
+                                  const double *normals)
 {
   vtkIdType j;
   int i, k;
@@ -352,6 +600,7 @@ int vtkTubeFilter::GeneratePoints(vtkIdType offset,
   double nP[3];
   double sFactor=1.0;
   double normal[3];
+  double v[3];
   vtkIdType ptId=offset;
 
   // Use "averaged" segment to create beveled effect.
@@ -395,12 +644,13 @@ int vtkTubeFilter::GeneratePoints(vtkIdType offset,
       }
     }
 
-    inNormals->GetTuple(pts[j], n);
+    n[0] = normals[3*j];
+    n[1] = normals[3*j+1];
+    n[2] = normals[3*j+2];
 
     if ( vtkMath::Normalize(sNext) == 0.0 )
     {
-      vtkWarningMacro(<<"Coincident points!");
-      return 0;
+      return COINCIDENT_POINTS;
     }
 
     for (i=0; i<3; i++)
@@ -410,12 +660,8 @@ int vtkTubeFilter::GeneratePoints(vtkIdType offset,
     // if s is zero then just use sPrev cross n
     if (vtkMath::Normalize(s) == 0.0)
     {
-      vtkDebugMacro(<< "Using alternate bevel vector");
       vtkMath::Cross(sPrev,n,s);
-      if (vtkMath::Normalize(s) == 0.0)
-      {
-        vtkDebugMacro(<< "Using alternate bevel vector");
-      }
+      vtkMath::Normalize(s);
     }
 
 /*    if ( (bevelAngle = vtkMath::Dot(sNext,sPrev)) > 1.0 )
@@ -437,9 +683,7 @@ int vtkTubeFilter::GeneratePoints(vtkIdType offset,
     vtkMath::Cross(s,n,w);
     if ( vtkMath::Normalize(w) == 0.0)
     {
-      vtkWarningMacro(<<"Bad normal s = " <<s[0]<<" "<<s[1]<<" "<< s[2]
-                      << " n = " << n[0] << " " << n[1] << " " << n[2]);
-      return 0;
+      return BAD_NORMAL;
     }
 
     vtkMath::Cross(w,s,nP); //create orthogonal coordinate system
@@ -454,8 +698,8 @@ int vtkTubeFilter::GeneratePoints(vtkIdType offset,
     }
     else if ( inVectors && this->VaryRadius == VTK_VARY_RADIUS_BY_VECTOR )
     {
-      sFactor =
-        sqrt((double)maxSpeed/vtkMath::Norm(inVectors->GetTuple(pts[j])));
+      inVectors->GetTuple(pts[j], v);
+      sFactor = sqrt((double)maxSpeed/vtkMath::Norm(v));
       if ( sFactor > this->RadiusFactor )
       {
         sFactor = this->RadiusFactor;
@@ -467,11 +711,16 @@ int vtkTubeFilter::GeneratePoints(vtkIdType offset,
       sFactor = inScalars->GetComponent(pts[j],0);
       if (sFactor < 0.0)
       {
-        vtkWarningMacro(<<"Scalar value less than zero, skipping line");
-        return 0;
+        return NEGATIVE_SCALAR;
       }
     }
 
+    // only checking the polyline
+    if (!newPts)
+    {
+      continue;
+    }
+
     //create points around line
     if (this->SidesShareVertices)
     {
@@ -483,9 +732,8 @@ int vtkTubeFilter::GeneratePoints(vtkIdType offset,
             nP[i]*sin((double)k*this->Theta);
           s[i] = p[i] + this->Radius * sFactor * normal[i];
         }
-        newPts->InsertPoint(ptId,s);
-        newNormals->InsertTuple(ptId,normal);
-        outPD->CopyData(pd,pts[j],ptId);
+        newPts->SetPoint(ptId,s);
+        newNormals->SetTuple(ptId,normal);
         ptId++;
       }//for each side
     }
@@ -510,19 +758,17 @@ int vtkTubeFilter::GeneratePoints(vtkIdType offset,
             nP[i]*sin((double)(k+0.5)*this->Theta);
           s[i] = p[i] + this->Radius * sFactor * normal[i];
         }
-        newPts->InsertPoint(ptId,s);
-        newNormals->InsertTuple(ptId,n_right);
-        outPD->CopyData(pd,pts[j],ptId);
-        newPts->InsertPoint(ptId+1,s);
-        newNormals->InsertTuple(ptId+1,n_left);
-        outPD->CopyData(pd,pts[j],ptId+1);
+        newPts->SetPoint(ptId,s);
+        newNormals->SetTuple(ptId,n_right);
+        newPts->SetPoint(ptId+1,s);
+        newNormals->SetTuple(ptId+1,n_left);
         ptId += 2;
       }//for each side
     }//else separate vertices
   }//for all points in polyline
 
   //Produce end points for cap. They are placed at tail end of points.
-  if (this->Capping)
+  if (this->Capping && newPts)
   {
     int numCapSides = this->NumberOfSides;
     int capIncr = 1;
@@ -536,9 +782,8 @@ int vtkTubeFilter::GeneratePoints(vtkIdType offset,
     for (k=0; k < numCapSides; k+=capIncr)
     {
       newPts->GetPoint(offset+k,s);
-      newPts->InsertPoint(ptId,s);
-      newNormals->InsertTuple(ptId,startCapNorm);
-      outPD->CopyData(pd,pts[0],ptId);
+      newPts->SetPoint(ptId,s);
+      newNormals->SetTuple(ptId,startCapNorm);
       ptId++;
     }
     //the end cap
@@ -550,23 +795,19 @@ int vtkTubeFilter::GeneratePoints(vtkIdType offset,
     for (k=0; k < numCapSides; k+=capIncr)
     {
       newPts->GetPoint(endOffset+k,s);
-      newPts->InsertPoint(ptId,s);
-      newNormals->InsertTuple(ptId,endCapNorm);
-      outPD->CopyData(pd,pts[npts-1],ptId);
+      newPts->SetPoint(ptId,s);
+      newNormals->SetTuple(ptId,endCapNorm);
       ptId++;
     }
   }//if capping
 
-  return 1;
+  return VALID_LINE;
 }
 
 void vtkTubeFilter::GenerateStrips(vtkIdType offset, vtkIdType npts,
-                                   vtkIdType* vtkNotUsed(pts),
-                                   vtkIdType inCellId,
-                                   vtkCellData *cd, vtkCellData *outCD,
-                                   vtkCellArray *newStrips)
+                                   vtkIdType *strips)
 {
-  vtkIdType i, outCellId;
+  vtkIdType i;
   int k;
   int i1, i2, i3;
 
@@ -577,13 +818,12 @@ void vtkTubeFilter::GenerateStrips(vtkIdType offset, vtkIdType npts,
     {
       i1 = k % this->NumberOfSides;
       i2 = (k+1) % this->NumberOfSides;
-      outCellId = newStrips->InsertNextCell(npts*2);
-      outCD->CopyData(cd,inCellId,outCellId);
+      *strips++ = npts*2;
       for (i=0; i < npts; i++)
       {
         i3 = i*this->NumberOfSides;
-        newStrips->InsertCellPoint(offset+i2+i3);
-        newStrips->InsertCellPoint(offset+i1+i3);
+        *strips++ = offset+i2+i3;
+        *strips++ = offset+i1+i3;
       }
     } //for each side of the tube
   }
@@ -594,13 +834,12 @@ void vtkTubeFilter::GenerateStrips(vtkIdType offset, vtkIdType npts,
     {
       i1 = 2*(k % this->NumberOfSides) + 1;
       i2 = 2*((k+1) % this->NumberOfSides);
-      outCellId = newStrips->InsertNextCell(npts*2);
-      outCD->CopyData(cd,inCellId,outCellId);
+      *strips++ = npts*2;
       for (i=0; i < npts; i++)
       {
         i3 = i*2*this->NumberOfSides;
-        newStrips->InsertCellPoint(offset+i2+i3);
-        newStrips->InsertCellPoint(offset+i1+i3);
+        *strips++ = offset+i2+i3;
+        *strips++ = offset+i1+i3;
       }
     } //for each side of the tube
   }
@@ -610,7 +849,6 @@ void vtkTubeFilter::GenerateStrips(vtkIdType offset, vtkIdType npts,
   if (this->Capping)
   {
     vtkIdType startIdx = offset + npts*this->NumberOfSides;
-    vtkIdType idx;
 
     if ( ! this->SidesShareVertices )
     {
@@ -618,44 +856,38 @@ void vtkTubeFilter::GenerateStrips(vtkIdType offset, vtkIdType npts,
     }
 
     //The start cap
-    outCellId = newStrips->InsertNextCell(this->NumberOfSides);
-    outCD->CopyData(cd,inCellId,outCellId);
-    newStrips->InsertCellPoint(startIdx);
-    newStrips->InsertCellPoint(startIdx+1);
+    *strips++ = this->NumberOfSides;
+    *strips++ = startIdx;
+    *strips++ = startIdx+1;
     for (i1=this->NumberOfSides-1, i2=2, k=0; k<(this->NumberOfSides-2); k++)
     {
       if ( (k%2) )
       {
-        idx = startIdx + i2;
-        newStrips->InsertCellPoint(idx);
+        *strips++ = startIdx + i2;
         i2++;
       }
       else
       {
-        idx = startIdx + i1;
-        newStrips->InsertCellPoint(idx);
+        *strips++ = startIdx + i1;
         i1--;
       }
     }
 
     //The end cap - reversed order to be consistent with normal
     startIdx += this->NumberOfSides;
-    outCellId = newStrips->InsertNextCell(this->NumberOfSides);
-    outCD->CopyData(cd,inCellId,outCellId);
-    newStrips->InsertCellPoint(startIdx);
-    newStrips->InsertCellPoint(startIdx+this->NumberOfSides-1);
+    *strips++ = this->NumberOfSides;
+    *strips++ = startIdx;
+    *strips++ = startIdx+this->NumberOfSides-1;
     for (i1=this->NumberOfSides-2, i2=1, k=0; k<(this->NumberOfSides-2); k++)
     {
       if ( (k%2) )
       {
-        idx = startIdx + i1;
-        newStrips->InsertCellPoint(idx);
+        *strips++ = startIdx + i1;
         i1--;
       }
       else
       {
-        idx = startIdx + i2;
-        newStrips->InsertCellPoint(idx);
+        *strips++ = startIdx + i2;
         i2++;
       }
     }
@@ -663,7 +895,7 @@ void vtkTubeFilter::GenerateStrips(vtkIdType offset, vtkIdType npts,
 }
 
 void vtkTubeFilter::GenerateTextureCoords(vtkIdType offset,
-                                          vtkIdType npts, vtkIdType *pts,
+                                          vtkIdType npts, const vtkIdType *pts,
                                           vtkPoints *inPts,
                                           vtkDataArray *inScalars,
                                           vtkFloatArray *newTCoords)
@@ -689,7 +921,7 @@ void vtkTubeFilter::GenerateTextureCoords(vtkIdType offset,
       for ( k=0; k < numSides; k++)
       {
         double tcy = static_cast<double>(k) / (numSides - 1);
-        newTCoords->InsertTuple2(offset + i * numSides + k, tc, tcy);
+        newTCoords->SetTuple2(offset + i * numSides + k, tc, tcy);
       }
     }
   }
@@ -705,7 +937,7 @@ void vtkTubeFilter::GenerateTextureCoords(vtkIdType offset,
       for ( k=0; k < numSides; k++)
       {
         double tcy = static_cast<double>(k) / (numSides - 1);
-        newTCoords->InsertTuple2(offset + i * numSides + k, tc, tcy);
+        newTCoords->SetTuple2(offset + i * numSides + k, tc, tcy);
       }
 
       xPrev[0]=x[0]; xPrev[1]=x[1]; xPrev[2]=x[2];
@@ -731,7 +963,7 @@ void vtkTubeFilter::GenerateTextureCoords(vtkIdType offset,
       for ( k=0; k < numSides; k++)
       {
         double tcy = static_cast<double>(k) / (numSides - 1);
-        newTCoords->InsertTuple2(offset + i * numSides + k, tc, tcy);
+        newTCoords->SetTuple2(offset + i * numSides + k, tc, tcy);
       }
       xPrev[0]=x[0]; xPrev[1]=x[1]; xPrev[2]=x[2];
     }
@@ -746,13 +978,13 @@ void vtkTubeFilter::GenerateTextureCoords(vtkIdType offset,
     //start cap
     for (ik=0; ik < this->NumberOfSides; ik++)
     {
-      newTCoords->InsertTuple2(startIdx+ik,0.0,0.0);
+      newTCoords->SetTuple2(startIdx+ik,0.0,0.0);
     }
 
     //end cap
     for (ik=0; ik < this->NumberOfSides; ik++)
     {
-      newTCoords->InsertTuple2(startIdx+this->NumberOfSides+ik,tc,0.0);
+      newTCoords->SetTuple2(startIdx+this->NumberOfSides+ik,tc,0.0);
     }
   }
 }
@@ -777,6 +1009,18 @@ vtkIdType vtkTubeFilter::ComputeOffset(vtkIdType offset, vtkIdType npts)
   return offset;
 }
 
+// Compute the number of strips along each tube (caps excluded)
+vtkIdType vtkTubeFilter::ComputeNumberOfStrips()
+{
+  vtkIdType numStrips = 0;
+  for (int k=this->Offset; k<(this->NumberOfSides+this->Offset);
+       k+=this->OnRatio)
+  {
+    numStrips++;
+  }
+  return numStrips;
+}
+
 // Description:
 // Return the method of varying tube radius descriptive character string.
 const char *vtkTubeFilter::GetVaryRadiusAsString(void)
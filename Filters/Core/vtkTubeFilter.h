@@ -34,6 +34,10 @@
  * common use is to combine this filter with vtkStreamTracer to generate
  * streamtubes.
  *
+ * The filter first determines which polylines can be tubed and the exact
+ * size of the output, and then generates the tubes of all the polylines in
+ * parallel (using vtkSMPTools) directly into the preallocated output.
+ *
  * @warning
  * The number of tube sides must be greater than 3. If you wish to use fewer
  * sides (i.e., a ribbon), use vtkRibbonFilter.
@@ -250,25 +254,38 @@ protected:
   int OutputPointsPrecision;
   double TextureLength; //this length is mapped to [0,1) texture space
 
-  // Helper methods
-  int GeneratePoints(vtkIdType offset, vtkIdType npts, vtkIdType *pts,
+  // Helper methods. They write the output of one polyline at the given
+  // offsets of preallocated arrays, so that polylines can be processed
+  // concurrently. The normals of the polyline points are passed in
+  // (3*npts values). GeneratePoints() only checks the polyline when newPts
+  // is nullptr, and returns VALID_LINE or the reason to reject it.
+  enum
+  {
+    VALID_LINE = 1,
+    COINCIDENT_POINTS = 0,
+    BAD_NORMAL = -1,
+    NEGATIVE_SCALAR = -2
+  };
+  int GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkIdType *pts,
                      vtkPoints *inPts, vtkPoints *newPts,
-                     vtkPointData *pd, vtkPointData *outPD,
                      vtkFloatArray *newNormals, vtkDataArray *inScalars,
                      double range[2], vtkDataArray *inVectors, double maxNorm,
-                     vtkDataArray *inNormals);
-  void GenerateStrips(vtkIdType offset, vtkIdType npts, vtkIdType *pts,
-                      vtkIdType inCellId, vtkCellData *cd, vtkCellData *outCD,
-                      vtkCellArray *newStrips);
-  void GenerateTextureCoords(vtkIdType offset, vtkIdType npts, vtkIdType *pts,
-                             vtkPoints *inPts, vtkDataArray *inScalars,
-                            vtkFloatArray *newTCoords);
+                     const double *normals);
+  void GenerateStrips(vtkIdType offset, vtkIdType npts, vtkIdType *strips);
+  void GenerateTextureCoords(vtkIdType offset, vtkIdType npts,
+                             const vtkIdType *pts, vtkPoints *inPts,
+                             vtkDataArray *inScalars,
+                             vtkFloatArray *newTCoords);
   vtkIdType ComputeOffset(vtkIdType offset,vtkIdType npts);
+  vtkIdType ComputeNumberOfStrips();
 
   // Helper data members
   double Theta;
 
 private:
+  friend class vtkTubeFilterPlanLines;
+  friend class vtkTubeFilterGenerateLines;
+
   vtkTubeFilter(const vtkTubeFilter&) = delete;
   void operator=(const vtkTubeFilter&) = delete;
 };
@@ -24,9 +24,13 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPTools.h"
 #include "vtkTriangle.h"
 #include "vtkTriangleFilter.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkWindowedSincPolyDataFilter);
 
 //-----------------------------------------------------------------------------
@@ -64,6 +68,253 @@ typedef struct _vtkMeshVertex
   vtkIdList *edges; // connected edges (list of connected point ids)
 } vtkMeshVertex, *vtkMeshVertexPtr;
 
+namespace
+{
+
+// The connected vertices of every point packed into a single array (CSR
+// layout). It is built once from the per-vertex edge lists produced by the
+// topological analysis, and is then shared read-only by all iterations.
+struct vtkWindowedSincNeighbors
+{
+  std::vector<vtkIdType> Offsets;
+  std::vector<vtkIdType> Ids;
+};
+
+class vtkWindowedSincCountNeighbors
+{
+public:
+  const vtkMeshVertex *Verts;
+  vtkIdType *Offsets;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      this->Offsets[i + 1] = (this->Verts[i].edges != nullptr ?
+                              this->Verts[i].edges->GetNumberOfIds() : 0);
+    }
+  }
+};
+
+class vtkWindowedSincCopyNeighbors
+{
+public:
+  const vtkMeshVertex *Verts;
+  const vtkIdType *Offsets;
+  vtkIdType *Ids;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      vtkIdType npts = this->Offsets[i + 1] - this->Offsets[i];
+      if (npts > 0)
+      {
+        const vtkIdType *edges = this->Verts[i].edges->GetPointer(0);
+        std::copy(edges, edges + npts, this->Ids + this->Offsets[i]);
+      }
+    }
+  }
+};
+
+void vtkWindowedSincBuildNeighbors(const vtkMeshVertex *verts, vtkIdType numPts,
+                                   vtkWindowedSincNeighbors &neighbors)
+{
+  neighbors.Offsets.resize(numPts + 1);
+  neighbors.Offsets[0] = 0;
+
+  vtkWindowedSincCountNeighbors count = { verts, &neighbors.Offsets[0] };
+  vtkSMPTools::For(0, numPts, count);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    neighbors.Offsets[i + 1] += neighbors.Offsets[i];
+  }
+
+  neighbors.Ids.resize(neighbors.Offsets[numPts]);
+  if (neighbors.Offsets[numPts] > 0)
+  {
+    vtkWindowedSincCopyNeighbors copy =
+      { verts, &neighbors.Offsets[0], &neighbors.Ids[0] };
+    vtkSMPTools::For(0, numPts, copy);
+  }
+}
+
+// One pass of the Chebyshev iteration. Every point only reads the previous
+// two iterates (X0, X1) and only writes its own entries of X2 and X3, so the
+// points can be processed in any order and the result matches a serial pass
+// exactly.
+template <typename T>
+class vtkWindowedSincIteration
+{
+public:
+  const vtkMeshVertex *Verts;
+  const vtkIdType *Offsets;
+  const vtkIdType *Ids;
+  int IterationNumber;
+  const double *C;
+  const T *X0;
+  T *X1;
+  T *X2;
+  T *X3;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    if (this->IterationNumber == 1)
+    {
+      this->FirstIteration(begin, end);
+    }
+    else
+    {
+      this->NextIteration(begin, end);
+    }
+  }
+
+  void FirstIteration(vtkIdType begin, vtkIdType end)
+  {
+    double x[3], deltaX[3];
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const T *x0 = this->X0 + 3 * i;
+      T *x1 = this->X1 + 3 * i;
+      T *x3 = this->X3 + 3 * i;
+      vtkIdType npts = this->Offsets[i + 1] - this->Offsets[i];
+      if (npts > 0)
+      {
+        // point is allowed to move
+        const vtkIdType *nbrs = this->Ids + this->Offsets[i];
+        x[0] = x0[0]; x[1] = x0[1]; x[2] = x0[2];
+        deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+
+        // calculate the negative of the laplacian
+        for (vtkIdType j = 0; j < npts; ++j)
+        {
+          const T *y = this->X0 + 3 * nbrs[j];
+          for (int k = 0; k < 3; ++k)
+          {
+            deltaX[k] += (x[k] - static_cast<double>(y[k])) / npts;
+          }
+        }
+        // X1 = X0 - 0.5 laplacian
+        for (int k = 0; k < 3; ++k)
+        {
+          deltaX[k] = x[k] - 0.5 * deltaX[k];
+          x1[k] = static_cast<T>(deltaX[k]);
+        }
+
+        // X3 = c0 X0 + c1 X1
+        for (int k = 0; k < 3; ++k)
+        {
+          x3[k] = (this->Verts[i].type == VTK_FIXED_VERTEX ? x0[k] :
+                   static_cast<T>(this->C[0] * x[k] + this->C[1] * deltaX[k]));
+        }
+      }
+      else
+      {
+        // point is not allowed to move (zero out the Laplacian)
+        for (int k = 0; k < 3; ++k)
+        {
+          x1[k] = 0.0;
+          x3[k] = x0[k];
+        }
+      }
+    }
+  }
+
+  void NextIteration(vtkIdType begin, vtkIdType end)
+  {
+    double p_x0[3], p_x1[3], deltaX[3];
+    const double c = this->C[this->IterationNumber];
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      T *x2 = this->X2 + 3 * i;
+      vtkIdType npts = this->Offsets[i + 1] - this->Offsets[i];
+      if (npts > 0)
+      {
+        // point is allowed to move
+        const vtkIdType *nbrs = this->Ids + this->Offsets[i];
+        for (int k = 0; k < 3; ++k)
+        {
+          p_x0[k] = this->X0[3 * i + k];
+          p_x1[k] = this->X1[3 * i + k];
+        }
+        deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+
+        // calculate the negative laplacian of x1
+        for (vtkIdType j = 0; j < npts; ++j)
+        {
+          const T *y = this->X1 + 3 * nbrs[j];
+          for (int k = 0; k < 3; ++k)
+          {
+            deltaX[k] += (p_x1[k] - static_cast<double>(y[k])) / npts;
+          }
+        }
+
+        // Taubin:  x2 = (x1 - x0) + (x1 - x2), then x3 = x3 + cj x2
+        T *x3 = this->X3 + 3 * i;
+        for (int k = 0; k < 3; ++k)
+        {
+          deltaX[k] = p_x1[k] - p_x0[k] + p_x1[k] - deltaX[k];
+          x2[k] = static_cast<T>(deltaX[k]);
+        }
+        if (this->Verts[i].type != VTK_FIXED_VERTEX)
+        {
+          for (int k = 0; k < 3; ++k)
+          {
+            x3[k] = static_cast<T>(x3[k] + c * deltaX[k]);
+          }
+        }
+      }
+      else
+      {
+        // point is not allowed to move (zero out the Laplacian). X1 of such
+        // a point was already zeroed by the previous iteration, and writing
+        // it here would race with the neighbors reading it.
+        x2[0] = x2[1] = x2[2] = 0.0;
+      }
+    }
+  }
+};
+
+template <typename T>
+void vtkWindowedSincIterate(const vtkMeshVertex *verts,
+                            const vtkWindowedSincNeighbors &neighbors,
+                            int iterationNumber, const double *c,
+                            vtkPoints *x0, vtkPoints *x1, vtkPoints *x2,
+                            vtkPoints *x3)
+{
+  vtkWindowedSincIteration<T> iteration;
+  iteration.Verts = verts;
+  iteration.Offsets = &neighbors.Offsets[0];
+  iteration.Ids = neighbors.Ids.empty() ? nullptr : &neighbors.Ids[0];
+  iteration.IterationNumber = iterationNumber;
+  iteration.C = c;
+  iteration.X0 = static_cast<T*>(x0->GetVoidPointer(0));
+  iteration.X1 = static_cast<T*>(x1->GetVoidPointer(0));
+  iteration.X2 = static_cast<T*>(x2->GetVoidPointer(0));
+  iteration.X3 = static_cast<T*>(x3->GetVoidPointer(0));
+  vtkSMPTools::For(0, x0->GetNumberOfPoints(), iteration);
+}
+
+void vtkWindowedSincIterate(const vtkMeshVertex *verts,
+                            const vtkWindowedSincNeighbors &neighbors,
+                            int iterationNumber, const double *c,
+                            vtkPoints *x0, vtkPoints *x1, vtkPoints *x2,
+                            vtkPoints *x3)
+{
+  if (x0->GetDataType() == VTK_DOUBLE)
+  {
+    vtkWindowedSincIterate<double>(verts, neighbors, iterationNumber, c,
+                                   x0, x1, x2, x3);
+  }
+  else
+  {
+    vtkWindowedSincIterate<float>(verts, neighbors, iterationNumber, c,
+                                  x0, x1, x2, x3);
+  }
+}
+
+} // anonymous namespace
+
 //-----------------------------------------------------------------------------
 int vtkWindowedSincPolyDataFilter::RequestData(
   vtkInformation *vtkNotUsed(request),
@@ -85,7 +336,6 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   vtkIdType npts = 0;
   vtkIdType *pts = nullptr;
   vtkIdType p1, p2;
-  double x[3], y[3], deltaX[3], xNew[3];
   double x1[3], x2[3], x3[3], l1[3], l2[3];
   double CosFeatureAngle; //Cosine of angle between adjacent polys
   double CosEdgeAngle; // Cosine of angle between adjacent edges
@@ -99,7 +349,7 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   vtkMeshVertexPtr Verts;
 
   // variables specific to windowed sinc interpolation
-  double theta_pb, k_pb, sigma, p_x0[3], p_x1[3], p_x3[3];
+  double theta_pb, k_pb, sigma;
   double *w, *c, *cprime;
   int zero, one, two, three;
 
@@ -506,9 +756,6 @@ int vtkWindowedSincPolyDataFilter::RequestData(
   c = new double[this->NumberOfIterations+1];
   cprime = new double[this->NumberOfIterations+1];
 
-  double zerovector[3];
-  zerovector[0] = zerovector[1] = zerovector[2] = 0.0;
-
   // Calculate the weights and the Chebychev coefficients c.
   //
 
@@ -593,54 +840,14 @@ int vtkWindowedSincPolyDataFilter::RequestData(
     vtkErrorMacro(<< "An optimal offset for the smoothing filter could not be found.  Unpredictable smoothing/shrinkage may result.");
   }
 
-  // first iteration
-  for (i=0; i<numPts; i++)
-  {
-    if ( Verts[i].edges != nullptr &&
-         (npts = Verts[i].edges->GetNumberOfIds()) > 0 )
-    {
-      // point is allowed to move
-      newPts[zero]->GetPoint(i, x); //use current points
-      deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
+  // Pack the connected vertices of every point into a single array; the
+  // iterations below then process the points in parallel.
+  vtkWindowedSincNeighbors neighbors;
+  vtkWindowedSincBuildNeighbors(Verts, numPts, neighbors);
 
-      // calculate the negative of the laplacian
-      for (j=0; j<npts; j++) //for all connected points
-      {
-        newPts[zero]->GetPoint(Verts[i].edges->GetId(j), y);
-        for (k=0; k<3; k++)
-        {
-          deltaX[k] += (x[k] - y[k]) / npts;
-        }
-      }
-      // newPts[one] = newPts[zero] - 0.5 newPts[one]
-      for (k=0; k<3; k++)
-      {
-        deltaX[k] = x[k] - 0.5*deltaX[k];
-      }
-      newPts[one]->SetPoint(i, deltaX);
-
-      // calculate newPts[three] = c0 newPts[zero] + c1 newPts[one]
-      for (k=0; k < 3; k++)
-      {
-        deltaX[k] = c[0]*x[k] + c[1]*deltaX[k];
-      }
-      if (Verts[i].type == VTK_FIXED_VERTEX)
-      {
-        newPts[three]->SetPoint(i, newPts[zero]->GetPoint(i));
-      }
-      else
-      {
-        newPts[three]->SetPoint(i, deltaX);
-      }
-    }//if can move point
-    else
-    {
-      // point is not allowed to move, just use the old point...
-      // (zero out the Laplacian)
-      newPts[one]->SetPoint(i, zerovector);
-      newPts[three]->SetPoint(i, newPts[zero]->GetPoint(i));
-    }
-  }//for all points
+  // first iteration
+  vtkWindowedSincIterate(Verts, neighbors, 1, c, newPts[zero], newPts[one],
+                         newPts[two], newPts[three]);
 
   // for the rest of the iterations
   for ( iterationNumber=2;
@@ -656,53 +863,8 @@ int vtkWindowedSincPolyDataFilter::RequestData(
       }
     }
 
-    for (i=0; i<numPts; i++)
-    {
-      if ( Verts[i].edges != nullptr &&
-           (npts = Verts[i].edges->GetNumberOfIds()) > 0 )
-      {
-        // point is allowed to move
-        newPts[zero]->GetPoint(i, p_x0); //use current points
-        newPts[one]->GetPoint(i, p_x1);
-
-        deltaX[0] = deltaX[1] = deltaX[2] = 0.0;
-
-        // calculate the negative laplacian of x1
-        for (j=0; j<npts; j++)
-        {
-          newPts[one]->GetPoint(Verts[i].edges->GetId(j), y);
-          for (k=0; k<3; k++)
-          {
-            deltaX[k] += (p_x1[k] - y[k]) / npts;
-          }
-        }//for all connected points
-
-        // Taubin:  x2 = (x1 - x0) + (x1 - x2)
-        for (k=0; k<3; k++)
-        {
-          deltaX[k] = p_x1[k] - p_x0[k] + p_x1[k] - deltaX[k];
-        }
-        newPts[two]->SetPoint(i, deltaX);
-
-        // smooth the vertex (x3 = x3 + cj x2)
-        newPts[three]->GetPoint(i, p_x3);
-        for (k=0;k<3;k++)
-        {
-          xNew[k] = p_x3[k] + c[iterationNumber] * deltaX[k];
-        }
-        if (Verts[i].type != VTK_FIXED_VERTEX)
-        {
-          newPts[three]->SetPoint(i,xNew);
-        }
-      }//if can move point
-      else
-      {
-        // point is not allowed to move, just use the old point...
-        // (zero out the Laplacian)
-        newPts[one]->SetPoint(i, zerovector);
-        newPts[two]->SetPoint(i, zerovector);
-      }
-    }//for all points
+    vtkWindowedSincIterate(Verts, neighbors, iterationNumber, c, newPts[zero],
+                           newPts[one], newPts[two], newPts[three]);
 
     // update the pointers. three is always three. all other pointers
     // shift by one and wrap.
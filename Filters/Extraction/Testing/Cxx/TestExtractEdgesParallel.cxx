@@ -0,0 +1,227 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestExtractEdgesParallel.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Extracts the edges of an unstructured grid of vertices, lines, quads,
+// hexahedra, tetrahedra and quadratic tetrahedra, and of an image, serially
+// and in parallel, and checks that the outputs are identical.
+
+#include <vtkCellArray.h>
+#include <vtkCellData.h>
+#include <vtkDoubleArray.h>
+#include <vtkExtractEdges.h>
+#include <vtkImageData.h>
+#include <vtkIntArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPoints.h>
+#include <vtkPolyData.h>
+#include <vtkUnstructuredGrid.h>
+
+#include <iostream>
+
+namespace
+{
+const int Size = 12;
+
+vtkIdType PointId(int i, int j, int k)
+{
+  return i + Size * (j + Size * k);
+}
+
+void MakeGrid(vtkUnstructuredGrid* grid)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> values;
+  values->SetName("Values");
+  for (int k = 0; k < Size; ++k)
+  {
+    for (int j = 0; j < Size; ++j)
+    {
+      for (int i = 0; i < Size; ++i)
+      {
+        points->InsertNextPoint(i, j, k);
+        values->InsertNextValue(i + 0.1 * j + 0.01 * k);
+      }
+    }
+  }
+  grid->SetPoints(points);
+  grid->GetPointData()->AddArray(values);
+  grid->Allocate(6 * Size * Size * Size);
+
+  static const int tetras[5][4] = { { 0, 1, 3, 4 }, { 1, 2, 3, 6 },
+    { 1, 4, 5, 6 }, { 3, 4, 6, 7 }, { 1, 3, 4, 6 } };
+  for (int k = 0; k + 1 < Size; ++k)
+  {
+    for (int j = 0; j + 1 < Size; ++j)
+    {
+      for (int i = 0; i + 1 < Size; ++i)
+      {
+        vtkIdType hex[8] = { PointId(i, j, k), PointId(i + 1, j, k),
+          PointId(i + 1, j + 1, k), PointId(i, j + 1, k),
+          PointId(i, j, k + 1), PointId(i + 1, j, k + 1),
+          PointId(i + 1, j + 1, k + 1), PointId(i, j + 1, k + 1) };
+        if (k == 0 && j == 0)
+        {
+          // cells without edges, and 2D cells
+          grid->InsertNextCell(VTK_VERTEX, 1, hex);
+          grid->InsertNextCell(VTK_LINE, 2, hex);
+          grid->InsertNextCell(VTK_QUAD, 4, hex);
+        }
+        if ((i + 2 * j + k) % 4 < 2)
+        {
+          grid->InsertNextCell(VTK_HEXAHEDRON, 8, hex);
+        }
+        else if (i == 0)
+        {
+          // a quadratic tetrahedron, with its mid-edge nodes on the grid
+          vtkIdType tetra[10] = { PointId(0, j, k), PointId(0, j, k + 1),
+            PointId(0, j + 1, k), PointId(1, j, k), PointId(0, j, k),
+            PointId(0, j + 1, k + 1), PointId(0, j + 1, k),
+            PointId(1, j, k), PointId(1, j, k + 1), PointId(1, j + 1, k) };
+          grid->InsertNextCell(VTK_QUADRATIC_TETRA, 10, tetra);
+        }
+        else
+        {
+          for (int t = 0; t < 5; ++t)
+          {
+            vtkIdType tetra[4] = { hex[tetras[t][0]], hex[tetras[t][1]],
+              hex[tetras[t][2]], hex[tetras[t][3]] };
+            grid->InsertNextCell(VTK_TETRA, 4, tetra);
+          }
+        }
+      }
+    }
+  }
+
+  vtkNew<vtkIntArray> cellIds;
+  cellIds->SetName("CellIds");
+  for (vtkIdType i = 0; i < grid->GetNumberOfCells(); ++i)
+  {
+    cellIds->InsertNextValue(static_cast<int>(i));
+  }
+  grid->GetCellData()->AddArray(cellIds);
+}
+
+bool SameArrays(vtkDataSetAttributes* a, vtkDataSetAttributes* b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray* x = a->GetArray(i);
+    vtkDataArray* y = b->GetArray(x->GetName());
+    if (!y || x->GetNumberOfTuples() != y->GetNumberOfTuples() ||
+        x->GetNumberOfComponents() != y->GetNumberOfComponents())
+    {
+      return false;
+    }
+    for (vtkIdType t = 0; t < x->GetNumberOfTuples(); ++t)
+    {
+      for (int c = 0; c < x->GetNumberOfComponents(); ++c)
+      {
+        if (x->GetComponent(t, c) != y->GetComponent(t, c))
+        {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool TestExtractEdges(vtkDataSet* input)
+{
+  vtkNew<vtkExtractEdges> serial;
+  vtkNew<vtkExtractEdges> parallel;
+  vtkExtractEdges* filters[2] = { serial, parallel };
+  for (int i = 0; i < 2; ++i)
+  {
+    filters[i]->SetInputData(input);
+    filters[i]->SetParallelExtraction(i == 1);
+    filters[i]->Update();
+  }
+  vtkPolyData* a = serial->GetOutput();
+  vtkPolyData* b = parallel->GetOutput();
+  if (a->GetNumberOfLines() == 0 ||
+      a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfLines() != b->GetNumberOfLines())
+  {
+    std::cerr << "Expected " << a->GetNumberOfPoints() << " points and "
+              << a->GetNumberOfLines() << " lines, got "
+              << b->GetNumberOfPoints() << " and " << b->GetNumberOfLines()
+              << std::endl;
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+  {
+    double x[3], y[3];
+    a->GetPoint(i, x);
+    b->GetPoint(i, y);
+    if (x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+    {
+      std::cerr << "Point " << i << " differs." << std::endl;
+      return false;
+    }
+  }
+  vtkIdType npts, *pts, numPts, *ids;
+  a->GetLines()->InitTraversal();
+  b->GetLines()->InitTraversal();
+  while (a->GetLines()->GetNextCell(npts, pts) &&
+         b->GetLines()->GetNextCell(numPts, ids))
+  {
+    if (npts != 2 || numPts != 2 || pts[0] != ids[0] || pts[1] != ids[1])
+    {
+      std::cerr << "Lines differ." << std::endl;
+      return false;
+    }
+  }
+  if (!SameArrays(a->GetPointData(), b->GetPointData()) ||
+      !SameArrays(a->GetCellData(), b->GetCellData()))
+  {
+    std::cerr << "Attributes differ." << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int TestExtractEdgesParallel(int, char*[])
+{
+  vtkNew<vtkUnstructuredGrid> grid;
+  MakeGrid(grid);
+  if (!TestExtractEdges(grid))
+  {
+    std::cerr << "Parallel extraction of unstructured grid edges failed."
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(Size, Size - 2, Size - 4);
+  image->SetSpacing(0.5, 1.0, 2.0);
+  image->AllocateScalars(VTK_FLOAT, 1);
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    scalars->SetTuple1(i, 0.5 * i);
+  }
+  if (!TestExtractEdges(image))
+  {
+    std::cerr << "Parallel extraction of image edges failed." << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
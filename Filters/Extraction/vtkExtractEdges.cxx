@@ -26,14 +26,315 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkIncrementalPointLocator.h"
+#include "vtkArrayListTemplate.h"
+#include "vtkAtomic.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <vector>
 
 vtkStandardNewMacro(vtkExtractEdges);
 
+namespace
+{
+// An edge segment visited by the serial algorithm: its points (in the
+// orientation of the cell edge) and its cell.
+struct vtkExtractEdgesSegment
+{
+  vtkIdType Points[2];
+  vtkIdType Cell;
+};
+
+// A segment in the bucket of its smallest point: its other point and its
+// position in the serial visiting order.
+struct vtkExtractEdgesKey
+{
+  vtkIdType Max;
+  vtkIdType Position;
+
+  bool operator<(const vtkExtractEdgesKey &key) const
+  {
+    if (this->Max != key.Max)
+    {
+      return this->Max < key.Max;
+    }
+    return this->Position < key.Position;
+  }
+};
+
+// Collects the edge segments of blocks of consecutive cells, in the order
+// the serial algorithm visits them (higher-order edges are tessellated).
+struct vtkExtractEdgesCollect
+{
+  vtkDataSet *Input;
+  vtkIdType NumberOfCells;
+  vtkIdType BlockSize;
+  std::vector<vtkExtractEdgesSegment> *Blocks;
+
+  vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+  vtkSMPThreadLocalObject<vtkIdList> EdgeIds;
+  vtkSMPThreadLocalObject<vtkPoints> EdgePts;
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    vtkGenericCell *cell = this->Cell.Local();
+    vtkIdList *edgeIds = this->EdgeIds.Local();
+    vtkPoints *edgePts = this->EdgePts.Local();
+    for (vtkIdType blockId = beginBlock; blockId < endBlock; ++blockId)
+    {
+      std::vector<vtkExtractEdgesSegment> &segments = this->Blocks[blockId];
+      vtkIdType begin = blockId * this->BlockSize;
+      vtkIdType end = std::min(begin + this->BlockSize, this->NumberOfCells);
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        this->Input->GetCell(cellId, cell);
+        int numCellEdges = cell->GetNumberOfEdges();
+        for (int edgeNum = 0; edgeNum < numCellEdges; ++edgeNum)
+        {
+          vtkCell *edge = cell->GetEdge(edgeNum);
+          vtkExtractEdgesSegment segment;
+          segment.Cell = cellId;
+          if ( ! edge->IsLinear() )
+          {
+            edge->Triangulate(0, edgeIds, edgePts);
+            for (vtkIdType i = 0; i < edgeIds->GetNumberOfIds() / 2; ++i)
+            {
+              segment.Points[0] = edgeIds->GetId(2 * i);
+              segment.Points[1] = edgeIds->GetId(2 * i + 1);
+              segments.push_back(segment);
+            }
+          }
+          else
+          {
+            vtkIdList *ids = edge->PointIds;
+            for (vtkIdType i = 1; i < ids->GetNumberOfIds(); ++i)
+            {
+              segment.Points[0] = ids->GetId(i - 1);
+              segment.Points[1] = ids->GetId(i);
+              segments.push_back(segment);
+            }
+          }
+        }
+      }
+    }
+  }
+};
+
+// Concatenates the segments of the blocks.
+struct vtkExtractEdgesGather
+{
+  std::vector<vtkExtractEdgesSegment> *Blocks;
+  const vtkIdType *Offsets;
+  vtkExtractEdgesSegment *Segments;
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType blockId = beginBlock; blockId < endBlock; ++blockId)
+    {
+      std::vector<vtkExtractEdgesSegment> &segments = this->Blocks[blockId];
+      std::copy(segments.begin(), segments.end(),
+                this->Segments + this->Offsets[blockId]);
+      std::vector<vtkExtractEdgesSegment>().swap(segments);
+    }
+  }
+};
+
+// Buckets the segments by their smallest point: counts them first, then
+// (once the counts are turned into cursors) scatters them. The order within
+// a bucket depends on the threads, it is sorted afterwards.
+struct vtkExtractEdgesBucketSegments
+{
+  const vtkExtractEdgesSegment *Segments;
+  vtkAtomic<vtkIdType> *Cursors;
+  vtkExtractEdgesKey *Keys; // nullptr to count
+
+  void operator()(vtkIdType position, vtkIdType endPosition)
+  {
+    for ( ; position < endPosition; ++position)
+    {
+      const vtkIdType *pts = this->Segments[position].Points;
+      vtkIdType min = std::min(pts[0], pts[1]);
+      if (!this->Keys)
+      {
+        ++this->Cursors[min];
+        continue;
+      }
+      vtkExtractEdgesKey &key = this->Keys[this->Cursors[min]++];
+      key.Max = std::max(pts[0], pts[1]);
+      key.Position = position;
+    }
+  }
+};
+
+// Sorts the buckets of a range of points and marks the first visit of every
+// edge, the one the serial algorithm keeps.
+struct vtkExtractEdgesMarkFirst
+{
+  vtkExtractEdgesKey *Keys;
+  const vtkIdType *Buckets;
+  unsigned char *Kept;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      vtkExtractEdgesKey *keys = this->Keys + this->Buckets[ptId];
+      vtkExtractEdgesKey *keysEnd = this->Keys + this->Buckets[ptId+1];
+      std::sort(keys, keysEnd);
+      for (vtkExtractEdgesKey *key = keys; key < keysEnd; ++key)
+      {
+        this->Kept[key->Position] = (key == keys || key->Max != (key-1)->Max);
+      }
+    }
+  }
+};
+
+// Copies point coordinates from their source points.
+struct vtkExtractEdgesCopyPoints
+{
+  vtkDataSet *Input;
+  vtkPoints *OutPoints;
+  const vtkIdType *Sources;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    double x[3];
+    for ( ; ptId < endPtId; ++ptId)
+    {
+      this->Input->GetPoint(this->Sources[ptId], x);
+      this->OutPoints->SetPoint(ptId, x);
+    }
+  }
+};
+
+}
+
+//----------------------------------------------------------------------------
+// Extract the edges from sorted edge lists instead of an edge table: the
+// segments of all cells are collected in parallel, bucketed by their
+// smallest point and each bucket is sorted, so the visits of an edge are
+// adjacent and the first one is kept. Output is in serial order.
+static void vtkExtractEdgesParallelExecute(vtkExtractEdges *self,
+                                           vtkDataSet *input,
+                                           vtkPolyData *output)
+{
+  vtkIdType numCells = input->GetNumberOfCells();
+  vtkIdType numPts = input->GetNumberOfPoints();
+
+  // Make sure the cells can be read from several threads.
+  vtkNew<vtkGenericCell> cell;
+  input->GetCell(0, cell);
+
+  int numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+  vtkIdType numBlocks = (numThreads > 1 ? 4 * numThreads : 1);
+  numBlocks = std::max<vtkIdType>(1, std::min(numBlocks, numCells / 1024));
+  std::vector<std::vector<vtkExtractEdgesSegment> > blocks(numBlocks);
+  vtkExtractEdgesCollect collect;
+  collect.Input = input;
+  collect.NumberOfCells = numCells;
+  collect.BlockSize = (numCells + numBlocks - 1) / numBlocks;
+  collect.Blocks = blocks.data();
+  vtkSMPTools::For(0, numBlocks, 1, collect);
+
+  std::vector<vtkIdType> offsets(numBlocks + 1, 0);
+  for (vtkIdType blockId = 0; blockId < numBlocks; ++blockId)
+  {
+    offsets[blockId + 1] = offsets[blockId] +
+      static_cast<vtkIdType>(blocks[blockId].size());
+  }
+  vtkIdType numSegments = offsets[numBlocks];
+  std::vector<vtkExtractEdgesSegment> segments(numSegments);
+  vtkExtractEdgesGather gather = { blocks.data(), offsets.data(),
+                                   segments.data() };
+  vtkSMPTools::For(0, numBlocks, 1, gather);
+  self->UpdateProgress(0.4);
+
+  // Bucket the segments by smallest point, then keep the first visit of
+  // every edge of each bucket.
+  std::vector<vtkAtomic<vtkIdType> > cursors(numPts);
+  vtkExtractEdgesBucketSegments bucket = { segments.data(), cursors.data(),
+                                           nullptr };
+  vtkSMPTools::For(0, numSegments, bucket);
+  std::vector<vtkIdType> buckets(numPts + 1);
+  buckets[0] = 0;
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+  {
+    buckets[ptId + 1] = buckets[ptId] + cursors[ptId];
+    cursors[ptId] = buckets[ptId];
+  }
+  std::vector<vtkExtractEdgesKey> keys(numSegments);
+  bucket.Keys = keys.data();
+  vtkSMPTools::For(0, numSegments, bucket);
+  std::vector<vtkAtomic<vtkIdType> >().swap(cursors);
+
+  std::vector<unsigned char> kept(numSegments);
+  vtkExtractEdgesMarkFirst mark = { keys.data(), buckets.data(),
+                                    kept.data() };
+  vtkSMPTools::For(0, numPts, mark);
+  std::vector<vtkExtractEdgesKey>().swap(keys);
+  self->UpdateProgress(0.7);
+
+  // Output lines in visiting order. Points are numbered in the order they
+  // are first used, which is the order the serial algorithm inserts them.
+  std::vector<vtkIdType> newIds(numPts, -1);
+  std::vector<vtkIdType> pointSources;
+  std::vector<vtkIdType> cellSources;
+  vtkIdTypeArray *lineArray = vtkIdTypeArray::New();
+  lineArray->Allocate(3 * numSegments);
+  for (vtkIdType i = 0; i < numSegments; ++i)
+  {
+    if (!kept[i])
+    {
+      continue;
+    }
+    const vtkExtractEdgesSegment &segment = segments[i];
+    lineArray->InsertNextValue(2);
+    for (int j = 0; j < 2; ++j)
+    {
+      vtkIdType ptId = segment.Points[j];
+      if (newIds[ptId] < 0)
+      {
+        newIds[ptId] = static_cast<vtkIdType>(pointSources.size());
+        pointSources.push_back(ptId);
+      }
+      lineArray->InsertNextValue(newIds[ptId]);
+    }
+    cellSources.push_back(segment.Cell);
+  }
+  vtkIdType numNewPts = static_cast<vtkIdType>(pointSources.size());
+  vtkIdType numLines = static_cast<vtkIdType>(cellSources.size());
+
+  vtkNew<vtkPoints> newPts;
+  newPts->SetNumberOfPoints(numNewPts);
+  vtkExtractEdgesCopyPoints copyPoints = { input, newPts,
+                                           pointSources.data() };
+  vtkSMPTools::For(0, numNewPts, copyPoints);
+  output->SetPoints(newPts);
+
+  vtkNew<vtkCellArray> newLines;
+  newLines->SetCells(numLines, lineArray);
+  lineArray->Delete();
+  output->SetLines(newLines);
+
+  vtkPointData *outPD = output->GetPointData();
+  outPD->CopyAllocate(input->GetPointData(), numNewPts);
+  ArrayList::GatherTuples(input->GetPointData(), outPD,
+    pointSources.data(), static_cast<vtkIdType>(pointSources.size()));
+  vtkCellData *outCD = output->GetCellData();
+  outCD->CopyAllocate(input->GetCellData(), numLines);
+  ArrayList::GatherTuples(input->GetCellData(), outCD,
+    cellSources.data(), static_cast<vtkIdType>(cellSources.size()));
+}
+
 //----------------------------------------------------------------------------
 // Construct object.
 vtkExtractEdges::vtkExtractEdges()
 {
   this->Locator = nullptr;
+  this->ParallelExtraction = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -87,6 +388,14 @@ int vtkExtractEdges::RequestData(
     return 1;
   }
 
+  if ( this->ParallelExtraction )
+  {
+    vtkExtractEdgesParallelExecute(this, input, output);
+    vtkDebugMacro(<<"Created " << output->GetNumberOfLines() << " edges");
+    output->Squeeze();
+    return 1;
+  }
+
   // Set up processing
   //
   edgeTable = vtkEdgeTable::New();
@@ -261,6 +570,9 @@ void vtkExtractEdges::PrintSelf(ostream& os, vtkIndent indent)
   {
     os << indent << "Locator: (none)\n";
   }
+
+  os << indent << "Parallel Extraction: "
+     << (this->ParallelExtraction ? "On\n" : "Off\n");
 }
 
 //----------------------------------------------------------------------------
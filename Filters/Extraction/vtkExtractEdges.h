@@ -57,6 +57,21 @@ public:
    */
   vtkMTimeType GetMTime() override;
 
+  //@{
+  /**
+   * Turn on/off extracting the edges in parallel (using vtkSMPTools). The
+   * edges of all cells are collected in parallel and sorted, so that the
+   * copies of each edge are adjacent and only the first is kept, instead of
+   * checking every edge against a vtkEdgeTable. The output has the same
+   * lines, in the same order, with the same attributes, except that points
+   * are merged by id: the Locator is not used and coincident input points
+   * are not merged. Off by default.
+   */
+  vtkSetMacro(ParallelExtraction,vtkTypeBool);
+  vtkGetMacro(ParallelExtraction,vtkTypeBool);
+  vtkBooleanMacro(ParallelExtraction,vtkTypeBool);
+  //@}
+
 protected:
   vtkExtractEdges();
   ~vtkExtractEdges() override;
@@ -67,6 +82,7 @@ protected:
   int FillInputPortInformation(int port, vtkInformation *info) override;
 
   vtkIncrementalPointLocator *Locator;
+  vtkTypeBool ParallelExtraction;
 private:
   vtkExtractEdges(const vtkExtractEdges&) = delete;
   void operator=(const vtkExtractEdges&) = delete;
@@ -16,6 +16,7 @@
 
 #include "vtkActor.h"
 #include "vtkCamera.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkDataSetMapper.h"
 #include "vtkDataSetSurfaceFilter.h"
@@ -39,6 +40,49 @@
 #include "vtkRungeKutta2.h"
 #include "vtkSphereSource.h"
 
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+// Get, for each path, its points followed by its seed data, sorted since
+// the threaded integration does not output paths in the same order
+std::vector<std::vector<double> > GetSortedPaths(vtkPolyData* paths,
+  vtkPointData* seedData)
+{
+  std::vector<std::vector<double> > sortedPaths;
+  vtkCellData* pathsData = paths->GetCellData();
+  vtkIdType npts;
+  vtkIdType* pts;
+  vtkCellArray* lines = paths->GetLines();
+  lines->InitTraversal();
+  for (vtkIdType cellId = 0; lines->GetNextCell(npts, pts); cellId++)
+  {
+    std::vector<double> path;
+    for (vtkIdType i = 0; i < npts; i++)
+    {
+      double* x = paths->GetPoint(pts[i]);
+      path.insert(path.end(), x, x + 3);
+    }
+    for (int i = 0; i < seedData->GetNumberOfArrays(); i++)
+    {
+      vtkDataArray* array = pathsData->GetArray(seedData->GetArrayName(i));
+      if (!array)
+      {
+        return std::vector<std::vector<double> >();
+      }
+      for (int j = 0; j < array->GetNumberOfComponents(); j++)
+      {
+        path.push_back(array->GetComponent(cellId, j));
+      }
+    }
+    sortedPaths.push_back(path);
+  }
+  std::sort(sortedPaths.begin(), sortedPaths.end());
+  return sortedPaths;
+}
+}
+
 int TestLagrangianParticleTracker(int, char*[])
 {
   // Create a point source
@@ -304,6 +348,101 @@ int TestLagrangianParticleTracker(int, char*[])
     return EXIT_FAILURE;
   }
 
+  // Check threaded integration produces the same paths and interactions,
+  // using a breaking surface and a seed index to check the seed data of the
+  // particles created during integration
+  vtkNew<vtkPlaneSource> surfaceBreak;
+  surfaceBreak->SetOrigin(-10, 3.5, -10);
+  surfaceBreak->SetPoint1(10, 3.5, -10);
+  surfaceBreak->SetPoint2(-10, 3.5, 10);
+  surfaceBreak->Update();
+  vtkNew<vtkPolyData> breakPd;
+  breakPd->DeepCopy(surfaceBreak->GetOutput());
+  vtkNew<vtkDoubleArray> surfaceTypeBreak;
+  surfaceTypeBreak->SetNumberOfComponents(1);
+  surfaceTypeBreak->SetName("SurfaceType");
+  surfaceTypeBreak->SetNumberOfTuples(breakPd->GetNumberOfCells());
+  surfaceTypeBreak->FillComponent(0,
+    vtkLagrangianBasicIntegrationModel::SURFACE_TYPE_BREAK);
+  breakPd->GetCellData()->AddArray(surfaceTypeBreak);
+
+  vtkNew<vtkMultiBlockDataGroupFilter> groupBreakSurface;
+  groupBreakSurface->AddInputDataObject(surfacePd);
+  groupBreakSurface->AddInputDataObject(breakPd);
+  groupBreakSurface->AddInputDataObject(bouncePd);
+
+  vtkNew<vtkPolyData> indexedSeedPD;
+  indexedSeedPD->DeepCopy(seedPD);
+  vtkNew<vtkDoubleArray> seedIndex;
+  seedIndex->SetName("SeedIndex");
+  seedIndex->SetNumberOfTuples(indexedSeedPD->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < indexedSeedPD->GetNumberOfPoints(); i++)
+  {
+    seedIndex->SetValue(i, i);
+  }
+  indexedSeedPD->GetPointData()->AddArray(seedIndex);
+
+  vtkNew<vtkLagrangianParticleTracker> serialTracker;
+  vtkNew<vtkLagrangianParticleTracker> threadedTracker;
+  vtkLagrangianParticleTracker* comparedTrackers[2] = { serialTracker, threadedTracker };
+  for (int i = 0; i < 2; i++)
+  {
+    comparedTrackers[i]->SetIntegrator(integrator);
+    comparedTrackers[i]->SetIntegrationModel(integrationModel);
+    comparedTrackers[i]->SetInputData(waveletImg);
+    comparedTrackers[i]->SetSourceData(indexedSeedPD);
+    comparedTrackers[i]->SetSurfaceConnection(groupBreakSurface->GetOutputPort());
+    comparedTrackers[i]->SetStepFactor(0.1);
+    comparedTrackers[i]->SetStepFactorMin(0.1);
+    comparedTrackers[i]->SetStepFactorMax(0.1);
+    comparedTrackers[i]->SetMaximumNumberOfSteps(300);
+    comparedTrackers[i]->SetCellLengthComputationMode(
+      vtkLagrangianParticleTracker::STEP_LAST_CELL_VEL_DIR);
+  }
+  threadedTracker->ThreadedIntegrationOn();
+  serialTracker->Update();
+  threadedTracker->Update();
+  if (!threadedTracker->GetThreadedIntegration())
+  {
+    std::cerr << "Incorrect ThreadedIntegration" << std::endl;
+    return EXIT_FAILURE;
+  }
+  vtkPolyData* paths = vtkPolyData::SafeDownCast(serialTracker->GetOutput());
+  vtkPolyData* threadedPaths = vtkPolyData::SafeDownCast(threadedTracker->GetOutput());
+  if (paths->GetNumberOfCells() <= indexedSeedPD->GetNumberOfPoints())
+  {
+    std::cerr << "No particle was created by the breaking surface" << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::vector<std::vector<double> > sortedPaths =
+    GetSortedPaths(paths, indexedSeedPD->GetPointData());
+  if (sortedPaths.empty() || sortedPaths !=
+    GetSortedPaths(threadedPaths, indexedSeedPD->GetPointData()))
+  {
+    std::cerr << "Threaded integration paths differ from serial integration: "
+      << threadedPaths->GetNumberOfPoints() << " points and "
+      << threadedPaths->GetNumberOfCells() << " cells instead of "
+      << paths->GetNumberOfPoints() << " points and "
+      << paths->GetNumberOfCells() << " cells" << std::endl;
+    return EXIT_FAILURE;
+  }
+  vtkMultiBlockDataSet* interactions = vtkMultiBlockDataSet::SafeDownCast(
+    serialTracker->GetOutput(1));
+  vtkMultiBlockDataSet* threadedInteractions = vtkMultiBlockDataSet::SafeDownCast(
+    threadedTracker->GetOutput(1));
+  for (unsigned int i = 0; i < interactions->GetNumberOfBlocks(); i++)
+  {
+    vtkDataSet* block = vtkDataSet::SafeDownCast(interactions->GetBlock(i));
+    vtkDataSet* threadedBlock = vtkDataSet::SafeDownCast(threadedInteractions->GetBlock(i));
+    if (block && (!threadedBlock ||
+      block->GetNumberOfPoints() != threadedBlock->GetNumberOfPoints()))
+    {
+      std::cerr << "Threaded integration interactions differ from serial integration"
+        << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
   // Glyph for interaction points
   vtkNew<vtkSphereSource> sphereGlyph;
   sphereGlyph->SetRadius(0.1);
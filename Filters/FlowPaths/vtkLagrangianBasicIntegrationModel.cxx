@@ -586,6 +586,45 @@ void vtkLagrangianBasicIntegrationModel::PrintSelf(ostream& os, vtkIndent indent
   os << indent << "Tolerance: " << this->Tolerance << endl;
 }
 
+//----------------------------------------------------------------------------
+vtkLagrangianBasicIntegrationModel* vtkLagrangianBasicIntegrationModel::NewThreadedCopy()
+{
+  vtkLagrangianBasicIntegrationModel* copy = this->NewInstance();
+  copy->InitializeThreadedCopy(this);
+  return copy;
+}
+
+//----------------------------------------------------------------------------
+void vtkLagrangianBasicIntegrationModel::InitializeThreadedCopy(
+  vtkLagrangianBasicIntegrationModel* model)
+{
+  this->SetLocator(model->Locator);
+  this->Tracker = model->Tracker;
+  this->InputArrays = model->InputArrays;
+  this->SurfaceArrayDescriptions = model->SurfaceArrayDescriptions;
+  this->Tolerance = model->Tolerance;
+  this->NonPlanarQuadSupport = model->NonPlanarQuadSupport;
+  this->UseInitialIntegrationTime = model->UseInitialIntegrationTime;
+
+  // Flow datasets and locators are shared, FindCell is only a read access
+  // once the locators are built
+  this->ClearDataSets();
+  this->DataSets->assign(model->DataSets->begin(), model->DataSets->end());
+  this->Locators->assign(model->Locators->begin(), model->Locators->end());
+  this->WeightsSize = model->WeightsSize;
+  this->LastWeights = new double[this->WeightsSize];
+  this->LocatorsBuilt = model->LocatorsBuilt;
+
+  // Surface locators keep a per query state when intersecting lines,
+  // so each copy builds its own
+  this->ClearDataSets(/*surface*/ true);
+  for (size_t iDs = 0; iDs < model->Surfaces->size(); iDs++)
+  {
+    this->AddDataSet((*model->Surfaces)[iDs].second, /*surface*/ true,
+      (*model->Surfaces)[iDs].first);
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkLagrangianBasicIntegrationModel::SetTracker(
   vtkLagrangianParticleTracker* tracker)
@@ -763,8 +802,9 @@ vtkLagrangianParticle* vtkLagrangianBasicIntegrationModel::ComputeSurfaceInterac
         double tmpFactor;
         double tmpPoint[3];
         vtkIdType tmpCellId = cellList->GetId(i);
-        vtkCell* cell = tmpSurface->GetCell(tmpCellId);
-        if (this->IntersectWithLine(cell, particle->GetPosition(),
+        tmpSurface->GetCell(tmpCellId, this->Cell);
+        if (this->IntersectWithLine(this->Cell->GetRepresentativeCell(),
+          particle->GetPosition(),
           particle->GetNextPosition(), this->Tolerance,
           tmpFactor, tmpPoint) == 0)
         {
@@ -939,10 +979,8 @@ bool vtkLagrangianBasicIntegrationModel::BreakParticle(vtkLagrangianParticle* pa
   surface->GetCellData()->GetNormals()->GetTuple(cellId, normal);
 
   // Create new particles
-  vtkLagrangianParticle* particle1 =
-    particle->NewParticle(this->Tracker->GetNewParticleId());
-  vtkLagrangianParticle* particle2 =
-    particle->NewParticle(this->Tracker->GetNewParticleId());
+  vtkLagrangianParticle* particle1 = this->Tracker->NewChildParticle(particle);
+  vtkLagrangianParticle* particle2 = this->Tracker->NewChildParticle(particle);
 
   // Compute bounce for each new particle
   double* nextVel = particle->GetNextVelocity();
@@ -1355,8 +1393,9 @@ bool vtkLagrangianBasicIntegrationModel::GetFlowOrSurfaceData(int idx, vtkDataSe
       this->TmpArray = array->NewInstance();
       this->TmpArray->SetNumberOfComponents(nComponents);
       this->TmpArray->SetNumberOfTuples(1);
+      dataSet->GetCell(tupleId, this->Cell);
       this->TmpArray->InterpolateTuple(
-        0, dataSet->GetCell(tupleId)->GetPointIds(), array, weights);
+        0, this->Cell->GetPointIds(), array, weights);
 
       // Recover data
       data = this->TmpArray->GetTuple(0);
@@ -1379,7 +1418,9 @@ bool vtkLagrangianBasicIntegrationModel::GetFlowOrSurfaceData(int idx, vtkDataSe
         return false;
       }
       nComponents = array->GetNumberOfComponents();
-      data = array->GetTuple(tupleId);
+      this->TmpTuple.resize(nComponents);
+      array->GetTuple(tupleId, this->TmpTuple.data());
+      data = this->TmpTuple.data();
       return true;
     }
     case vtkDataObject::FIELD_ASSOCIATION_NONE:
@@ -1393,7 +1434,9 @@ bool vtkLagrangianBasicIntegrationModel::GetFlowOrSurfaceData(int idx, vtkDataSe
         return false;
       }
       nComponents = array->GetNumberOfComponents();
-      data = array->GetTuple(tupleId);
+      this->TmpTuple.resize(nComponents);
+      array->GetTuple(tupleId, this->TmpTuple.data());
+      data = this->TmpTuple.data();
       return true;
     }
     default:
@@ -58,6 +58,7 @@
 
 #include <queue> // for new particles
 #include <map> // for array indexes
+#include <vector> // for tuple cache
 
 class vtkAbstractArray;
 class vtkAbstractCellLocator;
@@ -396,10 +397,29 @@ public:
    */
   virtual vtkAbstractArray* GetSeedArray(int idx, vtkPointData* pointData);
 
+  /**
+   * Create a copy of this model to be used by a single thread of the
+   * tracker threaded integration. The copy shares the flow datasets and
+   * their locators, which are only read while integrating, but owns its
+   * own surface locators, cell and interpolation caches, so that
+   * FunctionValues and ComputeSurfaceInteraction can be called concurrently
+   * on distinct copies. The caller is responsible for deleting the copy.
+   * Inherited classes with additional state should reimplement
+   * InitializeThreadedCopy.
+   */
+  virtual vtkLagrangianBasicIntegrationModel* NewThreadedCopy();
+
 protected:
   vtkLagrangianBasicIntegrationModel();
   ~vtkLagrangianBasicIntegrationModel() override;
 
+  /**
+   * Copy the parameters and the flow and surface datasets of the provided
+   * model into this one, building new surface locators.
+   * Called by NewThreadedCopy on a NewInstance of the model.
+   */
+  virtual void InitializeThreadedCopy(vtkLagrangianBasicIntegrationModel* model);
+
   /**
    * Actually compute the integration model velocity field
    * pure abstract, to be implemented in inherited class
@@ -532,6 +552,7 @@ protected:
   vtkLocatorsType* SurfaceLocators;
 
   vtkDataArray* TmpArray;
+  std::vector<double> TmpTuple;
 
   double Tolerance;
   bool NonPlanarQuadSupport;
@@ -92,9 +92,15 @@ vtkLagrangianParticle* vtkLagrangianParticle::NewInstance(int numberOfVariables,
 
 //---------------------------------------------------------------------------
 vtkLagrangianParticle* vtkLagrangianParticle::NewParticle(vtkIdType particleId)
+{
+  return this->NewParticle(particleId, this->GetSeedData());
+}
+
+//---------------------------------------------------------------------------
+vtkLagrangianParticle* vtkLagrangianParticle::NewParticle(vtkIdType particleId,
+  vtkPointData* seedData)
 {
   // Copy point data tuples
-  vtkPointData* seedData = this->GetSeedData();
   vtkIdType seedArrayTupleIndex = this->GetSeedArrayTupleIndex();
   if (seedData->GetNumberOfArrays() > 0)
   {
@@ -103,7 +109,7 @@ vtkLagrangianParticle* vtkLagrangianParticle::NewParticle(vtkIdType particleId)
     seedData->CopyAllocate(
       seedData, seedArrayTupleIndex + 1);
     seedData->CopyData(
-      seedData, parentSeedArrayTupleIndex, seedArrayTupleIndex);
+      this->GetSeedData(), parentSeedArrayTupleIndex, seedArrayTupleIndex);
   }
 
   // Create particle and copy members
@@ -243,6 +249,14 @@ vtkPointData* vtkLagrangianParticle::GetSeedData()
   return this->SeedData;
 }
 
+//---------------------------------------------------------------------------
+void vtkLagrangianParticle::SetSeedData(vtkPointData* seedData,
+  vtkIdType seedArrayTupleIndex)
+{
+  this->SeedData = seedData;
+  this->SeedArrayTupleIndex = seedArrayTupleIndex;
+}
+
 //---------------------------------------------------------------------------
 double& vtkLagrangianParticle::GetStepTimeRef()
 {
@@ -113,6 +113,13 @@ public:
    */
   vtkLagrangianParticle* NewParticle(vtkIdType particleId);
 
+  /**
+   * method to create a particle from a parent particle, as NewParticle does,
+   * but appending the copy of the parent seed data tuple to the provided
+   * seedData, which must have the same structure as the parent seed data.
+   */
+  vtkLagrangianParticle* NewParticle(vtkIdType particleId, vtkPointData* seedData);
+
   /**
    * method to create an exact clone of a particle.
    */
@@ -323,6 +330,12 @@ public:
    */
   virtual vtkPointData* GetSeedData();
 
+  /**
+   * Set the particle data and the particle data tuple in it, to be used
+   * when the particle data tuple is moved to another particle data.
+   */
+  virtual void SetSeedData(vtkPointData* seedData, vtkIdType seedArrayTupleIndex);
+
   /**
    * Get the last traversed cell id
    */
@@ -22,27 +22,32 @@
 #include "vtkDataSetSurfaceFilter.h"
 #include "vtkDoubleArray.h"
 #include "vtkExecutive.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
 #include "vtkLagrangianMatidaIntegrationModel.h"
 #include "vtkLagrangianParticle.h"
 #include "vtkLongLongArray.h"
+#include "vtkMutexLock.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkPolyDataNormals.h"
-#include "vtkPolyLine.h"
 #include "vtkPolygon.h"
 #include "vtkRungeKutta2.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkVoxel.h"
 
 #include <algorithm>
 #include <limits>
 #include <sstream>
+#include <vector>
 
 vtkObjectFactoryNewMacro(vtkLagrangianParticleTracker);
 vtkCxxSetObjectMacro(vtkLagrangianParticleTracker, IntegrationModel, vtkLagrangianBasicIntegrationModel);
@@ -71,8 +76,11 @@ vtkLagrangianParticleTracker::vtkLagrangianParticleTracker()
   this->UseParticlePathsRenderingThreshold = false;
   this->GeneratePolyVertexInteractionOutput = false;
   this->ParticlePathsRenderingPointsThreshold = 100;
+  this->ThreadedIntegration = false;
 
   this->ParticleCounter = 0;
+  this->ParticleCounterLock = vtkSimpleMutexLock::New();
+  this->IntegrateFunctor = nullptr;
 
   this->FlowCache = nullptr;
   this->FlowTime = 0;
@@ -85,6 +93,7 @@ vtkLagrangianParticleTracker::~vtkLagrangianParticleTracker()
 {
   this->SetIntegrator(nullptr);
   this->SetIntegrationModel(nullptr);
+  this->ParticleCounterLock->Delete();
 }
 
 //---------------------------------------------------------------------------
@@ -121,6 +130,7 @@ void vtkLagrangianParticleTracker::PrintSelf(ostream& os, vtkIndent indent)
     << this->UseParticlePathsRenderingThreshold << endl;
   os << indent << "ParticlePathsRenderingPointsThreshold: "
     << this->ParticlePathsRenderingPointsThreshold << endl;
+  os << indent << "ThreadedIntegration: " << this->ThreadedIntegration << endl;
   os << indent << "MinimumVelocityMagnitude: " << this->MinimumVelocityMagnitude << endl;
   os << indent << "MinimumReductionFactor: " << this->MinimumReductionFactor << endl;
   os << indent << "ParticleCounter: " << this->ParticleCounter << endl;
@@ -271,46 +281,41 @@ int vtkLagrangianParticleTracker::RequestData(
   // before integration.
   this->IntegrationModel->PreIntegrate(particlesQueue);
 
-  // Integrate each particle
-  while (!this->GetAbortExecute())
+  if (this->CanUseThreadedIntegration())
   {
-    // Check for particle feed
-    this->GetParticleFeed(particlesQueue);
-    if (particlesQueue.empty())
+    this->IntegrateParticlesThreaded(particlesQueue, seedData,
+      particlePathsOutput, interactionOutput);
+  }
+  else
+  {
+    // Integrate each particle
+    while (!this->GetAbortExecute())
     {
-      break;
-    }
-
-    // Recover particle
-    vtkLagrangianParticle* particle = particlesQueue.front();
-    particlesQueue.pop();
+      // Check for particle feed
+      this->GetParticleFeed(particlesQueue);
+      if (particlesQueue.empty())
+      {
+        break;
+      }
 
-    // Create polyLine output cell
-    vtkNew<vtkPolyLine> particlePath;
+      // Recover particle
+      vtkLagrangianParticle* particle = particlesQueue.front();
+      particlesQueue.pop();
 
-    // Integrate
-    this->Integrate(particle, particlesQueue, particlePathsOutput,
-      particlePath->GetPointIds(), interactionOutput);
+      // Create particle path point ids
+      vtkNew<vtkIdList> particlePathPointId;
 
-    if (particlePath->GetPointIds()->GetNumberOfIds() == 1)
-    {
-      particlePath->GetPointIds()->InsertNextId(particlePath->GetPointId(0));
-    }
+      // Integrate
+      this->Integrate(particle, particlesQueue, particlePathsOutput,
+        particlePathPointId, interactionOutput);
 
-    // Duplicate single point particle paths, to avoid degenerated lines.
-    if (particlePath->GetPointIds()->GetNumberOfIds() > 0)
-    {
-      // Add particle path or vertex to cell array
-      particlePathsOutput->GetLines()->InsertNextCell(particlePath);
-      this->InsertPathData(particle, particlePathsOutput->GetCellData());
-      this->IntegrationModel->InsertModelPathData(particle, particlePathsOutput->GetCellData());
+      // Add particle path to cell array
+      this->InsertParticlePath(this->IntegrationModel, particle,
+        particlePathsOutput, particlePathPointId);
 
-      // Insert data from seed data only on not yet written arrays
-      this->InsertSeedData(particle, particlePathsOutput->GetCellData());
+      // Delete integrated particle
+      delete particle;
     }
-
-    // Delete integrated particle
-    delete particle;
   }
 
   // Abort if necessary
@@ -333,6 +338,362 @@ int vtkLagrangianParticleTracker::RequestData(
   return 1;
 }
 
+//---------------------------------------------------------------------------
+void vtkLagrangianParticleTracker::InsertParticlePath(
+  vtkLagrangianBasicIntegrationModel* model, vtkLagrangianParticle* particle,
+  vtkPolyData* particlePathsOutput, vtkIdList* particlePathPointId)
+{
+  // Duplicate single point particle paths, to avoid degenerated lines.
+  if (particlePathPointId->GetNumberOfIds() == 1)
+  {
+    particlePathPointId->InsertNextId(particlePathPointId->GetId(0));
+  }
+
+  if (particlePathPointId->GetNumberOfIds() > 0)
+  {
+    // Add particle path or vertex to cell array
+    particlePathsOutput->GetLines()->InsertNextCell(particlePathPointId);
+    this->InsertPathData(particle, particlePathsOutput->GetCellData());
+    model->InsertModelPathData(particle, particlePathsOutput->GetCellData());
+
+    // Insert data from seed data only on not yet written arrays
+    this->InsertSeedData(particle, particlePathsOutput->GetCellData());
+  }
+}
+
+//---------------------------------------------------------------------------
+namespace
+{
+// Create an empty polydata with the same arrays as the provided one
+vtkPolyData* vtkLagrangianNewEmptyPolyData(vtkPolyData* pd)
+{
+  vtkPolyData* copy = vtkPolyData::New();
+  if (pd->GetPoints())
+  {
+    vtkNew<vtkPoints> points;
+    points->SetDataType(pd->GetPoints()->GetDataType());
+    copy->SetPoints(points);
+  }
+  vtkNew<vtkCellArray> lines;
+  copy->SetLines(lines);
+  copy->GetPointData()->CopyStructure(pd->GetPointData());
+  copy->GetCellData()->CopyStructure(pd->GetCellData());
+  return copy;
+}
+
+// Append the points, lines and data of src at the end of dest,
+// which have the same arrays
+void vtkLagrangianAppendPolyData(vtkPolyData* dest, vtkPolyData* src)
+{
+  vtkIdType nPoints = src->GetNumberOfPoints();
+  if (nPoints == 0)
+  {
+    return;
+  }
+  vtkIdType offset = dest->GetNumberOfPoints();
+  dest->GetPoints()->InsertPoints(offset, nPoints, 0, src->GetPoints());
+
+  vtkDataSetAttributes* attributes[2][2] = {
+    { dest->GetPointData(), src->GetPointData() },
+    { dest->GetCellData(), src->GetCellData() } };
+  for (int i = 0; i < 2; i++)
+  {
+    for (int j = 0; j < attributes[i][0]->GetNumberOfArrays(); j++)
+    {
+      vtkAbstractArray* destArray = attributes[i][0]->GetAbstractArray(j);
+      vtkAbstractArray* srcArray =
+        attributes[i][1]->GetAbstractArray(destArray->GetName());
+      if (srcArray && srcArray->GetNumberOfTuples() > 0)
+      {
+        destArray->InsertTuples(destArray->GetNumberOfTuples(),
+          srcArray->GetNumberOfTuples(), 0, srcArray);
+      }
+    }
+  }
+
+  vtkCellArray* srcLines = src->GetLines();
+  vtkCellArray* destLines = dest->GetLines();
+  if (srcLines && destLines)
+  {
+    vtkIdType npts;
+    vtkIdType* pts;
+    for (srcLines->InitTraversal(); srcLines->GetNextCell(npts, pts);)
+    {
+      destLines->InsertNextCell(npts);
+      for (vtkIdType i = 0; i < npts; i++)
+      {
+        destLines->InsertCellPoint(pts[i] + offset);
+      }
+    }
+  }
+}
+
+// Create an empty interaction output with the same structure and arrays
+// as the provided one
+vtkDataObject* vtkLagrangianNewEmptyInteractionOutput(vtkDataObject* interactionOutput)
+{
+  vtkCompositeDataSet* hd = vtkCompositeDataSet::SafeDownCast(interactionOutput);
+  if (hd)
+  {
+    vtkCompositeDataSet* copy = hd->NewInstance();
+    copy->CopyStructure(hd);
+    vtkSmartPointer<vtkCompositeDataIterator> iter;
+    iter.TakeReference(hd->NewIterator());
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+    {
+      vtkPolyData* pd = vtkPolyData::SafeDownCast(hd->GetDataSet(iter));
+      if (pd)
+      {
+        vtkPolyData* pdCopy = vtkLagrangianNewEmptyPolyData(pd);
+        copy->SetDataSet(iter, pdCopy);
+        pdCopy->Delete();
+      }
+    }
+    return copy;
+  }
+  return vtkLagrangianNewEmptyPolyData(vtkPolyData::SafeDownCast(interactionOutput));
+}
+
+// Append a thread interaction output into the actual interaction output
+void vtkLagrangianAppendInteractionOutput(vtkDataObject* dest, vtkDataObject* src)
+{
+  vtkCompositeDataSet* hdDest = vtkCompositeDataSet::SafeDownCast(dest);
+  vtkCompositeDataSet* hdSrc = vtkCompositeDataSet::SafeDownCast(src);
+  if (hdDest && hdSrc)
+  {
+    vtkSmartPointer<vtkCompositeDataIterator> iter;
+    iter.TakeReference(hdDest->NewIterator());
+    for (iter->InitTraversal(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+    {
+      vtkPolyData* pdDest = vtkPolyData::SafeDownCast(hdDest->GetDataSet(iter));
+      vtkPolyData* pdSrc = vtkPolyData::SafeDownCast(hdSrc->GetDataSet(iter));
+      if (pdDest && pdSrc)
+      {
+        vtkLagrangianAppendPolyData(pdDest, pdSrc);
+      }
+    }
+  }
+  else
+  {
+    vtkPolyData* pdDest = vtkPolyData::SafeDownCast(dest);
+    vtkPolyData* pdSrc = vtkPolyData::SafeDownCast(src);
+    if (pdDest && pdSrc)
+    {
+      vtkLagrangianAppendPolyData(pdDest, pdSrc);
+    }
+  }
+}
+
+// Per thread integration state
+struct vtkLagrangianThreadedData
+{
+  vtkSmartPointer<vtkLagrangianBasicIntegrationModel> Model;
+  vtkSmartPointer<vtkInitialValueProblemSolver> Integrator;
+  vtkSmartPointer<vtkGenericCell> Cell;
+  vtkSmartPointer<vtkIdList> ParticlePathPointId;
+  vtkSmartPointer<vtkPolyData> ParticlePathsOutput;
+  vtkSmartPointer<vtkDataObject> InteractionOutput;
+  std::queue<vtkLagrangianParticle*> NewParticles;
+  // Seed data of the particles created during the batch, appended to the
+  // actual seed data once the batch is integrated
+  vtkSmartPointer<vtkPointData> NewSeedData;
+};
+}
+
+//---------------------------------------------------------------------------
+// Integrate a batch of particles concurrently, each thread using its own
+// copy of the integration model and integrator and its own outputs.
+class vtkLagrangianParticleTrackerIntegrateFunctor
+{
+public:
+  vtkLagrangianParticleTrackerIntegrateFunctor(vtkLagrangianParticleTracker* tracker,
+    vtkPointData* seedData, vtkPolyData* particlePathsOutput,
+    vtkDataObject* interactionOutput)
+    : Tracker(tracker)
+    , SeedData(seedData)
+    , ParticlePathsOutput(particlePathsOutput)
+    , InteractionOutput(interactionOutput)
+  {
+  }
+
+  ~vtkLagrangianParticleTrackerIntegrateFunctor()
+  {
+    // Delete particles which have been created but not integrated
+    for (auto dataIter = this->ThreadedData.begin();
+      dataIter != this->ThreadedData.end(); ++dataIter)
+    {
+      while (!(*dataIter).NewParticles.empty())
+      {
+        delete (*dataIter).NewParticles.front();
+        (*dataIter).NewParticles.pop();
+      }
+    }
+  }
+
+  void SetParticles(std::vector<vtkLagrangianParticle*>* particles)
+  {
+    this->Particles = particles;
+  }
+
+  void Initialize()
+  {
+    vtkLagrangianThreadedData& data = this->ThreadedData.Local();
+    if (data.Model)
+    {
+      // Thread data are kept between batches
+      return;
+    }
+
+    // Models and integrators copies are created one at a time,
+    // since building surfaces locators is not thread safe.
+    this->Tracker->ParticleCounterLock->Lock();
+    data.Model.TakeReference(this->Tracker->IntegrationModel->NewThreadedCopy());
+    data.Integrator.TakeReference(this->Tracker->Integrator->NewInstance());
+    data.Integrator->SetFunctionSet(data.Model);
+    data.Cell = vtkSmartPointer<vtkGenericCell>::New();
+    data.ParticlePathPointId = vtkSmartPointer<vtkIdList>::New();
+    data.ParticlePathsOutput.TakeReference(
+      vtkLagrangianNewEmptyPolyData(this->ParticlePathsOutput));
+    data.InteractionOutput.TakeReference(
+      vtkLagrangianNewEmptyInteractionOutput(this->InteractionOutput));
+    data.NewSeedData = vtkSmartPointer<vtkPointData>::New();
+    data.NewSeedData->CopyStructure(this->SeedData);
+    this->Tracker->ParticleCounterLock->Unlock();
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkLagrangianThreadedData& data = this->ThreadedData.Local();
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      vtkLagrangianParticle* particle = (*this->Particles)[i];
+      if (!this->Tracker->GetAbortExecute())
+      {
+        data.ParticlePathPointId->Reset();
+        this->Tracker->IntegrateParticle(data.Model, data.Integrator, data.Cell,
+          particle, data.NewParticles, data.ParticlePathsOutput,
+          data.ParticlePathPointId, data.InteractionOutput, false);
+        this->Tracker->InsertParticlePath(data.Model, particle,
+          data.ParticlePathsOutput, data.ParticlePathPointId);
+      }
+      delete particle;
+    }
+  }
+
+  void Reduce()
+  {
+  }
+
+  // Create a particle from a parent particle during a batch, its seed data
+  // tuple being appended to the seed data of the calling thread
+  vtkLagrangianParticle* NewChildParticle(vtkLagrangianParticle* parent,
+    vtkIdType particleId)
+  {
+    return parent->NewParticle(particleId, this->ThreadedData.Local().NewSeedData);
+  }
+
+  // Append the seed data of the particles created during the last batch to
+  // the actual seed data and move these particles to the provided queue
+  void CollectNewParticles(std::queue<vtkLagrangianParticle*>& particlesQueue)
+  {
+    for (auto dataIter = this->ThreadedData.begin();
+      dataIter != this->ThreadedData.end(); ++dataIter)
+    {
+      vtkPointData* newSeedData = (*dataIter).NewSeedData;
+      vtkIdType offset = this->SeedData->GetNumberOfTuples();
+      vtkIdType nNewTuples = newSeedData->GetNumberOfTuples();
+      for (int i = 0; nNewTuples > 0 && i < this->SeedData->GetNumberOfArrays(); i++)
+      {
+        this->SeedData->GetAbstractArray(i)->InsertTuples(
+          offset, nNewTuples, 0, newSeedData->GetAbstractArray(i));
+      }
+      newSeedData->Reset();
+
+      while (!(*dataIter).NewParticles.empty())
+      {
+        vtkLagrangianParticle* particle = (*dataIter).NewParticles.front();
+        if (particle->GetSeedData() == newSeedData)
+        {
+          particle->SetSeedData(
+            this->SeedData, offset + particle->GetSeedArrayTupleIndex());
+        }
+        particlesQueue.push(particle);
+        (*dataIter).NewParticles.pop();
+      }
+    }
+  }
+
+  // Merge the threads outputs into the actual outputs
+  void MergeOutputs()
+  {
+    for (auto dataIter = this->ThreadedData.begin();
+      dataIter != this->ThreadedData.end(); ++dataIter)
+    {
+      if ((*dataIter).Model)
+      {
+        vtkLagrangianAppendPolyData(this->ParticlePathsOutput,
+          (*dataIter).ParticlePathsOutput);
+        vtkLagrangianAppendInteractionOutput(this->InteractionOutput,
+          (*dataIter).InteractionOutput);
+      }
+    }
+  }
+
+private:
+  vtkLagrangianParticleTracker* Tracker;
+  vtkPointData* SeedData;
+  vtkPolyData* ParticlePathsOutput;
+  vtkDataObject* InteractionOutput;
+  std::vector<vtkLagrangianParticle*>* Particles = nullptr;
+  vtkSMPThreadLocal<vtkLagrangianThreadedData> ThreadedData;
+};
+
+//---------------------------------------------------------------------------
+bool vtkLagrangianParticleTracker::CanUseThreadedIntegration()
+{
+  return this->ThreadedIntegration;
+}
+
+//---------------------------------------------------------------------------
+void vtkLagrangianParticleTracker::IntegrateParticlesThreaded(
+  std::queue<vtkLagrangianParticle*>& particlesQueue, vtkPointData* seedData,
+  vtkPolyData* particlePathsOutput, vtkDataObject* interactionOutput)
+{
+  vtkLagrangianParticleTrackerIntegrateFunctor functor(this, seedData,
+    particlePathsOutput, interactionOutput);
+  this->IntegrateFunctor = &functor;
+  std::vector<vtkLagrangianParticle*> particles;
+  vtkIdType nIntegrated = 0;
+  while (!this->GetAbortExecute())
+  {
+    // Check for particle feed
+    this->GetParticleFeed(particlesQueue);
+    if (particlesQueue.empty())
+    {
+      break;
+    }
+
+    // Integrate the queued particles as a batch
+    particles.clear();
+    while (!particlesQueue.empty())
+    {
+      particles.push_back(particlesQueue.front());
+      particlesQueue.pop();
+    }
+    vtkIdType nParticles = static_cast<vtkIdType>(particles.size());
+    functor.SetParticles(&particles);
+    vtkSMPTools::For(0, nParticles, functor);
+    functor.CollectNewParticles(particlesQueue);
+
+    nIntegrated += nParticles;
+    this->UpdateProgress(std::min(1.0, static_cast<double>(nIntegrated) /
+      std::max(this->ParticleCounter, static_cast<vtkIdType>(1))));
+  }
+
+  functor.MergeOutputs();
+  this->IntegrateFunctor = nullptr;
+}
+
 //---------------------------------------------------------------------------
 bool vtkLagrangianParticleTracker::CheckParticlePathsRenderingThreshold(vtkPolyData* particlePathsOutput)
 {
@@ -357,6 +718,23 @@ vtkIdType vtkLagrangianParticleTracker::GetNewParticleId()
   return id;
 }
 
+//---------------------------------------------------------------------------
+vtkLagrangianParticle* vtkLagrangianParticleTracker::NewChildParticle(
+  vtkLagrangianParticle* parent)
+{
+  if (!this->IntegrateFunctor)
+  {
+    return parent->NewParticle(this->GetNewParticleId());
+  }
+
+  // The particle counter is shared between integration threads, while the
+  // seed data tuple is buffered by the thread until the end of the batch
+  this->ParticleCounterLock->Lock();
+  vtkIdType particleId = this->GetNewParticleId();
+  this->ParticleCounterLock->Unlock();
+  return this->IntegrateFunctor->NewChildParticle(parent, particleId);
+}
+
 //---------------------------------------------------------------------------
 bool vtkLagrangianParticleTracker::InitializeInputs(vtkInformationVector **inputVector,
   vtkDataObject*& flow, vtkDataObject*& seeds, vtkDataObject*& surfaces,
@@ -979,6 +1357,20 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
   std::queue<vtkLagrangianParticle*>& particlesQueue,
   vtkPolyData* particlePathsOutput, vtkIdList* particlePathPointId,
   vtkDataObject* interactionOutput)
+{
+  vtkNew<vtkGenericCell> cell;
+  return this->IntegrateParticle(this->IntegrationModel, this->Integrator, cell,
+    particle, particlesQueue, particlePathsOutput, particlePathPointId,
+    interactionOutput, true);
+}
+
+//---------------------------------------------------------------------------
+int vtkLagrangianParticleTracker::IntegrateParticle(
+  vtkLagrangianBasicIntegrationModel* model,
+  vtkInitialValueProblemSolver* integrator, vtkGenericCell* cell,
+  vtkLagrangianParticle* particle, std::queue<vtkLagrangianParticle*>& particlesQueue,
+  vtkPolyData* particlePathsOutput, vtkIdList* particlePathPointId,
+  vtkDataObject* interactionOutput, bool reportProgress)
 {
   // Sanity check
   if (particle == nullptr)
@@ -988,7 +1380,7 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
   }
 
   // Set the current particle
-  this->IntegrationModel->SetCurrentParticle(particle);
+  model->SetCurrentParticle(particle);
 
   // Integrate until MaximumNumberOfSteps or MaximumIntegrationTime is reached or special case stops integration
   int integrationRes = 0;
@@ -999,7 +1391,8 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
          vtkLagrangianParticle::PARTICLE_TERMINATION_NOT_TERMINATED)
   {
     // Update progress
-    if (particle->GetNumberOfSteps() % 100 == 0 && this->ParticleCounter > 0)
+    if (reportProgress &&
+      particle->GetNumberOfSteps() % 100 == 0 && this->ParticleCounter > 0)
     {
       double progress = 1.0;
       if (this->MaximumNumberOfSteps != -1)
@@ -1025,7 +1418,7 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
     double velocityMagnitude = reintegrationFactor * std::max(
       this->MinimumVelocityMagnitude,
       vtkMath::Norm(particle->GetVelocity()));
-    double cellLength = this->ComputeCellLength(particle);
+    double cellLength = this->ComputeCellLength(model, cell, particle);
 
     double stepLength    = stepFactor          * cellLength;
     double stepLengthMin = this->StepFactorMin * cellLength;
@@ -1035,7 +1428,8 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
     double stepTimeMax = stepLengthMax / (reintegrationFactor * velocityMagnitude);
 
     // Integrate one step
-    if (!this->ComputeNextStep(particle->GetEquationVariables(),
+    if (!this->ComputeNextStep(model, integrator,
+      particle->GetEquationVariables(),
       particle->GetNextEquationVariables(), particle->GetIntegrationTime(),
       stepTime, stepTimeActual, stepTimeMin, stepTimeMax, integrationRes))
     {
@@ -1057,7 +1451,7 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
 
     // Simpler Adaptive Step Reintegration code
     if (this->AdaptiveStepReintegration &&
-        this->IntegrationModel->CheckAdaptiveStepReintegration(particle))
+        model->CheckAdaptiveStepReintegration(particle))
     {
       double stepLengthCurr2 = vtkMath::Distance2BetweenPoints(
         particle->GetPosition(), particle->GetNextPosition());
@@ -1084,11 +1478,11 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
       vtkLagrangianBasicIntegrationModel::PassThroughParticlesType passThroughParticles;
       unsigned int interactedSurfaceFlaxIndex;
       vtkLagrangianParticle* interactionParticle =
-        this->IntegrationModel->ComputeSurfaceInteraction(
+        model->ComputeSurfaceInteraction(
         particle, particlesQueue, interactedSurfaceFlaxIndex, passThroughParticles);
       if (interactionParticle != nullptr)
       {
-        this->InsertInteractionOutputPoint(interactionParticle,
+        this->InsertInteractionOutputPoint(model, interactionParticle,
           interactedSurfaceFlaxIndex, interactionOutput);
         delete interactionParticle;
         interactionParticle = nullptr;
@@ -1104,7 +1498,7 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
         vtkLagrangianBasicIntegrationModel::PassThroughParticlesItem item =
           passThroughParticles.front();
         passThroughParticles.pop();
-        this->InsertInteractionOutputPoint(item.second, item.first, interactionOutput);
+        this->InsertInteractionOutputPoint(model, item.second, item.first, interactionOutput);
 
         // the pass through particles needs to be deleted
         delete item.second;
@@ -1112,7 +1506,7 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
 
       // Particle has been correctly integrated and interacted, record it
       // Insert Current particle as an output point
-      this->InsertPathOutputPoint(particle, particlePathsOutput, particlePathPointId);
+      this->InsertPathOutputPoint(model, particle, particlePathsOutput, particlePathPointId);
 
       // Particle has been terminated by surface
       if (particle->GetTermination() !=
@@ -1120,14 +1514,14 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
       {
         // Insert last particle path point on surface
         particle->MoveToNextPosition();
-        this->InsertPathOutputPoint(particle, particlePathsOutput, particlePathPointId);
+        this->InsertPathOutputPoint(model, particle, particlePathsOutput, particlePathPointId);
 
         // stop integration
         break;
       }
     }
 
-    if (this->IntegrationModel->CheckFreeFlightTermination(particle))
+    if (model->CheckFreeFlightTermination(particle))
     {
       particle->SetTermination(
         vtkLagrangianParticle::PARTICLE_TERMINATION_FLIGHT_TERMINATED);
@@ -1138,7 +1532,7 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
     particle->MoveToNextPosition();
 
     // Compute now adaptive step
-    if (this->Integrator->IsAdaptive() || this->AdaptiveStepReintegration)
+    if (integrator->IsAdaptive() || this->AdaptiveStepReintegration)
     {
       stepFactor = stepTime * reintegrationFactor * velocityMagnitude / cellLength;
     }
@@ -1160,7 +1554,7 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
     }
   }
 
-  this->IntegrationModel->SetCurrentParticle(nullptr);
+  model->SetCurrentParticle(nullptr);
   return integrationRes;
 }
 
@@ -1168,6 +1562,15 @@ int vtkLagrangianParticleTracker::Integrate(vtkLagrangianParticle* particle,
 void vtkLagrangianParticleTracker::InsertPathOutputPoint(
   vtkLagrangianParticle* particle, vtkPolyData* particlePathsOutput,
   vtkIdList* particlePathPointId, bool prev)
+{
+  this->InsertPathOutputPoint(this->IntegrationModel, particle,
+    particlePathsOutput, particlePathPointId, prev);
+}
+
+//---------------------------------------------------------------------------
+void vtkLagrangianParticleTracker::InsertPathOutputPoint(
+  vtkLagrangianBasicIntegrationModel* model, vtkLagrangianParticle* particle,
+  vtkPolyData* particlePathsOutput, vtkIdList* particlePathPointId, bool prev)
 {
   // Recover structures
   vtkPoints* particlePathsPoints = particlePathsOutput->GetPoints();
@@ -1185,7 +1588,7 @@ void vtkLagrangianParticleTracker::InsertPathOutputPoint(
     vtkLagrangianBasicIntegrationModel::VARIABLE_STEP_CURRENT);
 
   // Add Variables data
-  this->IntegrationModel->InsertVariablesParticleData(particle,
+  model->InsertVariablesParticleData(particle,
     particlePathsPointData, prev ?
     vtkLagrangianBasicIntegrationModel::VARIABLE_STEP_PREV :
     vtkLagrangianBasicIntegrationModel::VARIABLE_STEP_CURRENT);
@@ -1195,6 +1598,15 @@ void vtkLagrangianParticleTracker::InsertPathOutputPoint(
 void vtkLagrangianParticleTracker::InsertInteractionOutputPoint(
   vtkLagrangianParticle* particle, unsigned int interactedSurfaceFlatIndex,
   vtkDataObject* interactionOutput)
+{
+  this->InsertInteractionOutputPoint(this->IntegrationModel, particle,
+    interactedSurfaceFlatIndex, interactionOutput);
+}
+
+//---------------------------------------------------------------------------
+void vtkLagrangianParticleTracker::InsertInteractionOutputPoint(
+  vtkLagrangianBasicIntegrationModel* model, vtkLagrangianParticle* particle,
+  unsigned int interactedSurfaceFlatIndex, vtkDataObject* interactionOutput)
 {
   // Find the correct output
   vtkCompositeDataSet *hdOutput = vtkCompositeDataSet::SafeDownCast(interactionOutput);
@@ -1232,13 +1644,13 @@ void vtkLagrangianParticleTracker::InsertInteractionOutputPoint(
   // Fill up interaction point data
   vtkPointData* pointData = interactionPd->GetPointData();
   this->InsertPathData(particle, pointData);
-  this->IntegrationModel->InsertModelPathData(particle, pointData);
+  model->InsertModelPathData(particle, pointData);
   this->InsertInteractionData(particle, pointData);
   this->InsertParticleData(particle, pointData,
     vtkLagrangianBasicIntegrationModel::VARIABLE_STEP_NEXT);
 
   // Add Variables data
-  this->IntegrationModel->InsertVariablesParticleData(particle, pointData,
+  model->InsertVariablesParticleData(particle, pointData,
     vtkLagrangianBasicIntegrationModel::VARIABLE_STEP_NEXT);
 
   // Finally, Insert data from seed data only on not yet written arrays
@@ -1265,8 +1677,7 @@ void vtkLagrangianParticleTracker::InsertSeedData(vtkLagrangianParticle* particl
     vtkDataArray* arr = data->GetArray(name);
     if (arr->GetNumberOfTuples() < maxTuples)
     {
-      arr->InsertNextTuple(
-        seedData->GetArray(i)->GetTuple(particle->GetSeedArrayTupleIndex()));
+      arr->InsertNextTuple(particle->GetSeedArrayTupleIndex(), seedData->GetArray(i));
     }
   }
   // here all arrays from data should have the exact same size
@@ -1328,6 +1739,15 @@ void vtkLagrangianParticleTracker::InsertParticleData(vtkLagrangianParticle* par
 //---------------------------------------------------------------------------
 double vtkLagrangianParticleTracker::ComputeCellLength(
   vtkLagrangianParticle* particle)
+{
+  vtkNew<vtkGenericCell> genericCell;
+  return this->ComputeCellLength(this->IntegrationModel, genericCell, particle);
+}
+
+//---------------------------------------------------------------------------
+double vtkLagrangianParticleTracker::ComputeCellLength(
+  vtkLagrangianBasicIntegrationModel* model, vtkGenericCell* genericCell,
+  vtkLagrangianParticle* particle)
 {
   double cellLength = 1.0;
   vtkDataSet* dataset = nullptr;
@@ -1338,9 +1758,10 @@ double vtkLagrangianParticleTracker::ComputeCellLength(
     this->CellLengthComputationMode == STEP_CUR_CELL_DIV_THEO)
   {
     vtkIdType cellId;
-    if (this->IntegrationModel->FindInLocators(particle->GetPosition(), dataset, cellId))
+    if (model->FindInLocators(particle->GetPosition(), dataset, cellId))
     {
-      cell = dataset->GetCell(cellId);
+      dataset->GetCell(cellId, genericCell);
+      cell = genericCell->GetRepresentativeCell();
     }
     else
     {
@@ -1357,7 +1778,8 @@ double vtkLagrangianParticleTracker::ComputeCellLength(
     {
       return cellLength;
     }
-    cell = dataset->GetCell(particle->GetLastCellId());
+    dataset->GetCell(particle->GetLastCellId(), genericCell);
+    cell = genericCell->GetRepresentativeCell();
     if (!cell)
     {
       return cellLength;
@@ -1437,16 +1859,29 @@ bool vtkLagrangianParticleTracker::ComputeNextStep(
   double t, double& delT, double& delTActual,
   double minStep, double maxStep,
   int& integrationRes)
+{
+  return this->ComputeNextStep(this->IntegrationModel, this->Integrator,
+    xprev, xnext, t, delT, delTActual, minStep, maxStep, integrationRes);
+}
+
+//---------------------------------------------------------------------------
+bool vtkLagrangianParticleTracker::ComputeNextStep(
+  vtkLagrangianBasicIntegrationModel* model,
+  vtkInitialValueProblemSolver* integrator,
+  double* xprev, double* xnext,
+  double t, double& delT, double& delTActual,
+  double minStep, double maxStep,
+  int& integrationRes)
 {
   // Check for potential manual integration
   double error;
-  if (!this->IntegrationModel->ManualIntegration(xprev, xnext, t, delT, delTActual,
-    minStep, maxStep, this->IntegrationModel->GetTolerance(), error, integrationRes))
+  if (!model->ManualIntegration(xprev, xnext, t, delT, delTActual,
+    minStep, maxStep, model->GetTolerance(), error, integrationRes))
   {
     // integrate one step
     integrationRes =
-      this->Integrator->ComputeNextStep(xprev, xnext, t, delT, delTActual,
-        minStep, maxStep, this->IntegrationModel->GetTolerance(), error);
+      integrator->ComputeNextStep(xprev, xnext, t, delT, delTActual,
+        minStep, maxStep, model->GetTolerance(), error);
   }
 
   // Check failure cases
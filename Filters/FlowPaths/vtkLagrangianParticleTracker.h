@@ -97,14 +97,17 @@ class vtkBoundingBox;
 class vtkCellArray;
 class vtkDataSet;
 class vtkDoubleArray;
+class vtkGenericCell;
 class vtkIdList;
 class vtkInformation;
 class vtkInitialValueProblemSolver;
 class vtkLagrangianBasicIntegrationModel;
 class vtkLagrangianParticle;
+class vtkLagrangianParticleTrackerIntegrateFunctor;
 class vtkPointData;
 class vtkPoints;
 class vtkPolyData;
+class vtkSimpleMutexLock;
 
 class VTKFILTERSFLOWPATHS_EXPORT vtkLagrangianParticleTracker :
   public vtkDataObjectAlgorithm
@@ -258,6 +261,27 @@ public:
   vtkGetMacro(ParticlePathsRenderingPointsThreshold, int);
   //@}
 
+  //@{
+  /**
+   * Set/Get the threaded integration feature.
+   * When enabled, the particles are integrated concurrently using vtkSMPTools,
+   * each thread using its own copy of the integration model
+   * (see vtkLagrangianBasicIntegrationModel::NewThreadedCopy) and integrator
+   * and writing into its own outputs, which are merged at the end of the
+   * integration. Particles created by surface interactions are integrated
+   * in subsequent passes. Particles are not output in the same order than
+   * with the serial integration, and Integrate is not called, so inherited
+   * classes reimplementing it should not use this feature.
+   * Integration models creating particles should use NewChildParticle.
+   * The flow locator must support concurrent FindCell calls, as does the
+   * default vtkCellLocator.
+   * Default is false.
+   */
+  vtkSetMacro(ThreadedIntegration, bool);
+  vtkGetMacro(ThreadedIntegration, bool);
+  vtkBooleanMacro(ThreadedIntegration, bool);
+  //@}
+
   //@{
   /**
    * Specify the source object used to generate particle initial position (seeds).
@@ -325,6 +349,14 @@ public:
    */
   virtual vtkIdType GetNewParticleId();
 
+  /**
+   * Create a new particle from the provided parent particle, with an unique
+   * id and a copy of the parent seed data, as done when a particle breaks up.
+   * This can be called concurrently during threaded integration, the copies
+   * of the seed data being appended to the seed data after each pass.
+   */
+  virtual vtkLagrangianParticle* NewChildParticle(vtkLagrangianParticle* parent);
+
 protected:
   vtkLagrangianParticleTracker();
   ~vtkLagrangianParticleTracker() override;
@@ -367,12 +399,47 @@ protected:
     vtkPolyData* particlePathsOutput, vtkIdList* particlePathPointId,
     vtkDataObject* interactionOutput);
 
+  /**
+   * Integrate a particle using the provided model, integrator and cell,
+   * which allows concurrent integrations when each thread use its own.
+   * Progress is updated only if reportProgress is true.
+   */
+  int IntegrateParticle(vtkLagrangianBasicIntegrationModel* model,
+    vtkInitialValueProblemSolver* integrator, vtkGenericCell* cell,
+    vtkLagrangianParticle* particle, std::queue<vtkLagrangianParticle*>& particlesQueue,
+    vtkPolyData* particlePathsOutput, vtkIdList* particlePathPointId,
+    vtkDataObject* interactionOutput, bool reportProgress);
+
+  /**
+   * Integrate all the particles of the queue, and the particles they create,
+   * with vtkSMPTools, see ThreadedIntegration.
+   */
+  virtual void IntegrateParticlesThreaded(
+    std::queue<vtkLagrangianParticle*>& particlesQueue, vtkPointData* seedData,
+    vtkPolyData* particlePathsOutput, vtkDataObject* interactionOutput);
+
+  /**
+   * Return true if the particles should be integrated with
+   * IntegrateParticlesThreaded.
+   */
+  virtual bool CanUseThreadedIntegration();
+
+  void InsertParticlePath(vtkLagrangianBasicIntegrationModel* model,
+    vtkLagrangianParticle* particle, vtkPolyData* particlePathsOutput,
+    vtkIdList* particlePathPointId);
+
   void InsertPathOutputPoint(vtkLagrangianParticle* particle,
     vtkPolyData* particlePathsOutput, vtkIdList* particlePathPointId,
     bool prev = false);
+  void InsertPathOutputPoint(vtkLagrangianBasicIntegrationModel* model,
+    vtkLagrangianParticle* particle, vtkPolyData* particlePathsOutput,
+    vtkIdList* particlePathPointId, bool prev = false);
 
   void InsertInteractionOutputPoint(vtkLagrangianParticle* particle,
     unsigned int interactedSurfaceFlatIndex, vtkDataObject* interactionOutput);
+  void InsertInteractionOutputPoint(vtkLagrangianBasicIntegrationModel* model,
+    vtkLagrangianParticle* particle, unsigned int interactedSurfaceFlatIndex,
+    vtkDataObject* interactionOutput);
 
   void InsertSeedData(vtkLagrangianParticle* particle, vtkFieldData* data);
   void InsertPathData(vtkLagrangianParticle* particle, vtkFieldData* data);
@@ -380,12 +447,20 @@ protected:
   void InsertParticleData(vtkLagrangianParticle* particle, vtkFieldData* data, int stepEnum);
 
   double ComputeCellLength(vtkLagrangianParticle* particle);
+  double ComputeCellLength(vtkLagrangianBasicIntegrationModel* model,
+    vtkGenericCell* genericCell, vtkLagrangianParticle* particle);
 
   bool ComputeNextStep(
     double* xprev, double* xnext,
     double t, double& delT, double& delTActual,
     double minStep, double maxStep,
     int& integrationRes);
+  bool ComputeNextStep(vtkLagrangianBasicIntegrationModel* model,
+    vtkInitialValueProblemSolver* integrator,
+    double* xprev, double* xnext,
+    double t, double& delT, double& delTActual,
+    double minStep, double maxStep,
+    int& integrationRes);
 
   virtual bool CheckParticlePathsRenderingThreshold(vtkPolyData* particlePathsOutput);
 
@@ -402,7 +477,10 @@ protected:
   bool UseParticlePathsRenderingThreshold;
   bool GeneratePolyVertexInteractionOutput;
   int ParticlePathsRenderingPointsThreshold;
+  bool ThreadedIntegration;
   vtkIdType ParticleCounter;
+  vtkSimpleMutexLock* ParticleCounterLock;
+  vtkLagrangianParticleTrackerIntegrateFunctor* IntegrateFunctor;
 
   // internal parameters use for step computation
   double MinimumVelocityMagnitude;
@@ -416,6 +494,8 @@ protected:
   vtkMTimeType SurfacesTime;
 
 private:
+  friend class vtkLagrangianParticleTrackerIntegrateFunctor;
+
   vtkLagrangianParticleTracker(const vtkLagrangianParticleTracker&) = delete;
   void operator=(const vtkLagrangianParticleTracker&) = delete;
 };
@@ -14,24 +14,341 @@
 =========================================================================*/
 #include "vtkDataSetTriangleFilter.h"
 
+#include "vtkArrayListTemplate.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellType.h"
 #include "vtkGenericCell.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkOrderedTriangulator.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkStructuredGrid.h"
 #include "vtkStructuredPoints.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkUnsignedCharArray.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkDataSetTriangleFilter);
 
+namespace
+{
+// The input cells are triangulated in blocks of consecutive cells. Each
+// block keeps its simplices (in the vtkCellArray layout), and the input
+// cell of each simplex, until the output offsets of all blocks are known.
+struct vtkDataSetTriangleFilterBlock
+{
+  std::vector<unsigned char> Types;
+  std::vector<vtkIdType> Cells;
+  std::vector<vtkIdType> Sources;
+
+  // Appends the simplices of dim points listed in ptIds.
+  void AddSimplices(int type, int dim, vtkIdList *ptIds, vtkIdType source)
+  {
+    vtkIdType numSimplices = ptIds->GetNumberOfIds() / dim;
+    const vtkIdType *ids = ptIds->GetPointer(0);
+    for (vtkIdType i = 0; i < numSimplices; i++, ids += dim)
+    {
+      this->Types.push_back(static_cast<unsigned char>(type));
+      this->Cells.push_back(dim);
+      this->Cells.insert(this->Cells.end(), ids, ids + dim);
+      this->Sources.push_back(source);
+    }
+  }
+};
+
+int vtkDataSetTriangleFilterSimplexType(int dim)
+{
+  switch (dim)
+  {
+    case 1:
+      return VTK_VERTEX;
+    case 2:
+      return VTK_LINE;
+    case 3:
+      return VTK_TRIANGLE;
+    case 4:
+      return VTK_TETRA;
+  }
+  return 0;
+}
+
+// Number of blocks (and their size) used to process numCells cells.
+vtkIdType vtkDataSetTriangleFilterBlocks(vtkIdType numCells,
+                                         vtkIdType &blockSize)
+{
+  vtkIdType numBlocks = 4 * vtkSMPTools::GetEstimatedNumberOfThreads();
+  numBlocks = std::max<vtkIdType>(1, std::min(numBlocks, numCells / 1024));
+  blockSize = (numCells + numBlocks - 1) / numBlocks;
+  return numBlocks;
+}
+
+// State shared by the triangulation functors.
+struct vtkDataSetTriangleFilterTriangulate
+{
+  vtkDataSet *Input;
+  vtkIdType NumberOfCells;
+  vtkIdType BlockSize;
+  bool TetrahedraOnly;
+  vtkDataSetTriangleFilterBlock *Blocks;
+
+  vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+  vtkSMPThreadLocalObject<vtkIdList> CellPtIds;
+  vtkSMPThreadLocalObject<vtkPoints> CellPts;
+};
+
+// Structured data: every cell is split by vtkCell::Triangulate(), with
+// alternating indices so that neighbor cells are compatible.
+struct vtkDataSetTriangleFilterStructured
+  : public vtkDataSetTriangleFilterTriangulate
+{
+  vtkIdType Dimensions[2];
+
+  void Initialize()
+  {
+  }
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    vtkGenericCell *cell = this->Cell.Local();
+    vtkIdList *cellPtIds = this->CellPtIds.Local();
+    vtkPoints *cellPts = this->CellPts.Local();
+    vtkIdType d01 = this->Dimensions[0] * this->Dimensions[1];
+    for (vtkIdType blockId = beginBlock; blockId < endBlock; ++blockId)
+    {
+      vtkDataSetTriangleFilterBlock &block = this->Blocks[blockId];
+      vtkIdType begin = blockId * this->BlockSize;
+      vtkIdType end = std::min(begin + this->BlockSize, this->NumberOfCells);
+      for (vtkIdType inId = begin; inId < end; ++inId)
+      {
+        vtkIdType i = inId % this->Dimensions[0];
+        vtkIdType j = (inId / this->Dimensions[0]) % this->Dimensions[1];
+        vtkIdType k = inId / d01;
+        this->Input->GetCell(inId, cell);
+        cell->Triangulate(static_cast<int>((i + j + k) % 2), cellPtIds,
+                          cellPts);
+        int dim = cell->GetCellDimension() + 1;
+        int type = vtkDataSetTriangleFilterSimplexType(dim);
+        if (!this->TetrahedraOnly || type == VTK_TETRA)
+        {
+          block.AddSimplices(type, dim, cellPtIds, inId);
+        }
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+// Unstructured data: 3D cells use an ordered triangulator per thread,
+// configured like the filter's one; other cells use vtkCell::Triangulate().
+struct vtkDataSetTriangleFilterUnstructured
+  : public vtkDataSetTriangleFilterTriangulate
+{
+  vtkOrderedTriangulator *Prototype;
+
+  vtkSMPThreadLocalObject<vtkOrderedTriangulator> Triangulator;
+  vtkSMPThreadLocalObject<vtkCellArray> Tetras;
+
+  void Initialize()
+  {
+    vtkOrderedTriangulator *triangulator = this->Triangulator.Local();
+    triangulator->SetPreSorted(this->Prototype->GetPreSorted());
+    triangulator->SetUseTemplates(this->Prototype->GetUseTemplates());
+    triangulator->SetUseTwoSortIds(this->Prototype->GetUseTwoSortIds());
+  }
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    vtkGenericCell *cell = this->Cell.Local();
+    vtkIdList *cellPtIds = this->CellPtIds.Local();
+    vtkPoints *cellPts = this->CellPts.Local();
+    vtkOrderedTriangulator *triangulator = this->Triangulator.Local();
+    vtkCellArray *tetras = this->Tetras.Local();
+    double x[3];
+    for (vtkIdType blockId = beginBlock; blockId < endBlock; ++blockId)
+    {
+      vtkDataSetTriangleFilterBlock &block = this->Blocks[blockId];
+      vtkIdType begin = blockId * this->BlockSize;
+      vtkIdType end = std::min(begin + this->BlockSize, this->NumberOfCells);
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        this->Input->GetCell(cellId, cell);
+        int dim = cell->GetCellDimension();
+
+        if (cell->GetCellType() == VTK_POLYHEDRON) //polyhedron
+        {
+          cell->Triangulate(0, cellPtIds, cellPts);
+          block.AddSimplices(VTK_TETRA, 4, cellPtIds, cellId);
+        }
+
+        else if ( dim == 3 ) //use ordered triangulation
+        {
+          int numPts = cell->GetNumberOfPoints();
+          int type = cell->GetCellType();
+          double *p = cell->GetParametricCoords();
+          triangulator->InitTriangulation(0.0,1.0, 0.0,1.0, 0.0,1.0, numPts);
+          for (int j = 0; j < numPts; j++, p += 3)
+          {
+            // the wedge is "flipped" compared to other cells in that
+            // the normal of the first face points out instead of in
+            // so we flip the way we pass the points to the triangulator
+            const vtkIdType wedgemap[18] = {3, 4, 5, 0, 1, 2, 9, 10, 11, 6, 7, 8, 12, 13, 14, 15, 16, 17};
+            vtkIdType ptId;
+            if (type == VTK_WEDGE || type == VTK_QUADRATIC_WEDGE || type == VTK_QUADRATIC_LINEAR_WEDGE ||
+                type == VTK_BIQUADRATIC_QUADRATIC_WEDGE)
+            {
+              ptId = cell->PointIds->GetId(wedgemap[j]);
+              cell->Points->GetPoint(wedgemap[j], x);
+            }
+            else
+            {
+              ptId = cell->PointIds->GetId(j);
+              cell->Points->GetPoint(j, x);
+            }
+            triangulator->InsertPoint(ptId, x, p, 0);
+          }//for all cell points
+          if ( cell->IsPrimaryCell() ) //use templates if topology is fixed
+          {
+            int numEdges=cell->GetNumberOfEdges();
+            triangulator->TemplateTriangulate(type, numPts, numEdges);
+          }
+          else //use ordered triangulator
+          {
+            triangulator->Triangulate();
+          }
+
+          tetras->Reset();
+          vtkIdType numTets = triangulator->AddTetras(0, tetras);
+          const vtkIdType *tets = tetras->GetPointer();
+          block.Types.insert(block.Types.end(), numTets,
+                             static_cast<unsigned char>(VTK_TETRA));
+          block.Cells.insert(block.Cells.end(), tets, tets + 5 * numTets);
+          block.Sources.insert(block.Sources.end(), numTets, cellId);
+        }
+
+        else if (!this->TetrahedraOnly) //2D or lower dimension
+        {
+          dim++;
+          cell->Triangulate(0, cellPtIds, cellPts);
+          block.AddSimplices(vtkDataSetTriangleFilterSimplexType(dim), dim,
+                             cellPtIds, cellId);
+        }
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+// Writes the simplices of the blocks into the output cell arrays.
+struct vtkDataSetTriangleFilterFill
+{
+  const std::vector<vtkDataSetTriangleFilterBlock> *Blocks;
+  const vtkIdType *CellOffsets;
+  const vtkIdType *ConnectivityOffsets;
+  unsigned char *Types;
+  vtkIdType *Locations;
+  vtkIdType *Cells;
+  vtkIdType *Sources;
+
+  void operator()(vtkIdType beginBlock, vtkIdType endBlock)
+  {
+    for (vtkIdType blockId = beginBlock; blockId < endBlock; ++blockId)
+    {
+      const vtkDataSetTriangleFilterBlock &block = (*this->Blocks)[blockId];
+      vtkIdType cellId = this->CellOffsets[blockId];
+      vtkIdType loc = this->ConnectivityOffsets[blockId];
+      std::copy(block.Types.begin(), block.Types.end(), this->Types + cellId);
+      std::copy(block.Sources.begin(), block.Sources.end(),
+                this->Sources + cellId);
+      std::copy(block.Cells.begin(), block.Cells.end(), this->Cells + loc);
+      for (size_t i = 0; i < block.Cells.size(); i += block.Cells[i] + 1)
+      {
+        this->Locations[cellId++] = loc + static_cast<vtkIdType>(i);
+      }
+    }
+  }
+};
+
+// Makes the simplices of the blocks the output cells, and copies their cell
+// data.
+void vtkDataSetTriangleFilterOutput(
+  const std::vector<vtkDataSetTriangleFilterBlock> &blocks,
+  vtkCellData *inCD, vtkUnstructuredGrid *output)
+{
+  size_t numBlocks = blocks.size();
+  std::vector<vtkIdType> cellOffsets(numBlocks + 1, 0);
+  std::vector<vtkIdType> connectivityOffsets(numBlocks + 1, 0);
+  for (size_t blockId = 0; blockId < numBlocks; ++blockId)
+  {
+    cellOffsets[blockId + 1] = cellOffsets[blockId] +
+      static_cast<vtkIdType>(blocks[blockId].Types.size());
+    connectivityOffsets[blockId + 1] = connectivityOffsets[blockId] +
+      static_cast<vtkIdType>(blocks[blockId].Cells.size());
+  }
+  vtkIdType numCells = cellOffsets[numBlocks];
+
+  vtkNew<vtkUnsignedCharArray> types;
+  types->SetNumberOfValues(numCells);
+  vtkNew<vtkIdTypeArray> locations;
+  locations->SetNumberOfValues(numCells);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(connectivityOffsets[numBlocks]);
+  vtkNew<vtkIdList> sources;
+  sources->SetNumberOfIds(numCells);
+
+  vtkDataSetTriangleFilterFill fill;
+  fill.Blocks = &blocks;
+  fill.CellOffsets = &cellOffsets[0];
+  fill.ConnectivityOffsets = &connectivityOffsets[0];
+  fill.Types = types->GetPointer(0);
+  fill.Locations = locations->GetPointer(0);
+  fill.Cells = connectivity->GetPointer(0);
+  fill.Sources = sources->GetPointer(0);
+  vtkSMPTools::For(0, static_cast<vtkIdType>(numBlocks), 1, fill);
+
+  vtkNew<vtkCellArray> cells;
+  cells->SetCells(numCells, connectivity);
+  output->SetCells(types, locations, cells);
+
+  vtkCellData *outCD = output->GetCellData();
+  outCD->CopyAllocate(inCD, numCells);
+  ArrayList::GatherTuples(inCD, outCD, sources->GetPointer(0), numCells);
+}
+
+// Explicit copy of the points of structured data.
+struct vtkDataSetTriangleFilterCopyPoints
+{
+  vtkDataSet *Input;
+  vtkPoints *Points;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    double x[3];
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      this->Input->GetPoint(i, x);
+      this->Points->SetPoint(i, x);
+    }
+  }
+};
+}
+
 vtkDataSetTriangleFilter::vtkDataSetTriangleFilter()
 {
   this->Triangulator = vtkOrderedTriangulator::New();
@@ -81,27 +398,16 @@ int vtkDataSetTriangleFilter::RequestData(
 void vtkDataSetTriangleFilter::StructuredExecute(vtkDataSet *input,
                                                  vtkUnstructuredGrid *output)
 {
-  int dimensions[3], i, j, k, l, m;
-  vtkIdType newCellId, inId;
-  vtkCellData *inCD = input->GetCellData();
-  vtkCellData *outCD = output->GetCellData();
-  vtkPoints *cellPts = vtkPoints::New();
+  int dimensions[3];
+  vtkIdType num;
   vtkPoints *newPoints = vtkPoints::New();
-  vtkIdList *cellPtIds = vtkIdList::New();
-  int numSimplices, numPts, dim, type;
-  vtkIdType pts[4], num;
 
   // Create an array of points. This does an explicit creation
   // of each point.
   num = input->GetNumberOfPoints();
   newPoints->SetNumberOfPoints(num);
-  for (i = 0; i < num; ++i)
-  {
-    newPoints->SetPoint(i,input->GetPoint(i));
-  }
-
-  outCD->CopyAllocate(inCD,input->GetNumberOfCells()*5);
-  output->Allocate(input->GetNumberOfCells()*5);
+  vtkDataSetTriangleFilterCopyPoints copyPoints = { input, newPoints };
+  vtkSMPTools::For(0, num, copyPoints);
 
   if (input->IsA("vtkStructuredPoints"))
   {
@@ -135,59 +441,33 @@ void vtkDataSetTriangleFilter::StructuredExecute(vtkDataSet *input,
   dimensions[2] = dimensions[2] - 1;
 
   vtkIdType numSlices = ( dimensions[2] > 0 ? dimensions[2] : 1 );
-  int abort=0;
-  for (k = 0; k < numSlices && !abort; k++)
-  {
-    this->UpdateProgress(static_cast<double>(k) / numSlices);
-    abort = this->GetAbortExecute();
-
-    for (j = 0; j < dimensions[1]; j++)
-    {
-      for (i = 0; i < dimensions[0]; i++)
-      {
-        inId = i+(j+(k*dimensions[1]))*dimensions[0];
-        vtkCell *cell = input->GetCell(i, j, k);
-        if ((i+j+k)%2 == 0)
-        {
-          cell->Triangulate(0, cellPtIds, cellPts);
-        }
-        else
-        {
-          cell->Triangulate(1, cellPtIds, cellPts);
-        }
+  vtkIdType numCells = std::max(dimensions[0], 0) *
+    static_cast<vtkIdType>(std::max(dimensions[1], 0)) * numSlices;
+  this->UpdateProgress(0.1);
 
-        dim = cell->GetCellDimension() + 1;
+  // Triangulate the cells in parallel
+  std::vector<vtkDataSetTriangleFilterBlock> blocks;
+  if (numCells > 0 && !this->GetAbortExecute())
+  {
+    // Build any lazily created structure before the threads query cells.
+    vtkNew<vtkGenericCell> cell;
+    input->GetCell(0, cell);
+
+    vtkDataSetTriangleFilterStructured triangulate;
+    vtkIdType numBlocks =
+      vtkDataSetTriangleFilterBlocks(numCells, triangulate.BlockSize);
+    blocks.resize(numBlocks);
+    triangulate.Input = input;
+    triangulate.NumberOfCells = numCells;
+    triangulate.TetrahedraOnly = (this->TetrahedraOnly != 0);
+    triangulate.Blocks = &blocks[0];
+    triangulate.Dimensions[0] = dimensions[0];
+    triangulate.Dimensions[1] = dimensions[1];
+    vtkSMPTools::For(0, numBlocks, 1, triangulate);
+  }
+  this->UpdateProgress(0.8);
 
-        numPts = cellPtIds->GetNumberOfIds();
-        numSimplices = numPts / dim;
-        type = 0;
-        switch (dim)
-        {
-          case 1:
-            type = VTK_VERTEX;    break;
-          case 2:
-            type = VTK_LINE;      break;
-          case 3:
-            type = VTK_TRIANGLE;  break;
-          case 4:
-            type = VTK_TETRA;     break;
-        }
-        if (!this->TetrahedraOnly || type == VTK_TETRA)
-        {
-          for (l = 0; l < numSimplices; l++ )
-          {
-            for (m = 0; m < dim; m++)
-            {
-              pts[m] = cellPtIds->GetId(dim*l+m);
-            }
-            // copy cell data
-            newCellId = output->InsertNextCell(type, dim, pts);
-            outCD->CopyData(inCD, inId, newCellId);
-          }//for all simplices
-        }
-      }//i dimension
-    }//j dimension
-  }//k dimension
+  vtkDataSetTriangleFilterOutput(blocks, input->GetCellData(), output);
 
   // Update output
   output->SetPoints(newPoints);
@@ -195,31 +475,19 @@ void vtkDataSetTriangleFilter::StructuredExecute(vtkDataSet *input,
   output->Squeeze();
 
   newPoints->Delete();
-  cellPts->Delete();
-  cellPtIds->Delete();
 }
 
 // 3D cells use the ordered triangulator. The ordered triangulator is used
 // to create templates on the fly. Once the templates are created then they
-// are used to produce the final triangulation.
+// are used to produce the final triangulation. Blocks of cells are
+// triangulated in parallel, each thread with its own ordered triangulator.
 //
 void vtkDataSetTriangleFilter::UnstructuredExecute(vtkDataSet *dataSetInput,
                                                    vtkUnstructuredGrid *output)
 {
   vtkPointSet *input = static_cast<vtkPointSet*>(dataSetInput); //has to be
   vtkIdType numCells = input->GetNumberOfCells();
-  vtkGenericCell *cell;
-  vtkIdType newCellId, j;
-  int k;
   vtkCellData *inCD=input->GetCellData();
-  vtkCellData *outCD=output->GetCellData();
-  vtkPoints *cellPts;
-  vtkIdList *cellPtIds;
-  vtkIdType ptId, numTets, ncells;
-  int numPts, type;
-  int numSimplices, dim;
-  vtkIdType pts[4];
-  double x[3];
 
   if (numCells == 0)
   {
@@ -262,140 +530,38 @@ void vtkDataSetTriangleFilter::UnstructuredExecute(vtkDataSet *dataSetInput,
     }
   }
 
-  cell = vtkGenericCell::New();
-  cellPts = vtkPoints::New();
-  cellPtIds = vtkIdList::New();
-
   // Create an array of points
   vtkCellData *tempCD = vtkCellData::New();
   tempCD->ShallowCopy(inCD);
   tempCD->SetActiveGlobalIds(nullptr);
 
-  outCD->CopyAllocate(tempCD, input->GetNumberOfCells()*5);
-  output->Allocate(input->GetNumberOfCells()*5);
-
   // Points are passed through
   output->SetPoints(input->GetPoints());
   output->GetPointData()->PassData(input->GetPointData());
 
-  int abort=0;
-  vtkIdType updateTime = numCells/20 + 1;  // update roughly every 5%
-  for (vtkIdType cellId=0; cellId < numCells && !abort; cellId++)
-  {
-    if ( !(cellId % updateTime) )
-    {
-      this->UpdateProgress(static_cast<double>(cellId) / numCells);
-      abort = this->GetAbortExecute();
-    }
-
-    input->GetCell(cellId, cell);
-    dim = cell->GetCellDimension();
-
-    if (cell->GetCellType() == VTK_POLYHEDRON) //polyhedron
-    {
-      dim = 4;
-      cell->Triangulate(0, cellPtIds, cellPts);
-      numPts = cellPtIds->GetNumberOfIds();
-
-      numSimplices = numPts / dim;
-      type = VTK_TETRA;
-
-      for ( j=0; j < numSimplices; j++ )
-      {
-        for (k=0; k<dim; k++)
-        {
-          pts[k] = cellPtIds->GetId(dim*j+k);
-        }
-        // copy cell data
-        newCellId = output->InsertNextCell(type, dim, pts);
-        outCD->CopyData(tempCD, cellId, newCellId);
-      }
-    }
-
-    else if ( dim == 3 ) //use ordered triangulation
-    {
-      numPts = cell->GetNumberOfPoints();
-      double *p, *pPtr=cell->GetParametricCoords();
-      this->Triangulator->InitTriangulation(0.0,1.0, 0.0,1.0, 0.0,1.0, numPts);
-      for (p=pPtr, j=0; j<numPts; j++, p+=3)
-      {
-        // the wedge is "flipped" compared to other cells in that
-        // the normal of the first face points out instead of in
-        // so we flip the way we pass the points to the triangulator
-        const vtkIdType wedgemap[18] = {3, 4, 5, 0, 1, 2, 9, 10, 11, 6, 7, 8, 12, 13, 14, 15, 16, 17};
-        type = cell->GetCellType();
-        if (type == VTK_WEDGE || type == VTK_QUADRATIC_WEDGE || type == VTK_QUADRATIC_LINEAR_WEDGE ||
-            type == VTK_BIQUADRATIC_QUADRATIC_WEDGE)
-        {
-          ptId = cell->PointIds->GetId(wedgemap[j]);
-          cell->Points->GetPoint(wedgemap[j], x);
-        }
-        else
-        {
-          ptId = cell->PointIds->GetId(j);
-          cell->Points->GetPoint(j, x);
-        }
-        this->Triangulator->InsertPoint(ptId, x, p, 0);
-      }//for all cell points
-      if ( cell->IsPrimaryCell() ) //use templates if topology is fixed
-      {
-        int numEdges=cell->GetNumberOfEdges();
-        this->Triangulator->TemplateTriangulate(cell->GetCellType(),
-                                                numPts,numEdges);
-      }
-      else //use ordered triangulator
-      {
-        this->Triangulator->Triangulate();
-      }
-
-      ncells = output->GetNumberOfCells();
-      numTets = this->Triangulator->AddTetras(0,output);
-
-      for (j=0; j < numTets; j++)
-      {
-        outCD->CopyData(tempCD, cellId, ncells+j);
-      }
-    }
-
-    else if (!this->TetrahedraOnly) //2D or lower dimension
-    {
-      dim++;
-      cell->Triangulate(0, cellPtIds, cellPts);
-      numPts = cellPtIds->GetNumberOfIds();
-
-      numSimplices = numPts / dim;
-      type = 0;
-      switch (dim)
-      {
-        case 1:
-          type = VTK_VERTEX;    break;
-        case 2:
-          type = VTK_LINE;      break;
-        case 3:
-          type = VTK_TRIANGLE;  break;
-      }
-
-      for ( j=0; j < numSimplices; j++ )
-      {
-        for (k=0; k<dim; k++)
-        {
-          pts[k] = cellPtIds->GetId(dim*j+k);
-        }
-        // copy cell data
-        newCellId = output->InsertNextCell(type, dim, pts);
-        outCD->CopyData(tempCD, cellId, newCellId);
-      }
-    } //if 2D or less cell
-  } //for all cells
+  // Build any lazily created structure (e.g. the cells of polydata) before
+  // the threads query cells.
+  vtkNew<vtkGenericCell> cell;
+  input->GetCell(0, cell);
+
+  vtkDataSetTriangleFilterUnstructured triangulate;
+  vtkIdType numBlocks =
+    vtkDataSetTriangleFilterBlocks(numCells, triangulate.BlockSize);
+  std::vector<vtkDataSetTriangleFilterBlock> blocks(numBlocks);
+  triangulate.Input = input;
+  triangulate.NumberOfCells = numCells;
+  triangulate.TetrahedraOnly = (this->TetrahedraOnly != 0);
+  triangulate.Blocks = &blocks[0];
+  triangulate.Prototype = this->Triangulator;
+  vtkSMPTools::For(0, numBlocks, 1, triangulate);
+  this->UpdateProgress(0.8);
+
+  vtkDataSetTriangleFilterOutput(blocks, tempCD, output);
 
   // Update output
   output->Squeeze();
 
   tempCD->Delete();
-
-  cellPts->Delete();
-  cellPtIds->Delete();
-  cell->Delete();
 }
 
 int vtkDataSetTriangleFilter::FillInputPortInformation(int, vtkInformation *info)
@@ -409,4 +575,3 @@ void vtkDataSetTriangleFilter::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
   os << indent << "TetrahedraOnly: " << (this->TetrahedraOnly ? "On":"Off") << "\n";
 }
-
@@ -27,6 +27,11 @@
  * This approach produces templates on the fly for triangulating the
  * cells. The templates are then used to do the actual triangulation.
  *
+ * The cells are triangulated in parallel (using vtkSMPTools), in blocks of
+ * consecutive cells; the output cells keep the order of the input cells.
+ * Each thread uses its own ordered triangulator, configured like
+ * Triangulator.
+ *
  * @sa
  * vtkOrderedTriangulator vtkTriangleFilter
 */
@@ -65,7 +70,7 @@ protected:
 
   int FillInputPortInformation(int port, vtkInformation *info) override;
 
-  // Used to triangulate 3D cells
+  // Used to configure the ordered triangulators of 3D cells
   vtkOrderedTriangulator *Triangulator;
 
   // Different execute methods depending on whether input is structured or not
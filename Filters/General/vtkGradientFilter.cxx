@@ -20,11 +20,15 @@
 
 #include "vtkGradientFilter.h"
 
+#include "vtkArrayDispatch.h"
 #include "vtkCell.h"
 #include "vtkCellData.h"
 #include "vtkCellDataToPointData.h"
+#include "vtkCellType.h"
 #include "vtkDataArray.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkDataSet.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
@@ -35,11 +39,16 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticCellLinksTemplate.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
 #include <limits>
 #include <vector>
 
@@ -87,11 +96,11 @@ namespace
   void ComputePointGradientsUG(
     vtkDataSet *structure, vtkDataArray *array, data_type *gradients,
     int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
-    data_type* divergence, int highestCellDimension, int contributingCellOption);
+    data_type* divergence, int contributingCellOption);
 
   int GetCellParametricData(
     vtkIdType pointId, double pointCoord[3], vtkCell *cell, int & subId,
-    double parametricCoord[3]);
+    double parametricCoord[3], std::vector<double>& weights);
 
   template<class data_type>
   void ComputeCellGradientsUG(
@@ -120,25 +129,6 @@ namespace
     return false;
   }
 
-  // generic way to get the coordinate for either a cell (using
-  // the parametric center) or a point
-  void GetGridEntityCoordinate(vtkDataSet* grid, int fieldAssociation,
-                               vtkIdType index, double coords[3])
-  {
-    if(fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS)
-    {
-      grid->GetPoint(index, coords);
-    }
-    else
-    {
-      vtkCell* cell = grid->GetCell(index);
-      double pcoords[3];
-      int subId = cell->GetParametricCenter(pcoords);
-      std::vector<double> weights(cell->GetNumberOfPoints()+1);
-      cell->EvaluateLocation(subId, pcoords, coords, &weights[0]);
-    }
-  }
-
   template<class data_type>
   void Fill(vtkDataArray* array, data_type vtkNotUsed(data), int replacementValueOption)
   {
@@ -448,24 +438,6 @@ int vtkGradientFilter::ComputeUnstructuredGridGradient(
     }
   }
 
-  int highestCellDimension = 0;
-  if (this->ContributingCellOption == vtkGradientFilter::DataSetMax)
-  {
-    int maxDimension = input->IsA("vtkPolyData") == 1 ? 2 : 3;
-    for (vtkIdType i=0;i<input->GetNumberOfCells();i++)
-    {
-      int dim = input->GetCell(i)->GetCellDimension();
-      if (dim > highestCellDimension)
-      {
-        highestCellDimension = dim;
-        if (highestCellDimension == maxDimension)
-        {
-          break;
-        }
-      }
-    }
-  }
-
   if (fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS)
   {
     if (!this->FasterApproximation)
@@ -483,7 +455,7 @@ int vtkGradientFilter::ComputeUnstructuredGridGradient(
                             static_cast<VTK_TT *>(qCriterion->GetVoidPointer(0))),
                            (divergence == nullptr ? nullptr :
                             static_cast<VTK_TT *>(divergence->GetVoidPointer(0))),
-                           highestCellDimension, this->ContributingCellOption));
+                           this->ContributingCellOption));
       }
       if(gradients)
       {
@@ -836,125 +808,261 @@ int vtkGradientFilter::GetOutputArrayType(vtkDataArray* array)
 
 namespace {
 //-----------------------------------------------------------------------------
+// Everything the gradient kernels need to know about the data set and the
+// requested outputs. The gradient and the derived quantities (vorticity,
+// Q-criterion, divergence) are all filled from a single gradient evaluation.
   template<class data_type>
-  void ComputePointGradientsUG(
-    vtkDataSet *structure, vtkDataArray *array, data_type *gradients,
-    int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
-    data_type* divergence, int highestCellDimension, int contributingCellOption)
+  struct GradientParameters
   {
-    vtkNew<vtkIdList> currentPoint;
-    currentPoint->SetNumberOfIds(1);
-    vtkNew<vtkIdList> cellsOnPoint;
+    vtkDataSet* Structure;
+    int NumberOfInputComponents;
+    data_type* Gradients;
+    data_type* Vorticity;
+    data_type* QCriterion;
+    data_type* Divergence;
+
+    // point gradients of unstructured data
+    vtkStaticCellLinksTemplate<vtkIdType>* Links;
+    const unsigned char* CellDimensions;
+    int HighestCellDimension;
+    bool Patch;
+
+    // structured data
+    int FieldAssociation;
+    int Dims[3];
+    const std::vector<double>* AxisCoordinates;
+  };
 
-    vtkIdType numpts = structure->GetNumberOfPoints();
+  template<class data_type>
+  void StoreGradient(const GradientParameters<data_type>& params,
+                     vtkIdType index, data_type* g)
+  {
+    if(params.Gradients)
+    {
+      const int numberOfOutputComponents = 3*params.NumberOfInputComponents;
+      std::copy(g, g+numberOfOutputComponents,
+                params.Gradients+index*numberOfOutputComponents);
+    }
+    if(params.Vorticity)
+    {
+      ComputeVorticityFromGradient(g, params.Vorticity+3*index);
+    }
+    if(params.QCriterion)
+    {
+      ComputeQCriterionFromGradient(g, params.QCriterion+index);
+    }
+    if(params.Divergence)
+    {
+      ComputeDivergenceFromGradient(g, params.Divergence+index);
+    }
+  }
 
-    int numberOfOutputComponents = 3*numberOfInputComponents;
-    std::vector<data_type> g(numberOfOutputComponents);
+//-----------------------------------------------------------------------------
+// Dispatches the input array to the typed kernel and runs it over [0,n) in
+// parallel. Only floating point arrays get a typed kernel, others go through
+// the vtkDataArray API.
+  template<template<class, class> class Functor, class data_type>
+  struct GradientWorker
+  {
+    const GradientParameters<data_type>* Parameters;
+    vtkIdType NumberOfTasks;
 
-    // if we are doing patches for contributing cell dimensions we want to keep track of
-    // the maximum expected dimension so we can exit out of the check loop quicker
-    const int maxCellDimension = structure->IsA("vtkPolyData") ? 2 : 3;
+    template<class ArrayT>
+    void operator()(ArrayT* array)
+    {
+      Functor<ArrayT, data_type> functor(array, *this->Parameters);
+      vtkSMPTools::For(0, this->NumberOfTasks, functor);
+    }
+  };
 
-    for (vtkIdType point = 0; point < numpts; point++)
+  template<template<class, class> class Functor, class data_type>
+  void ExecuteGradient(vtkDataArray* array,
+                       const GradientParameters<data_type>& params,
+                       vtkIdType numberOfTasks)
+  {
+    GradientWorker<Functor, data_type> worker;
+    worker.Parameters = &params;
+    worker.NumberOfTasks = numberOfTasks;
+    if(!vtkArrayDispatch::DispatchByValueType<vtkArrayDispatch::Reals>::Execute(
+         array, worker))
     {
-      currentPoint->SetId(0, point);
-      double pointcoords[3];
-      structure->GetPoint(point, pointcoords);
-      // Get all cells touching this point.
-      structure->GetCellNeighbors(-1, currentPoint, cellsOnPoint);
-      vtkIdType numCellNeighbors = cellsOnPoint->GetNumberOfIds();
+      worker(array);
+    }
+  }
 
-      for(int i=0;i<numberOfOutputComponents;i++)
-      {
-        g[i] = 0;
-      }
+//-----------------------------------------------------------------------------
+  template<class ArrayT, class data_type>
+  class PointGradientsUG
+  {
+  public:
+    PointGradientsUG(ArrayT* array, const GradientParameters<data_type>& params)
+      : Array(array), Parameters(params)
+    {
+    }
 
-      if (contributingCellOption == vtkGradientFilter::Patch)
+    void Initialize()
+    {
+      this->G.Local().resize(3*this->Parameters.NumberOfInputComponents);
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      const GradientParameters<data_type>& p = this->Parameters;
+      vtkDataArrayAccessor<ArrayT> values(this->Array);
+      vtkGenericCell* cell = this->Cell.Local();
+      std::vector<double>& cellValues = this->Values.Local();
+      std::vector<data_type>& g = this->G.Local();
+      const int numberOfInputComponents = p.NumberOfInputComponents;
+
+      for (vtkIdType point = begin; point < end; point++)
       {
-        highestCellDimension = 0;
-        for (vtkIdType neighbor = 0; neighbor < numCellNeighbors; neighbor++)
+        double pointcoords[3];
+        p.Structure->GetPoint(point, pointcoords);
+        // Get all cells touching this point.
+        const vtkIdType numCellNeighbors = p.Links->GetNumberOfCells(point);
+        const vtkIdType* cellsOnPoint = p.Links->GetCells(point);
+
+        std::fill(g.begin(), g.end(), 0);
+
+        int highestCellDimension = p.HighestCellDimension;
+        if (p.Patch)
         {
-          int cellDimension = structure->GetCell(cellsOnPoint->GetId(neighbor))->GetCellDimension();
-          if (cellDimension > highestCellDimension)
+          highestCellDimension = 0;
+          for (vtkIdType neighbor = 0; neighbor < numCellNeighbors; neighbor++)
           {
-            highestCellDimension = cellDimension;
-            if (highestCellDimension == maxCellDimension)
-            {
-              break;
-            }
+            highestCellDimension = std::max(
+              highestCellDimension, int(p.CellDimensions[cellsOnPoint[neighbor]]));
           }
         }
-      }
-      vtkIdType numValidCellNeighbors = 0;
+        vtkIdType numValidCellNeighbors = 0;
 
-      // Iterate on all cells and find all points connected to current point
-      // by an edge.
-      for (vtkIdType neighbor = 0; neighbor < numCellNeighbors; neighbor++)
-      {
-        vtkCell *cell = structure->GetCell(cellsOnPoint->GetId(neighbor));
-        if (cell->GetCellDimension() >= highestCellDimension)
+        // Iterate on all cells and find all points connected to current point
+        // by an edge.
+        for (vtkIdType neighbor = 0; neighbor < numCellNeighbors; neighbor++)
         {
+          const vtkIdType cellId = cellsOnPoint[neighbor];
+          if (p.CellDimensions && p.CellDimensions[cellId] < highestCellDimension)
+          {
+            continue;
+          }
+          p.Structure->GetCell(cellId, cell);
           int subId;
           double parametricCoord[3];
           if(GetCellParametricData(point, pointcoords, cell,
-                                   subId, parametricCoord))
+                                   subId, parametricCoord, cellValues))
           {
             numValidCellNeighbors++;
+            int numberOfCellPoints = cell->GetNumberOfPoints();
+            cellValues.resize(numberOfCellPoints);
             for(int inputComponent=0;inputComponent<numberOfInputComponents;inputComponent++)
             {
-              int numberOfCellPoints = cell->GetNumberOfPoints();
-              std::vector<double> values(numberOfCellPoints);
               // Get values of Array at cell points.
               for (int i = 0; i < numberOfCellPoints; i++)
               {
-                values[i] = array->GetComponent(cell->GetPointId(i), inputComponent);
+                cellValues[i] = static_cast<double>(
+                  values.Get(cell->GetPointId(i), inputComponent));
               }
 
               double derivative[3];
               // Get derivative of cell at point.
-              cell->Derivatives(subId, parametricCoord, &values[0], 1, derivative);
+              cell->Derivatives(subId, parametricCoord, &cellValues[0], 1, derivative);
 
               g[inputComponent*3] += static_cast<data_type>(derivative[0]);
               g[inputComponent*3+1] += static_cast<data_type>(derivative[1]);
               g[inputComponent*3+2] += static_cast<data_type>(derivative[2]);
             } // iterating over Components
           } // if(GetCellParametricData())
-        } // if(cell->GetCellDimension () >= highestCellDimension
-      } // iterating over neighbors
+        } // iterating over neighbors
 
-      if (numValidCellNeighbors > 0)
-      {
-        for(int i=0;i<3*numberOfInputComponents;i++)
+        if (numValidCellNeighbors > 0)
         {
-          g[i] /= numValidCellNeighbors;
+          for(int i=0;i<3*numberOfInputComponents;i++)
+          {
+            g[i] /= numValidCellNeighbors;
+          }
+          StoreGradient(p, point, &g[0]);
         }
+      }  // iterating over points in grid
+    }
 
-        if(vorticity)
-        {
-          ComputeVorticityFromGradient(&g[0], vorticity+3*point);
-        }
-        if(qCriterion)
-        {
-          ComputeQCriterionFromGradient(&g[0], qCriterion+point);
-        }
-        if(divergence)
-        {
-          ComputeDivergenceFromGradient(&g[0], divergence+point);
-        }
-        if(gradients)
+    void Reduce()
+    {
+    }
+
+  private:
+    ArrayT* Array;
+    const GradientParameters<data_type>& Parameters;
+    vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+    vtkSMPThreadLocal<std::vector<double> > Values;
+    vtkSMPThreadLocal<std::vector<data_type> > G;
+  };
+
+//-----------------------------------------------------------------------------
+  template<class data_type>
+  void ComputePointGradientsUG(
+    vtkDataSet *structure, vtkDataArray *array, data_type *gradients,
+    int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
+    data_type* divergence, int contributingCellOption)
+  {
+    vtkIdType numpts = structure->GetNumberOfPoints();
+    vtkIdType numcells = structure->GetNumberOfCells();
+    if (numpts < 1 || numcells < 1)
+    {
+      return;
+    }
+
+    // The cell dimensions are only needed when some cells may not contribute.
+    // They are cached per cell type since generic cells are costly to set up.
+    std::vector<unsigned char> cellDimensions;
+    int highestCellDimension = 0;
+    vtkNew<vtkGenericCell> cell;
+    if (contributingCellOption != vtkGradientFilter::All)
+    {
+      signed char typeDimensions[VTK_NUMBER_OF_CELL_TYPES];
+      std::fill_n(typeDimensions, VTK_NUMBER_OF_CELL_TYPES, -1);
+      cellDimensions.resize(numcells);
+      for (vtkIdType cellId = 0; cellId < numcells; cellId++)
+      {
+        int type = structure->GetCellType(cellId);
+        if (typeDimensions[type] < 0)
         {
-          for(int i=0;i<numberOfOutputComponents;i++)
-          {
-            gradients[point*numberOfOutputComponents+i] = g[i];
-          }
+          cell->SetCellType(type);
+          typeDimensions[type] = static_cast<signed char>(cell->GetCellDimension());
         }
+        cellDimensions[cellId] = static_cast<unsigned char>(typeDimensions[type]);
+      }
+      if (contributingCellOption == vtkGradientFilter::DataSetMax)
+      {
+        highestCellDimension =
+          *std::max_element(cellDimensions.begin(), cellDimensions.end());
       }
-    }  // iterating over points in grid
+    }
+
+    // Build the point to cell links up front and make the cell queries of the
+    // data set thread safe (e.g. build the cells of vtkPolyData).
+    vtkStaticCellLinksTemplate<vtkIdType> links;
+    links.BuildLinks(structure);
+    structure->GetCell(0, cell);
+
+    GradientParameters<data_type> params = GradientParameters<data_type>();
+    params.Structure = structure;
+    params.NumberOfInputComponents = numberOfInputComponents;
+    params.Gradients = gradients;
+    params.Vorticity = vorticity;
+    params.QCriterion = qCriterion;
+    params.Divergence = divergence;
+    params.Links = &links;
+    params.CellDimensions = cellDimensions.empty() ? nullptr : &cellDimensions[0];
+    params.HighestCellDimension = highestCellDimension;
+    params.Patch = contributingCellOption == vtkGradientFilter::Patch;
+
+    ExecuteGradient<PointGradientsUG>(array, params, numpts);
   }
 
 //-----------------------------------------------------------------------------
   int GetCellParametricData(vtkIdType pointId, double pointCoord[3],
-                            vtkCell *cell, int &subId, double parametricCoord[3])
+                            vtkCell *cell, int &subId, double parametricCoord[3],
+                            std::vector<double>& weights)
   {
     // Watch out for degenerate cells.  They make the derivative calculation
     // fail.
@@ -975,14 +1083,85 @@ namespace {
 
     double dummy;
     int numpoints = cell->GetNumberOfPoints();
-    std::vector<double> values(numpoints);
+    weights.resize(numpoints);
     // Get parametric position of point.
     cell->EvaluatePosition(pointCoord, nullptr, subId, parametricCoord,
-                           dummy, &values[0]/*Really another dummy.*/);
+                           dummy, &weights[0]/*Really another dummy.*/);
 
     return 1;
   }
 
+//-----------------------------------------------------------------------------
+  template<class ArrayT, class data_type>
+  class CellGradientsUG
+  {
+  public:
+    CellGradientsUG(ArrayT* array, const GradientParameters<data_type>& params)
+      : Array(array), Parameters(params)
+    {
+    }
+
+    void Initialize()
+    {
+      this->Values.Local().resize(8);
+      this->G.Local().resize(3*this->Parameters.NumberOfInputComponents);
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      const GradientParameters<data_type>& p = this->Parameters;
+      vtkDataArrayAccessor<ArrayT> values(this->Array);
+      vtkGenericCell* cell = this->Cell.Local();
+      std::vector<double>& cellValues = this->Values.Local();
+      std::vector<data_type>& cellGradients = this->G.Local();
+      const int numberOfInputComponents = p.NumberOfInputComponents;
+
+      for (vtkIdType cellid = begin; cellid < end; cellid++)
+      {
+        p.Structure->GetCell(cellid, cell);
+        int subId;
+        double cellCenter[3];
+        subId = cell->GetParametricCenter(cellCenter);
+
+        int numpoints = cell->GetNumberOfPoints();
+        if(static_cast<size_t>(numpoints) > cellValues.size())
+        {
+          cellValues.resize(numpoints);
+        }
+        double derivative[3];
+        for(int inputComponent=0;inputComponent<numberOfInputComponents;
+            inputComponent++)
+        {
+          for (int i = 0; i < numpoints; i++)
+          {
+            cellValues[i] = static_cast<double>(
+              values.Get(cell->GetPointId(i), inputComponent));
+          }
+
+          cell->Derivatives(subId, cellCenter, &cellValues[0], 1, derivative);
+          cellGradients[inputComponent*3] =
+            static_cast<data_type>(derivative[0]);
+          cellGradients[inputComponent*3+1] =
+            static_cast<data_type>(derivative[1]);
+          cellGradients[inputComponent*3+2] =
+            static_cast<data_type>(derivative[2]);
+        }
+        StoreGradient(p, cellid, &cellGradients[0]);
+      }
+    }
+
+    void Reduce()
+    {
+    }
+
+  private:
+    ArrayT* Array;
+    const GradientParameters<data_type>& Parameters;
+    vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+    vtkSMPThreadLocal<std::vector<double> > Values;
+    vtkSMPThreadLocal<std::vector<data_type> > G;
+  };
+
 //-----------------------------------------------------------------------------
   template<class data_type>
     void ComputeCellGradientsUG(
@@ -991,308 +1170,164 @@ namespace {
       data_type* divergence)
   {
     vtkIdType numcells = structure->GetNumberOfCells();
-    std::vector<double> values(8);
-    std::vector<data_type> cellGradients(3*numberOfInputComponents);
-    for (vtkIdType cellid = 0; cellid < numcells; cellid++)
+    if (numcells < 1)
+    {
+      return;
+    }
+
+    // make the cell queries of the data set thread safe
+    vtkNew<vtkGenericCell> cell;
+    structure->GetCell(0, cell);
+
+    GradientParameters<data_type> params = GradientParameters<data_type>();
+    params.Structure = structure;
+    params.NumberOfInputComponents = numberOfInputComponents;
+    params.Gradients = gradients;
+    params.Vorticity = vorticity;
+    params.QCriterion = qCriterion;
+    params.Divergence = divergence;
+
+    ExecuteGradient<CellGradientsUG>(array, params, numcells);
+  }
+
+//-----------------------------------------------------------------------------
+// Finite differences over the (i,j,k) stencil of structured data. The work is
+// split over the rows of constant (j,k).
+  template<class ArrayT, class data_type>
+  class GradientsSG
+  {
+  public:
+    GradientsSG(ArrayT* array, const GradientParameters<data_type>& params)
+      : Array(array), Parameters(params)
     {
-      vtkCell *cell = structure->GetCell(cellid);
-      int subId;
-      double cellCenter[3];
-      subId = cell->GetParametricCenter(cellCenter);
+    }
 
-      int numpoints = cell->GetNumberOfPoints();
-      if(static_cast<size_t>(numpoints) > values.size())
+    void Initialize()
+    {
+      const int numberOfInputComponents = this->Parameters.NumberOfInputComponents;
+      this->DValues.Local().resize(3*numberOfInputComponents);
+      this->G.Local().resize(3*numberOfInputComponents);
+    }
+
+    // The coordinate of point or cell (i,j,k). Image data and rectilinear
+    // grids use precomputed per-axis coordinates, other grids use the point
+    // or the parametric center of the cell.
+    void GetCoordinate(int i, int j, int k, double x[3])
+    {
+      const GradientParameters<data_type>& p = this->Parameters;
+      if (p.AxisCoordinates)
       {
-        values.resize(numpoints);
+        x[0] = p.AxisCoordinates[0][i];
+        x[1] = p.AxisCoordinates[1][j];
+        x[2] = p.AxisCoordinates[2][k];
+        return;
       }
-      double derivative[3];
-      for(int inputComponent=0;inputComponent<numberOfInputComponents;
-          inputComponent++)
+      vtkIdType index = i + (j + static_cast<vtkIdType>(k)*p.Dims[1])*p.Dims[0];
+      if(p.FieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS)
       {
-        for (int i = 0; i < numpoints; i++)
-        {
-          values[i] = array->GetComponent(cell->GetPointId(i), inputComponent);
-        }
-
-        cell->Derivatives(subId, cellCenter, &values[0], 1, derivative);
-        cellGradients[inputComponent*3] =
-          static_cast<data_type>(derivative[0]);
-        cellGradients[inputComponent*3+1] =
-          static_cast<data_type>(derivative[1]);
-        cellGradients[inputComponent*3+2] =
-          static_cast<data_type>(derivative[2]);
+        p.Structure->GetPoint(index, x);
       }
-      if(gradients)
+      else
       {
-        for(int i=0;i<3*numberOfInputComponents;i++)
+        vtkGenericCell* cell = this->Cell.Local();
+        std::vector<double>& weights = this->Weights.Local();
+        p.Structure->GetCell(index, cell);
+        double pcoords[3];
+        int subId = cell->GetParametricCenter(pcoords);
+        weights.resize(cell->GetNumberOfPoints()+1);
+        cell->EvaluateLocation(subId, pcoords, x, &weights[0]);
+      }
+    }
+
+    // One sided differences at the boundaries and central differences
+    // inside along the given axis. Writes the derivative of the coordinates
+    // in dx and the derivatives of the values in dValues.
+    void Difference(int axis, const int ijk[3], double dx[3], double* dValues,
+                    vtkDataArrayAccessor<ArrayT>& values)
+    {
+      const GradientParameters<data_type>& p = this->Parameters;
+      const int numberOfInputComponents = p.NumberOfInputComponents;
+      const int dim = p.Dims[axis];
+      if ( dim == 1 ) // 2D in this direction
+      {
+        dx[0] = dx[1] = dx[2] = 0.0;
+        dx[axis] = 1.0;
+        for(int inputComponent=0;inputComponent<numberOfInputComponents;
+            inputComponent++)
         {
-          gradients[cellid*3*numberOfInputComponents+i] = cellGradients[i];
+          dValues[inputComponent] = 0;
         }
+        return;
       }
-      if(vorticity)
+
+      int plus[3] = { ijk[0], ijk[1], ijk[2] };
+      int minus[3] = { ijk[0], ijk[1], ijk[2] };
+      double factor = 1.0;
+      if ( ijk[axis] == 0 )
       {
-        ComputeVorticityFromGradient(&cellGradients[0], vorticity+3*cellid);
+        plus[axis]++;
       }
-      if(qCriterion)
+      else if ( ijk[axis] == (dim-1) )
       {
-        ComputeQCriterionFromGradient(&cellGradients[0], qCriterion+cellid);
+        minus[axis]--;
       }
-      if(divergence)
+      else
       {
-        ComputeDivergenceFromGradient(&cellGradients[0], divergence+cellid);
+        factor = 0.5;
+        plus[axis]++;
+        minus[axis]--;
       }
-    }
-  }
 
-//-----------------------------------------------------------------------------
-  template<class Grid, class data_type>
-  void ComputeGradientsSG(Grid output, vtkDataArray* array, data_type* gradients,
-                          int numberOfInputComponents, int fieldAssociation,
-                          data_type* vorticity, data_type* qCriterion,
-                          data_type* divergence)
-  {
-    int idx, idx2, inputComponent;
-    double xp[3], xm[3], factor;
-    xp[0] = xp[1] = xp[2] = xm[0] = xm[1] = xm[2] = factor = 0;
-    double xxi, yxi, zxi, xeta, yeta, zeta, xzeta, yzeta, zzeta;
-    yxi = zxi = xeta = yeta = zeta = xzeta = yzeta = zzeta = 0;
-    double aj, xix, xiy, xiz, etax, etay, etaz, zetax, zetay, zetaz;
-    xix = xiy = xiz = etax = etay = etaz = zetax = zetay = zetaz = 0;
-    // for finite differencing -- the values on the "plus" side and
-    // "minus" side of the point to be computed at
-    std::vector<double> plusvalues(numberOfInputComponents);
-    std::vector<double> minusvalues(numberOfInputComponents);
-
-    std::vector<double> dValuesdXi(numberOfInputComponents);
-    std::vector<double> dValuesdEta(numberOfInputComponents);
-    std::vector<double> dValuesdZeta(numberOfInputComponents);
-    std::vector<data_type> localGradients(numberOfInputComponents*3);
-
-    int dims[3];
-    output->GetDimensions(dims);
-    if(fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_CELLS)
-    {
-      // reduce the dimensions by 1 for cells
-      for(int i=0;i<3;i++)
+      double xp[3], xm[3];
+      this->GetCoordinate(plus[0], plus[1], plus[2], xp);
+      this->GetCoordinate(minus[0], minus[1], minus[2], xm);
+      for (int ii=0; ii<3; ii++)
+      {
+        dx[ii] = factor * (xp[ii] - xm[ii]);
+      }
+
+      const vtkIdType idx = plus[0] + (plus[1] + static_cast<vtkIdType>(plus[2])*p.Dims[1])*p.Dims[0];
+      const vtkIdType idx2 = minus[0] + (minus[1] + static_cast<vtkIdType>(minus[2])*p.Dims[1])*p.Dims[0];
+      for(int inputComponent=0;inputComponent<numberOfInputComponents;inputComponent++)
       {
-        dims[i]--;
+        dValues[inputComponent] = factor *
+          (static_cast<double>(values.Get(idx, inputComponent)) -
+           static_cast<double>(values.Get(idx2, inputComponent)));
       }
     }
-    int ijsize = dims[0]*dims[1];
 
-    for (int k=0; k<dims[2]; k++)
+    void operator()(vtkIdType begin, vtkIdType end)
     {
-      for (int j=0; j<dims[1]; j++)
+      const GradientParameters<data_type>& p = this->Parameters;
+      vtkDataArrayAccessor<ArrayT> values(this->Array);
+      const int numberOfInputComponents = p.NumberOfInputComponents;
+      std::vector<double>& dValues = this->DValues.Local();
+      std::vector<data_type>& localGradients = this->G.Local();
+      double* dValuesdXi = &dValues[0];
+      double* dValuesdEta = dValuesdXi + numberOfInputComponents;
+      double* dValuesdZeta = dValuesdEta + numberOfInputComponents;
+
+      for (vtkIdType row = begin; row < end; row++)
       {
-        for (int i=0; i<dims[0]; i++)
+        int ijk[3] = { 0, static_cast<int>(row % p.Dims[1]),
+                       static_cast<int>(row / p.Dims[1]) };
+        for (ijk[0] = 0; ijk[0] < p.Dims[0]; ijk[0]++)
         {
-          //  Xi derivatives.
-          if ( dims[0] == 1 ) // 2D in this direction
-          {
-            factor = 1.0;
-            for (int ii=0; ii<3; ii++)
-            {
-              xp[ii] = xm[ii] = 0.0;
-            }
-            xp[0] = 1.0;
-            for(inputComponent=0;inputComponent<numberOfInputComponents;
-                inputComponent++)
-            {
-              plusvalues[inputComponent] = minusvalues[inputComponent] = 0;
-            }
-          }
-          else if ( i == 0 )
-          {
-            factor = 1.0;
-            idx = (i+1) + j*dims[0] + k*ijsize;
-            idx2 = i + j*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
-            for(inputComponent=0;inputComponent<numberOfInputComponents;
-                inputComponent++)
-            {
-              plusvalues[inputComponent] = array->GetComponent(idx, inputComponent);
-              minusvalues[inputComponent] = array->GetComponent(idx2, inputComponent);
-            }
-          }
-          else if ( i == (dims[0]-1) )
-          {
-            factor = 1.0;
-            idx = i + j*dims[0] + k*ijsize;
-            idx2 = i-1 + j*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
-            for(inputComponent=0;inputComponent<numberOfInputComponents;
-                inputComponent++)
-            {
-              plusvalues[inputComponent] = array->GetComponent(idx, inputComponent);
-              minusvalues[inputComponent] = array->GetComponent(idx2, inputComponent);
-            }
-          }
-          else
-          {
-            factor = 0.5;
-            idx = (i+1) + j*dims[0] + k*ijsize;
-            idx2 = (i-1) + j*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
-            for(inputComponent=0;inputComponent<numberOfInputComponents;
-                inputComponent++)
-            {
-              plusvalues[inputComponent] = array->GetComponent(idx, inputComponent);
-              minusvalues[inputComponent] = array->GetComponent(idx2, inputComponent);
-            }
-          }
-
-          xxi = factor * (xp[0] - xm[0]);
-          yxi = factor * (xp[1] - xm[1]);
-          zxi = factor * (xp[2] - xm[2]);
-          for(inputComponent=0;inputComponent<numberOfInputComponents;inputComponent++)
-          {
-            dValuesdXi[inputComponent] = factor *
-              (plusvalues[inputComponent] - minusvalues[inputComponent]);
-          }
-
-          //  Eta derivatives.
-          if ( dims[1] == 1 ) // 2D in this direction
-          {
-            factor = 1.0;
-            for (int ii=0; ii<3; ii++)
-            {
-              xp[ii] = xm[ii] = 0.0;
-            }
-            xp[1] = 1.0;
-            for(inputComponent=0;inputComponent<numberOfInputComponents;
-                inputComponent++)
-            {
-              plusvalues[inputComponent] = minusvalues[inputComponent] = 0;
-            }
-          }
-          else if ( j == 0 )
-          {
-            factor = 1.0;
-            idx = i + (j+1)*dims[0] + k*ijsize;
-            idx2 = i + j*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
-            for(inputComponent=0;inputComponent<numberOfInputComponents;
-                inputComponent++)
-            {
-              plusvalues[inputComponent] = array->GetComponent(idx, inputComponent);
-              minusvalues[inputComponent] = array->GetComponent(idx2, inputComponent);
-            }
-          }
-          else if ( j == (dims[1]-1) )
-          {
-            factor = 1.0;
-            idx = i + j*dims[0] + k*ijsize;
-            idx2 = i + (j-1)*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
-            for(inputComponent=0;inputComponent<numberOfInputComponents;
-                inputComponent++)
-            {
-              plusvalues[inputComponent] = array->GetComponent(idx, inputComponent);
-              minusvalues[inputComponent] = array->GetComponent(idx2, inputComponent);
-            }
-          }
-          else
-          {
-            factor = 0.5;
-            idx = i + (j+1)*dims[0] + k*ijsize;
-            idx2 = i + (j-1)*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
-            for(inputComponent=0;inputComponent<numberOfInputComponents;
-                inputComponent++)
-            {
-              plusvalues[inputComponent] = array->GetComponent(idx, inputComponent);
-              minusvalues[inputComponent] = array->GetComponent(idx2, inputComponent);
-            }
-          }
+          double dXi[3], dEta[3], dZeta[3];
+          this->Difference(0, ijk, dXi, dValuesdXi, values);
+          this->Difference(1, ijk, dEta, dValuesdEta, values);
+          this->Difference(2, ijk, dZeta, dValuesdZeta, values);
 
-          xeta = factor * (xp[0] - xm[0]);
-          yeta = factor * (xp[1] - xm[1]);
-          zeta = factor * (xp[2] - xm[2]);
-          for(inputComponent=0;inputComponent<numberOfInputComponents;inputComponent++)
-          {
-            dValuesdEta[inputComponent] = factor *
-              (plusvalues[inputComponent] - minusvalues[inputComponent]);
-          }
-
-          //  Zeta derivatives.
-          if ( dims[2] == 1 ) // 2D in this direction
-          {
-            factor = 1.0;
-            for (int ii=0; ii<3; ii++)
-            {
-              xp[ii] = xm[ii] = 0.0;
-            }
-            for(inputComponent=0;inputComponent<numberOfInputComponents;
-                inputComponent++)
-            {
-              plusvalues[inputComponent] = minusvalues[inputComponent] = 0;
-            }
-            xp[2] = 1.0;
-          }
-          else if ( k == 0 )
-          {
-            factor = 1.0;
-            idx = i + j*dims[0] + (k+1)*ijsize;
-            idx2 = i + j*dims[0] + k*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
-            for(inputComponent=0;inputComponent<numberOfInputComponents;
-                inputComponent++)
-            {
-              plusvalues[inputComponent] = array->GetComponent(idx, inputComponent);
-              minusvalues[inputComponent] = array->GetComponent(idx2, inputComponent);
-            }
-          }
-          else if ( k == (dims[2]-1) )
-          {
-            factor = 1.0;
-            idx = i + j*dims[0] + k*ijsize;
-            idx2 = i + j*dims[0] + (k-1)*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
-            for(inputComponent=0;inputComponent<numberOfInputComponents;
-                inputComponent++)
-            {
-              plusvalues[inputComponent] = array->GetComponent(idx, inputComponent);
-              minusvalues[inputComponent] = array->GetComponent(idx2, inputComponent);
-            }
-          }
-          else
-          {
-            factor = 0.5;
-            idx = i + j*dims[0] + (k+1)*ijsize;
-            idx2 = i + j*dims[0] + (k-1)*ijsize;
-            GetGridEntityCoordinate(output, fieldAssociation, idx, xp);
-            GetGridEntityCoordinate(output, fieldAssociation, idx2, xm);
-            for(inputComponent=0;inputComponent<numberOfInputComponents;
-                inputComponent++)
-            {
-              plusvalues[inputComponent] = array->GetComponent(idx, inputComponent);
-              minusvalues[inputComponent] = array->GetComponent(idx2, inputComponent);
-            }
-          }
-
-          xzeta = factor * (xp[0] - xm[0]);
-          yzeta = factor * (xp[1] - xm[1]);
-          zzeta = factor * (xp[2] - xm[2]);
-          for(inputComponent=0;inputComponent<numberOfInputComponents;inputComponent++)
-          {
-            dValuesdZeta[inputComponent] = factor *
-              (plusvalues[inputComponent] - minusvalues[inputComponent]);
-          }
+          const double xxi = dXi[0], yxi = dXi[1], zxi = dXi[2];
+          const double xeta = dEta[0], yeta = dEta[1], zeta = dEta[2];
+          const double xzeta = dZeta[0], yzeta = dZeta[1], zzeta = dZeta[2];
 
           // Now calculate the Jacobian.  Grids occasionally have
           // singularities, or points where the Jacobian is infinite (the
           // inverse is zero).  For these cases, we'll set the Jacobian to
           // zero, which will result in a zero derivative.
           //
-          aj =  xxi*yeta*zzeta+yxi*zeta*xzeta+zxi*xeta*yzeta
+          double aj =  xxi*yeta*zzeta+yxi*zeta*xzeta+zxi*xeta*yzeta
             -zxi*yeta*xzeta-yxi*xeta*zzeta-xxi*zeta*yzeta;
           if (aj != 0.0)
           {
@@ -1300,23 +1335,22 @@ namespace {
           }
 
           //  Xi metrics.
-          xix  =  aj*(yeta*zzeta-zeta*yzeta);
-          xiy  = -aj*(xeta*zzeta-zeta*xzeta);
-          xiz  =  aj*(xeta*yzeta-yeta*xzeta);
+          const double xix  =  aj*(yeta*zzeta-zeta*yzeta);
+          const double xiy  = -aj*(xeta*zzeta-zeta*xzeta);
+          const double xiz  =  aj*(xeta*yzeta-yeta*xzeta);
 
           //  Eta metrics.
-          etax = -aj*(yxi*zzeta-zxi*yzeta);
-          etay =  aj*(xxi*zzeta-zxi*xzeta);
-          etaz = -aj*(xxi*yzeta-yxi*xzeta);
+          const double etax = -aj*(yxi*zzeta-zxi*yzeta);
+          const double etay =  aj*(xxi*zzeta-zxi*xzeta);
+          const double etaz = -aj*(xxi*yzeta-yxi*xzeta);
 
           //  Zeta metrics.
-          zetax=  aj*(yxi*zeta-zxi*yeta);
-          zetay= -aj*(xxi*zeta-zxi*xeta);
-          zetaz=  aj*(xxi*yeta-yxi*xeta);
+          const double zetax=  aj*(yxi*zeta-zxi*yeta);
+          const double zetay= -aj*(xxi*zeta-zxi*xeta);
+          const double zetaz=  aj*(xxi*yeta-yxi*xeta);
 
           // Finally compute the actual derivatives
-          idx = i + j*dims[0] + k*ijsize;
-          for(inputComponent=0;inputComponent<numberOfInputComponents;inputComponent++)
+          for(int inputComponent=0;inputComponent<numberOfInputComponents;inputComponent++)
           {
             localGradients[inputComponent*3] = static_cast<data_type>(
               xix*dValuesdXi[inputComponent]+etax*dValuesdEta[inputComponent]+
@@ -1331,28 +1365,114 @@ namespace {
               zetaz*dValuesdZeta[inputComponent]);
           }
 
-          if(gradients)
-          {
-            for(int ii=0;ii<3*numberOfInputComponents;ii++)
-            {
-              gradients[idx*numberOfInputComponents*3+ii] = localGradients[ii];
-            }
-          }
-          if(vorticity)
-          {
-            ComputeVorticityFromGradient(&localGradients[0], vorticity+3*idx);
-          }
-          if(qCriterion)
-          {
-            ComputeQCriterionFromGradient(&localGradients[0], qCriterion+idx);
-          }
-          if(divergence)
-          {
-            ComputeDivergenceFromGradient(&localGradients[0], divergence+idx);
-          }
+          const vtkIdType idx = ijk[0] + row*p.Dims[0];
+          StoreGradient(p, idx, &localGradients[0]);
+        }
+      }
+    }
+
+    void Reduce()
+    {
+    }
+
+  private:
+    ArrayT* Array;
+    const GradientParameters<data_type>& Parameters;
+    vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+    vtkSMPThreadLocal<std::vector<double> > Weights;
+    vtkSMPThreadLocal<std::vector<double> > DValues;
+    vtkSMPThreadLocal<std::vector<data_type> > G;
+  };
+
+//-----------------------------------------------------------------------------
+// Coordinates of the points or cell centers along each axis of image data and
+// rectilinear grids, for which they only depend on the index along that axis.
+  void GetAxisCoordinates(vtkDataSet* output, int fieldAssociation,
+                          const int pointDims[3], std::vector<double> coords[3])
+  {
+    for (int axis = 0; axis < 3; axis++)
+    {
+      std::vector<double> pointCoords(pointDims[axis]);
+      if (vtkImageData* image = vtkImageData::SafeDownCast(output))
+      {
+        const double* origin = image->GetOrigin();
+        const double* spacing = image->GetSpacing();
+        const int* extent = image->GetExtent();
+        for (int i = 0; i < pointDims[axis]; i++)
+        {
+          pointCoords[i] = origin[axis] + (extent[2*axis] + i) * spacing[axis];
+        }
+      }
+      else
+      {
+        vtkRectilinearGrid* grid = vtkRectilinearGrid::SafeDownCast(output);
+        vtkDataArray* axisCoords = axis == 0 ? grid->GetXCoordinates() :
+          (axis == 1 ? grid->GetYCoordinates() : grid->GetZCoordinates());
+        for (int i = 0; i < pointDims[axis]; i++)
+        {
+          pointCoords[i] = axisCoords->GetComponent(i, 0);
+        }
+      }
+
+      if(fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS)
+      {
+        coords[axis].swap(pointCoords);
+      }
+      else
+      {
+        // cell centers, or the point coordinate along flat axes
+        const int numCells = std::max(pointDims[axis]-1, 1);
+        coords[axis].resize(numCells);
+        for (int i = 0; i < numCells; i++)
+        {
+          coords[axis][i] = pointDims[axis] > 1 ?
+            0.5*(pointCoords[i] + pointCoords[i+1]) : pointCoords[0];
         }
       }
     }
   }
 
+//-----------------------------------------------------------------------------
+  template<class Grid, class data_type>
+  void ComputeGradientsSG(Grid output, vtkDataArray* array, data_type* gradients,
+                          int numberOfInputComponents, int fieldAssociation,
+                          data_type* vorticity, data_type* qCriterion,
+                          data_type* divergence)
+  {
+    int pointDims[3];
+    output->GetDimensions(pointDims);
+
+    GradientParameters<data_type> params = GradientParameters<data_type>();
+    params.Structure = output;
+    params.NumberOfInputComponents = numberOfInputComponents;
+    params.Gradients = gradients;
+    params.Vorticity = vorticity;
+    params.QCriterion = qCriterion;
+    params.Divergence = divergence;
+    params.FieldAssociation = fieldAssociation;
+    for(int i=0;i<3;i++)
+    {
+      params.Dims[i] = pointDims[i];
+      if(fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_CELLS)
+      {
+        // reduce the dimensions by 1 for cells
+        params.Dims[i]--;
+      }
+    }
+    vtkIdType numberOfRows = static_cast<vtkIdType>(params.Dims[1])*params.Dims[2];
+    if (params.Dims[0] < 1 || numberOfRows < 1)
+    {
+      return;
+    }
+
+    std::vector<double> axisCoordinates[3];
+    if (!vtkStructuredGrid::SafeDownCast(output))
+    {
+      GetAxisCoordinates(output, fieldAssociation, pointDims, axisCoordinates);
+      params.AxisCoordinates = axisCoordinates;
+    }
+
+    ExecuteGradient<GradientsSG>(array, params, numberOfRows);
+  }
+
 } // end anonymous namespace
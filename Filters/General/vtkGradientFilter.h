@@ -39,6 +39,10 @@
  * the entire data set. For Patch or DataSetMax it is possible that some values
  * will not be computed. The ReplacementValueOption specifies what to use
  * for these values.
+ *
+ * The computation is multithreaded with vtkSMPTools. The requested
+ * derivative quantities are all derived from a single gradient evaluation
+ * per point or cell.
 */
 
 #ifndef vtkGradientFilter_h
@@ -0,0 +1,186 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTemporalPrefetcher.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkTemporalPrefetcher
+// .SECTION Description
+// Plays the time steps of a temporal source forward through
+// vtkTemporalPrefetcher, then seeks backwards, and checks that every
+// requested time step is the right one and that prefetched time steps are
+// not read again.
+
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
+#include "vtkSphereSource.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+#include "vtkTemporalPrefetcher.h"
+
+#include <cmath>
+
+//-------------------------------------------------------------------------
+// A sphere whose radius is 1 + the requested time, that counts how many
+// times it executes.
+//-------------------------------------------------------------------------
+class vtkTestPrefetchSphereSource : public vtkSphereSource
+{
+public:
+  static vtkTestPrefetchSphereSource *New();
+  vtkTypeMacro(vtkTestPrefetchSphereSource, vtkSphereSource);
+
+  vtkAtomicInt32 NumberOfExecutions;
+
+protected:
+  vtkTestPrefetchSphereSource()
+  {
+    this->NumberOfExecutions = 0;
+  }
+
+  int RequestInformation(vtkInformation* request,
+    vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override
+  {
+    if (!this->Superclass::RequestInformation(request, inputVector, outputVector))
+    {
+      return 0;
+    }
+    double timeSteps[10];
+    for (int i = 0; i < 10; ++i)
+    {
+      timeSteps[i] = i;
+    }
+    double timeRange[2] = { timeSteps[0], timeSteps[9] };
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_STEPS(), timeSteps, 10);
+    outInfo->Set(vtkStreamingDemandDrivenPipeline::TIME_RANGE(), timeRange, 2);
+    return 1;
+  }
+
+  int RequestData(vtkInformation* request,
+    vtkInformationVector** inputVector,
+    vtkInformationVector* outputVector) override
+  {
+    vtkInformation* outInfo = outputVector->GetInformationObject(0);
+    // not SetRadius(), which would modify the source
+    this->Radius = 1.0 +
+      outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP());
+    ++this->NumberOfExecutions;
+    return this->Superclass::RequestData(request, inputVector, outputVector);
+  }
+
+private:
+  vtkTestPrefetchSphereSource(const vtkTestPrefetchSphereSource&) = delete;
+  void operator=(const vtkTestPrefetchSphereSource&) = delete;
+};
+
+vtkStandardNewMacro(vtkTestPrefetchSphereSource);
+
+namespace
+{
+bool CheckTimeStep(vtkTemporalPrefetcher* prefetcher, double time)
+{
+  if (!prefetcher->UpdateTimeStep(time))
+  {
+    std::cerr << "Updating time " << time << " failed." << std::endl;
+    return false;
+  }
+  vtkPolyData* output = vtkPolyData::SafeDownCast(prefetcher->GetOutputDataObject(0));
+  double bounds[6];
+  output->GetBounds(bounds);
+  if (std::fabs(bounds[5] - (1.0 + time)) > 1e-6 ||
+      output->GetInformation()->Get(vtkDataObject::DATA_TIME_STEP()) != time)
+  {
+    std::cerr << "Wrong data for time " << time << ": z max is " << bounds[5]
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+//-------------------------------------------------------------------------
+int TestTemporalPrefetcher(int, char*[])
+{
+  // forward playback reads every time step once
+  vtkNew<vtkTestPrefetchSphereSource> sphere;
+  vtkNew<vtkTemporalPrefetcher> prefetcher;
+  prefetcher->SetReader(sphere);
+  prefetcher->SetNumberOfTimeStepsToPrefetch(2);
+  for (int i = 0; i < 10; ++i)
+  {
+    if (!CheckTimeStep(prefetcher, i))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  prefetcher->CancelPrefetching();
+  if (sphere->NumberOfExecutions != 10)
+  {
+    std::cerr << "Forward playback read " << sphere->NumberOfExecutions
+              << " time steps instead of 10." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // seeking back reads the released time step again and prefetches
+  // backwards from there
+  if (!CheckTimeStep(prefetcher, 5) || !CheckTimeStep(prefetcher, 4) ||
+      !CheckTimeStep(prefetcher, 3))
+  {
+    return EXIT_FAILURE;
+  }
+  prefetcher->CancelPrefetching();
+  if (sphere->NumberOfExecutions < 13 || sphere->NumberOfExecutions > 15)
+  {
+    std::cerr << "Seeking read " << sphere->NumberOfExecutions - 10
+              << " time steps instead of 3 to 5." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // modifying the reader invalidates the prefetched time steps
+  sphere->SetThetaResolution(16);
+  const int executions = sphere->NumberOfExecutions;
+  if (!CheckTimeStep(prefetcher, 2))
+  {
+    return EXIT_FAILURE;
+  }
+  prefetcher->CancelPrefetching();
+  if (sphere->NumberOfExecutions == executions)
+  {
+    std::cerr << "A time step of the modified reader was not read again."
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // without memory budget only the requested time steps are read
+  vtkNew<vtkTestPrefetchSphereSource> sphere2;
+  vtkNew<vtkTemporalPrefetcher> prefetcher2;
+  prefetcher2->SetReader(sphere2);
+  prefetcher2->SetMemoryBudget(0);
+  for (int i = 0; i < 10; ++i)
+  {
+    if (!CheckTimeStep(prefetcher2, i))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+  prefetcher2->CancelPrefetching();
+  if (sphere2->NumberOfExecutions != 10)
+  {
+    std::cerr << "Without memory budget " << sphere2->NumberOfExecutions
+              << " time steps were read instead of 10." << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
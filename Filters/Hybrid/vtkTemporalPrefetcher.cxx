@@ -0,0 +1,547 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkTemporalPrefetcher.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkTemporalPrefetcher.h"
+
+#include "vtkConditionVariable.h"
+#include "vtkDataObject.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
+#include "vtkMultiThreader.h"
+#include "vtkMutexLock.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkSmartPointer.h"
+#include "vtkStreamingDemandDrivenPipeline.h"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <vector>
+
+//****************************************************************************
+class vtkTemporalPrefetcher::vtkInternals
+{
+public:
+  struct CacheEntry
+  {
+    vtkSmartPointer<vtkDataObject> Data;
+    unsigned long Size;
+  };
+  typedef std::map<double, CacheEntry> CacheType;
+
+  vtkNew<vtkMultiThreader> Threader;
+  int ThreadId;
+
+  // the time steps of the reader and the last requested one, only used by
+  // the main thread
+  std::vector<double> TimeSteps;
+  int LastIndex;
+
+  //------------------------------------------------------------------------
+  // Lock must be held to access the following members once the background
+  // thread has been spawned. The condition is signaled whenever the queue,
+  // the Reading flag or the Done flag change.
+  vtkSimpleMutexLock Lock;
+  vtkSimpleConditionVariable Changed;
+  bool Done;
+  std::deque<double> Queue;
+  bool Reading;
+  double ReadingTime;
+
+  vtkAlgorithm *Reader;
+  int Piece;
+  int NumberOfPieces;
+  int GhostLevels;
+  vtkMTimeType ReaderMTime;
+
+  CacheType Cache;
+  unsigned long CacheSize;
+  unsigned long MemoryBudget;
+
+  vtkInternals()
+    : ThreadId(-1)
+    , LastIndex(-1)
+    , Done(false)
+    , Reading(false)
+    , ReadingTime(0.0)
+    , Reader(nullptr)
+    , Piece(-1)
+    , NumberOfPieces(1)
+    , GhostLevels(0)
+    , ReaderMTime(0)
+    , CacheSize(0)
+    , MemoryBudget(0)
+  {
+  }
+
+  //------------------------------------------------------------------------
+  // Drop the pending prefetches and wait until the reader is idle.
+  // Lock must be held.
+  void WaitForReader()
+  {
+    this->Queue.clear();
+    while (this->Reading)
+    {
+      this->Changed.Wait(this->Lock);
+    }
+  }
+
+  //------------------------------------------------------------------------
+  // Lock must be held.
+  void Insert(double time, vtkDataObject *data)
+  {
+    CacheEntry &entry = this->Cache[time];
+    if (entry.Data)
+    {
+      this->CacheSize -= entry.Size;
+    }
+    entry.Data = data;
+    entry.Size = data->GetActualMemorySize();
+    this->CacheSize += entry.Size;
+  }
+
+  //------------------------------------------------------------------------
+  // Lock must be held.
+  void ClearCache()
+  {
+    this->Cache.clear();
+    this->CacheSize = 0;
+  }
+
+  //------------------------------------------------------------------------
+  // Read a time step with the reader and return a shallow copy of its
+  // output, or nullptr if reading failed. Lock must not be held, and the
+  // calling thread must be the only one using the reader.
+  static vtkSmartPointer<vtkDataObject> Read(vtkAlgorithm *reader,
+    double time, int piece, int numberOfPieces, int ghostLevels)
+  {
+    vtkSmartPointer<vtkDataObject> data;
+    if (!reader->UpdateTimeStep(time, piece, numberOfPieces, ghostLevels))
+    {
+      return data;
+    }
+    vtkDataObject *output = reader->GetOutputDataObject(0);
+    if (output)
+    {
+      data.TakeReference(output->NewInstance());
+      data->ShallowCopy(output);
+      data->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(), time);
+    }
+    return data;
+  }
+
+  //------------------------------------------------------------------------
+  // The background thread reads the queued time steps until Done is set.
+  static VTK_THREAD_RETURN_TYPE Prefetch(void *calldata)
+  {
+    vtkMultiThreader::ThreadInfo *info =
+      static_cast<vtkMultiThreader::ThreadInfo *>(calldata);
+    vtkInternals *self = static_cast<vtkInternals *>(info->UserData);
+
+    self->Lock.Lock();
+    while (!self->Done)
+    {
+      if (self->Queue.empty())
+      {
+        self->Changed.Wait(self->Lock);
+        continue;
+      }
+      const double time = self->Queue.front();
+      self->Queue.pop_front();
+      if (self->CacheSize >= self->MemoryBudget)
+      {
+        // out of memory budget: drop the prefetches of this request
+        self->Queue.clear();
+        continue;
+      }
+      if (self->Cache.find(time) != self->Cache.end())
+      {
+        continue;
+      }
+      vtkAlgorithm *reader = self->Reader;
+      const int piece = self->Piece;
+      const int numberOfPieces = self->NumberOfPieces;
+      const int ghostLevels = self->GhostLevels;
+      self->Reading = true;
+      self->ReadingTime = time;
+      self->Lock.Unlock();
+
+      vtkSmartPointer<vtkDataObject> data =
+        Read(reader, time, piece, numberOfPieces, ghostLevels);
+
+      self->Lock.Lock();
+      if (data)
+      {
+        self->Insert(time, data);
+      }
+      self->ReaderMTime = reader->GetMTime();
+      self->Reading = false;
+      self->Changed.Broadcast();
+    }
+    self->Lock.Unlock();
+    return VTK_THREAD_RETURN_VALUE;
+  }
+};
+
+//****************************************************************************
+vtkStandardNewMacro(vtkTemporalPrefetcher);
+
+//----------------------------------------------------------------------------
+vtkTemporalPrefetcher::vtkTemporalPrefetcher()
+{
+  this->Reader = nullptr;
+  this->NumberOfTimeStepsToPrefetch = 2;
+  this->MemoryBudget = 1048576;
+  this->Internals = new vtkInternals;
+  this->SetNumberOfInputPorts(0);
+  this->SetNumberOfOutputPorts(1);
+}
+
+//----------------------------------------------------------------------------
+vtkTemporalPrefetcher::~vtkTemporalPrefetcher()
+{
+  vtkInternals &internals = *this->Internals;
+  internals.Lock.Lock();
+  internals.Done = true;
+  internals.Queue.clear();
+  internals.Changed.Broadcast();
+  internals.Lock.Unlock();
+  if (internals.ThreadId >= 0)
+  {
+    internals.Threader->TerminateThread(internals.ThreadId);
+  }
+  delete this->Internals;
+
+  if (this->Reader)
+  {
+    this->Reader->UnRegister(this);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalPrefetcher::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+
+  os << indent << "Reader: ";
+  if (this->Reader)
+  {
+    os << endl;
+    this->Reader->PrintSelf(os, indent.GetNextIndent());
+  }
+  else
+  {
+    os << "(none)" << endl;
+  }
+  os << indent << "NumberOfTimeStepsToPrefetch: "
+     << this->NumberOfTimeStepsToPrefetch << endl;
+  os << indent << "MemoryBudget: " << this->MemoryBudget << endl;
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalPrefetcher::SetReader(vtkAlgorithm *reader)
+{
+  if (this->Reader == reader)
+  {
+    return;
+  }
+
+  vtkInternals &internals = *this->Internals;
+  internals.Lock.Lock();
+  internals.WaitForReader();
+  internals.ClearCache();
+  internals.Reader = reader;
+  internals.Lock.Unlock();
+
+  if (this->Reader)
+  {
+    this->Reader->UnRegister(this);
+  }
+  this->Reader = reader;
+  if (this->Reader)
+  {
+    this->Reader->Register(this);
+  }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkTemporalPrefetcher::CancelPrefetching()
+{
+  vtkInternals &internals = *this->Internals;
+  internals.Lock.Lock();
+  internals.WaitForReader();
+  internals.Lock.Unlock();
+}
+
+//----------------------------------------------------------------------------
+vtkMTimeType vtkTemporalPrefetcher::GetMTime()
+{
+  vtkMTimeType mTime = this->Superclass::GetMTime();
+  if (this->Reader)
+  {
+    mTime = std::max(mTime, this->Reader->GetMTime());
+  }
+  return mTime;
+}
+
+//----------------------------------------------------------------------------
+int vtkTemporalPrefetcher::ProcessRequest(
+  vtkInformation* request,
+  vtkInformationVector** inputVector,
+  vtkInformationVector* outputVector)
+{
+  // create the output
+  if (request->Has(vtkDemandDrivenPipeline::REQUEST_DATA_OBJECT()))
+  {
+    return this->RequestDataObject(request, inputVector, outputVector);
+  }
+
+  // set the time steps
+  if (request->Has(vtkDemandDrivenPipeline::REQUEST_INFORMATION()))
+  {
+    return this->RequestInformation(request, inputVector, outputVector);
+  }
+
+  // generate the data
+  if (request->Has(vtkDemandDrivenPipeline::REQUEST_DATA()))
+  {
+    return this->RequestData(request, inputVector, outputVector);
+  }
+
+  return this->Superclass::ProcessRequest(request, inputVector, outputVector);
+}
+
+//----------------------------------------------------------------------------
+int vtkTemporalPrefetcher::FillOutputPortInformation(
+  int vtkNotUsed(port), vtkInformation* info)
+{
+  info->Set(vtkDataObject::DATA_TYPE_NAME(), "vtkDataObject");
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkTemporalPrefetcher::RequestDataObject(vtkInformation *,
+  vtkInformationVector **, vtkInformationVector *outputVector)
+{
+  if (!this->Reader)
+  {
+    vtkErrorMacro("No reader is set.");
+    return 0;
+  }
+
+  this->CancelPrefetching();
+  this->Reader->UpdateDataObject();
+  vtkDataObject *readerOutput = this->Reader->GetOutputDataObject(0);
+  if (!readerOutput)
+  {
+    return 0;
+  }
+
+  vtkInformation *info = outputVector->GetInformationObject(0);
+  vtkDataObject *output = info->Get(vtkDataObject::DATA_OBJECT());
+  if (!output || !output->IsA(readerOutput->GetClassName()))
+  {
+    vtkDataObject *newOutput = readerOutput->NewInstance();
+    info->Set(vtkDataObject::DATA_OBJECT(), newOutput);
+    newOutput->Delete();
+  }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkTemporalPrefetcher::RequestInformation(vtkInformation *,
+  vtkInformationVector **, vtkInformationVector *outputVector)
+{
+  if (!this->Reader)
+  {
+    vtkErrorMacro("No reader is set.");
+    return 0;
+  }
+
+  this->CancelPrefetching();
+  this->Reader->UpdateInformation();
+  vtkInformation *readerInfo = this->Reader->GetOutputInformation(0);
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+
+  vtkInternals &internals = *this->Internals;
+  internals.TimeSteps.clear();
+  internals.LastIndex = -1;
+  if (readerInfo->Has(vtkStreamingDemandDrivenPipeline::TIME_STEPS()))
+  {
+    const int numberOfTimeSteps =
+      readerInfo->Length(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    const double *timeSteps =
+      readerInfo->Get(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+    internals.TimeSteps.assign(timeSteps, timeSteps + numberOfTimeSteps);
+    std::sort(internals.TimeSteps.begin(), internals.TimeSteps.end());
+    outInfo->CopyEntry(readerInfo, vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  }
+  else
+  {
+    outInfo->Remove(vtkStreamingDemandDrivenPipeline::TIME_STEPS());
+  }
+  if (readerInfo->Has(vtkStreamingDemandDrivenPipeline::TIME_RANGE()))
+  {
+    outInfo->CopyEntry(readerInfo, vtkStreamingDemandDrivenPipeline::TIME_RANGE());
+  }
+  else
+  {
+    outInfo->Remove(vtkStreamingDemandDrivenPipeline::TIME_RANGE());
+  }
+  if (readerInfo->Has(vtkAlgorithm::CAN_HANDLE_PIECE_REQUEST()))
+  {
+    outInfo->CopyEntry(readerInfo, vtkAlgorithm::CAN_HANDLE_PIECE_REQUEST());
+  }
+  return 1;
+}
+
+//----------------------------------------------------------------------------
+int vtkTemporalPrefetcher::RequestData(vtkInformation *,
+  vtkInformationVector **, vtkInformationVector *outputVector)
+{
+  vtkInformation *outInfo = outputVector->GetInformationObject(0);
+  vtkDataObject *output = outInfo->Get(vtkDataObject::DATA_OBJECT());
+  vtkInternals &internals = *this->Internals;
+
+  int piece = -1;
+  int numberOfPieces = 1;
+  int ghostLevels = 0;
+  if (outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER()))
+  {
+    piece = outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_PIECE_NUMBER());
+    numberOfPieces =
+      outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_PIECES());
+    ghostLevels =
+      outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_NUMBER_OF_GHOST_LEVELS());
+  }
+
+  // without time steps there is nothing to prefetch
+  if (!outInfo->Has(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP()) ||
+      internals.TimeSteps.empty())
+  {
+    this->CancelPrefetching();
+    if (piece < 0)
+    {
+      this->Reader->Update();
+    }
+    else if (!this->Reader->UpdatePiece(piece, numberOfPieces, ghostLevels))
+    {
+      return 0;
+    }
+    output->ShallowCopy(this->Reader->GetOutputDataObject(0));
+    return 1;
+  }
+  const double time =
+    outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_TIME_STEP());
+
+  internals.Lock.Lock();
+  internals.Queue.clear();
+  internals.MemoryBudget = this->MemoryBudget;
+
+  // the cached time steps are stale if another piece is requested or if
+  // the reader was modified since it last executed
+  if (piece != internals.Piece || numberOfPieces != internals.NumberOfPieces ||
+      ghostLevels != internals.GhostLevels ||
+      (!internals.Reading && this->Reader->GetMTime() > internals.ReaderMTime))
+  {
+    internals.WaitForReader();
+    internals.ClearCache();
+    internals.Piece = piece;
+    internals.NumberOfPieces = numberOfPieces;
+    internals.GhostLevels = ghostLevels;
+  }
+
+  // the requested time step may be cached, being prefetched or not read yet
+  vtkInternals::CacheType::iterator pos = internals.Cache.find(time);
+  if (pos == internals.Cache.end() && internals.Reading &&
+      internals.ReadingTime == time)
+  {
+    internals.WaitForReader();
+    pos = internals.Cache.find(time);
+  }
+  vtkSmartPointer<vtkDataObject> data;
+  if (pos != internals.Cache.end())
+  {
+    data = pos->second.Data;
+  }
+  else
+  {
+    internals.WaitForReader();
+    internals.Lock.Unlock();
+    data = vtkInternals::Read(
+      this->Reader, time, piece, numberOfPieces, ghostLevels);
+    internals.Lock.Lock();
+    internals.ReaderMTime = this->Reader->GetMTime();
+    if (!data)
+    {
+      internals.Lock.Unlock();
+      return 0;
+    }
+    internals.Insert(time, data);
+  }
+
+  // prefetch the next time steps in the direction of the last request
+  const int index = static_cast<int>(std::upper_bound(internals.TimeSteps.begin(),
+    internals.TimeSteps.end(), time) - internals.TimeSteps.begin()) - 1;
+  const int direction = index < internals.LastIndex ? -1 : 1;
+  internals.LastIndex = index;
+  std::vector<double> window(1, time);
+  for (int i = 1; i <= this->NumberOfTimeStepsToPrefetch; ++i)
+  {
+    const int next = index + direction * i;
+    if (next < 0 || next >= static_cast<int>(internals.TimeSteps.size()))
+    {
+      break;
+    }
+    window.push_back(internals.TimeSteps[next]);
+  }
+
+  // release the time steps outside of the window and queue the missing ones
+  for (pos = internals.Cache.begin(); pos != internals.Cache.end();)
+  {
+    if (std::find(window.begin(), window.end(), pos->first) == window.end())
+    {
+      internals.CacheSize -= pos->second.Size;
+      internals.Cache.erase(pos++);
+    }
+    else
+    {
+      ++pos;
+    }
+  }
+  for (size_t i = 1; i < window.size(); ++i)
+  {
+    if (internals.Cache.find(window[i]) == internals.Cache.end() &&
+        !(internals.Reading && internals.ReadingTime == window[i]))
+    {
+      internals.Queue.push_back(window[i]);
+    }
+  }
+  if (!internals.Queue.empty())
+  {
+    if (internals.ThreadId < 0)
+    {
+      internals.ThreadId =
+        internals.Threader->SpawnThread(vtkInternals::Prefetch, &internals);
+    }
+    internals.Changed.Broadcast();
+  }
+  internals.Lock.Unlock();
+
+  output->ShallowCopy(data);
+  output->GetInformation()->Set(vtkDataObject::DATA_TIME_STEP(), time);
+  return 1;
+}
@@ -0,0 +1,132 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkTemporalPrefetcher.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkTemporalPrefetcher
+ * @brief   read the next time steps of a reader in the background
+ *
+ * vtkTemporalPrefetcher wraps a time-aware reader, such as
+ * vtkXMLUnstructuredGridReader, vtkExodusIIReader or vtkEnSightReader, and
+ * produces its output for the time step requested with UPDATE_TIME_STEP.
+ * After each request, a background thread reads the next
+ * NumberOfTimeStepsToPrefetch time steps, in the direction in which the
+ * time steps were last requested, while the pipeline processes the current
+ * one. A request for a prefetched time step is then answered without
+ * reading. A request for a time step outside of the prefetch window
+ * cancels the pending prefetches; the time step that is being read is
+ * finished first.
+ *
+ * Like vtkTemporalDataSetCache, the time steps are kept as shallow copies
+ * of the reader's output. Prefetching stops once the cached time steps use
+ * MemoryBudget kibibytes, and the time steps outside of the prefetch window
+ * are released on every request.
+ *
+ * The reader is not an input of the pipeline: it is executed by this
+ * algorithm alone, from either thread. It must not be connected to another
+ * pipeline, and its parameters must only be changed after calling
+ * CancelPrefetching(). Its progress and error events may be invoked from
+ * the background thread.
+ *
+ * @sa
+ * vtkTemporalDataSetCache
+*/
+
+#ifndef vtkTemporalPrefetcher_h
+#define vtkTemporalPrefetcher_h
+
+#include "vtkFiltersHybridModule.h" // For export macro
+
+#include "vtkAlgorithm.h"
+
+class VTKFILTERSHYBRID_EXPORT vtkTemporalPrefetcher : public vtkAlgorithm
+{
+public:
+  static vtkTemporalPrefetcher *New();
+  vtkTypeMacro(vtkTemporalPrefetcher, vtkAlgorithm);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  //@{
+  /**
+   * The reader whose time steps are prefetched.
+   */
+  virtual void SetReader(vtkAlgorithm *reader);
+  vtkGetObjectMacro(Reader, vtkAlgorithm);
+  //@}
+
+  //@{
+  /**
+   * The number of time steps read ahead of the requested one. Setting it
+   * to 0 disables prefetching. It defaults to 2.
+   */
+  vtkSetClampMacro(NumberOfTimeStepsToPrefetch, int, 0, VTK_INT_MAX);
+  vtkGetMacro(NumberOfTimeStepsToPrefetch, int);
+  //@}
+
+  //@{
+  /**
+   * The memory, in kibibytes, that the cached time steps may use before
+   * prefetching stops. The requested time step is always kept. It defaults
+   * to 1048576 (1 GiB).
+   */
+  vtkSetMacro(MemoryBudget, unsigned long);
+  vtkGetMacro(MemoryBudget, unsigned long);
+  //@}
+
+  /**
+   * Cancel the pending prefetches and wait for the time step that is
+   * being read. Call this before changing the parameters of the reader.
+   */
+  void CancelPrefetching();
+
+  /**
+   * The modification time also depends on the reader.
+   */
+  vtkMTimeType GetMTime() override;
+
+  /**
+   * see vtkAlgorithm for details
+   */
+  int ProcessRequest(vtkInformation* request,
+                     vtkInformationVector** inputVector,
+                     vtkInformationVector* outputVector) override;
+
+protected:
+  vtkTemporalPrefetcher();
+  ~vtkTemporalPrefetcher() override;
+
+  int FillOutputPortInformation(int port, vtkInformation* info) override;
+
+  virtual int RequestDataObject(vtkInformation *,
+                                vtkInformationVector **,
+                                vtkInformationVector *);
+  virtual int RequestInformation(vtkInformation *,
+                                 vtkInformationVector **,
+                                 vtkInformationVector *);
+  virtual int RequestData(vtkInformation *,
+                          vtkInformationVector **,
+                          vtkInformationVector *);
+
+  vtkAlgorithm *Reader;
+  int NumberOfTimeStepsToPrefetch;
+  unsigned long MemoryBudget;
+
+private:
+  vtkTemporalPrefetcher(const vtkTemporalPrefetcher&) = delete;
+  void operator=(const vtkTemporalPrefetcher&) = delete;
+
+  class vtkInternals;
+  vtkInternals *Internals;
+};
+
+#endif
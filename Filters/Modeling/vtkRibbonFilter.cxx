@@ -14,17 +14,28 @@
 =========================================================================*/
 #include "vtkRibbonFilter.h"
 
+#include "vtkArrayListTemplate.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkMath.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
 #include "vtkPolyData.h"
 #include "vtkPolyLine.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 vtkStandardNewMacro(vtkRibbonFilter);
 
@@ -56,6 +67,184 @@ vtkRibbonFilter::vtkRibbonFilter()
 
 vtkRibbonFilter::~vtkRibbonFilter() = default;
 
+// Line data shared by the planning and generation passes. Each line owns
+// the slice of Normals that starts at its location in the input cell array,
+// so the lines can be processed independently.
+struct vtkRibbonFilterLines
+{
+  vtkPoints *InPts;
+  const vtkIdType *Connectivity;
+  std::vector<vtkIdType> Locations;
+  std::vector<double> Normals;
+  std::vector<int> Status;
+  std::vector<vtkIdType> PointOffsets;
+  std::vector<vtkIdType> StripOffsets;
+  std::vector<vtkIdType> CellIds;
+
+  vtkIdType GetNumberOfPoints(vtkIdType lineId)
+  {
+    return this->Connectivity[this->Locations[lineId]];
+  }
+  const vtkIdType *GetIds(vtkIdType lineId)
+  {
+    return this->Connectivity + this->Locations[lineId] + 1;
+  }
+  double *GetNormals(vtkIdType lineId)
+  {
+    return &this->Normals[3 * (this->Locations[lineId] + 1)];
+  }
+};
+
+// First pass: computes the normals of the lines and checks whether they can
+// be ribboned.
+class vtkRibbonFilterPlanLines
+{
+public:
+  vtkRibbonFilter *Filter;
+  vtkRibbonFilterLines *Lines;
+  vtkDataArray *InNormals; // nullptr if the normals are generated
+  vtkDataArray *InScalars;
+  double *Range;
+
+  vtkSMPThreadLocalObject<vtkPoints> LinePoints;
+  vtkSMPThreadLocalObject<vtkCellArray> LineCells;
+  vtkSMPThreadLocalObject<vtkFloatArray> LineNormals;
+  vtkSMPThreadLocal<std::vector<std::pair<vtkIdType, vtkIdType> > > Sorted;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > LocalIds;
+
+  void Initialize()
+  {
+    this->LinePoints.Local()->SetDataTypeToDouble();
+    this->LineNormals.Local()->SetNumberOfComponents(3);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType lineId = begin; lineId < end; ++lineId)
+    {
+      vtkIdType npts = this->Lines->GetNumberOfPoints(lineId);
+      if (npts < 2)
+      {
+        continue; //skip ribboning this line
+      }
+      const vtkIdType *pts = this->Lines->GetIds(lineId);
+
+      double *normals = this->Lines->GetNormals(lineId);
+      if (this->InNormals)
+      {
+        for (vtkIdType j = 0; j < npts; ++j)
+        {
+          this->InNormals->GetTuple(pts[j], normals + 3 * j);
+        }
+      }
+      else
+      {
+        this->GenerateNormals(npts, pts, normals);
+      }
+
+      this->Lines->Status[lineId] = this->Filter->GeneratePoints(
+        0, npts, pts, this->Lines->InPts, nullptr, nullptr, this->InScalars,
+        this->Range, normals);
+    }
+  }
+
+  void Reduce()
+  {
+  }
+
+  // Each line calculates its normals independently, avoiding conflicts at
+  // shared vertices. The normals are generated per point id, so a point
+  // repeated in the line (e.g. a closed loop) gets the same normal at all
+  // its occurrences; repeated points share a local id to preserve this.
+  void GenerateNormals(vtkIdType npts, const vtkIdType *pts, double *normals)
+  {
+    std::vector<std::pair<vtkIdType, vtkIdType> > &sorted =
+      this->Sorted.Local();
+    std::vector<vtkIdType> &localIds = this->LocalIds.Local();
+    sorted.resize(npts);
+    localIds.resize(npts);
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      sorted[j] = std::make_pair(pts[j], j);
+    }
+    std::sort(sorted.begin(), sorted.end());
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      localIds[sorted[j].second] =
+        (j > 0 && sorted[j].first == sorted[j - 1].first) ?
+        localIds[sorted[j - 1].second] : sorted[j].second;
+    }
+
+    vtkPoints *points = this->LinePoints.Local();
+    points->SetNumberOfPoints(npts);
+    double x[3];
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      this->Lines->InPts->GetPoint(pts[j], x);
+      points->SetPoint(j, x);
+    }
+    vtkCellArray *cells = this->LineCells.Local();
+    cells->Reset();
+    cells->InsertNextCell(npts, &localIds[0]);
+    vtkFloatArray *lineNormals = this->LineNormals.Local();
+    lineNormals->SetNumberOfTuples(npts);
+    vtkPolyLine::GenerateSlidingNormals(points, cells, lineNormals);
+
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      lineNormals->GetTuple(localIds[j], normals + 3 * j);
+    }
+  }
+};
+
+// Second pass: generates the ribbons of the valid lines at their offsets in
+// the output, and records the input point each output point comes from.
+class vtkRibbonFilterGenerateLines
+{
+public:
+  vtkRibbonFilter *Filter;
+  vtkRibbonFilterLines *Lines;
+  vtkDataArray *InScalars;
+  double *Range;
+  vtkPoints *NewPts;
+  vtkFloatArray *NewNormals;
+  vtkFloatArray *NewTCoords;
+  vtkIdType *Strips;
+  vtkIdType *PointSources;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkRibbonFilter *self = this->Filter;
+    for (vtkIdType lineId = begin; lineId < end; ++lineId)
+    {
+      vtkIdType npts = this->Lines->GetNumberOfPoints(lineId);
+      if (npts < 2 ||
+          this->Lines->Status[lineId] != vtkRibbonFilter::VALID_LINE)
+      {
+        continue;
+      }
+      const vtkIdType *pts = this->Lines->GetIds(lineId);
+      vtkIdType offset = this->Lines->PointOffsets[lineId];
+
+      self->GeneratePoints(offset, npts, pts, this->Lines->InPts, this->NewPts,
+                           this->NewNormals, this->InScalars, this->Range,
+                           this->Lines->GetNormals(lineId));
+      self->GenerateStrip(offset, npts,
+                          this->Strips + this->Lines->StripOffsets[lineId]);
+      if (this->NewTCoords)
+      {
+        self->GenerateTextureCoords(offset, npts, pts, this->Lines->InPts,
+                                    this->InScalars, this->NewTCoords);
+      }
+
+      for (vtkIdType j = 0; j < npts; ++j)
+      {
+        this->PointSources[offset + 2*j] = pts[j];
+        this->PointSources[offset + 2*j + 1] = pts[j];
+      }
+    }
+  }
+};
 
 int vtkRibbonFilter::RequestData(
   vtkInformation *vtkNotUsed(request),
@@ -83,18 +272,13 @@ int vtkRibbonFilter::RequestData(
   vtkPoints *inPts;
   vtkIdType numPts;
   vtkIdType numLines;
-  vtkIdType numNewPts, numNewCells;
+  vtkIdType numNewPts, numNewCells, stripsSize;
   vtkPoints *newPts;
-  int deleteNormals=0;
   vtkFloatArray *newNormals;
   vtkIdType i;
   double range[2];
   vtkCellArray *newStrips;
-  vtkIdType npts=0, *pts=nullptr;
-  vtkIdType offset=0;
   vtkFloatArray *newTCoords=nullptr;
-  int abort=0;
-  vtkIdType inCellId;
 
   // Check input and initialize
   //
@@ -108,53 +292,23 @@ int vtkRibbonFilter::RequestData(
     return 1;
   }
 
-  // Create the geometry and topology
-  numNewPts = 2 * numPts;
-  newPts = vtkPoints::New();
-  newPts->Allocate(numNewPts);
-  newNormals = vtkFloatArray::New();
-  newNormals->SetNumberOfComponents(3);
-  newNormals->Allocate(3*numNewPts);
-  newStrips = vtkCellArray::New();
-  newStrips->Allocate(newStrips->EstimateSize(1,numNewPts));
-  vtkCellArray *singlePolyline = vtkCellArray::New();
-
-  // Point data: copy scalars, vectors, tcoords. Normals may be computed here.
-  outPD->CopyNormalsOff();
-  if ( (this->GenerateTCoords == VTK_TCOORDS_FROM_SCALARS && inScalars) ||
-       this->GenerateTCoords == VTK_TCOORDS_FROM_LENGTH ||
-       this->GenerateTCoords == VTK_TCOORDS_FROM_NORMALIZED_LENGTH )
-  {
-    newTCoords = vtkFloatArray::New();
-    newTCoords->SetNumberOfComponents(2);
-    newTCoords->Allocate(numNewPts);
-    outPD->CopyTCoordsOff();
-  }
-  outPD->CopyAllocate(pd,numNewPts);
-
-  int generateNormals = 0;
+  // Normals are only used if present and not overridden; otherwise they are
+  // either the default normal or generated for each line.
+  vtkNew<vtkFloatArray> defaultNormals;
   inNormals = this->GetInputArrayToProcess(1,inputVector);
   if ( !inNormals || this->UseDefaultNormal )
   {
-    deleteNormals = 1;
-    inNormals = vtkFloatArray::New();
-    inNormals->SetNumberOfComponents(3);
-    inNormals->SetNumberOfTuples(numPts);
-
+    inNormals = nullptr;
     if ( this->UseDefaultNormal )
     {
+      inNormals = defaultNormals;
+      defaultNormals->SetNumberOfComponents(3);
+      defaultNormals->SetNumberOfTuples(numPts);
       for ( i=0; i < numPts; i++)
       {
-        inNormals->SetTuple(i,this->DefaultNormal);
+        defaultNormals->SetTuple(i,this->DefaultNormal);
       }
     }
-    else
-    {
-      // Normal generation has been moved to lower in the function.
-      // This allows each different polylines to share vertices, but have
-      // their normals (and hence their ribbons) calculated independently
-      generateNormals = 1;
-    }
   }
 
   // If varying width, get appropriate info.
@@ -168,79 +322,123 @@ int vtkRibbonFilter::RequestData(
       range[1] = range[0] + 1.0;
     }
   }
+  this->Theta = vtkMath::RadiansFromDegrees( this->Angle );
 
-  // Copy selected parts of cell data; certainly don't want normals
+  // Locate the lines in the input cell array, then check them (in parallel)
+  // to find out which ones can be ribboned.
   //
-  numNewCells = inLines->GetNumberOfCells();
-  outCD->CopyNormalsOff();
-  outCD->CopyAllocate(cd,numNewCells);
+  vtkRibbonFilterLines lines;
+  lines.InPts = inPts;
+  lines.Connectivity = inLines->GetPointer();
+  lines.Locations.resize(numLines);
+  for (vtkIdType lineId = 0, loc = 0; lineId < numLines; ++lineId)
+  {
+    lines.Locations[lineId] = loc;
+    loc += lines.Connectivity[loc] + 1;
+  }
+  lines.Normals.resize(3 * inLines->GetNumberOfConnectivityEntries());
+  lines.Status.resize(numLines);
+
+  vtkRibbonFilterPlanLines plan;
+  plan.Filter = this;
+  plan.Lines = &lines;
+  plan.InNormals = inNormals;
+  plan.InScalars = inScalars;
+  plan.Range = range;
+  vtkSMPTools::For(0, numLines, plan);
+  this->UpdateProgress(0.5);
+  if (this->GetAbortExecute())
+  {
+    return 1;
+  }
 
-  //  Create points along each polyline that are connected into NumberOfSides
-  //  triangle strips. Texture coordinates are optionally generated.
+  // Compute the exact size of the output: each valid line is given its range
+  // of points and its strip, in line order.
   //
-  this->Theta = vtkMath::RadiansFromDegrees( this->Angle );
-  vtkPolyLine *lineNormalGenerator = vtkPolyLine::New();
-  for (inCellId=0, inLines->InitTraversal();
-       inLines->GetNextCell(npts,pts) && !abort; inCellId++)
+  lines.PointOffsets.resize(numLines);
+  lines.StripOffsets.resize(numLines);
+  lines.CellIds.reserve(numLines);
+  numNewPts = stripsSize = 0;
+  for (vtkIdType lineId = 0; lineId < numLines; ++lineId)
   {
-    this->UpdateProgress((double)inCellId/numLines);
-    abort = this->GetAbortExecute();
-
+    vtkIdType npts = lines.GetNumberOfPoints(lineId);
     if (npts < 2)
     {
       vtkWarningMacro(<< "Less than two points in line!");
       continue; //skip tubing this polyline
     }
-
-    // If necessary calculate normals, each polyline calculates its
-    // normals independently, avoiding conflicts at shared vertices.
-    if (generateNormals)
+    if (lines.Status[lineId] != VALID_LINE)
     {
-      singlePolyline->Reset(); //avoid instantiation
-      singlePolyline->InsertNextCell(npts,pts);
-      if ( !lineNormalGenerator->GenerateSlidingNormals(inPts,singlePolyline,
-                                                        inNormals) )
+      if (lines.Status[lineId] == COINCIDENT_POINTS)
       {
-        vtkWarningMacro(<< "No normals for line!");
-        continue; //skip tubing this polyline
+        vtkWarningMacro(<<"Coincident points!");
+      }
+      else
+      {
+        vtkWarningMacro(<<"Bad normal!");
       }
-    }
-
-    // Generate the points around the polyline. The strip is not created
-    // if the polyline is bad.
-    //
-    if ( !this->GeneratePoints(offset,npts,pts,inPts,newPts,pd,outPD,
-                               newNormals,inScalars,range,inNormals) )
-    {
       vtkWarningMacro(<< "Could not generate points!");
       continue; //skip ribboning this polyline
     }
+    lines.PointOffsets[lineId] = numNewPts;
+    lines.StripOffsets[lineId] = stripsSize;
+    lines.CellIds.push_back(lineId);
+    numNewPts = this->ComputeOffset(numNewPts,npts);
+    stripsSize += 1 + 2*npts;
+  }
+  numNewCells = static_cast<vtkIdType>(lines.CellIds.size());
 
-    // Generate the strip for this polyline
-    //
-    this->GenerateStrip(offset,npts,pts,inCellId,cd,outCD,newStrips);
-
-    // Generate the texture coordinates for this polyline
-    //
-    if ( newTCoords )
-    {
-      this->GenerateTextureCoords(offset,npts,pts,inPts,inScalars,newTCoords);
-    }
+  // Create the geometry and topology
+  newPts = vtkPoints::New();
+  newPts->SetNumberOfPoints(numNewPts);
+  newNormals = vtkFloatArray::New();
+  newNormals->SetNumberOfComponents(3);
+  newNormals->SetNumberOfTuples(numNewPts);
+  vtkNew<vtkIdTypeArray> strips;
+  strips->SetNumberOfValues(stripsSize);
+  newStrips = vtkCellArray::New();
+  newStrips->SetCells(numNewCells, strips);
 
-    // Compute the new offset for the next polyline
-    offset = this->ComputeOffset(offset,npts);
+  // Point data: copy scalars, vectors, tcoords. Normals may be computed here.
+  outPD->CopyNormalsOff();
+  if ( (this->GenerateTCoords == VTK_TCOORDS_FROM_SCALARS && inScalars) ||
+       this->GenerateTCoords == VTK_TCOORDS_FROM_LENGTH ||
+       this->GenerateTCoords == VTK_TCOORDS_FROM_NORMALIZED_LENGTH )
+  {
+    newTCoords = vtkFloatArray::New();
+    newTCoords->SetNumberOfComponents(2);
+    newTCoords->SetNumberOfTuples(numNewPts);
+    outPD->CopyTCoordsOff();
+  }
+  outPD->CopyAllocate(pd,numNewPts);
 
-  }//for all polylines
+  // Copy selected parts of cell data; certainly don't want normals
+  //
+  outCD->CopyNormalsOff();
+  outCD->CopyAllocate(cd,numNewCells);
 
-  singlePolyline->Delete();
+  //  Create points along each line that are connected into a triangle
+  //  strip. Texture coordinates are optionally generated.
+  //
+  vtkNew<vtkIdList> pointSources;
+  pointSources->SetNumberOfIds(numNewPts);
+  vtkRibbonFilterGenerateLines generate;
+  generate.Filter = this;
+  generate.Lines = &lines;
+  generate.InScalars = inScalars;
+  generate.Range = range;
+  generate.NewPts = newPts;
+  generate.NewNormals = newNormals;
+  generate.NewTCoords = newTCoords;
+  generate.Strips = strips->GetPointer(0);
+  generate.PointSources = pointSources->GetPointer(0);
+  vtkSMPTools::For(0, numLines, generate);
+
+  ArrayList::GatherTuples(pd, outPD, pointSources->GetPointer(0), numNewPts);
+  ArrayList::GatherTuples(cd, outCD, lines.CellIds.data(), numNewCells);
 
   // Update ourselves
   //
-  if ( deleteNormals )
-  {
-    inNormals->Delete();
-  }
-
   if ( newTCoords )
   {
     outPD->SetTCoords(newTCoords);
@@ -255,7 +453,6 @@ int vtkRibbonFilter::RequestData(
 
   outPD->SetNormals(newNormals);
   newNormals->Delete();
-  lineNormalGenerator->Delete();
 
   output->Squeeze();
 
@@ -263,12 +460,11 @@ int vtkRibbonFilter::RequestData(
 }
 
 int vtkRibbonFilter::GeneratePoints(vtkIdType offset,
-                                  vtkIdType npts, vtkIdType *pts,
+                                  vtkIdType npts, const vtkIdType *pts,
                                   vtkPoints *inPts, vtkPoints *newPts,
-                                  vtkPointData *pd, vtkPointData *outPD,
                                   vtkFloatArray *newNormals,
                                   vtkDataArray *inScalars, double range[2],
-                                  vtkDataArray *inNormals)
+                                  const double *normals)
 {
   vtkIdType j;
   int i;
@@ -321,12 +517,13 @@ int vtkRibbonFilter::GeneratePoints(vtkIdType offset,
       }
     }
 
-    inNormals->GetTuple(pts[j], n);
+    n[0] = normals[3*j];
+    n[1] = normals[3*j+1];
+    n[2] = normals[3*j+2];
 
     if ( vtkMath::Normalize(sNext) == 0.0 )
     {
-      vtkWarningMacro(<<"Coincident points!");
-      return 0;
+      return COINCIDENT_POINTS;
     }
 
     for (i=0; i<3; i++)
@@ -336,12 +533,8 @@ int vtkRibbonFilter::GeneratePoints(vtkIdType offset,
     // if s is zero then just use sPrev cross n
     if (vtkMath::Normalize(s) == 0.0)
     {
-      vtkWarningMacro(<< "Using alternate bevel vector");
       vtkMath::Cross(sPrev,n,s);
-      if (vtkMath::Normalize(s) == 0.0)
-      {
-        vtkWarningMacro(<< "Using alternate bevel vector");
-      }
+      vtkMath::Normalize(s);
     }
 /*
     if ( (bevelAngle = vtkMath::Dot(sNext,sPrev)) > 1.0 )
@@ -363,9 +556,7 @@ int vtkRibbonFilter::GeneratePoints(vtkIdType offset,
     vtkMath::Cross(s,n,w);
     if ( vtkMath::Normalize(w) == 0.0)
     {
-      vtkWarningMacro(<<"Bad normal s = " <<s[0]<<" "<<s[1]<<" "<< s[2]
-                      << " n = " << n[0] << " " << n[1] << " " << n[2]);
-      return 0;
+      return BAD_NORMAL;
     }
 
     vtkMath::Cross(w,s,nP); //create orthogonal coordinate system
@@ -379,45 +570,46 @@ int vtkRibbonFilter::GeneratePoints(vtkIdType offset,
                        / (range[1]-range[0]));
     }
 
+    // only checking the line
+    if (!newPts)
+    {
+      continue;
+    }
+
     for (i=0; i<3; i++)
     {
       v[i] = (w[i]*cos(this->Theta) + nP[i]*sin(this->Theta));
       sp[i] = p[i] + this->Width * sFactor * v[i];
       sm[i] = p[i] - this->Width * sFactor * v[i];
     }
-    newPts->InsertPoint(ptId,sm);
-    newNormals->InsertTuple(ptId,nP);
-    outPD->CopyData(pd,pts[j],ptId);
+    newPts->SetPoint(ptId,sm);
+    newNormals->SetTuple(ptId,nP);
     ptId++;
-    newPts->InsertPoint(ptId,sp);
-    newNormals->InsertTuple(ptId,nP);
-    outPD->CopyData(pd,pts[j],ptId);
+    newPts->SetPoint(ptId,sp);
+    newNormals->SetTuple(ptId,nP);
     ptId++;
   }//for all points in polyline
 
-  return 1;
+  return VALID_LINE;
 }
 
 void vtkRibbonFilter::GenerateStrip(vtkIdType offset, vtkIdType npts,
-                                    vtkIdType* vtkNotUsed(pts),
-                                    vtkIdType inCellId,
-                                    vtkCellData *cd, vtkCellData *outCD,
-                                    vtkCellArray *newStrips)
+                                    vtkIdType *strip)
 {
-  vtkIdType i, idx, outCellId;
+  vtkIdType i, idx;
 
-  outCellId = newStrips->InsertNextCell(npts*2);
-  outCD->CopyData(cd,inCellId,outCellId);
+  *strip++ = npts*2;
   for (i=0; i < npts; i++)
   {
     idx = 2*i;
-    newStrips->InsertCellPoint(offset+idx);
-    newStrips->InsertCellPoint(offset+idx+1);
+    *strip++ = offset+idx;
+    *strip++ = offset+idx+1;
   }
 }
 
 void vtkRibbonFilter::GenerateTextureCoords(vtkIdType offset,
-                                            vtkIdType npts, vtkIdType *pts,
+                                            vtkIdType npts,
+                                            const vtkIdType *pts,
                                             vtkPoints *inPts,
                                             vtkDataArray *inScalars,
                                             vtkFloatArray *newTCoords)
@@ -430,7 +622,7 @@ void vtkRibbonFilter::GenerateTextureCoords(vtkIdType offset,
   //The first texture coordinate is always 0.
   for ( k=0; k < 2; k++)
   {
-    newTCoords->InsertTuple2(offset+k,0.0,0.0);
+    newTCoords->SetTuple2(offset+k,0.0,0.0);
   }
   if ( this->GenerateTCoords == VTK_TCOORDS_FROM_SCALARS && inScalars)
   {
@@ -441,7 +633,7 @@ void vtkRibbonFilter::GenerateTextureCoords(vtkIdType offset,
       tc = (s - s0) / this->TextureLength;
       for ( k=0; k < 2; k++)
       {
-        newTCoords->InsertTuple2(offset+i*2+k,tc,0.0);
+        newTCoords->SetTuple2(offset+i*2+k,tc,0.0);
       }
     }
   }
@@ -456,7 +648,7 @@ void vtkRibbonFilter::GenerateTextureCoords(vtkIdType offset,
       tc = len / this->TextureLength;
       for ( k=0; k < 2; k++)
       {
-        newTCoords->InsertTuple2(offset+i*2+k,tc,0.0);
+        newTCoords->SetTuple2(offset+i*2+k,tc,0.0);
       }
       xPrev[0]=x[0]; xPrev[1]=x[1]; xPrev[2]=x[2];
     }
@@ -480,7 +672,7 @@ void vtkRibbonFilter::GenerateTextureCoords(vtkIdType offset,
       tc = len / length;
       for ( k=0; k < 2; k++)
       {
-        newTCoords->InsertTuple2(offset+i*2+k,tc,0.0);
+        newTCoords->SetTuple2(offset+i*2+k,tc,0.0);
       }
       xPrev[0]=x[0]; xPrev[1]=x[1]; xPrev[2]=x[2];
     }
@@ -23,6 +23,10 @@
  * the local line segment. An offset angle can be specified to rotate the
  * ribbon with respect to the normal.
  *
+ * The filter first determines which lines can be ribboned and the exact size
+ * of the output, and then generates the ribbons of all the lines in parallel
+ * (using vtkSMPTools) directly into the preallocated output.
+ *
  * @warning
  * The input line must not have duplicate points, or normals at points that
  * are parallel to the incoming/outgoing line segments. (Duplicate points
@@ -163,17 +167,25 @@ protected:
   int GenerateTCoords; //control texture coordinate generation
   double TextureLength; //this length is mapped to [0,1) texture space
 
-  // Helper methods
-  int GeneratePoints(vtkIdType offset, vtkIdType npts, vtkIdType *pts,
+  // Helper methods. They write the output of one line at the given offsets
+  // of preallocated arrays, so that lines can be processed concurrently. The
+  // normals of the line points are passed in (3*npts values).
+  // GeneratePoints() only checks the line when newPts is nullptr, and
+  // returns VALID_LINE or the reason to reject it.
+  enum
+  {
+    VALID_LINE = 1,
+    COINCIDENT_POINTS = 0,
+    BAD_NORMAL = -1
+  };
+  int GeneratePoints(vtkIdType offset, vtkIdType npts, const vtkIdType *pts,
                      vtkPoints *inPts, vtkPoints *newPts,
-                     vtkPointData *pd, vtkPointData *outPD,
                      vtkFloatArray *newNormals, vtkDataArray *inScalars,
-                     double range[2], vtkDataArray *inNormals);
-  void GenerateStrip(vtkIdType offset, vtkIdType npts, vtkIdType *pts,
-                     vtkIdType inCellId, vtkCellData *cd, vtkCellData *outCD,
-                     vtkCellArray *newStrips);
-  void GenerateTextureCoords(vtkIdType offset, vtkIdType npts, vtkIdType *pts,
-                             vtkPoints *inPts, vtkDataArray *inScalars,
+                     double range[2], const double *normals);
+  void GenerateStrip(vtkIdType offset, vtkIdType npts, vtkIdType *strip);
+  void GenerateTextureCoords(vtkIdType offset, vtkIdType npts,
+                             const vtkIdType *pts, vtkPoints *inPts,
+                             vtkDataArray *inScalars,
                              vtkFloatArray *newTCoords);
   vtkIdType ComputeOffset(vtkIdType offset,vtkIdType npts);
 
@@ -181,6 +193,9 @@ protected:
   double Theta;
 
 private:
+  friend class vtkRibbonFilterPlanLines;
+  friend class vtkRibbonFilterGenerateLines;
+
   vtkRibbonFilter(const vtkRibbonFilter&) = delete;
   void operator=(const vtkRibbonFilter&) = delete;
 };
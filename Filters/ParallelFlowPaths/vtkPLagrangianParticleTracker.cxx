@@ -1134,6 +1134,16 @@ bool vtkPLagrangianParticleTracker::UpdateSurfaceCacheIfNeeded(vtkDataObject*& s
   }
 }
 
+//---------------------------------------------------------------------------
+bool vtkPLagrangianParticleTracker::CanUseThreadedIntegration()
+{
+  if (this->Controller && this->Controller->GetNumberOfProcesses() > 1)
+  {
+    return false;
+  }
+  return this->Superclass::CanUseThreadedIntegration();
+}
+
 //---------------------------------------------------------------------------
 vtkIdType vtkPLagrangianParticleTracker::GetNewParticleId()
 {
@@ -96,6 +96,12 @@ protected:
 
   bool UpdateSurfaceCacheIfNeeded(vtkDataObject*& surfaces) override;
 
+  /**
+   * Threaded integration is only used when running on a single rank,
+   * as particles are streamed between ranks by Integrate.
+   */
+  bool CanUseThreadedIntegration() override;
+
   /**
    * Get an unique id for a particle
    */
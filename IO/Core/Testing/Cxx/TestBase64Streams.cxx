@@ -0,0 +1,109 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestBase64Streams.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkBase64OutputStream and vtkBase64InputStream
+// .SECTION Description
+// Encodes data in writes and reads of various lengths, spanning several
+// of the chunks the streams encode and decode at once, and checks the
+// result against vtkBase64Utilities.
+
+#include "vtkBase64InputStream.h"
+#include "vtkBase64OutputStream.h"
+#include "vtkBase64Utilities.h"
+#include "vtkNew.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+int TestBase64Streams(int, char*[])
+{
+  const size_t lengths[4] = { 1, 2, 3, 20000 };
+  const size_t pieces[4] = { 1, 7, 3072, 5000 };
+  for (int l = 0; l < 4; ++l)
+  {
+    size_t length = lengths[l];
+    std::vector<unsigned char> data(length);
+    for (size_t i = 0; i < length; ++i)
+    {
+      data[i] = static_cast<unsigned char>((i * 7919) >> 3);
+    }
+    std::vector<unsigned char> expected((length + 2) / 3 * 4);
+    expected.resize(
+      vtkBase64Utilities::Encode(data.data(), length, expected.data(), 0));
+
+    for (int p = 0; p < 4; ++p)
+    {
+      // Encode in pieces.
+      std::ostringstream os;
+      vtkNew<vtkBase64OutputStream> output;
+      output->SetStream(&os);
+      output->StartWriting();
+      for (size_t i = 0; i < length; i += pieces[p])
+      {
+        output->Write(&data[i], std::min(pieces[p], length - i));
+      }
+      output->EndWriting();
+      std::string encoded = os.str();
+      if (encoded !=
+          std::string(expected.begin(), expected.end()))
+      {
+        std::cerr << "Encoding " << length << " bytes in pieces of "
+                  << pieces[p] << " failed." << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      // Decode in pieces, then from an offset.
+      std::istringstream is(encoded);
+      vtkNew<vtkBase64InputStream> input;
+      input->SetStream(&is);
+      input->StartReading();
+      std::vector<unsigned char> decoded(length + 10);
+      size_t decodedLength = 0;
+      size_t read;
+      do
+      {
+        read = input->Read(&decoded[decodedLength], pieces[p]);
+        decodedLength += read;
+      } while (read == pieces[p] && decodedLength < length);
+      size_t offset = length / 2;
+      if (decodedLength != length ||
+          memcmp(decoded.data(), data.data(), length) != 0 ||
+          !input->Seek(offset) ||
+          input->Read(decoded.data(), length + 10) != length - offset ||
+          memcmp(decoded.data(), &data[offset], length - offset) != 0)
+      {
+        std::cerr << "Decoding " << length << " bytes in pieces of "
+                  << pieces[p] << " failed." << std::endl;
+        return EXIT_FAILURE;
+      }
+      input->EndReading();
+    }
+  }
+
+  // Decoding stops at the first invalid character.
+  const unsigned char invalid[12] = { 'Q', 'U', 'J', 'D', 'R', 'E', 'V',
+    'G', 'R', '*', 'h', 'J' };
+  unsigned char decoded[9];
+  if (vtkBase64Utilities::DecodeSafely(invalid, 12, decoded, 9) != 6 ||
+      memcmp(decoded, "ABCDEF", 6) != 0)
+  {
+    std::cerr << "Decoding invalid data failed." << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,111 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCompressLZ4HC.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkLZ4HCDataCompressor
+// .SECTION Description
+// Compresses a smooth floating-point field with each combination of the
+// byte filters, including sizes that are not a multiple of the word size,
+// and checks that it uncompresses with a compressor of other settings.
+
+#include "vtkLZ4HCDataCompressor.h"
+#include "vtkNew.h"
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+size_t RoundTrip(vtkLZ4HCDataCompressor* compressor,
+                 const unsigned char* data, size_t size)
+{
+  std::vector<unsigned char> compressed(
+    compressor->GetMaximumCompressionSpace(size));
+  size_t compressedSize =
+    compressor->Compress(data, size, compressed.data(), compressed.size());
+  if (compressedSize == 0)
+  {
+    return 0;
+  }
+
+  // The filters are read from the compressed data, not from the settings.
+  vtkNew<vtkLZ4HCDataCompressor> uncompressor;
+  uncompressor->SetWordSize(3);
+  uncompressor->SetShuffle(!compressor->GetShuffle());
+  uncompressor->SetDelta(!compressor->GetDelta());
+  std::vector<unsigned char> uncompressed(size);
+  if (uncompressor->Uncompress(compressed.data(), compressedSize,
+                               uncompressed.data(), size) != size ||
+      memcmp(uncompressed.data(), data, size) != 0)
+  {
+    return 0;
+  }
+  return compressedSize;
+}
+}
+
+int TestCompressLZ4HC(int, char*[])
+{
+  const size_t numValues = 8192;
+  std::vector<float> field(numValues);
+  for (size_t i = 0; i < numValues; ++i)
+  {
+    field[i] = static_cast<float>(101325.0 + 50.0 * std::sin(0.001 * i));
+  }
+  const unsigned char* data =
+    reinterpret_cast<const unsigned char*>(field.data());
+  const size_t size = numValues * sizeof(float);
+
+  vtkNew<vtkLZ4HCDataCompressor> compressor;
+  compressor->SetWordSize(static_cast<int>(sizeof(float)));
+  size_t sizes[2][2];
+  for (int shuffle = 0; shuffle < 2; ++shuffle)
+  {
+    for (int delta = 0; delta < 2; ++delta)
+    {
+      compressor->SetShuffle(shuffle);
+      compressor->SetDelta(delta);
+      sizes[shuffle][delta] = RoundTrip(compressor, data, size);
+      if (sizes[shuffle][delta] == 0 ||
+          RoundTrip(compressor, data, size - 3) == 0 ||
+          RoundTrip(compressor, data, 3) == 0)
+      {
+        std::cerr << "Round trip failed with Shuffle " << shuffle
+                  << " and Delta " << delta << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  std::cout << "Compressed " << size << " bytes to " << sizes[0][0]
+            << ", " << sizes[1][0] << " shuffled, and " << sizes[1][1]
+            << " shuffled and delta encoded." << std::endl;
+  if (sizes[1][0] >= sizes[0][0])
+  {
+    std::cerr << "Shuffling did not improve compression." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  for (int level = 1; level <= 9; ++level)
+  {
+    compressor->SetCompressionLevel(level);
+    if (compressor->GetCompressionLevel() != level ||
+        RoundTrip(compressor, data, size) == 0)
+    {
+      std::cerr << "Round trip failed at level " << level << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
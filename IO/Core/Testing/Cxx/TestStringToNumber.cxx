@@ -0,0 +1,136 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestStringToNumber.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of vtkStringToNumber
+// .SECTION Description
+// Parses numbers written by vtkNumberToString and by printf, checks where
+// parsing stops, and reads streams larger than the windows they are read
+// in, including numbers that straddle a window boundary.
+
+#include "vtkNumberToString.h"
+#include "vtkStringToNumber.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+template <typename T>
+bool ReadBack(const std::vector<T>& values, const std::string& text)
+{
+  std::istringstream is(text + " end");
+  std::vector<T> read(values.size());
+  if (vtkStringToNumber::Read(is, read.data(), read.size()) != values.size() ||
+      read != values)
+  {
+    return false;
+  }
+  std::string word;
+  return (is >> word) && word == "end";
+}
+}
+
+int TestStringToNumber(int, char*[])
+{
+  // Floating point numbers and symbols, with leading signs and exponents.
+  const std::string symbols =
+    " 1.5\t-2e3\n+0.25 Infinity -Infinity NaN inf -inf nan 7";
+  std::vector<double> doubles(20);
+  const char* last = nullptr;
+  size_t count = vtkStringToNumber::Parse(symbols.c_str(),
+    symbols.c_str() + symbols.size(), doubles.data(), doubles.size(), &last);
+  if (count != 10 || doubles[0] != 1.5 || doubles[1] != -2000.0 ||
+      doubles[2] != 0.25 || !std::isinf(doubles[3]) || doubles[3] < 0 ||
+      !std::isinf(doubles[4]) || doubles[4] > 0 || !std::isnan(doubles[5]) ||
+      !std::isinf(doubles[6]) || doubles[7] > 0 || !std::isnan(doubles[8]) ||
+      doubles[9] != 7.0 || last != symbols.c_str() + symbols.size())
+  {
+    std::cerr << "Parsing floating point symbols failed." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Integers, and a number followed by markup as in XML ascii data.
+  const std::string markup = "12 -34\n56 +7 8</DataArray>\n 9";
+  std::vector<int> ints;
+  std::istringstream markupStream(markup);
+  if (vtkStringToNumber::Read(markupStream, ints) != 5 || ints[0] != 12 ||
+      ints[1] != -34 || ints[2] != 56 || ints[3] != 7 || ints[4] != 8 ||
+      markupStream.tellg() != static_cast<std::streamoff>(markup.find('<')))
+  {
+    std::cerr << "Parsing integers before markup failed." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // A token that is not a number stops parsing.
+  const std::string junk = "1 2 x 3";
+  unsigned char bytes[4];
+  if (vtkStringToNumber::Parse(junk.c_str(), junk.c_str() + junk.size(),
+        bytes, 4) != 2 || bytes[0] != 1 || bytes[1] != 2)
+  {
+    std::cerr << "Parsing stopped at the wrong token." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Round trip of values formatted by vtkNumberToString, in streams much
+  // larger than a window.
+  const size_t numValues = 200000;
+  std::vector<float> floats(numValues);
+  std::vector<double> longDoubles(numValues);
+  std::vector<long long> longs(numValues);
+  std::ostringstream floatText;
+  std::ostringstream doubleText;
+  std::ostringstream longText;
+  char buffer[32];
+  for (size_t i = 0; i < numValues; ++i)
+  {
+    floats[i] = static_cast<float>(std::sin(0.01 * i) * std::pow(10.0, i % 20));
+    longDoubles[i] = std::cos(0.01 * i) / (1.0 + i);
+    longs[i] = (i % 3 ? 1 : -1) * static_cast<long long>(i * i * i);
+    vtkNumberToString::Convert(floats[i], buffer);
+    floatText << buffer << (i % 9 == 8 ? '\n' : ' ');
+    vtkNumberToString::Convert(longDoubles[i], buffer);
+    doubleText << buffer << ' ';
+    longText << longs[i] << "  ";
+  }
+  longs.push_back(std::numeric_limits<long long>::min());
+  longText << longs.back();
+  if (!ReadBack(floats, floatText.str()) ||
+      !ReadBack(longDoubles, doubleText.str()) ||
+      !ReadBack(longs, longText.str()))
+  {
+    std::cerr << "Round trip of large streams failed." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Reading a prefix of a stream leaves the rest to read.
+  std::istringstream prefix(longText.str());
+  std::vector<long long> first(1000);
+  std::vector<long long> rest;
+  if (vtkStringToNumber::Read(prefix, first.data(), first.size()) !=
+        first.size() ||
+      vtkStringToNumber::Read(prefix, rest) != longs.size() - first.size() ||
+      !std::equal(first.begin(), first.end(), longs.begin()) ||
+      !std::equal(rest.begin(), rest.end(), longs.begin() + first.size()))
+  {
+    std::cerr << "Reading a stream in parts failed." << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
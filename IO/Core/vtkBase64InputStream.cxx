@@ -16,6 +16,8 @@
 #include "vtkObjectFactory.h"
 #include "vtkBase64Utilities.h"
 
+#include <algorithm>
+
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkBase64InputStream);
 
@@ -123,14 +125,27 @@ size_t vtkBase64InputStream::Read(void* data_in, size_t length)
     this->BufferLength = 0;
   }
 
-  // Decode all complete triplets.
+  // Decode all complete triplets, reading the stream in chunks rather
+  // than one encoded triplet at a time.
+  unsigned char in[4096];
   while((end - out) >= 3)
   {
-    int len = this->DecodeTriplet(out[0], out[1], out[2]);
+    size_t chunkLength =
+      std::min(static_cast<size_t>(end - out) / 3, sizeof(in) / 4) * 3;
+    this->Stream->read(reinterpret_cast<char*>(in), chunkLength / 3 * 4);
+    size_t len = vtkBase64Utilities::DecodeSafely(
+      in, static_cast<size_t>(this->Stream->gcount()), out, chunkLength);
+    if(this->Stream->eof())
+    {
+      // A chunk may extend past padding at the end of the stream.  Keep
+      // the stream usable for a later Seek.
+      this->Stream->clear();
+    }
     out += len;
-    if(len < 3)
+    if(len < chunkLength)
     {
-      this->BufferLength = len-3;
+      // The last triplet decoded was short or invalid.
+      this->BufferLength = static_cast<int>(len % 3) - 3;
       return (out-data);
     }
   }
@@ -16,6 +16,8 @@
 #include "vtkObjectFactory.h"
 #include "vtkBase64Utilities.h"
 
+#include <algorithm>
+
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkBase64OutputStream);
 
@@ -118,10 +120,20 @@ int vtkBase64OutputStream::Write(void const* data, size_t length)
     }
   }
 
+  // Encode the complete triplets in chunks, with one stream write per
+  // chunk rather than per triplet.
+  unsigned char out[4096];
   while((end - in) >= 3)
   {
-    if(!this->EncodeTriplet(in[0], in[1], in[2])) { return 0; }
-    in += 3;
+    size_t chunkLength =
+      std::min(static_cast<size_t>(end - in) / 3, sizeof(out) / 4) * 3;
+    unsigned long outLength =
+      vtkBase64Utilities::Encode(in, chunkLength, out, 0);
+    if(!this->Stream->write(reinterpret_cast<char*>(out), outLength))
+    {
+      return 0;
+    }
+    in += chunkLength;
   }
 
   while(in != end)
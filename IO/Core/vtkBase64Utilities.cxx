@@ -85,12 +85,18 @@ unsigned long vtkBase64Utilities::Encode(const unsigned char *input,
   const unsigned char *end = input + length;
   unsigned char *optr = output;
 
-  // Encode complete triplet
+  // Encode complete triplet, packing each one into a 24-bit word so that
+  // the four output characters are four independent table lookups.
 
   while ((end - ptr) >= 3)
   {
-    vtkBase64Utilities::EncodeTriplet(ptr[0], ptr[1], ptr[2],
-                                      &optr[0], &optr[1], &optr[2], &optr[3]);
+    unsigned int bits = (static_cast<unsigned int>(ptr[0]) << 16) |
+                        (static_cast<unsigned int>(ptr[1]) << 8) |
+                        static_cast<unsigned int>(ptr[2]);
+    optr[0] = vtkBase64UtilitiesEncodeTable[(bits >> 18) & 0x3F];
+    optr[1] = vtkBase64UtilitiesEncodeTable[(bits >> 12) & 0x3F];
+    optr[2] = vtkBase64UtilitiesEncodeTable[(bits >> 6) & 0x3F];
+    optr[3] = vtkBase64UtilitiesEncodeTable[bits & 0x3F];
     ptr += 3;
     optr += 4;
   }
@@ -225,8 +231,30 @@ size_t vtkBase64Utilities::DecodeSafely(const unsigned char *input,
     return 0;
   }
 
-  // Consume 4 ASCII chars of input at a time, until less than 4 left
+  // Decode the leading groups of 4 valid ASCII chars without padding and
+  // with room for their 3 bytes.  Invalid characters decode to 0xFF, so
+  // one test of the combined high bits rejects any of them.
   size_t inIdx = 0, outIdx = 0;
+  while ((inIdx <= inputLen-4) && (outIdx + 3 <= outputLen) &&
+         (input[inIdx+2] != '=') && (input[inIdx+3] != '='))
+  {
+    unsigned int d0 = vtkBase64UtilitiesDecodeTable[input[inIdx+0]];
+    unsigned int d1 = vtkBase64UtilitiesDecodeTable[input[inIdx+1]];
+    unsigned int d2 = vtkBase64UtilitiesDecodeTable[input[inIdx+2]];
+    unsigned int d3 = vtkBase64UtilitiesDecodeTable[input[inIdx+3]];
+    if ((d0 | d1 | d2 | d3) & 0x80)
+    {
+      break;
+    }
+    unsigned int bits = (d0 << 18) | (d1 << 12) | (d2 << 6) | d3;
+    output[outIdx+0] = static_cast<unsigned char>(bits >> 16);
+    output[outIdx+1] = static_cast<unsigned char>(bits >> 8);
+    output[outIdx+2] = static_cast<unsigned char>(bits);
+    inIdx += 4;
+    outIdx += 3;
+  }
+
+  // Consume 4 ASCII chars of input at a time, until less than 4 left
   while (inIdx <= inputLen-4)
   {
     // Decode 4 ASCII characters into 0, 1, 2, or 3 bytes
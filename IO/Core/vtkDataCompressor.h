@@ -105,6 +105,13 @@ public:
   virtual void SetCompressionLevel(int compressionLevel) = 0;
   virtual int GetCompressionLevel() = 0;
 
+  /**
+   * Set the size in bytes of the words of the data compressed next.
+   * vtkXMLWriter calls it before compressing each array.  Compressors
+   * that filter the data word by word use it; by default it is ignored.
+   */
+  virtual void SetWordSize(int vtkNotUsed(wordSize)) {}
+
 protected:
   vtkDataCompressor();
   ~vtkDataCompressor() override;
@@ -0,0 +1,271 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkLZ4HCDataCompressor.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkLZ4HCDataCompressor.h"
+#include "vtkObjectFactory.h"
+#include "vtk_lz4.h"
+
+#include <vector>
+
+vtkStandardNewMacro(vtkLZ4HCDataCompressor);
+
+namespace
+{
+// Each compressed buffer starts with the size of the shuffled words (1
+// when the bytes are not shuffled) and with a byte of filter flags.
+const size_t HeaderSize = 2;
+const unsigned char DeltaFlag = 0x01;
+
+// Regroups the bytes of the words by significance.  The bytes past the
+// last complete word are copied as they are.
+void ShuffleBytes(const unsigned char* in, size_t size, size_t wordSize,
+                  unsigned char* out)
+{
+  size_t numWords = size / wordSize;
+  for (size_t b = 0; b < wordSize; ++b)
+  {
+    const unsigned char* src = in + b;
+    unsigned char* dst = out + b * numWords;
+    for (size_t i = 0; i < numWords; ++i, src += wordSize)
+    {
+      dst[i] = *src;
+    }
+  }
+  for (size_t i = numWords * wordSize; i < size; ++i)
+  {
+    out[i] = in[i];
+  }
+}
+
+void UnshuffleBytes(const unsigned char* in, size_t size, size_t wordSize,
+                    unsigned char* out)
+{
+  size_t numWords = size / wordSize;
+  for (size_t b = 0; b < wordSize; ++b)
+  {
+    const unsigned char* src = in + b * numWords;
+    unsigned char* dst = out + b;
+    for (size_t i = 0; i < numWords; ++i, dst += wordSize)
+    {
+      *dst = src[i];
+    }
+  }
+  for (size_t i = numWords * wordSize; i < size; ++i)
+  {
+    out[i] = in[i];
+  }
+}
+
+// Replaces each byte of the shuffled planes by its difference with the
+// previous byte of the same plane.
+void DeltaEncode(unsigned char* data, size_t size, size_t wordSize)
+{
+  size_t numWords = size / wordSize;
+  for (size_t b = 0; b < wordSize; ++b)
+  {
+    unsigned char* plane = data + b * numWords;
+    for (size_t i = numWords; i > 1; --i)
+    {
+      plane[i - 1] = static_cast<unsigned char>(plane[i - 1] - plane[i - 2]);
+    }
+  }
+}
+
+void DeltaDecode(unsigned char* data, size_t size, size_t wordSize)
+{
+  size_t numWords = size / wordSize;
+  for (size_t b = 0; b < wordSize; ++b)
+  {
+    unsigned char* plane = data + b * numWords;
+    for (size_t i = 1; i < numWords; ++i)
+    {
+      plane[i] = static_cast<unsigned char>(plane[i] + plane[i - 1]);
+    }
+  }
+}
+}
+
+//----------------------------------------------------------------------------
+vtkLZ4HCDataCompressor::vtkLZ4HCDataCompressor()
+{
+  this->HighCompressionLevel = 7;
+  this->WordSize = 1;
+  this->Shuffle = 1;
+  this->Delta = 0;
+}
+
+//----------------------------------------------------------------------------
+vtkLZ4HCDataCompressor::~vtkLZ4HCDataCompressor() = default;
+
+//----------------------------------------------------------------------------
+void vtkLZ4HCDataCompressor::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "HighCompressionLevel: " << this->HighCompressionLevel
+     << endl;
+  os << indent << "WordSize: " << this->WordSize << endl;
+  os << indent << "Shuffle: " << this->Shuffle << endl;
+  os << indent << "Delta: " << this->Delta << endl;
+}
+
+//----------------------------------------------------------------------------
+size_t
+vtkLZ4HCDataCompressor::CompressBuffer(unsigned char const* uncompressedData,
+                                       size_t uncompressedSize,
+                                       unsigned char* compressedData,
+                                       size_t compressionSpace)
+{
+  if (compressionSpace < HeaderSize)
+  {
+    vtkErrorMacro("LZ4 HC compression space is too small.");
+    return 0;
+  }
+
+  // The filters only read the settings, and filter into a buffer local
+  // to this call, so that blocks can be compressed concurrently.
+  size_t wordSize = 1;
+  if (this->Shuffle)
+  {
+    wordSize = static_cast<size_t>(this->WordSize);
+  }
+  const unsigned char* source = uncompressedData;
+  std::vector<unsigned char> filtered;
+  if (wordSize > 1 || this->Delta)
+  {
+    filtered.resize(uncompressedSize);
+    ShuffleBytes(
+      uncompressedData, uncompressedSize, wordSize, filtered.data());
+    if (this->Delta)
+    {
+      DeltaEncode(filtered.data(), uncompressedSize, wordSize);
+    }
+    source = filtered.data();
+  }
+  compressedData[0] = static_cast<unsigned char>(wordSize);
+  compressedData[1] = this->Delta ? DeltaFlag : 0;
+
+  // Call LZ4's high compression function.
+  int cs =
+    LZ4_compress_HC(reinterpret_cast<const char*>(source),
+      reinterpret_cast<char*>(compressedData + HeaderSize),
+      static_cast<int>(uncompressedSize),
+      static_cast<int>(compressionSpace - HeaderSize),
+      this->HighCompressionLevel);
+  if (cs == 0)
+  {
+    vtkErrorMacro("LZ4 HC error while compressing data.");
+    return 0;
+  }
+  return static_cast<size_t>(cs) + HeaderSize;
+}
+
+//----------------------------------------------------------------------------
+size_t
+vtkLZ4HCDataCompressor::UncompressBuffer(unsigned char const* compressedData,
+                                         size_t compressedSize,
+                                         unsigned char* uncompressedData,
+                                         size_t uncompressedSize)
+{
+  if (compressedSize < HeaderSize || compressedData[0] == 0 ||
+      (compressedData[1] & ~DeltaFlag) != 0)
+  {
+    vtkErrorMacro("Invalid LZ4 HC compressed data header.");
+    return 0;
+  }
+  size_t wordSize = compressedData[0];
+  bool delta = (compressedData[1] & DeltaFlag) != 0;
+
+  // Shuffled data is uncompressed into a buffer local to this call.
+  unsigned char* target = uncompressedData;
+  std::vector<unsigned char> filtered;
+  if (wordSize > 1)
+  {
+    filtered.resize(uncompressedSize);
+    target = filtered.data();
+  }
+  int us =
+    LZ4_decompress_safe(
+      reinterpret_cast<const char*>(compressedData + HeaderSize),
+      reinterpret_cast<char*>(target),
+      static_cast<int>(compressedSize - HeaderSize),
+      static_cast<int>(uncompressedSize));
+  if (us < 0)
+  {
+    vtkErrorMacro("LZ4 HC error while uncompressing data.");
+    return 0;
+  }
+  // Make sure the output size matched that expected.
+  if(us != static_cast<int>(uncompressedSize))
+  {
+    vtkErrorMacro("Decompression produced incorrect size.\n"
+                  "Expected " << uncompressedSize << " and got " << us);
+    return 0;
+  }
+  if (delta)
+  {
+    DeltaDecode(target, uncompressedSize, wordSize);
+  }
+  if (wordSize > 1)
+  {
+    UnshuffleBytes(target, uncompressedSize, wordSize, uncompressedData);
+  }
+  return uncompressedSize;
+}
+
+//----------------------------------------------------------------------------
+int vtkLZ4HCDataCompressor::GetCompressionLevel()
+{
+  int compressionLevel = this->HighCompressionLevel - 2;
+  compressionLevel = (compressionLevel < 1 ? 1 :
+    (compressionLevel > 9 ? 9 : compressionLevel));
+  vtkDebugMacro(<< this->GetClassName() << " (" << this << "): returning CompressionLevel " << compressionLevel);
+  return compressionLevel;
+}
+
+//----------------------------------------------------------------------------
+void vtkLZ4HCDataCompressor::SetCompressionLevel(int compressionLevel)
+{
+  int min=1;
+  int max=9;
+  vtkDebugMacro(<< this->GetClassName() << " (" << this << "): setting CompressionLevel to " << compressionLevel );
+  // Accept the compressionLevel values 1..9 of vtkDataCompressor and map
+  // them to the LZ4 high compression levels 3..11.  Level 12, the
+  // slowest, is only available through SetHighCompressionLevel.
+  int level =
+    (compressionLevel<min?min:(compressionLevel>max?max:compressionLevel)) + 2;
+  if (this->HighCompressionLevel != level)
+  {
+    this->HighCompressionLevel = level;
+    this->Modified();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkLZ4HCDataCompressor::SetWordSize(int wordSize)
+{
+  wordSize = (wordSize < 1 ? 1 : (wordSize > 255 ? 255 : wordSize));
+  if (this->WordSize != wordSize)
+  {
+    this->WordSize = wordSize;
+    this->Modified();
+  }
+}
+
+//----------------------------------------------------------------------------
+size_t
+vtkLZ4HCDataCompressor::GetMaximumCompressionSpace(size_t size)
+{
+  return LZ4_COMPRESSBOUND(size) + HeaderSize;
+}
@@ -0,0 +1,131 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkLZ4HCDataCompressor.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkLZ4HCDataCompressor
+ * @brief   Data compression using high compression LZ4 and byte filters.
+ *
+ * vtkLZ4HCDataCompressor provides a concrete vtkDataCompressor class
+ * using the high compression mode of LZ4 for compressing data, and the
+ * regular LZ4 decoder for uncompressing it.  It compresses better than
+ * vtkLZ4DataCompressor, at the cost of slower compression, and
+ * decompresses as fast.  Lacking an entropy coding stage, it compresses
+ * floating-point data much less than vtkZLibDataCompressor.
+ *
+ * Before compression, the data may be byte shuffled: the bytes of each
+ * word of WordSize bytes are regrouped by significance, so that the
+ * slowly varying exponent and high order bytes of floating-point and
+ * integer values form long runs that compress much better.  The shuffled
+ * bytes may additionally be delta encoded, which helps smooth fields and
+ * monotonic ids.  Each compressed buffer records the filters it was
+ * compressed with, so uncompressing does not depend on the settings.
+ *
+ * vtkXMLWriter sets WordSize to the size of the words of each array it
+ * writes, through vtkDataCompressor::SetWordSize.
+*/
+
+#ifndef vtkLZ4HCDataCompressor_h
+#define vtkLZ4HCDataCompressor_h
+
+#include "vtkIOCoreModule.h" // For export macro
+#include "vtkDataCompressor.h"
+
+class VTKIOCORE_EXPORT vtkLZ4HCDataCompressor : public vtkDataCompressor
+{
+public:
+  vtkTypeMacro(vtkLZ4HCDataCompressor,vtkDataCompressor);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+  static vtkLZ4HCDataCompressor* New();
+
+  /**
+   *  Get the maximum space that may be needed to store data of the
+   *  given uncompressed size after compression.  This is the minimum
+   *  size of the output buffer that can be passed to the four-argument
+   *  Compress method.
+   */
+  size_t GetMaximumCompressionSpace(size_t size) override;
+
+  /**
+   *  Get/Set the compression level.  Levels 1 to 9 map to the LZ4 high
+   *  compression levels 3 to 11.
+   */
+  // Compression level getter required by vtkDataCompressor.
+  int GetCompressionLevel() override;
+
+  // Compression level setter required by vtkDataCompresor.
+  void SetCompressionLevel(int compressionLevel) override;
+
+  //@{
+  /**
+   * Direct setting of the LZ4 high compression level, from 1 to 12.
+   * Default is 7.
+   */
+  vtkSetClampMacro(HighCompressionLevel, int, 1, 12);
+  vtkGetMacro(HighCompressionLevel, int);
+  //@}
+
+  //@{
+  /**
+   * Get/Set the size in bytes of the words that are shuffled before
+   * compression, from 1 to 255.  Default is 1, which disables shuffling.
+   */
+  void SetWordSize(int wordSize) override;
+  vtkGetMacro(WordSize, int);
+  //@}
+
+  //@{
+  /**
+   * Enable/Disable byte shuffling of words larger than one byte.
+   * Default is on.
+   */
+  vtkSetMacro(Shuffle, vtkTypeBool);
+  vtkGetMacro(Shuffle, vtkTypeBool);
+  vtkBooleanMacro(Shuffle, vtkTypeBool);
+  //@}
+
+  //@{
+  /**
+   * Enable/Disable delta encoding of the (shuffled) bytes.  Default is
+   * off.
+   */
+  vtkSetMacro(Delta, vtkTypeBool);
+  vtkGetMacro(Delta, vtkTypeBool);
+  vtkBooleanMacro(Delta, vtkTypeBool);
+  //@}
+
+protected:
+  vtkLZ4HCDataCompressor();
+  ~vtkLZ4HCDataCompressor() override;
+
+  int HighCompressionLevel;
+  int WordSize;
+  vtkTypeBool Shuffle;
+  vtkTypeBool Delta;
+
+  // Compression method required by vtkDataCompressor.
+  size_t CompressBuffer(unsigned char const* uncompressedData,
+                        size_t uncompressedSize,
+                        unsigned char* compressedData,
+                        size_t compressionSpace) override;
+  // Decompression method required by vtkDataCompressor.
+  size_t UncompressBuffer(unsigned char const* compressedData,
+                          size_t compressedSize,
+                          unsigned char* uncompressedData,
+                          size_t uncompressedSize) override;
+private:
+  vtkLZ4HCDataCompressor(const vtkLZ4HCDataCompressor&) = delete;
+  void operator=(const vtkLZ4HCDataCompressor&) = delete;
+};
+
+#endif
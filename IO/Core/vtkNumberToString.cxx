@@ -46,3 +46,21 @@ ostream& operator<<(ostream& stream, const vtkNumberToString::TagFloat& tag)
 {
   return ToString(stream, tag);
 }
+
+//----------------------------------------------------------------------------
+int vtkNumberToString::Convert(double val, char* buffer)
+{
+  double_conversion::StringBuilder builder(buffer, 32);
+  double_conversion::DoubleToStringConverter::EcmaScriptConverter().ToShortest(
+    val, &builder);
+  return builder.position();
+}
+
+//----------------------------------------------------------------------------
+int vtkNumberToString::Convert(float val, char* buffer)
+{
+  double_conversion::StringBuilder builder(buffer, 32);
+  double_conversion::DoubleToStringConverter::EcmaScriptConverter()
+    .ToShortestSingle(val, &builder);
+  return builder.position();
+}
@@ -60,6 +60,17 @@ public:
   }
   const TagDouble operator()(const double& val) const { return TagDouble(val); }
   const TagFloat operator()(const float& val) const { return TagFloat(val); }
+
+  //@{
+  /**
+   * Write the shortest text that reads back to the given value into
+   * buffer, which must hold at least 32 characters, and return its
+   * length without the terminating null.  Floats are written with the
+   * shortest text that reads back to the same float.
+   */
+  static int Convert(double val, char* buffer);
+  static int Convert(float val, char* buffer);
+  //@}
 };
 
 VTKIOCORE_EXPORT ostream& operator<<(ostream& stream, const vtkNumberToString::TagDouble& tag);
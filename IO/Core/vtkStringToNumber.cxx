@@ -0,0 +1,402 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkStringToNumber.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkStringToNumber.h"
+
+#include "vtkSMPTools.h"
+#include "vtk_doubleconversion.h"
+#include VTK_DOUBLECONVERSION_HEADER(double-conversion.h)
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+namespace
+{
+// Bytes of text counted and parsed by each task.
+const size_t ChunkSize = 1 << 16;
+
+// Bytes of text read from a stream at once, at first and at most.
+const size_t MinimumWindowSize = 1 << 16;
+const size_t MaximumWindowSize = 1 << 24;
+
+inline bool IsSpace(char c)
+{
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' ||
+    c == '\f';
+}
+
+// Symbols written by vtkNumberToString, then by printf.
+const double_conversion::StringToDoubleConverter EcmaScriptConverter(
+  double_conversion::StringToDoubleConverter::ALLOW_TRAILING_JUNK, 0.0,
+  std::numeric_limits<double>::quiet_NaN(), "Infinity", "NaN");
+const double_conversion::StringToDoubleConverter PrintfConverter(
+  double_conversion::StringToDoubleConverter::ALLOW_TRAILING_JUNK, 0.0,
+  std::numeric_limits<double>::quiet_NaN(), "inf", "nan");
+
+//----------------------------------------------------------------------------
+// Parse the number at the start of a token.  Return the number of
+// characters parsed, zero if the token does not start with a number.
+inline size_t ParseNumber(const char* begin, const char* end, double& value)
+{
+  int length = static_cast<int>(end - begin);
+  int parsed = 0;
+  value = EcmaScriptConverter.StringToDouble(begin, length, &parsed);
+  if (parsed == 0)
+  {
+    value = PrintfConverter.StringToDouble(begin, length, &parsed);
+  }
+  return static_cast<size_t>(parsed);
+}
+
+inline size_t ParseNumber(const char* begin, const char* end, float& value)
+{
+  // Not the same as casting a double, which may round twice.
+  int length = static_cast<int>(end - begin);
+  int parsed = 0;
+  value = EcmaScriptConverter.StringToFloat(begin, length, &parsed);
+  if (parsed == 0)
+  {
+    value = PrintfConverter.StringToFloat(begin, length, &parsed);
+  }
+  return static_cast<size_t>(parsed);
+}
+
+template <typename T>
+inline size_t ParseNumber(const char* begin, const char* end, T& value)
+{
+  static_assert(std::is_integral<T>::value, "Unsupported type.");
+  const char* p = begin;
+  bool negative = false;
+  if (p != end && (*p == '-' || *p == '+'))
+  {
+    negative = (*p == '-');
+    ++p;
+  }
+  const char* digits = p;
+  unsigned long long magnitude = 0;
+  for (; p != end && *p >= '0' && *p <= '9'; ++p)
+  {
+    magnitude = 10 * magnitude + static_cast<unsigned long long>(*p - '0');
+  }
+  if (p == digits)
+  {
+    return 0;
+  }
+  // Out of range values wrap around, as with the casts used by readers.
+  value = static_cast<T>(negative ? 0 - magnitude : magnitude);
+  return static_cast<size_t>(p - begin);
+}
+
+//----------------------------------------------------------------------------
+size_t CountTokens(const char* p, const char* end)
+{
+  size_t count = 0;
+  bool inToken = false;
+  for (; p != end; ++p)
+  {
+    bool space = IsSpace(*p);
+    count += (!space && !inToken) ? 1 : 0;
+    inToken = !space;
+  }
+  return count;
+}
+
+// Parse up to maxValues tokens.  Set stopped if a token does not parse
+// entirely, and last to the end of the last number parsed.
+template <typename T>
+size_t ParseTokens(const char* p, const char* end, T* values,
+  size_t maxValues, const char*& last, bool& stopped)
+{
+  size_t count = 0;
+  last = p;
+  stopped = false;
+  while (count < maxValues)
+  {
+    while (p != end && IsSpace(*p))
+    {
+      ++p;
+    }
+    if (p == end)
+    {
+      break;
+    }
+    const char* tokenEnd = p;
+    while (tokenEnd != end && !IsSpace(*tokenEnd))
+    {
+      ++tokenEnd;
+    }
+    size_t parsed = ParseNumber(p, tokenEnd, values[count]);
+    if (parsed == 0)
+    {
+      stopped = true;
+      break;
+    }
+    ++count;
+    p += parsed;
+    last = p;
+    if (p != tokenEnd)
+    {
+      stopped = true;
+      break;
+    }
+  }
+  return count;
+}
+
+//----------------------------------------------------------------------------
+// Text split at whitespace into chunks, with the numbers of each chunk.
+struct Chunks
+{
+  std::vector<const char*> Bounds;
+  std::vector<size_t> Offsets;
+  std::vector<size_t> Counts;
+  std::vector<const char*> Lasts;
+  std::vector<unsigned char> Stopped;
+
+  Chunks(const char* begin, const char* end)
+  {
+    this->Bounds.push_back(begin);
+    const char* p = begin;
+    while (static_cast<size_t>(end - p) > ChunkSize)
+    {
+      p += ChunkSize;
+      while (p != end && !IsSpace(*p))
+      {
+        ++p;
+      }
+      if (p == end)
+      {
+        break;
+      }
+      this->Bounds.push_back(p);
+    }
+    this->Bounds.push_back(end);
+    size_t numChunks = this->Bounds.size() - 1;
+    this->Offsets.resize(numChunks + 1);
+    this->Counts.resize(numChunks);
+    this->Lasts.resize(numChunks);
+    this->Stopped.resize(numChunks);
+  }
+
+  vtkIdType GetNumberOfChunks() const
+  {
+    return static_cast<vtkIdType>(this->Counts.size());
+  }
+};
+
+struct CountChunks
+{
+  Chunks& Text;
+
+  CountChunks(Chunks& text) : Text(text) {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      this->Text.Counts[i] =
+        CountTokens(this->Text.Bounds[i], this->Text.Bounds[i + 1]);
+    }
+  }
+};
+
+template <typename T>
+struct ParseChunks
+{
+  Chunks& Text;
+  T* Values;
+
+  ParseChunks(Chunks& text, T* values) : Text(text), Values(values) {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      bool stopped;
+      this->Text.Counts[i] = ParseTokens(this->Text.Bounds[i],
+        this->Text.Bounds[i + 1], this->Values + this->Text.Offsets[i],
+        this->Text.Counts[i], this->Text.Lasts[i], stopped);
+      this->Text.Stopped[i] = stopped;
+    }
+  }
+};
+
+// Count the numbers of the chunks, and return how many of them, up to
+// maxValues, are to be parsed.
+size_t CountValues(Chunks& text, size_t maxValues)
+{
+  CountChunks counter(text);
+  vtkSMPTools::For(0, text.GetNumberOfChunks(), counter);
+  text.Offsets[0] = 0;
+  for (vtkIdType i = 0; i < text.GetNumberOfChunks(); ++i)
+  {
+    text.Counts[i] = std::min(text.Counts[i], maxValues - text.Offsets[i]);
+    text.Offsets[i + 1] = text.Offsets[i] + text.Counts[i];
+  }
+  return text.Offsets.back();
+}
+
+// Parse the numbers counted into values.  Return the number of values up
+// to the first token that does not parse, and set last to the end of the
+// last number parsed.
+template <typename T>
+size_t ParseValues(Chunks& text, T* values, const char*& last)
+{
+  ParseChunks<T> parser(text, values);
+  vtkSMPTools::For(0, text.GetNumberOfChunks(), parser);
+  size_t count = 0;
+  last = text.Bounds[0];
+  for (vtkIdType i = 0; i < text.GetNumberOfChunks(); ++i)
+  {
+    count += text.Counts[i];
+    if (text.Counts[i] > 0)
+    {
+      last = text.Lasts[i];
+    }
+    if (text.Stopped[i])
+    {
+      break;
+    }
+  }
+  return count;
+}
+
+//----------------------------------------------------------------------------
+// Read windows of text and parse them until maxValues values are read or
+// a token does not parse.  getValues(offset, count) returns where to
+// store count values after the first offset ones.
+template <typename T, typename GetValuesType>
+size_t ReadWindows(std::istream& is, size_t maxValues, GetValuesType getValues)
+{
+  size_t total = 0;
+  size_t windowSize = MinimumWindowSize;
+  std::vector<char> window;
+  while (total < maxValues && is)
+  {
+    window.resize(windowSize);
+    is.read(window.data(), static_cast<std::streamsize>(windowSize));
+    size_t length = static_cast<size_t>(is.gcount());
+    bool atEnd = (length < windowSize);
+    if (atEnd)
+    {
+      // Clear the end of file state to seek back below.
+      is.clear();
+    }
+    if (length == 0)
+    {
+      break;
+    }
+
+    // Leave out a number that may continue past the window, unless the
+    // window does not hold a whole number yet.
+    const char* begin = window.data();
+    size_t usable = length;
+    if (!atEnd)
+    {
+      while (usable > 0 && !IsSpace(begin[usable - 1]))
+      {
+        --usable;
+      }
+      if (usable == 0 && windowSize < MaximumWindowSize)
+      {
+        is.seekg(-static_cast<std::streamoff>(length), std::ios::cur);
+        windowSize *= 2;
+        continue;
+      }
+      usable = (usable == 0 ? length : usable);
+    }
+
+    Chunks text(begin, begin + usable);
+    size_t count = CountValues(text, maxValues - total);
+    const char* last = begin;
+    size_t parsed =
+      count ? ParseValues(text, getValues(total, count), last) : 0;
+    total += parsed;
+
+    // Leave the stream after the last number, or at the text left out.
+    bool done = (parsed < count || total == maxValues || atEnd);
+    size_t consumed = done ? static_cast<size_t>(last - begin) : usable;
+    if (consumed < length)
+    {
+      is.seekg(-static_cast<std::streamoff>(length - consumed), std::ios::cur);
+    }
+    if (done)
+    {
+      break;
+    }
+    windowSize = std::min(2 * windowSize, MaximumWindowSize);
+  }
+  return total;
+}
+}
+
+//----------------------------------------------------------------------------
+template <typename T>
+size_t vtkStringToNumber::Parse(const char* begin, const char* end,
+  T* values, size_t numValues, const char** last)
+{
+  Chunks text(begin, end);
+  const char* lastParsed = begin;
+  size_t count = CountValues(text, numValues);
+  size_t parsed = count ? ParseValues(text, values, lastParsed) : 0;
+  if (last)
+  {
+    *last = lastParsed;
+  }
+  return parsed;
+}
+
+//----------------------------------------------------------------------------
+template <typename T>
+size_t vtkStringToNumber::Read(std::istream& is, T* values, size_t numValues)
+{
+  return ReadWindows<T>(is, numValues,
+    [values](size_t offset, size_t) { return values + offset; });
+}
+
+//----------------------------------------------------------------------------
+template <typename T>
+size_t vtkStringToNumber::Read(std::istream& is, std::vector<T>& values)
+{
+  size_t size = values.size();
+  size_t total = ReadWindows<T>(is, std::numeric_limits<size_t>::max(),
+    [&values, size](size_t offset, size_t count) {
+      values.resize(size + offset + count);
+      return values.data() + size + offset;
+    });
+  values.resize(size + total);
+  return total;
+}
+
+//----------------------------------------------------------------------------
+#define vtkStringToNumberInstantiateMacro(T)                                 \
+  template size_t vtkStringToNumber::Parse<T>(                               \
+    const char*, const char*, T*, size_t, const char**);                     \
+  template size_t vtkStringToNumber::Read<T>(std::istream&, T*, size_t);     \
+  template size_t vtkStringToNumber::Read<T>(std::istream&, std::vector<T>&)
+
+vtkStringToNumberInstantiateMacro(char);
+vtkStringToNumberInstantiateMacro(signed char);
+vtkStringToNumberInstantiateMacro(unsigned char);
+vtkStringToNumberInstantiateMacro(short);
+vtkStringToNumberInstantiateMacro(unsigned short);
+vtkStringToNumberInstantiateMacro(int);
+vtkStringToNumberInstantiateMacro(unsigned int);
+vtkStringToNumberInstantiateMacro(long);
+vtkStringToNumberInstantiateMacro(unsigned long);
+vtkStringToNumberInstantiateMacro(long long);
+vtkStringToNumberInstantiateMacro(unsigned long long);
+vtkStringToNumberInstantiateMacro(float);
+vtkStringToNumberInstantiateMacro(double);
@@ -0,0 +1,90 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkStringToNumber.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class vtkStringToNumber
+ * @brief Parse whitespace separated numbers from ASCII text in parallel
+ *
+ * vtkStringToNumber is the reading counterpart of vtkNumberToString.  It
+ * parses floating point numbers with the double-conversion library and
+ * integers with a plain decimal parser, so that the result does not
+ * depend on the locale.  Floating point numbers may also be the
+ * "Infinity" and "NaN" symbols written by vtkNumberToString, or the "inf"
+ * and "nan" symbols written by printf.
+ *
+ * The text is split at whitespace into chunks whose numbers are counted,
+ * then parsed, concurrently with vtkSMPTools.  Streams are read in windows
+ * of growing size, so that memory use is bounded by the largest window
+ * and little is read past the last number.
+ *
+ * As with istream::operator>>, parsing stops at the first token that does
+ * not start with a number.  A number followed by other characters, as in
+ * "3</DataArray>", is parsed and then stops the parsing.
+ *
+ * The methods are instantiated for the fundamental arithmetic types.
+ * Characters are parsed as numbers, not as characters.
+ *
+ * Typical use:
+ *
+ * @code{cpp}
+ *  #include "vtkStringToNumber.h"
+ *  std::vector<float> values(numValues);
+ *  if (vtkStringToNumber::Read(is, values.data(), numValues) != numValues)
+ *  {
+ *    // error
+ *  }
+ * @endcode
+ *
+ * @sa
+ * vtkNumberToString
+ */
+#ifndef vtkStringToNumber_h
+#define vtkStringToNumber_h
+
+#include "vtkIOCoreModule.h" // For export macro
+
+#include <istream> // For istream
+#include <vector>  // For std::vector
+
+class VTKIOCORE_EXPORT vtkStringToNumber
+{
+public:
+  /**
+   * Parse up to numValues numbers from the text between begin and end
+   * into values.  Returns the number of values parsed.  If last is not
+   * null, it is set to the end of the last number parsed.
+   */
+  template <typename T>
+  static size_t Parse(const char* begin, const char* end, T* values,
+    size_t numValues, const char** last = nullptr);
+
+  /**
+   * Read up to numValues numbers from the stream into values.  Returns
+   * the number of values read.  The stream is left right after the last
+   * number read, as it would be by operator>>.
+   */
+  template <typename T>
+  static size_t Read(std::istream& is, T* values, size_t numValues);
+
+  /**
+   * Read numbers from the stream and append them to values, until one
+   * does not parse or the stream ends.  Returns the number of values
+   * read.  The stream is left right after the last number read.
+   */
+  template <typename T>
+  static size_t Read(std::istream& is, std::vector<T>& values);
+};
+
+#endif
+// VTK-HeaderTest-Exclude: vtkStringToNumber.h
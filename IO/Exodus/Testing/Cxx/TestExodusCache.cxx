@@ -0,0 +1,193 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestExodusCache.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of the array cache of vtkExodusIIReader
+// .SECTION Description
+// Reads all the result arrays of a file without cache, with a cache, with
+// and without reading the arrays of each block together, and into memory.
+// Checks that the outputs are the same, that reading together turns the
+// misses of the result arrays into hits, and that the cache is used.
+
+#include "vtkCellData.h"
+#include "vtkCompositeDataIterator.h"
+#include "vtkDataArray.h"
+#include "vtkDataSet.h"
+#include "vtkExodusIIReader.h"
+#include "vtkMultiBlockDataSet.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+
+namespace
+{
+void EnableAllArrays(vtkExodusIIReader* reader)
+{
+  const int types[] = { vtkExodusIIReader::NODAL, vtkExodusIIReader::ELEM_BLOCK };
+  for (int type : types)
+  {
+    for (int i = 0; i < reader->GetNumberOfObjectArrays(type); ++i)
+    {
+      reader->SetObjectArrayStatus(type, i, 1);
+    }
+  }
+}
+
+bool SameArrays(vtkFieldData* a, vtkFieldData* b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray* aa = a->GetArray(i);
+    vtkDataArray* ba = aa ? b->GetArray(aa->GetName()) : nullptr;
+    if (!aa)
+    {
+      continue;
+    }
+    if (!ba || aa->GetNumberOfTuples() != ba->GetNumberOfTuples() ||
+        aa->GetNumberOfComponents() != ba->GetNumberOfComponents())
+    {
+      return false;
+    }
+    for (vtkIdType t = 0; t < aa->GetNumberOfTuples(); ++t)
+    {
+      for (int c = 0; c < aa->GetNumberOfComponents(); ++c)
+      {
+        if (aa->GetComponent(t, c) != ba->GetComponent(t, c))
+        {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool SameOutput(vtkMultiBlockDataSet* a, vtkMultiBlockDataSet* b)
+{
+  vtkSmartPointer<vtkCompositeDataIterator> ait;
+  ait.TakeReference(a->NewIterator());
+  vtkSmartPointer<vtkCompositeDataIterator> bit;
+  bit.TakeReference(b->NewIterator());
+  int numBlocks = 0;
+  for (ait->InitTraversal(), bit->InitTraversal();
+       !ait->IsDoneWithTraversal() && !bit->IsDoneWithTraversal();
+       ait->GoToNextItem(), bit->GoToNextItem(), ++numBlocks)
+  {
+    vtkDataSet* ads = vtkDataSet::SafeDownCast(ait->GetCurrentDataObject());
+    vtkDataSet* bds = vtkDataSet::SafeDownCast(bit->GetCurrentDataObject());
+    if (!ads || !bds || !SameArrays(ads->GetPointData(), bds->GetPointData()) ||
+        !SameArrays(ads->GetCellData(), bds->GetCellData()))
+    {
+      return false;
+    }
+  }
+  return numBlocks > 0 && ait->IsDoneWithTraversal() &&
+    bit->IsDoneWithTraversal();
+}
+}
+
+int TestExodusCache(int argc, char* argv[])
+{
+  char* fname = vtkTestUtilities::ExpandDataFileName(
+    argc, argv, "Data/can.ex2");
+  if (!fname)
+  {
+    cout << "Could not obtain filename for test data.\n";
+    return 1;
+  }
+
+  // Without cache, every array is read when it is requested.
+  vtkNew<vtkExodusIIReader> uncached;
+  uncached->SetFileName(fname);
+  uncached->SetCacheSize(0.);
+  uncached->UpdateInformation();
+  EnableAllArrays(uncached);
+  uncached->SetTimeStep(1);
+  uncached->Update();
+
+  vtkNew<vtkExodusIIReader> cached;
+  cached->SetFileName(fname);
+  cached->SetCacheSize(100.);
+  cached->UpdateInformation();
+  EnableAllArrays(cached);
+  cached->SetTimeStep(1);
+  cached->Update();
+  if (!SameOutput(uncached->GetOutput(), cached->GetOutput()))
+  {
+    std::cerr << "The arrays read with a cache differ." << std::endl;
+    delete[] fname;
+    return 1;
+  }
+
+  // Read each array when it is requested: every result array is then a
+  // miss. The arrays are looked up the same number of times either way.
+  vtkNew<vtkExodusIIReader> separate;
+  separate->SetFileName(fname);
+  separate->SetCacheSize(100.);
+  separate->ReadResultArraysTogetherOff();
+  separate->UpdateInformation();
+  EnableAllArrays(separate);
+  separate->SetTimeStep(1);
+  separate->Update();
+  if (!SameOutput(uncached->GetOutput(), separate->GetOutput()))
+  {
+    std::cerr << "The arrays read separately differ." << std::endl;
+    delete[] fname;
+    return 1;
+  }
+  const vtkTypeUInt64 togetherMisses = cached->GetNumberOfCacheMisses();
+  const vtkTypeUInt64 separateMisses = separate->GetNumberOfCacheMisses();
+  if (togetherMisses >= separateMisses ||
+      cached->GetNumberOfCacheHits() + togetherMisses !=
+        separate->GetNumberOfCacheHits() + separateMisses)
+  {
+    std::cerr << "The arrays of a block were not read together: "
+              << togetherMisses << " misses, " << separateMisses
+              << " when read separately." << std::endl;
+    delete[] fname;
+    return 1;
+  }
+
+  // Reading the same time step again finds the arrays in the cache.
+  const vtkTypeUInt64 misses = cached->GetNumberOfCacheMisses();
+  cached->Modified();
+  cached->Update();
+  if (cached->GetNumberOfCacheMisses() - misses >= misses ||
+      !SameOutput(uncached->GetOutput(), cached->GetOutput()))
+  {
+    std::cerr << "Reading a cached time step again failed." << std::endl;
+    delete[] fname;
+    return 1;
+  }
+
+  vtkNew<vtkExodusIIReader> inMemory;
+  inMemory->SetFileName(fname);
+  inMemory->ReadFileIntoMemoryOn();
+  inMemory->UpdateInformation();
+  EnableAllArrays(inMemory);
+  inMemory->SetTimeStep(1);
+  inMemory->Update();
+  delete[] fname;
+  if (!SameOutput(uncached->GetOutput(), inMemory->GetOutput()))
+  {
+    std::cerr << "The arrays read into memory differ." << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
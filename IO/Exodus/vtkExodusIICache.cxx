@@ -9,7 +9,7 @@
 #define VTK_EXO_PRT_KEY( ckey ) \
   "(" << (ckey).Time << ", " << (ckey).ObjectType << ", " << (ckey).ObjectId << ", " << (ckey).ArrayId << ")"
 #define VTK_EXO_PRT_ARR( cval ) \
-  " [" << (cval) << "," <<  ((cval) ? (cval)->GetActualMemorySize() / 1024. : 0.) << "/" << this->Size << "/" << this->Capacity << "]"
+  " [" << (cval) << "," <<  ((cval) ? (cval)->GetActualMemorySize() / 1024. : 0.) << "/" << this->GetSize() << "/" << this->Capacity << "]"
 #define VTK_EXO_PRT_ARR2( cval ) \
   " [" << (cval) << ", " <<  ((cval) ? (cval)->GetActualMemorySize() / 1024. : 0.) << "]"
 
@@ -35,13 +35,18 @@ static void printCache( vtkExodusIICacheSet& cache, vtkExodusIICacheLRU& lru )
 vtkExodusIICacheEntry::vtkExodusIICacheEntry()
 {
   this->Value = nullptr;
+  this->Size = 0;
 }
 
 vtkExodusIICacheEntry::vtkExodusIICacheEntry( vtkDataArray* arr )
 {
   this->Value = arr;
+  this->Size = 0;
   if ( arr )
+  {
     this->Value->Register( nullptr );
+    this->Size = arr->GetActualMemorySize();
+  }
 }
 vtkExodusIICacheEntry::~vtkExodusIICacheEntry()
 {
@@ -52,6 +57,7 @@ vtkExodusIICacheEntry::~vtkExodusIICacheEntry()
 vtkExodusIICacheEntry::vtkExodusIICacheEntry( const vtkExodusIICacheEntry& other )
 {
   this->Value = other.Value;
+  this->Size = other.Size;
   if ( this->Value )
     this->Value->Register( nullptr );
 }
@@ -69,8 +75,10 @@ vtkStandardNewMacro(vtkExodusIICache);
 
 vtkExodusIICache::vtkExodusIICache()
 {
-  this->Size = 0.;
+  this->Size = 0;
   this->Capacity = 2.;
+  this->NumberOfHits = 0;
+  this->NumberOfMisses = 0;
 }
 
 vtkExodusIICache::~vtkExodusIICache()
@@ -82,9 +90,11 @@ void vtkExodusIICache::PrintSelf( ostream& os, vtkIndent indent )
 {
   this->Superclass::PrintSelf( os, indent );
   os << indent << "Capacity: " << this->Capacity << " MiB\n";
-  os << indent << "Size: " << this->Size << " MiB\n";
+  os << indent << "Size: " << this->GetSize() << " MiB\n";
   os << indent << "Cache: " << &this->Cache << " (" << this->Cache.size() << ")\n";
   os << indent << "LRU: " << &this->LRU << "\n";
+  os << indent << "NumberOfHits: " << this->NumberOfHits << "\n";
+  os << indent << "NumberOfMisses: " << this->NumberOfMisses << "\n";
 }
 
 void vtkExodusIICache::Clear()
@@ -98,7 +108,7 @@ void vtkExodusIICache::SetCacheCapacity( double sizeInMiB )
   if ( sizeInMiB == this->Capacity )
     return;
 
-  if ( this->Size > sizeInMiB )
+  if ( this->GetSize() > sizeInMiB )
   {
     this->ReduceToSize( sizeInMiB );
   }
@@ -109,41 +119,17 @@ void vtkExodusIICache::SetCacheCapacity( double sizeInMiB )
 int vtkExodusIICache::ReduceToSize( double newSize )
 {
   int deletedSomething = 0;
-  while ( this->Size > newSize && ! this->LRU.empty() )
+  while ( this->GetSize() > newSize && ! this->LRU.empty() )
   {
     vtkExodusIICacheRef cit( this->LRU.back() );
-    vtkDataArray* arr = cit->second->Value;
-    if ( arr )
+    if ( cit->second->Value )
     {
       deletedSomething = 1;
-      double arrSz = (double) arr->GetActualMemorySize() / 1024.;
-      this->Size -= arrSz;
-#ifdef VTK_EXO_DBG_CACHE
-      cout << "Dropping " << VTK_EXO_PRT_KEY( cit->first ) << VTK_EXO_PRT_ARR( arr ) << "\n";
-#endif // VTK_EXO_DBG_CACHE
-      if ( this->Size <= 0 )
-      {
-        if ( this->Cache.empty() )
-          this->Size = 0.;
-        else
-          this->RecomputeSize(); // oops, FP roundoff
-      }
     }
-    else
-    {
 #ifdef VTK_EXO_DBG_CACHE
-      cout << "Dropping " << VTK_EXO_PRT_KEY( cit->first ) << VTK_EXO_PRT_ARR( arr ) << "\n";
+    cout << "Dropping " << VTK_EXO_PRT_KEY( cit->first ) << VTK_EXO_PRT_ARR( cit->second->Value ) << "\n";
 #endif // VTK_EXO_DBG_CACHE
-    }
-
-    delete cit->second;
-    this->Cache.erase( cit );
-    this->LRU.pop_back();
-  }
-
-  if ( this->Cache.empty() )
-  {
-    this->Size = 0;
+    this->Drop( cit );
   }
 
   return deletedSomething;
@@ -151,42 +137,28 @@ int vtkExodusIICache::ReduceToSize( double newSize )
 
 void vtkExodusIICache::Insert( vtkExodusIICacheKey& key, vtkDataArray* value )
 {
-  double vsize = value ? value->GetActualMemorySize() / 1024. : 0.;
-
   vtkExodusIICacheRef it = this->Cache.find( key );
   if ( it != this->Cache.end() )
   {
     if ( it->second->Value == value )
       return;
 
-    // Remove existing array and put in our new one.
-    this->Size -= vsize;
-    if ( this->Size <= 0 )
-    {
-      this->RecomputeSize();
-    }
-    this->ReduceToSize( this->Capacity - vsize );
-    it->second->Value->Delete();
-    it->second->Value = value;
-    it->second->Value->Register( nullptr ); // Since we re-use the cache entry, the constructor's Register won't get called.
-    this->Size += vsize;
+    // Remove the existing array with its own size, then add the new one.
 #ifdef VTK_EXO_DBG_CACHE
     cout << "Replacing " << VTK_EXO_PRT_KEY( it->first ) << VTK_EXO_PRT_ARR( value ) << "\n";
 #endif // VTK_EXO_DBG_CACHE
-    this->LRU.erase( it->second->LRUEntry );
-    it->second->LRUEntry = this->LRU.insert( this->LRU.begin(), it );
+    this->Drop( it );
   }
-  else
-  {
-    this->ReduceToSize( this->Capacity - vsize );
-    std::pair<const vtkExodusIICacheKey,vtkExodusIICacheEntry*> entry( key, new vtkExodusIICacheEntry(value) );
-    std::pair<vtkExodusIICacheSet::iterator, bool> iret = this->Cache.insert( entry );
-    this->Size += vsize;
+
+  vtkExodusIICacheEntry* entry = new vtkExodusIICacheEntry( value );
+  this->ReduceToSize( this->Capacity - entry->Size / 1024. );
+  std::pair<vtkExodusIICacheSet::iterator, bool> iret =
+    this->Cache.insert( std::make_pair( key, entry ) );
+  this->Size += entry->Size;
 #ifdef VTK_EXO_DBG_CACHE
-    cout << "Adding " << VTK_EXO_PRT_KEY( key ) << VTK_EXO_PRT_ARR( value ) << "\n";
+  cout << "Adding " << VTK_EXO_PRT_KEY( key ) << VTK_EXO_PRT_ARR( value ) << "\n";
 #endif // VTK_EXO_DBG_CACHE
-    iret.first->second->LRUEntry = this->LRU.insert( this->LRU.begin(), iret.first );
-  }
+  entry->LRUEntry = this->LRU.insert( this->LRU.begin(), iret.first );
   //printCache( this->Cache, this->LRU );
 }
 
@@ -197,11 +169,13 @@ vtkDataArray*& vtkExodusIICache::Find( const vtkExodusIICacheKey& key )
   vtkExodusIICacheRef it = this->Cache.find( key );
   if ( it != this->Cache.end() )
   {
+    ++this->NumberOfHits;
     this->LRU.erase( it->second->LRUEntry );
     it->second->LRUEntry = this->LRU.insert( this->LRU.begin(), it );
     return it->second->Value;
   }
 
+  ++this->NumberOfMisses;
   dummy = nullptr;
   return dummy;
 }
@@ -214,22 +188,7 @@ int vtkExodusIICache::Invalidate( const vtkExodusIICacheKey& key )
 #ifdef VTK_EXO_DBG_CACHE
     cout << "Dropping " << VTK_EXO_PRT_KEY( it->first ) << VTK_EXO_PRT_ARR( it->second->Value ) << "\n";
 #endif // VTK_EXO_DBG_CACHE
-    this->LRU.erase( it->second->LRUEntry );
-    if ( it->second->Value )
-    {
-      this->Size -= it->second->Value->GetActualMemorySize() / 1024.;
-    }
-    delete it->second;
-    this->Cache.erase( it );
-
-    if ( this->Size <= 0 )
-    {
-      if ( this->Cache.empty() )
-        this->Size = 0.;
-      else
-        this->RecomputeSize(); // oops, FP roundoff
-    }
-
+    this->Drop( it );
     return 1;
   }
   return 0;
@@ -251,37 +210,29 @@ int vtkExodusIICache::Invalidate( const vtkExodusIICacheKey& key, const vtkExodu
 #ifdef VTK_EXO_DBG_CACHE
     cout << "Dropping " << VTK_EXO_PRT_KEY( it->first ) << VTK_EXO_PRT_ARR( it->second->Value ) << "\n";
 #endif // VTK_EXO_DBG_CACHE
-    this->LRU.erase( it->second->LRUEntry );
-    if ( it->second->Value )
-    {
-      this->Size -= it->second->Value->GetActualMemorySize() / 1024.;
-    }
     vtkExodusIICacheRef tmpIt = it++;
-    delete tmpIt->second;
-    this->Cache.erase( tmpIt );
-
-    if ( this->Size <= 0 )
-    {
-      if ( this->Cache.empty() )
-        this->Size = 0.;
-      else
-        this->RecomputeSize(); // oops, FP roundoff
-    }
-
+    this->Drop( tmpIt );
     ++nDropped;
   }
   return nDropped;
 }
 
-void vtkExodusIICache::RecomputeSize()
+double vtkExodusIICache::GetHitRatio()
 {
-  this->Size = 0.;
-  vtkExodusIICacheRef it;
-  for ( it = this->Cache.begin(); it != this->Cache.end(); ++it )
-  {
-    if ( it->second->Value )
-    {
-      this->Size += (double)it->second->Value->GetActualMemorySize() / 1024.;
-    }
-  }
+  vtkTypeUInt64 total = this->NumberOfHits + this->NumberOfMisses;
+  return total ? static_cast<double>( this->NumberOfHits ) / total : 0.;
+}
+
+void vtkExodusIICache::ResetStatistics()
+{
+  this->NumberOfHits = 0;
+  this->NumberOfMisses = 0;
+}
+
+void vtkExodusIICache::Drop( vtkExodusIICacheRef it )
+{
+  this->LRU.erase( it->second->LRUEntry );
+  this->Size -= it->second->Size;
+  delete it->second;
+  this->Cache.erase( it );
 }
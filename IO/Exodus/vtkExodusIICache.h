@@ -22,6 +22,12 @@
 // entries O(1). Each cache entry stores an iterator into
 // the list of references so that it can be located quickly for
 // removal.
+//
+// The size of each array is recorded when it is inserted, so the
+// size of the cache is an exact sum even if an array is resized or
+// replaced while it is cached. The cache also counts how many
+// Find() calls succeed, which tells whether the capacity is large
+// enough for the way the data is accessed.
 
 #include "vtkIOExodusModule.h" // For export macro
 #include "vtkObject.h"
@@ -120,6 +126,8 @@ public:
 protected:
   vtkDataArray* Value;
   vtkExodusIICacheLRURef LRUEntry;
+  /// The size of Value in KiB when it was inserted.
+  unsigned long Size;
 
   friend class vtkExodusIICache;
 };
@@ -142,7 +150,11 @@ public:
     * The result is in MiB.
     */
   double GetSpaceLeft()
-    { return this->Capacity - this->Size; }
+    { return this->Capacity - this->GetSize(); }
+
+  /// The size of the arrays in the cache in MiB.
+  double GetSize()
+    { return this->Size / 1024.; }
 
   /** Remove cache entries until the size of the cache is at or below the given size.
     * Returns a nonzero value if deletions were required.
@@ -157,6 +169,12 @@ public:
     */
   vtkDataArray*& Find( const vtkExodusIICacheKey& );
 
+  /** Determine whether a cache entry exists without marking it as used.
+    * Unlike Find(), this is not counted as a hit or a miss.
+    */
+  bool Contains( const vtkExodusIICacheKey& key ) const
+    { return this->Cache.find( key ) != this->Cache.end(); }
+
   /** Invalidate a cache entry (drop it from the cache) if the key exists.
     * This does nothing if the cache entry does not exist.
     * Returns 1 if the cache entry existed prior to this call and 0 otherwise.
@@ -174,6 +192,21 @@ public:
     */
   int Invalidate( const vtkExodusIICacheKey& key, const vtkExodusIICacheKey& pattern );
 
+  //@{
+  /** The number of Find() calls that returned a cached array (hits) and
+    * that did not (misses) since the cache was created or the statistics
+    * were reset.
+    */
+  vtkGetMacro(NumberOfHits,vtkTypeUInt64);
+  vtkGetMacro(NumberOfMisses,vtkTypeUInt64);
+  //@}
+
+  /// The fraction of Find() calls that were hits, or 0 if there was none.
+  double GetHitRatio();
+
+  /// Reset the hit and miss counts.
+  void ResetStatistics();
+
 protected:
   /// Default constructor
   vtkExodusIICache();
@@ -182,14 +215,17 @@ protected:
   ~vtkExodusIICache() override;
 
 
-  /// Avoid (some) FP problems
-  void RecomputeSize();
+  /// Remove an entry from the cache and the LRU list.
+  void Drop( vtkExodusIICacheRef it );
 
   /// The capacity of the cache (i.e., the maximum size of all arrays it contains) in MiB.
   double Capacity;
 
-  /// The current size of the cache (i.e., the size of the all the arrays it currently contains) in MiB.
-  double Size;
+  /// The current size of the cache (i.e., the sum of the sizes of the entries) in KiB.
+  vtkTypeUInt64 Size;
+
+  vtkTypeUInt64 NumberOfHits;
+  vtkTypeUInt64 NumberOfMisses;
 
   /** A least-recently-used (LRU) cache to hold arrays.
     * During RequestData the cache may contain more than its maximum size since
@@ -388,6 +388,8 @@ vtkExodusIIReaderPrivate::vtkExodusIIReaderPrivate()
   this->AnimateModeShapes = 1;
 
   this->IgnoreFileTime = false;
+  this->ReadFileIntoMemory = false;
+  this->ReadResultArraysTogether = true;
 
   this->GenerateObjectIdArray = 1;
   this->GenerateGlobalElementIdArray = 0;
@@ -637,6 +639,7 @@ int vtkExodusIIReaderPrivate::AssembleOutputPointArrays(
   std::vector<ArrayInfoType>::iterator ai;
   int aidx = 0;
 
+  this->ReadResultArrays( timeStep, vtkExodusIIReader::NODAL, 0 );
   for (
     ai = this->ArrayInfo[ vtkExodusIIReader::NODAL ].begin();
     ai != this->ArrayInfo[ vtkExodusIIReader::NODAL ].end();
@@ -760,6 +763,7 @@ int vtkExodusIIReaderPrivate::AssembleOutputCellArrays(
   // table indicating values are present for object obj in the file.
   std::vector<ArrayInfoType>::iterator ai;
   int aidx = 0;
+  this->ReadResultArrays( timeStep, otyp, obj );
   for ( ai = ami->second.begin(); ai != ami->second.end(); ++ai, ++aidx )
   {
     if ( ! ai->Status )
@@ -2956,6 +2960,154 @@ vtkDataArray* vtkExodusIIReaderPrivate::GetCacheOrRead( vtkExodusIICacheKey key
   return arr;
 }
 
+//-----------------------------------------------------------------------------
+void vtkExodusIIReaderPrivate::ReadResultArrays(
+  vtkIdType timeStep, int otyp, int obj )
+{
+  if ( ! this->ReadResultArraysTogether )
+  {
+    return;
+  }
+  switch ( otyp )
+  {
+    case vtkExodusIIReader::NODAL:
+    case vtkExodusIIReader::EDGE_BLOCK:
+    case vtkExodusIIReader::FACE_BLOCK:
+    case vtkExodusIIReader::ELEM_BLOCK:
+    case vtkExodusIIReader::NODE_SET:
+    case vtkExodusIIReader::EDGE_SET:
+    case vtkExodusIIReader::FACE_SET:
+    case vtkExodusIIReader::SIDE_SET:
+    case vtkExodusIIReader::ELEM_SET:
+      break;
+    default:
+      return;
+  }
+  std::map<int,std::vector<ArrayInfoType> >::iterator ami = this->ArrayInfo.find( otyp );
+  if ( ami == this->ArrayInfo.end() )
+  {
+    return;
+  }
+
+  vtkIdType numTuples;
+  vtkIdType objId;
+  if ( otyp == vtkExodusIIReader::NODAL )
+  {
+    numTuples = this->ModelParameters.num_nodes;
+    objId = 0;
+  }
+  else
+  {
+    ObjectInfoType* oinfop = this->GetObjectInfo(
+      this->GetObjectTypeIndexFromObjectType( otyp ), obj );
+    if ( ! oinfop )
+    {
+      return;
+    }
+    numTuples = oinfop->Size;
+    objId = oinfop->Id;
+  }
+  if ( numTuples <= 0 )
+  {
+    return;
+  }
+
+  // Collect the arrays that are not cached yet and the file variables
+  // holding their components, as (variable index, (array, component)).
+  std::vector<vtkSmartPointer<vtkDoubleArray> > arrays;
+  std::vector<int> arrayIds;
+  std::vector<std::pair<int,std::pair<int,int> > > vars;
+  double size = 0.;
+  int aidx = 0;
+  std::vector<ArrayInfoType>::iterator ai;
+  for ( ai = ami->second.begin(); ai != ami->second.end(); ++ai, ++aidx )
+  {
+    if ( ! ai->Status || ai->StorageType != VTK_DOUBLE ||
+      ( otyp != vtkExodusIIReader::NODAL && ! ai->ObjectTruth[obj] ) ||
+      this->Cache->Contains( vtkExodusIICacheKey( timeStep, otyp, obj, aidx ) ) )
+    {
+      continue;
+    }
+    // Promote 2-component arrays to 3-component arrays when we have 2-D coordinates
+    int ncomps = ( this->ModelParameters.num_dim == 2 && ai->Components == 2 ) ? 3 : ai->Components;
+    for ( int c = 0; c < ai->Components; ++c )
+    {
+      vars.push_back( std::make_pair( ai->OriginalIndices[c],
+          std::make_pair( static_cast<int>( arrays.size() ), c ) ) );
+    }
+    vtkSmartPointer<vtkDoubleArray> arr = vtkSmartPointer<vtkDoubleArray>::New();
+    arr->SetName( ai->Name.c_str() );
+    arr->SetNumberOfComponents( ncomps );
+    arrays.push_back( arr );
+    arrayIds.push_back( aidx );
+    size += static_cast<double>( numTuples ) * ncomps * sizeof( double );
+  }
+
+  // A single array is read by GetCacheOrRead() as usual. Arrays read
+  // together must fit in the cache, or they would evict each other before
+  // they are requested.
+  if ( arrays.size() < 2 || size / 1048576. > this->CacheSize )
+  {
+    return;
+  }
+
+  for ( size_t i = 0; i < arrays.size(); ++i )
+  {
+    arrays[i]->SetNumberOfTuples( numTuples );
+    if ( arrays[i]->GetNumberOfComponents() == 3 &&
+      this->ArrayInfo[otyp][arrayIds[i]].Components == 2 )
+    {
+      arrays[i]->FillComponent( 2, 0. );
+    }
+  }
+
+  // Read the variables in the order in which they are stored in the file.
+  std::sort( vars.begin(), vars.end() );
+  std::vector<bool> failed( arrays.size(), false );
+  std::vector<double> tmpVal;
+  for ( size_t v = 0; v < vars.size(); ++v )
+  {
+    int a = vars[v].second.first;
+    int c = vars[v].second.second;
+    if ( failed[a] )
+    {
+      continue;
+    }
+    vtkDoubleArray* arr = arrays[a];
+    int ncomps = arr->GetNumberOfComponents();
+    double* dst = ncomps == 1 ? arr->GetPointer( 0 ) : nullptr;
+    if ( ! dst )
+    {
+      tmpVal.resize( numTuples );
+    }
+    if ( ex_get_var( this->Exoid, timeStep + 1, static_cast<ex_entity_type>( otyp ),
+        vars[v].first, objId, numTuples, dst ? dst : &tmpVal[0] ) < 0 )
+    {
+      // GetCacheOrRead() reads the array again and reports the error.
+      failed[a] = true;
+      continue;
+    }
+    if ( ! dst )
+    {
+      // Exodus doesn't support reading with a stride, so interleave the components.
+      dst = arr->GetPointer( 0 ) + c;
+      for ( vtkIdType t = 0; t < numTuples; ++t, dst += ncomps )
+      {
+        *dst = tmpVal[t];
+      }
+    }
+  }
+
+  for ( size_t i = 0; i < arrays.size(); ++i )
+  {
+    if ( ! failed[i] )
+    {
+      vtkExodusIICacheKey key( timeStep, otyp, obj, arrayIds[i] );
+      this->Cache->Insert( key, arrays[i] );
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 int vtkExodusIIReaderPrivate::GetConnTypeIndexFromConnType( int ctyp )
 {
@@ -3629,6 +3781,8 @@ void vtkExodusIIReader::PrintSelf( ostream& os, vtkIndent indent )
   os << indent << "ModeShapesRange:  [ "
     << this->GetModeShapesRange()[0] << ", " << this->GetModeShapesRange()[1] << "]\n";
   os << indent << "IgnoreFileTime: " << this->GetIgnoreFileTime() << "\n";
+  os << indent << "ReadFileIntoMemory: " << this->GetReadFileIntoMemory() << "\n";
+  os << indent << "ReadResultArraysTogether: " << this->GetReadResultArraysTogether() << "\n";
   os << indent << "SILUpdateStamp: " << this->SILUpdateStamp << "\n";
   if ( this->Metadata )
   {
@@ -3771,7 +3925,10 @@ int vtkExodusIIReaderPrivate::OpenFile( const char* filename )
     this->CloseFile();
   }
 
-  this->Exoid = ex_open( filename, EX_READ,
+  // In diskless mode, netCDF reads a classic file into memory with a single
+  // read when it is opened; netCDF-4 files ignore the flag.
+  this->Exoid = ex_open( filename,
+    this->ReadFileIntoMemory ? EX_READ | EX_DISKLESS : EX_READ,
     &this->AppWordSize, &this->DiskWordSize, &this->ExodusVersion );
 #ifdef VTK_USE_64BIT_IDS
   // Set the exodus API to always return integer types as 64-bit
@@ -4690,6 +4847,7 @@ void vtkExodusIIReaderPrivate::ResetCache()
 {
   this->Cache->Clear();
   this->Cache->SetCacheCapacity(this->CacheSize); // FIXME: Perhaps Cache should have a Reset and a Clear method?
+  this->Cache->ResetStatistics();
   this->ClearConnectivityCaches();
 }
 
@@ -6417,6 +6575,41 @@ double vtkExodusIIReader::GetCacheSize()
   return this->Metadata->GetCacheSize();
 }
 
+vtkTypeUInt64 vtkExodusIIReader::GetNumberOfCacheHits()
+{
+  return this->Metadata->GetCache()->GetNumberOfHits();
+}
+
+vtkTypeUInt64 vtkExodusIIReader::GetNumberOfCacheMisses()
+{
+  return this->Metadata->GetCache()->GetNumberOfMisses();
+}
+
+double vtkExodusIIReader::GetCacheHitRatio()
+{
+  return this->Metadata->GetCache()->GetHitRatio();
+}
+
+void vtkExodusIIReader::SetReadFileIntoMemory(bool flag)
+{
+  this->Metadata->SetReadFileIntoMemory(flag);
+}
+
+bool vtkExodusIIReader::GetReadFileIntoMemory()
+{
+  return this->Metadata->GetReadFileIntoMemory();
+}
+
+void vtkExodusIIReader::SetReadResultArraysTogether(bool flag)
+{
+  this->Metadata->SetReadResultArraysTogether(flag);
+}
+
+bool vtkExodusIIReader::GetReadResultArraysTogether()
+{
+  return this->Metadata->GetReadResultArraysTogether();
+}
+
 void vtkExodusIIReader::SetSqueezePoints(bool sp)
 {
   this->Metadata->SetSqueezePoints(sp ? 1 : 0);
@@ -751,6 +751,46 @@ public:
    */
   double GetCacheSize();
 
+  //@{
+  /**
+   * The number of arrays that were found in the cache (hits) or had to be
+   * read from the file (misses) since the last ResetCache(), and the
+   * fraction of hits. When an array is read, the other enabled result
+   * arrays of the same block or set at the same time step are read along
+   * with it if they fit in the cache (see ReadResultArraysTogether), so
+   * requesting them counts as hits.
+   */
+  vtkTypeUInt64 GetNumberOfCacheHits();
+  vtkTypeUInt64 GetNumberOfCacheMisses();
+  double GetCacheHitRatio();
+  //@}
+
+  //@{
+  /**
+   * When on, the enabled result arrays of a block, set or of the nodes at
+   * a time step are read in a single pass over the file variables, when
+   * they fit in the cache together. When off, each array is read when it
+   * is requested. It is on by default.
+   */
+  void SetReadResultArraysTogether(bool flag);
+  bool GetReadResultArraysTogether();
+  vtkBooleanMacro(ReadResultArraysTogether, bool);
+  //@}
+
+  //@{
+  /**
+   * When on, a file in the classic netCDF format is read into memory with
+   * a single read when it is opened, using the diskless mode of netCDF.
+   * This is faster for small and medium files on slow or network file
+   * systems, but the whole file is read again on every update, so it
+   * should be off for files with many time steps. Files in the netCDF-4
+   * format ignore it. It is off by default.
+   */
+  void SetReadFileIntoMemory(bool flag);
+  bool GetReadFileIntoMemory();
+  vtkBooleanMacro(ReadFileIntoMemory, bool);
+  //@}
+
   //@{
   /**
    * Should the reader output only points used by elements in the output mesh,
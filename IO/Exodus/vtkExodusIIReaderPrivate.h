@@ -78,6 +78,9 @@ public:
   /// Get the size of the cache in MiB.
   vtkGetMacro(CacheSize, double);
 
+  /// Get the cache, e.g. for its hit and miss counts.
+  vtkExodusIICache* GetCache() { return this->Cache; }
+
   /** Return the number of time steps in the open file.
     * You must have called RequestInformation() before
     * invoking this member function.
@@ -263,6 +266,12 @@ public:
   vtkSetMacro(IgnoreFileTime, bool);
   vtkGetMacro(IgnoreFileTime, bool);
 
+  vtkSetMacro(ReadFileIntoMemory, bool);
+  vtkGetMacro(ReadFileIntoMemory, bool);
+
+  vtkSetMacro(ReadResultArraysTogether, bool);
+  vtkGetMacro(ReadResultArraysTogether, bool);
+
   vtkDataArray* FindDisplacementVectors( int timeStep );
 
   const struct ex_init_params* GetModelParams() const
@@ -638,6 +647,17 @@ protected:
     */
   vtkDataArray* GetCacheOrRead( vtkExodusIICacheKey );
 
+  /** Read the enabled result arrays of an object (a block or set, or the
+    * nodes when \a otyp is NODAL) at a time step that are not cached yet
+    * and insert them into the cache, so that the following GetCacheOrRead()
+    * calls for the object are hits. The variables are read in the order in
+    * which they are stored in the file, with a single scratch buffer for
+    * the components of vector and tensor arrays. Nothing is read if the
+    * arrays would not fit in the cache together, or if
+    * ReadResultArraysTogether is off.
+    */
+  void ReadResultArrays( vtkIdType timeStep, int otyp, int obj );
+
   /** Return the index of an object type (in a private list of all object types).
     * This returns a 0-based index if the object type was found and -1 if it
     * was not.
@@ -831,6 +851,12 @@ protected:
 
   bool IgnoreFileTime;
 
+  /// Open classic netCDF files with EX_DISKLESS.
+  bool ReadFileIntoMemory;
+
+  /// Read the result arrays of an object together (see ReadResultArrays()).
+  bool ReadResultArraysTogether;
+
   /** Should the reader output only points used by elements in the output mesh,
     * or all the points. Outputting all the points is much faster since the
     * point array can be read straight from disk and the mesh connectivity need
@@ -0,0 +1,143 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSTLReaderMerging.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// .NAME Test of point merging in vtkSTLReader
+// .SECTION Description
+// Writes a sphere to binary and ASCII STL files, and checks that the
+// points merged without a locator are the same, in the same order, as
+// the points merged with a vtkMergePoints locator.
+
+#include "vtkCellArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkMergePoints.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSTLReader.h"
+#include "vtkSTLWriter.h"
+#include "vtkSphereSource.h"
+#include "vtkTestUtilities.h"
+
+#include <string>
+
+namespace
+{
+bool SamePolyData(vtkPolyData* a, vtkPolyData* b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfPolys() != b->GetNumberOfPolys())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+  {
+    double pa[3];
+    double pb[3];
+    a->GetPoint(i, pa);
+    b->GetPoint(i, pb);
+    if (pa[0] != pb[0] || pa[1] != pb[1] || pa[2] != pb[2])
+    {
+      return false;
+    }
+  }
+  vtkIdTypeArray* ca = a->GetPolys()->GetData();
+  vtkIdTypeArray* cb = b->GetPolys()->GetData();
+  if (ca->GetNumberOfValues() != cb->GetNumberOfValues())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < ca->GetNumberOfValues(); ++i)
+  {
+    if (ca->GetValue(i) != cb->GetValue(i))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int TestSTLReaderMerging(int argc, char* argv[])
+{
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+  {
+    std::cout << "Could not determine temporary directory.\n";
+    return EXIT_FAILURE;
+  }
+  std::string testDirectory = tempDir;
+  delete[] tempDir;
+
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(60);
+  sphere->SetPhiResolution(40);
+  sphere->Update();
+  vtkIdType numTriangles = sphere->GetOutput()->GetNumberOfPolys();
+
+  const char* fileTypes[2] = { "Binary", "ASCII" };
+  for (int i = 0; i < 2; ++i)
+  {
+    std::string fileName =
+      testDirectory + "/TestSTLReaderMerging" + fileTypes[i] + ".stl";
+    vtkNew<vtkSTLWriter> writer;
+    writer->SetFileName(fileName.c_str());
+    writer->SetFileType(i == 0 ? VTK_BINARY : VTK_ASCII);
+    writer->SetInputConnection(sphere->GetOutputPort());
+    writer->Write();
+
+    vtkNew<vtkSTLReader> sorted;
+    sorted->SetFileName(fileName.c_str());
+    sorted->Update();
+
+    vtkNew<vtkSTLReader> located;
+    located->SetFileName(fileName.c_str());
+    vtkNew<vtkMergePoints> locator;
+    located->SetLocator(locator);
+    located->Update();
+
+    vtkNew<vtkSTLReader> unmerged;
+    unmerged->SetFileName(fileName.c_str());
+    unmerged->MergingOff();
+    unmerged->Update();
+
+    if (sorted->GetOutput()->GetNumberOfPolys() != numTriangles ||
+        sorted->GetOutput()->GetNumberOfPoints() !=
+          sphere->GetOutput()->GetNumberOfPoints())
+    {
+      std::cerr << fileTypes[i] << " file: expected " << numTriangles
+                << " triangles and "
+                << sphere->GetOutput()->GetNumberOfPoints()
+                << " points, got "
+                << sorted->GetOutput()->GetNumberOfPolys() << " and "
+                << sorted->GetOutput()->GetNumberOfPoints() << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (!SamePolyData(sorted->GetOutput(), located->GetOutput()))
+    {
+      std::cerr << fileTypes[i]
+                << " file: merging without a locator differs from "
+                   "merging with vtkMergePoints." << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (unmerged->GetOutput()->GetNumberOfPoints() != 3 * numTriangles ||
+        unmerged->GetOutput()->GetNumberOfPolys() != numTriangles)
+    {
+      std::cerr << fileTypes[i] << " file: reading without merging failed."
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
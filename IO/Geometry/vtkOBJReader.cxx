@@ -21,8 +21,14 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include <algorithm>
 #include <cctype>
+#include <cstdlib>
+#include <cstring>
 #include <map>
+#include <string>
+#include <vector>
 
 #include <map>
 #include "vtkCellData.h"
@@ -30,6 +36,176 @@
 
 vtkStandardNewMacro(vtkOBJReader);
 
+namespace
+{
+// The first pass reads the file in blocks of whole lines, split into
+// pieces whose lines are parsed in parallel.
+const size_t vtkOBJBlockSize = 16 << 20;
+const size_t vtkOBJPieceSize = 1 << 18;
+const int vtkOBJMaxLine = 1024;
+
+// Parse up to num floats from a line, as sscanf with "%f %f %f" would.
+int vtkOBJParseFloats(const char *line, int num, float *values)
+{
+  for (int i = 0; i < num; ++i)
+  {
+    char *end;
+    values[i] = strtof(line, &end);
+    if (end == line)
+    {
+      return i;
+    }
+    line = end;
+  }
+  return num;
+}
+
+// The coordinates and the material names of the lines of a piece of the
+// file.  Every "v" and "vn" line has coordinates, valid or not, so that
+// the second pass can report the invalid ones by their line number.
+struct vtkOBJPiece
+{
+  const char *Begin;
+  const char *End;
+  std::vector<float> Points;
+  std::vector<unsigned char> PointsValid;
+  std::vector<float> Normals;
+  std::vector<unsigned char> NormalsValid;
+  std::vector<float> TCoords;
+  std::vector<std::string> Materials;
+};
+
+struct vtkOBJParsePieces
+{
+  vtkOBJPiece *Pieces;
+
+  static void ParseTriplet(const char *line, std::vector<float> &coords,
+    std::vector<unsigned char> &valid)
+  {
+    float xyz[3] = { 0.0f, 0.0f, 0.0f };
+    valid.push_back(vtkOBJParseFloats(line, 3, xyz) == 3);
+    coords.insert(coords.end(), xyz, xyz + 3);
+  }
+
+  static void Parse(vtkOBJPiece &piece)
+  {
+    char rawLine[vtkOBJMaxLine];
+    for (const char *p = piece.Begin; p < piece.End;)
+    {
+      const char *eol = std::find(p, piece.End, '\n');
+      const char *next = (eol < piece.End) ? eol + 1 : eol;
+      size_t length = std::min(static_cast<size_t>(next - p),
+        static_cast<size_t>(vtkOBJMaxLine - 1));
+      memcpy(rawLine, p, length);
+      rawLine[length] = '\0';
+      p = next;
+
+      // the command is the first word of the line
+      char *pLine = rawLine;
+      while (isspace(*pLine)) { pLine++; }
+      const char *cmd = pLine;
+      while (*pLine && !isspace(*pLine)) { pLine++; }
+      if (*pLine)
+      {
+        *pLine++ = '\0';
+      }
+
+      if (strcmp(cmd, "v") == 0)
+      {
+        ParseTriplet(pLine, piece.Points, piece.PointsValid);
+      }
+      else if (strcmp(cmd, "vn") == 0)
+      {
+        ParseTriplet(pLine, piece.Normals, piece.NormalsValid);
+      }
+      else if (strcmp(cmd, "vt") == 0)
+      {
+        float uv[2];
+        if (vtkOBJParseFloats(pLine, 2, uv) == 2)
+        {
+          piece.TCoords.insert(piece.TCoords.end(), uv, uv + 2);
+        }
+      }
+      else if (strcmp(cmd, "usemtl") == 0)
+      {
+        while (isspace(*pLine)) { pLine++; }
+        const char *name = pLine;
+        while (*pLine && !isspace(*pLine)) { pLine++; }
+        if (pLine > name)
+        {
+          piece.Materials.push_back(std::string(name, pLine - name));
+        }
+      }
+    }
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      Parse(this->Pieces[i]);
+    }
+  }
+};
+
+// Parse an integer as sscanf with "%d" would.
+bool vtkOBJParseInt(const char *&p, int &value)
+{
+  char *end;
+  long parsed = strtol(p, &end, 10);
+  if (end == p)
+  {
+    return false;
+  }
+  value = static_cast<int>(parsed);
+  p = end;
+  return true;
+}
+
+// The forms of a face vertex, with the indices they hold.
+enum
+{
+  vtkOBJNoVertex,
+  vtkOBJVertex,
+  vtkOBJVertexTCoord,
+  vtkOBJVertexNormal,
+  vtkOBJVertexTCoordNormal
+};
+
+// Parse a face vertex as sscanf would with the formats "%d/%d/%d",
+// "%d//%d", "%d/%d" and "%d", tried in that order.
+int vtkOBJParseFaceVertex(const char *p, int &iVert, int &iTCoord, int &iNormal)
+{
+  if (!vtkOBJParseInt(p, iVert))
+  {
+    return vtkOBJNoVertex;
+  }
+  if (*p != '/')
+  {
+    return vtkOBJVertex;
+  }
+  ++p;
+  if (*p == '/')
+  {
+    ++p;
+    return vtkOBJParseInt(p, iNormal) ? vtkOBJVertexNormal : vtkOBJVertex;
+  }
+  if (!vtkOBJParseInt(p, iTCoord))
+  {
+    return vtkOBJVertex;
+  }
+  if (*p == '/')
+  {
+    ++p;
+    if (vtkOBJParseInt(p, iNormal))
+    {
+      return vtkOBJVertexTCoordNormal;
+    }
+  }
+  return vtkOBJVertexTCoord;
+}
+}
+
 //----------------------------------------------------------------------------
 vtkOBJReader::vtkOBJReader()
 {
@@ -173,34 +349,56 @@ int vtkOBJReader::RequestData(
   const int MAX_LINE = 1024;
   char rawLine[MAX_LINE];
   char tcoordsName[100];
-  float xyz[3];
   int numPoints = 0;
   int numTCoords = 0;
   int numNormals = 0;
 
-  // First loop to initialize the data arrays for the different set of texture coordinates
+  // First loop to initialize the data arrays for the different set of texture coordinates,
+  // and to parse the coordinates of the vertices and the normals in parallel
   bool readingFirstComment = true;
   std::string firstComment;
   int lineNr = 0;
-  while (everything_ok && fgets(rawLine, MAX_LINE, in) != nullptr)
+  std::vector<float> pointCoords;
+  std::vector<unsigned char> pointsValid;
+  std::vector<float> normalCoords;
+  std::vector<unsigned char> normalsValid;
+  std::string lastMaterial;
+  fseek(in, 0, SEEK_END);
+  long fileLength = ftell(in);
+  fseek(in, 0, SEEK_SET);
+  std::vector<char> block(
+    std::min(vtkOBJBlockSize, static_cast<size_t>(std::max(fileLength, 0L)) + 1));
+  size_t blockLength = 0;
+  bool atEnd = false;
+  while (!atEnd)
   {
-    lineNr++;
-    char *pLine = rawLine;
-    char *pEnd = rawLine + strlen(rawLine);
-
-    // find the first non-whitespace character
-    while (isspace(*pLine) && pLine < pEnd) { pLine++; }
-
-    // this first non-whitespace is the command
-    const char *cmd = pLine;
+    size_t wanted = block.size() - blockLength;
+    blockLength += fread(block.data() + blockLength, 1, wanted, in);
+    atEnd = blockLength < block.size();
+
+    // Parse the whole lines of the block, and keep the rest for the next.
+    const char *text = block.data();
+    const char *textEnd = text + blockLength;
+    if (!atEnd)
+    {
+      while (textEnd > text && textEnd[-1] != '\n') { textEnd--; }
+      if (textEnd == text)
+      {
+        block.resize(2 * block.size());
+        continue;
+      }
+    }
 
-    if (readingFirstComment)
+    for (const char *p = text; readingFirstComment && p < textEnd;)
     {
-      if (cmd[0] == '#')
+      const char *next = std::find(p, textEnd, '\n');
+      next = (next < textEnd) ? next + 1 : next;
+      while (isspace(*p) && p < next) { p++; }
+      if (p < next && *p == '#')
       {
-        cmd++; // skip #
-        while (isspace(*cmd) && cmd < pEnd) { cmd++; } // skip whitespace at comment start
-        firstComment += cmd;
+        p++; // skip #
+        while (isspace(*p) && p < next) { p++; } // skip whitespace at comment start
+        firstComment.append(p, next);
       }
       else
       {
@@ -208,48 +406,70 @@ int vtkOBJReader::RequestData(
         // There may be more comments in the file but we ignore those.
         readingFirstComment = false;
       }
+      p = next;
     }
 
-    // skip over non-whitespace
-    while (!isspace(*pLine) && pLine < pEnd) { pLine++; }
-
-    // terminate command
-    if (pLine < pEnd)
+    std::vector<vtkOBJPiece> pieces;
+    for (const char *p = text; p < textEnd;)
     {
-      *pLine = '\0';
-      pLine++;
+      vtkOBJPiece piece;
+      piece.Begin = p;
+      p += std::min(vtkOBJPieceSize, static_cast<size_t>(textEnd - p));
+      p = std::find(p, textEnd, '\n');
+      p = (p < textEnd) ? p + 1 : p;
+      piece.End = p;
+      pieces.push_back(piece);
     }
+    vtkOBJParsePieces parser;
+    parser.Pieces = pieces.data();
+    vtkSMPTools::For(0, static_cast<vtkIdType>(pieces.size()), parser);
 
-    // if line starts by "usemtl", we're listing a new set of texture coordinates
-    if (strcmp(cmd, "usemtl") == 0)
+    for (size_t i = 0; i < pieces.size(); ++i)
     {
-      // Read name of texture coordinate
-      if (sscanf(pLine, "%s", tcoordsName) == 1)
+      vtkOBJPiece &piece = pieces[i];
+      pointCoords.insert(pointCoords.end(), piece.Points.begin(), piece.Points.end());
+      pointsValid.insert(pointsValid.end(), piece.PointsValid.begin(), piece.PointsValid.end());
+      normalCoords.insert(normalCoords.end(), piece.Normals.begin(), piece.Normals.end());
+      normalsValid.insert(normalsValid.end(), piece.NormalsValid.begin(), piece.NormalsValid.end());
+      for (size_t j = 0; j < piece.TCoords.size(); j += 2)
+      {
+        verticesTextureList.push_back(
+          std::pair<float, float>(piece.TCoords[j], piece.TCoords[j + 1]));
+      }
+
+      // each new material name is a new set of texture coordinates
+      for (size_t j = 0; j < piece.Materials.size(); ++j)
       {
-        if (tcoords_map.find(tcoordsName) == tcoords_map.end())
+        const std::string &name = piece.Materials[j];
+        if (tcoords_map.find(name) == tcoords_map.end())
         {
           vtkFloatArray* tcoords = vtkFloatArray::New();
           tcoords->SetNumberOfComponents(2);
-          tcoords->SetName(tcoordsName);
-          tcoords_map[tcoordsName] = tcoords;
+          tcoords->SetName(name.c_str());
+          tcoords_map[name] = tcoords;
         }
       }
-      else
-      {
-        vtkErrorMacro(<<"Error reading 'usemtl' at line " << lineNr);
-        everything_ok = false;
-      }
-    }
-    else if (strcmp(cmd, "vt") == 0)
-    {
-      // this is a tcoord, expect two floats, separated by whitespace:
-      if (sscanf(pLine, "%f %f", xyz, xyz+1) == 2)
+      if (!piece.Materials.empty())
       {
-        verticesTextureList.push_back(std::pair<float, float>(xyz[0], xyz[1]));
+        lastMaterial = piece.Materials.back();
       }
     }
+
+    blockLength -= textEnd - text;
+    memmove(block.data(), textEnd, blockLength);
   } // (end of first while loop)
 
+  // The second loop checks the coordinates as it counts the lines.
+  points->SetNumberOfPoints(static_cast<vtkIdType>(pointsValid.size()));
+  std::copy(pointCoords.begin(), pointCoords.end(),
+    static_cast<float*>(points->GetVoidPointer(0)));
+  std::vector<float>().swap(pointCoords);
+  normals->SetNumberOfTuples(static_cast<vtkIdType>(normalsValid.size()));
+  std::copy(normalCoords.begin(), normalCoords.end(), normals->GetPointer(0));
+  std::vector<float>().swap(normalCoords);
+  strncpy(tcoordsName, lastMaterial.c_str(), sizeof(tcoordsName) - 1);
+  tcoordsName[sizeof(tcoordsName) - 1] = '\0';
+
   // Comment lines include newline characters.
   // Keep newlines between lines of multi-line comment, but
   // remove the last newline to have a clean string when comment is single-line.
@@ -310,10 +530,9 @@ int vtkOBJReader::RequestData(
     // in the OBJ format the first characters determine how to interpret the line:
     if (strcmp(cmd, "v") == 0)
     {
-      // this is a vertex definition, expect three floats, separated by whitespace:
-      if (sscanf(pLine, "%f %f %f", xyz, xyz+1, xyz+2) == 3)
+      // this is a vertex definition, with three floats parsed by the first loop:
+      if (numPoints < static_cast<int>(pointsValid.size()) && pointsValid[numPoints])
       {
-        points->InsertNextPoint(xyz);
         numPoints++;
       }
       else
@@ -347,10 +566,9 @@ int vtkOBJReader::RequestData(
     }
     else if (strcmp(cmd, "vn") == 0)
     {
-      // this is a normal, expect three floats, separated by whitespace:
-      if (sscanf(pLine, "%f %f %f", xyz, xyz+1, xyz+2) == 3)
+      // this is a normal, with three floats parsed by the first loop:
+      if (numNormals < static_cast<int>(normalsValid.size()) && normalsValid[numNormals])
       {
-        normals->InsertNextTuple(xyz);
         hasNormals = true;
         numNormals++;
       }
@@ -525,7 +743,8 @@ int vtkOBJReader::RequestData(
         if (pLine < pEnd)         // there is still data left on this line
         {
           int iVert,iTCoord,iNormal;
-          if (sscanf(pLine, "%d/%d/%d", &iVert, &iTCoord, &iNormal) == 3)
+          int form = vtkOBJParseFaceVertex(pLine, iVert, iTCoord, iNormal);
+          if (form == vtkOBJVertexTCoordNormal)
           {
             if (iVert < 0)
             {
@@ -570,7 +789,7 @@ int vtkOBJReader::RequestData(
               normals_same_as_verts = false;
             }
           }
-          else if (sscanf(pLine, "%d//%d", &iVert, &iNormal) == 2)
+          else if (form == vtkOBJVertexNormal)
           {
             if (iVert < 0)
             {
@@ -595,7 +814,7 @@ int vtkOBJReader::RequestData(
             if (iNormal != iVert)
               normals_same_as_verts = false;
           }
-          else if (sscanf(pLine, "%d/%d", &iVert, &iTCoord) == 2)
+          else if (form == vtkOBJVertexTCoord)
           {
             if (iVert < 0)
             {
@@ -623,7 +842,7 @@ int vtkOBJReader::RequestData(
               tcoords_same_as_verts = false;
             }
           }
-          else if (sscanf(pLine, "%d", &iVert) == 1)
+          else if (form == vtkOBJVertex)
           {
             if (iVert < 0)
             {
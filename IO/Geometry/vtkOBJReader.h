@@ -18,6 +18,11 @@
  *
  * vtkOBJReader is a source object that reads Wavefront .obj
  * files. The output of this source object is polygonal data.
+ *
+ * The file is read in large blocks of lines. The coordinates of the
+ * vertices, normals and texture coordinates of each block are parsed
+ * concurrently with vtkSMPTools; the faces, lines and points are then
+ * read in order.
  * @sa
  * vtkOBJImporter
 */
@@ -84,6 +84,7 @@
 #include "vtkPolygon.h"
 #include "vtkPyramid.h"
 #include "vtkQuad.h"
+#include "vtkSMPTools.h"
 #include "vtkSortDataArray.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
@@ -109,6 +110,8 @@
 // for isalnum() / isspace() / isdigit()
 #include <cctype>
 
+#include <algorithm>
+#include <map>
 #include <typeinfo>
 #include <vector>
 
@@ -292,6 +295,9 @@ public:
   void SetTimeValue(const double);
   int MakeMetaDataAtTimeStep(vtkStringArray *, vtkStringArray *,
       vtkStringArray *, const bool);
+  // read the metadata files of the current time step into the caches,
+  // without touching the parent, so that readers can do it concurrently
+  void CacheMetaDataAtTimeStep(const bool);
   void SetupInformation(const vtkStdString &, const vtkStdString &,
       const vtkStdString &, vtkOpenFOAMReaderPrivate *);
 
@@ -318,6 +324,24 @@ private:
     vtkStdString TimeDir;
   };
 
+  // the header of an object file in a time directory
+  struct vtkFoamObjectHeader
+  {
+    vtkStdString FileName;
+    vtkStdString ClassName;
+    vtkStdString ObjectName;
+  };
+  typedef std::vector<vtkFoamObjectHeader> vtkFoamObjectHeaders;
+
+  // the patches of a boundary file, before their selection status is set
+  struct vtkFoamBoundaryFile
+  {
+    vtkFoamBoundaryFile() : Found(false), Valid(false) {}
+    bool Found;
+    bool Valid;
+    std::vector<vtkFoamBoundaryEntry> Entries;
+  };
+
   vtkOpenFOAMReader *Parent;
 
   // case and region
@@ -341,6 +365,11 @@ private:
   vtkStringArray *PolyMeshPointsDir;
   vtkStringArray *PolyMeshFacesDir;
 
+  // metadata cache, by directory, kept until the case is refreshed so
+  // that time steps and patch selections do not rescan the case
+  std::map<vtkStdString, vtkFoamObjectHeaders> ObjectHeaders;
+  std::map<vtkStdString, vtkFoamBoundaryFile> BoundaryFiles;
+
   // for mesh construction
   vtkIdType NumCells;
   vtkIdType NumPoints;
@@ -398,6 +427,10 @@ private:
   void AppendMeshDirToArray(vtkStringArray *, const vtkStdString &, const int);
   void PopulatePolyMeshDirArrays();
 
+  // read the metadata files of a directory through the caches
+  const vtkFoamObjectHeaders &GetObjectHeaders(const vtkStdString &);
+  const vtkFoamBoundaryFile &GetBoundaryFile();
+
   // search a time directory for field objects
   void GetFieldNames(const vtkStdString &, const bool, vtkStringArray *,
       vtkStringArray *);
@@ -445,9 +478,12 @@ private:
   vtkFloatArray *FillField(vtkFoamEntry *, vtkIdType, vtkFoamIOobject *,
       const vtkStdString &);
   void GetVolFieldAtTimeStep(vtkUnstructuredGrid *, vtkMultiBlockDataSet *,
-      const vtkStdString &);
+      const vtkStdString &, vtkFoamIOobject *, vtkFoamDict *);
   void GetPointFieldAtTimeStep(vtkUnstructuredGrid *, vtkMultiBlockDataSet *,
-      const vtkStdString &);
+      const vtkStdString &, vtkFoamIOobject *, vtkFoamDict *);
+  void GetFieldsAtTimeStep(vtkUnstructuredGrid *, vtkMultiBlockDataSet *,
+      const bool, const double, const double);
+  friend struct vtkFoamFieldFileReader;
   void AddArrayToFieldData(vtkDataSetAttributes *, vtkDataArray *,
       const vtkStdString &);
 
@@ -1843,12 +1879,10 @@ public:
       this->Superclass::BufPtr += len;
       readlen = len;
     }
-    for (int i = 0; i < readlen; i++)
+    if (readlen > 0)
     {
-      if (buf[i] == '\n')
-      {
-        this->Superclass::LineNumber++;
-      }
+      this->Superclass::LineNumber += static_cast<int>(
+        std::count(buf, buf + readlen, static_cast<unsigned char>('\n')));
     }
     return readlen;
   }
@@ -2609,22 +2643,38 @@ public:
         // Compiler hint for better unrolling:
         VTK_ASSUME(this->Ptr->GetNumberOfComponents() == nComponents);
 
+        // read the tuples in chunks, directly into the list if the file
+        // and the list have the same type, and through a buffer otherwise
         const int tupleLength = sizeof(primitiveT)*nComponents;
-        primitiveT buffer[nComponents];
-        for (int i = 0; i < size; i++)
-        {
-          const int readLength =
-              io.Read(reinterpret_cast<unsigned char *>(buffer), tupleLength);
-          if (readLength != tupleLength)
+        const int chunkSize = (1 << 26) / tupleLength;
+        std::vector<primitiveT> buffer;
+        for (int i = 0; i < size; i += chunkSize)
+        {
+          const int nTuples = std::min(chunkSize, size - i);
+          ListValueType *tuples = this->Ptr->GetPointer(nComponents * i);
+          primitiveT *chunk = reinterpret_cast<primitiveT *>(tuples);
+          if (typeid(ListValueType) != typeid(primitiveT))
           {
-            throw vtkFoamError() << "Failed to read tuple " << i << " of "
+            buffer.resize(static_cast<size_t>(nTuples) * nComponents);
+            chunk = buffer.data();
+          }
+          const int readLength = io.Read(
+            reinterpret_cast<unsigned char *>(chunk), nTuples * tupleLength);
+          if (readLength != nTuples * tupleLength)
+          {
+            const int tupleI = i + std::max(readLength, 0) / tupleLength;
+            throw vtkFoamError() << "Failed to read tuple " << tupleI << " of "
                                  << size << ": Expected " << tupleLength
-                                 << " bytes, got " << readLength << " bytes.";
+                                 << " bytes, got "
+                                 << std::max(readLength, 0) % tupleLength
+                                 << " bytes.";
           }
-          for (int c = 0; c < nComponents; ++c)
+          if (chunk != reinterpret_cast<primitiveT *>(tuples))
           {
-            this->Ptr->SetTypedComponent(i, c,
-                                         static_cast<ListValueType>(buffer[c]));
+            for (int j = 0; j < nTuples * nComponents; ++j)
+            {
+              tuples[j] = static_cast<ListValueType>(chunk[j]);
+            }
           }
         }
       }
@@ -4602,16 +4652,72 @@ void vtkOpenFOAMReaderPrivate::GetFieldNames(const vtkStdString &tempPath,
     const bool isLagrangian, vtkStringArray *cellObjectNames,
     vtkStringArray *pointObjectNames)
 {
+  // loop over all readable files and locate valid fields
+  const vtkFoamObjectHeaders &headers = this->GetObjectHeaders(tempPath);
+  for (size_t j = 0; j < headers.size(); j++)
+  {
+    const vtkStdString &fieldFile = headers[j].FileName;
+    const vtkStdString &cn = headers[j].ClassName;
+    if (isLagrangian)
+    {
+      if (cn == "labelField" || cn == "scalarField" || cn == "vectorField"
+          || cn == "sphericalTensorField" || cn == "symmTensorField" || cn
+          == "tensorField")
+      {
+        // real file name
+        this->LagrangianFieldFiles->InsertNextValue(fieldFile);
+        // object name
+        pointObjectNames->InsertNextValue(headers[j].ObjectName);
+      }
+    }
+    else
+    {
+      if (cn == "volScalarField" || cn == "pointScalarField" || cn
+          == "volVectorField" || cn == "pointVectorField" || cn
+          == "volSphericalTensorField" || cn == "pointSphericalTensorField"
+          || cn == "volSymmTensorField" || cn == "pointSymmTensorField"
+          || cn == "volTensorField" || cn == "pointTensorField")
+      {
+        if (cn.substr(0, 3) == "vol")
+        {
+          // real file name
+          this->VolFieldFiles->InsertNextValue(fieldFile);
+          // object name
+          cellObjectNames->InsertNextValue(headers[j].ObjectName);
+        }
+        else
+        {
+          this->PointFieldFiles->InsertNextValue(fieldFile);
+          pointObjectNames->InsertNextValue(headers[j].ObjectName);
+        }
+      }
+    }
+  }
+  // inserted objects are squeezed later in SortFieldFiles()
+}
+
+//-----------------------------------------------------------------------------
+// read the headers of the object files in a directory, once per directory
+const vtkOpenFOAMReaderPrivate::vtkFoamObjectHeaders &
+vtkOpenFOAMReaderPrivate::GetObjectHeaders(const vtkStdString &tempPath)
+{
+  std::map<vtkStdString, vtkFoamObjectHeaders>::iterator it
+      = this->ObjectHeaders.find(tempPath);
+  if (it != this->ObjectHeaders.end())
+  {
+    return it->second;
+  }
+  vtkFoamObjectHeaders &headers = this->ObjectHeaders[tempPath];
+
   // open the directory and get num of files
   vtkDirectory *directory = vtkDirectory::New();
   if (!directory->Open(tempPath.c_str()))
   {
     // no data
     directory->Delete();
-    return;
+    return headers;
   }
 
-  // loop over all files and locate valid fields
   vtkIdType nFieldFiles = directory->GetNumberOfFiles();
   for (vtkIdType j = 0; j < nFieldFiles; j++)
   {
@@ -4627,47 +4733,119 @@ void vtkOpenFOAMReaderPrivate::GetFieldNames(const vtkStdString &tempPath,
       vtkFoamIOobject io(this->CasePath, this->Parent);
       if (io.Open(tempPath + "/" + fieldFile)) // file exists and readable
       {
-        const vtkStdString& cn = io.GetClassName();
-        if (isLagrangian)
-        {
-          if (cn == "labelField" || cn == "scalarField" || cn == "vectorField"
-              || cn == "sphericalTensorField" || cn == "symmTensorField" || cn
-              == "tensorField")
-          {
-            // real file name
-            this->LagrangianFieldFiles->InsertNextValue(fieldFile);
-            // object name
-            pointObjectNames->InsertNextValue(io.GetObjectName());
-          }
-        }
-        else
-        {
-          if (cn == "volScalarField" || cn == "pointScalarField" || cn
-              == "volVectorField" || cn == "pointVectorField" || cn
-              == "volSphericalTensorField" || cn == "pointSphericalTensorField"
-              || cn == "volSymmTensorField" || cn == "pointSymmTensorField"
-              || cn == "volTensorField" || cn == "pointTensorField")
-          {
-            if (cn.substr(0, 3) == "vol")
-            {
-              // real file name
-              this->VolFieldFiles->InsertNextValue(fieldFile);
-              // object name
-              cellObjectNames->InsertNextValue(io.GetObjectName());
-            }
-            else
-            {
-              this->PointFieldFiles->InsertNextValue(fieldFile);
-              pointObjectNames->InsertNextValue(io.GetObjectName());
-            }
-          }
-        }
+        vtkFoamObjectHeader header;
+        header.FileName = fieldFile;
+        header.ClassName = io.GetClassName();
+        header.ObjectName = io.GetObjectName();
+        headers.push_back(header);
         io.Close();
       }
     }
   }
-  // inserted objects are squeezed later in SortFieldFiles()
   directory->Delete();
+  return headers;
+}
+
+//-----------------------------------------------------------------------------
+// read the patches of the boundary file of the current time step, once per
+// polyMesh directory
+const vtkOpenFOAMReaderPrivate::vtkFoamBoundaryFile &
+vtkOpenFOAMReaderPrivate::GetBoundaryFile()
+{
+  const vtkStdString meshPath(
+      this->CurrentTimeRegionMeshPath(this->PolyMeshFacesDir));
+  std::map<vtkStdString, vtkFoamBoundaryFile>::iterator it
+      = this->BoundaryFiles.find(meshPath);
+  if (it != this->BoundaryFiles.end())
+  {
+    return it->second;
+  }
+  vtkFoamBoundaryFile &boundaryFile = this->BoundaryFiles[meshPath];
+
+  const bool isSubRegion = !this->RegionName.empty();
+  vtkFoamDict *boundaryDict = this->GatherBlocks("boundary", isSubRegion);
+  if (boundaryDict == nullptr)
+  {
+    return boundaryFile;
+  }
+  boundaryFile.Found = true;
+
+  // iterate through each entry in the boundary file
+  vtkTypeInt64 allBoundariesNextStartFace = 0;
+  boundaryFile.Entries.resize(boundaryDict->size());
+  for (size_t i = 0; i < boundaryDict->size(); i++)
+  {
+    vtkFoamEntry *boundaryEntryI = boundaryDict->operator[](i);
+    const vtkFoamEntry *nFacesEntry = boundaryEntryI->Dictionary().Lookup("nFaces");
+    if (nFacesEntry == nullptr)
+    {
+      vtkErrorMacro(<< "nFaces entry not found in boundary entry "
+          << boundaryEntryI->GetKeyword().c_str());
+      delete boundaryDict;
+      return boundaryFile;
+    }
+    vtkTypeInt64 nFaces = nFacesEntry->ToInt();
+
+    // create BoundaryDict entry
+    vtkFoamBoundaryEntry &BoundaryEntryI = boundaryFile.Entries[i];
+    BoundaryEntryI.NFaces = nFaces;
+    BoundaryEntryI.BoundaryName = boundaryEntryI->GetKeyword();
+    const vtkFoamEntry *startFaceEntry = boundaryEntryI->Dictionary().Lookup("startFace");
+    if (startFaceEntry == nullptr)
+    {
+      vtkErrorMacro(<< "startFace entry not found in boundary entry "
+          << boundaryEntryI->GetKeyword().c_str());
+      delete boundaryDict;
+      return boundaryFile;
+    }
+    BoundaryEntryI.StartFace = startFaceEntry->ToInt();
+    const vtkFoamEntry *typeEntry = boundaryEntryI->Dictionary().Lookup("type");
+    if (typeEntry == nullptr)
+    {
+      vtkErrorMacro(<< "type entry not found in boundary entry "
+          << boundaryEntryI->GetKeyword().c_str());
+      delete boundaryDict;
+      return boundaryFile;
+    }
+    BoundaryEntryI.AllBoundariesStartFace = allBoundariesNextStartFace;
+    const vtkStdString typeNameI(typeEntry->ToString());
+    // if the basic type of the patch is one of the followings the
+    // point-filtered values at patches are overridden by patch values
+    if (typeNameI == "patch" || typeNameI == "wall")
+    {
+      BoundaryEntryI.BoundaryType = vtkFoamBoundaryEntry::PHYSICAL;
+      allBoundariesNextStartFace += nFaces;
+    }
+    else if (typeNameI == "processor")
+    {
+      BoundaryEntryI.BoundaryType = vtkFoamBoundaryEntry::PROCESSOR;
+      allBoundariesNextStartFace += nFaces;
+    }
+    else
+    {
+      BoundaryEntryI.BoundaryType = vtkFoamBoundaryEntry::GEOMETRICAL;
+    }
+    BoundaryEntryI.IsActive = false;
+  }
+  boundaryFile.Valid = true;
+
+  delete boundaryDict;
+  return boundaryFile;
+}
+
+//-----------------------------------------------------------------------------
+// read the boundary file and the field headers that
+// MakeMetaDataAtTimeStep() will need into the caches
+void vtkOpenFOAMReaderPrivate::CacheMetaDataAtTimeStep(
+    const bool listNextTimeStep)
+{
+  this->GetBoundaryFile();
+  this->GetObjectHeaders(this->CurrentTimePath() + this->RegionPath());
+  if (listNextTimeStep && this->TimeValues->GetNumberOfTuples() >= 2
+      && this->TimeStep == 0)
+  {
+    this->GetObjectHeaders(this->TimePath(1) + this->RegionPath());
+  }
 }
 
 //-----------------------------------------------------------------------------
@@ -4768,11 +4946,10 @@ int vtkOpenFOAMReaderPrivate::MakeMetaDataAtTimeStep(
     this->BoundaryDict.TimeDir
         = this->PolyMeshFacesDir->GetValue(this->TimeStep);
 
-    const bool isSubRegion = !this->RegionName.empty();
-    vtkFoamDict *boundaryDict = this->GatherBlocks("boundary", isSubRegion);
-    if (boundaryDict == nullptr)
+    const vtkFoamBoundaryFile &boundaryFile = this->GetBoundaryFile();
+    if (!boundaryFile.Found)
     {
-      if (isSubRegion)
+      if (!this->RegionName.empty())
       {
         return 0;
       }
@@ -4785,66 +4962,16 @@ int vtkOpenFOAMReaderPrivate::MakeMetaDataAtTimeStep(
       this->Parent->PatchDataArraySelection->AddArray(internalMeshName.c_str());
       this->InternalMeshSelectionStatus
           = this->Parent->GetPatchArrayStatus(internalMeshName.c_str());
-
-      // iterate through each entry in the boundary file
-      vtkTypeInt64 allBoundariesNextStartFace = 0;
-      this->BoundaryDict.resize(boundaryDict->size());
-      for (size_t i = 0; i < boundaryDict->size(); i++)
+      if (!boundaryFile.Valid)
       {
-        vtkFoamEntry *boundaryEntryI = boundaryDict->operator[](i);
-        const vtkFoamEntry *nFacesEntry = boundaryEntryI->Dictionary().Lookup("nFaces");
-        if (nFacesEntry == nullptr)
-        {
-          vtkErrorMacro(<< "nFaces entry not found in boundary entry "
-              << boundaryEntryI->GetKeyword().c_str());
-          delete boundaryDict;
-          return 0;
-        }
-        vtkTypeInt64 nFaces = nFacesEntry->ToInt();
-
-        // extract name of the current patch for insertion
-        const vtkStdString &boundaryNameI = boundaryEntryI->GetKeyword();
+        return 0;
+      }
 
-        // create BoundaryDict entry
+      this->BoundaryDict.assign(boundaryFile.Entries.begin(),
+          boundaryFile.Entries.end());
+      for (size_t i = 0; i < this->BoundaryDict.size(); i++)
+      {
         vtkFoamBoundaryEntry &BoundaryEntryI = this->BoundaryDict[i];
-        BoundaryEntryI.NFaces = nFaces;
-        BoundaryEntryI.BoundaryName = boundaryNameI;
-        const vtkFoamEntry *startFaceEntry = boundaryEntryI->Dictionary().Lookup("startFace");
-        if (startFaceEntry == nullptr)
-        {
-          vtkErrorMacro(<< "startFace entry not found in boundary entry "
-              << boundaryEntryI->GetKeyword().c_str());
-          delete boundaryDict;
-          return 0;
-        }
-        BoundaryEntryI.StartFace = startFaceEntry->ToInt();
-        const vtkFoamEntry *typeEntry = boundaryEntryI->Dictionary().Lookup("type");
-        if (typeEntry == nullptr)
-        {
-          vtkErrorMacro(<< "type entry not found in boundary entry "
-              << boundaryEntryI->GetKeyword().c_str());
-          delete boundaryDict;
-          return 0;
-        }
-        BoundaryEntryI.AllBoundariesStartFace = allBoundariesNextStartFace;
-        const vtkStdString typeNameI(typeEntry->ToString());
-        // if the basic type of the patch is one of the followings the
-        // point-filtered values at patches are overridden by patch values
-        if (typeNameI == "patch" || typeNameI == "wall")
-        {
-          BoundaryEntryI.BoundaryType = vtkFoamBoundaryEntry::PHYSICAL;
-          allBoundariesNextStartFace += nFaces;
-        }
-        else if (typeNameI == "processor")
-        {
-          BoundaryEntryI.BoundaryType = vtkFoamBoundaryEntry::PROCESSOR;
-          allBoundariesNextStartFace += nFaces;
-        }
-        else
-        {
-          BoundaryEntryI.BoundaryType = vtkFoamBoundaryEntry::GEOMETRICAL;
-        }
-        BoundaryEntryI.IsActive = false;
 
         // always hide processor patches for decomposed cases to keep
         // vtkAppendCompositeDataLeaves happy
@@ -4853,7 +4980,8 @@ int vtkOpenFOAMReaderPrivate::MakeMetaDataAtTimeStep(
         {
           continue;
         }
-        const vtkStdString selectionName(this->RegionPrefix() + boundaryNameI);
+        const vtkStdString selectionName(this->RegionPrefix()
+            + BoundaryEntryI.BoundaryName);
         if (this->Parent->PatchDataArraySelection->
         ArrayExists(selectionName.c_str()))
         {
@@ -4870,8 +4998,6 @@ int vtkOpenFOAMReaderPrivate::MakeMetaDataAtTimeStep(
           this->Parent->PatchDataArraySelection->DisableArray(selectionName.c_str());
         }
       }
-
-      delete boundaryDict;
     }
   }
 
@@ -7739,19 +7865,95 @@ void vtkOpenFOAMReaderPrivate::ConstructDimensions(vtkStdString *dimString,
   }
 }
 
+//-----------------------------------------------------------------------------
+// reads a batch of field files into dictionaries concurrently; a file that
+// is not selected or cannot be read leaves a null dictionary
+struct vtkFoamFieldFileReader
+{
+  vtkOpenFOAMReaderPrivate *Reader;
+  vtkStringArray *Files;
+  vtkDataArraySelection *Selection;
+  vtkIdType First;
+  std::vector<vtkFoamIOobject *> *IOs;
+  std::vector<vtkFoamDict *> *Dicts;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      vtkFoamIOobject *io
+          = new vtkFoamIOobject(this->Reader->CasePath, this->Reader->Parent);
+      vtkFoamDict *dict = new vtkFoamDict;
+      if (!this->Reader->ReadFieldFile(io, dict,
+          this->Files->GetValue(this->First + i), this->Selection))
+      {
+        delete dict;
+        dict = nullptr;
+      }
+      (*this->IOs)[i] = io;
+      (*this->Dicts)[i] = dict;
+    }
+  }
+};
+
+//-----------------------------------------------------------------------------
+// read the selected vol or point fields into the meshes. The field files are
+// parsed in batches of one file per thread, and the parsed fields of each
+// batch are then added to the meshes in order.
+void vtkOpenFOAMReaderPrivate::GetFieldsAtTimeStep(
+    vtkUnstructuredGrid *internalMesh, vtkMultiBlockDataSet *boundaryMesh,
+    const bool pointFields, const double progressStart,
+    const double progressRange)
+{
+  vtkFoamFieldFileReader reader;
+  reader.Reader = this;
+  reader.Files = pointFields ? this->PointFieldFiles : this->VolFieldFiles;
+  reader.Selection = pointFields ? this->Parent->PointDataArraySelection
+      : this->Parent->CellDataArraySelection;
+  const vtkIdType nFiles = reader.Files->GetNumberOfValues();
+  const vtkIdType batchSize
+      = std::max(vtkSMPTools::GetEstimatedNumberOfThreads(), 1);
+  std::vector<vtkFoamIOobject *> ios(batchSize);
+  std::vector<vtkFoamDict *> dicts(batchSize);
+  reader.IOs = &ios;
+  reader.Dicts = &dicts;
+  for (vtkIdType first = 0; first < nFiles; first += batchSize)
+  {
+    const vtkIdType n = std::min(batchSize, nFiles - first);
+    reader.First = first;
+    vtkSMPTools::For(0, n, 1, reader);
+    for (vtkIdType i = 0; i < n; i++)
+    {
+      if (dicts[i] != nullptr)
+      {
+        const vtkStdString &varName = reader.Files->GetValue(first + i);
+        if (pointFields)
+        {
+          this->GetPointFieldAtTimeStep(internalMesh, boundaryMesh, varName,
+              ios[i], dicts[i]);
+        }
+        else
+        {
+          this->GetVolFieldAtTimeStep(internalMesh, boundaryMesh, varName,
+              ios[i], dicts[i]);
+        }
+        delete dicts[i];
+      }
+      delete ios[i];
+      this->Parent->UpdateProgress(progressStart + progressRange
+          * ((float)(first + i + 1) / ((float)nFiles + 0.0001)));
+    }
+  }
+}
+
 //-----------------------------------------------------------------------------
 void vtkOpenFOAMReaderPrivate::GetVolFieldAtTimeStep(
     vtkUnstructuredGrid *internalMesh, vtkMultiBlockDataSet *boundaryMesh,
-    const vtkStdString &varName)
+    const vtkStdString &varName, vtkFoamIOobject *ioPtr, vtkFoamDict *dictPtr)
 {
   bool use64BitLabels = this->Parent->GetUse64BitLabels();
-  vtkFoamIOobject io(this->CasePath, this->Parent);
-  vtkFoamDict dict;
-  if (!this->ReadFieldFile(&io, &dict, varName,
-      this->Parent->CellDataArraySelection))
-  {
-    return;
-  }
+  vtkFoamIOobject &io = *ioPtr;
+  vtkFoamDict &dict = *dictPtr;
 
   if (io.GetClassName().substr(0, 3) != "vol")
   {
@@ -8101,16 +8303,11 @@ void vtkOpenFOAMReaderPrivate::GetVolFieldAtTimeStep(
 // read point field at a timestep
 void vtkOpenFOAMReaderPrivate::GetPointFieldAtTimeStep(
     vtkUnstructuredGrid *internalMesh, vtkMultiBlockDataSet *boundaryMesh,
-    const vtkStdString &varName)
+    const vtkStdString &varName, vtkFoamIOobject *ioPtr, vtkFoamDict *dictPtr)
 {
   bool use64BitLabels = this->Parent->GetUse64BitLabels();
-  vtkFoamIOobject io(this->CasePath, this->Parent);
-  vtkFoamDict dict;
-  if (!this->ReadFieldFile(&io, &dict, varName,
-      this->Parent->PointDataArraySelection))
-  {
-    return;
-  }
+  vtkFoamIOobject &io = *ioPtr;
+  vtkFoamDict &dict = *dictPtr;
 
   if (io.GetClassName().substr(0, 5) != "point")
   {
@@ -9026,20 +9223,10 @@ int vtkOpenFOAMReaderPrivate::RequestData(vtkMultiBlockDataSet *output,
         }
       }
       // read field data variables into Internal/Boundary meshes
-      for (int i = 0; i < (int)this->VolFieldFiles->GetNumberOfValues(); i++)
-      {
-        this->GetVolFieldAtTimeStep(this->InternalMesh, this->BoundaryMesh,
-            this->VolFieldFiles->GetValue(i));
-        this->Parent->UpdateProgress(0.5 + 0.25 * ((float)(i + 1)
-            / ((float)this->VolFieldFiles->GetNumberOfValues() + 0.0001)));
-      }
-      for (int i = 0; i < (int)this->PointFieldFiles->GetNumberOfValues(); i++)
-      {
-        this->GetPointFieldAtTimeStep(this->InternalMesh, this->BoundaryMesh,
-            this->PointFieldFiles->GetValue(i));
-        this->Parent->UpdateProgress(0.75 + 0.125 * ((float)(i + 1)
-            / ((float)this->PointFieldFiles->GetNumberOfValues() + 0.0001)));
-      }
+      this->GetFieldsAtTimeStep(this->InternalMesh, this->BoundaryMesh,
+          false, 0.5, 0.25);
+      this->GetFieldsAtTimeStep(this->InternalMesh, this->BoundaryMesh,
+          true, 0.75, 0.125);
     }
     // read lagrangian mesh and fields
     lagrangianMesh = this->MakeLagrangianMesh();
@@ -9220,6 +9407,7 @@ vtkOpenFOAMReader::vtkOpenFOAMReader()
 
   this->CurrentReaderIndex = 0;
   this->NumberOfReaders = 0;
+  this->ReadingConcurrently = false;
   this->Use64BitLabels = false;
   this->Use64BitFloats = true;
   this->Use64BitLabelsOld = false;
@@ -9733,6 +9921,19 @@ int vtkOpenFOAMReader::MakeMetaDataAtTimeStep(const bool listNextTimeStep)
   return ret;
 }
 
+//-----------------------------------------------------------------------------
+void vtkOpenFOAMReader::CacheMetaDataAtTimeStep(const bool listNextTimeStep)
+{
+  vtkOpenFOAMReaderPrivate *reader;
+  this->Readers->InitTraversal();
+  while ((reader
+      = vtkOpenFOAMReaderPrivate::SafeDownCast(this->Readers->GetNextItemAsObject()))
+      != nullptr)
+  {
+    reader->CacheMetaDataAtTimeStep(listNextTimeStep);
+  }
+}
+
 //-----------------------------------------------------------------------------
 void vtkOpenFOAMReader::CreateCharArrayFromString(vtkCharArray *array,
     const char *name, vtkStdString &string)
@@ -9768,6 +9969,10 @@ void vtkOpenFOAMReader::UpdateStatus()
 //-----------------------------------------------------------------------------
 void vtkOpenFOAMReader::UpdateProgress(double amount)
 {
+  if (this->ReadingConcurrently)
+  {
+    return;
+  }
   this->vtkAlgorithm::UpdateProgress((static_cast<double>(this->Parent->CurrentReaderIndex)
       + amount) / static_cast<double>(this->Parent->NumberOfReaders));
 }
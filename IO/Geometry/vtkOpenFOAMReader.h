@@ -40,6 +40,10 @@
  *
  * Misc cleanup, bugfixes, improvements
  * Mark Olesen (OpenCFD Ltd.)
+ *
+ * The headers of the field files and the patches of the boundary files
+ * are cached per directory until the case is refreshed, and the selected
+ * field files of a time step are parsed concurrently with vtkSMPTools.
 */
 
 #ifndef vtkOpenFOAMReader_h
@@ -47,6 +51,7 @@
 
 #include "vtkIOGeometryModule.h" // For export macro
 #include "vtkMultiBlockDataSetAlgorithm.h"
+#include "vtkAtomicTypes.h" // For vtkAtomicInt32
 
 class vtkCollection;
 class vtkCharArray;
@@ -318,6 +323,14 @@ public:
   vtkDoubleArray *GetTimeValues();
   int MakeMetaDataAtTimeStep(const bool);
 
+  /**
+   * Read the boundary files and field headers that MakeMetaDataAtTimeStep()
+   * needs at the current time step into the cache. Unlike
+   * MakeMetaDataAtTimeStep() this does not modify the parent reader, so
+   * vtkPOpenFOAMReader calls it for all of its readers concurrently.
+   */
+  void CacheMetaDataAtTimeStep(const bool);
+
   friend class vtkOpenFOAMReaderPrivate;
 
 protected:
@@ -391,9 +404,12 @@ protected:
   vtkStringArray *LagrangianPaths;
 
   // number of reader instances
-  int NumberOfReaders;
+  vtkAtomicInt32 NumberOfReaders;
   // index of the active reader
-  int CurrentReaderIndex;
+  vtkAtomicInt32 CurrentReaderIndex;
+  // true while the reader instances execute concurrently, which
+  // suppresses the progress events of the parent
+  bool ReadingConcurrently;
 
   vtkOpenFOAMReader();
   ~vtkOpenFOAMReader() override;
@@ -26,13 +26,17 @@
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
 #include <algorithm>
 #include <cctype>
 #include <cstdlib>
+#include <cstring>
 #include <string>
+#include <utility>
+#include <vector>
 #include <vtksys/SystemTools.hxx>
 
 vtkStandardNewMacro(vtkSTLReader);
@@ -43,6 +47,165 @@ vtkStandardNewMacro(vtkSTLReader);
 vtkCxxSetObjectMacro(vtkSTLReader, Locator, vtkIncrementalPointLocator);
 vtkCxxSetObjectMacro(vtkSTLReader, BinaryHeader, vtkUnsignedCharArray);
 
+namespace
+{
+// A binary facet is a normal and three vertices as little endian floats,
+// followed by a 2 byte attribute byte count.
+const size_t vtkSTLFacetSize = 50;
+const vtkIdType vtkSTLFacetsPerBatch = 65536;
+
+// Copy the vertices of a batch of binary facets into the points and make
+// a triangle of each.
+struct vtkSTLDecodeFacets
+{
+  const unsigned char *Facets;
+  float *Points;
+  vtkIdType *Cells;
+  vtkIdType FirstPoint;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      float *x = this->Points + 9 * i;
+      memcpy(x, this->Facets + vtkSTLFacetSize * i + 12, 9 * sizeof(float));
+      vtkByteSwap::Swap4LERange(x, 9);
+
+      vtkIdType *cell = this->Cells + 4 * i;
+      vtkIdType ptId = this->FirstPoint + 3 * i;
+      cell[0] = 3;
+      cell[1] = ptId;
+      cell[2] = ptId + 1;
+      cell[3] = ptId + 2;
+    }
+  }
+};
+
+// Hash the coordinates of a point, with -0 equal to 0 as for vtkMergePoints.
+inline vtkTypeUInt64 vtkSTLHashPoint(const float *x)
+{
+  vtkTypeUInt64 hash = 14695981039346656037ull;
+  for (int i = 0; i < 3; ++i)
+  {
+    float c = (x[i] == 0.0f) ? 0.0f : x[i];
+    vtkTypeUInt32 bits;
+    memcpy(&bits, &c, sizeof(bits));
+    hash = (hash ^ bits) * 1099511628211ull;
+    hash ^= hash >> 29;
+  }
+  return hash;
+}
+
+// Hash the vertices of the triangles.
+struct vtkSTLHashVertices
+{
+  const float *Points;
+  const vtkIdType *Cells;
+  std::pair<vtkTypeUInt64, vtkIdType> *Hashes;
+
+  const float *GetPoint(vtkIdType vertex) const
+  {
+    return this->Points + 3 * this->Cells[4 * (vertex / 3) + 1 + vertex % 3];
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      this->Hashes[i] = std::make_pair(vtkSTLHashPoint(this->GetPoint(i)), i);
+    }
+  }
+};
+
+// Merge coincident points the way vtkMergePoints does when inserting the
+// triangle vertices in order, but by hashing and sorting the vertices in
+// parallel instead of inserting them one at a time.  Triangles that collapse are
+// removed.
+void vtkSTLMergeTriangles(vtkPoints *newPts, vtkCellArray *newPolys,
+  vtkFloatArray *newScalars, vtkPoints *mergedPts, vtkCellArray *mergedPolys,
+  vtkFloatArray *mergedScalars)
+{
+  const float *coords = static_cast<const float*>(newPts->GetVoidPointer(0));
+  const vtkIdType *cells = newPolys->GetPointer();
+  vtkIdType numTris = newPolys->GetNumberOfCells();
+  vtkIdType numVerts = 3 * numTris;
+
+  // Sort the vertices by the hash of their point, then by their position.
+  std::vector<std::pair<vtkTypeUInt64, vtkIdType> > hashes(numVerts);
+  vtkSTLHashVertices hasher;
+  hasher.Points = coords;
+  hasher.Cells = cells;
+  hasher.Hashes = hashes.data();
+  vtkSMPTools::For(0, numVerts, hasher);
+  vtkSMPTools::Sort(hashes.begin(), hashes.end());
+
+  // Within a run of equal hashes, a vertex takes the first vertex with an
+  // equal point, which is the first inserted.
+  std::vector<vtkIdType> ids(numVerts);
+  for (vtkIdType begin = 0, end; begin < numVerts; begin = end)
+  {
+    for (end = begin + 1;
+         end < numVerts && hashes[end].first == hashes[begin].first; ++end)
+    {
+    }
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      vtkIdType vertex = hashes[i].second;
+      const float *x = hasher.GetPoint(vertex);
+      ids[vertex] = vertex;
+      for (vtkIdType j = begin; j < i; ++j)
+      {
+        const float *y = hasher.GetPoint(hashes[j].second);
+        if (x[0] == y[0] && x[1] == y[1] && x[2] == y[2])
+        {
+          ids[vertex] = ids[hashes[j].second];
+          break;
+        }
+      }
+    }
+  }
+  std::vector<std::pair<vtkTypeUInt64, vtkIdType> >().swap(hashes);
+
+  // Number the points in the order they are first inserted, and keep the
+  // coordinates of the first, as for -0 and 0 they may differ.
+  mergedPts->SetNumberOfPoints(numVerts);
+  float *merged = static_cast<float*>(mergedPts->GetVoidPointer(0));
+  vtkIdType numPts = 0;
+  for (vtkIdType i = 0; i < numVerts; ++i)
+  {
+    if (ids[i] == i)
+    {
+      memcpy(merged + 3 * numPts, hasher.GetPoint(i), 3 * sizeof(float));
+      ids[i] = numPts++;
+    }
+    else
+    {
+      ids[i] = ids[ids[i]];
+    }
+  }
+  mergedPts->SetNumberOfPoints(numPts);
+
+  vtkIdType *mergedCells = mergedPolys->WritePointer(numTris, 4 * numTris);
+  vtkIdType numMerged = 0;
+  for (vtkIdType i = 0; i < numTris; ++i)
+  {
+    const vtkIdType *nodes = &ids[3 * i];
+    if (nodes[0] != nodes[1] && nodes[0] != nodes[2] && nodes[1] != nodes[2])
+    {
+      vtkIdType *cell = mergedCells + 4 * numMerged++;
+      cell[0] = 3;
+      std::copy(nodes, nodes + 3, cell + 1);
+      if (newScalars)
+      {
+        mergedScalars->InsertNextValue(newScalars->GetValue(i));
+      }
+    }
+  }
+  mergedPolys->WritePointer(numMerged, 4 * numMerged);
+  mergedPolys->GetData()->SetNumberOfValues(4 * numMerged);
+}
+}
+
 //------------------------------------------------------------------------------
 // Construct object with merging set to true.
 vtkSTLReader::vtkSTLReader()
@@ -187,37 +350,43 @@ int vtkSTLReader::RequestData(
       mergedScalars->Allocate(newPolys->GetSize());
     }
 
-    vtkSmartPointer<vtkIncrementalPointLocator> locator = this->Locator;
     if (this->Locator == nullptr)
     {
-      locator.TakeReference(this->NewDefaultLocator());
+      // Without a locator, points are merged exactly as the default
+      // vtkMergePoints would, by sorting them.
+      vtkSTLMergeTriangles(newPts, newPolys, newScalars,
+        mergedPts, mergedPolys, mergedScalars);
     }
-    locator->InitPointInsertion(mergedPts, newPts->GetBounds());
-
-    int nextCell = 0;
-    vtkIdType *pts = nullptr;
-    vtkIdType npts;
-    for (newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts);)
+    else
     {
-      vtkIdType nodes[3];
-      for (int i = 0; i < 3; i++)
-      {
-        double x[3];
-        newPts->GetPoint(pts[i], x);
-        locator->InsertUniquePoint(x, nodes[i]);
-      }
+      vtkIncrementalPointLocator *locator = this->Locator;
+      locator->InitPointInsertion(mergedPts, newPts->GetBounds());
 
-      if (nodes[0] != nodes[1] &&
-        nodes[0] != nodes[2] &&
-        nodes[1] != nodes[2])
+      int nextCell = 0;
+      vtkIdType *pts = nullptr;
+      vtkIdType npts;
+      for (newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts);)
       {
-        mergedPolys->InsertNextCell(3, nodes);
-        if (newScalars)
+        vtkIdType nodes[3];
+        for (int i = 0; i < 3; i++)
+        {
+          double x[3];
+          newPts->GetPoint(pts[i], x);
+          locator->InsertUniquePoint(x, nodes[i]);
+        }
+
+        if (nodes[0] != nodes[1] &&
+          nodes[0] != nodes[2] &&
+          nodes[1] != nodes[2])
         {
-          mergedScalars->InsertNextValue(newScalars->GetValue(nextCell));
+          mergedPolys->InsertNextCell(3, nodes);
+          if (newScalars)
+          {
+            mergedScalars->InsertNextValue(newScalars->GetValue(nextCell));
+          }
         }
+        nextCell++;
       }
-      nextCell++;
     }
 
     if (newScalars)
@@ -231,10 +400,16 @@ int vtkSTLReader::RequestData(
   }
 
   output->SetPoints(mergedPts);
-  mergedPts->Delete();
+  if (mergedPts != newPts.Get())
+  {
+    mergedPts->Delete();
+  }
 
   output->SetPolys(mergedPolys);
-  mergedPolys->Delete();
+  if (mergedPolys != newPolys.Get())
+  {
+    mergedPolys->Delete();
+  }
 
   if (mergedScalars)
   {
@@ -257,8 +432,6 @@ int vtkSTLReader::RequestData(
 bool vtkSTLReader::ReadBinarySTL(FILE *fp, vtkPoints *newPts,
                                  vtkCellArray *newPolys)
 {
-  typedef struct { float  n[3], v1[3], v2[3], v3[3]; } facet_t;
-
   vtkDebugMacro(<< "Reading BINARY STL file");
 
   //  File is read to obtain raw information as well as bounding box
@@ -281,7 +454,7 @@ bool vtkSTLReader::ReadBinarySTL(FILE *fp, vtkPoints *newPts,
   // Remove extra zero termination from binary header
   this->BinaryHeader->Resize(headerSize);
 
-  unsigned long ulint;
+  vtkTypeUInt32 ulint;
   if (fread(&ulint, 1, 4, fp) != 4)
   {
     vtkErrorMacro("STLReader error reading file: " << this->FileName
@@ -290,69 +463,70 @@ bool vtkSTLReader::ReadBinarySTL(FILE *fp, vtkPoints *newPts,
   }
   vtkByteSwap::Swap4LE(&ulint);
 
-  // Many .stl files contain bogus count.  Hence we will ignore and read
-  //   until end of file.
-  //
-  int numTris = static_cast<int>(ulint);
-  if (numTris <= 0)
+  // Many .stl files contain bogus count.  Hence we will ignore it and read
+  // the facets the length of the file holds, including a last partial one
+  // so that a truncated file is reported.
+  vtkIdType numTris = static_cast<vtkIdType>(ulint);
+  vtkTypeUInt64 fileLength = vtksys::SystemTools::FileLength(this->FileName);
+  fileLength -= std::min<vtkTypeUInt64>(fileLength, 80 + 4); // 80 byte - header, 4 byte - triangle count
+  // 50 byte - twelve 32-bit-floating point numbers + 2 byte for attribute byte count
+  vtkIdType fileTris = static_cast<vtkIdType>((fileLength + vtkSTLFacetSize - 1) / vtkSTLFacetSize);
+  if (numTris != fileTris)
   {
     vtkDebugMacro(<< "Bad binary count: attempting to correct("
       << numTris << ")");
   }
-
-  // Verify the numTris with the length of the file
-  unsigned long ulFileLength = vtksys::SystemTools::FileLength(this->FileName);
-  ulFileLength -= (80 + 4); // 80 byte - header, 4 byte - tringle count
-  ulFileLength /= 50;       // 50 byte - twelve 32-bit-floating point numbers + 2 byte for attribute byte count
-
-  if (numTris < static_cast<int>(ulFileLength))
+  numTris = fileTris;
+
+  // Read the facets in batches and decode each batch in parallel, directly
+  // into the points and the cells.
+  newPts->SetNumberOfPoints(3 * numTris);
+  vtkIdType *cells = newPolys->WritePointer(numTris, 4 * numTris);
+  float *coords = static_cast<float*>(newPts->GetVoidPointer(0));
+
+  std::vector<unsigned char> batch(vtkSTLFacetSize * vtkSTLFacetsPerBatch);
+  vtkIdType numRead = 0;
+  bool premature = false;
+  while (numRead < numTris)
   {
-    numTris = static_cast<int>(ulFileLength);
-  }
-
-  // now we can allocate the memory we need for this STL file
-  newPts->Allocate(numTris * 3);
-  newPolys->Allocate(numTris);
-
-  facet_t facet;
-  for (int i = 0; fread(&facet, 48, 1, fp) > 0; i++)
-  {
-    unsigned short ibuff2;
-    if (fread(&ibuff2, 2, 1, fp) != 1) //read extra junk
+    size_t wanted = static_cast<size_t>(std::min(numTris - numRead,
+      vtkSTLFacetsPerBatch)) * vtkSTLFacetSize;
+    size_t got = fread(batch.data(), 1, wanted, fp);
+
+    vtkSTLDecodeFacets decoder;
+    decoder.Facets = batch.data();
+    decoder.Points = coords + 9 * numRead;
+    decoder.Cells = cells + 4 * numRead;
+    decoder.FirstPoint = 3 * numRead;
+    vtkIdType numFacets = static_cast<vtkIdType>(got / vtkSTLFacetSize);
+    vtkSMPTools::For(0, numFacets, decoder);
+    numRead += numFacets;
+
+    if (got < wanted)
     {
-      vtkErrorMacro("STLReader error reading file: " << this->FileName
-        << " Premature EOF while reading extra junk.");
-      return false;
+      // A trailing facet without its attribute byte count is an error,
+      // anything shorter is ignored.
+      premature = (got % vtkSTLFacetSize) >= 48;
+      break;
     }
 
-    vtkByteSwap::Swap4LE(facet.n);
-    vtkByteSwap::Swap4LE(facet.n+1);
-    vtkByteSwap::Swap4LE(facet.n+2);
-
-    vtkByteSwap::Swap4LE(facet.v1);
-    vtkByteSwap::Swap4LE(facet.v1+1);
-    vtkByteSwap::Swap4LE(facet.v1+2);
-
-    vtkByteSwap::Swap4LE(facet.v2);
-    vtkByteSwap::Swap4LE(facet.v2+1);
-    vtkByteSwap::Swap4LE(facet.v2+2);
-
-    vtkByteSwap::Swap4LE(facet.v3);
-    vtkByteSwap::Swap4LE(facet.v3+1);
-    vtkByteSwap::Swap4LE(facet.v3+2);
-
-    vtkIdType pts[3];
-    pts[0] = newPts->InsertNextPoint(facet.v1);
-    pts[1] = newPts->InsertNextPoint(facet.v2);
-    pts[2] = newPts->InsertNextPoint(facet.v3);
+    vtkDebugMacro(<< "triangle# " << numRead);
+    this->UpdateProgress(static_cast<double>(numRead) / numTris);
+  }
 
-    newPolys->InsertNextCell(3, pts);
+  // The count from the file length may be more than the file holds.
+  if (numRead < numTris)
+  {
+    newPts->SetNumberOfPoints(3 * numRead);
+    newPolys->WritePointer(numRead, 4 * numRead);
+    newPolys->GetData()->SetNumberOfValues(4 * numRead);
+  }
 
-    if ((i % 5000) == 0 && i != 0)
-    {
-      vtkDebugMacro(<< "triangle# " << i);
-      this->UpdateProgress(static_cast<double>(i) / numTris);
-    }
+  if (premature)
+  {
+    vtkErrorMacro("STLReader error reading file: " << this->FileName
+      << " Premature EOF while reading extra junk.");
+    return false;
   }
 
   return true;
@@ -24,8 +24,12 @@
  * .stl files are quite inefficient since they duplicate vertex
  * definitions. By setting the Merging boolean you can control whether the
  * point data is merged after reading. Merging is performed by default,
- * however, merging requires a large amount of temporary storage since a
- * 3D hash table must be constructed.
+ * however, merging requires a large amount of temporary storage. Unless a
+ * locator is set, coincident points are found by sorting the triangle
+ * vertices in parallel, otherwise by inserting them in the locator.
+ *
+ * Binary files are read in large batches of triangles, each decoded in
+ * parallel.
  *
  * @warning
  * Binary files written on one system may not be readable on other systems.
@@ -80,8 +84,9 @@ public:
 
   //@{
   /**
-   * Specify a spatial locator for merging points. By
-   * default an instance of vtkMergePoints is used.
+   * Specify a spatial locator for merging points. By default points are
+   * merged exactly, with the same result as with an instance of
+   * vtkMergePoints, but without a locator.
    */
   void SetLocator(vtkIncrementalPointLocator *locator);
   vtkGetObjectMacro(Locator,vtkIncrementalPointLocator);
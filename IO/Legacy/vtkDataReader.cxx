@@ -46,6 +46,7 @@
 #include "vtkShortArray.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStringArray.h"
+#include "vtkStringToNumber.h"
 #include "vtkTable.h"
 #include "vtkTypeInt64Array.h"
 #include "vtkTypeUInt64Array.h"
@@ -1420,23 +1421,18 @@ int vtkReadBinaryData(istream *IS, T *data, vtkIdType numTuples, vtkIdType numCo
   return 1;
 }
 
-// General templated function to read data of various types.
+// General templated function to read data of various types.  The values
+// are parsed in parallel, independently of the locale.
 template <class T>
 int vtkReadASCIIData(vtkDataReader *self, T *data, vtkIdType numTuples, vtkIdType numComp)
 {
-  vtkIdType i, j;
-
-  for (i=0; i<numTuples; i++)
+  size_t numValues = static_cast<size_t>(numTuples*numComp);
+  if (vtkStringToNumber::Read(*self->GetIStream(), data, numValues) !=
+      numValues)
   {
-    for (j=0; j<numComp; j++)
-    {
-      if ( !self->Read(data++) )
-      {
-        vtkGenericWarningMacro(<<"Error reading ascii data. Possible mismatch of "
-          "datasize with declaration.");
-        return 0;
-      }
-    }
+    vtkGenericWarningMacro(<<"Error reading ascii data. Possible mismatch of "
+      "datasize with declaration.");
+    return 0;
   }
   return 1;
 }
@@ -3052,7 +3048,6 @@ int vtkDataReader::ReadLutData(vtkDataSetAttributes *a)
 int vtkDataReader::ReadCells(vtkIdType size, int *data)
 {
   char line[256];
-  int i;
 
   if ( this->FileType == VTK_BINARY)
   {
@@ -3069,14 +3064,12 @@ int vtkDataReader::ReadCells(vtkIdType size, int *data)
   }
   else // ascii
   {
-    for (i=0; i<size; i++)
+    if (vtkStringToNumber::Read(*this->IS, data, static_cast<size_t>(size)) !=
+        static_cast<size_t>(size))
     {
-      if (!this->Read(data+i))
-      {
-        vtkErrorMacro(<<"Error reading ascii cell data!" << " for file: "
-                      << (this->FileName?this->FileName:"(Null FileName)"));
-        return 0;
-      }
+      vtkErrorMacro(<<"Error reading ascii cell data!" << " for file: "
+                    << (this->FileName?this->FileName:"(Null FileName)"));
+      return 0;
     }
   }
 
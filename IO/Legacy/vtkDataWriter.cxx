@@ -43,11 +43,13 @@
 #include "vtkLookupTable.h"
 #include "vtkMath.h"
 #include "vtkNew.h"
+#include "vtkNumberToString.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
 #include "vtkShortArray.h"
 #include "vtkSignedCharArray.h"
+#include "vtkSMPTools.h"
 #include "vtkSOADataArrayTemplate.h"
 #include "vtkStringArray.h"
 #include "vtkTable.h"
@@ -61,8 +63,12 @@
 #include "vtkUnsignedShortArray.h"
 #include "vtkVariantArray.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 vtkStandardNewMacro(vtkDataWriter);
 
@@ -961,32 +967,128 @@ int vtkDataWriter::WriteRowData(ostream *fp, vtkTable *t)
 
 namespace
 {
-// Template to handle writing data in ascii or binary
-// We could change the format into C++ io standard ...
+// Values formatted by each task, and tasks formatted before writing.
+const vtkIdType ValuesPerChunk = 9 * 4096;
+const vtkIdType ChunksPerBatch = 16;
+
+// Write the decimal text of an integer into buffer and return its length.
+inline int vtkFormatASCIIMagnitude(unsigned long long magnitude, char* buffer)
+{
+  char digits[24];
+  int numDigits = 0;
+  do
+  {
+    digits[numDigits++] = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude);
+  for (int i = 0; i < numDigits; ++i)
+  {
+    buffer[i] = digits[numDigits - 1 - i];
+  }
+  return numDigits;
+}
+
 template <class T>
-void vtkWriteDataArray(ostream *fp, T *data, int fileType,
-                       const char *format, vtkIdType num, vtkIdType numComp)
+inline int vtkFormatASCIIValue(T value, char* buffer, std::true_type)
 {
-  vtkIdType i, j, idx, sizeT;
-  char str[1024];
+  if (value < 0)
+  {
+    buffer[0] = '-';
+    return 1 + vtkFormatASCIIMagnitude(
+      0 - static_cast<unsigned long long>(value), buffer + 1);
+  }
+  return vtkFormatASCIIMagnitude(
+    static_cast<unsigned long long>(value), buffer);
+}
 
-  sizeT = sizeof(T);
+template <class T>
+inline int vtkFormatASCIIValue(T value, char* buffer, std::false_type)
+{
+  return vtkFormatASCIIMagnitude(
+    static_cast<unsigned long long>(value), buffer);
+}
 
-  if ( fileType == VTK_ASCII )
+template <class T>
+inline int vtkFormatASCIIValue(T value, char* buffer)
+{
+  return vtkFormatASCIIValue(value, buffer, std::is_signed<T>());
+}
+
+// Floating point values are written with the shortest text that reads
+// back to the same value.
+inline int vtkFormatASCIIValue(float value, char* buffer)
+{
+  return vtkNumberToString::Convert(value, buffer);
+}
+
+inline int vtkFormatASCIIValue(double value, char* buffer)
+{
+  return vtkNumberToString::Convert(value, buffer);
+}
+
+// Formats chunks of values into text, nine values per line.
+template <class T>
+struct vtkFormatASCIIData
+{
+  const T* Data;
+  vtkIdType NumValues;
+  vtkIdType FirstChunk;
+  std::vector<std::string>& Text;
+
+  vtkFormatASCIIData(const T* data, vtkIdType numValues,
+                     std::vector<std::string>& text)
+    : Data(data), NumValues(numValues), FirstChunk(0), Text(text)
   {
-    for (j=0; j<num; j++)
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    char buffer[32];
+    for (vtkIdType chunk = begin; chunk < end; ++chunk)
     {
-      for (i=0; i<numComp; i++)
+      vtkIdType first = (this->FirstChunk + chunk) * ValuesPerChunk;
+      vtkIdType last = std::min(first + ValuesPerChunk, this->NumValues);
+      std::string& text = this->Text[chunk];
+      text.clear();
+      for (vtkIdType idx = first; idx < last; ++idx)
       {
-        idx = i + j*numComp;
-        snprintf (str, sizeof(str), format, *data++); *fp << str;
+        text.append(buffer, vtkFormatASCIIValue(this->Data[idx], buffer));
+        text += ' ';
         if ( !((idx+1)%9) )
         {
-          *fp << "\n";
+          text += '\n';
         }
       }
     }
   }
+};
+
+// Template to handle writing data in ascii or binary
+template <class T>
+void vtkWriteDataArray(ostream *fp, T *data, int fileType,
+                       vtkIdType num, vtkIdType numComp)
+{
+  vtkIdType sizeT = sizeof(T);
+
+  if ( fileType == VTK_ASCII )
+  {
+    // Format batches of chunks in parallel, and write them in order.
+    vtkIdType numValues = num*numComp;
+    vtkIdType numChunks = (numValues + ValuesPerChunk - 1) / ValuesPerChunk;
+    std::vector<std::string> text(std::min(numChunks, ChunksPerBatch));
+    vtkFormatASCIIData<T> formatter(data, numValues, text);
+    for (vtkIdType chunk = 0; chunk < numChunks; chunk += ChunksPerBatch)
+    {
+      vtkIdType batchSize = std::min(numChunks - chunk, ChunksPerBatch);
+      formatter.FirstChunk = chunk;
+      vtkSMPTools::For(0, batchSize, 1, formatter);
+      for (vtkIdType i = 0; i < batchSize; ++i)
+      {
+        fp->write(text[i].data(),
+                  static_cast<std::streamsize>(text[i].size()));
+      }
+    }
+  }
   else
   {
     if (num*numComp > 0)
@@ -1043,7 +1145,6 @@ int vtkDataWriter::WriteArray(ostream *fp, int dataType, vtkAbstractArray *data,
 
   bool isAOSArray = data->HasStandardMemoryLayout();
 
-  char* outputFormat = new char[10];
   switch (dataType)
   {
     case VTK_BIT:
@@ -1087,11 +1188,7 @@ int vtkDataWriter::WriteArray(ostream *fp, int dataType, vtkAbstractArray *data,
       snprintf (str, sizeof(str), format, "char"); *fp << str;
       char *s=GetArrayRawPointer(
         data, static_cast<vtkCharArray *>(data)->GetPointer(0), isAOSArray);
-#if VTK_TYPE_CHAR_IS_SIGNED
-      vtkWriteDataArray(fp, s, this->FileType, "%hhd ", num, numComp);
-#else
-      vtkWriteDataArray(fp, s, this->FileType, "%hhu ", num, numComp);
-#endif
+      vtkWriteDataArray(fp, s, this->FileType, num, numComp);
       if (!isAOSArray)
       {
         delete [] s;
@@ -1104,7 +1201,7 @@ int vtkDataWriter::WriteArray(ostream *fp, int dataType, vtkAbstractArray *data,
       snprintf (str, sizeof(str), format, "signed_char"); *fp << str;
       signed char *s=GetArrayRawPointer(
         data, static_cast<vtkSignedCharArray *>(data)->GetPointer(0), isAOSArray);
-      vtkWriteDataArray(fp, s, this->FileType, "%hhd ", num, numComp);
+      vtkWriteDataArray(fp, s, this->FileType, num, numComp);
       if (!isAOSArray)
       {
         delete [] s;
@@ -1117,7 +1214,7 @@ int vtkDataWriter::WriteArray(ostream *fp, int dataType, vtkAbstractArray *data,
       snprintf (str, sizeof(str), format, "unsigned_char"); *fp << str;
       unsigned char *s=GetArrayRawPointer(
         data, static_cast<vtkUnsignedCharArray *>(data)->GetPointer(0), isAOSArray);
-      vtkWriteDataArray(fp, s, this->FileType, "%hhu ", num, numComp);
+      vtkWriteDataArray(fp, s, this->FileType, num, numComp);
       if (!isAOSArray)
       {
         delete [] s;
@@ -1130,7 +1227,7 @@ int vtkDataWriter::WriteArray(ostream *fp, int dataType, vtkAbstractArray *data,
       snprintf (str, sizeof(str), format, "short"); *fp << str;
       short *s=GetArrayRawPointer(
         data, static_cast<vtkShortArray *>(data)->GetPointer(0), isAOSArray);
-      vtkWriteDataArray(fp, s, this->FileType, "%hd ", num, numComp);
+      vtkWriteDataArray(fp, s, this->FileType, num, numComp);
       if (!isAOSArray)
       {
         delete [] s;
@@ -1143,7 +1240,7 @@ int vtkDataWriter::WriteArray(ostream *fp, int dataType, vtkAbstractArray *data,
       snprintf (str, sizeof(str), format, "unsigned_short"); *fp << str;
       unsigned short *s=GetArrayRawPointer(
         data, static_cast<vtkUnsignedShortArray *>(data)->GetPointer(0), isAOSArray);
-      vtkWriteDataArray(fp, s, this->FileType, "%hu ", num, numComp);
+      vtkWriteDataArray(fp, s, this->FileType, num, numComp);
       if (!isAOSArray)
       {
         delete [] s;
@@ -1156,7 +1253,7 @@ int vtkDataWriter::WriteArray(ostream *fp, int dataType, vtkAbstractArray *data,
       snprintf (str, sizeof(str), format, "int"); *fp << str;
       int *s=GetArrayRawPointer(
         data, static_cast<vtkIntArray *>(data)->GetPointer(0), isAOSArray);
-      vtkWriteDataArray(fp, s, this->FileType, "%d ", num, numComp);
+      vtkWriteDataArray(fp, s, this->FileType, num, numComp);
       if (!isAOSArray)
       {
         delete [] s;
@@ -1169,7 +1266,7 @@ int vtkDataWriter::WriteArray(ostream *fp, int dataType, vtkAbstractArray *data,
       snprintf (str, sizeof(str), format, "unsigned_int"); *fp << str;
       unsigned int *s=GetArrayRawPointer(
         data, static_cast<vtkUnsignedIntArray *>(data)->GetPointer(0), isAOSArray);
-      vtkWriteDataArray(fp, s, this->FileType, "%u ", num, numComp);
+      vtkWriteDataArray(fp, s, this->FileType, num, numComp);
       if (!isAOSArray)
       {
         delete [] s;
@@ -1182,7 +1279,7 @@ int vtkDataWriter::WriteArray(ostream *fp, int dataType, vtkAbstractArray *data,
       snprintf (str, sizeof(str), format, "long"); *fp << str;
       long *s=GetArrayRawPointer(
         data, static_cast<vtkLongArray *>(data)->GetPointer(0), isAOSArray);
-      vtkWriteDataArray(fp, s, this->FileType, "%ld ", num, numComp);
+      vtkWriteDataArray(fp, s, this->FileType, num, numComp);
       if (!isAOSArray)
       {
         delete [] s;
@@ -1195,7 +1292,7 @@ int vtkDataWriter::WriteArray(ostream *fp, int dataType, vtkAbstractArray *data,
       snprintf (str, sizeof(str), format, "unsigned_long"); *fp << str;
       unsigned long *s=GetArrayRawPointer(
         data, static_cast<vtkUnsignedLongArray *>(data)->GetPointer(0), isAOSArray);
-      vtkWriteDataArray(fp, s, this->FileType, "%lu ", num, numComp);
+      vtkWriteDataArray(fp, s, this->FileType, num, numComp);
       if (!isAOSArray)
       {
         delete [] s;
@@ -1208,9 +1305,7 @@ int vtkDataWriter::WriteArray(ostream *fp, int dataType, vtkAbstractArray *data,
       snprintf (str, sizeof(str), format, "vtktypeint64"); *fp << str;
       long long *s=GetArrayRawPointer(
         data, static_cast<vtkTypeInt64Array *>(data)->GetPointer(0), isAOSArray);
-      strcpy(outputFormat, vtkTypeTraits<long long>::ParseFormat());
-      strcat(outputFormat, " ");
-      vtkWriteDataArray(fp, s, this->FileType, outputFormat, num, numComp);
+      vtkWriteDataArray(fp, s, this->FileType, num, numComp);
       if (!isAOSArray)
       {
         delete [] s;
@@ -1223,9 +1318,7 @@ int vtkDataWriter::WriteArray(ostream *fp, int dataType, vtkAbstractArray *data,
       snprintf (str, sizeof(str), format, "vtktypeuint64"); *fp << str;
       unsigned long long *s=GetArrayRawPointer(
         data, static_cast<vtkTypeUInt64Array *>(data)->GetPointer(0), isAOSArray);
-      strcpy(outputFormat, vtkTypeTraits<unsigned long long>::ParseFormat());
-      strcat(outputFormat, " ");
-      vtkWriteDataArray(fp, s, this->FileType, outputFormat, num, numComp);
+      vtkWriteDataArray(fp, s, this->FileType, num, numComp);
       if (!isAOSArray)
       {
         delete [] s;
@@ -1238,7 +1331,7 @@ int vtkDataWriter::WriteArray(ostream *fp, int dataType, vtkAbstractArray *data,
       snprintf (str, sizeof(str), format, "float"); *fp << str;
       float *s=GetArrayRawPointer(
         data, static_cast<vtkFloatArray *>(data)->GetPointer(0), isAOSArray);
-      vtkWriteDataArray(fp, s, this->FileType, "%g ", num, numComp);
+      vtkWriteDataArray(fp, s, this->FileType, num, numComp);
       if (!isAOSArray)
       {
         delete [] s;
@@ -1251,7 +1344,7 @@ int vtkDataWriter::WriteArray(ostream *fp, int dataType, vtkAbstractArray *data,
       snprintf (str, sizeof(str), format, "double"); *fp << str;
       double *s=GetArrayRawPointer(
         data, static_cast<vtkDoubleArray *>(data)->GetPointer(0), isAOSArray);
-      vtkWriteDataArray(fp, s, this->FileType, "%.11lg ", num, numComp);
+      vtkWriteDataArray(fp, s, this->FileType, num, numComp);
       if (!isAOSArray)
       {
         delete [] s;
@@ -1287,7 +1380,7 @@ int vtkDataWriter::WriteArray(ostream *fp, int dataType, vtkAbstractArray *data,
           }
         }
       }
-      vtkWriteDataArray(fp, &intArray[0], this->FileType, "%d ", num, numComp);
+      vtkWriteDataArray(fp, &intArray[0], this->FileType, num, numComp);
     }
     break;
 
@@ -1422,11 +1515,9 @@ int vtkDataWriter::WriteArray(ostream *fp, int dataType, vtkAbstractArray *data,
     {
       vtkErrorMacro(<<"Type currently not supported");
       *fp << "NULL_ARRAY" << endl;
-      delete[] outputFormat;
       return 0;
     }
   }
-  delete[] outputFormat;
 
   // Write out metadata if it exists:
   vtkInformation *info = data->GetInformation();
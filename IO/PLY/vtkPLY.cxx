@@ -2298,19 +2298,56 @@ void vtkPLY::get_binary_item(
   unsigned int *uint_val,
   double *double_val
 )
+{
+  if (type <= PLY_START_TYPE || type >= PLY_END_TYPE) {
+    fprintf (stderr, "get_binary_item: bad type = %d\n", type);
+    assert (0);
+    return;
+  }
+
+  char item[8];
+  if (fread (item, ply_type_size[type], 1, plyfile->fp) != 1)
+  {
+    vtkGenericWarningMacro ("PLY error reading file."
+                            << " Premature EOF while reading " << type_names[type] << ".");
+    fclose (plyfile->fp);
+    return;
+  }
+
+  get_binary_item (item, plyfile->file_type, type, int_val, uint_val, double_val);
+}
+
+
+/******************************************************************************
+Get the value of an item of binary data in memory, and place the result
+into an integer, an unsigned integer and a double.
+
+Entry:
+  item      - pointer to the item
+  file_type - byte order of the item, PLY_BINARY_BE or PLY_BINARY_LE
+  type      - data type of the item
+
+Exit:
+  int_val    - integer value
+  uint_val   - unsigned integer value
+  double_val - double-precision floating point value
+******************************************************************************/
+
+void vtkPLY::get_binary_item(
+  const char *item,
+  int file_type,
+  int type,
+  int *int_val,
+  unsigned int *uint_val,
+  double *double_val
+)
 {
   switch (type) {
     case PLY_CHAR:
     case PLY_INT8:
       {
       vtkTypeInt8 value = 0;
-      if (fread (&value, sizeof(value), 1, plyfile->fp) != 1)
-      {
-        vtkGenericWarningMacro ("PLY error reading file."
-                                << " Premature EOF while reading char.");
-        fclose (plyfile->fp);
-        return;
-      }
+      memcpy(&value, item, sizeof(value));
 
       // Here value can always fit in int, unsigned int, and double.
       *int_val = static_cast<int>(value);
@@ -2322,13 +2359,7 @@ void vtkPLY::get_binary_item(
     case PLY_UINT8:
     {
       vtkTypeUInt8 value = 0;
-      if (fread (&value, sizeof(value), 1, plyfile->fp) != 1)
-      {
-        vtkGenericWarningMacro ("PLY error reading file."
-                                << " Premature EOF while reading uchar or uint8.");
-        fclose (plyfile->fp);
-        return;
-      }
+      memcpy(&value, item, sizeof(value));
 
       // Here value can always fit in int, unsigned int, and double.
       *int_val = static_cast<int>(value);
@@ -2340,14 +2371,8 @@ void vtkPLY::get_binary_item(
     case PLY_INT16:
     {
       vtkTypeInt16 value = 0;
-      if (fread (&value, sizeof(value), 1, plyfile->fp) != 1)
-      {
-        vtkGenericWarningMacro ("PLY error reading file."
-                                << " Premature EOF while reading short.");
-        fclose (plyfile->fp);
-        return;
-      }
-      plyfile->file_type == PLY_BINARY_BE ?
+      memcpy(&value, item, sizeof(value));
+      file_type == PLY_BINARY_BE ?
         vtkByteSwap::Swap2BE(&value) :
         vtkByteSwap::Swap2LE(&value);
 
@@ -2361,14 +2386,8 @@ void vtkPLY::get_binary_item(
     case PLY_UINT16:
     {
       vtkTypeUInt16 value = 0;
-      if (fread (&value, sizeof(value), 1, plyfile->fp) != 1)
-      {
-        vtkGenericWarningMacro ("PLY error reading file."
-                                << " Premature EOF while reading ushort.");
-        fclose (plyfile->fp);
-        return;
-      }
-      plyfile->file_type == PLY_BINARY_BE ?
+      memcpy(&value, item, sizeof(value));
+      file_type == PLY_BINARY_BE ?
         vtkByteSwap::Swap2BE(&value) :
         vtkByteSwap::Swap2LE(&value);
 
@@ -2382,14 +2401,8 @@ void vtkPLY::get_binary_item(
     case PLY_INT32:
     {
       vtkTypeInt32 value = 0;
-      if (fread (&value, sizeof(value), 1, plyfile->fp) != 1)
-      {
-        vtkGenericWarningMacro ("PLY error reading file."
-                                << " Premature EOF while reading int or int32.");
-        fclose (plyfile->fp);
-        return;
-      }
-      plyfile->file_type == PLY_BINARY_BE ?
+      memcpy(&value, item, sizeof(value));
+      file_type == PLY_BINARY_BE ?
         vtkByteSwap::Swap4BE(&value) :
         vtkByteSwap::Swap4LE(&value);
 
@@ -2403,14 +2416,8 @@ void vtkPLY::get_binary_item(
     case PLY_UINT32:
     {
       vtkTypeUInt32 value = 0;
-      if (fread (&value, sizeof(value), 1, plyfile->fp) != 1)
-      {
-        vtkGenericWarningMacro ("PLY error reading file."
-                                << " Premature EOF while reading uint");
-        fclose (plyfile->fp);
-        return;
-      }
-      plyfile->file_type == PLY_BINARY_BE ?
+      memcpy(&value, item, sizeof(value));
+      file_type == PLY_BINARY_BE ?
         vtkByteSwap::Swap4BE(&value) :
         vtkByteSwap::Swap4LE(&value);
 
@@ -2424,14 +2431,8 @@ void vtkPLY::get_binary_item(
     case PLY_FLOAT32:
     {
       vtkTypeFloat32 value = 0.0;
-      if (fread (&value, sizeof(value), 1, plyfile->fp) != 1)
-      {
-        vtkGenericWarningMacro ("PLY error reading file."
-                                << " Premature EOF while reading float of float32.");
-        fclose (plyfile->fp);
-        return;
-      }
-      plyfile->file_type == PLY_BINARY_BE ?
+      memcpy(&value, item, sizeof(value));
+      file_type == PLY_BINARY_BE ?
         vtkByteSwap::Swap4BE(&value) :
         vtkByteSwap::Swap4LE(&value);
 
@@ -2446,14 +2447,8 @@ void vtkPLY::get_binary_item(
     case PLY_DOUBLE:
     {
       vtkTypeFloat64 value = 0.0;
-      if (fread (&value, sizeof(value), 1, plyfile->fp) != 1)
-      {
-        vtkGenericWarningMacro ("PLY error reading file."
-                                << " Premature EOF while reading double.");
-        fclose (plyfile->fp);
-        return;
-      }
-      plyfile->file_type == PLY_BINARY_BE ?
+      memcpy(&value, item, sizeof(value));
+      file_type == PLY_BINARY_BE ?
         vtkByteSwap::Swap8BE(&value) :
         vtkByteSwap::Swap8LE(&value);
 
@@ -2470,6 +2465,20 @@ void vtkPLY::get_binary_item(
 }
 
 
+
+
+/******************************************************************************
+Return the size in bytes of an item of the given type, or 0 for a bad type.
+******************************************************************************/
+
+int vtkPLY::get_item_size(int type)
+{
+  if (type <= PLY_START_TYPE || type >= PLY_END_TYPE)
+    return 0;
+  return ply_type_size[type];
+}
+
+
 /******************************************************************************
 Extract the value of an item from an ascii word, and place the result
 into an integer, an unsigned integer and a double.
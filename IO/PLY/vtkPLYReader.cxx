@@ -18,17 +18,24 @@
 #include "vtkCellData.h"
 #include "vtkPointData.h"
 #include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPLY.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStringArray.h"
+#include "vtkUnsignedCharArray.h"
 #include <vtksys/SystemTools.hxx>
 
+#include <algorithm>
 #include <cctype>
 #include <cstddef>
+#include <cstring>
+#include <vector>
 
 vtkStandardNewMacro(vtkPLYReader);
 
@@ -70,6 +77,346 @@ typedef struct _plyFace {
 } plyFace;
 }
 
+namespace
+{
+// Binary vertices are read and decoded in batches, and binary faces in
+// blocks of at least this many bytes.
+const vtkIdType vtkPLYVerticesPerBatch = 65536;
+const size_t vtkPLYFaceBlockSize = 4 << 20;
+
+// The byte layout of the records of a binary element.  Each property has
+// an offset from the start of the record, or from the end of the list for
+// the properties after it.  An element has at most one list for the
+// layout to be known from the list length.
+struct vtkPLYLayout
+{
+  std::vector<int> Offsets;
+  std::vector<bool> AfterList;
+  int List;
+  int CountSize;
+  int ItemSize;
+  int Before; // bytes before the list, or the record size without a list
+  int After;  // bytes after the list
+
+  bool Init(PlyElement *elem)
+  {
+    this->Offsets.resize(elem->nprops);
+    this->AfterList.resize(elem->nprops);
+    this->List = -1;
+    this->CountSize = this->ItemSize = this->Before = this->After = 0;
+    for (int i = 0; i < elem->nprops; ++i)
+    {
+      PlyProperty *prop = elem->props[i];
+      int size = vtkPLY::get_item_size(prop->external_type);
+      if (size == 0)
+      {
+        return false;
+      }
+      if (prop->is_list)
+      {
+        if (this->List >= 0 || vtkPLY::get_item_size(prop->count_external) == 0)
+        {
+          return false;
+        }
+        this->List = i;
+        this->CountSize = vtkPLY::get_item_size(prop->count_external);
+        this->ItemSize = size;
+        this->Offsets[i] = this->Before;
+        this->AfterList[i] = false;
+      }
+      else if (this->List < 0)
+      {
+        this->Offsets[i] = this->Before;
+        this->AfterList[i] = false;
+        this->Before += size;
+      }
+      else
+      {
+        this->Offsets[i] = this->After;
+        this->AfterList[i] = true;
+        this->After += size;
+      }
+    }
+    return true;
+  }
+};
+
+// Decode binary vertex records into the points and the optional texture
+// coordinates, normals and colors, converting the values as
+// vtkPLY::ply_get_element does.
+struct vtkPLYDecodeVertices
+{
+  const char *Records;
+  int RecordSize;
+  int FileType;
+  // Offsets and types of x, y, z, u, v, nx, ny, nz, red, green, blue and
+  // alpha, in the order of the vertex properties.
+  int Offsets[12];
+  int Types[12];
+  float *Points;
+  float *TCoords;
+  float *Normals;
+  unsigned char *Colors;
+  int ColorComponents;
+
+  void Get(const char *record, int prop, unsigned int &uintVal, double &doubleVal) const
+  {
+    int intVal;
+    vtkPLY::get_binary_item(record + this->Offsets[prop], this->FileType,
+      this->Types[prop], &intVal, &uintVal, &doubleVal);
+  }
+
+  void GetFloats(const char *record, int first, int num, float *values) const
+  {
+    for (int i = 0; i < num; ++i)
+    {
+      unsigned int uintVal;
+      double doubleVal;
+      this->Get(record, first + i, uintVal, doubleVal);
+      values[i] = static_cast<float>(doubleVal);
+    }
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const char *record = this->Records + i * this->RecordSize;
+      this->GetFloats(record, 0, 3, this->Points + 3 * i);
+      if (this->TCoords)
+      {
+        this->GetFloats(record, 3, 2, this->TCoords + 2 * i);
+      }
+      if (this->Normals)
+      {
+        this->GetFloats(record, 5, 3, this->Normals + 3 * i);
+      }
+      if (this->Colors)
+      {
+        for (int c = 0; c < this->ColorComponents; ++c)
+        {
+          unsigned int uintVal;
+          double doubleVal;
+          this->Get(record, 8 + c, uintVal, doubleVal);
+          this->Colors[this->ColorComponents * i + c] =
+            static_cast<unsigned char>(uintVal);
+        }
+      }
+    }
+  }
+};
+
+// Decode binary face records, whose starts and connectivity locations are
+// known, into the connectivity and the optional intensity and colors.
+struct vtkPLYDecodeFaces
+{
+  const char *Records;
+  const size_t *Starts;
+  const vtkIdType *Locations;
+  int FileType;
+  const vtkPLYLayout *Layout;
+  int CountType;
+  int IndexType;
+  // Property indices of intensity, red, green, blue and alpha, or -1.
+  int Props[5];
+  int Types[5];
+  vtkIdType *Connectivity;
+  unsigned char *Intensity;
+  unsigned char *Colors;
+  int ColorComponents;
+
+  unsigned char GetUChar(const char *record, const char *listEnd, int k) const
+  {
+    int prop = this->Props[k];
+    const char *item = (this->Layout->AfterList[prop] ? listEnd : record) +
+      this->Layout->Offsets[prop];
+    int intVal;
+    unsigned int uintVal;
+    double doubleVal;
+    vtkPLY::get_binary_item(item, this->FileType, this->Types[k], &intVal,
+      &uintVal, &doubleVal);
+    return static_cast<unsigned char>(uintVal);
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    const vtkPLYLayout &layout = *this->Layout;
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const char *record = this->Records + this->Starts[i];
+      vtkIdType *cell = this->Connectivity + this->Locations[i];
+      vtkIdType npts = this->Locations[i + 1] - this->Locations[i] - 1;
+      const char *item = record + layout.Before + layout.CountSize;
+      cell[0] = npts;
+      for (vtkIdType j = 0; j < npts; ++j, item += layout.ItemSize)
+      {
+        int intVal;
+        unsigned int uintVal;
+        double doubleVal;
+        vtkPLY::get_binary_item(item, this->FileType, this->IndexType, &intVal,
+          &uintVal, &doubleVal);
+        cell[j + 1] = intVal;
+      }
+      if (this->Intensity)
+      {
+        this->Intensity[i] = this->GetUChar(record, item, 0);
+      }
+      if (this->Colors)
+      {
+        for (int c = 0; c < this->ColorComponents; ++c)
+        {
+          this->Colors[this->ColorComponents * i + c] =
+            this->GetUChar(record, item, 1 + c);
+        }
+      }
+    }
+  }
+};
+
+// Find the index and type of a property the reader asked for.
+void vtkPLYFindProperty(PlyElement *elem, const char *name, int &index, int &type)
+{
+  PlyProperty *prop = vtkPLY::find_property(elem, name, &index);
+  type = prop ? prop->external_type : 0;
+  if (!prop)
+  {
+    index = -1;
+  }
+}
+
+// Read the vertices of a binary file whose vertex element has no list, in
+// batches decoded in parallel.
+bool vtkPLYReadBinaryVertices(PlyFile *ply, PlyElement *elem,
+  const vtkPLYLayout &layout, const PlyProperty *vertProps, vtkIdType numPts,
+  vtkPoints *pts, vtkFloatArray *tcoords, vtkFloatArray *normals,
+  vtkUnsignedCharArray *colors)
+{
+  vtkPLYDecodeVertices decoder;
+  decoder.RecordSize = layout.Before;
+  decoder.FileType = ply->file_type;
+  for (int k = 0; k < 12; ++k)
+  {
+    int index;
+    vtkPLYFindProperty(elem, vertProps[k].name, index, decoder.Types[k]);
+    decoder.Offsets[k] = index >= 0 ? layout.Offsets[index] : 0;
+  }
+  decoder.ColorComponents = colors ? colors->GetNumberOfComponents() : 0;
+
+  std::vector<char> batch(static_cast<size_t>(decoder.RecordSize) *
+    std::min(numPts, vtkPLYVerticesPerBatch));
+  for (vtkIdType first = 0; first < numPts; first += vtkPLYVerticesPerBatch)
+  {
+    vtkIdType num = std::min(numPts - first, vtkPLYVerticesPerBatch);
+    if (fread(batch.data(), decoder.RecordSize, num, ply->fp) !=
+        static_cast<size_t>(num))
+    {
+      return false;
+    }
+    decoder.Records = batch.data();
+    decoder.Points = static_cast<float*>(pts->GetVoidPointer(3 * first));
+    decoder.TCoords = tcoords ? tcoords->GetPointer(2 * first) : nullptr;
+    decoder.Normals = normals ? normals->GetPointer(3 * first) : nullptr;
+    decoder.Colors = colors ?
+      colors->GetPointer(decoder.ColorComponents * first) : nullptr;
+    vtkSMPTools::For(0, num, decoder);
+  }
+  return true;
+}
+
+// Read the faces of a binary file whose face element has the vertex
+// indices as its only list.  Blocks of the file are scanned for the face
+// records they hold, which are then decoded in parallel.
+bool vtkPLYReadBinaryFaces(PlyFile *ply, PlyElement *elem,
+  const vtkPLYLayout &layout, const PlyProperty *faceProps, vtkIdType numPolys,
+  vtkCellArray *polys, vtkUnsignedCharArray *intensity,
+  vtkUnsignedCharArray *colors)
+{
+  vtkPLYDecodeFaces decoder;
+  decoder.FileType = ply->file_type;
+  decoder.Layout = &layout;
+  PlyProperty *list = elem->props[layout.List];
+  decoder.CountType = list->count_external;
+  decoder.IndexType = list->external_type;
+  for (int k = 0; k < 5; ++k)
+  {
+    vtkPLYFindProperty(elem, faceProps[k + 1].name, decoder.Props[k], decoder.Types[k]);
+  }
+  decoder.ColorComponents = colors ? colors->GetNumberOfComponents() : 0;
+
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->Allocate(4 * numPolys);
+  // Start with a block for the faces if they are triangles.
+  size_t triangleSize = layout.Before + layout.CountSize + 3 * layout.ItemSize +
+    layout.After;
+  std::vector<char> block(std::min(vtkPLYFaceBlockSize,
+    triangleSize * static_cast<size_t>(numPolys) + 1));
+  std::vector<size_t> starts;
+  std::vector<vtkIdType> locations;
+  size_t have = 0;
+  size_t used = 0;
+  vtkIdType numRead = 0;
+  while (numRead < numPolys)
+  {
+    // Keep the part of a face left at the end of the block, and grow the
+    // block if a face does not fit in it.
+    memmove(block.data(), block.data() + used, have - used);
+    have -= used;
+    if (used == 0 && have == block.size())
+    {
+      block.resize(2 * block.size());
+    }
+    used = 0;
+    size_t wanted = block.size() - have;
+    size_t got = fread(block.data() + have, 1, wanted, ply->fp);
+    have += got;
+
+    starts.clear();
+    locations.assign(1, connectivity->GetNumberOfValues());
+    size_t headerSize = layout.Before + layout.CountSize;
+    while (numRead + static_cast<vtkIdType>(starts.size()) < numPolys &&
+           used + headerSize <= have)
+    {
+      int npts;
+      unsigned int uintVal;
+      double doubleVal;
+      vtkPLY::get_binary_item(block.data() + used + layout.Before,
+        decoder.FileType, decoder.CountType, &npts, &uintVal, &doubleVal);
+      size_t size = headerSize +
+        static_cast<size_t>(std::max(npts, 0)) * layout.ItemSize + layout.After;
+      if (used + size > have)
+      {
+        break;
+      }
+      starts.push_back(used);
+      locations.push_back(locations.back() + std::max(npts, 0) + 1);
+      used += size;
+    }
+    if (starts.empty() && got < wanted)
+    {
+      return false;
+    }
+
+    vtkIdType num = static_cast<vtkIdType>(starts.size());
+    vtkIdType first = locations.front();
+    decoder.Records = block.data();
+    decoder.Starts = starts.data();
+    decoder.Locations = locations.data();
+    decoder.Connectivity =
+      connectivity->WritePointer(first, locations.back() - first) - first;
+    decoder.Intensity = intensity ? intensity->GetPointer(numRead) : nullptr;
+    decoder.Colors = colors ?
+      colors->GetPointer(decoder.ColorComponents * numRead) : nullptr;
+    vtkSMPTools::For(0, num, decoder);
+    numRead += num;
+  }
+
+  // Leave the file after the last face.
+  fseek(ply->fp, -static_cast<long>(have - used), SEEK_CUR);
+  polys->SetCells(numPolys, connectivity);
+  return true;
+}
+}
+
 int vtkPLYReader::RequestData(
   vtkInformation *vtkNotUsed(request),
   vtkInformationVector **vtkNotUsed(inputVector),
@@ -256,6 +603,7 @@ int vtkPLYReader::RequestData(
 
   // Okay, now we can grab the data
   int numPts = 0, numPolys = 0;
+  bool readOk = true;
   for (int i = 0; i < nelems; i++)
   {
     //get the description of the first element */
@@ -263,7 +611,11 @@ int vtkPLYReader::RequestData(
     vtkPLY::ply_get_element_description (ply, elemName, &numElems, &nprops);
 
     // if we're on vertex elements, read them in
-    if ( elemName && !strcmp ("vertex", elemName) )
+    if ( !readOk )
+    {
+      // Skip the elements after an error.
+    }
+    else if ( elemName && !strcmp ("vertex", elemName) )
     {
       // Create a list of points
       numPts = numElems;
@@ -303,28 +655,46 @@ int vtkPLYReader::RequestData(
         RGBPoints->SetNumberOfTuples(numPts);
       }
 
-      plyVertex vertex;
-      for (int j=0; j < numPts; j++)
+      // Binary vertices without lists are read in bulk, straight into the
+      // arrays.
+      PlyElement *vertElem = vtkPLY::find_element(ply, elemName);
+      vtkPLYLayout layout;
+      if (ply->file_type != PLY_ASCII && layout.Init(vertElem) && layout.List < 0)
       {
-        vtkPLY::ply_get_element (ply, (void *) &vertex);
-        pts->SetPoint (j, vertex.x);
-        if ( TexCoordsPointsAvailable )
-        {
-          TexCoordsPoints->SetTuple2(j, vertex.tex[0], vertex.tex[1]);
-        }
-        if ( NormalPointsAvailable )
+        if (!vtkPLYReadBinaryVertices(ply, vertElem, layout, vertProps, numPts, pts,
+              TexCoordsPointsAvailable ? TexCoordsPoints.Get() : nullptr,
+              NormalPointsAvailable ? Normals.Get() : nullptr,
+              RGBPointsAvailable ? RGBPoints.Get() : nullptr))
         {
-          Normals->SetTuple3(j, vertex.normal[0], vertex.normal[1], vertex.normal[2]);
+          vtkErrorMacro(<<"Premature EOF while reading vertices");
+          readOk = false;
         }
-        if ( RGBPointsAvailable )
+      }
+      else
+      {
+        plyVertex vertex;
+        for (int j=0; j < numPts; j++)
         {
-          if (RGBPointsHaveAlpha)
+          vtkPLY::ply_get_element (ply, (void *) &vertex);
+          pts->SetPoint (j, vertex.x);
+          if ( TexCoordsPointsAvailable )
           {
-            RGBPoints->SetTuple4(j, vertex.red, vertex.green, vertex.blue, vertex.alpha);
+            TexCoordsPoints->SetTuple2(j, vertex.tex[0], vertex.tex[1]);
           }
-          else
+          if ( NormalPointsAvailable )
           {
-            RGBPoints->SetTuple3(j, vertex.red, vertex.green, vertex.blue);
+            Normals->SetTuple3(j, vertex.normal[0], vertex.normal[1], vertex.normal[2]);
+          }
+          if ( RGBPointsAvailable )
+          {
+            if (RGBPointsHaveAlpha)
+            {
+              RGBPoints->SetTuple4(j, vertex.red, vertex.green, vertex.blue, vertex.alpha);
+            }
+            else
+            {
+              RGBPoints->SetTuple3(j, vertex.red, vertex.green, vertex.blue);
+            }
           }
         }
       }
@@ -362,36 +732,56 @@ int vtkPLYReader::RequestData(
         RGBCells->SetNumberOfTuples(numPolys);
       }
 
-      // grab all the face elements
-      for (int j=0; j < numPolys; j++)
+      // Binary faces with the vertex indices as their only list are read
+      // in blocks, straight into the arrays.
+      PlyElement *faceElem = vtkPLY::find_element(ply, elemName);
+      vtkPLYLayout layout;
+      int listIndex;
+      if (ply->file_type != PLY_ASCII && layout.Init(faceElem) &&
+          vtkPLY::find_property(faceElem, faceProps[0].name, &listIndex) &&
+          layout.List == listIndex)
       {
-        //grab and element from the file
-        vtkPLY::ply_get_element (ply, (void *) &face);
-        for (int k=0; k < face.nverts; k++)
+        if (!vtkPLYReadBinaryFaces(ply, faceElem, layout, faceProps, numPolys, polys,
+              intensityAvailable ? intensity.Get() : nullptr,
+              RGBCellsAvailable ? RGBCells.Get() : nullptr))
         {
-          vtkVerts[k] = face.verts[k];
+          vtkErrorMacro(<<"Premature EOF while reading faces");
+          readOk = false;
         }
-        free(face.verts); // allocated in vtkPLY::ascii/binary_get_element
-
-        polys->InsertNextCell(face.nverts,vtkVerts);
-        if ( intensityAvailable )
-        {
-          intensity->SetValue(j,face.intensity);
-        }
-        if ( RGBCellsAvailable )
+      }
+      else
+      {
+        // grab all the face elements
+        for (int j=0; j < numPolys; j++)
         {
-          if (RGBCellsHaveAlpha)
+          //grab and element from the file
+          vtkPLY::ply_get_element (ply, (void *) &face);
+          for (int k=0; k < face.nverts; k++)
+          {
+            vtkVerts[k] = face.verts[k];
+          }
+          free(face.verts); // allocated in vtkPLY::ascii/binary_get_element
+
+          polys->InsertNextCell(face.nverts,vtkVerts);
+          if ( intensityAvailable )
           {
-            RGBCells->SetValue(4 * j, face.red);
-            RGBCells->SetValue(4 * j + 1, face.green);
-            RGBCells->SetValue(4 * j + 2, face.blue);
-            RGBCells->SetValue(4 * j + 3, face.alpha);
+            intensity->SetValue(j,face.intensity);
           }
-          else
+          if ( RGBCellsAvailable )
           {
-            RGBCells->SetValue(3 * j, face.red);
-            RGBCells->SetValue(3 * j + 1, face.green);
-            RGBCells->SetValue(3 * j + 2, face.blue);
+            if (RGBCellsHaveAlpha)
+            {
+              RGBCells->SetValue(4 * j, face.red);
+              RGBCells->SetValue(4 * j + 1, face.green);
+              RGBCells->SetValue(4 * j + 2, face.blue);
+              RGBCells->SetValue(4 * j + 3, face.alpha);
+            }
+            else
+            {
+              RGBCells->SetValue(3 * j, face.red);
+              RGBCells->SetValue(3 * j + 1, face.green);
+              RGBCells->SetValue(3 * j + 2, face.blue);
+            }
           }
         }
       }
@@ -410,7 +800,7 @@ int vtkPLYReader::RequestData(
   // close the PLY file
   vtkPLY::ply_close (ply);
 
-  return 1;
+  return readOk ? 1 : 0;
 }
 
 int vtkPLYReader::CanReadFile(const char *filename)
@@ -30,11 +30,71 @@
 #include "vtkMultiBlockDataSet.h"
 #include "vtkMultiProcessController.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkSortDataArray.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStringArray.h"
 
+#include <vector>
+
+namespace
+{
+// lists the time steps, regions and metadata files of the processor
+// subdirectories concurrently. Only the reader instances themselves are
+// modified, except for the atomic reader count of the parent.
+struct vtkPOpenFOAMMakeInformation
+{
+  std::vector<vtkSmartPointer<vtkOpenFOAMReader> > *Readers;
+  vtkStringArray *ProcNames;
+  std::vector<unsigned char> *Status;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      vtkOpenFOAMReader *reader = (*this->Readers)[i];
+      (*this->Status)[i] = static_cast<unsigned char>(
+        reader->MakeInformationVector(nullptr, this->ProcNames->GetValue(i)));
+      if ((*this->Status)[i])
+      {
+        reader->CacheMetaDataAtTimeStep(true);
+      }
+    }
+  }
+};
+
+// reads the metadata files of the current time step of the processor
+// subdirectories concurrently
+struct vtkPOpenFOAMCacheMetaData
+{
+  std::vector<vtkOpenFOAMReader *> *Readers;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      (*this->Readers)[i]->CacheMetaDataAtTimeStep(false);
+    }
+  }
+};
+
+// reads the meshes and fields of the processor subdirectories concurrently
+struct vtkPOpenFOAMUpdate
+{
+  std::vector<vtkOpenFOAMReader *> *Readers;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; i++)
+    {
+      (*this->Readers)[i]->Update();
+    }
+  }
+};
+}
+
 vtkStandardNewMacro(vtkPOpenFOAMReader);
 vtkCxxSetObjectMacro(vtkPOpenFOAMReader, Controller, vtkMultiProcessController);
 
@@ -260,27 +320,44 @@ int vtkPOpenFOAMReader::RequestInformation(vtkInformation *request,
 
     // create reader instances for other processor subdirectories
     // skip processor0 since it's already created
+    std::vector<vtkSmartPointer<vtkOpenFOAMReader> > subReaders;
+    vtkStringArray *subProcNames = vtkStringArray::New();
     for (int procI = (this->ProcessId ? this->ProcessId : this->NumProcesses); procI
         < procNames->GetNumberOfTuples(); procI += this->NumProcesses)
     {
-      vtkOpenFOAMReader *subReader = vtkOpenFOAMReader::New();
+      vtkSmartPointer<vtkOpenFOAMReader> subReader
+          = vtkSmartPointer<vtkOpenFOAMReader>::New();
       subReader->SetFileName(this->FileName);
       subReader->SetParent(this);
       subReader->SetUse64BitLabels(this->Use64BitLabels);
       subReader->SetUse64BitFloats(this->Use64BitFloats);
+      subReaders.push_back(subReader);
+      subProcNames->InsertNextValue(procNames->GetValue(procI));
+    }
+
+    // the processor subdirectories are scanned concurrently, but the
+    // selections are built in processor order since they are shared
+    std::vector<unsigned char> status(subReaders.size());
+    vtkPOpenFOAMMakeInformation makeInformation;
+    makeInformation.Readers = &subReaders;
+    makeInformation.ProcNames = subProcNames;
+    makeInformation.Status = &status;
+    vtkSMPTools::For(0, static_cast<vtkIdType>(subReaders.size()), 1,
+        makeInformation);
+    for (size_t readerI = 0; readerI < subReaders.size(); readerI++)
+    {
       // if getting metadata failed simply delete the reader instance
-      if (subReader->MakeInformationVector(nullptr, procNames->GetValue(procI))
-          && subReader->MakeMetaDataAtTimeStep(true))
+      if (status[readerI] && subReaders[readerI]->MakeMetaDataAtTimeStep(true))
       {
-        this->Superclass::Readers->AddItem(subReader);
+        this->Superclass::Readers->AddItem(subReaders[readerI]);
       }
       else
       {
         vtkWarningMacro(<<"Removing reader for processor subdirectory "
-            << procNames->GetValue(procI).c_str());
+            << subProcNames->GetValue(readerI).c_str());
       }
-      subReader->Delete();
     }
+    subProcNames->Delete();
 
     procNames->Delete();
 
@@ -336,6 +413,7 @@ int vtkPOpenFOAMReader::RequestData(vtkInformation *request,
     // append->AppendFieldDataOn();
 
     vtkOpenFOAMReader *reader;
+    std::vector<vtkOpenFOAMReader *> readers;
     this->Superclass::CurrentReaderIndex = 0;
     this->Superclass::Readers->InitTraversal();
     while ((reader
@@ -350,15 +428,28 @@ int vtkPOpenFOAMReader::RequestData(vtkInformation *request,
       {
         reader->Modified();
       }
-      if (reader->MakeMetaDataAtTimeStep(false))
+      readers.push_back(reader);
+    }
+
+    // read the boundary files and field headers of all processor
+    // subdirectories concurrently, then update the shared selections in
+    // processor order
+    vtkPOpenFOAMCacheMetaData cacheMetaData;
+    cacheMetaData.Readers = &readers;
+    vtkSMPTools::For(0, static_cast<vtkIdType>(readers.size()), 1,
+        cacheMetaData);
+    std::vector<vtkOpenFOAMReader *> activeReaders;
+    for (size_t readerI = 0; readerI < readers.size(); readerI++)
+    {
+      if (readers[readerI]->MakeMetaDataAtTimeStep(false))
       {
-        append->AddInputConnection(reader->GetOutputPort());
+        activeReaders.push_back(readers[readerI]);
       }
     }
 
     this->GatherMetaData();
 
-    if (append->GetNumberOfInputConnections(0) == 0)
+    if (activeReaders.empty())
     {
       output->Initialize();
       ret = 0;
@@ -366,7 +457,22 @@ int vtkPOpenFOAMReader::RequestData(vtkInformation *request,
     else
     {
       // reader->RequestInformation() and RequestData() are called
-      // for all reader instances without setting UPDATE_TIME_STEPS
+      // for all reader instances without setting UPDATE_TIME_STEPS.
+      // The processor subdirectories are read concurrently and the
+      // outputs appended in processor order.
+      vtkPOpenFOAMUpdate update;
+      update.Readers = &activeReaders;
+      this->Superclass::ReadingConcurrently = true;
+      vtkSMPTools::For(0, static_cast<vtkIdType>(activeReaders.size()), 1,
+          update);
+      this->Superclass::ReadingConcurrently = false;
+      for (size_t readerI = 0; readerI < activeReaders.size(); readerI++)
+      {
+        vtkMultiBlockDataSet *subOutput = vtkMultiBlockDataSet::New();
+        subOutput->ShallowCopy(activeReaders[readerI]->GetOutput());
+        append->AddInputDataObject(subOutput);
+        subOutput->Delete();
+      }
       append->Update();
       output->ShallowCopy(append->GetOutput());
     }
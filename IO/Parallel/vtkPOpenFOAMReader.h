@@ -22,6 +22,12 @@
  * transient data for the cells. Each folder can contain any number of
  * data files.
  *
+ * The processor subdirectories assigned to a process are scanned and read
+ * concurrently with vtkSMPTools, one reader instance per subdirectory,
+ * and the outputs are appended in processor order. Array and patch
+ * selections are still built serially so that they do not depend on the
+ * number of threads.
+ *
  * @par Thanks:
  * This class was developed by Takuya Oshima at Niigata University,
  * Japan (oshima@eng.niigata-u.ac.jp).
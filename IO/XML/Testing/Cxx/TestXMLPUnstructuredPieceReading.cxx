@@ -0,0 +1,196 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLPUnstructuredPieceReading.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Writes a sphere as parallel polydata and unstructured grid files with
+// 8 pieces, reads all the pieces at once (the piece files are then read
+// concurrently), and checks that the output is the pieces read one at a
+// time, appended in order.
+
+#include "vtkAppendFilter.h"
+#include "vtkAppendPolyData.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkElevationFilter.h"
+#include "vtkIdFilter.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSphereSource.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkXMLPPolyDataReader.h"
+#include "vtkXMLPPolyDataWriter.h"
+#include "vtkXMLPUnstructuredGridReader.h"
+#include "vtkXMLPUnstructuredGridWriter.h"
+
+#include <iostream>
+#include <string>
+
+namespace
+{
+const int NumberOfPieces = 8;
+
+bool SameArray(vtkDataArray* a, vtkDataArray* b)
+{
+  if (!a || !b || a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType t = 0; t < a->GetNumberOfTuples(); ++t)
+  {
+    for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+    {
+      if (a->GetComponent(t, c) != b->GetComponent(t, c))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool SameData(vtkPointSet* a, vtkPointSet* b)
+{
+  if (a->GetNumberOfPoints() == 0 ||
+      !SameArray(a->GetPoints()->GetData(), b->GetPoints()->GetData()) ||
+      a->GetPointData()->GetNumberOfArrays() !=
+        b->GetPointData()->GetNumberOfArrays() ||
+      a->GetCellData()->GetNumberOfArrays() !=
+        b->GetCellData()->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < a->GetPointData()->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray* x = a->GetPointData()->GetArray(i);
+    if (!SameArray(x, b->GetPointData()->GetArray(x->GetName())))
+    {
+      return false;
+    }
+  }
+  for (int i = 0; i < a->GetCellData()->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray* x = a->GetCellData()->GetArray(i);
+    if (!SameArray(x, b->GetCellData()->GetArray(x->GetName())))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameCells(vtkCellArray* a, vtkCellArray* b)
+{
+  return a->GetNumberOfCells() == b->GetNumberOfCells() &&
+    SameArray(a->GetData(), b->GetData());
+}
+}
+
+int TestXMLPUnstructuredPieceReading(int argc, char* argv[])
+{
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  if (!tempDir)
+  {
+    std::cout << "Could not determine temporary directory.\n";
+    return EXIT_FAILURE;
+  }
+  std::string testDirectory = tempDir;
+  delete[] tempDir;
+
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(64);
+  sphere->SetPhiResolution(32);
+  vtkNew<vtkElevationFilter> elevation;
+  elevation->SetInputConnection(sphere->GetOutputPort());
+  vtkNew<vtkIdFilter> ids;
+  ids->SetInputConnection(elevation->GetOutputPort());
+
+  // Poly data
+  std::string pvtp = testDirectory + "/TestXMLPUnstructuredPieceReading.pvtp";
+  vtkNew<vtkXMLPPolyDataWriter> pdWriter;
+  pdWriter->SetInputConnection(ids->GetOutputPort());
+  pdWriter->SetFileName(pvtp.c_str());
+  pdWriter->SetNumberOfPieces(NumberOfPieces);
+  pdWriter->SetStartPiece(0);
+  pdWriter->SetEndPiece(NumberOfPieces - 1);
+  pdWriter->Write();
+
+  vtkNew<vtkXMLPPolyDataReader> pdReader;
+  pdReader->SetFileName(pvtp.c_str());
+  pdReader->Update();
+
+  vtkNew<vtkAppendPolyData> pdPieces;
+  for (int i = 0; i < NumberOfPieces; ++i)
+  {
+    vtkNew<vtkXMLPPolyDataReader> pieceReader;
+    pieceReader->SetFileName(pvtp.c_str());
+    // the reader hides vtkAlgorithm::UpdatePiece with a member
+    vtkAlgorithm* algorithm = pieceReader;
+    algorithm->UpdatePiece(i, NumberOfPieces, 0);
+    pdPieces->AddInputData(pieceReader->GetOutput());
+  }
+  pdPieces->Update();
+
+  vtkPolyData* pd = pdReader->GetOutput();
+  if (!SameData(pd, pdPieces->GetOutput()) ||
+      !SameCells(pd->GetPolys(), pdPieces->GetOutput()->GetPolys()))
+  {
+    std::cerr << "The poly data pieces read together differ from the "
+                 "pieces read one at a time." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Unstructured grid
+  vtkNew<vtkAppendFilter> toGrid;
+  toGrid->SetInputConnection(ids->GetOutputPort());
+  std::string pvtu = testDirectory + "/TestXMLPUnstructuredPieceReading.pvtu";
+  vtkNew<vtkXMLPUnstructuredGridWriter> ugWriter;
+  ugWriter->SetInputConnection(toGrid->GetOutputPort());
+  ugWriter->SetFileName(pvtu.c_str());
+  ugWriter->SetNumberOfPieces(NumberOfPieces);
+  ugWriter->SetStartPiece(0);
+  ugWriter->SetEndPiece(NumberOfPieces - 1);
+  ugWriter->Write();
+
+  vtkNew<vtkXMLPUnstructuredGridReader> ugReader;
+  ugReader->SetFileName(pvtu.c_str());
+  ugReader->Update();
+
+  vtkNew<vtkAppendFilter> ugPieces;
+  for (int i = 0; i < NumberOfPieces; ++i)
+  {
+    vtkNew<vtkXMLPUnstructuredGridReader> pieceReader;
+    pieceReader->SetFileName(pvtu.c_str());
+    // the reader hides vtkAlgorithm::UpdatePiece with a member
+    vtkAlgorithm* algorithm = pieceReader;
+    algorithm->UpdatePiece(i, NumberOfPieces, 0);
+    ugPieces->AddInputData(pieceReader->GetOutput());
+  }
+  ugPieces->Update();
+
+  vtkUnstructuredGrid* ug = ugReader->GetOutput();
+  vtkUnstructuredGrid* ugExpected = ugPieces->GetOutput();
+  if (!SameData(ug, ugExpected) ||
+      !SameCells(ug->GetCells(), ugExpected->GetCells()))
+  {
+    std::cerr << "The unstructured grid pieces read together differ from "
+                 "the pieces read one at a time." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
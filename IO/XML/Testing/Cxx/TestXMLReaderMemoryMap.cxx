@@ -0,0 +1,210 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLReaderMemoryMap.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Reads raw appended images with memory mapping, and checks that the
+// arrays written in native byte order are mapped, that they match the ones
+// read without mapping, that they outlive the reader, and that modifying or
+// resizing them leaves the file unchanged.
+
+#include "vtkCharArray.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkShortArray.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestUtilities.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+
+#include <iostream>
+#include <string>
+
+namespace
+{
+vtkSmartPointer<vtkImageData> Read(const std::string& fileName, bool map,
+                                   vtkIdType* numMapped = nullptr)
+{
+  vtkNew<vtkXMLImageDataReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->SetMemoryMapAppendedData(map);
+  reader->Update();
+  if (numMapped)
+  {
+    *numMapped = reader->GetNumberOfMappedArrays();
+  }
+  vtkSmartPointer<vtkImageData> image = reader->GetOutput();
+  return image;
+}
+
+bool SameArrays(vtkImageData* a, vtkImageData* b)
+{
+  vtkPointData* pa = a->GetPointData();
+  vtkPointData* pb = b->GetPointData();
+  if (pa->GetNumberOfArrays() != pb->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < pa->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray* x = pa->GetArray(i);
+    vtkDataArray* y = pb->GetArray(x->GetName());
+    if (!y || x->GetNumberOfTuples() != y->GetNumberOfTuples() ||
+        x->GetNumberOfComponents() != y->GetNumberOfComponents())
+    {
+      return false;
+    }
+    for (vtkIdType t = 0; t < x->GetNumberOfTuples(); ++t)
+    {
+      for (int c = 0; c < x->GetNumberOfComponents(); ++c)
+      {
+        if (x->GetComponent(t, c) != y->GetComponent(t, c))
+        {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool TestFile(vtkImageData* image, const std::string& fileName,
+              int byteOrder, int headerType, bool compress,
+              vtkIdType expectedMapped)
+{
+  vtkNew<vtkXMLImageDataWriter> writer;
+  writer->SetInputData(image);
+  writer->SetFileName(fileName.c_str());
+  writer->SetDataModeToAppended();
+  writer->EncodeAppendedDataOff();
+  writer->SetByteOrder(byteOrder);
+  writer->SetHeaderType(headerType);
+  if (!compress)
+  {
+    writer->SetCompressorTypeToNone();
+  }
+  writer->Write();
+
+  vtkIdType numMapped;
+  vtkSmartPointer<vtkImageData> read = Read(fileName, false);
+  vtkSmartPointer<vtkImageData> mapped = Read(fileName, true, &numMapped);
+  if (numMapped != expectedMapped)
+  {
+    std::cerr << numMapped << " arrays were mapped instead of "
+              << expectedMapped << "." << std::endl;
+    return false;
+  }
+  if (!SameArrays(image, read) || !SameArrays(image, mapped))
+  {
+    std::cerr << "Mapped arrays differ from the arrays read." << std::endl;
+    return false;
+  }
+
+  // Modify and resize the mapped arrays, then check the file is unchanged.
+  vtkPointData* pd = mapped->GetPointData();
+  for (int i = 0; i < pd->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray* array = pd->GetArray(i);
+    array->SetComponent(0, 0, 42);
+    if (i % 2)
+    {
+      array->InsertNextTuple(array->GetTuple(1));
+      if (array->GetComponent(0, 0) != 42)
+      {
+        std::cerr << "Resizing a mapped array lost its values." << std::endl;
+        return false;
+      }
+    }
+  }
+  mapped = nullptr;
+  if (!SameArrays(image, Read(fileName, true)))
+  {
+    std::cerr << "Modifying mapped arrays changed the file." << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int TestXMLReaderMemoryMap(int argc, char* argv[])
+{
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault(
+    "-T", argc, argv, "VTK_TEMP_DIR", "Testing/Temporary");
+  std::string fileName = std::string(tempDir) + "/TestXMLReaderMemoryMap.vti";
+  delete[] tempDir;
+
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(30, 20, 10);
+  vtkIdType numPts = image->GetNumberOfPoints();
+  vtkNew<vtkCharArray> chars;
+  chars->SetName("Chars");
+  chars->SetNumberOfTuples(numPts);
+  vtkNew<vtkShortArray> shorts;
+  shorts->SetName("Shorts");
+  shorts->SetNumberOfComponents(3);
+  shorts->SetNumberOfTuples(numPts);
+  vtkNew<vtkFloatArray> floats;
+  floats->SetName("Floats");
+  floats->SetNumberOfTuples(numPts);
+  vtkNew<vtkDoubleArray> doubles;
+  doubles->SetName("Doubles");
+  doubles->SetNumberOfComponents(2);
+  doubles->SetNumberOfTuples(numPts);
+  vtkNew<vtkIdTypeArray> ids;
+  ids->SetName("Ids");
+  ids->SetNumberOfTuples(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    chars->SetValue(i, static_cast<char>(i % 100));
+    shorts->SetTuple3(i, i % 1000, -(i % 300), i % 7);
+    floats->SetValue(i, 0.5f * i);
+    doubles->SetTuple2(i, 0.25 * i, -1.0 * i);
+    ids->SetValue(i, 3 * i);
+  }
+  image->GetPointData()->AddArray(chars);
+  image->GetPointData()->AddArray(shorts);
+  image->GetPointData()->AddArray(floats);
+  image->GetPointData()->AddArray(doubles);
+  image->GetPointData()->AddArray(ids);
+
+  // Native and swapped byte orders, both header types, and compressed
+  // data. Swapped and compressed data is read rather than mapped; in native
+  // byte order the writer aligns every array so that all of them are mapped.
+#ifdef VTK_WORDS_BIGENDIAN
+  const int nativeOrder = vtkXMLWriter::BigEndian;
+  const int swappedOrder = vtkXMLWriter::LittleEndian;
+#else
+  const int nativeOrder = vtkXMLWriter::LittleEndian;
+  const int swappedOrder = vtkXMLWriter::BigEndian;
+#endif
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  const vtkIdType numArrays = 0;
+#else
+  const vtkIdType numArrays = image->GetPointData()->GetNumberOfArrays();
+#endif
+  if (!TestFile(image, fileName, nativeOrder, vtkXMLWriter::UInt32, false,
+                numArrays) ||
+      !TestFile(image, fileName, nativeOrder, vtkXMLWriter::UInt64, false,
+                numArrays) ||
+      !TestFile(image, fileName, swappedOrder, vtkXMLWriter::UInt64, false,
+                0) ||
+      !TestFile(image, fileName, nativeOrder, vtkXMLWriter::UInt64, true,
+                0))
+  {
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
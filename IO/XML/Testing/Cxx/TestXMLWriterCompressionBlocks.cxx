@@ -0,0 +1,148 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLWriterCompressionBlocks.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Writes an image with each compressor, queuing a varying number of blocks
+// for concurrent compression, and checks that the files are identical to
+// the ones written one block at a time.  Then reads them back, with a
+// varying number of blocks decompressed concurrently.
+
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkXMLDataParser.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+namespace
+{
+std::string Write(vtkImageData* image, int compressor, int dataMode,
+                  int byteOrder, int blocksInFlight)
+{
+  vtkNew<vtkXMLImageDataWriter> writer;
+  writer->SetInputData(image);
+  writer->WriteToOutputStringOn();
+  writer->SetCompressorType(compressor);
+  writer->SetDataMode(dataMode);
+  writer->SetByteOrder(byteOrder);
+  writer->SetIdTypeToInt32();
+  writer->SetBlockSize(1024);
+  writer->SetCompressionBlocksInFlight(blocksInFlight);
+  writer->Write();
+  return writer->GetOutputString();
+}
+
+bool ReadsBack(vtkImageData* image, const std::string& data,
+               int blocksInFlight)
+{
+  vtkNew<vtkXMLImageDataReader> reader;
+  reader->ReadFromInputStringOn();
+  reader->SetInputString(data);
+  reader->UpdateInformation();
+  reader->GetXMLParser()->SetDecompressionBlocksInFlight(blocksInFlight);
+  reader->Update();
+  vtkPointData* expected = image->GetPointData();
+  vtkPointData* actual = reader->GetOutput()->GetPointData();
+  for (int i = 0; i < expected->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray* a = expected->GetArray(i);
+    vtkDataArray* b = actual->GetArray(a->GetName());
+    if (!b || a->GetNumberOfTuples() != b->GetNumberOfTuples())
+    {
+      return false;
+    }
+    for (vtkIdType t = 0; t < a->GetNumberOfTuples(); ++t)
+    {
+      for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+      {
+        if (a->GetComponent(t, c) != b->GetComponent(t, c))
+        {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+}
+
+int TestXMLWriterCompressionBlocks(int, char*[])
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(20, 15, 10);
+  vtkIdType numPts = image->GetNumberOfPoints();
+  vtkNew<vtkFloatArray> floats;
+  floats->SetName("Floats");
+  floats->SetNumberOfComponents(3);
+  floats->SetNumberOfTuples(numPts);
+  vtkNew<vtkDoubleArray> doubles;
+  doubles->SetName("Doubles");
+  doubles->SetNumberOfTuples(numPts);
+  vtkNew<vtkIdTypeArray> ids;
+  ids->SetName("Ids");
+  ids->SetNumberOfTuples(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    floats->SetTuple3(i, std::sin(0.01 * i), std::cos(0.02 * i), i % 17);
+    doubles->SetValue(i, std::sqrt(static_cast<double>(i)));
+    ids->SetValue(i, i / 3);
+  }
+  image->GetPointData()->AddArray(floats);
+  image->GetPointData()->AddArray(doubles);
+  image->GetPointData()->AddArray(ids);
+
+  const int compressors[4] = { vtkXMLWriter::ZLIB, vtkXMLWriter::LZ4,
+    vtkXMLWriter::LZMA, vtkXMLWriter::LZ4HC };
+  const int dataModes[2] = { vtkXMLWriter::Binary, vtkXMLWriter::Appended };
+  const int byteOrders[2] = { vtkXMLWriter::LittleEndian,
+    vtkXMLWriter::BigEndian };
+  for (int c = 0; c < 4; ++c)
+  {
+    for (int m = 0; m < 2; ++m)
+    {
+      for (int o = 0; o < 2; ++o)
+      {
+        std::string serial =
+          Write(image, compressors[c], dataModes[m], byteOrders[o], 1);
+        const int blocksInFlight[4] = { 1, 0, 3, 1000 };
+        for (int b = 0; b < 4; ++b)
+        {
+          if (!ReadsBack(image, serial, blocksInFlight[b]))
+          {
+            std::cerr << "Compressor " << compressors[c] << " with "
+                      << blocksInFlight[b]
+                      << " blocks in flight does not read back." << std::endl;
+            return EXIT_FAILURE;
+          }
+          if (b > 0 && Write(image, compressors[c], dataModes[m],
+                             byteOrders[o], blocksInFlight[b]) != serial)
+          {
+            std::cerr << "Compressor " << compressors[c] << " with "
+                      << blocksInFlight[b]
+                      << " blocks in flight differs from serial output."
+                      << std::endl;
+            return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -16,11 +16,34 @@
 #include "vtkXMLDataElement.h"
 #include "vtkXMLUnstructuredDataReader.h"
 #include "vtkPointSet.h"
+#include "vtkCallbackCommand.h"
 #include "vtkCellArray.h"
+#include "vtkDataArraySelection.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkSMPTools.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
+#include <vector>
+
+namespace
+{
+// Reads the files of several pieces concurrently. Each piece reader only
+// reads its own file into its own output.
+struct vtkXMLPUnstructuredDataReadPieces
+{
+  std::vector<vtkXMLDataReader*>* Readers;
+  int GhostLevel;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      (*this->Readers)[i]->UpdatePiece(0, 1, this->GhostLevel);
+    }
+  }
+};
+}
 
 //----------------------------------------------------------------------------
 vtkXMLPUnstructuredDataReader::vtkXMLPUnstructuredDataReader()
@@ -309,6 +332,10 @@ void vtkXMLPUnstructuredDataReader::ReadXMLData()
       fractions[this->EndPiece-this->StartPiece];
   }
 
+  // Read the piece files concurrently, then copy each piece into the
+  // preallocated output in order.
+  this->ReadPieceFiles();
+
   // Read the data needed from each piece.
   for(int i = this->StartPiece;
     (i < this->EndPiece && !this->AbortExecute && !this->DataError); ++i)
@@ -327,6 +354,46 @@ void vtkXMLPUnstructuredDataReader::ReadXMLData()
   delete [] fractions;
 }
 
+//----------------------------------------------------------------------------
+void vtkXMLPUnstructuredDataReader::ReadPieceFiles()
+{
+  // The selections and the progress observer are set up serially. The
+  // progress callback reports the progress of the current piece, so it is
+  // detached while the pieces are read concurrently.
+  std::vector<vtkXMLDataReader*> readers;
+  for (int i = this->StartPiece; i < this->EndPiece; ++i)
+  {
+    if (this->CanReadPiece(i))
+    {
+      vtkXMLDataReader* reader = this->PieceReaders[i];
+      reader->SetAbortExecute(0);
+      reader->GetPointDataArraySelection()->CopySelections(
+        this->PointDataArraySelection);
+      reader->GetCellDataArraySelection()->CopySelections(
+        this->CellDataArraySelection);
+      readers.push_back(reader);
+    }
+  }
+  if (readers.size() < 2)
+  {
+    return;
+  }
+
+  for (size_t i = 0; i < readers.size(); ++i)
+  {
+    readers[i]->RemoveObserver(this->PieceProgressObserver);
+  }
+  vtkXMLPUnstructuredDataReadPieces readPieces;
+  readPieces.Readers = &readers;
+  readPieces.GhostLevel = this->UpdateGhostLevel;
+  vtkSMPTools::For(0, static_cast<vtkIdType>(readers.size()), 1, readPieces);
+  for (size_t i = 0; i < readers.size(); ++i)
+  {
+    readers[i]->AddObserver(
+      vtkCommand::ProgressEvent, this->PieceProgressObserver);
+  }
+}
+
 //----------------------------------------------------------------------------
 int vtkXMLPUnstructuredDataReader::ReadPieceData()
 {
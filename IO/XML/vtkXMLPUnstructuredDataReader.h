@@ -19,6 +19,10 @@
  * vtkXMLPUnstructuredDataReader provides functionality common to all
  * parallel unstructured data format readers.
  *
+ * When the requested piece is made of several pieces of the file, their
+ * files are read concurrently with vtkSMPTools, each by its own piece
+ * reader, and are then copied into the preallocated output in order.
+ *
  * @sa
  * vtkXMLPPolyDataReader vtkXMLPUnstructuredGridReader
 */
@@ -75,6 +79,11 @@ protected:
   void SetupUpdateExtent(int piece, int numberOfPieces, int ghostLevel);
 
   int ReadPieceData() override;
+
+  // Update the readers of the pieces from StartPiece to EndPiece
+  // concurrently. ReadPieceData then finds their outputs up to date.
+  void ReadPieceFiles();
+
   void CopyCellArray(vtkIdType totalNumberOfCells, vtkCellArray* inCells,
                      vtkCellArray* outCells);
 
@@ -34,6 +34,7 @@
 #include "vtkInformationUnsignedLongKey.h"
 #include "vtkInformationVector.h"
 #include "vtkLZ4DataCompressor.h"
+#include "vtkLZ4HCDataCompressor.h"
 #include "vtkLZMADataCompressor.h"
 #include "vtkObjectFactory.h"
 #include "vtkQuadratureSchemeDefinition.h"
@@ -106,6 +107,8 @@ vtkXMLReader::vtkXMLReader()
   this->StringStream = nullptr;
   this->ReadFromInputString = 0;
   this->InputString = "";
+  this->MemoryMapAppendedData = 0;
+  this->NumberOfMappedArrays = 0;
   this->XMLParser = nullptr;
   this->ReaderErrorObserver = nullptr;
   this->ParserErrorObserver = nullptr;
@@ -201,6 +204,10 @@ void vtkXMLReader::PrintSelf(ostream& os, vtkIndent indent)
   {
     os << indent << "Stream: (none)\n";
   }
+  os << indent << "MemoryMapAppendedData: " << this->MemoryMapAppendedData
+     << "\n";
+  os << indent << "NumberOfMappedArrays: " << this->NumberOfMappedArrays
+     << "\n";
   os << indent << "TimeStep:" << this->TimeStep << "\n";
   os << indent << "NumberOfTimeSteps:" << this->NumberOfTimeSteps << "\n";
   os << indent << "TimeStepRange:(" << this->TimeStepRange[0] << ","
@@ -427,6 +434,10 @@ void vtkXMLReader::SetupCompressor(const char* type)
     {
       compressor = vtkLZMADataCompressor::New();
     }
+    else if (strcmp(type, "vtkLZ4HCDataCompressor") == 0)
+    {
+      compressor = vtkLZ4HCDataCompressor::New();
+    }
   }
 
   if (!compressor)
@@ -658,6 +669,7 @@ int vtkXMLReader::RequestData(vtkInformation *vtkNotUsed(request),
     // We are just starting to execute.  No errors have yet occurred.
     this->XMLParser->SetAbort(0);
     this->DataError = 0;
+    this->NumberOfMappedArrays = 0;
 
     // Let the subclasses read the data they want.
     this->ReadXMLData();
@@ -844,19 +856,44 @@ int vtkXMLReader::ReadArrayValues(
   }
   this->InReadData = 1;
   int result;
-  // All arrays types except vtkBitArray.
-  vtkArrayIterator* iter = array->NewIterator();
-  switch (array->GetDataType())
+
+  // Use raw appended data in place when the whole array is read from a
+  // file opened by this reader.
+  void* mapped = nullptr;
+  if (this->MemoryMapAppendedData && this->FileStream &&
+      arrayIndex == 0 && startIndex == 0 &&
+      numValues == array->GetNumberOfValues() &&
+      array->HasStandardMemoryLayout() && da->GetAttribute("offset"))
   {
-    vtkArrayIteratorTemplateMacro(
-      result = vtkXMLDataReaderReadArrayValues(da, this->XMLParser,
-        arrayIndex, static_cast<VTK_TT*>(iter), startIndex, numValues));
-  default:
-    result = 0;
+    vtkTypeInt64 offset = 0;
+    da->GetScalarAttribute("offset", offset);
+    mapped = this->XMLParser->MapAppendedData(this->FileName, offset,
+      static_cast<size_t>(numValues), array->GetDataType());
   }
-  if (iter)
+  if (mapped)
   {
-    iter->Delete();
+    array->SetVoidArray(mapped, numValues, 0,
+                        vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+    array->SetArrayFreeFunction(&vtkXMLDataParser::UnmapAppendedData);
+    this->NumberOfMappedArrays++;
+    result = 1;
+  }
+  else
+  {
+    // All arrays types except vtkBitArray.
+    vtkArrayIterator* iter = array->NewIterator();
+    switch (array->GetDataType())
+    {
+      vtkArrayIteratorTemplateMacro(
+        result = vtkXMLDataReaderReadArrayValues(da, this->XMLParser,
+          arrayIndex, static_cast<VTK_TT*>(iter), startIndex, numValues));
+    default:
+      result = 0;
+    }
+    if (iter)
+    {
+      iter->Delete();
+    }
   }
 
   this->ConvertGhostLevelsToGhostType(fieldType, array, startIndex, numValues);
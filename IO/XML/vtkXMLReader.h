@@ -72,6 +72,29 @@ public:
   void SetInputString(const std::string& s) { this->InputString = s; }
   //@}
 
+  //@{
+  /**
+   * Enable mapping raw appended data from the file into memory instead of
+   * reading it.  Arrays read as a whole from uncompressed appended data
+   * with encoding="raw", in the byte order of this machine and aligned in
+   * the file (as vtkXMLWriter writes them), then use the mapped file
+   * contents as their storage.  The mapping is private, so modifying such
+   * an array copies the pages it touches, and the file is never changed.
+   * The file must not be truncated while its arrays are in use.  Other
+   * arrays are read as usual.  Off by default, and not available on
+   * Windows.
+   */
+  vtkSetMacro(MemoryMapAppendedData, vtkTypeBool);
+  vtkGetMacro(MemoryMapAppendedData, vtkTypeBool);
+  vtkBooleanMacro(MemoryMapAppendedData, vtkTypeBool);
+  //@}
+
+  /**
+   * Get the number of arrays whose values were mapped into memory during
+   * the last execution of this reader (see MemoryMapAppendedData).
+   */
+  vtkGetMacro(NumberOfMappedArrays, vtkIdType);
+
   /**
    * Test whether the file (type) with the given name can be read by this
    * reader. If the file has a newer version than the reader, we still say
@@ -315,6 +338,10 @@ protected:
   // The input string.
   std::string InputString;
 
+  // Whether raw appended data is mapped into memory rather than read.
+  vtkTypeBool MemoryMapAppendedData;
+  vtkIdType NumberOfMappedArrays;
+
   // The array selections.
   vtkDataArraySelection* PointDataArraySelection;
   vtkDataArraySelection* CellDataArraySelection;
@@ -39,11 +39,13 @@
 #include "vtkInformationUnsignedLongKey.h"
 #include "vtkInformationVector.h"
 #include "vtkLZ4DataCompressor.h"
+#include "vtkLZ4HCDataCompressor.h"
 #include "vtkLZMADataCompressor.h"
 #include "vtkNew.h"
 #include "vtkOutputStream.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
+#include "vtkSMPTools.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnsignedCharArray.h"
@@ -65,6 +67,7 @@
 #include <cassert>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #if !defined(_WIN32) || defined(__CYGWIN__)
 # include <unistd.h> /* unlink */
@@ -75,6 +78,49 @@
 #include <cctype> // for isalnum
 #include <locale> // C++ locale
 
+//*****************************************************************************
+// Blocks of the array being written that wait to be compressed, in output
+// order.  The buffers are kept between batches to avoid reallocating them.
+class vtkXMLWriterCompressionQueue
+{
+public:
+  struct Block
+  {
+    std::vector<unsigned char> Data;
+    std::vector<unsigned char> Compressed;
+    size_t Size;
+    size_t CompressedSize;
+  };
+
+  std::vector<Block> Blocks;
+  size_t NumberOfBlocks = 0;
+};
+
+namespace
+{
+// Compresses a range of queued blocks.  The compressors keep no state
+// between calls, so independent blocks may be compressed concurrently.
+struct vtkXMLWriterCompressBlocks
+{
+  vtkDataCompressor* Compressor;
+  vtkXMLWriterCompressionQueue::Block* Blocks;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      vtkXMLWriterCompressionQueue::Block& block = this->Blocks[i];
+      size_t space = this->Compressor->GetMaximumCompressionSpace(block.Size);
+      if (block.Compressed.size() < space)
+      {
+        block.Compressed.resize(space);
+      }
+      block.CompressedSize = this->Compressor->Compress(
+        block.Data.data(), block.Size, block.Compressed.data(), space);
+    }
+  }
+};
+}
 
 //*****************************************************************************
 // Friend class to enable access for template functions to the protected
@@ -475,6 +521,8 @@ vtkXMLWriter::vtkXMLWriter()
   this->BlockSize = 32768; //2^15
   this->Compressor = vtkZLibDataCompressor::New();
   this->CompressionHeader = nullptr;
+  this->CompressionBlocksInFlight = 0;
+  this->CompressionQueue = new vtkXMLWriterCompressionQueue;
   this->Int32IdTypeBuffer = nullptr;
   this->ByteSwapBuffer = nullptr;
 
@@ -511,6 +559,7 @@ vtkXMLWriter::~vtkXMLWriter()
   this->OutStringStream = nullptr;
   delete this->FieldDataOM;
   delete[] this->NumberOfTimeValues;
+  delete this->CompressionQueue;
 }
 
 //----------------------------------------------------------------------------
@@ -555,6 +604,16 @@ void vtkXMLWriter::SetCompressorType(int compressorType)
     this->Compressor->SetCompressionLevel(this->CompressionLevel);
     this->Modified();
   }
+  else if (compressorType == LZ4HC)
+  {
+    if (this->Compressor &&
+        !this->Compressor->IsTypeOf("vtkLZ4HCDataCompressor")) {
+      this->Compressor->Delete();
+    }
+    this->Compressor = vtkLZ4HCDataCompressor::New();
+    this->Compressor->SetCompressionLevel(this->CompressionLevel);
+    this->Modified();
+  }
   else
   {
     vtkWarningMacro("Invalid compressorType:" << compressorType);
@@ -620,6 +679,8 @@ void vtkXMLWriter::PrintSelf(ostream& os, vtkIndent indent)
   }
   os << indent << "EncodeAppendedData: " << this->EncodeAppendedData << "\n";
   os << indent << "BlockSize: " << this->BlockSize << "\n";
+  os << indent << "CompressionBlocksInFlight: "
+     << this->CompressionBlocksInFlight << "\n";
   if (this->Stream)
   {
     os << indent << "Stream: " << this->Stream << "\n";
@@ -1324,6 +1385,9 @@ int vtkXMLWriter::WriteBinaryData(vtkAbstractArray* a)
     {
       return 0;
     }
+    // Let a compressor that filters words know the size of those written.
+    this->Compressor->SetWordSize(wordType != VTK_BIT ?
+      static_cast<int>(this->GetOutputWordTypeSize(wordType)) : 1);
     // Start writing the data.
     int result = this->DataStream->StartWriting();
 
@@ -1333,6 +1397,13 @@ int vtkXMLWriter::WriteBinaryData(vtkAbstractArray* a)
       result = 0;
     }
 
+    // Compress and write the blocks still queued.
+    if (result && !this->FlushCompressionBlocks())
+    {
+      result = 0;
+    }
+    this->CompressionQueue->NumberOfBlocks = 0;
+
     // Finish writing the data.
     if (result && !this->DataStream->EndWriting())
     {
@@ -1692,6 +1763,7 @@ int vtkXMLWriter::CreateCompressionHeader(size_t size)
 
   // Initialize counter for block writing.
   this->CompressionBlockNumber = 0;
+  this->CompressionQueue->NumberOfBlocks = 0;
 
   return result;
 }
@@ -1699,8 +1771,39 @@ int vtkXMLWriter::CreateCompressionHeader(size_t size)
 //----------------------------------------------------------------------------
 int vtkXMLWriter::WriteCompressionBlock(unsigned char* data, size_t size)
 {
+  size_t maxBlocks = static_cast<size_t>(this->CompressionBlocksInFlight);
+  if (maxBlocks == 0)
+  {
+    int numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+    maxBlocks = (numThreads > 1 ? 4 * static_cast<size_t>(numThreads) : 1);
+  }
+  vtkXMLWriterCompressionQueue* queue = this->CompressionQueue;
+  if (maxBlocks > 1)
+  {
+    // Queue a copy of the block, since the caller reuses its buffer, and
+    // compress the queue once it is full.
+    if (queue->Blocks.size() <= queue->NumberOfBlocks)
+    {
+      queue->Blocks.resize(queue->NumberOfBlocks + 1);
+    }
+    vtkXMLWriterCompressionQueue::Block& block =
+      queue->Blocks[queue->NumberOfBlocks++];
+    if (block.Data.size() < size)
+    {
+      block.Data.resize(size);
+    }
+    memcpy(block.Data.data(), data, size);
+    block.Size = size;
+    return (queue->NumberOfBlocks < maxBlocks ? 1 :
+            this->FlushCompressionBlocks());
+  }
+
   // Compress the data.
   vtkUnsignedCharArray* outputArray = this->Compressor->Compress(data, size);
+  if (!outputArray)
+  {
+    return 0;
+  }
 
   // Find the compressed size.
   size_t outputSize = outputArray->GetNumberOfTuples();
@@ -1722,6 +1825,46 @@ int vtkXMLWriter::WriteCompressionBlock(unsigned char* data, size_t size)
   return result;
 }
 
+//----------------------------------------------------------------------------
+int vtkXMLWriter::FlushCompressionBlocks()
+{
+  vtkXMLWriterCompressionQueue* queue = this->CompressionQueue;
+  size_t numBlocks = queue->NumberOfBlocks;
+  queue->NumberOfBlocks = 0;
+  if (numBlocks == 0)
+  {
+    return 1;
+  }
+
+  vtkXMLWriterCompressBlocks compress;
+  compress.Compressor = this->Compressor;
+  compress.Blocks = queue->Blocks.data();
+  vtkSMPTools::For(0, static_cast<vtkIdType>(numBlocks), 1, compress);
+
+  // Write the compressed blocks in order, and store their sizes in the
+  // compression header.
+  int result = 1;
+  for (size_t i = 0; i < numBlocks && result; ++i)
+  {
+    vtkXMLWriterCompressionQueue::Block& block = queue->Blocks[i];
+    if (!block.CompressedSize)
+    {
+      return 0;
+    }
+    result = this->DataStream->Write(block.Compressed.data(),
+                                     block.CompressedSize);
+    this->CompressionHeader->Set(3+this->CompressionBlockNumber++,
+                                 block.CompressedSize);
+  }
+  this->Stream->flush();
+  if (this->Stream->fail())
+  {
+    this->SetErrorCode(vtkErrorCode::GetLastSystemError());
+    return 0;
+  }
+  return result;
+}
+
 //----------------------------------------------------------------------------
 int vtkXMLWriter::WriteCompressionHeader()
 {
@@ -2325,6 +2468,24 @@ void vtkXMLWriter::WriteArrayAppendedData(vtkAbstractArray* a,
                                           vtkTypeInt64 pos,
                                           vtkTypeInt64& lastoffset)
 {
+  // Pad raw uncompressed data so that the values start at a multiple of
+  // their size in the file.  vtkXMLReader can then map them into memory.
+  int wordType = a->GetDataType();
+  if (!this->EncodeAppendedData && !this->Compressor &&
+      vtkArrayDownCast<vtkDataArray>(a) && wordType != VTK_BIT)
+  {
+    ostream& os = *(this->Stream);
+    vtkTypeInt64 wordSize =
+      static_cast<vtkTypeInt64>(this->GetOutputWordTypeSize(wordType));
+    vtkTypeInt64 headerSize =
+      (this->HeaderType == vtkXMLWriter::UInt64) ? 8 : 4;
+    vtkTypeInt64 misalignment =
+      (static_cast<vtkTypeInt64>(os.tellp()) + headerSize) % wordSize;
+    for (vtkTypeInt64 i = misalignment; i > 0 && i < wordSize; ++i)
+    {
+      os.put('\0');
+    }
+  }
   this->WriteAppendedDataOffset(pos, lastoffset, "offset");
   this->WriteBinaryData(a);
 }
@@ -50,6 +50,7 @@ class vtkPointData;
 class vtkPoints;
 class vtkFieldData;
 class vtkXMLDataHeader;
+class vtkXMLWriterCompressionQueue;
 
 class vtkStdString;
 class OffsetsManager;      // one per piece/per time
@@ -154,7 +155,8 @@ public:
     NONE,
     ZLIB,
     LZ4,
-    LZMA
+    LZMA,
+    LZ4HC
   };
 
   //@{
@@ -178,6 +180,10 @@ public:
   {
     this->SetCompressorType(LZMA);
   }
+  void SetCompressorTypeToLZ4HC()
+  {
+    this->SetCompressorType(LZ4HC);
+  }
 
   void SetCompressionLevel(int compressorLevel);
   vtkGetMacro(CompressionLevel, int);
@@ -194,6 +200,21 @@ public:
   vtkGetMacro(BlockSize, size_t);
   //@}
 
+  //@{
+  /**
+   * Get/Set the maximum number of blocks held in memory for compression.
+   * Blocks of an array are queued until this many are pending, compressed
+   * concurrently with vtkSMPTools, and written in their original order, so
+   * the file is identical to the one written with serial compression.
+   * Memory use is bounded by about twice this number of blocks. A value of
+   * 1 compresses and writes each block as it is produced. The default, 0,
+   * queues four blocks per thread, or one block when running on a single
+   * thread.
+   */
+  vtkSetClampMacro(CompressionBlocksInFlight, int, 0, VTK_INT_MAX);
+  vtkGetMacro(CompressionBlocksInFlight, int);
+  //@}
+
   //@{
   /**
    * Get/Set the data mode used for the file's data.  The options are
@@ -213,7 +234,9 @@ public:
    * encoded, reading and writing will be slower, but the file will be
    * fully valid XML and text-only.  If not encoded, the XML
    * specification will be violated, but reading and writing will be
-   * fast.  The default is to do the encoding.
+   * fast.  The default is to do the encoding.  Uncompressed data that is
+   * not encoded is padded so that the values of each array are aligned in
+   * the file, which lets vtkXMLReader map them into memory.
    */
   vtkSetMacro(EncodeAppendedData, vtkTypeBool);
   vtkGetMacro(EncodeAppendedData, vtkTypeBool);
@@ -337,6 +360,8 @@ protected:
   size_t CompressionBlockNumber;
   vtkXMLDataHeader* CompressionHeader;
   vtkTypeInt64 CompressionHeaderPosition;
+  int CompressionBlocksInFlight;
+  vtkXMLWriterCompressionQueue* CompressionQueue;
   // Compression Level for vtkDataCompressor objects
   // 1 (worst compression, fastest) ... 9 (best compression, slowest)
   int CompressionLevel = 5;
@@ -475,6 +500,7 @@ protected:
   void PerformByteSwap(void* data, size_t numWords, size_t wordSize);
   int CreateCompressionHeader(size_t size);
   int WriteCompressionBlock(unsigned char* data, size_t size);
+  int FlushCompressionBlocks();
   int WriteCompressionHeader();
   size_t GetWordTypeSize(int dataType);
   const char* GetWordTypeName(int dataType);
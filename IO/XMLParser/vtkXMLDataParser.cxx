@@ -20,19 +20,102 @@
 #include "vtkDataCompressor.h"
 #include "vtkInputStream.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
+#include "vtkStringToNumber.h"
 #include "vtkXMLDataElement.h"
 #define vtkXMLDataHeaderPrivate_DoNotInclude
 #include "vtkXMLDataHeaderPrivate.h"
 #undef vtkXMLDataHeaderPrivate_DoNotInclude
 
 #include <algorithm>
-#include <cassert>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <vector>
 
+#if !defined(_WIN32) || defined(__CYGWIN__)
+# define VTK_XML_DATA_PARSER_USE_MMAP
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
+
 #include "vtkXMLUtilities.h"
 
+namespace
+{
+#ifdef VTK_XML_DATA_PARSER_USE_MMAP
+// The mappings made by MapAppendedData, by the address of the values
+// they hold, so that UnmapAppendedData can release them given only that
+// address.
+struct vtkXMLDataParserMapping
+{
+  void* Address;
+  size_t Length;
+};
+
+std::mutex& vtkXMLDataParserMappingsMutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::map<void*, vtkXMLDataParserMapping>& vtkXMLDataParserMappings()
+{
+  static std::map<void*, vtkXMLDataParserMapping> mappings;
+  return mappings;
+}
+#endif
+
+// Decompresses a range of blocks from a buffer holding the compressed
+// bytes of consecutive blocks, and byte swaps them in place.  Each block
+// is written to its own part of the output, so blocks are independent.
+struct vtkXMLDataParserUncompressBlocks
+{
+  vtkDataCompressor* Compressor;
+  const unsigned char* Compressed;
+  const size_t* CompressedSizes;
+  const vtkTypeInt64* StartOffsets;
+  vtkTypeInt64 BaseOffset;
+  unsigned char* Output;
+  size_t BlockSize;
+  size_t WordSize;
+  bool BigEndian;
+  std::vector<size_t> Results;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      unsigned char* out = this->Output + i * this->BlockSize;
+      this->Results[i] = this->Compressor->Uncompress(
+        this->Compressed + (this->StartOffsets[i] - this->BaseOffset),
+        this->CompressedSizes[i], out, this->BlockSize);
+      size_t numWords = this->BlockSize / this->WordSize;
+      char* ptr = reinterpret_cast<char*>(out);
+      switch (this->WordSize)
+      {
+        case 2:
+          if (this->BigEndian) { vtkByteSwap::Swap2BERange(ptr, numWords); }
+          else { vtkByteSwap::Swap2LERange(ptr, numWords); }
+          break;
+        case 4:
+          if (this->BigEndian) { vtkByteSwap::Swap4BERange(ptr, numWords); }
+          else { vtkByteSwap::Swap4LERange(ptr, numWords); }
+          break;
+        case 8:
+          if (this->BigEndian) { vtkByteSwap::Swap8BERange(ptr, numWords); }
+          else { vtkByteSwap::Swap8LERange(ptr, numWords); }
+          break;
+        default:
+          break;
+      }
+    }
+  }
+};
+}
+
 
 vtkStandardNewMacro(vtkXMLDataParser);
 vtkCxxSetObjectMacro(vtkXMLDataParser, Compressor, vtkDataCompressor);
@@ -53,6 +136,9 @@ vtkXMLDataParser::vtkXMLDataParser()
   this->BlockCompressedSizes = nullptr;
   this->BlockStartOffsets = nullptr;
   this->Compressor = nullptr;
+  this->DecompressionBlocksInFlight = 0;
+  this->CompressedBlocksBuffer = nullptr;
+  this->CompressedBlocksBufferLength = 0;
 
   this->AsciiDataBuffer = nullptr;
   this->AsciiDataBufferLength = 0;
@@ -86,6 +172,7 @@ vtkXMLDataParser::~vtkXMLDataParser()
   this->AppendedDataStream->Delete();
   delete [] this->BlockCompressedSizes;
   delete [] this->BlockStartOffsets;
+  delete [] this->CompressedBlocksBuffer;
   this->SetCompressor(nullptr);
   if(this->AsciiDataBuffer) { this->FreeAsciiBuffer(); }
 }
@@ -111,6 +198,8 @@ void vtkXMLDataParser::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Progress: " << this->Progress << "\n";
   os << indent << "Abort: " << this->Abort << "\n";
   os << indent << "AttributesEncoding: " << this->AttributesEncoding << "\n";
+  os << indent << "DecompressionBlocksInFlight: "
+     << this->DecompressionBlocksInFlight << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -595,6 +684,47 @@ unsigned char* vtkXMLDataParser::ReadBlock(vtkTypeUInt64 block)
   return decompressBuffer;
 }
 
+//----------------------------------------------------------------------------
+int vtkXMLDataParser::ReadBlocks(vtkTypeUInt64 firstBlock,
+                                 vtkTypeUInt64 endBlock,
+                                 unsigned char* buffer, size_t wordSize)
+{
+  // The blocks are stored one after the other, so read all of their
+  // compressed bytes at once.
+  vtkTypeInt64 beginOffset = this->BlockStartOffsets[firstBlock];
+  size_t length = static_cast<size_t>(
+    this->BlockStartOffsets[endBlock-1] - beginOffset) +
+    this->BlockCompressedSizes[endBlock-1];
+  if(length > this->CompressedBlocksBufferLength)
+  {
+    delete [] this->CompressedBlocksBuffer;
+    this->CompressedBlocksBuffer = new unsigned char[length];
+    this->CompressedBlocksBufferLength = length;
+  }
+  if(!this->DataStream->Seek(beginOffset) ||
+     this->DataStream->Read(this->CompressedBlocksBuffer, length) < length)
+  {
+    return 0;
+  }
+
+  vtkIdType numBlocks = static_cast<vtkIdType>(endBlock - firstBlock);
+  vtkXMLDataParserUncompressBlocks uncompress;
+  uncompress.Compressor = this->Compressor;
+  uncompress.Compressed = this->CompressedBlocksBuffer;
+  uncompress.CompressedSizes = this->BlockCompressedSizes + firstBlock;
+  uncompress.StartOffsets = this->BlockStartOffsets + firstBlock;
+  uncompress.BaseOffset = beginOffset;
+  uncompress.Output = buffer;
+  uncompress.BlockSize = this->BlockUncompressedSize;
+  uncompress.WordSize = wordSize;
+  uncompress.BigEndian = (this->ByteOrder == vtkXMLDataParser::BigEndian);
+  uncompress.Results.resize(numBlocks);
+  vtkSMPTools::For(0, numBlocks, 1, uncompress);
+
+  return std::find(uncompress.Results.begin(), uncompress.Results.end(),
+                   size_t(0)) == uncompress.Results.end();
+}
+
 //----------------------------------------------------------------------------
 size_t vtkXMLDataParser::ReadUncompressedData(unsigned char* data,
                                               vtkTypeUInt64 startWord,
@@ -774,7 +904,27 @@ size_t vtkXMLDataParser::ReadCompressedData(unsigned char* data,
     // Report progress.
     this->UpdateProgress(float(outputPointer-data)/length);
 
-    unsigned int currentBlock = firstBlock+1;
+    // Read the complete blocks in batches when they may be decompressed
+    // concurrently.
+    size_t maxBlocks = static_cast<size_t>(this->DecompressionBlocksInFlight);
+    if(maxBlocks == 0)
+    {
+      int numThreads = vtkSMPTools::GetEstimatedNumberOfThreads();
+      maxBlocks = (numThreads > 1 ? 4 * static_cast<size_t>(numThreads) : 1);
+    }
+    vtkTypeUInt64 currentBlock = firstBlock+1;
+    while(maxBlocks > 1 && currentBlock != lastBlock && !this->Abort)
+    {
+      vtkTypeUInt64 endBlock = std::min<vtkTypeUInt64>(
+        lastBlock, currentBlock + maxBlocks);
+      if(!this->ReadBlocks(currentBlock, endBlock, outputPointer, wordSize))
+      {
+        return 0;
+      }
+      outputPointer += (endBlock - currentBlock) * blockSize;
+      currentBlock = endBlock;
+      this->UpdateProgress(float(outputPointer-data)/length);
+    }
     for(;currentBlock != lastBlock && !this->Abort; ++currentBlock)
     {
       // Read this block.
@@ -935,141 +1085,117 @@ size_t vtkXMLDataParser::ReadAppendedData(vtkTypeInt64 offset,
 }
 
 //----------------------------------------------------------------------------
-//----------------------------------------------------------------------------
-// Define a parsing function template.  The extra "long" argument is used
-// to help broken compilers select the non-templates below for char and
-// unsigned char by making them a better conversion than the template.
-template <class T>
-T* vtkXMLParseAsciiData(istream& is, int* length, T*, long)
+void* vtkXMLDataParser::MapAppendedData(const char* fileName,
+                                        vtkTypeInt64 offset,
+                                        size_t numWords, int wordType)
 {
-  int dataLength = 0;
-  int dataBufferSize = 64;
-
-  T* dataBuffer = new T[dataBufferSize];
-  T element;
-
-  while(is >> element)
+#ifdef VTK_XML_DATA_PARSER_USE_MMAP
+#ifdef VTK_WORDS_BIGENDIAN
+  int nativeByteOrder = vtkXMLDataParser::BigEndian;
+#else
+  int nativeByteOrder = vtkXMLDataParser::LittleEndian;
+#endif
+  if(!fileName || numWords == 0 || this->Compressor || this->Abort ||
+     wordType == VTK_BIT || wordType == VTK_STRING ||
+     this->ByteOrder != nativeByteOrder ||
+     this->AppendedDataStream->IsA("vtkBase64InputStream"))
   {
-    if(dataLength == dataBufferSize)
-    {
-      int newSize = dataBufferSize*2;
-      T* newBuffer = new T[newSize];
-      memcpy(newBuffer, dataBuffer, dataLength*sizeof(T));
-      delete [] dataBuffer;
-      dataBuffer = newBuffer;
-      dataBufferSize = newSize;
-    }
-    dataBuffer[dataLength++] = element;
+    return nullptr;
   }
+  size_t wordSize = this->GetWordTypeSize(wordType);
+  size_t length = numWords*wordSize;
 
-  if(length)
+  // Read the length of the data, which must hold all the values.
+#if defined(VTK_HAS_STD_UNIQUE_PTR)
+  std::unique_ptr<vtkXMLDataHeader>
+    uh(vtkXMLDataHeader::New(this->HeaderType, 1));
+#else
+  std::auto_ptr<vtkXMLDataHeader>
+    uh(vtkXMLDataHeader::New(this->HeaderType, 1));
+#endif
+  size_t const headerSize = uh->DataSize();
+  this->DataStream = this->AppendedDataStream;
+  this->DataStream->SetStream(this->Stream);
+  this->SeekG(this->AppendedDataPosition+offset);
+  this->DataStream->StartReading();
+  size_t r = this->DataStream->Read(uh->Data(), headerSize);
+  this->DataStream->EndReading();
+  if(r < headerSize || uh->Get(0) < length)
   {
-    *length = dataLength;
+    return nullptr;
   }
 
-  return dataBuffer;
-}
-
-//----------------------------------------------------------------------------
-static char* vtkXMLParseAsciiData(istream& is, int* length, char*, int)
-{
-  int dataLength = 0;
-  int dataBufferSize = 64;
-
-  char* dataBuffer = new char[dataBufferSize];
-  char element;
-  short inElement;
-
-  while(is >> inElement)
+  // The values must be aligned in the file to be aligned in memory.
+  vtkTypeInt64 position = this->AppendedDataPosition+offset+headerSize;
+  if(position < 0 || position % static_cast<vtkTypeInt64>(wordSize) != 0)
   {
-    element = inElement;
-    if(dataLength == dataBufferSize)
-    {
-      int newSize = dataBufferSize*2;
-      char* newBuffer = new char[newSize];
-      memcpy(newBuffer, dataBuffer, dataLength*sizeof(char));
-      delete [] dataBuffer;
-      dataBuffer = newBuffer;
-      dataBufferSize = newSize;
-    }
-    dataBuffer[dataLength++] = element;
+    return nullptr;
   }
 
-  if(length)
+  // Mappings start on a page boundary.
+  vtkTypeInt64 pageSize = static_cast<vtkTypeInt64>(sysconf(_SC_PAGESIZE));
+  vtkTypeInt64 begin = position - position % pageSize;
+  size_t mapLength = static_cast<size_t>(position - begin) + length;
+  int fd = open(fileName, O_RDONLY);
+  if(fd < 0)
   {
-    *length = dataLength;
+    return nullptr;
+  }
+  void* address = mmap(nullptr, mapLength, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE, fd, static_cast<off_t>(begin));
+  close(fd);
+  if(address == MAP_FAILED)
+  {
+    return nullptr;
   }
 
-  return dataBuffer;
+  void* data = static_cast<char*>(address) + (position - begin);
+  std::lock_guard<std::mutex> lock(vtkXMLDataParserMappingsMutex());
+  vtkXMLDataParserMapping mapping = { address, mapLength };
+  vtkXMLDataParserMappings()[data] = mapping;
+  return data;
+#else
+  (void)fileName;
+  (void)offset;
+  (void)numWords;
+  (void)wordType;
+  return nullptr;
+#endif
 }
 
 //----------------------------------------------------------------------------
-static unsigned char* vtkXMLParseAsciiData(istream& is,
-                                           int* length,
-                                           unsigned char*,
-                                           int)
+void vtkXMLDataParser::UnmapAppendedData(void* data)
 {
-  int dataLength = 0;
-  int dataBufferSize = 64;
-
-  unsigned char* dataBuffer = new unsigned char[dataBufferSize];
-  unsigned char element;
-  short inElement;
-
-  while(is >> inElement)
-  {
-    element = inElement;
-    if(dataLength == dataBufferSize)
-    {
-      int newSize = dataBufferSize*2;
-      unsigned char* newBuffer = new unsigned char[newSize];
-      memcpy(newBuffer, dataBuffer, dataLength*sizeof(unsigned char));
-      delete [] dataBuffer;
-      dataBuffer = newBuffer;
-      dataBufferSize = newSize;
-    }
-    dataBuffer[dataLength++] = element;
-  }
-
-  if(length)
+#ifdef VTK_XML_DATA_PARSER_USE_MMAP
+  std::lock_guard<std::mutex> lock(vtkXMLDataParserMappingsMutex());
+  std::map<void*, vtkXMLDataParserMapping>& mappings =
+    vtkXMLDataParserMappings();
+  std::map<void*, vtkXMLDataParserMapping>::iterator i = mappings.find(data);
+  if(i != mappings.end())
   {
-    *length = dataLength;
+    munmap(i->second.Address, i->second.Length);
+    mappings.erase(i);
   }
-
-  return dataBuffer;
+#else
+  (void)data;
+#endif
 }
 
 //----------------------------------------------------------------------------
-static signed char* vtkXMLParseAsciiData(istream& is,
-                                         int* length,
-                                         signed char*,
-                                         int)
+// Parse numbers until one does not parse.  vtkStringToNumber parses
+// characters as numbers and splits the text to parse it in parallel.
+template <class T>
+T* vtkXMLParseAsciiData(istream& is, int* length, T*)
 {
-  int dataLength = 0;
-  int dataBufferSize = 64;
+  std::vector<T> values;
+  vtkStringToNumber::Read(is, values);
 
-  signed char* dataBuffer = new signed char[dataBufferSize];
-  signed char element;
-  short inElement;
-
-  while(is >> inElement)
-  {
-    element = inElement;
-    if(dataLength == dataBufferSize)
-    {
-      int newSize = dataBufferSize*2;
-      signed char* newBuffer = new signed char[newSize];
-      memcpy(newBuffer, dataBuffer, dataLength*sizeof(signed char));
-      delete [] dataBuffer;
-      dataBuffer = newBuffer;
-      dataBufferSize = newSize;
-    }
-    dataBuffer[dataLength++] = element;
-  }
+  T* dataBuffer = new T[values.empty() ? 1 : values.size()];
+  std::copy(values.begin(), values.end(), dataBuffer);
 
   if(length)
   {
-    *length = dataLength;
+    *length = static_cast<int>(values.size());
   }
 
   return dataBuffer;
@@ -1078,46 +1204,18 @@ static signed char* vtkXMLParseAsciiData(istream& is,
 //----------------------------------------------------------------------------
 static unsigned char* vtkXMLParseAsciiBitData(istream& is, int* length)
 {
-  size_t arrayCapacity = 64; // capacity in bytes
-  unsigned char *array = new unsigned char[arrayCapacity];
-  std::fill(array, array + arrayCapacity, static_cast<unsigned char>(0));
-
-  size_t fullBytesRead = 0;
-  unsigned char currentBitInByte = 0;
-  unsigned char *currentByte = array;
-
-  int value;
-  while (is >> value)
+  std::vector<int> values;
+  vtkStringToNumber::Read(is, values);
+
+  // Mimic the storage mechanism used by vtkBitArray.
+  size_t numBytes = (values.size() + 7) / 8;
+  unsigned char *array = new unsigned char[numBytes ? numBytes : 1];
+  std::fill(array, array + numBytes, static_cast<unsigned char>(0));
+  for (size_t i = 0; i < values.size(); ++i)
   {
-    // Realloc array buffer if needed:
-    if (fullBytesRead == arrayCapacity)
-    {
-      assert("sanity check" && currentBitInByte == 0);
-      size_t newSize = arrayCapacity * 2;
-      unsigned char *tmp = new unsigned char[newSize];
-      std::copy(array, array + arrayCapacity, tmp);
-      std::fill(tmp + arrayCapacity, tmp + newSize,
-                static_cast<unsigned char>(0));
-
-      delete [] array;
-      array = tmp;
-      currentByte = array + fullBytesRead;
-      arrayCapacity = newSize;
-    }
-
-    // Set the current bit:
-    assert("sanity check" && currentBitInByte < 8);
-    if (value != 0)
-    { // Mimic the storage mechanism used by vtkBitArray
-      *currentByte = *currentByte | (0x80 >> currentBitInByte);
-    }
-
-    // Update bookkeeping:
-    if (++currentBitInByte == 8)
+    if (values[i] != 0)
     {
-      ++currentByte;
-      ++fullBytesRead;
-      currentBitInByte = 0;
+      array[i / 8] |= static_cast<unsigned char>(0x80 >> (i % 8));
     }
   }
 
@@ -1125,7 +1223,7 @@ static unsigned char* vtkXMLParseAsciiBitData(istream& is, int* length)
   {
     // We fudge the 'word size' to 1 byte for bit arrays (since it's integral)
     // so return the length in bytes here:
-    *length = static_cast<int>(fullBytesRead + (currentBitInByte != 0 ? 1 : 0));
+    *length = static_cast<int>(numBytes);
   }
 
   return array;
@@ -1151,7 +1249,7 @@ int vtkXMLDataParser::ParseAsciiData(int wordType)
   switch (wordType)
   {
     vtkTemplateMacro(
-      buffer = vtkXMLParseAsciiData(is, &length, static_cast<VTK_TT*>(nullptr), 1)
+      buffer = vtkXMLParseAsciiData(is, &length, static_cast<VTK_TT*>(nullptr))
       );
 
     case VTK_BIT:
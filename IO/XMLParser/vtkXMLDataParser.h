@@ -79,6 +79,25 @@ public:
   { return this->ReadAppendedData(offset, buffer, startWord, numWords,
                                     VTK_CHAR); }
 
+  /**
+   * Map the raw appended data of an array from the given file into
+   * memory, without reading or copying it.  This is possible only for
+   * uncompressed data with encoding="raw", in the byte order of this
+   * machine, and stored at a file position aligned for the word type.
+   * The mapping is private, so writing to the values copies the pages
+   * they touch and never changes the file.  Returns a pointer to the
+   * first of numWords values, to be released with UnmapAppendedData, or
+   * nullptr when the data must be read instead.
+   */
+  void* MapAppendedData(const char* fileName, vtkTypeInt64 offset,
+                        size_t numWords, int wordType);
+
+  /**
+   * Release values returned by MapAppendedData.  Its signature matches
+   * the free function of vtkAbstractArray::SetArrayFreeFunction.
+   */
+  static void UnmapAppendedData(void* data);
+
   /**
    * Read from an ascii data section starting at the current position in
    * the stream.  Returns the number of words read.
@@ -144,6 +163,19 @@ public:
   vtkGetMacro(AttributesEncoding, int);
   //@}
 
+  //@{
+  /**
+   * Get/Set the maximum number of compressed blocks read at once.  The
+   * compressed bytes of consecutive blocks are read with a single read
+   * and the blocks are decompressed concurrently with vtkSMPTools
+   * directly into the destination buffer.  A value of 1 reads and
+   * decompresses one block at a time.  The default, 0, reads four blocks
+   * per thread, or one block when running on a single thread.
+   */
+  vtkSetClampMacro(DecompressionBlocksInFlight, int, 0, VTK_INT_MAX);
+  vtkGetMacro(DecompressionBlocksInFlight, int);
+  //@}
+
   /**
    * If you need the text inside XMLElements, turn IgnoreCharacterData off.
    * This method will then be called when the file is parsed, and the text
@@ -189,6 +221,8 @@ protected:
   size_t FindBlockSize(vtkTypeUInt64 block);
   int ReadBlock(vtkTypeUInt64 block, unsigned char* buffer);
   unsigned char* ReadBlock(vtkTypeUInt64 block);
+  int ReadBlocks(vtkTypeUInt64 firstBlock, vtkTypeUInt64 endBlock,
+                 unsigned char* buffer, size_t wordSize);
   size_t ReadUncompressedData(unsigned char* data,
                               vtkTypeUInt64 startWord,
                               size_t numWords,
@@ -246,6 +280,9 @@ protected:
   size_t PartialLastBlockUncompressedSize;
   size_t* BlockCompressedSizes;
   vtkTypeInt64* BlockStartOffsets;
+  int DecompressionBlocksInFlight;
+  unsigned char* CompressedBlocksBuffer;
+  size_t CompressedBlocksBufferLength;
 
   // Ascii data parsing.
   unsigned char* AsciiDataBuffer;